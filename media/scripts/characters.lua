@@ -0,0 +1,48 @@
+-- ******************************************************************************
+-- Filename:    characters.lua
+-- Project:     Vogue
+--
+-- Purpose:
+--   Character presets, the number of each part the character creator can
+--   pick from and the chances used when randomizing a character.
+-- ******************************************************************************
+
+CharacterParts =
+{
+	heads = 2,
+	hairsMale = 22,
+	hairsFemale = 10,
+	facialHairs = 9,
+	noses = 8,
+	ears = 6,
+	glasses = 5,
+	bodyMale = 2,
+	bodyFemale = 1,
+	legsMale = 2,
+	legsFemale = 1,
+	rightHand = 1,
+	leftHand = 1,
+	rightShoulder = 2,
+	leftShoulder = 2,
+	rightFoot = 5,
+	leftFoot = 5,
+}
+
+-- Percentage chances when randomizing
+CharacterRandomization =
+{
+	facialHairChance = 40,
+	glassesChance = 20,
+}
+
+-- The number of eyes is the length of this list
+EyesNames =
+{
+	"eyes_brown",
+	"eyes_blue",
+	"eyes_gray",
+	"eyes_green",
+	"eyes_orange",
+	"eyes_purple",
+	"eyes_red",
+}
@@ -0,0 +1,28 @@
+-- ******************************************************************************
+-- Filename:    rooms.lua
+-- Project:     Vogue
+--
+-- Purpose:
+--   Room generation rules, read by the RoomManager when it is created.
+--   Room sizes and corridor lengths are in tiles.
+--
+--   A script can also define UpdateRooms(dt, count, ids, fields), it is
+--   called once a frame for all the rooms together. ids[i] is the room
+--   index and each room has 3 consecutive values in fields, starting at
+--   fields[(i-1)*3 + 1]: depth, isItemRoom and isBossRoom (1 or 0).
+-- ******************************************************************************
+
+RoomGeneration =
+{
+	minRoomSize = 5,
+	maxRoomSize = 14,
+
+	minCorridorLength = 2,
+	maxCorridorLength = 8,
+
+	-- How many rooms deep the layout can go from the starting room
+	maxRoomDepth = 3,
+
+	-- How many random directions to try before a room gives up making connections
+	numDirectionTries = 10,
+}
@@ -0,0 +1,219 @@
+// ******************************************************************************
+// Filename:    CrowdBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "CrowdBenchmark.h"
+
+#include <vector>
+#include <cmath>
+#include <iomanip>
+
+const float CROWD_BENCHMARK_FRAME_TIME = 1.0f / 60.0f;
+
+// The characters stand on a grid in the middle of the room, the camera circles around them
+const float CROWD_BENCHMARK_SPACING = 1.5f;
+const float CROWD_BENCHMARK_CHARACTER_SCALE = 0.08f;
+const float CROWD_BENCHMARK_CHARACTER_RADIUS = 1.25f;
+const float CROWD_BENCHMARK_CAMERA_DISTANCE = 14.0f;
+const float CROWD_BENCHMARK_CAMERA_HEIGHT = 4.0f;
+const float CROWD_BENCHMARK_CAMERA_SPEED = 0.25f;
+const float CROWD_BENCHMARK_FOV = 60.0f;
+const int CROWD_BENCHMARK_WINDOW_WIDTH = 1024;
+const int CROWD_BENCHMARK_WINDOW_HEIGHT = 768;
+
+// Looping animations, so the whole crowd keeps moving for the entire run
+const int CROWD_BENCHMARK_NUM_ANIMATIONS = 5;
+const char* CROWD_BENCHMARK_ANIMATIONS[CROWD_BENCHMARK_NUM_ANIMATIONS] = { "Run", "MummyWalk", "GhostPose", "StaffRun", "ZombieCrawl" };
+
+
+CrowdBenchmark::CrowdBenchmark()
+{
+	m_numCharacters = 0;
+	m_numFrames = 0;
+
+	for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+	{
+		m_averageAtLOD[i] = 0.0;
+	}
+	m_averageVisibleFaces = 0.0;
+	m_maxFullRateError = 0.0f;
+	m_maxReducedRateError = 0.0f;
+}
+
+CrowdBenchmark::~CrowdBenchmark()
+{
+}
+
+// Running
+void CrowdBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numCharacters = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	Renderer* pRenderer = new Renderer(CROWD_BENCHMARK_WINDOW_WIDTH, CROWD_BENCHMARK_WINDOW_HEIGHT, 32, 8);
+	QubicleBinaryManager* pQubicleBinaryManager = new QubicleBinaryManager(pRenderer);
+
+	// Two identical crowds, the reference one is updated the old way with paperdolls and faces always animating
+	vector<VoxelCharacter*> vpReferenceCharacters(m_numCharacters);
+	vector<VoxelCharacter*> vpCrowdCharacters(m_numCharacters);
+	VoxelCharacterCrowd* pCrowd = new VoxelCharacterCrowd();
+	pCrowd->SetProjection(CROWD_BENCHMARK_FOV, (float)CROWD_BENCHMARK_WINDOW_WIDTH / (float)CROWD_BENCHMARK_WINDOW_HEIGHT, 0.1f, 1000.0f, CROWD_BENCHMARK_WINDOW_HEIGHT);
+
+	int gridSize = (int)ceil(sqrt((float)m_numCharacters));
+	for (int i = 0; i < m_numCharacters; i++)
+	{
+		vpReferenceCharacters[i] = CreateCharacter(pRenderer, pQubicleBinaryManager, i);
+		vpReferenceCharacters[i]->SetPaperdollAnimationEnabled(true);
+
+		vpCrowdCharacters[i] = CreateCharacter(pRenderer, pQubicleBinaryManager, i);
+
+		float x = ((i % gridSize) - (gridSize - 1) * 0.5f) * CROWD_BENCHMARK_SPACING;
+		float z = ((i / gridSize) - (gridSize - 1) * 0.5f) * CROWD_BENCHMARK_SPACING;
+		float facing = (float)i * 2.4f;
+
+		int characterId = pCrowd->AddCharacter(vpCrowdCharacters[i], CROWD_BENCHMARK_CHARACTER_RADIUS);
+		pCrowd->SetCharacterTransform(characterId, vec3(x, 1.0f, z), vec3(sin(facing), 0.0f, cos(facing)));
+	}
+
+	m_full.Reset();
+	m_crowd.Reset();
+	for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+	{
+		m_averageAtLOD[i] = 0.0;
+	}
+	m_averageVisibleFaces = 0.0;
+	m_maxFullRateError = 0.0f;
+	m_maxReducedRateError = 0.0f;
+
+	float animationSpeeds[AnimationSections_NUMSECTIONS] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		float cameraAngle = frame * CROWD_BENCHMARK_FRAME_TIME * CROWD_BENCHMARK_CAMERA_SPEED;
+		vec3 cameraPosition = vec3(sin(cameraAngle) * CROWD_BENCHMARK_CAMERA_DISTANCE, CROWD_BENCHMARK_CAMERA_HEIGHT, cos(cameraAngle) * CROWD_BENCHMARK_CAMERA_DISTANCE);
+		pCrowd->SetCamera(cameraPosition, vec3(0.0f, 1.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+
+		double start = GetBenchmarkTime();
+		for (int i = 0; i < m_numCharacters; i++)
+		{
+			vpReferenceCharacters[i]->Update(CROWD_BENCHMARK_FRAME_TIME, animationSpeeds);
+		}
+		double end = GetBenchmarkTime();
+		m_full.AddSample(end - start);
+
+		start = end;
+		pCrowd->Update(CROWD_BENCHMARK_FRAME_TIME);
+		end = GetBenchmarkTime();
+		m_crowd.AddSample(end - start);
+
+		for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+		{
+			m_averageAtLOD[i] += pCrowd->GetNumCharactersAtLOD((CrowdAnimationLOD)i);
+		}
+		m_averageVisibleFaces += pCrowd->GetNumVisibleFaces();
+
+		// How far the poses on screen are from the fully updated ones
+		for (int i = 0; i < m_numCharacters; i++)
+		{
+			CrowdAnimationLOD lod = pCrowd->GetCharacterLOD(i);
+			if (lod == CrowdAnimationLOD_Culled)
+			{
+				continue;
+			}
+
+			float error = GetPoseError(vpCrowdCharacters[i], vpReferenceCharacters[i]);
+			if (lod == CrowdAnimationLOD_Full)
+			{
+				m_maxFullRateError = error > m_maxFullRateError ? error : m_maxFullRateError;
+			}
+			else
+			{
+				m_maxReducedRateError = error > m_maxReducedRateError ? error : m_maxReducedRateError;
+			}
+		}
+	}
+
+	for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+	{
+		m_averageAtLOD[i] /= m_numFrames;
+	}
+	m_averageVisibleFaces /= m_numFrames;
+
+	delete pCrowd;
+	for (int i = 0; i < m_numCharacters; i++)
+	{
+		delete vpReferenceCharacters[i];
+		delete vpCrowdCharacters[i];
+	}
+	delete pQubicleBinaryManager;
+	delete pRenderer;
+}
+
+// Reporting
+void CrowdBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"characters\": " << m_numCharacters << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"full\": { ";
+	output << "\"average\": " << m_full.Average() << ", ";
+	output << "\"max\": " << m_full.Max() << " },\n";
+	output << "  \"crowd\": { ";
+	output << "\"average\": " << m_crowd.Average() << ", ";
+	output << "\"max\": " << m_crowd.Max() << " },\n";
+	output << "  \"speedup\": " << (m_crowd.Average() > 0.0 ? m_full.Average() / m_crowd.Average() : 0.0) << ",\n";
+	output << "  \"lod\": { ";
+	output << "\"full\": " << m_averageAtLOD[CrowdAnimationLOD_Full] << ", ";
+	output << "\"near\": " << m_averageAtLOD[CrowdAnimationLOD_Near] << ", ";
+	output << "\"far\": " << m_averageAtLOD[CrowdAnimationLOD_Far] << ", ";
+	output << "\"culled\": " << m_averageAtLOD[CrowdAnimationLOD_Culled] << " },\n";
+	output << "  \"visibleFaces\": " << m_averageVisibleFaces << ",\n";
+	output << "  \"maxFullRateError\": " << m_maxFullRateError << ",\n";
+	output << "  \"maxReducedRateError\": " << m_maxReducedRateError << "\n";
+	output << "}\n";
+}
+
+VoxelCharacter* CrowdBenchmark::CreateCharacter(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, int index)
+{
+	VoxelCharacter* pCharacter = new VoxelCharacter(pRenderer, pQubicleBinaryManager);
+
+	pCharacter->LoadVoxelCharacter("human",
+		"media/gamedata/models/human/base_human1.qb",
+		"media/gamedata/models/human/human.ms3d",
+		"media/gamedata/models/human/human.animlist",
+		"media/gamedata/models/human/base_human1.faces",
+		"media/gamedata/models/human/base_human1.character",
+		"media/gamedata/models",
+		true);
+	pCharacter->SetCharacterScale(CROWD_BENCHMARK_CHARACTER_SCALE);
+	pCharacter->SetWinkAnimationEnabled(true);
+	pCharacter->SetTalkingAnimationEnabled(true);
+	pCharacter->SetRandomLookDirection(true);
+
+	pCharacter->PlayAnimation(AnimationSections_FullBody, false, AnimationSections_FullBody, CROWD_BENCHMARK_ANIMATIONS[index % CROWD_BENCHMARK_NUM_ANIMATIONS]);
+
+	return pCharacter;
+}
+
+// The furthest any bone has moved away from the reference pose, in world units
+float CrowdBenchmark::GetPoseError(VoxelCharacter* pCharacter, VoxelCharacter* pReference)
+{
+	float maxError = 0.0f;
+	for (int i = 0; i < pCharacter->GetNumJoints(); i++)
+	{
+		vec3 bone = pCharacter->GetBoneMatrix(AnimationSections_FullBody, i).GetTranslationVector();
+		vec3 referenceBone = pReference->GetBoneMatrix(AnimationSections_FullBody, i).GetTranslationVector();
+
+		float error = length(bone - referenceBone) * CROWD_BENCHMARK_CHARACTER_SCALE;
+		maxError = error > maxError ? error : maxError;
+	}
+
+	return maxError;
+}
@@ -0,0 +1,69 @@
+// ******************************************************************************
+// Filename:    CrowdBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless benchmark for crowds of animated voxel characters. Fills a room
+//   with two identical crowds, walking and talking, and steps one of them
+//   the old way with every character fully updated each frame and the other
+//   through the crowd update with its animation level of detail, while the
+//   camera circles the room. Reports the per frame cost of both, how the
+//   characters were spread across the detail levels and how far the
+//   reduced rate poses strayed from the full ones as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include "../models/VoxelCharacterCrowd.h"
+
+#include <ostream>
+using namespace std;
+
+class CrowdBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	CrowdBenchmark();
+	~CrowdBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	VoxelCharacter* CreateCharacter(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, int index);
+	float GetPoseError(VoxelCharacter* pCharacter, VoxelCharacter* pReference);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numCharacters;
+	int m_numFrames;
+
+	// Results
+	HeadlessBenchmarkTimings m_full;
+	HeadlessBenchmarkTimings m_crowd;
+	double m_averageAtLOD[CrowdAnimationLOD_NUM];
+	double m_averageVisibleFaces;
+	float m_maxFullRateError;
+	float m_maxReducedRateError;
+};
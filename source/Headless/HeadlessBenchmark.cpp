@@ -0,0 +1,57 @@
+// ******************************************************************************
+// Filename:    HeadlessBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "HeadlessBenchmark.h"
+
+#include <chrono>
+
+
+double GetBenchmarkTime()
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+HeadlessBenchmarkTimings::HeadlessBenchmarkTimings()
+{
+	Reset();
+}
+
+void HeadlessBenchmarkTimings::Reset()
+{
+	m_totalTime = 0.0;
+	m_maxTime = 0.0;
+	m_numSamples = 0;
+}
+
+void HeadlessBenchmarkTimings::AddSample(double time)
+{
+	m_totalTime += time;
+	m_maxTime = time > m_maxTime ? time : m_maxTime;
+	m_numSamples++;
+}
+
+double HeadlessBenchmarkTimings::Average() const
+{
+	return m_numSamples > 0 ? m_totalTime / m_numSamples : 0.0;
+}
+
+double HeadlessBenchmarkTimings::Max() const
+{
+	return m_maxTime;
+}
+
+float GetBenchmarkRandomValue(unsigned int* pSeed, float minValue, float maxValue)
+{
+	*pSeed = (*pSeed * 1103515245u) + 12345u;
+	float ratio = (float)((*pSeed >> 8) & 0xFFFF) / 65535.0f;
+
+	return minValue + ((maxValue - minValue) * ratio);
+}
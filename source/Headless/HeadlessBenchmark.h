@@ -0,0 +1,69 @@
+// ******************************************************************************
+// Filename:    HeadlessBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   The interface shared by the headless micro-benchmarks, and the timing,
+//   timing accumulator and random number helpers they use. HeadlessMain
+//   picks a benchmark from its command line flag, runs it and writes out its
+//   report.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <ostream>
+using namespace std;
+
+// The command line settings handed to a benchmark
+class HeadlessBenchmarkSettings
+{
+public:
+	// The value given after the benchmark's flag, and the same value as a number
+	const char* m_argument;
+	int m_count;
+
+	int m_numTicks;
+	int m_numIterations;
+};
+
+class HeadlessBenchmark
+{
+public:
+	virtual ~HeadlessBenchmark() {}
+
+	// Running
+	virtual void Run(const HeadlessBenchmarkSettings& settings) = 0;
+
+	// Reporting
+	virtual void WriteReport(ostream& output) = 0;
+};
+
+// Timing, in microseconds
+double GetBenchmarkTime();
+
+// The average and worst of a set of timing samples, one sample per frame in microseconds
+class HeadlessBenchmarkTimings
+{
+public:
+	HeadlessBenchmarkTimings();
+
+	void Reset();
+	void AddSample(double time);
+
+	double Average() const;
+	double Max() const;
+
+private:
+	double m_totalTime;
+	double m_maxTime;
+	int m_numSamples;
+};
+
+// A small deterministic generator, so every run sees the same workload
+float GetBenchmarkRandomValue(unsigned int* pSeed, float minValue, float maxValue);
@@ -0,0 +1,225 @@
+// ******************************************************************************
+// Filename:    HeadlessMain.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   The main entry point for the headless benchmark. Creates the headless world,
+//   replays the recorded input for a fixed number of ticks and writes out the
+//   timing report. A soak test runs the simulation with no recorded input as
+//   fast as possible and only prints the overall timing.
+//
+//   Usage: VogueHeadless [-ticks N] [-replay file] [-output file] [-trace file]
+//          VogueHeadless -soak ticks [-output file]
+//          VogueHeadless -texturebench directory [-iterations N] [-output file]
+//          VogueHeadless -interpolatorbench count [-ticks N] [-output file]
+//          VogueHeadless -noisebench size [-iterations N] [-output file]
+//          VogueHeadless -weaponbench count [-ticks N] [-output file]
+//          VogueHeadless -particlebench count [-ticks N] [-output file]
+//          VogueHeadless -lightbench count [-ticks N] [-output file]
+//          VogueHeadless -crowdbench count [-ticks N] [-output file]
+//          VogueHeadless -weaponloadbench count [-iterations N] [-output file]
+//          VogueHeadless -transformbench count [-ticks N] [-output file]
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "VogueHeadless.h"
+#include "TextureBenchmark.h"
+#include "InterpolatorBenchmark.h"
+#include "NoiseBenchmark.h"
+#include "WeaponAnimationBenchmark.h"
+#include "ParticleBenchmark.h"
+#include "LightClusterBenchmark.h"
+#include "CrowdBenchmark.h"
+#include "WeaponLoadBenchmark.h"
+#include "TransformBenchmark.h"
+#include "../utils/Profiler.h"
+
+#include <string.h>
+#include <fstream>
+#include <iostream>
+
+// The micro-benchmarks, each is selected by its flag and run on its own without the game world
+typedef HeadlessBenchmark* (*CreateHeadlessBenchmark)();
+
+template <class T>
+static HeadlessBenchmark* CreateBenchmark()
+{
+	return new T();
+}
+
+class HeadlessBenchmarkEntry
+{
+public:
+	const char* m_flag;
+	CreateHeadlessBenchmark m_create;
+};
+
+static const HeadlessBenchmarkEntry s_benchmarks[] =
+{
+	{ "-texturebench", CreateBenchmark<TextureBenchmark> },
+	{ "-interpolatorbench", CreateBenchmark<InterpolatorBenchmark> },
+	{ "-noisebench", CreateBenchmark<NoiseBenchmark> },
+	{ "-weaponbench", CreateBenchmark<WeaponAnimationBenchmark> },
+	{ "-particlebench", CreateBenchmark<ParticleBenchmark> },
+	{ "-lightbench", CreateBenchmark<LightClusterBenchmark> },
+	{ "-crowdbench", CreateBenchmark<CrowdBenchmark> },
+	{ "-weaponloadbench", CreateBenchmark<WeaponLoadBenchmark> },
+	{ "-transformbench", CreateBenchmark<TransformBenchmark> },
+};
+
+const int NUM_HEADLESS_BENCHMARKS = sizeof(s_benchmarks) / sizeof(s_benchmarks[0]);
+
+int main(int argc, char* argv[])
+{
+	int numTicks = 600;
+	const char* replayFile = "media/replays/benchmark.replay";
+	const char* outputFile = NULL;
+	const char* traceFile = NULL;
+	int numIterations = 10;
+	int soakTicks = 0;
+	const HeadlessBenchmarkEntry* pBenchmarkEntry = NULL;
+	const char* benchmarkArgument = NULL;
+
+	/* Command line arguments */
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "-ticks") == 0 && i + 1 < argc)
+		{
+			numTicks = atoi(argv[i + 1]);
+			i++;
+		}
+		else if (strcmp(argv[i], "-replay") == 0 && i + 1 < argc)
+		{
+			replayFile = argv[i + 1];
+			i++;
+		}
+		else if (strcmp(argv[i], "-output") == 0 && i + 1 < argc)
+		{
+			outputFile = argv[i + 1];
+			i++;
+		}
+		else if (strcmp(argv[i], "-trace") == 0 && i + 1 < argc)
+		{
+			traceFile = argv[i + 1];
+			i++;
+		}
+		else if (strcmp(argv[i], "-iterations") == 0 && i + 1 < argc)
+		{
+			numIterations = atoi(argv[i + 1]);
+			i++;
+		}
+		else if (strcmp(argv[i], "-soak") == 0 && i + 1 < argc)
+		{
+			soakTicks = atoi(argv[i + 1]);
+			i++;
+		}
+		else if (i + 1 < argc)
+		{
+			for (int j = 0; j < NUM_HEADLESS_BENCHMARKS; j++)
+			{
+				if (strcmp(argv[i], s_benchmarks[j].m_flag) == 0)
+				{
+					pBenchmarkEntry = &s_benchmarks[j];
+					benchmarkArgument = argv[i + 1];
+					i++;
+					break;
+				}
+			}
+		}
+	}
+
+	/* Micro-benchmark */
+	if (pBenchmarkEntry != NULL)
+	{
+		HeadlessBenchmarkSettings settings;
+		settings.m_argument = benchmarkArgument;
+		settings.m_count = atoi(benchmarkArgument);
+		settings.m_numTicks = numTicks;
+		settings.m_numIterations = numIterations;
+
+		HeadlessBenchmark* pBenchmark = pBenchmarkEntry->m_create();
+		pBenchmark->Run(settings);
+
+		if (outputFile != NULL)
+		{
+			ofstream output(outputFile);
+			pBenchmark->WriteReport(output);
+		}
+		else
+		{
+			pBenchmark->WriteReport(cout);
+		}
+
+		delete pBenchmark;
+
+		exit(EXIT_SUCCESS);
+	}
+
+	/* Load the settings */
+	VogueSettings* pVogueSettings = new VogueSettings();
+	pVogueSettings->LoadSettings();
+	pVogueSettings->LoadOptions();
+
+	/* Create the headless world and load the recorded input */
+	VogueHeadless* pVogueHeadless = new VogueHeadless(pVogueSettings);
+	pVogueHeadless->Create();
+
+	/* Soak test, no recorded input and no report beyond the overall timing */
+	if (soakTicks > 0)
+	{
+		pVogueHeadless->Run(soakTicks);
+
+		if (outputFile != NULL)
+		{
+			ofstream output(outputFile);
+			pVogueHeadless->WriteSoakReport(output);
+		}
+		else
+		{
+			pVogueHeadless->WriteSoakReport(cout);
+		}
+
+		delete pVogueHeadless;
+		delete pVogueSettings;
+		exit(EXIT_SUCCESS);
+	}
+
+	if (pVogueHeadless->LoadReplay(replayFile) == false)
+	{
+		delete pVogueHeadless;
+		delete pVogueSettings;
+		exit(EXIT_FAILURE);
+	}
+
+	/* Run */
+	pVogueHeadless->Run(numTicks);
+
+	/* Report */
+	if (outputFile != NULL)
+	{
+		ofstream output(outputFile);
+		pVogueHeadless->WriteReport(output);
+	}
+	else
+	{
+		pVogueHeadless->WriteReport(cout);
+	}
+
+	/* Profiler trace, the zones recorded during the run in chrome://tracing format */
+	if (traceFile != NULL)
+	{
+		Profiler::GetInstance()->ExportChromeTrace(traceFile);
+	}
+
+	/* Cleanup */
+	delete pVogueHeadless;
+	delete pVogueSettings;
+
+	/* Exit */
+	exit(EXIT_SUCCESS);
+}
@@ -0,0 +1,362 @@
+// ******************************************************************************
+// Filename:    InterpolatorBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "InterpolatorBenchmark.h"
+
+#include "../Maths/3dGeometry.h"
+
+#include <algorithm>
+#include <iomanip>
+
+const float INTERPOLATOR_BENCHMARK_FRAME_TIME = 1.0f / 60.0f;
+
+
+// The old approach, one heap object per interpolation and timer, every one visited every frame
+class LegacyTween
+{
+public:
+	float *m_variable;
+	float m_start;
+	float m_end;
+	float m_time;
+	float m_easing;
+	float m_elapsed;
+	bool m_erase;
+};
+
+class LegacyTimer
+{
+public:
+	float m_elapsedTime;
+	float m_timeOutTime;
+	bool m_bLooping;
+	bool m_bFinished;
+};
+
+static bool LegacyTweenNeedsErasing(LegacyTween* pTween)
+{
+	bool needsErase = pTween->m_erase;
+	if (needsErase)
+	{
+		delete pTween;
+	}
+
+	return needsErase;
+}
+
+
+InterpolatorBenchmark::InterpolatorBenchmark()
+{
+	m_numTweens = 0;
+	m_numTimers = 0;
+	m_numFrames = 0;
+	m_randomSeed = 1;
+
+	m_numTweensFinished = 0;
+	m_numTimersFinished = 0;
+
+	m_removeByHandleTime = 0.0;
+	m_removeByVariableTime = 0.0;
+	m_removeTimerTime = 0.0;
+	m_legacyRemoveByVariableTime = 0.0;
+}
+
+InterpolatorBenchmark::~InterpolatorBenchmark()
+{
+	Interpolator::GetInstance()->Destroy();
+	TimeManager::GetInstance()->Destroy();
+}
+
+// Running
+void InterpolatorBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numTweens = settings.m_count > 0 ? settings.m_count : 1;
+	m_numTimers = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	RunPooled();
+	RunLegacy();
+}
+
+void InterpolatorBenchmark::RunPooled()
+{
+	Interpolator* pInterpolator = Interpolator::GetInstance();
+	TimeManager* pTimeManager = TimeManager::GetInstance();
+
+	m_randomSeed = 1;
+	m_numTweensFinished = 0;
+	m_numTimersFinished = 0;
+
+	// The callbacks point into these, so they must not grow once the benchmark starts
+	m_vTweens.clear();
+	m_vTweens.resize(m_numTweens);
+	for (int i = 0; i < m_numTweens; i++)
+	{
+		m_vTweens[i].m_pBenchmark = this;
+		m_vTweens[i].m_value = 0.0f;
+		StartTween(&m_vTweens[i]);
+	}
+
+	m_vTimers.clear();
+	m_vTimers.resize(m_numTimers);
+	for (int i = 0; i < m_numTimers; i++)
+	{
+		// A mix of short repeating timers and long one-shot gameplay timers
+		bool looping = (i % 4) == 0;
+		float countdownTime = looping ? GetBenchmarkRandomValue(&m_randomSeed, 0.05f, 1.0f) : GetBenchmarkRandomValue(&m_randomSeed, 0.5f, 30.0f);
+
+		m_vTimers[i].m_pBenchmark = this;
+		m_vTimers[i].m_timer = pTimeManager->AddTimer(countdownTime, _TimerFinished, &m_vTimers[i], looping);
+	}
+
+	m_pooledInterpolator.Reset();
+	m_pooledTimers.Reset();
+
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		double start = GetBenchmarkTime();
+		pInterpolator->Update(INTERPOLATOR_BENCHMARK_FRAME_TIME);
+		double end = GetBenchmarkTime();
+		m_pooledInterpolator.AddSample(end - start);
+
+		start = end;
+		pTimeManager->Update(INTERPOLATOR_BENCHMARK_FRAME_TIME);
+		end = GetBenchmarkTime();
+		m_pooledTimers.AddSample(end - start);
+	}
+
+	m_pooledInterpolator.m_numFinished = m_numTweensFinished;
+	m_pooledTimers.m_numFinished = m_numTimersFinished;
+
+	// Cancel half the tweens by handle and the other half by variable
+	int numByHandle = m_numTweens / 2;
+	double start = GetBenchmarkTime();
+	for (int i = 0; i < numByHandle; i++)
+	{
+		pInterpolator->RemoveFloatInterpolation(m_vTweens[i].m_interpolation);
+	}
+	double end = GetBenchmarkTime();
+	m_removeByHandleTime = numByHandle > 0 ? ((end - start) * 1000.0) / numByHandle : 0.0;
+
+	start = end;
+	for (int i = numByHandle; i < m_numTweens; i++)
+	{
+		pInterpolator->RemoveFloatInterpolationByVariable(&m_vTweens[i].m_value);
+	}
+	end = GetBenchmarkTime();
+	m_removeByVariableTime = ((end - start) * 1000.0) / (m_numTweens - numByHandle);
+
+	start = end;
+	for (int i = 0; i < m_numTimers; i++)
+	{
+		pTimeManager->RemoveTimer(m_vTimers[i].m_timer);
+	}
+	end = GetBenchmarkTime();
+	m_removeTimerTime = ((end - start) * 1000.0) / m_numTimers;
+
+	pInterpolator->ClearInterpolators();
+	pTimeManager->RemoveTimers();
+}
+
+void InterpolatorBenchmark::RunLegacy()
+{
+	m_randomSeed = 1;
+
+	vector<float> vValues(m_numTweens, 0.0f);
+	vector<LegacyTween*> vpTweens;
+	vector<LegacyTween*> vpCreateTweens;
+	for (int i = 0; i < m_numTweens; i++)
+	{
+		LegacyTween* pTween = new LegacyTween();
+		pTween->m_variable = &vValues[i];
+		pTween->m_start = 0.0f;
+		pTween->m_end = 1.0f;
+		pTween->m_time = GetBenchmarkRandomValue(&m_randomSeed, 0.25f, 3.0f);
+		pTween->m_easing = (i % 3 == 0) ? 100.0f : ((i % 3 == 1) ? -100.0f : 0.0f);
+		pTween->m_elapsed = 0.0f;
+		pTween->m_erase = false;
+		vpCreateTweens.push_back(pTween);
+	}
+
+	vector<LegacyTimer*> vpTimers;
+	for (int i = 0; i < m_numTimers; i++)
+	{
+		bool looping = (i % 4) == 0;
+
+		LegacyTimer* pTimer = new LegacyTimer();
+		pTimer->m_elapsedTime = 0.0f;
+		pTimer->m_timeOutTime = looping ? GetBenchmarkRandomValue(&m_randomSeed, 0.05f, 1.0f) : GetBenchmarkRandomValue(&m_randomSeed, 0.5f, 30.0f);
+		pTimer->m_bLooping = looping;
+		pTimer->m_bFinished = false;
+		vpTimers.push_back(pTimer);
+	}
+
+	m_legacyInterpolator.Reset();
+	m_legacyInterpolator.m_numFinished = 0;
+	m_legacyTimers.Reset();
+	m_legacyTimers.m_numFinished = 0;
+
+	float delta = INTERPOLATOR_BENCHMARK_FRAME_TIME;
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		double start = GetBenchmarkTime();
+
+		vpTweens.insert(vpTweens.end(), vpCreateTweens.begin(), vpCreateTweens.end());
+		vpCreateTweens.clear();
+		vpTweens.erase(remove_if(vpTweens.begin(), vpTweens.end(), LegacyTweenNeedsErasing), vpTweens.end());
+
+		for (unsigned int i = 0; i < vpTweens.size(); i++)
+		{
+			LegacyTween* pTween = vpTweens[i];
+			if (pTween->m_elapsed < pTween->m_time)
+			{
+				float lTimeRatio = pTween->m_elapsed / pTween->m_time;
+				float lX = (pTween->m_easing * 0.005f) + 0.5f;
+				Bezier3 lEaseBezier = Bezier3(vec3(0.0f, 0.0f, 0.0f), vec3(1.0f, 1.0f, 0.0f), vec3(lX, 1.0f - lX, 0.0f));
+				(*pTween->m_variable) = pTween->m_start + ((pTween->m_end - pTween->m_start) * lEaseBezier.GetInterpolatedPoint(lTimeRatio).y);
+				pTween->m_elapsed += delta;
+			}
+			else
+			{
+				(*pTween->m_variable) = pTween->m_end;
+				pTween->m_erase = true;
+				m_legacyInterpolator.m_numFinished++;
+
+				// Restart it, the same as the pooled run's finished callback
+				LegacyTween* pNewTween = new LegacyTween(*pTween);
+				pNewTween->m_start = pTween->m_end;
+				pNewTween->m_end = 1.0f - pTween->m_end;
+				pNewTween->m_time = GetBenchmarkRandomValue(&m_randomSeed, 0.25f, 3.0f);
+				pNewTween->m_elapsed = 0.0f;
+				pNewTween->m_erase = false;
+				vpCreateTweens.push_back(pNewTween);
+			}
+		}
+
+		double end = GetBenchmarkTime();
+		m_legacyInterpolator.AddSample(end - start);
+
+		start = end;
+		for (unsigned int i = 0; i < vpTimers.size(); i++)
+		{
+			LegacyTimer* pTimer = vpTimers[i];
+			pTimer->m_elapsedTime += delta;
+			if (pTimer->m_elapsedTime >= pTimer->m_timeOutTime && pTimer->m_bFinished == false)
+			{
+				m_legacyTimers.m_numFinished++;
+
+				// One-shot timers are restarted from their callback in the pooled run
+				pTimer->m_elapsedTime = 0.0f;
+			}
+		}
+		end = GetBenchmarkTime();
+		m_legacyTimers.AddSample(end - start);
+	}
+
+	// Removing by variable was a search through the whole list
+	int numByVariable = m_numTweens / 2;
+	double start = GetBenchmarkTime();
+	for (int i = 0; i < numByVariable; i++)
+	{
+		for (unsigned int j = 0; j < vpTweens.size(); j++)
+		{
+			if (vpTweens[j]->m_variable == &vValues[i])
+			{
+				delete vpTweens[j];
+				vpTweens.erase(vpTweens.begin() + j);
+				break;
+			}
+		}
+	}
+	double end = GetBenchmarkTime();
+	m_legacyRemoveByVariableTime = numByVariable > 0 ? ((end - start) * 1000.0) / numByVariable : 0.0;
+
+	for (unsigned int i = 0; i < vpTweens.size(); i++)
+	{
+		delete vpTweens[i];
+	}
+	for (unsigned int i = 0; i < vpCreateTweens.size(); i++)
+	{
+		delete vpCreateTweens[i];
+	}
+	for (unsigned int i = 0; i < vpTimers.size(); i++)
+	{
+		delete vpTimers[i];
+	}
+}
+
+void InterpolatorBenchmark::StartTween(BenchmarkTween* pTween)
+{
+	// Bounce between 0 and 1 with a mix of easing curves
+	int index = (int)(pTween - &m_vTweens[0]);
+	float easing = (index % 3 == 0) ? 100.0f : ((index % 3 == 1) ? -100.0f : 0.0f);
+	float start = pTween->m_value;
+	float end = start < 0.5f ? 1.0f : 0.0f;
+
+	pTween->m_interpolation = Interpolator::GetInstance()->AddFloatInterpolation(&pTween->m_value, start, end, GetBenchmarkRandomValue(&m_randomSeed, 0.25f, 3.0f), easing, INVALID_INTERPOLATION, _TweenFinished, pTween);
+}
+
+void InterpolatorBenchmark::_TweenFinished(void *pData)
+{
+	BenchmarkTween* pTween = (BenchmarkTween*)pData;
+	pTween->m_pBenchmark->TweenFinished(pTween);
+}
+
+void InterpolatorBenchmark::TweenFinished(BenchmarkTween* pTween)
+{
+	m_numTweensFinished++;
+
+	StartTween(pTween);
+}
+
+void InterpolatorBenchmark::_TimerFinished(void *pData)
+{
+	BenchmarkTimer* pTimer = (BenchmarkTimer*)pData;
+	pTimer->m_pBenchmark->TimerFinished(pTimer);
+}
+
+void InterpolatorBenchmark::TimerFinished(BenchmarkTimer* pTimer)
+{
+	m_numTimersFinished++;
+
+	// Looping timers carry on by themselves, one-shot timers are started again
+	TimeManager::GetInstance()->ResetTimer(pTimer->m_timer);
+}
+
+// Reporting
+void InterpolatorBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"tweens\": " << m_numTweens << ",\n";
+	output << "  \"timers\": " << m_numTimers << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"pooled\": { ";
+	output << "\"interpolatorAverage\": " << m_pooledInterpolator.Average() << ", ";
+	output << "\"interpolatorMax\": " << m_pooledInterpolator.Max() << ", ";
+	output << "\"tweensFinished\": " << m_pooledInterpolator.m_numFinished << ", ";
+	output << "\"timersAverage\": " << m_pooledTimers.Average() << ", ";
+	output << "\"timersMax\": " << m_pooledTimers.Max() << ", ";
+	output << "\"timersFinished\": " << m_pooledTimers.m_numFinished << " },\n";
+	output << "  \"legacy\": { ";
+	output << "\"interpolatorAverage\": " << m_legacyInterpolator.Average() << ", ";
+	output << "\"interpolatorMax\": " << m_legacyInterpolator.Max() << ", ";
+	output << "\"tweensFinished\": " << m_legacyInterpolator.m_numFinished << ", ";
+	output << "\"timersAverage\": " << m_legacyTimers.Average() << ", ";
+	output << "\"timersMax\": " << m_legacyTimers.Max() << ", ";
+	output << "\"timersFinished\": " << m_legacyTimers.m_numFinished << " },\n";
+	output << "  \"cancel\": { ";
+	output << "\"byHandle\": " << m_removeByHandleTime << ", ";
+	output << "\"byVariable\": " << m_removeByVariableTime << ", ";
+	output << "\"timerByHandle\": " << m_removeTimerTime << ", ";
+	output << "\"legacyByVariable\": " << m_legacyRemoveByVariableTime << " }\n";
+	output << "}\n";
+}
@@ -0,0 +1,117 @@
+// ******************************************************************************
+// Filename:    InterpolatorBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless micro-benchmark for the interpolator and the countdown timers.
+//   Keeps a fixed number of tweens and timers alive for a number of frames,
+//   restarting each one as it finishes, and times the per frame update and
+//   the cost of cancelling them. The same workload is also run through a
+//   copy of the old heap allocated, tick everything per frame approach, so
+//   the report shows both side by side as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include "../utils/Interpolator.h"
+#include "../utils/TimeManager.h"
+
+#include <vector>
+#include <ostream>
+using namespace std;
+
+class InterpolatorBenchmark;
+
+// A tween kept running for the whole benchmark, it is restarted from its finished callback
+class BenchmarkTween
+{
+public:
+	InterpolatorBenchmark* m_pBenchmark;
+	float m_value;
+	InterpolationHandle m_interpolation;
+};
+
+// A timer kept running for the whole benchmark
+class BenchmarkTimer
+{
+public:
+	InterpolatorBenchmark* m_pBenchmark;
+	TimerHandle m_timer;
+};
+
+// Per frame update timings in microseconds
+class InterpolatorBenchmarkTimings : public HeadlessBenchmarkTimings
+{
+public:
+	int m_numFinished;
+};
+
+class InterpolatorBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	InterpolatorBenchmark();
+	~InterpolatorBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+	static void _TweenFinished(void *pData);
+	void TweenFinished(BenchmarkTween* pTween);
+
+	static void _TimerFinished(void *pData);
+	void TimerFinished(BenchmarkTimer* pTimer);
+
+private:
+	/* Private methods */
+	void RunPooled();
+	void RunLegacy();
+
+	void StartTween(BenchmarkTween* pTween);
+
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numTweens;
+	int m_numTimers;
+	int m_numFrames;
+
+	unsigned int m_randomSeed;
+
+	vector<BenchmarkTween> m_vTweens;
+	vector<BenchmarkTimer> m_vTimers;
+
+	int m_numTweensFinished;
+	int m_numTimersFinished;
+
+	// Results
+	InterpolatorBenchmarkTimings m_pooledInterpolator;
+	InterpolatorBenchmarkTimings m_pooledTimers;
+	InterpolatorBenchmarkTimings m_legacyInterpolator;
+	InterpolatorBenchmarkTimings m_legacyTimers;
+
+	// Cancellation timings, in nanoseconds per cancel
+	double m_removeByHandleTime;
+	double m_removeByVariableTime;
+	double m_removeTimerTime;
+	double m_legacyRemoveByVariableTime;
+};
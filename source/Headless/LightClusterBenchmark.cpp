@@ -0,0 +1,168 @@
+// ******************************************************************************
+// Filename:    LightClusterBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "LightClusterBenchmark.h"
+
+#include "../Renderer/lightclusters.h"
+
+#include <vector>
+#include <iomanip>
+
+const float LIGHT_CLUSTER_BENCHMARK_FRAME_TIME = 1.0f / 60.0f;
+
+
+LightClusterBenchmark::LightClusterBenchmark()
+{
+	m_numLights = 0;
+	m_numFrames = 0;
+	m_randomSeed = 1;
+
+	m_numBinnedLights = 0;
+	m_numDroppedLights = 0;
+	m_averageClusterLights = 0.0;
+	m_averageLitClusterLights = 0.0;
+	m_maxClusterLights = 0;
+	m_numMismatches = 0;
+}
+
+LightClusterBenchmark::~LightClusterBenchmark()
+{
+}
+
+// Running
+void LightClusterBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numLights = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	// The same projection the game uses, looking down -z from the origin
+	LightClusters* pLightClusters = new LightClusters();
+	pLightClusters->SetProjection(60.0f, 1024.0f / 768.0f, 0.1f, 100.0f);
+	pLightClusters->SetView(Matrix4x4());
+
+	// Torches, glows and spell effects, spread through the view and drifting about
+	m_randomSeed = 1;
+	vector<vec3> vPositions(m_numLights);
+	vector<vec3> vVelocities(m_numLights);
+	vector<float> vRadius(m_numLights);
+	for (int i = 0; i < m_numLights; i++)
+	{
+		float depth = GetBenchmarkRandomValue(&m_randomSeed, 0.5f, 60.0f);
+		vPositions[i] = vec3(GetBenchmarkRandomValue(&m_randomSeed, -0.8f, 0.8f) * depth, GetBenchmarkRandomValue(&m_randomSeed, -0.6f, 0.6f) * depth, -depth);
+		vVelocities[i] = vec3(GetBenchmarkRandomValue(&m_randomSeed, -1.0f, 1.0f), GetBenchmarkRandomValue(&m_randomSeed, -1.0f, 1.0f), GetBenchmarkRandomValue(&m_randomSeed, -1.0f, 1.0f));
+		vRadius[i] = GetBenchmarkRandomValue(&m_randomSeed, 0.5f, 6.0f);
+	}
+
+	m_clustered.Reset();
+	m_bruteForce.Reset();
+	m_averageClusterLights = 0.0;
+	m_averageLitClusterLights = 0.0;
+	m_maxClusterLights = 0;
+	m_numMismatches = 0;
+
+	vector<int> vBruteForceLights;
+	vector<int> vBruteForceOffsets(LIGHT_CLUSTERS_NUM + 1);
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		for (int i = 0; i < m_numLights; i++)
+		{
+			vPositions[i] += vVelocities[i] * LIGHT_CLUSTER_BENCHMARK_FRAME_TIME;
+		}
+
+		double start = GetBenchmarkTime();
+		pLightClusters->ClearLights();
+		for (int i = 0; i < m_numLights; i++)
+		{
+			pLightClusters->AddLight(vPositions[i], vRadius[i], Colour(1.0f, 0.8f, 0.6f), 1.0f);
+		}
+		pLightClusters->Build();
+		double end = GetBenchmarkTime();
+		m_clustered.AddSample(end - start);
+
+		// Every light against every cluster
+		start = GetBenchmarkTime();
+		vBruteForceLights.clear();
+		for (int cluster = 0; cluster < LIGHT_CLUSTERS_NUM; cluster++)
+		{
+			vBruteForceOffsets[cluster] = (int)vBruteForceLights.size();
+			for (int i = 0; i < pLightClusters->GetNumLights(); i++)
+			{
+				if (pLightClusters->LightIntersectsCluster(i, cluster))
+				{
+					vBruteForceLights.push_back(i);
+				}
+			}
+		}
+		vBruteForceOffsets[LIGHT_CLUSTERS_NUM] = (int)vBruteForceLights.size();
+		double bruteForceTime = GetBenchmarkTime() - start;
+
+		// Each cluster's list has to come out the same and in the same order
+		int numLitClusters = 0;
+		int numClusterLights = 0;
+		for (int cluster = 0; cluster < LIGHT_CLUSTERS_NUM; cluster++)
+		{
+			int numLightsInCluster = pLightClusters->GetClusterNumLights(cluster);
+			bool mismatch = numLightsInCluster != vBruteForceOffsets[cluster + 1] - vBruteForceOffsets[cluster];
+			for (int i = 0; i < numLightsInCluster && mismatch == false; i++)
+			{
+				mismatch = pLightClusters->GetClusterLight(cluster, i) != vBruteForceLights[vBruteForceOffsets[cluster] + i];
+			}
+
+			if (mismatch)
+			{
+				m_numMismatches++;
+			}
+
+			numClusterLights += numLightsInCluster;
+			if (numLightsInCluster > 0)
+			{
+				numLitClusters++;
+			}
+		}
+		m_bruteForce.AddSample(bruteForceTime);
+
+		m_averageClusterLights += (double)numClusterLights / LIGHT_CLUSTERS_NUM;
+		m_averageLitClusterLights += numLitClusters > 0 ? (double)numClusterLights / numLitClusters : 0.0;
+		m_maxClusterLights = pLightClusters->GetMaxClusterLights() > m_maxClusterLights ? pLightClusters->GetMaxClusterLights() : m_maxClusterLights;
+	}
+
+	m_averageClusterLights /= m_numFrames;
+	m_averageLitClusterLights /= m_numFrames;
+
+	m_numBinnedLights = pLightClusters->GetNumLights();
+	m_numDroppedLights = pLightClusters->GetNumDroppedLights();
+
+	delete pLightClusters;
+}
+
+// Reporting
+void LightClusterBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"lights\": " << m_numLights << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"clusters\": " << LIGHT_CLUSTERS_NUM << ",\n";
+	output << "  \"clustered\": { ";
+	output << "\"average\": " << m_clustered.Average() << ", ";
+	output << "\"max\": " << m_clustered.Max() << " },\n";
+	output << "  \"bruteForce\": { ";
+	output << "\"average\": " << m_bruteForce.Average() << ", ";
+	output << "\"max\": " << m_bruteForce.Max() << " },\n";
+	output << "  \"speedup\": " << (m_clustered.Average() > 0.0 ? m_bruteForce.Average() / m_clustered.Average() : 0.0) << ",\n";
+	output << "  \"binnedLights\": " << m_numBinnedLights << ",\n";
+	output << "  \"droppedLights\": " << m_numDroppedLights << ",\n";
+	output << "  \"lightsPerCluster\": " << m_averageClusterLights << ",\n";
+	output << "  \"lightsPerLitCluster\": " << m_averageLitClusterLights << ",\n";
+	output << "  \"mostLightsInACluster\": " << m_maxClusterLights << ",\n";
+	output << "  \"mismatches\": " << m_numMismatches << "\n";
+	output << "}\n";
+}
@@ -0,0 +1,68 @@
+// ******************************************************************************
+// Filename:    LightClusterBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless micro-benchmark and check for the light cluster binning.
+//   Moves a number of point lights around in front of the camera, bins them
+//   every frame and compares each cluster's light list against testing every
+//   light against every cluster, then reports the cost of both, how many
+//   lights the shader loops over for each cluster and any cluster where the
+//   lists disagree as JSON. Needs no GL context.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+using namespace std;
+
+class LightClusterBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	LightClusterBenchmark();
+	~LightClusterBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numLights;
+	int m_numFrames;
+
+	unsigned int m_randomSeed;
+
+	// Results
+	HeadlessBenchmarkTimings m_clustered;
+	HeadlessBenchmarkTimings m_bruteForce;
+	int m_numBinnedLights;
+	int m_numDroppedLights;
+	double m_averageClusterLights;
+	double m_averageLitClusterLights;
+	int m_maxClusterLights;
+	int m_numMismatches;
+};
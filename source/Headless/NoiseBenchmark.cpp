@@ -0,0 +1,183 @@
+// ******************************************************************************
+// Filename:    NoiseBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "NoiseBenchmark.h"
+
+#include "../simplex/simplexnoise.h"
+#include "../simplex/simplexbatch.h"
+#include "../room/RoomDecoration.h"
+
+#include <math.h>
+#include <vector>
+#include <iomanip>
+
+// The same settings the room decoration uses for its floor
+const float NOISE_BENCHMARK_OCTAVES = 3.0f;
+const float NOISE_BENCHMARK_PERSISTENCE = 0.5f;
+const float NOISE_BENCHMARK_SCALE = 0.15f;
+
+// The largest room the generator makes, in tiles
+const int NOISE_BENCHMARK_ROOM_TILES = 28;
+
+
+NoiseBenchmark::NoiseBenchmark()
+{
+	m_size = 0;
+	m_numIterations = 0;
+	m_roomBakeTime = 0.0;
+}
+
+NoiseBenchmark::~NoiseBenchmark()
+{
+}
+
+// Running
+void NoiseBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_size = settings.m_count > 0 ? settings.m_count : 1;
+	m_numIterations = settings.m_numIterations > 0 ? settings.m_numIterations : 1;
+
+	int numSamples = m_size * m_size;
+	double numTimedSamples = (double)numSamples * m_numIterations;
+	vector<float> vScalar(numSamples);
+	vector<float> vBatch(numSamples);
+
+	// Noise is only ever sampled away from the origin, so both signs of the floor are covered
+	const float originX = -0.37f * m_size;
+	const float originY = -0.61f * m_size;
+	const float z = 7.5f;
+
+	// 2D octave noise over the grid
+	double start = GetBenchmarkTime();
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		for (int row = 0; row < m_size; row++)
+		{
+			for (int column = 0; column < m_size; column++)
+			{
+				vScalar[row * m_size + column] = octave_noise_2d(NOISE_BENCHMARK_OCTAVES, NOISE_BENCHMARK_PERSISTENCE, NOISE_BENCHMARK_SCALE, originX + column, originY + row);
+			}
+		}
+	}
+	double end = GetBenchmarkTime();
+	m_octave2D.m_scalarTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	start = end;
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		octave_noise_2d_block(NOISE_BENCHMARK_OCTAVES, NOISE_BENCHMARK_PERSISTENCE, NOISE_BENCHMARK_SCALE, originX, originY, 1.0f, 1.0f, m_size, m_size, &vBatch[0]);
+	}
+	end = GetBenchmarkTime();
+	m_octave2D.m_batchTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	m_octave2D.m_maxError = 0.0;
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_octave2D.m_maxError = fmax(m_octave2D.m_maxError, fabs(vScalar[i] - vBatch[i]));
+	}
+
+	// 3D octave noise over a plane
+	start = GetBenchmarkTime();
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		for (int row = 0; row < m_size; row++)
+		{
+			for (int column = 0; column < m_size; column++)
+			{
+				vScalar[row * m_size + column] = octave_noise_3d(NOISE_BENCHMARK_OCTAVES, NOISE_BENCHMARK_PERSISTENCE, NOISE_BENCHMARK_SCALE, originX + column, originY + row, z);
+			}
+		}
+	}
+	end = GetBenchmarkTime();
+	m_octave3D.m_scalarTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	start = end;
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		octave_noise_3d_block(NOISE_BENCHMARK_OCTAVES, NOISE_BENCHMARK_PERSISTENCE, NOISE_BENCHMARK_SCALE, originX, originY, z, 1.0f, 1.0f, m_size, m_size, &vBatch[0]);
+	}
+	end = GetBenchmarkTime();
+	m_octave3D.m_batchTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	m_octave3D.m_maxError = 0.0;
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_octave3D.m_maxError = fmax(m_octave3D.m_maxError, fabs(vScalar[i] - vBatch[i]));
+	}
+
+	// Raw 3D noise at scattered positions
+	vector<float> vX(numSamples);
+	vector<float> vY(numSamples);
+	vector<float> vZ(numSamples);
+	for (int i = 0; i < numSamples; i++)
+	{
+		vX[i] = originX + (i % m_size) * 0.73f;
+		vY[i] = originY + (i / m_size) * 0.41f;
+		vZ[i] = z + (i % 7) * 1.3f;
+	}
+
+	start = GetBenchmarkTime();
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		for (int i = 0; i < numSamples; i++)
+		{
+			vScalar[i] = raw_noise_3d(vX[i], vY[i], vZ[i]);
+		}
+	}
+	end = GetBenchmarkTime();
+	m_raw3D.m_scalarTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	start = end;
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		raw_noise_3d_batch(&vX[0], &vY[0], &vZ[0], numSamples, &vBatch[0]);
+	}
+	end = GetBenchmarkTime();
+	m_raw3D.m_batchTime = (end - start) * 1000000.0 / numTimedSamples;
+
+	m_raw3D.m_maxError = 0.0;
+	for (int i = 0; i < numSamples; i++)
+	{
+		m_raw3D.m_maxError = fmax(m_raw3D.m_maxError, fabs(vScalar[i] - vBatch[i]));
+	}
+
+	// A full room decoration bake, on this thread
+	RoomDecoration decoration;
+	start = GetBenchmarkTime();
+	for (int iteration = 0; iteration < m_numIterations; iteration++)
+	{
+		RoomDecorationBaker::BakeDecoration(originX + iteration, originY, NOISE_BENCHMARK_ROOM_TILES, NOISE_BENCHMARK_ROOM_TILES, &decoration);
+	}
+	end = GetBenchmarkTime();
+	m_roomBakeTime = (end - start) * 1000.0 / m_numIterations;
+}
+
+// Reporting
+void NoiseBenchmark::WriteReport(ostream& output)
+{
+	const char* names[3] = { "octave2D", "octave3D", "raw3D" };
+	const NoiseBenchmarkTimings* pTimings[3] = { &m_octave2D, &m_octave3D, &m_raw3D };
+
+	output << fixed << setprecision(4);
+	output << "{\n";
+	output << "  \"size\": " << m_size << ",\n";
+	output << "  \"iterations\": " << m_numIterations << ",\n";
+	for (int i = 0; i < 3; i++)
+	{
+		output << "  \"" << names[i] << "\": { ";
+		output << "\"scalar\": " << pTimings[i]->m_scalarTime << ", ";
+		output << "\"batch\": " << pTimings[i]->m_batchTime << ", ";
+		output << "\"speedup\": " << (pTimings[i]->m_batchTime > 0.0 ? pTimings[i]->m_scalarTime / pTimings[i]->m_batchTime : 0.0) << ", ";
+		output << "\"maxError\": " << scientific << pTimings[i]->m_maxError << fixed << " },\n";
+	}
+	output << "  \"roomBake\": " << m_roomBakeTime << "\n";
+	output << "}\n";
+}
@@ -0,0 +1,70 @@
+// ******************************************************************************
+// Filename:    NoiseBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless noise benchmark. Evaluates a square grid of simplex noise one
+//   sample per call and then with the batched functions, and times a room
+//   decoration bake, then reports the per sample costs and the largest
+//   difference between the two paths as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+using namespace std;
+
+// Per sample timings in nanoseconds
+class NoiseBenchmarkTimings
+{
+public:
+	double m_scalarTime;
+	double m_batchTime;
+	double m_maxError;
+};
+
+class NoiseBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	NoiseBenchmark();
+	~NoiseBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_size;
+	int m_numIterations;
+
+	NoiseBenchmarkTimings m_octave2D;
+	NoiseBenchmarkTimings m_octave3D;
+	NoiseBenchmarkTimings m_raw3D;
+
+	// Average time to bake one room's decoration, in microseconds
+	double m_roomBakeTime;
+};
@@ -0,0 +1,380 @@
+// ******************************************************************************
+// Filename:    ParticleBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ParticleBenchmark.h"
+
+#include "../Renderer/Renderer.h"
+#include "../Particles/ParticleManager.h"
+
+#include <vector>
+#include <iomanip>
+
+const float PARTICLE_BENCHMARK_FRAME_TIME = 1.0f / 60.0f;
+const unsigned int PARTICLE_BENCHMARK_SEED = 1234;
+const int PARTICLE_BENCHMARK_NUM_EFFECTS = 3;
+
+
+// The effects every emitter picks from, sparks, smoke and a glow
+static ParticleEffectParams GetBenchmarkEffect(int index)
+{
+	ParticleEffectParams params;
+	params.m_fileName = "benchmark";
+	params.m_textureFileName = "none";
+	params.m_positionSpread = vec3(0.05f, 0.05f, 0.05f);
+	params.m_startColour = Colour(1.0f, 1.0f, 1.0f, 1.0f);
+	params.m_endColour = Colour(1.0f, 1.0f, 1.0f, 0.0f);
+
+	if (index == 0)
+	{
+		params.m_emissionRate = 60.0f;
+		params.m_maxParticles = 40;
+		params.m_lifeTimeMin = 0.3f;
+		params.m_lifeTimeMax = 0.6f;
+		params.m_velocity = vec3(0.0f, 2.0f, 0.0f);
+		params.m_velocitySpread = vec3(1.5f, 1.0f, 1.5f);
+		params.m_gravity = vec3(0.0f, -9.8f, 0.0f);
+		params.m_startSize = 0.02f;
+		params.m_endSize = 0.0f;
+		params.m_startColour = Colour(1.0f, 0.8f, 0.2f, 1.0f);
+	}
+	else if (index == 1)
+	{
+		params.m_emissionRate = 20.0f;
+		params.m_maxParticles = 30;
+		params.m_lifeTimeMin = 1.0f;
+		params.m_lifeTimeMax = 1.5f;
+		params.m_velocity = vec3(0.0f, 0.5f, 0.0f);
+		params.m_velocitySpread = vec3(0.2f, 0.1f, 0.2f);
+		params.m_gravity = vec3(0.0f, 0.2f, 0.0f);
+		params.m_startSize = 0.05f;
+		params.m_endSize = 0.2f;
+		params.m_startColour = Colour(0.5f, 0.5f, 0.5f, 0.8f);
+	}
+	else
+	{
+		params.m_emissionRate = 10.0f;
+		params.m_maxParticles = 8;
+		params.m_lifeTimeMin = 0.5f;
+		params.m_lifeTimeMax = 0.8f;
+		params.m_velocity = vec3(0.0f, 0.0f, 0.0f);
+		params.m_velocitySpread = vec3(0.05f, 0.05f, 0.05f);
+		params.m_gravity = vec3(0.0f, 0.0f, 0.0f);
+		params.m_startSize = 0.1f;
+		params.m_endSize = 0.15f;
+		params.m_startColour = Colour(0.3f, 0.6f, 1.0f, 1.0f);
+	}
+
+	return params;
+}
+
+// Where an emitter is on a given frame, each one swings around its own spot like a weapon being waved
+static vec3 GetEmitterPosition(int emitterIndex, int frame)
+{
+	float angle = (frame * PARTICLE_BENCHMARK_FRAME_TIME * 4.0f) + emitterIndex;
+	return vec3((float)(emitterIndex % 32) + cos(angle) * 0.5f, 1.0f + sin(angle) * 0.25f, (float)(emitterIndex / 32) + sin(angle) * 0.5f);
+}
+
+static unsigned int HashValue(unsigned int hash, const void* pData, int numBytes)
+{
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	for (int i = 0; i < numBytes; i++)
+	{
+		hash = (hash ^ pBytes[i]) * 16777619u;
+	}
+
+	return hash;
+}
+
+
+// The old approach, every emitter owns a list of particle objects and is drawn with its own call
+class LegacyParticle
+{
+public:
+	vec3 m_position;
+	vec3 m_velocity;
+	vec3 m_acceleration;
+	Colour m_colour;
+	Colour m_colourDelta;
+	float m_size;
+	float m_sizeDelta;
+	float m_age;
+	float m_lifeTime;
+};
+
+class LegacyEmitter
+{
+public:
+	int m_effectIndex;
+	vec3 m_position;
+	float m_emissionAccumulator;
+	unsigned int m_randomSeed;
+	vector<LegacyParticle> m_vParticles;
+	vector<float> m_vVertices;
+};
+
+static void LegacyUpdateEmitter(LegacyEmitter* pEmitter, const ParticleEffectParams& params, float dt)
+{
+	for (unsigned int i = 0; i < pEmitter->m_vParticles.size(); i++)
+	{
+		LegacyParticle* pParticle = &pEmitter->m_vParticles[i];
+		pParticle->m_velocity += pParticle->m_acceleration * dt;
+		pParticle->m_position += pParticle->m_velocity * dt;
+		pParticle->m_colour.SetRed(pParticle->m_colour.GetRed() + pParticle->m_colourDelta.GetRed() * dt);
+		pParticle->m_colour.SetGreen(pParticle->m_colour.GetGreen() + pParticle->m_colourDelta.GetGreen() * dt);
+		pParticle->m_colour.SetBlue(pParticle->m_colour.GetBlue() + pParticle->m_colourDelta.GetBlue() * dt);
+		pParticle->m_colour.SetAlpha(pParticle->m_colour.GetAlpha() + pParticle->m_colourDelta.GetAlpha() * dt);
+		pParticle->m_size += pParticle->m_sizeDelta * dt;
+		pParticle->m_age += dt;
+	}
+
+	for (int i = (int)pEmitter->m_vParticles.size() - 1; i >= 0; i--)
+	{
+		if (pEmitter->m_vParticles[i].m_age >= pEmitter->m_vParticles[i].m_lifeTime)
+		{
+			pEmitter->m_vParticles.erase(pEmitter->m_vParticles.begin() + i);
+		}
+	}
+
+	pEmitter->m_emissionAccumulator += params.m_emissionRate * dt;
+	int numToEmit = (int)pEmitter->m_emissionAccumulator;
+	pEmitter->m_emissionAccumulator -= numToEmit;
+
+	for (int i = 0; i < numToEmit && (int)pEmitter->m_vParticles.size() < params.m_maxParticles; i++)
+	{
+		LegacyParticle particle;
+		float lifeTime = GetBenchmarkRandomValue(&pEmitter->m_randomSeed, params.m_lifeTimeMin, params.m_lifeTimeMax);
+		particle.m_position = pEmitter->m_position + vec3(GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.x, params.m_positionSpread.x), GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.y, params.m_positionSpread.y), GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.z, params.m_positionSpread.z));
+		particle.m_velocity = params.m_velocity + vec3(GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.x, params.m_velocitySpread.x), GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.y, params.m_velocitySpread.y), GetBenchmarkRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.z, params.m_velocitySpread.z));
+		particle.m_acceleration = params.m_gravity;
+		particle.m_colour = params.m_startColour;
+		particle.m_colourDelta = Colour((params.m_endColour.GetRed() - params.m_startColour.GetRed()) / lifeTime, (params.m_endColour.GetGreen() - params.m_startColour.GetGreen()) / lifeTime,
+			(params.m_endColour.GetBlue() - params.m_startColour.GetBlue()) / lifeTime, (params.m_endColour.GetAlpha() - params.m_startColour.GetAlpha()) / lifeTime);
+		particle.m_size = params.m_startSize;
+		particle.m_sizeDelta = (params.m_endSize - params.m_startSize) / lifeTime;
+		particle.m_age = 0.0f;
+		particle.m_lifeTime = lifeTime;
+
+		pEmitter->m_vParticles.push_back(particle);
+	}
+}
+
+static void LegacyBuildVertices(LegacyEmitter* pEmitter, vec3 cameraRight, vec3 cameraUp)
+{
+	const float cornerX[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+	const float cornerY[4] = { -1.0f, -1.0f, 1.0f, 1.0f };
+	const float textureS[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+	const float textureT[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	pEmitter->m_vVertices.clear();
+	for (unsigned int i = 0; i < pEmitter->m_vParticles.size(); i++)
+	{
+		const LegacyParticle& particle = pEmitter->m_vParticles[i];
+		for (int corner = 0; corner < 4; corner++)
+		{
+			vec3 cornerPosition = particle.m_position + (cameraRight * particle.m_size * cornerX[corner]) + (cameraUp * particle.m_size * cornerY[corner]);
+			pEmitter->m_vVertices.push_back(cornerPosition.x);
+			pEmitter->m_vVertices.push_back(cornerPosition.y);
+			pEmitter->m_vVertices.push_back(cornerPosition.z);
+			pEmitter->m_vVertices.push_back(particle.m_colour.GetRed());
+			pEmitter->m_vVertices.push_back(particle.m_colour.GetGreen());
+			pEmitter->m_vVertices.push_back(particle.m_colour.GetBlue());
+			pEmitter->m_vVertices.push_back(particle.m_colour.GetAlpha());
+			pEmitter->m_vVertices.push_back(textureS[corner]);
+			pEmitter->m_vVertices.push_back(textureT[corner]);
+		}
+	}
+}
+
+
+ParticleBenchmark::ParticleBenchmark()
+{
+	m_numEmitters = 0;
+	m_numFrames = 0;
+
+	m_numParticles = 0;
+	m_numPools = 0;
+	m_numDroppedParticles = 0;
+	m_numLegacyParticles = 0;
+	m_numLegacyDraws = 0;
+	m_checksum = 0;
+	m_deterministic = false;
+}
+
+ParticleBenchmark::~ParticleBenchmark()
+{
+}
+
+// Running
+void ParticleBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numEmitters = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	Renderer* pRenderer = new Renderer(1024, 768, 32, 8);
+
+	// Two managers from the same seed have to produce exactly the same particles
+	ParticleManager* pParticleManager = new ParticleManager(pRenderer);
+	m_checksum = RunPooled(pParticleManager, true);
+	m_numParticles = pParticleManager->GetNumParticles();
+	m_numPools = pParticleManager->GetNumPools();
+	m_numDroppedParticles = pParticleManager->GetNumDroppedParticles();
+	delete pParticleManager;
+
+	pParticleManager = new ParticleManager(pRenderer);
+	m_deterministic = RunPooled(pParticleManager, false) == m_checksum;
+	delete pParticleManager;
+
+	delete pRenderer;
+
+	RunLegacy();
+}
+
+unsigned int ParticleBenchmark::RunPooled(ParticleManager* pParticleManager, bool recordTimings)
+{
+	for (int i = 0; i < PARTICLE_BENCHMARK_NUM_EFFECTS; i++)
+	{
+		pParticleManager->AddEffect(GetBenchmarkEffect(i));
+	}
+
+	pParticleManager->SetRandomSeed(PARTICLE_BENCHMARK_SEED);
+	vector<unsigned int> vEmitterIds(m_numEmitters);
+	for (int i = 0; i < m_numEmitters; i++)
+	{
+		vEmitterIds[i] = pParticleManager->CreateEmitter(i % PARTICLE_BENCHMARK_NUM_EFFECTS, GetEmitterPosition(i, 0), NULL);
+	}
+
+	HeadlessBenchmarkTimings updateTimings;
+	HeadlessBenchmarkTimings verticesTimings;
+
+	unsigned int checksum = 2166136261u;
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		double start = GetBenchmarkTime();
+		for (int i = 0; i < m_numEmitters; i++)
+		{
+			pParticleManager->SetEmitterPosition(vEmitterIds[i], GetEmitterPosition(i, frame));
+		}
+		pParticleManager->Update(PARTICLE_BENCHMARK_FRAME_TIME);
+		double end = GetBenchmarkTime();
+		updateTimings.AddSample(end - start);
+
+		start = end;
+		pParticleManager->BuildVertices(vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+		end = GetBenchmarkTime();
+		verticesTimings.AddSample(end - start);
+
+		int numParticles = pParticleManager->GetNumParticles();
+		checksum = HashValue(checksum, &numParticles, sizeof(numParticles));
+	}
+
+	// Every vertex of the last frame, bit for bit
+	for (int i = 0; i < pParticleManager->GetNumPools(); i++)
+	{
+		int numVertices;
+		const float* pVertices = pParticleManager->GetPoolVertices(i, &numVertices);
+		if (numVertices > 0)
+		{
+			checksum = HashValue(checksum, pVertices, numVertices * PARTICLE_VERTEX_FLOATS * sizeof(float));
+		}
+	}
+
+	if (recordTimings)
+	{
+		m_pooledUpdate = updateTimings;
+		m_pooledVertices = verticesTimings;
+	}
+
+	return checksum;
+}
+
+void ParticleBenchmark::RunLegacy()
+{
+	ParticleEffectParams effects[PARTICLE_BENCHMARK_NUM_EFFECTS];
+	for (int i = 0; i < PARTICLE_BENCHMARK_NUM_EFFECTS; i++)
+	{
+		effects[i] = GetBenchmarkEffect(i);
+	}
+
+	vector<LegacyEmitter> vEmitters(m_numEmitters);
+	for (int i = 0; i < m_numEmitters; i++)
+	{
+		vEmitters[i].m_effectIndex = i % PARTICLE_BENCHMARK_NUM_EFFECTS;
+		vEmitters[i].m_position = GetEmitterPosition(i, 0);
+		vEmitters[i].m_emissionAccumulator = 0.0f;
+		vEmitters[i].m_randomSeed = (PARTICLE_BENCHMARK_SEED * 2654435761u) ^ ((i + 1) * 40503u);
+	}
+
+	m_legacyUpdate.Reset();
+	m_legacyVertices.Reset();
+
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		double start = GetBenchmarkTime();
+		for (int i = 0; i < m_numEmitters; i++)
+		{
+			vEmitters[i].m_position = GetEmitterPosition(i, frame);
+			LegacyUpdateEmitter(&vEmitters[i], effects[vEmitters[i].m_effectIndex], PARTICLE_BENCHMARK_FRAME_TIME);
+		}
+		double end = GetBenchmarkTime();
+		m_legacyUpdate.AddSample(end - start);
+
+		start = end;
+		for (int i = 0; i < m_numEmitters; i++)
+		{
+			LegacyBuildVertices(&vEmitters[i], vec3(1.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
+		}
+		end = GetBenchmarkTime();
+		m_legacyVertices.AddSample(end - start);
+	}
+
+	// One draw for every emitter that has anything to show
+	m_numLegacyParticles = 0;
+	m_numLegacyDraws = 0;
+	for (int i = 0; i < m_numEmitters; i++)
+	{
+		m_numLegacyParticles += (int)vEmitters[i].m_vParticles.size();
+		if (vEmitters[i].m_vParticles.empty() == false)
+		{
+			m_numLegacyDraws++;
+		}
+	}
+}
+
+// Reporting
+void ParticleBenchmark::WriteReport(ostream& output)
+{
+	double pooledTime = m_pooledUpdate.Average() + m_pooledVertices.Average();
+	double legacyTime = m_legacyUpdate.Average() + m_legacyVertices.Average();
+
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"emitters\": " << m_numEmitters << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"pooled\": { ";
+	output << "\"update\": " << m_pooledUpdate.Average() << ", ";
+	output << "\"updateMax\": " << m_pooledUpdate.Max() << ", ";
+	output << "\"vertices\": " << m_pooledVertices.Average() << ", ";
+	output << "\"verticesMax\": " << m_pooledVertices.Max() << ", ";
+	output << "\"particles\": " << m_numParticles << ", ";
+	output << "\"draws\": " << m_numPools << ", ";
+	output << "\"dropped\": " << m_numDroppedParticles << " },\n";
+	output << "  \"legacy\": { ";
+	output << "\"update\": " << m_legacyUpdate.Average() << ", ";
+	output << "\"updateMax\": " << m_legacyUpdate.Max() << ", ";
+	output << "\"vertices\": " << m_legacyVertices.Average() << ", ";
+	output << "\"verticesMax\": " << m_legacyVertices.Max() << ", ";
+	output << "\"particles\": " << m_numLegacyParticles << ", ";
+	output << "\"draws\": " << m_numLegacyDraws << " },\n";
+	output << "  \"speedup\": " << (pooledTime > 0.0 ? legacyTime / pooledTime : 0.0) << ",\n";
+	output << "  \"checksum\": " << m_checksum << ",\n";
+	output << "  \"deterministic\": " << (m_deterministic ? "true" : "false") << "\n";
+	output << "}\n";
+}
@@ -0,0 +1,74 @@
+// ******************************************************************************
+// Filename:    ParticleBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless micro-benchmark for the particle manager. Runs a number of
+//   emitters through the pooled particle update and vertex build, and
+//   through a copy of the old style where every emitter keeps its own list
+//   of particle objects and is drawn on its own. The pooled run is done
+//   twice from the same seed to check it is deterministic, then the per
+//   frame costs, draw counts and dropped particles are reported as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+using namespace std;
+
+class ParticleManager;
+
+class ParticleBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	ParticleBenchmark();
+	~ParticleBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	unsigned int RunPooled(ParticleManager* pParticleManager, bool recordTimings);
+	void RunLegacy();
+
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numEmitters;
+	int m_numFrames;
+
+	// Results
+	HeadlessBenchmarkTimings m_pooledUpdate;
+	HeadlessBenchmarkTimings m_pooledVertices;
+	HeadlessBenchmarkTimings m_legacyUpdate;
+	HeadlessBenchmarkTimings m_legacyVertices;
+	int m_numParticles;
+	int m_numPools;
+	int m_numDroppedParticles;
+	int m_numLegacyParticles;
+	int m_numLegacyDraws;
+	unsigned int m_checksum;
+	bool m_deterministic;
+};
@@ -0,0 +1,151 @@
+// ******************************************************************************
+// Filename:    TextureBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "TextureBenchmark.h"
+
+#include "../Renderer/tga.h"
+#include "../Renderer/texturecache.h"
+#include "../utils/FileUtils.h"
+
+#include <iomanip>
+
+// Kept apart from the game's cache, so the benchmark always measures its own freshly written files
+const char* TEXTURE_BENCHMARK_CACHE_DIRECTORY = "cache/texturebenchmark";
+
+
+TextureBenchmark::TextureBenchmark()
+{
+	m_numIterations = 0;
+}
+
+TextureBenchmark::~TextureBenchmark()
+{
+}
+
+// Running
+void TextureBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_directory = settings.m_argument;
+	m_numIterations = settings.m_numIterations > 0 ? settings.m_numIterations : 1;
+	m_vResults.clear();
+
+	unsigned int flags = TextureImageFlags_FlipVertical | TextureImageFlags_MipMaps;
+
+	vector<string> fileNames = listFilesInDirectoryRecursive(m_directory, ".tga");
+	for (unsigned int i = 0; i < fileNames.size(); i++)
+	{
+		TextureBenchmarkResult result;
+		result.m_fileName = fileNames[i];
+		result.m_fileSize = 0;
+		result.m_width = 0;
+		result.m_height = 0;
+		result.m_numMipLevels = 0;
+		result.m_decodeTime = 0.0;
+		result.m_pipelineTime = 0.0;
+		result.m_cachedTime = 0.0;
+
+		// Make sure the file decodes, and write its cache file, before timing anything
+		TextureImage image;
+		if (LoadTextureImage(fileNames[i], flags, TEXTURE_BENCHMARK_CACHE_DIRECTORY, &image) == false)
+		{
+			continue;
+		}
+		result.m_width = image.m_width;
+		result.m_height = image.m_height;
+		result.m_numMipLevels = image.GetNumMipLevels();
+		image.Release();
+
+		FILE* pFile = fopen(fileNames[i].c_str(), "rb");
+		if (pFile != NULL)
+		{
+			fseek(pFile, 0, SEEK_END);
+			result.m_fileSize = ftell(pFile);
+			fclose(pFile);
+		}
+
+		for (int iteration = 0; iteration < m_numIterations; iteration++)
+		{
+			// Raw decode only
+			double start = GetBenchmarkTime();
+			unsigned char* pPixels = NULL;
+			int width;
+			int height;
+			LoadFileTGA(fileNames[i].c_str(), &pPixels, &width, &height, true);
+			delete[] pPixels;
+			double end = GetBenchmarkTime();
+			result.m_decodeTime += end - start;
+
+			// Decode and build the mip chain, without the cache
+			start = end;
+			LoadTextureImage(fileNames[i], flags, NULL, &image);
+			image.Release();
+			end = GetBenchmarkTime();
+			result.m_pipelineTime += end - start;
+
+			// Straight from the cache file
+			start = end;
+			LoadTextureImage(fileNames[i], flags, TEXTURE_BENCHMARK_CACHE_DIRECTORY, &image);
+			image.Release();
+			end = GetBenchmarkTime();
+			result.m_cachedTime += end - start;
+		}
+
+		result.m_decodeTime /= m_numIterations;
+		result.m_pipelineTime /= m_numIterations;
+		result.m_cachedTime /= m_numIterations;
+
+		m_vResults.push_back(result);
+	}
+}
+
+// Reporting
+void TextureBenchmark::WriteReport(ostream& output)
+{
+	double totalDecodeTime = 0.0;
+	double totalPipelineTime = 0.0;
+	double totalCachedTime = 0.0;
+	long totalFileSize = 0;
+
+	for (unsigned int i = 0; i < m_vResults.size(); i++)
+	{
+		totalDecodeTime += m_vResults[i].m_decodeTime;
+		totalPipelineTime += m_vResults[i].m_pipelineTime;
+		totalCachedTime += m_vResults[i].m_cachedTime;
+		totalFileSize += m_vResults[i].m_fileSize;
+	}
+
+	output << fixed << setprecision(4);
+	output << "{\n";
+	output << "  \"directory\": \"" << m_directory << "\",\n";
+	output << "  \"iterations\": " << m_numIterations << ",\n";
+	output << "  \"files\": " << m_vResults.size() << ",\n";
+	output << "  \"bytes\": " << totalFileSize << ",\n";
+	output << "  \"totals\": { ";
+	output << "\"decode\": " << totalDecodeTime << ", ";
+	output << "\"pipeline\": " << totalPipelineTime << ", ";
+	output << "\"cached\": " << totalCachedTime << ", ";
+	output << "\"cacheSpeedup\": " << (totalCachedTime > 0.0 ? totalPipelineTime / totalCachedTime : 0.0) << " },\n";
+	output << "  \"textures\": [\n";
+	for (unsigned int i = 0; i < m_vResults.size(); i++)
+	{
+		const TextureBenchmarkResult& result = m_vResults[i];
+		output << "    { \"file\": \"" << result.m_fileName << "\", ";
+		output << "\"width\": " << result.m_width << ", ";
+		output << "\"height\": " << result.m_height << ", ";
+		output << "\"mipLevels\": " << result.m_numMipLevels << ", ";
+		output << "\"decode\": " << result.m_decodeTime << ", ";
+		output << "\"pipeline\": " << result.m_pipelineTime << ", ";
+		output << "\"cached\": " << result.m_cachedTime << " }";
+		output << ((i < m_vResults.size() - 1) ? ",\n" : "\n");
+	}
+	output << "  ]\n";
+	output << "}\n";
+}
@@ -0,0 +1,72 @@
+// ******************************************************************************
+// Filename:    TextureBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless texture decode benchmark. Finds every TGA under a directory and
+//   times the raw decode, the full CPU pipeline (decode and mip chain) and a
+//   load from the texture cache, then reports the timings as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+using namespace std;
+
+// Timings for a single file, averaged over the iterations, in milliseconds
+class TextureBenchmarkResult
+{
+public:
+	string m_fileName;
+	long m_fileSize;
+	int m_width;
+	int m_height;
+	int m_numMipLevels;
+
+	double m_decodeTime;
+	double m_pipelineTime;
+	double m_cachedTime;
+};
+
+class TextureBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	TextureBenchmark();
+	~TextureBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	string m_directory;
+	int m_numIterations;
+
+	vector<TextureBenchmarkResult> m_vResults;
+};
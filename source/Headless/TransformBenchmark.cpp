@@ -0,0 +1,166 @@
+// ******************************************************************************
+// Filename:    TransformBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "TransformBenchmark.h"
+
+#include "../Maths/TransformHierarchy.h"
+
+#include <vector>
+#include <iomanip>
+#include <math.h>
+
+// Matrices in the wood tile file
+const int TRANSFORM_BENCHMARK_TILE_MATRICES = 4;
+
+const float TRANSFORM_BENCHMARK_TILE_SCALE = 0.03125f;
+const float TRANSFORM_BENCHMARK_TOLERANCE = 0.0001f;
+
+
+TransformBenchmark::TransformBenchmark()
+{
+	m_numTiles = 0;
+	m_numFrames = 0;
+	m_numNodes = 0;
+
+	m_numStaticUpdated = 0;
+	m_numMovingUpdated = 0;
+	m_numMismatches = 0;
+}
+
+TransformBenchmark::~TransformBenchmark()
+{
+}
+
+// Running
+void TransformBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numTiles = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	m_everyFrame.Reset();
+	m_cachedStatic.Reset();
+	m_cachedMoving.Reset();
+	m_numStaticUpdated = 0;
+	m_numMovingUpdated = 0;
+	m_numMismatches = 0;
+
+	// A square floor of tiles, the matrices inside each tile offset like the tile file's are
+	int floorWidth = (int)ceil(sqrt((double)m_numTiles));
+	vector<vec3> vTilePositions(m_numTiles);
+	for (int i = 0; i < m_numTiles; i++)
+	{
+		vTilePositions[i] = vec3((i % floorWidth) * 1.0f, 0.0f, (i / floorWidth) * 1.0f);
+	}
+
+	Matrix4x4 matrixLocals[TRANSFORM_BENCHMARK_TILE_MATRICES];
+	for (int i = 0; i < TRANSFORM_BENCHMARK_TILE_MATRICES; i++)
+	{
+		matrixLocals[i].SetTranslation(vec3(-15.5f + (i % 2) * 16.0f, 0.5f, -15.5f + (i / 2) * 16.0f));
+	}
+
+	TransformHierarchy* pTransforms = new TransformHierarchy();
+	vector<int> vMatrixTransformIds;
+	for (int i = 0; i < m_numTiles; i++)
+	{
+		int tileTransformId = pTransforms->CreateNode();
+		Matrix4x4 translate;
+		translate.SetTranslation(vTilePositions[i]);
+		Matrix4x4 scale;
+		scale.SetScale(vec3(TRANSFORM_BENCHMARK_TILE_SCALE, TRANSFORM_BENCHMARK_TILE_SCALE, TRANSFORM_BENCHMARK_TILE_SCALE));
+		pTransforms->SetLocalMatrix(tileTransformId, scale * translate);
+
+		for (int j = 0; j < TRANSFORM_BENCHMARK_TILE_MATRICES; j++)
+		{
+			int matrixTransformId = pTransforms->CreateNode(tileTransformId);
+			pTransforms->SetLocalMatrix(matrixTransformId, matrixLocals[j]);
+			vMatrixTransformIds.push_back(matrixTransformId);
+		}
+	}
+	int playerTransformId = pTransforms->CreateNode();
+	pTransforms->Update();
+
+	m_numNodes = pTransforms->GetNumNodes();
+
+	vector<Matrix4x4> vEveryFrameMatrices(vMatrixTransformIds.size());
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		// Every world matrix composed again, as pushing through the matrix stack every frame did
+		double start = GetBenchmarkTime();
+		for (int i = 0; i < m_numTiles; i++)
+		{
+			Matrix4x4 translate;
+			translate.SetTranslation(vTilePositions[i]);
+			Matrix4x4 scale;
+			scale.SetScale(vec3(TRANSFORM_BENCHMARK_TILE_SCALE, TRANSFORM_BENCHMARK_TILE_SCALE, TRANSFORM_BENCHMARK_TILE_SCALE));
+			Matrix4x4 tileMatrix = scale * translate;
+
+			for (int j = 0; j < TRANSFORM_BENCHMARK_TILE_MATRICES; j++)
+			{
+				Matrix4x4::Multiply(matrixLocals[j], tileMatrix, vEveryFrameMatrices[i * TRANSFORM_BENCHMARK_TILE_MATRICES + j]);
+			}
+		}
+		m_everyFrame.AddSample(GetBenchmarkTime() - start);
+
+		// Nothing moved
+		start = GetBenchmarkTime();
+		pTransforms->Update();
+		m_cachedStatic.AddSample(GetBenchmarkTime() - start);
+		m_numStaticUpdated += pTransforms->GetNumUpdated();
+
+		// Only the player moved
+		start = GetBenchmarkTime();
+		Matrix4x4 playerMatrix;
+		playerMatrix.SetTranslation(vec3(sin(frame * 0.01f) * floorWidth, 0.0f, cos(frame * 0.01f) * floorWidth));
+		pTransforms->SetLocalMatrix(playerTransformId, playerMatrix);
+		pTransforms->Update();
+		m_cachedMoving.AddSample(GetBenchmarkTime() - start);
+		m_numMovingUpdated += pTransforms->GetNumUpdated();
+
+		// The cached world matrices have to match the ones composed every frame
+		for (unsigned int i = 0; i < vMatrixTransformIds.size(); i++)
+		{
+			const Matrix4x4& cachedMatrix = pTransforms->GetWorldMatrix(vMatrixTransformIds[i]);
+			for (int k = 0; k < 16; k++)
+			{
+				if (fabs(cachedMatrix.m[k] - vEveryFrameMatrices[i].m[k]) > TRANSFORM_BENCHMARK_TOLERANCE)
+				{
+					m_numMismatches++;
+					break;
+				}
+			}
+		}
+	}
+
+	delete pTransforms;
+}
+
+// Reporting
+void TransformBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"tiles\": " << m_numTiles << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"nodes\": " << m_numNodes << ",\n";
+	output << "  \"everyFrame\": { ";
+	output << "\"average\": " << m_everyFrame.Average() << ", ";
+	output << "\"max\": " << m_everyFrame.Max() << " },\n";
+	output << "  \"cachedStatic\": { ";
+	output << "\"average\": " << m_cachedStatic.Average() << ", ";
+	output << "\"max\": " << m_cachedStatic.Max() << ", ";
+	output << "\"updatedPerFrame\": " << (double)m_numStaticUpdated / m_numFrames << " },\n";
+	output << "  \"cachedMoving\": { ";
+	output << "\"average\": " << m_cachedMoving.Average() << ", ";
+	output << "\"max\": " << m_cachedMoving.Max() << ", ";
+	output << "\"updatedPerFrame\": " << (double)m_numMovingUpdated / m_numFrames << " },\n";
+	output << "  \"mismatches\": " << m_numMismatches << "\n";
+	output << "}\n";
+}
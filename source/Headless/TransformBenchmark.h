@@ -0,0 +1,66 @@
+// ******************************************************************************
+// Filename:    TransformBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless micro-benchmark and check for the cached scene transforms.
+//   Lays out a number of tiles, each with a child node per matrix, plus a
+//   player that walks around, then compares composing every world matrix
+//   every frame, the way the matrix stack did, against updating the
+//   transform hierarchy for a static frame and for a frame where only the
+//   player moved. Reports the cost of each, how many matrices each update
+//   composed and any world matrix that disagrees as JSON. Needs no GL context.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+using namespace std;
+
+class TransformBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	TransformBenchmark();
+	~TransformBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numTiles;
+	int m_numFrames;
+	int m_numNodes;
+
+	// Results
+	HeadlessBenchmarkTimings m_everyFrame;
+	HeadlessBenchmarkTimings m_cachedStatic;
+	HeadlessBenchmarkTimings m_cachedMoving;
+	int m_numStaticUpdated;
+	int m_numMovingUpdated;
+	int m_numMismatches;
+};
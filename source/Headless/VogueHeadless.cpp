@@ -0,0 +1,696 @@
+// ******************************************************************************
+// Filename:    VogueHeadless.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "VogueHeadless.h"
+#include "HeadlessBenchmark.h"
+
+#include "../Renderer/postprocesschain.h"
+#include "../utils/Interpolator.h"
+#include "../utils/TimeManager.h"
+#include "../Scripting/ScriptManager.h"
+#include "../utils/Random.h"
+#include "../utils/Profiler.h"
+#include "../models/AnimatedSectionBatch.h"
+#include "../gui/selectionmanager.h"
+
+#include <fstream>
+#include <sstream>
+#include <iostream>
+#include <iomanip>
+#include <algorithm>
+
+// Size and layout of the buttons created by the 'gui' replay command
+const int HEADLESS_BUTTONS_PER_ROW = 100;
+const int HEADLESS_BUTTON_SIZE = 8;
+
+// Window size the GUI is laid out against
+const int HEADLESS_WINDOW_WIDTH = 1024;
+const int HEADLESS_WINDOW_HEIGHT = 768;
+
+// Camera the LOD report picks levels from, the game's starting camera and field of view
+const vec3 HEADLESS_CAMERA_POSITION = vec3(0.0f, 2.0f, 5.0f);
+const float HEADLESS_CAMERA_FOV = 60.0f;
+
+// Clip planes the visibility report builds its frustums with, the same as the renderer's
+const float HEADLESS_CAMERA_NEAR = 0.1f;
+const float HEADLESS_CAMERA_FAR = 10000.0f;
+
+
+bool replay_event_sort(const ReplayEvent& lhs, const ReplayEvent& rhs)
+{
+	return lhs.m_tick < rhs.m_tick;
+}
+
+VogueHeadless::VogueHeadless(VogueSettings* pVogueSettings)
+{
+	m_pVogueSettings = pVogueSettings;
+
+	m_pRenderer = NULL;
+	m_pGUI = NULL;
+	m_pGUIWindow = NULL;
+	m_GUIFont = 0;
+
+	m_pQubicleBinaryManager = NULL;
+	m_pInstanceManager = NULL;
+	m_pParticleManager = NULL;
+	m_pSceneTransforms = NULL;
+	m_pTileManager = NULL;
+	m_pRoomManager = NULL;
+	m_pPlayer = NULL;
+
+	m_nextReplayEvent = 0;
+
+	int tickRate = m_pVogueSettings->m_simulationTickRate > 0 ? m_pVogueSettings->m_simulationTickRate : 60;
+	m_fixedTimeStep = 1.0f / (float)tickRate;
+	m_numTicks = 0;
+
+	m_setupTime = 0.0;
+	m_runTime = 0.0;
+	for (int i = 0; i < HeadlessSubsystem_NUM; i++)
+	{
+		m_tickTimes[i] = 0.0;
+		m_timings[i].m_totalTime = 0.0;
+		m_timings[i].m_maxTickTime = 0.0;
+	}
+}
+
+VogueHeadless::~VogueHeadless()
+{
+	delete m_pRoomManager;
+	delete m_pTileManager;
+	delete m_pPlayer;
+	delete m_pSceneTransforms;
+
+	delete m_pParticleManager;
+	delete m_pInstanceManager;
+	delete m_pQubicleBinaryManager;
+
+	if (m_pGUIWindow != NULL)
+	{
+		m_pGUI->RemoveWindow(m_pGUIWindow);
+
+		for (unsigned int i = 0; i < m_vpGUIComponents.size(); i++)
+		{
+			m_pGUIWindow->RemoveComponent(m_vpGUIComponents[i]);
+			delete m_vpGUIComponents[i];
+		}
+		m_vpGUIComponents.clear();
+
+		delete m_pGUIWindow;
+	}
+
+	delete m_pGUI;
+	delete m_pRenderer;
+
+	Interpolator::GetInstance()->Destroy();
+	TimeManager::GetInstance()->Destroy();
+	ScriptManager::GetInstance()->Destroy();
+	AnimatedSectionBatch::GetInstance()->Destroy();
+	Profiler::GetInstance()->Destroy();
+}
+
+// Creation
+void VogueHeadless::Create()
+{
+	double setupStart = GetBenchmarkTime();
+
+	/* Create the renderer */
+	m_pRenderer = new Renderer(HEADLESS_WINDOW_WIDTH, HEADLESS_WINDOW_HEIGHT, 32, 8);
+
+	/* Create the GUI */
+	m_pGUI = new OpenGLGUI(m_pRenderer);
+	m_pRenderer->CreateFreeTypeFont("media/fonts/arial.ttf", 12, &m_GUIFont);
+
+	/* Create the game objects, in the same order as the game does */
+	m_pQubicleBinaryManager = new QubicleBinaryManager(m_pRenderer);
+	m_pInstanceManager = new InstanceManager(m_pRenderer);
+	m_pParticleManager = new ParticleManager(m_pRenderer);
+	m_pSceneTransforms = new TransformHierarchy();
+	m_pTileManager = new TileManager(m_pRenderer, m_pQubicleBinaryManager, m_pSceneTransforms);
+	m_pRoomManager = new RoomManager(m_pRenderer, m_pTileManager, m_pInstanceManager);
+	m_pPlayer = new Player(m_pRenderer, m_pQubicleBinaryManager, m_pSceneTransforms);
+
+	m_setupTime = (GetBenchmarkTime() - setupStart) * 0.001;
+}
+
+// Replay
+bool VogueHeadless::LoadReplay(const char* fileName)
+{
+	ifstream file(fileName);
+
+	if (file.is_open() == false)
+	{
+		cout << "ERROR: Could not load replay file: " << fileName << endl;
+		return false;
+	}
+
+	string line;
+	while (getline(file, line))
+	{
+		// Skip blank lines and comments
+		if (line.empty() || line[0] == '#')
+		{
+			continue;
+		}
+
+		stringstream lineStream(line);
+
+		ReplayEvent replayEvent;
+		if (!(lineStream >> replayEvent.m_tick >> replayEvent.m_command))
+		{
+			continue;
+		}
+
+		string argument;
+		while (lineStream >> argument)
+		{
+			replayEvent.m_vArguments.push_back(argument);
+		}
+
+		m_vReplayEvents.push_back(replayEvent);
+	}
+
+	// Keep the file order for events on the same tick
+	stable_sort(m_vReplayEvents.begin(), m_vReplayEvents.end(), replay_event_sort);
+	m_nextReplayEvent = 0;
+
+	return true;
+}
+
+void VogueHeadless::ExecuteReplayEvent(const ReplayEvent& replayEvent)
+{
+	const vector<string>& args = replayEvent.m_vArguments;
+
+	if (replayEvent.m_command == "seed" && args.size() >= 1)
+	{
+		SeedRandomNumberGeneratorInt(atoi(args[0].c_str()));
+	}
+	else if (replayEvent.m_command == "layout")
+	{
+		m_pRoomManager->GenerateNewLayout();
+	}
+	else if (replayEvent.m_command == "rooms" && args.size() >= 1)
+	{
+		int numRooms = atoi(args[0].c_str());
+		for (int i = 0; i < numRooms; i++)
+		{
+			m_pRoomManager->CreateConnectedRoom();
+		}
+	}
+	else if (replayEvent.m_command == "itemroom")
+	{
+		m_pRoomManager->CreateItemRoom();
+	}
+	else if (replayEvent.m_command == "bossroom")
+	{
+		m_pRoomManager->CreateBossRoom();
+	}
+	else if (replayEvent.m_command == "instances" && args.size() >= 2)
+	{
+		int numInstances = atoi(args[0].c_str());
+		for (int i = 0; i < numInstances; i++)
+		{
+			vec3 pos = vec3(GetRandomNumber(-50, 50, 2), 0.0f, GetRandomNumber(-50, 50, 2));
+			vec3 rot = vec3(0.0f, GetRandomNumber(0, 360, 2), 0.0f);
+			m_pInstanceManager->AddInstanceObject(args[1], pos, rot, 0.08f);
+		}
+	}
+	else if (replayEvent.m_command == "gui" && args.size() >= 1)
+	{
+		CreateGUIButtons(atoi(args[0].c_str()));
+	}
+	else if (replayEvent.m_command == "mouse" && args.size() >= 2)
+	{
+		m_pGUI->ImportMouseMotion(atoi(args[0].c_str()), atoi(args[1].c_str()));
+	}
+	else if (replayEvent.m_command == "press")
+	{
+		m_pGUI->MousePressed(MOUSE_BUTTON1);
+	}
+	else if (replayEvent.m_command == "release")
+	{
+		m_pGUI->MouseReleased(MOUSE_BUTTON1);
+	}
+	else if (replayEvent.m_command == "randomize" && args.size() >= 1)
+	{
+		m_pPlayer->RandomizeParts(atoi(args[0].c_str()));
+		m_pPlayer->UpdateDefaults();
+		m_pPlayer->SetColourModifiers();
+	}
+	else
+	{
+		cout << "Warning: Unknown replay command '" << replayEvent.m_command << "' at tick " << replayEvent.m_tick << ".\n";
+	}
+}
+
+void VogueHeadless::CreateGUIButtons(int numButtons)
+{
+	if (m_pGUIWindow == NULL)
+	{
+		m_pGUIWindow = new GUIWindow(m_pRenderer, m_GUIFont, "Headless");
+		m_pGUIWindow->AllowMoving(true);
+		m_pGUIWindow->AllowClosing(false);
+		m_pGUIWindow->AllowMinimizing(true);
+		m_pGUIWindow->AllowScrolling(false);
+		m_pGUIWindow->SetRenderTitleBar(true);
+		m_pGUIWindow->SetRenderWindowBackground(true);
+	}
+	else
+	{
+		// The event listeners are only hooked up when a window is added, so re-add it after the new buttons
+		m_pGUI->RemoveWindow(m_pGUIWindow);
+	}
+
+	for (int i = 0; i < numButtons; i++)
+	{
+		int index = (int)m_vpGUIComponents.size();
+		int x = (index % HEADLESS_BUTTONS_PER_ROW) * HEADLESS_BUTTON_SIZE;
+		int y = (index / HEADLESS_BUTTONS_PER_ROW) * HEADLESS_BUTTON_SIZE;
+
+		Button* pButton = new Button(m_pRenderer, m_GUIFont, "");
+		pButton->SetDimensions(x, y, HEADLESS_BUTTON_SIZE - 1, HEADLESS_BUTTON_SIZE - 1);
+		m_pGUIWindow->AddComponent(pButton);
+
+		m_vpGUIComponents.push_back(pButton);
+	}
+
+	int numRows = ((int)m_vpGUIComponents.size() + HEADLESS_BUTTONS_PER_ROW - 1) / HEADLESS_BUTTONS_PER_ROW;
+	m_pGUIWindow->SetDimensions(15, 15, HEADLESS_BUTTONS_PER_ROW * HEADLESS_BUTTON_SIZE, numRows * HEADLESS_BUTTON_SIZE);
+	m_pGUIWindow->SetApplicationDimensions(HEADLESS_WINDOW_WIDTH, HEADLESS_WINDOW_HEIGHT);
+
+	m_pGUI->AddWindow(m_pGUIWindow);
+}
+
+// Running
+void VogueHeadless::Run(int numTicks)
+{
+	double runStart = GetBenchmarkTime();
+
+	for (int tick = 0; tick < numTicks; tick++)
+	{
+		PROFILE_FRAME();
+		PROFILE_ZONE("VogueHeadless::Tick");
+
+		// Stand in for the frame boundary, publish queued resources and free retired ones
+		m_pRenderer->UpdateResourceRegistries();
+
+		for (int i = 0; i < HeadlessSubsystem_NUM; i++)
+		{
+			m_tickTimes[i] = 0.0;
+		}
+
+		// Feed in the recorded input for this tick
+		double replayStart = GetBenchmarkTime();
+		while (m_nextReplayEvent < (int)m_vReplayEvents.size() && m_vReplayEvents[m_nextReplayEvent].m_tick <= tick)
+		{
+			ExecuteReplayEvent(m_vReplayEvents[m_nextReplayEvent]);
+			m_nextReplayEvent++;
+		}
+		AddTiming(HeadlessSubsystem_Replay, GetBenchmarkTime() - replayStart);
+
+		UpdateSimulation(m_fixedTimeStep);
+		UpdateGUI(m_fixedTimeStep);
+
+		for (int i = 0; i < HeadlessSubsystem_NUM; i++)
+		{
+			if (m_tickTimes[i] > m_timings[i].m_maxTickTime)
+			{
+				m_timings[i].m_maxTickTime = m_tickTimes[i];
+			}
+		}
+
+		m_numTicks++;
+	}
+
+	m_runTime += (GetBenchmarkTime() - runStart) * 0.001;
+}
+
+void VogueHeadless::UpdateSimulation(float dt)
+{
+	ScriptManager::GetInstance()->NewFrame();
+
+	double start = GetBenchmarkTime();
+	Interpolator::GetInstance()->Update(dt);
+	double end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_Interpolator, end - start);
+
+	start = end;
+	TimeManager::GetInstance()->Update(dt);
+	end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_TimeManager, end - start);
+
+	start = end;
+	m_pInstanceManager->Update(dt);
+	end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_Instances, end - start);
+
+	start = end;
+	m_pRoomManager->Update(dt);
+	end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_Rooms, end - start);
+
+	start = end;
+	m_pTileManager->Update(dt);
+	end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_Tiles, end - start);
+
+	start = end;
+	m_pPlayer->Update(dt);
+	AnimatedSectionBatch::GetInstance()->Update();
+	m_pPlayer->UpdateWeaponParticleEffects(m_pParticleManager);
+	m_pParticleManager->Update(dt);
+	end = GetBenchmarkTime();
+	AddTiming(HeadlessSubsystem_Player, end - start);
+}
+
+void VogueHeadless::UpdateGUI(float dt)
+{
+	double start = GetBenchmarkTime();
+	m_pGUI->Update(dt);
+	AddTiming(HeadlessSubsystem_GUI, GetBenchmarkTime() - start);
+}
+
+// Reporting
+void VogueHeadless::WriteSoakReport(ostream& output)
+{
+	int numTicks = m_numTicks > 0 ? m_numTicks : 1;
+
+	output << "Soak test: completed " << m_numTicks << " simulation ticks at " << m_fixedTimeStep << "s per tick in " << m_runTime * 0.001 << "s (" << m_runTime / numTicks << "ms per tick).\n";
+}
+
+void VogueHeadless::WriteReport(ostream& output)
+{
+	int numTicks = m_numTicks > 0 ? m_numTicks : 1;
+
+	output << fixed << setprecision(4);
+	output << "{\n";
+	output << "  \"ticks\": " << m_numTicks << ",\n";
+	output << "  \"timeStep\": " << m_fixedTimeStep << ",\n";
+	output << "  \"setupTime\": " << m_setupTime << ",\n";
+	output << "  \"runTime\": " << m_runTime << ",\n";
+	output << "  \"averageTickTime\": " << m_runTime / numTicks << ",\n";
+	output << "  \"world\": {\n";
+	output << "    \"rooms\": " << m_pRoomManager->GetNumRooms() << ",\n";
+	output << "    \"decoratedRooms\": " << m_pRoomManager->GetNumDecoratedRooms() << ",\n";
+	output << "    \"instances\": " << m_pInstanceManager->GetTotalNumInstanceObjects() << ",\n";
+	output << "    \"guiComponents\": " << m_vpGUIComponents.size() << ",\n";
+	output << "    \"guiSelectable\": " << SelectionManager::GetInstance()->GetNumComponents() << "\n";
+	output << "  },\n";
+	output << "  \"scripts\": {\n";
+	output << "    \"cachedLoads\": " << ScriptManager::GetInstance()->GetNumCachedLoads() << ",\n";
+	output << "    \"compiledLoads\": " << ScriptManager::GetInstance()->GetNumCompiledLoads() << ",\n";
+	output << "    \"calls\": " << ScriptManager::GetInstance()->GetTotalNumCalls() << ",\n";
+	output << "    \"total\": " << ScriptManager::GetInstance()->GetTotalTime() << ",\n";
+	output << "    \"average\": " << ScriptManager::GetInstance()->GetTotalTime() / numTicks << "\n";
+	output << "  },\n";
+	int numTiles = 0;
+	int trianglesPerLOD[QUBICLE_NUM_LODS];
+	int selectedTriangles = 0;
+	CountDungeonTriangles(&numTiles, trianglesPerLOD, &selectedTriangles);
+	output << "  \"lod\": {\n";
+	output << "    \"tiles\": " << numTiles << ",\n";
+	output << "    \"triangles\": [";
+	for (int i = 0; i < QUBICLE_NUM_LODS; i++)
+	{
+		output << trianglesPerLOD[i] << ((i < QUBICLE_NUM_LODS - 1) ? ", " : "");
+	}
+	output << "],\n";
+	output << "    \"selected\": " << selectedTriangles << ",\n";
+	output << "    \"reduction\": " << ((trianglesPerLOD[0] > 0) ? 1.0 - (double)selectedTriangles / trianglesPerLOD[0] : 0.0) << "\n";
+	output << "  },\n";
+	VisibilityReport visibilityReport;
+	TestRoomVisibility(&visibilityReport);
+	output << "  \"visibility\": {\n";
+	output << "    \"queries\": " << visibilityReport.m_numQueries << ",\n";
+	output << "    \"portalRooms\": " << visibilityReport.m_averagePortalRooms << ",\n";
+	output << "    \"frustumRooms\": " << visibilityReport.m_averageFrustumRooms << ",\n";
+	output << "    \"reduction\": " << ((visibilityReport.m_averageFrustumRooms > 0.0) ? 1.0 - visibilityReport.m_averagePortalRooms / visibilityReport.m_averageFrustumRooms : 0.0) << ",\n";
+	output << "    \"averageTime\": " << visibilityReport.m_averageTime << ",\n";
+	output << "    \"errors\": " << visibilityReport.m_numErrors << "\n";
+	output << "  },\n";
+	DrawListReport drawListReport;
+	TestDrawList(&drawListReport);
+	output << "  \"drawList\": {\n";
+	output << "    \"draws\": " << drawListReport.m_numDraws << ",\n";
+	output << "    \"unsortedStateChanges\": " << drawListReport.m_numUnsortedStateChanges << ",\n";
+	output << "    \"sortedStateChanges\": " << drawListReport.m_numSortedStateChanges << ",\n";
+	output << "    \"sortTime\": " << drawListReport.m_sortTime << "\n";
+	output << "  },\n";
+	// The game's post processing chain, with the default options (SSAO and FXAA, no blur) and with everything turned on
+	PostProcessChain postProcessChain;
+	postProcessChain.AddPass("SSAO", PostProcessPassType_Default, 0.5f);
+	postProcessChain.AddPass("Composite", PostProcessPassType_Composite, 1.0f);
+	postProcessChain.AddPass("FXAA", PostProcessPassType_Antialiasing, 1.0f);
+	unsigned int blurHorizontalPass = postProcessChain.AddPass("Blur H", PostProcessPassType_Blur, 1.0f);
+	unsigned int blurVerticalPass = postProcessChain.AddPass("Blur V", PostProcessPassType_Blur, 1.0f);
+	output << "  \"postProcessing\": {\n";
+	output << "    \"passes\": " << postProcessChain.GetNumPasses() << ",\n";
+	postProcessChain.SetPassEnabled(blurHorizontalPass, false);
+	postProcessChain.SetPassEnabled(blurVerticalPass, false);
+	postProcessChain.Build();
+	output << "    \"default\": { \"runPasses\": " << postProcessChain.GetNumRunPasses() << ", \"unfusedScreenWrites\": " << postProcessChain.GetUnfusedScreenWrites() << ", \"screenWrites\": " << postProcessChain.GetScreenWrites() << " },\n";
+	postProcessChain.SetPassEnabled(blurHorizontalPass, true);
+	postProcessChain.SetPassEnabled(blurVerticalPass, true);
+	postProcessChain.Build();
+	output << "    \"allEnabled\": { \"runPasses\": " << postProcessChain.GetNumRunPasses() << ", \"unfusedScreenWrites\": " << postProcessChain.GetUnfusedScreenWrites() << ", \"screenWrites\": " << postProcessChain.GetScreenWrites() << " }\n";
+	output << "  },\n";
+	output << "  \"subsystems\": {\n";
+	for (int i = 0; i < HeadlessSubsystem_NUM; i++)
+	{
+		output << "    \"" << GetSubsystemName((HeadlessSubsystem)i) << "\": { ";
+		output << "\"total\": " << m_timings[i].m_totalTime << ", ";
+		output << "\"average\": " << m_timings[i].m_totalTime / numTicks << ", ";
+		output << "\"max\": " << m_timings[i].m_maxTickTime << " }";
+		output << ((i < HeadlessSubsystem_NUM - 1) ? ",\n" : "\n");
+	}
+	output << "  }\n";
+	output << "}\n";
+}
+
+void VogueHeadless::CountDungeonTriangles(int* pNumTiles, int* pTrianglesPerLOD, int* pSelectedTriangles)
+{
+	*pNumTiles = 0;
+	*pSelectedTriangles = 0;
+	for (int i = 0; i < QUBICLE_NUM_LODS; i++)
+	{
+		pTrianglesPerLOD[i] = 0;
+	}
+
+	// Every floor tile of the decorated rooms, at each LOD and at the LOD the game camera would pick
+	for (int i = 0; i < m_pRoomManager->GetNumRooms(); i++)
+	{
+		Room* pRoom = m_pRoomManager->GetRoom(i);
+		if (pRoom->IsDecorated() == false)
+		{
+			continue;
+		}
+
+		const RoomDecoration& decoration = pRoom->GetDecoration();
+		for (int x = 0; x < decoration.m_numTilesX; x++)
+		{
+			for (int z = 0; z < decoration.m_numTilesZ; z++)
+			{
+				QubicleBinary* pTileFile = m_pQubicleBinaryManager->GetQubicleBinaryFile(pRoom->GetTileFilename(x, z).c_str(), false);
+
+				for (int lod = 0; lod < QUBICLE_NUM_LODS; lod++)
+				{
+					pTrianglesPerLOD[lod] += pTileFile->GetNumTriangles(lod);
+				}
+
+				float distance = length(pRoom->GetTilePosition(x, z) - HEADLESS_CAMERA_POSITION);
+				float voxelScreenSize = Renderer::GetProjectedSize(ROOM_TILE_SCALE, distance, HEADLESS_CAMERA_FOV, HEADLESS_WINDOW_HEIGHT);
+				*pSelectedTriangles += pTileFile->GetNumTriangles(QubicleBinary::SelectLOD(0, voxelScreenSize));
+
+				(*pNumTiles)++;
+			}
+		}
+	}
+}
+
+void VogueHeadless::TestRoomVisibility(VisibilityReport* pReport)
+{
+	pReport->m_numQueries = 0;
+	pReport->m_averagePortalRooms = 0.0;
+	pReport->m_averageFrustumRooms = 0.0;
+	pReport->m_averageTime = 0.0;
+	pReport->m_numErrors = 0;
+
+	RoomList vpRoomList;
+	for (int i = 0; i < m_pRoomManager->GetNumRooms(); i++)
+	{
+		vpRoomList.push_back(m_pRoomManager->GetRoom(i));
+	}
+
+	Frustum frustum;
+	frustum.SetFrustum(HEADLESS_CAMERA_FOV, (float)HEADLESS_WINDOW_WIDTH / HEADLESS_WINDOW_HEIGHT, HEADLESS_CAMERA_NEAR, HEADLESS_CAMERA_FAR);
+
+	RoomVisibility portalVisibility;
+	RoomVisibility frustumVisibility;
+	const vec3 facings[4] = { vec3(0.0f, 0.0f, -1.0f), vec3(0.0f, 0.0f, 1.0f), vec3(1.0f, 0.0f, 0.0f), vec3(-1.0f, 0.0f, 0.0f) };
+
+	// From the middle of each room, looking towards each of the walls
+	for (unsigned int i = 0; i < vpRoomList.size(); i++)
+	{
+		Room* pRoom = vpRoomList[i];
+
+		for (int j = 0; j < 4; j++)
+		{
+			vec3 cameraPosition = pRoom->GetPosition();
+			frustum.SetCamera(cameraPosition, cameraPosition + facings[j], vec3(0.0f, 1.0f, 0.0f));
+
+			double start = GetBenchmarkTime();
+			portalVisibility.FindVisibleRooms(vpRoomList, &frustum);
+			pReport->m_averageTime += GetBenchmarkTime() - start;
+
+			frustumVisibility.FindRoomsInFrustum(vpRoomList, &frustum);
+
+			const RoomList& vpPortalRooms = portalVisibility.GetVisibleRooms();
+			const RoomList& vpFrustumRooms = frustumVisibility.GetVisibleRooms();
+
+			if (find(vpPortalRooms.begin(), vpPortalRooms.end(), pRoom) == vpPortalRooms.end())
+			{
+				pReport->m_numErrors++;
+			}
+			for (unsigned int k = 0; k < vpPortalRooms.size(); k++)
+			{
+				if (find(vpFrustumRooms.begin(), vpFrustumRooms.end(), vpPortalRooms[k]) == vpFrustumRooms.end())
+				{
+					pReport->m_numErrors++;
+				}
+			}
+
+			pReport->m_averagePortalRooms += vpPortalRooms.size();
+			pReport->m_averageFrustumRooms += vpFrustumRooms.size();
+			pReport->m_numQueries++;
+		}
+	}
+
+	if (pReport->m_numQueries > 0)
+	{
+		pReport->m_averagePortalRooms /= pReport->m_numQueries;
+		pReport->m_averageFrustumRooms /= pReport->m_numQueries;
+		pReport->m_averageTime /= pReport->m_numQueries;
+	}
+}
+
+void VogueHeadless::TestDrawList(DrawListReport* pReport)
+{
+	pReport->m_numDraws = 0;
+	pReport->m_numUnsortedStateChanges = 0;
+	pReport->m_numSortedStateChanges = 0;
+	pReport->m_sortTime = 0.0;
+
+	// Every matrix of every floor tile of the decorated rooms, in the order the tile manager walks them
+	vector<DrawCommand> vCommands;
+	for (int i = 0; i < m_pRoomManager->GetNumRooms(); i++)
+	{
+		Room* pRoom = m_pRoomManager->GetRoom(i);
+		if (pRoom->IsDecorated() == false)
+		{
+			continue;
+		}
+
+		const RoomDecoration& decoration = pRoom->GetDecoration();
+		for (int x = 0; x < decoration.m_numTilesX; x++)
+		{
+			for (int z = 0; z < decoration.m_numTilesZ; z++)
+			{
+				QubicleBinary* pTileFile = m_pQubicleBinaryManager->GetQubicleBinaryFile(pRoom->GetTileFilename(x, z).c_str(), false);
+				float depth = length(pRoom->GetTilePosition(x, z) - HEADLESS_CAMERA_POSITION) / HEADLESS_CAMERA_FAR;
+
+				for (int j = 0; j < pTileFile->GetNumMatrices(); j++)
+				{
+					QubicleMatrix* pMatrix = pTileFile->GetQubicleMatrix(j);
+					if (pMatrix->m_pMesh == NULL)
+					{
+						continue;
+					}
+
+					DrawCommand command;
+					command.m_staticBufferId = pMatrix->m_pMesh->m_staticMeshId;
+					command.m_shaderId = 0;
+					command.m_textureId = (unsigned int)RENDER_STATE_UNKNOWN;
+					command.m_materialId = pTileFile->GetMaterial();
+					command.m_cullMode = CM_BACK;
+					command.m_pass = DrawPass_Opaque;
+					command.m_sortKey = DrawList::CreateSortKey(command.m_pass, command.m_shaderId, command.m_textureId, command.m_materialId, depth);
+					vCommands.push_back(command);
+				}
+			}
+		}
+	}
+
+	pReport->m_numDraws = (int)vCommands.size();
+
+	RenderStateCache unsortedState;
+	for (unsigned int i = 0; i < vCommands.size(); i++)
+	{
+		ApplyDrawState(&unsortedState, vCommands[i]);
+	}
+	pReport->m_numUnsortedStateChanges = unsortedState.GetNumStateChanges();
+
+	DrawList drawList;
+	for (unsigned int i = 0; i < vCommands.size(); i++)
+	{
+		drawList.AddCommand(vCommands[i]);
+	}
+
+	double start = GetBenchmarkTime();
+	drawList.Sort();
+	pReport->m_sortTime = GetBenchmarkTime() - start;
+
+	RenderStateCache sortedState;
+	for (int i = 0; i < drawList.GetNumCommands(); i++)
+	{
+		ApplyDrawState(&sortedState, drawList.GetSortedCommand(i));
+	}
+	pReport->m_numSortedStateChanges = sortedState.GetNumStateChanges();
+}
+
+void VogueHeadless::ApplyDrawState(RenderStateCache* pStateCache, const DrawCommand& command)
+{
+	// The same state the renderer sets when it submits a draw list
+	pStateCache->SetShaderProgram(command.m_shaderId);
+	pStateCache->SetCullMode(command.m_cullMode);
+	pStateCache->SetBlend(command.m_pass == DrawPass_Transparent);
+	pStateCache->SetMaterial(command.m_materialId);
+	if (command.m_textureId != (unsigned int)RENDER_STATE_UNKNOWN)
+	{
+		pStateCache->SetActiveTextureUnit(0);
+		pStateCache->SetTexture(command.m_textureId);
+	}
+}
+
+// Timing, measured in microseconds and reported in milliseconds
+void VogueHeadless::AddTiming(HeadlessSubsystem subsystem, double microseconds)
+{
+	double time = microseconds * 0.001;
+	m_tickTimes[subsystem] += time;
+	m_timings[subsystem].m_totalTime += time;
+}
+
+const char* VogueHeadless::GetSubsystemName(HeadlessSubsystem subsystem)
+{
+	switch (subsystem)
+	{
+		case HeadlessSubsystem_Replay: { return "replay"; }
+		case HeadlessSubsystem_Interpolator: { return "interpolator"; }
+		case HeadlessSubsystem_TimeManager: { return "timeManager"; }
+		case HeadlessSubsystem_Instances: { return "instances"; }
+		case HeadlessSubsystem_Rooms: { return "rooms"; }
+		case HeadlessSubsystem_Tiles: { return "tiles"; }
+		case HeadlessSubsystem_Player: { return "player"; }
+		case HeadlessSubsystem_GUI: { return "gui"; }
+		case HeadlessSubsystem_NUM: { break; }
+	}
+
+	return "unknown";
+}
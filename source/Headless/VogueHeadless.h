@@ -0,0 +1,173 @@
+// ******************************************************************************
+// Filename:    VogueHeadless.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless benchmark harness. Builds the CPU side of the game world (room
+//   layout, player character, instances and the GUI tree) without a window or
+//   OpenGL context, replays a recorded input script over a fixed number of
+//   simulation ticks and reports the per-subsystem timings as JSON, along
+//   with the triangle counts of the dungeon floor at each model LOD and how
+//   many rooms the portal visibility pass lets through from inside each room
+//   and how many state changes sorting the floor draws saves.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Renderer/Renderer.h"
+#include "../gui/openglgui.h"
+#include "../VogueSettings.h"
+
+#include "../room/RoomManager.h"
+#include "../room/TileManager.h"
+#include "../Player/Player.h"
+#include "../Instance/InstanceManager.h"
+#include "../Particles/ParticleManager.h"
+
+#include <string>
+#include <vector>
+#include <ostream>
+using namespace std;
+
+// Subsystems that are timed by the harness
+enum HeadlessSubsystem
+{
+	HeadlessSubsystem_Replay = 0,
+	HeadlessSubsystem_Interpolator,
+	HeadlessSubsystem_TimeManager,
+	HeadlessSubsystem_Instances,
+	HeadlessSubsystem_Rooms,
+	HeadlessSubsystem_Tiles,
+	HeadlessSubsystem_Player,
+	HeadlessSubsystem_GUI,
+
+	HeadlessSubsystem_NUM,
+};
+
+// A single recorded input event, executed at the start of its tick
+class ReplayEvent
+{
+public:
+	int m_tick;
+	string m_command;
+	vector<string> m_vArguments;
+};
+
+// Accumulated timings for a subsystem, in milliseconds
+class SubsystemTiming
+{
+public:
+	double m_totalTime;
+	double m_maxTickTime;
+};
+
+// Looking around from the middle of every room, portal visibility against the frustum alone
+class VisibilityReport
+{
+public:
+	int m_numQueries;
+	double m_averagePortalRooms;
+	double m_averageFrustumRooms;
+	double m_averageTime;	// Microseconds per portal pass
+	int m_numErrors;		// Camera room missing, or a room let through that is outside the frustum
+};
+
+// The dungeon floor draws in scene walk order against the same draws sorted by key
+class DrawListReport
+{
+public:
+	int m_numDraws;
+	int m_numUnsortedStateChanges;
+	int m_numSortedStateChanges;
+	double m_sortTime;	// Microseconds
+};
+
+class VogueHeadless
+{
+public:
+	/* Public methods */
+	VogueHeadless(VogueSettings* pVogueSettings);
+	~VogueHeadless();
+
+	// Creation
+	void Create();
+
+	// Replay
+	bool LoadReplay(const char* fileName);
+
+	// Running
+	void Run(int numTicks);
+
+	// Reporting
+	void WriteReport(ostream& output);
+	void WriteSoakReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void ExecuteReplayEvent(const ReplayEvent& replayEvent);
+	void CreateGUIButtons(int numButtons);
+	void UpdateSimulation(float dt);
+	void UpdateGUI(float dt);
+
+	// Reporting
+	void CountDungeonTriangles(int* pNumTiles, int* pTrianglesPerLOD, int* pSelectedTriangles);
+	void TestRoomVisibility(VisibilityReport* pReport);
+	void TestDrawList(DrawListReport* pReport);
+	static void ApplyDrawState(RenderStateCache* pStateCache, const DrawCommand& command);
+
+	// Timing
+	void AddTiming(HeadlessSubsystem subsystem, double microseconds);
+
+	static const char* GetSubsystemName(HeadlessSubsystem subsystem);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	VogueSettings* m_pVogueSettings;
+
+	// Renderer, without any GL context behind it
+	Renderer* m_pRenderer;
+
+	// GUI
+	OpenGLGUI* m_pGUI;
+	GUIWindow* m_pGUIWindow;
+	vector<Component*> m_vpGUIComponents;
+	unsigned int m_GUIFont;
+
+	// Game objects
+	QubicleBinaryManager* m_pQubicleBinaryManager;
+	InstanceManager* m_pInstanceManager;
+	ParticleManager* m_pParticleManager;
+	TransformHierarchy* m_pSceneTransforms;
+	TileManager* m_pTileManager;
+	RoomManager* m_pRoomManager;
+	Player* m_pPlayer;
+
+	// Replay events, in tick order
+	vector<ReplayEvent> m_vReplayEvents;
+	int m_nextReplayEvent;
+
+	// Simulation
+	float m_fixedTimeStep;
+	int m_numTicks;
+
+	// Timings
+	double m_setupTime;
+	double m_runTime;
+	double m_tickTimes[HeadlessSubsystem_NUM];
+	SubsystemTiming m_timings[HeadlessSubsystem_NUM];
+};
@@ -0,0 +1,249 @@
+// ******************************************************************************
+// Filename:    WeaponAnimationBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "WeaponAnimationBenchmark.h"
+
+#include "../models/AnimatedSectionBatch.h"
+
+#include <vector>
+#include <iomanip>
+
+const float WEAPON_ANIMATION_BENCHMARK_FRAME_TIME = 1.0f / 60.0f;
+
+// How often the one shot animations are started again, in frames
+const int WEAPON_ANIMATION_BENCHMARK_RESTART_FRAMES = 60;
+
+
+// The old approach, every section walks its own up and down flags for each track
+class LegacyAnimatedSection
+{
+public:
+	bool m_playingAnimation;
+	bool m_loopingAnimation;
+
+	float m_value[AnimatedSectionTrack_NUM];
+	float m_speed[AnimatedSectionTrack_NUM];
+	float m_maxSpeed[AnimatedSectionTrack_NUM];
+	float m_turnSpeed[AnimatedSectionTrack_NUM];
+	float m_rangeMin[AnimatedSectionTrack_NUM];
+	float m_rangeMax[AnimatedSectionTrack_NUM];
+	bool m_up[AnimatedSectionTrack_NUM];
+	bool m_down[AnimatedSectionTrack_NUM];
+};
+
+static void LegacyUpdateSection(LegacyAnimatedSection* pSection, float dt)
+{
+	if (pSection->m_playingAnimation == false)
+	{
+		return;
+	}
+
+	bool noChangeInAnimation = true;
+	for (int i = 0; i < AnimatedSectionTrack_NUM; i++)
+	{
+		noChangeInAnimation = noChangeInAnimation && (pSection->m_speed[i] == 0.0f);
+	}
+
+	for (int i = 0; i < AnimatedSectionTrack_NUM; i++)
+	{
+		if (pSection->m_up[i] == true && pSection->m_speed[i] < pSection->m_maxSpeed[i])
+		{
+			if (pSection->m_turnSpeed[i] != -1)
+			{
+				pSection->m_speed[i] += pSection->m_turnSpeed[i] * dt;
+			}
+			else
+			{
+				pSection->m_value[i] = pSection->m_rangeMin[i];
+				pSection->m_speed[i] = -pSection->m_speed[i];
+			}
+		}
+		else if (pSection->m_down[i] == true && pSection->m_speed[i] > -pSection->m_maxSpeed[i])
+		{
+			if (pSection->m_turnSpeed[i] != -1)
+			{
+				pSection->m_speed[i] -= pSection->m_turnSpeed[i] * dt;
+			}
+			else
+			{
+				pSection->m_value[i] = pSection->m_rangeMax[i];
+				pSection->m_speed[i] = -pSection->m_speed[i];
+			}
+		}
+
+		if (pSection->m_value[i] > pSection->m_rangeMax[i])
+		{
+			pSection->m_up[i] = false;
+			pSection->m_down[i] = true;
+
+			if (pSection->m_loopingAnimation == false)
+			{
+				pSection->m_playingAnimation = false;
+			}
+		}
+		else if (pSection->m_value[i] < pSection->m_rangeMin[i])
+		{
+			pSection->m_up[i] = true;
+			pSection->m_down[i] = false;
+
+			if (pSection->m_loopingAnimation == false)
+			{
+				pSection->m_playingAnimation = false;
+			}
+		}
+
+		pSection->m_value[i] += pSection->m_speed[i] * dt;
+	}
+
+	if (noChangeInAnimation)
+	{
+		pSection->m_playingAnimation = false;
+	}
+}
+
+
+WeaponAnimationBenchmark::WeaponAnimationBenchmark()
+{
+	m_numSections = 0;
+	m_numFrames = 0;
+	m_randomSeed = 1;
+
+	m_numPlaying = 0;
+	m_numMismatches = 0;
+}
+
+WeaponAnimationBenchmark::~WeaponAnimationBenchmark()
+{
+	AnimatedSectionBatch::GetInstance()->Destroy();
+}
+
+// Running
+void WeaponAnimationBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numSections = settings.m_count > 0 ? settings.m_count : 1;
+	m_numFrames = settings.m_numTicks > 0 ? settings.m_numTicks : 1;
+
+	AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+
+	// The same random sections for both, a mix of looping and one shot, ramped and snapping tracks
+	m_randomSeed = 1;
+	vector<LegacyAnimatedSection> vLegacySections(m_numSections);
+	vector<int> vSectionIds(m_numSections);
+	for (int i = 0; i < m_numSections; i++)
+	{
+		LegacyAnimatedSection* pSection = &vLegacySections[i];
+		pSection->m_loopingAnimation = GetBenchmarkRandomValue(&m_randomSeed, 0.0f, 1.0f) < 0.75f;
+		pSection->m_playingAnimation = true;
+
+		vSectionIds[i] = pBatch->AddSection(pSection->m_playingAnimation, pSection->m_loopingAnimation);
+
+		for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+		{
+			bool rotation = track >= AnimatedSectionTrack_RotationX;
+			float scale = rotation ? 45.0f : 0.5f;
+
+			float speed = GetBenchmarkRandomValue(&m_randomSeed, 0.0f, 1.0f) < 0.3f ? 0.0f : GetBenchmarkRandomValue(&m_randomSeed, 0.5f, 4.0f) * scale;
+			float rangeMin = -GetBenchmarkRandomValue(&m_randomSeed, 0.1f, 1.0f) * scale;
+			float rangeMax = GetBenchmarkRandomValue(&m_randomSeed, 0.1f, 1.0f) * scale;
+			float turnSpeed = GetBenchmarkRandomValue(&m_randomSeed, 0.0f, 1.0f) < 0.25f ? -1.0f : GetBenchmarkRandomValue(&m_randomSeed, 1.0f, 20.0f) * scale;
+
+			pSection->m_value[track] = 0.0f;
+			pSection->m_speed[track] = speed;
+			pSection->m_maxSpeed[track] = speed;
+			pSection->m_turnSpeed[track] = turnSpeed;
+			pSection->m_rangeMin[track] = rangeMin;
+			pSection->m_rangeMax[track] = rangeMax;
+			pSection->m_up[track] = true;
+			pSection->m_down[track] = false;
+
+			pBatch->SetTrack(vSectionIds[i], (AnimatedSectionTrack)track, speed, rangeMin, rangeMax, turnSpeed);
+		}
+	}
+
+	m_batch.Reset();
+	m_legacy.Reset();
+	m_numMismatches = 0;
+
+	for (int frame = 0; frame < m_numFrames; frame++)
+	{
+		if (frame > 0 && (frame % WEAPON_ANIMATION_BENCHMARK_RESTART_FRAMES) == 0)
+		{
+			for (int i = 0; i < m_numSections; i++)
+			{
+				vLegacySections[i].m_playingAnimation = true;
+				pBatch->SetPlaying(vSectionIds[i], true);
+			}
+		}
+
+		double start = GetBenchmarkTime();
+		for (int i = 0; i < m_numSections; i++)
+		{
+			pBatch->QueueUpdate(vSectionIds[i], WEAPON_ANIMATION_BENCHMARK_FRAME_TIME);
+		}
+		pBatch->Update();
+		double end = GetBenchmarkTime();
+		m_batch.AddSample(end - start);
+
+		start = end;
+		for (int i = 0; i < m_numSections; i++)
+		{
+			LegacyUpdateSection(&vLegacySections[i], WEAPON_ANIMATION_BENCHMARK_FRAME_TIME);
+		}
+		end = GetBenchmarkTime();
+		m_legacy.AddSample(end - start);
+
+		// Both must stay in step exactly, every frame
+		for (int i = 0; i < m_numSections; i++)
+		{
+			bool mismatch = pBatch->IsPlaying(vSectionIds[i]) != vLegacySections[i].m_playingAnimation;
+			for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+			{
+				mismatch = mismatch || (pBatch->GetValue(vSectionIds[i], (AnimatedSectionTrack)track) != vLegacySections[i].m_value[track]);
+				mismatch = mismatch || (pBatch->GetSpeed(vSectionIds[i], (AnimatedSectionTrack)track) != vLegacySections[i].m_speed[track]);
+			}
+
+			if (mismatch)
+			{
+				m_numMismatches++;
+			}
+		}
+	}
+
+	m_numPlaying = 0;
+	for (int i = 0; i < m_numSections; i++)
+	{
+		if (pBatch->IsPlaying(vSectionIds[i]))
+		{
+			m_numPlaying++;
+		}
+
+		pBatch->RemoveSection(vSectionIds[i]);
+	}
+}
+
+// Reporting
+void WeaponAnimationBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"sections\": " << m_numSections << ",\n";
+	output << "  \"frames\": " << m_numFrames << ",\n";
+	output << "  \"batch\": { ";
+	output << "\"average\": " << m_batch.Average() << ", ";
+	output << "\"max\": " << m_batch.Max() << " },\n";
+	output << "  \"legacy\": { ";
+	output << "\"average\": " << m_legacy.Average() << ", ";
+	output << "\"max\": " << m_legacy.Max() << " },\n";
+	output << "  \"speedup\": " << (m_batch.Average() > 0.0 ? m_legacy.Average() / m_batch.Average() : 0.0) << ",\n";
+	output << "  \"playingAtEnd\": " << m_numPlaying << ",\n";
+	output << "  \"mismatches\": " << m_numMismatches << "\n";
+	output << "}\n";
+}
@@ -0,0 +1,63 @@
+// ******************************************************************************
+// Filename:    WeaponAnimationBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless micro-benchmark for the weapon animated section update. Steps
+//   a large number of randomly set up sections through the batched tracks
+//   and through a copy of the old one section at a time update, restarting
+//   the one shot animations every second the way attacks do, then reports
+//   the per frame cost of both and any track where they disagree as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+using namespace std;
+
+class WeaponAnimationBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	WeaponAnimationBenchmark();
+	~WeaponAnimationBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numSections;
+	int m_numFrames;
+
+	unsigned int m_randomSeed;
+
+	// Results
+	HeadlessBenchmarkTimings m_batch;
+	HeadlessBenchmarkTimings m_legacy;
+	int m_numPlaying;
+	int m_numMismatches;
+};
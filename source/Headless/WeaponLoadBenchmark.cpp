@@ -0,0 +1,222 @@
+// ******************************************************************************
+// Filename:    WeaponLoadBenchmark.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "WeaponLoadBenchmark.h"
+
+#include "../models/VoxelWeapon.h"
+#include "../models/WeaponDefinition.h"
+#include "../models/AnimatedSectionBatch.h"
+#include "../utils/FileUtils.h"
+
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <string.h>
+
+const char* WEAPON_LOAD_BENCHMARK_DIRECTORY = "cache/weaponloadbench";
+const char* WEAPON_LOAD_BENCHMARK_WEAPON_FILE = "cache/weaponloadbench/benchmark.weapon";
+const char* WEAPON_LOAD_BENCHMARK_PACKED_FILE = "cache/weaponloadbench/benchmark.vwpn";
+const char* WEAPON_LOAD_BENCHMARK_SECTION_MODEL = "media/gamedata/hair/male_hair1.qb";
+const int WEAPON_LOAD_BENCHMARK_WINDOW_WIDTH = 1024;
+const int WEAPON_LOAD_BENCHMARK_WINDOW_HEIGHT = 768;
+
+
+WeaponLoadBenchmark::WeaponLoadBenchmark()
+{
+	m_numWeapons = 0;
+	m_numIterations = 0;
+
+	m_textLoadTime = 0.0;
+	m_packedLoadTime = 0.0;
+	m_equipTime = 0.0;
+	m_numMismatches = 0;
+	m_numDefinitions = 0;
+	m_numSharedLoads = 0;
+	m_numCachedLoads = 0;
+	m_numCompiledLoads = 0;
+	m_definitionBytes = 0;
+	m_perWeaponBytes = 0;
+}
+
+WeaponLoadBenchmark::~WeaponLoadBenchmark()
+{
+	AnimatedSectionBatch::GetInstance()->Destroy();
+}
+
+// Running
+void WeaponLoadBenchmark::Run(const HeadlessBenchmarkSettings& settings)
+{
+	m_numWeapons = settings.m_count > 0 ? settings.m_count : 1;
+	m_numIterations = settings.m_numIterations > 0 ? settings.m_numIterations : 1;
+
+	createDirectory(WEAPON_LOAD_BENCHMARK_DIRECTORY);
+
+	string source = GetWeaponSource();
+	ofstream weaponFile(WEAPON_LOAD_BENCHMARK_WEAPON_FILE, ios::out | ios::binary);
+	weaponFile << source;
+	weaponFile.close();
+
+	// The reference packed definition, compiled once
+	WeaponDefinition reference;
+	reference.Compile(source, 0);
+	reference.SavePacked(WEAPON_LOAD_BENCHMARK_PACKED_FILE);
+
+	// Text, read the file and parse every field the way the old loader did
+	m_textLoadTime = 0.0;
+	for (int i = 0; i < m_numIterations; i++)
+	{
+		double start = GetBenchmarkTime();
+		ifstream file(WEAPON_LOAD_BENCHMARK_WEAPON_FILE, ios::in | ios::binary);
+		stringstream contents;
+		contents << file.rdbuf();
+		WeaponDefinition definition;
+		definition.Compile(contents.str(), 0);
+		m_textLoadTime += GetBenchmarkTime() - start;
+	}
+	m_textLoadTime /= m_numIterations;
+
+	// Packed, a single read with the records used where they land
+	m_packedLoadTime = 0.0;
+	m_numMismatches = 0;
+	for (int i = 0; i < m_numIterations; i++)
+	{
+		double start = GetBenchmarkTime();
+		WeaponDefinition definition;
+		bool loaded = definition.LoadPacked(WEAPON_LOAD_BENCHMARK_PACKED_FILE, 0);
+		m_packedLoadTime += GetBenchmarkTime() - start;
+
+		if (loaded == false || definition.GetDataSize() != reference.GetDataSize() ||
+			memcmp(definition.GetHeader(), reference.GetHeader(), reference.GetDataSize()) != 0)
+		{
+			m_numMismatches++;
+		}
+	}
+	m_packedLoadTime /= m_numIterations;
+
+	// Equip every weapon from the shared registry
+	Renderer* pRenderer = new Renderer(WEAPON_LOAD_BENCHMARK_WINDOW_WIDTH, WEAPON_LOAD_BENCHMARK_WINDOW_HEIGHT, 32, 8);
+	QubicleBinaryManager* pQubicleBinaryManager = new QubicleBinaryManager(pRenderer);
+
+	vector<VoxelWeapon*> vpWeapons(m_numWeapons);
+	double start = GetBenchmarkTime();
+	for (int i = 0; i < m_numWeapons; i++)
+	{
+		vpWeapons[i] = new VoxelWeapon(pRenderer, pQubicleBinaryManager);
+		vpWeapons[i]->LoadWeapon(WEAPON_LOAD_BENCHMARK_WEAPON_FILE);
+	}
+	m_equipTime = (GetBenchmarkTime() - start) / m_numWeapons;
+
+	WeaponDefinitionRegistry* pRegistry = pQubicleBinaryManager->GetWeaponDefinitionRegistry();
+	m_numDefinitions = pRegistry->GetNumDefinitions();
+	m_numSharedLoads = pRegistry->GetNumSharedLoads();
+	m_numCachedLoads = pRegistry->GetNumCachedLoads();
+	m_numCompiledLoads = pRegistry->GetNumCompiledLoads();
+	m_definitionBytes = pRegistry->GetTotalDataSize();
+
+	// What each carrier still holds on its own, the animation state and the trail points
+	const WeaponDefinitionHeader* pHeader = reference.GetHeader();
+	m_perWeaponBytes = (int)(sizeof(VoxelWeapon) +
+		sizeof(AnimatedSection) * pHeader->m_numSections +
+		sizeof(VoxelWeaponLight) * pHeader->m_numLights +
+		sizeof(ParticleEffect) * pHeader->m_numParticleEffects +
+		(sizeof(WeaponTrail) + sizeof(WeaponTrailPoint) * 50) * pHeader->m_numTrails);
+
+	for (int i = 0; i < m_numWeapons; i++)
+	{
+		delete vpWeapons[i];
+	}
+	delete pQubicleBinaryManager;
+	delete pRenderer;
+}
+
+// Reporting
+void WeaponLoadBenchmark::WriteReport(ostream& output)
+{
+	output << fixed << setprecision(3);
+	output << "{\n";
+	output << "  \"weapons\": " << m_numWeapons << ",\n";
+	output << "  \"iterations\": " << m_numIterations << ",\n";
+	output << "  \"textLoad\": " << m_textLoadTime << ",\n";
+	output << "  \"packedLoad\": " << m_packedLoadTime << ",\n";
+	output << "  \"speedup\": " << (m_packedLoadTime > 0.0 ? m_textLoadTime / m_packedLoadTime : 0.0) << ",\n";
+	output << "  \"mismatches\": " << m_numMismatches << ",\n";
+	output << "  \"equip\": " << m_equipTime << ",\n";
+	output << "  \"registry\": { ";
+	output << "\"definitions\": " << m_numDefinitions << ", ";
+	output << "\"shared\": " << m_numSharedLoads << ", ";
+	output << "\"cached\": " << m_numCachedLoads << ", ";
+	output << "\"compiled\": " << m_numCompiledLoads << " },\n";
+	output << "  \"definitionBytes\": " << m_definitionBytes << ",\n";
+	output << "  \"perWeaponBytes\": " << m_perWeaponBytes << "\n";
+	output << "}\n";
+}
+
+// A two section weapon with a light, a particle effect and a trail, in the text format
+string WeaponLoadBenchmark::GetWeaponSource()
+{
+	stringstream source;
+	source << "offset: 0.5 0 -0.5\n";
+	source << "scale: 0.08\n\n";
+
+	source << "numAnimatedSections: 2\n";
+	for (int i = 0; i < 2; i++)
+	{
+		source << "qubicleFile: " << WEAPON_LOAD_BENCHMARK_SECTION_MODEL << "\n";
+		source << "renderScale: 0.08\n";
+		source << "renderOffset: 0 " << i * 0.5f << " 0 \n";
+		source << "autoStartAnimation: 1\n";
+		source << "loopingAnimation: " << (i == 0 ? 1 : 0) << "\n";
+		source << "translateXSpeed: 0\n";
+		source << "translateYSpeed: 0.5\n";
+		source << "translateZSpeed: 0\n";
+		source << "translateXRange: 0 0\n";
+		source << "translateYRange: -0.25 0.25\n";
+		source << "translateZRange: 0 0\n";
+		source << "translateXTurnSpeed: 0\n";
+		source << "translateYTurnSpeed: 0.25\n";
+		source << "translateZTurnSpeed: 0\n";
+		source << "rotationPoint: 0 0.5 0\n";
+		source << "rotationXSpeed: 0\n";
+		source << "rotationYSpeed: 90\n";
+		source << "rotationZSpeed: 0\n";
+		source << "rotationXRange: 0 0\n";
+		source << "rotationYRange: -45 45\n";
+		source << "rotationZRange: 0 0\n";
+		source << "rotationXTurnSpeed: 0\n";
+		source << "rotationYTurnSpeed: 10\n";
+		source << "rotationZTurnSpeed: 0\n";
+	}
+	source << "\n";
+
+	source << "numLights: 1\n";
+	source << "lightOffset: 0 1.5 0 \n";
+	source << "lightRadius: 1.5\n";
+	source << "lightDiffuseMultiplier: 2\n";
+	source << "lightColour: 1 0.5 0.25 1\n";
+	source << "connectedToSection: 1\n\n";
+
+	source << "numParticleEffects: 1\n";
+	source << "particleEffect: media/gamedata/particles/weapon_glow.effect\n";
+	source << "position: 0 1.5 0\n";
+	source << "connectedToSection: 1\n\n";
+
+	source << "numWeaponTrails: 1\n";
+	source << "trailTime: 0.25\n";
+	source << "startOffsetPoint: 0 0.2 0\n";
+	source << "endOffsetPoint: 0 1.8 0\n";
+	source << "trailColour: 1 1 1\n";
+	source << "followOrigin: 1\n\n";
+
+	source << "weaponRadius: 0.75\n";
+
+	return source.str();
+}
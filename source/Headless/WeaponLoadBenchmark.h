@@ -0,0 +1,70 @@
+// ******************************************************************************
+// Filename:    WeaponLoadBenchmark.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Headless benchmark for loading weapons. Writes out a text weapon
+//   definition and times parsing it the old way against reading back its
+//   packed binary form, then equips a large number of weapons from it
+//   through the shared definition registry. Reports the load times, how
+//   many definitions were actually built and the memory held by the shared
+//   definitions against the per weapon state as JSON.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "HeadlessBenchmark.h"
+
+#include <ostream>
+#include <string>
+using namespace std;
+
+class WeaponLoadBenchmark : public HeadlessBenchmark
+{
+public:
+	/* Public methods */
+	WeaponLoadBenchmark();
+	~WeaponLoadBenchmark();
+
+	// Running
+	void Run(const HeadlessBenchmarkSettings& settings);
+
+	// Reporting
+	void WriteReport(ostream& output);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	string GetWeaponSource();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_numWeapons;
+	int m_numIterations;
+
+	// Results, times in microseconds
+	double m_textLoadTime;
+	double m_packedLoadTime;
+	double m_equipTime;
+	int m_numMismatches;
+	int m_numDefinitions;
+	int m_numSharedLoads;
+	int m_numCachedLoads;
+	int m_numCompiledLoads;
+	int m_definitionBytes;
+	int m_perWeaponBytes;
+};
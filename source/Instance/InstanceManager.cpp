@@ -12,10 +12,12 @@
 #include "InstanceManager.h"
 
 #include <algorithm>
+#include <string.h>
 
 #include "../Renderer/Renderer.h"
 #include "../utils/Random.h"
 #include "../models/QubicleBinary.h"
+#include "../utils/Profiler.h"
 
 
 InstanceManager::InstanceManager(Renderer* pRenderer)
@@ -27,6 +29,9 @@ InstanceManager::InstanceManager(Renderer* pRenderer)
 	m_instanceShader = -1;
 	m_pRenderer->LoadGLSLShader("media/shaders/instance.vertex", "media/shaders/instance.pixel", &m_instanceShader);
 
+	m_instanceDepthShader = -1;
+	m_pRenderer->LoadGLSLShader("media/shaders/instance_depth.vertex", "media/shaders/instance_depth.pixel", &m_instanceDepthShader);
+
 	m_checkChunkInstanceTimer = 0.0f;
 
 	// Test data
@@ -134,10 +139,17 @@ void InstanceManager::SetupGLBuffers(InstanceParent *pInstanceParent)
 	pInstanceParent->m_normalBuffer = -1;
 	pInstanceParent->m_colourBuffer = -1;
 	pInstanceParent->m_matrixBuffer = -1;
+	pInstanceParent->m_depthVertexArray = -1;
+	pInstanceParent->m_depthMatrixBuffer = -1;
 
 	pInstanceParent->m_pQubicleBinary = new QubicleBinary(m_pRenderer);
 	pInstanceParent->m_pQubicleBinary->Import(pInstanceParent->m_modelName.c_str(), true);
 
+#ifdef VOGUE_HEADLESS
+	// No GL context to create the instance buffers with, the imported model is all the bookkeeping we need
+	return;
+#endif //VOGUE_HEADLESS
+
 	OpenGLTriangleMesh* pMesh = pInstanceParent->m_pQubicleBinary->GetQubicleMatrix(0)->m_pMesh;	
 
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
@@ -214,6 +226,19 @@ void InstanceManager::SetupGLBuffers(InstanceParent *pInstanceParent)
 	glEnableVertexAttribArray(in_color);
 	glVertexAttribPointer(in_color, 4, GL_FLOAT, 0, 0, 0);
 
+	// A second vertex array for the depth shader, sharing the position buffer
+	glShader* pDepthShader = m_pRenderer->GetShader(m_instanceDepthShader);
+	GLint depth_in_position = glGetAttribLocation(pDepthShader->GetProgramObject(), "in_position");
+
+	glGenVertexArrays(1, &pInstanceParent->m_depthVertexArray);
+	glBindVertexArray(pInstanceParent->m_depthVertexArray);
+	glBindBuffer(GL_ARRAY_BUFFER, pInstanceParent->m_positionBuffer);
+	glEnableVertexAttribArray(depth_in_position);
+	glVertexAttribPointer(depth_in_position, 4, GL_FLOAT, 0, 0, 0);
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
 	delete vertices;
 	delete normals;
 	delete colours;
@@ -247,6 +272,12 @@ InstanceObject* InstanceManager::AddInstanceObject(string modelName, vec3 positi
 
 		SetupGLBuffers(pNewInstanceParent);
 
+		// The instanced mesh is drawn straight from its voxel coordinates, one unit per voxel starting at -0.5
+		QubicleMatrix* pMatrix = pNewInstanceParent->m_pQubicleBinary->GetQubicleMatrix(0);
+		vec3 matrixSize = vec3((float)pMatrix->m_matrixSizeX, (float)pMatrix->m_matrixSizeY, (float)pMatrix->m_matrixSizeZ);
+		pNewInstanceParent->m_boundingCenter = (matrixSize * 0.5f) - vec3(0.5f, 0.5f, 0.5f);
+		pNewInstanceParent->m_boundingRadius = length(matrixSize * 0.5f);
+
 		m_vpInstanceParentList.push_back(pNewInstanceParent);
 	}
 
@@ -313,8 +344,29 @@ void InstanceManager::Update(float dt)
 }
 
 // Rendering
+unsigned int* InstanceManager::CreateIndices(OpenGLTriangleMesh* pMesh, unsigned int *pNumIndices)
+{
+	unsigned int numTriangles = (int)pMesh->m_triangles.size();
+	*pNumIndices = numTriangles * 3;
+
+	unsigned int* indicesBuffer = new unsigned int[*pNumIndices];
+	int lIndexCounter = 0;
+	for(unsigned int i = 0; i < numTriangles; i++)
+	{
+		indicesBuffer[lIndexCounter] = pMesh->m_triangles[i]->vertexIndices[0];
+		indicesBuffer[lIndexCounter+1] = pMesh->m_triangles[i]->vertexIndices[1];
+		indicesBuffer[lIndexCounter+2] = pMesh->m_triangles[i]->vertexIndices[2];
+
+		lIndexCounter += 3;
+	}
+
+	return indicesBuffer;
+}
+
 void InstanceManager::Render()
 {
+	PROFILE_ZONE("InstanceManager::Render");
+
 	glShader* pShader = m_pRenderer->GetShader(m_instanceShader);
 
 	GLint in_position = glGetAttribLocation(pShader->GetProgramObject(), "in_position");
@@ -325,18 +377,8 @@ void InstanceManager::Render()
 	{
 		OpenGLTriangleMesh* pMesh = m_vpInstanceParentList[instanceParentId]->m_pQubicleBinary->GetQubicleMatrix(0)->m_pMesh;
 
-		unsigned int numIndices = (int)pMesh->m_triangles.size() * 3;
-		unsigned int numTriangles = (int)pMesh->m_triangles.size();
-		unsigned int* indicesBuffer = new unsigned int[numIndices];
-		int lIndexCounter = 0;
-		for(unsigned int i = 0; i < numTriangles; i++)
-		{
-			indicesBuffer[lIndexCounter] = pMesh->m_triangles[i]->vertexIndices[0];
-			indicesBuffer[lIndexCounter+1] = pMesh->m_triangles[i]->vertexIndices[1];
-			indicesBuffer[lIndexCounter+2] = pMesh->m_triangles[i]->vertexIndices[2];
-
-			lIndexCounter += 3;
-		}
+		unsigned int numIndices;
+		unsigned int* indicesBuffer = CreateIndices(pMesh, &numIndices);
 
 		int instanceObjectRenderCounter = 0;
 		int numInstanceObjectsRender = GetNumInstanceRenderObjectsForParent(instanceParentId);
@@ -448,3 +490,89 @@ void InstanceManager::Render()
 		delete indicesBuffer;
 	}
 }
+
+void InstanceManager::RenderDepthOnly(Frustum* pLightFrustum)
+{
+	PROFILE_ZONE("InstanceManager::RenderDepthOnly");
+
+	glShader* pShader = m_pRenderer->GetShader(m_instanceDepthShader);
+
+	GLint in_model_matrix = glGetAttribLocation(pShader->GetProgramObject(), "in_model_matrix");
+
+	Matrix4x4 projMat;
+	Matrix4x4 viewMat;
+	m_pRenderer->GetProjectionMatrix(&projMat);
+	m_pRenderer->GetModelViewMatrix(&viewMat);
+
+	m_pRenderer->BeginGLSLShader(m_instanceDepthShader);
+	glUniformMatrix4fv(glGetUniformLocation(pShader->GetProgramObject(), "projMatrix"), 1, false, projMat.m);
+	glUniformMatrix4fv(glGetUniformLocation(pShader->GetProgramObject(), "viewMatrix"), 1, false, viewMat.m);
+
+	m_pRenderer->StartDepthOnlyRender();
+
+	for(int instanceParentId = 0; instanceParentId < (int)m_vpInstanceParentList.size(); instanceParentId++)
+	{
+		InstanceParent* pInstanceParent = m_vpInstanceParentList[instanceParentId];
+
+		// Every instance inside the light's view casts, whether or not it is in the camera's view
+		int numInstanceObjects = 0;
+		float* newMatrices = new float[16 * pInstanceParent->m_vpInstanceObjectList.size()];
+		for(unsigned int i = 0; i < pInstanceParent->m_vpInstanceObjectList.size(); i++)
+		{
+			InstanceObject* pInstanceObject = pInstanceParent->m_vpInstanceObjectList[i];
+			if(pInstanceObject->m_erase)
+			{
+				continue;
+			}
+
+			// The instances are scaled uniformly
+			vec3 origin = pInstanceObject->m_worldMatrix * vec3(0.0f, 0.0f, 0.0f);
+			float scale = length((pInstanceObject->m_worldMatrix * vec3(1.0f, 0.0f, 0.0f)) - origin);
+			vec3 center = pInstanceObject->m_worldMatrix * pInstanceParent->m_boundingCenter;
+			if(pLightFrustum->SphereInFrustum(center, pInstanceParent->m_boundingRadius * scale) == Frustum::FRUSTUM_OUTSIDE)
+			{
+				continue;
+			}
+
+			memcpy(&newMatrices[numInstanceObjects * 16], pInstanceObject->m_worldMatrix.m, sizeof(float) * 16);
+			numInstanceObjects++;
+		}
+
+		if(numInstanceObjects == 0)
+		{
+			delete [] newMatrices;
+			continue;
+		}
+
+		glBindVertexArray(pInstanceParent->m_depthVertexArray);
+
+		if(pInstanceParent->m_depthMatrixBuffer == -1)
+		{
+			glGenBuffers(1, &pInstanceParent->m_depthMatrixBuffer);
+		}
+		glBindBuffer(GL_ARRAY_BUFFER, pInstanceParent->m_depthMatrixBuffer);
+		for (int i = 0; i < 4; i++)
+		{
+			glVertexAttribPointer(in_model_matrix + i, 4, GL_FLOAT, GL_FALSE, 4*16, reinterpret_cast<void *>(16 * i));
+			glEnableVertexAttribArray(in_model_matrix + i);
+			glVertexAttribDivisor(in_model_matrix + i, 1);
+		}
+		glBufferData(GL_ARRAY_BUFFER, sizeof(float)*16*numInstanceObjects, newMatrices, GL_STREAM_DRAW);
+
+		delete [] newMatrices;
+
+		OpenGLTriangleMesh* pMesh = pInstanceParent->m_pQubicleBinary->GetQubicleMatrix(0)->m_pMesh;
+		unsigned int numIndices;
+		unsigned int* indicesBuffer = CreateIndices(pMesh, &numIndices);
+
+		glDrawElementsInstanced(GL_TRIANGLES, numIndices, GL_UNSIGNED_INT, indicesBuffer, numInstanceObjects);
+
+		delete [] indicesBuffer;
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_pRenderer->EndDepthOnlyRender();
+	m_pRenderer->EndGLSLShader(m_instanceDepthShader);
+}
\ No newline at end of file
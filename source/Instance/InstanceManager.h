@@ -24,7 +24,9 @@
 #include "../Maths/3dmaths.h"
 
 class QubicleBinary;
+class Frustum;
 class Renderer;
+class OpenGLTriangleMesh;
 
 class InstanceObject
 {
@@ -55,10 +57,18 @@ public:
 	unsigned int m_colourBuffer;
 	unsigned int m_matrixBuffer;
 
+	// Depth only rendering, positions and matrices only
+	unsigned int m_depthVertexArray;
+	unsigned int m_depthMatrixBuffer;
+
 	InstanceObjectList m_vpInstanceObjectList;
 
 	string m_modelName;
 	QubicleBinary* m_pQubicleBinary;
+
+	// A sphere holding the instanced mesh, in the mesh's own space
+	vec3 m_boundingCenter;
+	float m_boundingRadius;
 };
 
 typedef vector<InstanceParent*> InstanceParentList;
@@ -96,12 +106,14 @@ public:
 
 	// Rendering
 	void Render();
+	void RenderDepthOnly(Frustum* pLightFrustum);
 
 protected:
 	/* Protected methods */
 
 private:
 	/* Private methods */
+	unsigned int* CreateIndices(OpenGLTriangleMesh* pMesh, unsigned int *pNumIndices);
 
 public:
 	/* Public members */
@@ -118,6 +130,7 @@ private:
 
 	// Shader
 	unsigned int m_instanceShader;
+	unsigned int m_instanceDepthShader;
 
 	// List of instance parents what we render in a single render call for all children instances
 	InstanceParentList m_vpInstanceParentList;
@@ -0,0 +1,223 @@
+// ******************************************************************************
+// Filename:    TransformHierarchy.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "TransformHierarchy.h"
+
+
+TransformHierarchy::TransformHierarchy()
+{
+	m_numUpdated = 0;
+}
+
+TransformHierarchy::~TransformHierarchy()
+{
+	ClearNodes();
+}
+
+void TransformHierarchy::ClearNodes()
+{
+	m_vLocalMatrices.clear();
+	m_vWorldMatrices.clear();
+	m_vParents.clear();
+	m_vFirstChildren.clear();
+	m_vNextSiblings.clear();
+	m_vDirty.clear();
+	m_vUsed.clear();
+	m_vFreeNodes.clear();
+	m_vDirtyNodes.clear();
+
+	m_numUpdated = 0;
+}
+
+// Nodes
+int TransformHierarchy::CreateNode(int parentId)
+{
+	int nodeId;
+	if (m_vFreeNodes.size() > 0)
+	{
+		nodeId = m_vFreeNodes.back();
+		m_vFreeNodes.pop_back();
+	}
+	else
+	{
+		nodeId = (int)m_vLocalMatrices.size();
+		m_vLocalMatrices.push_back(Matrix4x4());
+		m_vWorldMatrices.push_back(Matrix4x4());
+		m_vParents.push_back(-1);
+		m_vFirstChildren.push_back(-1);
+		m_vNextSiblings.push_back(-1);
+		m_vDirty.push_back(false);
+		m_vUsed.push_back(false);
+	}
+
+	m_vLocalMatrices[nodeId].LoadIdentity();
+	m_vWorldMatrices[nodeId].LoadIdentity();
+	m_vParents[nodeId] = parentId;
+	m_vFirstChildren[nodeId] = -1;
+	m_vNextSiblings[nodeId] = -1;
+	m_vUsed[nodeId] = true;
+
+	if (parentId != -1)
+	{
+		m_vNextSiblings[nodeId] = m_vFirstChildren[parentId];
+		m_vFirstChildren[parentId] = nodeId;
+	}
+
+	// Picks up its parent's world matrix on the next update
+	m_vDirty[nodeId] = true;
+	m_vDirtyNodes.push_back(nodeId);
+
+	return nodeId;
+}
+
+void TransformHierarchy::DestroyNode(int nodeId)
+{
+	if (nodeId < 0 || nodeId >= (int)m_vUsed.size() || m_vUsed[nodeId] == false)
+	{
+		return;
+	}
+
+	while (m_vFirstChildren[nodeId] != -1)
+	{
+		DestroyNode(m_vFirstChildren[nodeId]);
+	}
+
+	// Unlink from the parent's children
+	int parentId = m_vParents[nodeId];
+	if (parentId != -1)
+	{
+		if (m_vFirstChildren[parentId] == nodeId)
+		{
+			m_vFirstChildren[parentId] = m_vNextSiblings[nodeId];
+		}
+		else
+		{
+			int siblingId = m_vFirstChildren[parentId];
+			while (m_vNextSiblings[siblingId] != nodeId)
+			{
+				siblingId = m_vNextSiblings[siblingId];
+			}
+			m_vNextSiblings[siblingId] = m_vNextSiblings[nodeId];
+		}
+	}
+
+	m_vParents[nodeId] = -1;
+	m_vNextSiblings[nodeId] = -1;
+	m_vDirty[nodeId] = false;
+	m_vUsed[nodeId] = false;
+	m_vFreeNodes.push_back(nodeId);
+}
+
+int TransformHierarchy::GetNumNodes()
+{
+	return (int)(m_vUsed.size() - m_vFreeNodes.size());
+}
+
+// Local transforms
+void TransformHierarchy::SetLocalMatrix(int nodeId, const Matrix4x4& localMatrix)
+{
+	m_vLocalMatrices[nodeId] = localMatrix;
+
+	if (m_vDirty[nodeId] == false)
+	{
+		m_vDirty[nodeId] = true;
+		m_vDirtyNodes.push_back(nodeId);
+	}
+}
+
+const Matrix4x4& TransformHierarchy::GetLocalMatrix(int nodeId)
+{
+	return m_vLocalMatrices[nodeId];
+}
+
+// World transforms
+const Matrix4x4& TransformHierarchy::GetWorldMatrix(int nodeId)
+{
+	return m_vWorldMatrices[nodeId];
+}
+
+const Matrix4x4* TransformHierarchy::GetWorldMatrices()
+{
+	return m_vWorldMatrices.size() > 0 ? &m_vWorldMatrices[0] : NULL;
+}
+
+// Update
+void TransformHierarchy::Update()
+{
+	m_numUpdated = 0;
+
+	if (m_vDirtyNodes.size() == 0)
+	{
+		return;
+	}
+
+	for (unsigned int i = 0; i < m_vDirtyNodes.size(); i++)
+	{
+		int nodeId = m_vDirtyNodes[i];
+
+		// Already done as part of a parent's update, or destroyed since it was changed
+		if (m_vUsed[nodeId] == false || m_vDirty[nodeId] == false)
+		{
+			continue;
+		}
+
+		// The topmost changed node updates everything beneath it
+		if (HasDirtyParent(nodeId))
+		{
+			continue;
+		}
+
+		UpdateNode(nodeId);
+	}
+
+	m_vDirtyNodes.clear();
+}
+
+int TransformHierarchy::GetNumUpdated()
+{
+	return m_numUpdated;
+}
+
+// Private methods
+bool TransformHierarchy::HasDirtyParent(int nodeId)
+{
+	for (int parentId = m_vParents[nodeId]; parentId != -1; parentId = m_vParents[parentId])
+	{
+		if (m_vDirty[parentId])
+		{
+			return true;
+		}
+	}
+
+	return false;
+}
+
+void TransformHierarchy::UpdateNode(int nodeId)
+{
+	// Same order as the renderer's matrix stack, the local transform is applied before the parent's
+	int parentId = m_vParents[nodeId];
+	if (parentId == -1)
+	{
+		m_vWorldMatrices[nodeId] = m_vLocalMatrices[nodeId];
+	}
+	else
+	{
+		Matrix4x4::Multiply(m_vLocalMatrices[nodeId], m_vWorldMatrices[parentId], m_vWorldMatrices[nodeId]);
+	}
+
+	m_vDirty[nodeId] = false;
+	m_numUpdated++;
+
+	for (int childId = m_vFirstChildren[nodeId]; childId != -1; childId = m_vNextSiblings[childId])
+	{
+		UpdateNode(childId);
+	}
+}
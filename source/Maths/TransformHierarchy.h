@@ -0,0 +1,89 @@
+// ******************************************************************************
+// Filename:    TransformHierarchy.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   A scene hierarchy of transforms. Every node has a local matrix relative
+//   to its parent, and its world matrix is only composed again when that
+//   local matrix, or the local matrix of one of its parents, has changed
+//   since the last update. The world matrices are stored contiguously and
+//   are handed straight to the renderer, so a scene where nothing moves
+//   does no transform maths at all from one frame to the next.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "3dmaths.h"
+
+#include <vector>
+using namespace std;
+
+
+class TransformHierarchy
+{
+public:
+	/* Public methods */
+	TransformHierarchy();
+	~TransformHierarchy();
+
+	void ClearNodes();
+
+	// Nodes, a parent of -1 makes a root node. Destroying a node destroys all of its children too
+	int CreateNode(int parentId = -1);
+	void DestroyNode(int nodeId);
+	int GetNumNodes();
+
+	// Local transforms, the world matrix follows on the next update
+	void SetLocalMatrix(int nodeId, const Matrix4x4& localMatrix);
+	const Matrix4x4& GetLocalMatrix(int nodeId);
+
+	// World transforms, as of the last update
+	const Matrix4x4& GetWorldMatrix(int nodeId);
+	const Matrix4x4* GetWorldMatrices();
+
+	// Update, composes the world matrices of the nodes that changed
+	void Update();
+	int GetNumUpdated();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	TransformHierarchy(const TransformHierarchy&);
+	TransformHierarchy &operator=(const TransformHierarchy&);
+
+	bool HasDirtyParent(int nodeId);
+	void UpdateNode(int nodeId);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	// Per node, indexed by node id
+	vector<Matrix4x4> m_vLocalMatrices;
+	vector<Matrix4x4> m_vWorldMatrices;
+	vector<int> m_vParents;
+	vector<int> m_vFirstChildren;
+	vector<int> m_vNextSiblings;
+	vector<bool> m_vDirty;
+	vector<bool> m_vUsed;
+
+	vector<int> m_vFreeNodes;
+
+	// Nodes whose local matrix changed since the last update
+	vector<int> m_vDirtyNodes;
+
+	// World matrices composed by the last update
+	int m_numUpdated;
+};
@@ -0,0 +1,575 @@
+// ******************************************************************************
+// Filename:    ParticleManager.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ParticleManager.h"
+
+#include "../Renderer/Renderer.h"
+#include "../utils/Profiler.h"
+
+#include <fstream>
+#include <iostream>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define PARTICLE_MANAGER_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// value += rate * dt over a whole stream, the pools are sized so the count can be rounded up to a group of four
+static void IntegrateStream(float* pValue, const float* pRate, float dt, int count)
+{
+#ifdef PARTICLE_MANAGER_SSE2
+	__m128 delta = _mm_set1_ps(dt);
+	for (int i = 0; i < count; i += 4)
+	{
+		__m128 value = _mm_loadu_ps(pValue + i);
+		__m128 rate = _mm_loadu_ps(pRate + i);
+		_mm_storeu_ps(pValue + i, _mm_add_ps(value, _mm_mul_ps(rate, delta)));
+	}
+#else
+	for (int i = 0; i < count; i++)
+	{
+		pValue[i] += pRate[i] * dt;
+	}
+#endif
+}
+
+static void AdvanceStream(float* pValue, float dt, int count)
+{
+#ifdef PARTICLE_MANAGER_SSE2
+	__m128 delta = _mm_set1_ps(dt);
+	for (int i = 0; i < count; i += 4)
+	{
+		_mm_storeu_ps(pValue + i, _mm_add_ps(_mm_loadu_ps(pValue + i), delta));
+	}
+#else
+	for (int i = 0; i < count; i++)
+	{
+		pValue[i] += dt;
+	}
+#endif
+}
+
+
+ParticleManager::ParticleManager(Renderer* pRenderer)
+{
+	m_pRenderer = pRenderer;
+
+	m_randomSeed = 1;
+	m_numEmittersCreated = 0;
+	m_numDroppedParticles = 0;
+}
+
+ParticleManager::~ParticleManager()
+{
+	ClearEmitters();
+
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		delete m_vpPools[i];
+		m_vpPools[i] = 0;
+	}
+	m_vpPools.clear();
+}
+
+// Clearing
+void ParticleManager::ClearParticles()
+{
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		m_vpPools[i]->m_numParticles = 0;
+		m_vpPools[i]->m_numVertices = 0;
+	}
+
+	for (unsigned int i = 0; i < m_vEmitters.size(); i++)
+	{
+		m_vEmitters[i].m_numAlive = 0;
+	}
+}
+
+void ParticleManager::ClearEmitters()
+{
+	ClearParticles();
+
+	m_vEmitters.clear();
+	m_vFreeEmitters.clear();
+}
+
+// Effects
+int ParticleManager::LoadEffect(const char* fileName)
+{
+	for (unsigned int i = 0; i < m_vEffects.size(); i++)
+	{
+		if (m_vEffects[i].m_fileName == fileName)
+		{
+			return i;
+		}
+	}
+
+	ParticleEffectParams params;
+	params.m_fileName = fileName;
+	params.m_textureFileName = "none";
+	params.m_emissionRate = 0.0f;
+	params.m_maxParticles = 0;
+	params.m_lifeTimeMin = 1.0f;
+	params.m_lifeTimeMax = 1.0f;
+	params.m_startSize = 0.1f;
+	params.m_endSize = 0.1f;
+	params.m_startColour = Colour(1.0f, 1.0f, 1.0f, 1.0f);
+	params.m_endColour = Colour(1.0f, 1.0f, 1.0f, 0.0f);
+
+	ifstream file;
+	file.open(fileName, ios::in);
+	if (file.is_open() == false)
+	{
+		// Still keep an entry that emits nothing, so a missing file isn't looked for again
+		cout << "ERROR: Could not load particle effect file: " << fileName << endl;
+		return AddEffect(params);
+	}
+
+	string tempString;
+
+	file >> tempString >> params.m_textureFileName;
+
+	file >> tempString >> params.m_emissionRate;
+	file >> tempString >> params.m_maxParticles;
+	file >> tempString >> params.m_lifeTimeMin >> params.m_lifeTimeMax;
+
+	file >> tempString >> params.m_positionSpread.x >> params.m_positionSpread.y >> params.m_positionSpread.z;
+	file >> tempString >> params.m_velocity.x >> params.m_velocity.y >> params.m_velocity.z;
+	file >> tempString >> params.m_velocitySpread.x >> params.m_velocitySpread.y >> params.m_velocitySpread.z;
+	file >> tempString >> params.m_gravity.x >> params.m_gravity.y >> params.m_gravity.z;
+
+	file >> tempString >> params.m_startSize >> params.m_endSize;
+
+	float r, g, b, a;
+	file >> tempString >> r >> g >> b >> a;
+	params.m_startColour = Colour(r, g, b, a);
+	file >> tempString >> r >> g >> b >> a;
+	params.m_endColour = Colour(r, g, b, a);
+
+	file.close();
+
+	return AddEffect(params);
+}
+
+int ParticleManager::AddEffect(const ParticleEffectParams& params)
+{
+	m_vEffects.push_back(params);
+
+	// A lifetime of zero would never give the colour and size a rate to change at
+	ParticleEffectParams* pParams = &m_vEffects.back();
+	pParams->m_lifeTimeMin = pParams->m_lifeTimeMin > 0.01f ? pParams->m_lifeTimeMin : 0.01f;
+	pParams->m_lifeTimeMax = pParams->m_lifeTimeMax > pParams->m_lifeTimeMin ? pParams->m_lifeTimeMax : pParams->m_lifeTimeMin;
+
+	return (int)m_vEffects.size() - 1;
+}
+
+int ParticleManager::GetNumEffects()
+{
+	return (int)m_vEffects.size();
+}
+
+// Emitters
+unsigned int ParticleManager::CreateEmitter(int effectIndex, vec3 position, void* pOwner)
+{
+	if (effectIndex < 0 || effectIndex >= (int)m_vEffects.size())
+	{
+		return INVALID_EMITTER;
+	}
+
+	unsigned int emitterId;
+	if (m_vFreeEmitters.empty() == false)
+	{
+		emitterId = m_vFreeEmitters.back();
+		m_vFreeEmitters.pop_back();
+	}
+	else
+	{
+		emitterId = (unsigned int)m_vEmitters.size();
+		m_vEmitters.push_back(ParticleEmitter());
+	}
+
+	ParticleEmitter* pEmitter = &m_vEmitters[emitterId];
+	pEmitter->m_used = true;
+	pEmitter->m_enabled = true;
+	pEmitter->m_effectIndex = effectIndex;
+	pEmitter->m_poolIndex = GetPool(m_vEffects[effectIndex].m_textureFileName);
+	pEmitter->m_pOwner = pOwner;
+	pEmitter->m_position = position;
+	pEmitter->m_emissionAccumulator = 0.0f;
+	pEmitter->m_numAlive = 0;
+
+	// Each emitter gets its own stream, so the same seed and creation order always give the same particles
+	pEmitter->m_randomSeed = (m_randomSeed * 2654435761u) ^ ((m_numEmittersCreated + 1) * 40503u);
+	m_numEmittersCreated++;
+
+	return emitterId;
+}
+
+unsigned int ParticleManager::CreateEmitter(const char* effectFileName, vec3 position, void* pOwner)
+{
+	return CreateEmitter(LoadEffect(effectFileName), position, pOwner);
+}
+
+void ParticleManager::DestroyEmitter(unsigned int emitterId)
+{
+	if (emitterId >= m_vEmitters.size() || m_vEmitters[emitterId].m_used == false)
+	{
+		return;
+	}
+
+	// Particles already emitted live out their lifetime, they just no longer count against the emitter
+	ParticlePool* pPool = m_vpPools[m_vEmitters[emitterId].m_poolIndex];
+	for (int i = 0; i < pPool->m_numParticles; i++)
+	{
+		if (pPool->m_vEmitterIds[i] == (int)emitterId)
+		{
+			pPool->m_vEmitterIds[i] = -1;
+		}
+	}
+
+	m_vEmitters[emitterId].m_used = false;
+	m_vEmitters[emitterId].m_pOwner = NULL;
+	m_vFreeEmitters.push_back(emitterId);
+}
+
+void ParticleManager::DestroyEmitters(void* pOwner)
+{
+	for (unsigned int i = 0; i < m_vEmitters.size(); i++)
+	{
+		if (m_vEmitters[i].m_used && m_vEmitters[i].m_pOwner == pOwner)
+		{
+			DestroyEmitter(i);
+		}
+	}
+}
+
+void ParticleManager::SetEmitterPosition(unsigned int emitterId, vec3 position)
+{
+	if (emitterId >= m_vEmitters.size())
+	{
+		return;
+	}
+
+	m_vEmitters[emitterId].m_position = position;
+}
+
+void ParticleManager::SetEmitterEnabled(unsigned int emitterId, bool enabled)
+{
+	if (emitterId >= m_vEmitters.size())
+	{
+		return;
+	}
+
+	m_vEmitters[emitterId].m_enabled = enabled;
+}
+
+int ParticleManager::GetNumEmitters()
+{
+	return (int)(m_vEmitters.size() - m_vFreeEmitters.size());
+}
+
+// Seeding
+void ParticleManager::SetRandomSeed(unsigned int seed)
+{
+	m_randomSeed = seed;
+	m_numEmittersCreated = 0;
+}
+
+// Accessors
+int ParticleManager::GetNumParticles()
+{
+	int numParticles = 0;
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		numParticles += m_vpPools[i]->m_numParticles;
+	}
+
+	return numParticles;
+}
+
+int ParticleManager::GetNumPools()
+{
+	return (int)m_vpPools.size();
+}
+
+int ParticleManager::GetNumDroppedParticles()
+{
+	return m_numDroppedParticles;
+}
+
+// Update
+void ParticleManager::Update(float dt)
+{
+	PROFILE_ZONE("ParticleManager::Update");
+
+	// Integrate every pool, each stream in one pass
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		ParticlePool* pPool = m_vpPools[i];
+		if (pPool->m_numParticles == 0)
+		{
+			continue;
+		}
+
+		int count = (pPool->m_numParticles + 3) & ~3;
+		float* pStreams[ParticleStream_NUM];
+		for (int stream = 0; stream < ParticleStream_NUM; stream++)
+		{
+			pStreams[stream] = &pPool->m_vStreams[stream][0];
+		}
+
+		IntegrateStream(pStreams[ParticleStream_VelocityX], pStreams[ParticleStream_AccelerationX], dt, count);
+		IntegrateStream(pStreams[ParticleStream_VelocityY], pStreams[ParticleStream_AccelerationY], dt, count);
+		IntegrateStream(pStreams[ParticleStream_VelocityZ], pStreams[ParticleStream_AccelerationZ], dt, count);
+		IntegrateStream(pStreams[ParticleStream_PositionX], pStreams[ParticleStream_VelocityX], dt, count);
+		IntegrateStream(pStreams[ParticleStream_PositionY], pStreams[ParticleStream_VelocityY], dt, count);
+		IntegrateStream(pStreams[ParticleStream_PositionZ], pStreams[ParticleStream_VelocityZ], dt, count);
+		IntegrateStream(pStreams[ParticleStream_ColourR], pStreams[ParticleStream_ColourDeltaR], dt, count);
+		IntegrateStream(pStreams[ParticleStream_ColourG], pStreams[ParticleStream_ColourDeltaG], dt, count);
+		IntegrateStream(pStreams[ParticleStream_ColourB], pStreams[ParticleStream_ColourDeltaB], dt, count);
+		IntegrateStream(pStreams[ParticleStream_ColourA], pStreams[ParticleStream_ColourDeltaA], dt, count);
+		IntegrateStream(pStreams[ParticleStream_Size], pStreams[ParticleStream_SizeDelta], dt, count);
+		AdvanceStream(pStreams[ParticleStream_Age], dt, count);
+
+		// Remove the expired particles, walking backwards so the swapped in particle has already been checked
+		const float* pAge = pStreams[ParticleStream_Age];
+		const float* pLifeTime = pStreams[ParticleStream_LifeTime];
+		for (int particle = pPool->m_numParticles - 1; particle >= 0; particle--)
+		{
+			if (pAge[particle] >= pLifeTime[particle])
+			{
+				RemoveParticle(pPool, particle);
+			}
+		}
+	}
+
+	// Emit new particles, up to each emitter's budget
+	for (unsigned int i = 0; i < m_vEmitters.size(); i++)
+	{
+		ParticleEmitter* pEmitter = &m_vEmitters[i];
+		if (pEmitter->m_used == false || pEmitter->m_enabled == false)
+		{
+			continue;
+		}
+
+		const ParticleEffectParams& params = m_vEffects[pEmitter->m_effectIndex];
+
+		pEmitter->m_emissionAccumulator += params.m_emissionRate * dt;
+		int numToEmit = (int)pEmitter->m_emissionAccumulator;
+		pEmitter->m_emissionAccumulator -= numToEmit;
+
+		// Particles the emitter's own budget holds back are just not wanted, running out of pool is worth knowing about
+		int emitterBudget = params.m_maxParticles - pEmitter->m_numAlive;
+		int poolBudget = PARTICLE_POOL_BUDGET - m_vpPools[pEmitter->m_poolIndex]->m_numParticles;
+		int numWanted = numToEmit < emitterBudget ? numToEmit : emitterBudget;
+		numWanted = numWanted > 0 ? numWanted : 0;
+		int numEmitted = numWanted < poolBudget ? numWanted : poolBudget;
+		m_numDroppedParticles += numWanted - numEmitted;
+
+		Emit(i, numEmitted);
+	}
+}
+
+// Rendering
+void ParticleManager::BuildVertices(vec3 cameraRight, vec3 cameraUp)
+{
+	PROFILE_ZONE("ParticleManager::BuildVertices");
+
+	// Corners of the quad, facing the camera
+	const float cornerX[4] = { -1.0f, 1.0f, 1.0f, -1.0f };
+	const float cornerY[4] = { -1.0f, -1.0f, 1.0f, 1.0f };
+	const float textureS[4] = { 0.0f, 1.0f, 1.0f, 0.0f };
+	const float textureT[4] = { 0.0f, 0.0f, 1.0f, 1.0f };
+
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		ParticlePool* pPool = m_vpPools[i];
+
+		pPool->m_numVertices = pPool->m_numParticles * 4;
+		float* pVertex = pPool->m_vVertices.empty() ? NULL : &pPool->m_vVertices[0];
+		for (int particle = 0; particle < pPool->m_numParticles; particle++)
+		{
+			float size = pPool->m_vStreams[ParticleStream_Size][particle];
+			vec3 position = vec3(pPool->m_vStreams[ParticleStream_PositionX][particle], pPool->m_vStreams[ParticleStream_PositionY][particle], pPool->m_vStreams[ParticleStream_PositionZ][particle]);
+			vec3 right = cameraRight * size;
+			vec3 up = cameraUp * size;
+
+			for (int corner = 0; corner < 4; corner++)
+			{
+				vec3 cornerPosition = position + (right * cornerX[corner]) + (up * cornerY[corner]);
+				pVertex[0] = cornerPosition.x;
+				pVertex[1] = cornerPosition.y;
+				pVertex[2] = cornerPosition.z;
+				pVertex[3] = pPool->m_vStreams[ParticleStream_ColourR][particle];
+				pVertex[4] = pPool->m_vStreams[ParticleStream_ColourG][particle];
+				pVertex[5] = pPool->m_vStreams[ParticleStream_ColourB][particle];
+				pVertex[6] = pPool->m_vStreams[ParticleStream_ColourA][particle];
+				pVertex[7] = textureS[corner];
+				pVertex[8] = textureT[corner];
+				pVertex += PARTICLE_VERTEX_FLOATS;
+			}
+		}
+	}
+}
+
+void ParticleManager::Render()
+{
+	PROFILE_ZONE("ParticleManager::Render");
+
+	m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+	m_pRenderer->DisableDepthWrite();
+	m_pRenderer->SetCullMode(CM_NOCULL);
+
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		ParticlePool* pPool = m_vpPools[i];
+		if (pPool->m_numVertices == 0)
+		{
+			continue;
+		}
+
+		m_pRenderer->RenderStreamBuffer(pPool->m_streamBufferId, pPool->m_textureId, pPool->m_numVertices, &pPool->m_vVertices[0]);
+	}
+
+	m_pRenderer->SetCullMode(CM_BACK);
+	m_pRenderer->EnableDepthWrite();
+	m_pRenderer->DisableTransparency();
+}
+
+int ParticleManager::GetNumVertices()
+{
+	int numVertices = 0;
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		numVertices += m_vpPools[i]->m_numVertices;
+	}
+
+	return numVertices;
+}
+
+const float* ParticleManager::GetPoolVertices(int poolIndex, int* pNumVertices)
+{
+	*pNumVertices = m_vpPools[poolIndex]->m_numVertices;
+
+	return m_vpPools[poolIndex]->m_vVertices.empty() ? NULL : &m_vpPools[poolIndex]->m_vVertices[0];
+}
+
+int ParticleManager::GetPool(const string& textureFileName)
+{
+	for (unsigned int i = 0; i < m_vpPools.size(); i++)
+	{
+		if (m_vpPools[i]->m_textureFileName == textureFileName)
+		{
+			return i;
+		}
+	}
+
+	ParticlePool* pPool = new ParticlePool();
+	pPool->m_textureFileName = textureFileName;
+	pPool->m_textureId = -1;
+	pPool->m_numParticles = 0;
+	pPool->m_numVertices = 0;
+
+	// An effect without a texture is drawn with just the vertex colours
+	if (textureFileName != "none")
+	{
+		int textureWidth, textureHeight, textureWidth2, textureHeight2;
+		if (m_pRenderer->LoadTexture(textureFileName, &textureWidth, &textureHeight, &textureWidth2, &textureHeight2, &pPool->m_textureId) == false)
+		{
+			pPool->m_textureId = -1;
+		}
+	}
+	m_pRenderer->CreateStreamBuffer(&pPool->m_streamBufferId);
+
+	// The whole budget up front, padded so a pass can always read a full group of four
+	for (int stream = 0; stream < ParticleStream_NUM; stream++)
+	{
+		pPool->m_vStreams[stream].resize((PARTICLE_POOL_BUDGET + 3) & ~3, 0.0f);
+	}
+	pPool->m_vEmitterIds.resize(PARTICLE_POOL_BUDGET, -1);
+	pPool->m_vVertices.resize(PARTICLE_POOL_BUDGET * 4 * PARTICLE_VERTEX_FLOATS, 0.0f);
+
+	m_vpPools.push_back(pPool);
+
+	return (int)m_vpPools.size() - 1;
+}
+
+void ParticleManager::Emit(unsigned int emitterId, int numParticles)
+{
+	ParticleEmitter* pEmitter = &m_vEmitters[emitterId];
+	const ParticleEffectParams& params = m_vEffects[pEmitter->m_effectIndex];
+	ParticlePool* pPool = m_vpPools[pEmitter->m_poolIndex];
+
+	for (int i = 0; i < numParticles; i++)
+	{
+		int index = pPool->m_numParticles;
+		pPool->m_numParticles++;
+		pEmitter->m_numAlive++;
+
+		float lifeTime = GetRandomValue(&pEmitter->m_randomSeed, params.m_lifeTimeMin, params.m_lifeTimeMax);
+
+		pPool->m_vStreams[ParticleStream_PositionX][index] = pEmitter->m_position.x + GetRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.x, params.m_positionSpread.x);
+		pPool->m_vStreams[ParticleStream_PositionY][index] = pEmitter->m_position.y + GetRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.y, params.m_positionSpread.y);
+		pPool->m_vStreams[ParticleStream_PositionZ][index] = pEmitter->m_position.z + GetRandomValue(&pEmitter->m_randomSeed, -params.m_positionSpread.z, params.m_positionSpread.z);
+		pPool->m_vStreams[ParticleStream_VelocityX][index] = params.m_velocity.x + GetRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.x, params.m_velocitySpread.x);
+		pPool->m_vStreams[ParticleStream_VelocityY][index] = params.m_velocity.y + GetRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.y, params.m_velocitySpread.y);
+		pPool->m_vStreams[ParticleStream_VelocityZ][index] = params.m_velocity.z + GetRandomValue(&pEmitter->m_randomSeed, -params.m_velocitySpread.z, params.m_velocitySpread.z);
+		pPool->m_vStreams[ParticleStream_AccelerationX][index] = params.m_gravity.x;
+		pPool->m_vStreams[ParticleStream_AccelerationY][index] = params.m_gravity.y;
+		pPool->m_vStreams[ParticleStream_AccelerationZ][index] = params.m_gravity.z;
+
+		// Colour and size move linearly from their start to their end values over the lifetime
+		pPool->m_vStreams[ParticleStream_ColourR][index] = params.m_startColour.GetRed();
+		pPool->m_vStreams[ParticleStream_ColourG][index] = params.m_startColour.GetGreen();
+		pPool->m_vStreams[ParticleStream_ColourB][index] = params.m_startColour.GetBlue();
+		pPool->m_vStreams[ParticleStream_ColourA][index] = params.m_startColour.GetAlpha();
+		pPool->m_vStreams[ParticleStream_ColourDeltaR][index] = (params.m_endColour.GetRed() - params.m_startColour.GetRed()) / lifeTime;
+		pPool->m_vStreams[ParticleStream_ColourDeltaG][index] = (params.m_endColour.GetGreen() - params.m_startColour.GetGreen()) / lifeTime;
+		pPool->m_vStreams[ParticleStream_ColourDeltaB][index] = (params.m_endColour.GetBlue() - params.m_startColour.GetBlue()) / lifeTime;
+		pPool->m_vStreams[ParticleStream_ColourDeltaA][index] = (params.m_endColour.GetAlpha() - params.m_startColour.GetAlpha()) / lifeTime;
+		pPool->m_vStreams[ParticleStream_Size][index] = params.m_startSize;
+		pPool->m_vStreams[ParticleStream_SizeDelta][index] = (params.m_endSize - params.m_startSize) / lifeTime;
+		pPool->m_vStreams[ParticleStream_Age][index] = 0.0f;
+		pPool->m_vStreams[ParticleStream_LifeTime][index] = lifeTime;
+
+		pPool->m_vEmitterIds[index] = emitterId;
+	}
+}
+
+void ParticleManager::RemoveParticle(ParticlePool* pPool, int index)
+{
+	int emitterId = pPool->m_vEmitterIds[index];
+	if (emitterId != -1)
+	{
+		m_vEmitters[emitterId].m_numAlive--;
+	}
+
+	// Move the last particle into the gap
+	int last = pPool->m_numParticles - 1;
+	for (int stream = 0; stream < ParticleStream_NUM; stream++)
+	{
+		pPool->m_vStreams[stream][index] = pPool->m_vStreams[stream][last];
+	}
+	pPool->m_vEmitterIds[index] = pPool->m_vEmitterIds[last];
+
+	pPool->m_numParticles--;
+}
+
+// A small deterministic generator for each emitter
+float ParticleManager::GetRandomValue(unsigned int* pSeed, float minValue, float maxValue)
+{
+	*pSeed = (*pSeed * 1103515245u) + 12345u;
+	float ratio = (float)((*pSeed >> 8) & 0xFFFF) / 65535.0f;
+
+	return minValue + ((maxValue - minValue) * ratio);
+}
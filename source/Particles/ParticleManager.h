@@ -0,0 +1,196 @@
+// ******************************************************************************
+// Filename:    ParticleManager.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Particle emitters for weapon particle effects and anything else that
+//   wants them. Particles are kept in pools, one per texture, with each
+//   property stored in its own array so the whole pool is integrated four
+//   particles at a time with SSE2. Every emitter has a fixed budget and its
+//   own deterministic random seed, and each pool is written into a single
+//   streamed vertex buffer, so all the particles using one texture are
+//   drawn with one call.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Maths/3dmaths.h"
+#include "../Renderer/colour.h"
+
+#include <vector>
+#include <string>
+using namespace std;
+
+class Renderer;
+
+// The most particles one pool can hold, new particles are dropped while it is full
+const int PARTICLE_POOL_BUDGET = 16384;
+
+// Position, colour and texture coordinate for each corner of a particle quad
+const int PARTICLE_VERTEX_FLOATS = 9;
+
+// The per particle properties, each one is stored as its own array in the pool
+enum ParticleStream
+{
+	ParticleStream_PositionX = 0,
+	ParticleStream_PositionY,
+	ParticleStream_PositionZ,
+	ParticleStream_VelocityX,
+	ParticleStream_VelocityY,
+	ParticleStream_VelocityZ,
+	ParticleStream_AccelerationX,
+	ParticleStream_AccelerationY,
+	ParticleStream_AccelerationZ,
+	ParticleStream_ColourR,
+	ParticleStream_ColourG,
+	ParticleStream_ColourB,
+	ParticleStream_ColourA,
+	ParticleStream_ColourDeltaR,
+	ParticleStream_ColourDeltaG,
+	ParticleStream_ColourDeltaB,
+	ParticleStream_ColourDeltaA,
+	ParticleStream_Size,
+	ParticleStream_SizeDelta,
+	ParticleStream_Age,
+	ParticleStream_LifeTime,
+
+	ParticleStream_NUM,
+};
+
+// The settings for an effect, loaded from a .effect file
+class ParticleEffectParams
+{
+public:
+	string m_fileName;
+	string m_textureFileName;
+
+	float m_emissionRate;		// Particles per second
+	int m_maxParticles;			// Budget for each emitter using this effect
+	float m_lifeTimeMin;
+	float m_lifeTimeMax;
+
+	vec3 m_positionSpread;
+	vec3 m_velocity;
+	vec3 m_velocitySpread;
+	vec3 m_gravity;
+
+	float m_startSize;
+	float m_endSize;
+	Colour m_startColour;
+	Colour m_endColour;
+};
+
+class ParticleEmitter
+{
+public:
+	bool m_used;
+	bool m_enabled;
+	int m_effectIndex;
+	int m_poolIndex;
+	void* m_pOwner;
+
+	vec3 m_position;
+	float m_emissionAccumulator;
+	unsigned int m_randomSeed;
+	int m_numAlive;
+};
+
+// All the particles sharing a texture
+class ParticlePool
+{
+public:
+	string m_textureFileName;
+	unsigned int m_textureId;
+	unsigned int m_streamBufferId;
+
+	int m_numParticles;
+	vector<float> m_vStreams[ParticleStream_NUM];
+	vector<int> m_vEmitterIds;
+
+	vector<float> m_vVertices;
+	int m_numVertices;
+};
+
+class ParticleManager
+{
+public:
+	/* Public methods */
+	ParticleManager(Renderer* pRenderer);
+	~ParticleManager();
+
+	// Clearing
+	void ClearParticles();
+	void ClearEmitters();
+
+	// Effects
+	int LoadEffect(const char* fileName);
+	int AddEffect(const ParticleEffectParams& params);
+	int GetNumEffects();
+
+	// Emitters
+	unsigned int CreateEmitter(int effectIndex, vec3 position, void* pOwner);
+	unsigned int CreateEmitter(const char* effectFileName, vec3 position, void* pOwner);
+	void DestroyEmitter(unsigned int emitterId);
+	void DestroyEmitters(void* pOwner);
+	void SetEmitterPosition(unsigned int emitterId, vec3 position);
+	void SetEmitterEnabled(unsigned int emitterId, bool enabled);
+	int GetNumEmitters();
+
+	// Seeding, emitters created after this get their random streams from the new seed
+	void SetRandomSeed(unsigned int seed);
+
+	// Accessors
+	int GetNumParticles();
+	int GetNumPools();
+	int GetNumDroppedParticles();
+
+	// Update
+	void Update(float dt);
+
+	// Rendering
+	void BuildVertices(vec3 cameraRight, vec3 cameraUp);
+	void Render();
+	int GetNumVertices();
+	const float* GetPoolVertices(int poolIndex, int* pNumVertices);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	ParticleManager(const ParticleManager&);
+	ParticleManager &operator=(const ParticleManager&);
+
+	int GetPool(const string& textureFileName);
+	void Emit(unsigned int emitterId, int numParticles);
+	void RemoveParticle(ParticlePool* pPool, int index);
+
+	float GetRandomValue(unsigned int* pSeed, float minValue, float maxValue);
+
+public:
+	/* Public members */
+	// Returned by CreateEmitter when the effect can't be found
+	static const unsigned int INVALID_EMITTER = 0xFFFFFFFF;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	Renderer* m_pRenderer;
+
+	vector<ParticleEffectParams> m_vEffects;
+	vector<ParticleEmitter> m_vEmitters;
+	vector<unsigned int> m_vFreeEmitters;
+	vector<ParticlePool*> m_vpPools;
+
+	unsigned int m_randomSeed;
+	unsigned int m_numEmittersCreated;
+	int m_numDroppedParticles;
+};
@@ -13,7 +13,12 @@
 
 #include "Player.h"
 #include "../utils/Random.h"
+#include "../Scripting/ScriptManager.h"
+#include "../Particles/ParticleManager.h"
+#include "../Renderer/lightclusters.h"
+#ifndef VOGUE_HEADLESS
 #include "../VogueGame.h"
+#endif //VOGUE_HEADLESS
 
 #include <fstream>
 #include <ostream>
@@ -24,16 +29,21 @@
 using namespace std;
 
 
-Player::Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
+Player::Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms)
 {
 	m_pRenderer = pRenderer;
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
+	m_pTransforms = pTransforms;
+
+	m_transformId = m_pTransforms->CreateNode();
+	m_worldMatrixValid = false;
 
 	m_forward = vec3(0.0f, 0.0f, 1.0f);
 	m_right = vec3(1.0f, 0.0f, 0.0f);
 	m_up = vec3(0.0f, 1.0f, 0.0f);
 
 	m_position = vec3(0.0f, 0.0f, 0.0f);
+	m_previousTickPosition = m_position;
 	m_gravityDirection = vec3(0.0f, -1.0f, 0.0f);
 
 	m_pHeadModel = NULL;
@@ -76,6 +86,7 @@ Player::Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
 	m_pVoxelCharacter->SetRandomLookDirection(false);
 	m_pVoxelCharacter->SetWireFrameRender(false);
 	m_pVoxelCharacter->SetCharacterScale(0.08f);
+	m_pVoxelCharacter->SetTickInterpolationEnabled(true);
 
 	// Body parts indices
 	m_headNum = 0;
@@ -102,25 +113,7 @@ Player::Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
 
 	m_lockSymetricalSides = true;
 
-	MAX_NUM_HEADS = 2;
-	MAX_NUM_HAIRS_MALE = 22;
-	MAX_NUM_HAIRS_FEMALE = 10;
-	MAX_NUM_FACIAL_HAIRS = 9;
-	MAX_NUM_NOSES = 8;
-	MAX_NUM_EARS = 6;
-	MAX_NUM_EYES = 7;
-	MAX_NUM_GLASSES = 5;
-	MAX_NUM_BODY_MALE = 2;
-	MAX_NUM_BODY_FEMALE = 1;
-	MAX_NUM_LEGS_MALE = 2;
-	MAX_NUM_LEGS_FEMALE = 1;
-	MAX_NUM_RIGHT_HAND = 1;
-	MAX_NUM_LEFT_HAND = 1;
-	MAX_NUM_RIGHT_SHOULDER = 2;
-	MAX_NUM_LEFT_SHOULDER = 2;
-	MAX_NUM_RIGHT_FOOT = 5;
-	MAX_NUM_LEFT_FOOT = 5;
-
+	LoadCharacterPresets();
 	LoadSkinColours();
 	LoadHairColours();
 	LoadEyesNames();
@@ -159,6 +152,8 @@ Player::Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
 
 Player::~Player()
 {
+	m_pTransforms->DestroyNode(m_transformId);
+
 	m_pVoxelCharacter->GetQubicleModel()->SetNullLinkage(m_pHeadModel);
 	m_pVoxelCharacter->GetQubicleModel()->SetNullLinkage(m_pHairModel);
 	m_pVoxelCharacter->GetQubicleModel()->SetNullLinkage(m_pFacialHairModel);
@@ -230,16 +225,50 @@ void Player::LoadHairColours()
 	}
 }
 
+void Player::LoadCharacterPresets()
+{
+	// The part counts and chances come from the character script, these defaults are used if it is missing
+	ScriptManager* pScriptManager = ScriptManager::GetInstance();
+	pScriptManager->LoadScript("media/scripts/characters.lua");
+
+	MAX_NUM_HEADS = pScriptManager->GetInt("CharacterParts", "heads", 2);
+	MAX_NUM_HAIRS_MALE = pScriptManager->GetInt("CharacterParts", "hairsMale", 22);
+	MAX_NUM_HAIRS_FEMALE = pScriptManager->GetInt("CharacterParts", "hairsFemale", 10);
+	MAX_NUM_FACIAL_HAIRS = pScriptManager->GetInt("CharacterParts", "facialHairs", 9);
+	MAX_NUM_NOSES = pScriptManager->GetInt("CharacterParts", "noses", 8);
+	MAX_NUM_EARS = pScriptManager->GetInt("CharacterParts", "ears", 6);
+	MAX_NUM_GLASSES = pScriptManager->GetInt("CharacterParts", "glasses", 5);
+	MAX_NUM_BODY_MALE = pScriptManager->GetInt("CharacterParts", "bodyMale", 2);
+	MAX_NUM_BODY_FEMALE = pScriptManager->GetInt("CharacterParts", "bodyFemale", 1);
+	MAX_NUM_LEGS_MALE = pScriptManager->GetInt("CharacterParts", "legsMale", 2);
+	MAX_NUM_LEGS_FEMALE = pScriptManager->GetInt("CharacterParts", "legsFemale", 1);
+	MAX_NUM_RIGHT_HAND = pScriptManager->GetInt("CharacterParts", "rightHand", 1);
+	MAX_NUM_LEFT_HAND = pScriptManager->GetInt("CharacterParts", "leftHand", 1);
+	MAX_NUM_RIGHT_SHOULDER = pScriptManager->GetInt("CharacterParts", "rightShoulder", 2);
+	MAX_NUM_LEFT_SHOULDER = pScriptManager->GetInt("CharacterParts", "leftShoulder", 2);
+	MAX_NUM_RIGHT_FOOT = pScriptManager->GetInt("CharacterParts", "rightFoot", 5);
+	MAX_NUM_LEFT_FOOT = pScriptManager->GetInt("CharacterParts", "leftFoot", 5);
+
+	m_chanceForFacialHair = pScriptManager->GetInt("CharacterRandomization", "facialHairChance", 40);
+	m_chanceForGlasses = pScriptManager->GetInt("CharacterRandomization", "glassesChance", 20);
+}
+
 void Player::LoadEyesNames()
 {
+	const char* defaultEyesNames[] = { "eyes_brown", "eyes_blue", "eyes_gray", "eyes_green", "eyes_orange", "eyes_purple", "eyes_red" };
+
+	ScriptManager* pScriptManager = ScriptManager::GetInstance();
+	MAX_NUM_EYES = pScriptManager->GetArrayLength("EyesNames");
+	if (MAX_NUM_EYES == 0)
+	{
+		MAX_NUM_EYES = 7;
+	}
+
 	m_pEyesNames = new string[MAX_NUM_EYES];
-	m_pEyesNames[0] = "eyes_brown";
-	m_pEyesNames[1] = "eyes_blue";
-	m_pEyesNames[2] = "eyes_gray";
-	m_pEyesNames[3] = "eyes_green";
-	m_pEyesNames[4] = "eyes_orange";
-	m_pEyesNames[5] = "eyes_purple";
-	m_pEyesNames[6] = "eyes_red";
+	for (int i = 0; i < MAX_NUM_EYES; i++)
+	{
+		m_pEyesNames[i] = pScriptManager->GetArrayString("EyesNames", i, (i < 7) ? defaultEyesNames[i] : defaultEyesNames[0]);
+	}
 }
 
 void Player::ModifyHead()
@@ -615,20 +644,22 @@ void Player::RandomizeParts(long seed)
 {
 	SeedRandomNumberGeneratorInt(seed);
 
+#ifdef VOGUE_HEADLESS
+	// No front-end GUI to pick the gender from when running headless
+	m_playerSex = (ePlayerSex)GetRandomNumber(0, ePlayerSex_Female);
+#else
 	m_playerSex = VogueGame::GetInstance()->GetVogueGUI()->GetPlayerSex();
-
-	int chanceForFacialHair = 40;
-	int chanceForGlasses = 20;
+#endif //VOGUE_HEADLESS
 
 	m_headNum = GetRandomNumber(0, MAX_NUM_HEADS-1);
 	m_hairNum = GetRandomNumber(0, (m_playerSex == ePlayerSex_Male) ? MAX_NUM_HAIRS_MALE-1 : MAX_NUM_HAIRS_FEMALE-1);
 	int randomHair = GetRandomNumber(2, MAX_NUM_FACIAL_HAIRS - 1);
-	m_facialHairNum = (GetRandomNumber(0, 100) >= chanceForFacialHair) ? 0 : randomHair;
+	m_facialHairNum = (GetRandomNumber(0, 100) >= m_chanceForFacialHair) ? 0 : randomHair;
 	m_noseNum = GetRandomNumber(0, MAX_NUM_NOSES-1);
 	m_earsNum = GetRandomNumber(0, MAX_NUM_EARS-1);
 	m_eyesNum = GetRandomNumber(0, MAX_NUM_EYES-1);
 	int randomGlasses = GetRandomNumber(2, MAX_NUM_GLASSES - 1);
-	m_glassesNum = (GetRandomNumber(0, 100) >= chanceForGlasses) ? 0 : randomGlasses;
+	m_glassesNum = (GetRandomNumber(0, 100) >= m_chanceForGlasses) ? 0 : randomGlasses;
 	m_bodyNum = GetRandomNumber(0, (m_playerSex == ePlayerSex_Male) ? MAX_NUM_BODY_MALE-1 : MAX_NUM_BODY_FEMALE-1);
 	m_legsNum = GetRandomNumber(0, (m_playerSex == ePlayerSex_Male) ? MAX_NUM_LEGS_MALE-1 : MAX_NUM_LEGS_FEMALE-1);
 	m_rightHandNum = GetRandomNumber(0, MAX_NUM_RIGHT_HAND-1);
@@ -876,8 +907,16 @@ vec3 Player::GetPosition()
 }
 
 // Rendering Helpers
-void Player::CalculateWorldTransformMatrix()
+void Player::CalculateWorldTransformMatrix(float interpolationAlpha)
 {
+	vec3 renderPosition = m_previousTickPosition + (m_position - m_previousTickPosition) * interpolationAlpha;
+
+	// Nothing to do if the player hasn't moved or turned since the matrix was last built
+	if (m_worldMatrixValid && renderPosition == m_worldMatrixPosition && m_forward == m_worldMatrixForward && m_up == m_worldMatrixUp)
+	{
+		return;
+	}
+
 	m_right = normalize(cross(m_up, m_forward));
 	m_forward = normalize(cross(m_right, m_up));
 
@@ -886,10 +925,21 @@ void Player::CalculateWorldTransformMatrix()
 		m_right.x, m_right.y, m_right.z, 0.0f,
 		m_up.x, m_up.y, m_up.z, 0.0f,
 		m_forward.x, m_forward.y, m_forward.z, 0.0f,
-		m_position.x, m_position.y, m_position.z, 1.0f
+		renderPosition.x, renderPosition.y, renderPosition.z, 1.0f
 	};
 
 	m_worldMatrix.SetValues(lMatrix);
+	m_pTransforms->SetLocalMatrix(m_transformId, m_worldMatrix);
+
+	m_worldMatrixValid = true;
+	m_worldMatrixPosition = renderPosition;
+	m_worldMatrixForward = m_forward;
+	m_worldMatrixUp = m_up;
+}
+
+void Player::InterpolatePose(float interpolationAlpha)
+{
+	m_pVoxelCharacter->InterpolateTickPose(interpolationAlpha);
 }
 
 // Rendering modes
@@ -901,30 +951,124 @@ void Player::SetWireFrameRender(bool wireframe)
 // Update
 void Player::Update(float dt)
 {
+	m_previousTickPosition = m_position;
+
 	// Update the voxel model
 	float animationSpeeds[AnimationSections_NUMSECTIONS] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
 	m_pVoxelCharacter->Update(dt, animationSpeeds);
 }
 
+void Player::UpdateWeaponParticleEffects(ParticleManager* pParticleManager)
+{
+	UpdateWeaponEmitters(m_pVoxelCharacter->GetRightWeapon(), m_pVoxelCharacter->IsRightWeaponLoaded(), pParticleManager);
+	UpdateWeaponEmitters(m_pVoxelCharacter->GetLeftWeapon(), m_pVoxelCharacter->IsLeftWeaponLoaded(), pParticleManager);
+}
+
+void Player::UpdateWeaponEmitters(VoxelWeapon* pWeapon, bool weaponLoaded, ParticleManager* pParticleManager)
+{
+	if (pWeapon == NULL)
+	{
+		return;
+	}
+
+	if (weaponLoaded == false || pWeapon->GetNumParticleEffects() == 0)
+	{
+		pParticleManager->DestroyEmitters(pWeapon);
+		return;
+	}
+
+	for (int i = 0; i < pWeapon->GetNumParticleEffects(); i++)
+	{
+		unsigned int particleEffectId;
+		vec3 particleEffectPosition;
+		string effectName;
+		bool connectedToSegment;
+		pWeapon->GetParticleEffectParams(i, &particleEffectId, &particleEffectPosition, &effectName, &connectedToSegment);
+
+		// Effects on an animated section already have their world position, the others are relative to us
+		if (connectedToSegment == false)
+		{
+			particleEffectPosition = m_worldMatrix * particleEffectPosition;
+		}
+
+		if (particleEffectId == ParticleManager::INVALID_EMITTER)
+		{
+			// A newly loaded weapon, drop anything left over from what it held before
+			if (i == 0)
+			{
+				pParticleManager->DestroyEmitters(pWeapon);
+			}
+
+			particleEffectId = pParticleManager->CreateEmitter(effectName.c_str(), particleEffectPosition, pWeapon);
+			pWeapon->SetParticleEffectId(i, particleEffectId);
+		}
+		else
+		{
+			pParticleManager->SetEmitterPosition(particleEffectId, particleEffectPosition);
+		}
+	}
+}
+
+// Lighting
+void Player::AddWeaponLights(LightClusters* pLightClusters)
+{
+	if (m_pVoxelCharacter->IsRightWeaponLoaded())
+	{
+		AddWeaponLights(m_pVoxelCharacter->GetRightWeapon(), pLightClusters);
+	}
+
+	if (m_pVoxelCharacter->IsLeftWeaponLoaded())
+	{
+		AddWeaponLights(m_pVoxelCharacter->GetLeftWeapon(), pLightClusters);
+	}
+}
+
+void Player::AddWeaponLights(VoxelWeapon* pWeapon, LightClusters* pLightClusters)
+{
+	if (pWeapon == NULL)
+	{
+		return;
+	}
+
+	for (int i = 0; i < pWeapon->GetNumLights(); i++)
+	{
+		unsigned int lightId;
+		vec3 lightPosition;
+		float lightRadius;
+		float lightDiffuseMultiplier;
+		Colour lightColour;
+		bool connectedToSegment;
+		pWeapon->GetLightParams(i, &lightId, &lightPosition, &lightRadius, &lightDiffuseMultiplier, &lightColour, &connectedToSegment);
+
+		// Lights on an animated section already have their world position, the others are relative to us
+		if (connectedToSegment == false)
+		{
+			lightPosition = m_worldMatrix * lightPosition;
+		}
+
+		pLightClusters->AddLight(lightPosition, lightRadius, lightColour, lightDiffuseMultiplier);
+	}
+}
+
 // Render
 void Player::Render()
 {
 	Colour OulineColour(1.0f, 1.0f, 0.0f, 1.0f);
 
 	m_pRenderer->PushMatrix();
-		m_pRenderer->MultiplyWorldMatrix(m_worldMatrix);
+		m_pRenderer->MultiplyWorldMatrix(m_pTransforms->GetWorldMatrix(m_transformId));
 
 		m_pVoxelCharacter->Render(false, false, false, OulineColour, false);
 		m_pVoxelCharacter->RenderWeapons(false, false, false, OulineColour);
 	m_pRenderer->PopMatrix();
 }
 
-void Player::RenderFace()
+void Player::RenderFace(FaceQuadBatch* pFaceQuadBatch)
 {
 	m_pRenderer->PushMatrix();
-		m_pRenderer->MultiplyWorldMatrix(m_worldMatrix);
+		m_pRenderer->MultiplyWorldMatrix(m_pTransforms->GetWorldMatrix(m_transformId));
 
-		m_pVoxelCharacter->RenderFace();
+		m_pVoxelCharacter->RenderFace(pFaceQuadBatch);
 	m_pRenderer->PopMatrix();
 }
 
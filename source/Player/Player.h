@@ -14,9 +14,14 @@
 #pragma once
 
 #include "../Maths/3dmaths.h"
+#include "../Maths/TransformHierarchy.h"
 #include "../Renderer/Renderer.h"
 #include "../models/modelloader.h"
 
+class ParticleManager;
+class FaceQuadBatch;
+class LightClusters;
+
 
 enum eColourModifiers
 {
@@ -36,11 +41,12 @@ class Player
 {
 public:
 	/* Public methods */
-	Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager);
+	Player(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms);
 	~Player();
 
 	void LoadSkinColours();
 	void LoadHairColours();
+	void LoadCharacterPresets();
 	void LoadEyesNames();
 
 	void ModifyHead();
@@ -88,17 +94,22 @@ public:
 	vec3 GetPosition();
 
 	// Rendering Helpers
-	void CalculateWorldTransformMatrix();
+	void CalculateWorldTransformMatrix(float interpolationAlpha);
+	void InterpolatePose(float interpolationAlpha);
 
 	// Rendering modes
 	void SetWireFrameRender(bool wireframe);
 
 	// Update
 	void Update(float dt);
+	void UpdateWeaponParticleEffects(ParticleManager* pParticleManager);
+
+	// Lighting
+	void AddWeaponLights(LightClusters* pLightClusters);
 
 	// Render
     void Render();
-	void RenderFace();
+	void RenderFace(FaceQuadBatch* pFaceQuadBatch);
 	void RenderDebug();
 
 protected:
@@ -106,6 +117,8 @@ protected:
 
 private:
 	/* Private methods */
+	void UpdateWeaponEmitters(VoxelWeapon* pWeapon, bool weaponLoaded, ParticleManager* pParticleManager);
+	void AddWeaponLights(VoxelWeapon* pWeapon, LightClusters* pLightClusters);
 
 public:
 	/* Public members */
@@ -117,6 +130,7 @@ private:
 	/* Private members */
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
+	TransformHierarchy* m_pTransforms;
 
 	// Player position and movement variables
 	vec3 m_position;
@@ -127,6 +141,9 @@ private:
 	// Used for collision and other movement calculations
 	vec3 m_previousPosition;
 
+	// Position at the start of the last simulation tick, used to interpolate rendering between ticks
+	vec3 m_previousTickPosition;
+
 	// The direction of gravity for the player
 	vec3 m_gravityDirection;
 
@@ -138,6 +155,13 @@ private:
 	// Players world matrix
 	Matrix4x4 m_worldMatrix;
 
+	// Transform node for the player, only updated when the player has moved or turned
+	int m_transformId;
+	bool m_worldMatrixValid;
+	vec3 m_worldMatrixPosition;
+	vec3 m_worldMatrixForward;
+	vec3 m_worldMatrixUp;
+
 	// Body parts indices
 	int m_headNum;
 	int m_hairNum;
@@ -179,6 +203,10 @@ private:
 	int MAX_NUM_SKIN_COLOURS;
 	int MAX_NUM_HAIR_COLOURS;
 
+	// Randomization chances, as percentages
+	int m_chanceForFacialHair;
+	int m_chanceForGlasses;
+
 	// Colours
 	Colour* m_pSkinColours;
 	Colour* m_pHair1Colours;
@@ -47,6 +47,12 @@ Renderer::Renderer(int width, int height, int depthBits, int stencilBits)
 	m_clipNear = 0.1f;
 	m_clipFar = 10000.0f;
 
+#ifdef VOGUE_HEADLESS
+	// Headless builds have no GL context, only keep the CPU side state
+	m_depth = (depthBits > 0);
+	m_stencil = (stencilBits > 0);
+	m_Quadratic = NULL;
+#else
 	// Is depth buffer needed?
 	if (depthBits > 0)
 	{
@@ -76,6 +82,7 @@ Renderer::Renderer(int width, int height, int depthBits, int stencilBits)
 	m_Quadratic = gluNewQuadric();
 	gluQuadricNormals(m_Quadratic, GLU_SMOOTH);
 	gluQuadricTexture(m_Quadratic, GL_TRUE);
+#endif //VOGUE_HEADLESS
 
 	// Initialize defaults
 	m_cullMode = CM_NOCULL;
@@ -85,6 +92,21 @@ Renderer::Renderer(int width, int height, int depthBits, int stencilBits)
 	// Rendered information
 	m_numRenderedVertices = 0;
 	m_numRenderedFaces = 0;
+	m_numDrawCalls = 0;
+
+	// Draw list
+	m_recordingDrawList = false;
+	m_activeShader = -1;
+
+	// Depth only rendering
+	m_depthOnlyRender = false;
+
+	// Full screen passes
+	m_fullScreenTriangleBuffer = 0;
+
+	// Texture streaming
+	m_textureStreamingBudget = 1024 * 1024;
+	m_placeholderTexture = 0;
 
 	InitOpenGLExtensions();
 }
@@ -94,14 +116,7 @@ Renderer::~Renderer()
 	unsigned int i;
 
 	// Delete the vertex arrays
-	m_vertexArraysMutex.lock();
-	for (i = 0; i < m_vertexArrays.size(); i++)
-	{
-		delete m_vertexArrays[i];
-		m_vertexArrays[i] = 0;
-	}
-	m_vertexArrays.clear();
-	m_vertexArraysMutex.unlock();
+	m_vertexArrays.Clear();
 
 	// Delete the viewports
 	for (i = 0; i < m_viewports.size(); i++)
@@ -120,20 +135,22 @@ Renderer::~Renderer()
 	m_frustums.clear();
 
 	// Delete the materials
-	for (i = 0; i < m_materials.size(); i++)
-	{
-		delete m_materials[i];
-		m_materials[i] = 0;
-	}
-	m_materials.clear();
+	m_materials.Clear();
+
+	// Stop streaming before the textures it refers to are deleted
+	m_textureStreamer.Stop();
+	m_vTextureStreamCallbacks.clear();
 
 	// Delete the textures
-	for (i = 0; i < m_textures.size(); i++)
+	m_textures.Clear();
+	m_textureFileNames.clear();
+
+	// Delete the texture atlases
+	for (map<unsigned int, TextureAtlas*>::iterator atlas = m_textureAtlases.begin(); atlas != m_textureAtlases.end(); ++atlas)
 	{
-		delete m_textures[i];
-		m_textures[i] = 0;
+		delete atlas->second;
 	}
-	m_textures.clear();
+	m_textureAtlases.clear();
 
 	// Delete the lights
 	for (i = 0; i < m_lights.size(); i++)
@@ -144,12 +161,16 @@ Renderer::~Renderer()
 	m_lights.clear();
 
 	// Delete the FreeType fonts
+#ifdef VOGUE_HEADLESS
+	m_vHeadlessFontSizes.clear();
+#else
 	for (i = 0; i < m_freetypeFonts.size(); i++)
 	{
 		delete m_freetypeFonts[i];
 		m_freetypeFonts[i] = 0;
 	}
 	m_freetypeFonts.clear();
+#endif //VOGUE_HEADLESS
 
 	// Delete the frame buffers
 	for (i = 0; i < m_vFrameBuffers.size(); i++)
@@ -159,6 +180,42 @@ Renderer::~Renderer()
 	}
 	m_vFrameBuffers.clear();
 
+	if (m_fullScreenTriangleBuffer != 0)
+	{
+		glDeleteBuffers(1, &m_fullScreenTriangleBuffer);
+	}
+
+	// Delete the streamed vertex buffers
+#ifndef VOGUE_HEADLESS
+	if (m_vStreamBuffers.empty() == false)
+	{
+		glDeleteBuffers((GLsizei)m_vStreamBuffers.size(), &m_vStreamBuffers[0]);
+	}
+#endif //VOGUE_HEADLESS
+	m_vStreamBuffers.clear();
+
+	// Delete the GPU timers
+	for (i = 0; i < m_vpGPUTimers.size(); i++)
+	{
+		glDeleteQueries(2, m_vpGPUTimers[i]->m_queries);
+		delete m_vpGPUTimers[i];
+		m_vpGPUTimers[i] = 0;
+	}
+	m_vpGPUTimers.clear();
+
+	// Delete the texture buffers
+	for (i = 0; i < m_vpTextureBuffers.size(); i++)
+	{
+		if (m_vpTextureBuffers[i]->m_buffer != 0)
+		{
+			glDeleteTextures(1, &m_vpTextureBuffers[i]->m_texture);
+			glDeleteBuffers(1, &m_vpTextureBuffers[i]->m_buffer);
+		}
+		delete m_vpTextureBuffers[i];
+		m_vpTextureBuffers[i] = 0;
+	}
+	m_vpTextureBuffers.clear();
+
 	// Delete the shaders
 	for (i = 0; i < m_shaders.size(); i++)
 	{
@@ -168,7 +225,10 @@ Renderer::~Renderer()
 	m_shaders.clear();
 
 	// Delete the quadratic drawer
-	gluDeleteQuadric(m_Quadratic);
+	if (m_Quadratic != NULL)
+	{
+		gluDeleteQuadric(m_Quadratic);
+	}
 }
 
 // Resize
@@ -310,37 +370,54 @@ int Renderer::GetActiveViewPort()
 	return m_activeViewport;
 }
 
+float Renderer::GetViewportFov(unsigned int viewportid)
+{
+	return m_viewports[viewportid]->Fov;
+}
+
+float Renderer::GetClipNear()
+{
+	return m_clipNear;
+}
+
+float Renderer::GetClipFar()
+{
+	return m_clipFar;
+}
+
 // Render modes
 void Renderer::SetRenderMode(RenderMode mode)
 {
 	switch (mode)
 	{
 	case RM_WIREFRAME:
-		glDisable(GL_TEXTURE_2D);
+		DisableTexture();
 		glDisable(GL_LIGHTING);
 		glPolygonMode(GL_FRONT, GL_LINE);
 		glPolygonMode(GL_BACK, GL_LINE);
 		break;
 	case RM_SOLID:
-		glDisable(GL_TEXTURE_2D);
+		DisableTexture();
 		glDisable(GL_LIGHTING);
 		glPolygonMode(GL_FRONT, GL_FILL);
 		glPolygonMode(GL_BACK, GL_FILL);
 		break;
 	case RM_SHADED:
-		glDisable(GL_TEXTURE_2D);
+		DisableTexture();
 		glEnable(GL_LIGHTING);
 		glPolygonMode(GL_FRONT, GL_FILL);
 		glPolygonMode(GL_BACK, GL_FILL);
 		break;
 	case RM_TEXTURED:
-		glEnable(GL_TEXTURE_2D);
+		if (m_stateCache.SetTexture2D(true))
+			glEnable(GL_TEXTURE_2D);
 		glDisable(GL_LIGHTING);
 		glPolygonMode(GL_FRONT, GL_FILL);
 		glPolygonMode(GL_BACK, GL_FILL);
 		break;
 	case RM_TEXTURED_LIGHTING:
-		glEnable(GL_TEXTURE_2D);
+		if (m_stateCache.SetTexture2D(true))
+			glEnable(GL_TEXTURE_2D);
 		glEnable(GL_LIGHTING);
 		glPolygonMode(GL_FRONT, GL_FILL);
 		glPolygonMode(GL_BACK, GL_FILL);
@@ -380,6 +457,11 @@ void Renderer::SetCullMode(CullMode mode)
 {
 	m_cullMode = mode;
 
+	if (m_stateCache.SetCullMode(mode) == false)
+	{
+		return;
+	}
+
 	switch (mode)
 	{
 	case CM_NOCULL:
@@ -494,6 +576,9 @@ bool Renderer::BeginScene(bool pixel, bool depth, bool stencil)
 	// Reset the renderer stat counters
 	ResetRenderedStats();
 
+	// Publish resources queued by loader threads and free the ones retired last frame
+	UpdateResourceRegistries();
+
 	// Reset the projection and modelview matrices to be identity
 	glMatrixMode(GL_PROJECTION);
 	glLoadIdentity();
@@ -502,9 +587,13 @@ bool Renderer::BeginScene(bool pixel, bool depth, bool stencil)
 
 	IdentityWorldMatrix();
 
+	// Whatever drove GL directly last frame has left the state unknown
+	m_stateCache.Invalidate();
+
 	// Start off with lighting and texturing disabled. If these are required, they need to be set explicitly
 	glDisable(GL_LIGHTING);
-	glDisable(GL_TEXTURE_2D);
+	SetActiveTextureUnit(0);
+	DisableTexture();
 
 	return true;
 }
@@ -653,7 +742,7 @@ void Renderer::SetTextureMatrix()
 
 
 	glMatrixMode(GL_TEXTURE);
-	glActiveTextureARB(GL_TEXTURE7);
+	SetActiveTextureUnit(7);
 
 	glLoadIdentity();
 	glLoadMatrixd(bias);
@@ -669,7 +758,7 @@ void Renderer::SetTextureMatrix()
 void Renderer::PushTextureMatrix()
 {
 	glMatrixMode(GL_TEXTURE);
-	glActiveTextureARB(GL_TEXTURE7);
+	SetActiveTextureUnit(7);
 	glPushMatrix();
 }
 
@@ -679,6 +768,46 @@ void Renderer::PopTextureMatrix()
 	glMatrixMode(GL_MODELVIEW);
 }
 
+// Cached transforms
+void Renderer::BeginCachedTransforms()
+{
+	PushMatrix();
+
+	// Read back once, every cached draw is then a single load on top of these
+	glGetFloatv(GL_MODELVIEW_MATRIX, m_cachedTransformView);
+
+	glMatrixMode(GL_TEXTURE);
+	SetActiveTextureUnit(7);
+	glPushMatrix();
+	glGetFloatv(GL_TEXTURE_MATRIX, m_cachedTransformTexture);
+	glMatrixMode(GL_MODELVIEW);
+}
+
+void Renderer::LoadCachedTransform(const Matrix4x4 &worldMatrix)
+{
+	// The shadow texture coordinates follow the model the same way the stack path does in PushTextureMatrix()
+	glMatrixMode(GL_TEXTURE);
+	SetActiveTextureUnit(7);
+	glLoadMatrixf(m_cachedTransformTexture);
+	glMultMatrixf(worldMatrix.m);
+	glMatrixMode(GL_MODELVIEW);
+
+	glLoadMatrixf(m_cachedTransformView);
+	glMultMatrixf(worldMatrix.m);
+
+	m_model = worldMatrix;
+}
+
+void Renderer::EndCachedTransforms()
+{
+	glMatrixMode(GL_TEXTURE);
+	SetActiveTextureUnit(7);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+
+	PopMatrix();
+}
+
 // Scissor testing
 void Renderer::EnableScissorTest(int x, int y, int width, int height)
 {
@@ -755,13 +884,22 @@ void Renderer::SetLookAtCamera(vec3 pos, vec3 target, vec3 up)
 void Renderer::EnableTransparency(BlendFunction source, BlendFunction destination)
 {
 	//glDisable(GL_DEPTH_WRITEMASK);
-	glEnable(GL_BLEND);
-	glBlendFunc(GetBlendEnum(source), GetBlendEnum(destination));
+	if (m_stateCache.SetBlend(true))
+	{
+		glEnable(GL_BLEND);
+	}
+	if (m_stateCache.SetBlendFunction(source, destination))
+	{
+		glBlendFunc(GetBlendEnum(source), GetBlendEnum(destination));
+	}
 }
 
 void Renderer::DisableTransparency()
 {
-	glDisable(GL_BLEND);
+	if (m_stateCache.SetBlend(false))
+	{
+		glDisable(GL_BLEND);
+	}
 	//glEnable(GL_DEPTH_WRITEMASK);
 }
 
@@ -812,14 +950,23 @@ void Renderer::DisableVectorNormalize()
 // Depth testing
 void Renderer::EnableDepthTest(DepthTest lTestFunction)
 {
-	glEnable(GL_DEPTH_TEST);
+	if (m_stateCache.SetDepthTest(true))
+	{
+		glEnable(GL_DEPTH_TEST);
+	}
 
-	glDepthFunc(GetDepthTest(lTestFunction));
+	if (m_stateCache.SetDepthFunction(lTestFunction))
+	{
+		glDepthFunc(GetDepthTest(lTestFunction));
+	}
 }
 
 void Renderer::DisableDepthTest()
 {
-	glDisable(GL_DEPTH_TEST);
+	if (m_stateCache.SetDepthTest(false))
+	{
+		glDisable(GL_DEPTH_TEST);
+	}
 }
 
 GLenum Renderer::GetDepthTest(DepthTest lTest)
@@ -858,23 +1005,34 @@ GLenum Renderer::GetDepthTest(DepthTest lTest)
 
 void Renderer::EnableDepthWrite()
 {
-	glDepthMask(GL_TRUE);
+	if (m_stateCache.SetDepthWrite(true))
+	{
+		glDepthMask(GL_TRUE);
+	}
 }
 
 void Renderer::DisableDepthWrite()
 {
-	glDepthMask(GL_FALSE);
+	if (m_stateCache.SetDepthWrite(false))
+	{
+		glDepthMask(GL_FALSE);
+	}
 }
 
 // Colour material
 void Renderer::EnableColourMaterial()
 {
 	glEnable(GL_COLOR_MATERIAL);
+
+	// The vertex colours write over the applied material
+	m_stateCache.InvalidateMaterial();
 }
 
 void Renderer::DisableColourMaterial()
 {
 	glDisable(GL_COLOR_MATERIAL);
+
+	m_stateCache.InvalidateMaterial();
 }
 
 // Immediate mode
@@ -1045,6 +1203,10 @@ void Renderer::DrawSphericalSector(float lRadius, float angle, int lSectors, int
 // Text rendering
 bool Renderer::CreateFreeTypeFont(const char *fontName, int fontSize, unsigned int *pID, bool noAutoHint)
 {
+#ifdef VOGUE_HEADLESS
+	m_vHeadlessFontSizes.push_back(fontSize);
+	*pID = (unsigned int)m_vHeadlessFontSizes.size() - 1;
+#else
 	FreeTypeFont* font = new FreeTypeFont();
 
 	// Build the new freetype font
@@ -1054,6 +1216,9 @@ bool Renderer::CreateFreeTypeFont(const char *fontName, int fontSize, unsigned i
 	m_freetypeFonts.push_back(font);
 	*pID = (unsigned int)m_freetypeFonts.size() - 1;
 
+	m_stateCache.InvalidateTextures();
+#endif //VOGUE_HEADLESS
+
 	return true;
 }
 
@@ -1070,6 +1235,9 @@ bool Renderer::RenderFreeTypeText(unsigned int fontID, float x, float y, float z
 		vsprintf(outText, inText, ap);
 	va_end(ap);
 
+#ifdef VOGUE_HEADLESS
+	return false;
+#else
 	glColor4fv(colour.GetRGBA());
 
 	// Add on the descent value, so we don't draw letters with underhang out of bounds. (e.g - g, y, q and p)
@@ -1083,9 +1251,13 @@ bool Renderer::RenderFreeTypeText(unsigned int fontID, float x, float y, float z
 		m_freetypeFonts[fontID]->DrawString(outText, scale);
 	glPopMatrix();
 
+	// The font binds its glyph textures and sets its own blending
+	m_stateCache.Invalidate();
+
 	glColor4f(1.0f, 1.0f, 1.0f, 1.0f);
 
 	return true;
+#endif //VOGUE_HEADLESS
 }
 
 int Renderer::GetFreeTypeTextWidth(unsigned int fontID, const char *inText, ...)
@@ -1101,22 +1273,38 @@ int Renderer::GetFreeTypeTextWidth(unsigned int fontID, const char *inText, ...)
 		vsprintf(outText, inText, ap);
 	va_end(ap);
 
+#ifdef VOGUE_HEADLESS
+	return (int)strlen(outText) * m_vHeadlessFontSizes[fontID] / 2;
+#else
 	return m_freetypeFonts[fontID]->GetTextWidth(outText);
+#endif //VOGUE_HEADLESS
 }
 
 int Renderer::GetFreeTypeTextHeight(unsigned int fontID, const char *inText, ...)
 {
+#ifdef VOGUE_HEADLESS
+	return m_vHeadlessFontSizes[fontID];
+#else
 	return m_freetypeFonts[fontID]->GetCharHeight('a');
+#endif //VOGUE_HEADLESS
 }
 
 int Renderer::GetFreeTypeTextAscent(unsigned int fontID)
 {
+#ifdef VOGUE_HEADLESS
+	return m_vHeadlessFontSizes[fontID] * 3 / 4;
+#else
 	return m_freetypeFonts[fontID]->GetAscent();
+#endif //VOGUE_HEADLESS
 }
 
 int Renderer::GetFreeTypeTextDescent(unsigned int fontID)
 {
+#ifdef VOGUE_HEADLESS
+	return -(m_vHeadlessFontSizes[fontID] / 4);
+#else
 	return m_freetypeFonts[fontID]->GetDescent();
+#endif //VOGUE_HEADLESS
 }
 
 // Lighting
@@ -1247,18 +1435,19 @@ bool Renderer::CreateMaterial(const Colour &ambient, const Colour &diffuse, cons
 	pMaterial->Emission(emmisive);
 	pMaterial->Shininess(specularPower);
 
-	// Push the material onto the list
-	m_materials.push_back(pMaterial);
-
-	// Return the material id
-	*pID = (int)m_materials.size() - 1;
+	// Add the material to the registry and return its handle
+	*pID = m_materials.Insert(pMaterial);
 
-	return true;
+	return *pID != ResourceRegistry<Material>::INVALID_HANDLE;
 }
 
 bool Renderer::EditMaterial(unsigned int id, const Colour &ambient, const Colour &diffuse, const Colour &specular, const Colour &emmisive, float specularPower)
 {
-	Material *pMaterial = m_materials[id];
+	Material *pMaterial = m_materials.Get(id);
+	if (pMaterial == NULL)
+	{
+		return false;
+	}
 
 	pMaterial->Ambient(ambient);
 	pMaterial->Diffuse(diffuse);
@@ -1266,36 +1455,46 @@ bool Renderer::EditMaterial(unsigned int id, const Colour &ambient, const Colour
 	pMaterial->Emission(emmisive);
 	pMaterial->Shininess(specularPower);
 
+	// The material might be the applied one, so apply it again next time
+	m_stateCache.InvalidateMaterial();
+
 	return true;
 }
 
 void Renderer::EnableMaterial(unsigned int id)
 {
-	m_materials[id]->Apply();
+	Material *pMaterial = m_materials.Get(id);
+	if (pMaterial != NULL)
+	{
+		if (m_stateCache.SetMaterial(id))
+		{
+			pMaterial->Apply();
+		}
+	}
 }
 
 void Renderer::DeleteMaterial(unsigned int id)
 {
-	if (m_materials[id])
-	{
-		delete m_materials[id];
-		m_materials[id] = 0;
-	}
+	m_materials.Remove(id);
+
+	m_stateCache.InvalidateMaterial();
 }
 
 // Textures
 bool Renderer::LoadTexture(string fileName, int *width, int *height, int *width_power2, int *height_power2, unsigned int *pID)
 {
 	// Check that this texture hasn't already been loaded
-	for (unsigned int i = 0; i < m_textures.size(); i++)
+	map<string, unsigned int>::iterator textureFile = m_textureFileNames.find(fileName);
+	if (textureFile != m_textureFileNames.end())
 	{
-		if (m_textures[i]->GetFileName() == fileName)
+		Texture *pLoadedTexture = m_textures.Get(textureFile->second);
+		if (pLoadedTexture != NULL)
 		{
-			*width = m_textures[i]->GetWidth();
-			*height = m_textures[i]->GetHeight();
-			*width_power2 = m_textures[i]->GetWidthPower2();
-			*height_power2 = m_textures[i]->GetHeightPower2();
-			*pID = i;
+			*width = pLoadedTexture->GetWidth();
+			*height = pLoadedTexture->GetHeight();
+			*width_power2 = pLoadedTexture->GetWidthPower2();
+			*height_power2 = pLoadedTexture->GetHeightPower2();
+			*pID = textureFile->second;
 
 			return true;
 		}
@@ -1304,37 +1503,43 @@ bool Renderer::LoadTexture(string fileName, int *width, int *height, int *width_
 	// Texture hasn't already been loaded, create and load it!
 	Texture *pTexture = new Texture();
 	pTexture->Load(fileName, width, height, width_power2, height_power2, false);
+	m_stateCache.InvalidateTextures();
 
-	// Push the vertex array onto the list
-	m_textures.push_back(pTexture);
-
-	// Return the vertex array id
-	*pID = (int)m_textures.size() - 1;
+	// Add the texture to the registry and return its handle
+	*pID = m_textures.Insert(pTexture);
+	if (*pID == ResourceRegistry<Texture>::INVALID_HANDLE)
+	{
+		return false;
+	}
+	m_textureFileNames[fileName] = *pID;
 
 	return true;
 }
 
 bool Renderer::RefreshTexture(unsigned int id)
 {
-	Texture *pTexture = m_textures[id];
+	Texture *pTexture = m_textures.Get(id);
+	if (pTexture == NULL)
+	{
+		return false;
+	}
 
 	int width;
 	int height;
 	int width_power2;
 	int height_power2;
 	pTexture->Load(pTexture->GetFileName(), &width, &height, &width_power2, &height_power2, true);
+	m_stateCache.InvalidateTextures();
 
 	return true;
 }
 
 bool Renderer::RefreshTexture(string filename)
 {
-	for (unsigned int i = 0; i < m_textures.size(); i++)
+	map<string, unsigned int>::iterator textureFile = m_textureFileNames.find(filename);
+	if (textureFile != m_textureFileNames.end())
 	{
-		if (m_textures[i]->GetFileName() == filename)
-		{
-			return RefreshTexture(i);
-		}
+		return RefreshTexture(textureFile->second);
 	}
 
 	return false;
@@ -1342,37 +1547,69 @@ bool Renderer::RefreshTexture(string filename)
 
 void Renderer::BindTexture(unsigned int id)
 {
-	glEnable(GL_TEXTURE_2D);
-	m_textures[id]->Bind();
+	Texture *pTexture = m_textures.Get(id);
+	if (pTexture == NULL)
+	{
+		return;
+	}
+
+	if (m_stateCache.SetTexture2D(true))
+	{
+		glEnable(GL_TEXTURE_2D);
+	}
+	if (m_stateCache.SetTexture(pTexture->GetId()))
+	{
+		pTexture->Bind();
+	}
 }
 
 void Renderer::PrepareShaderTexture(unsigned int textureIndex, unsigned int textureId)
 {
-	glActiveTextureARB(GL_TEXTURE0_ARB + textureIndex);
+	SetActiveTextureUnit(textureIndex);
 	glUniform1iARB(textureId, textureIndex);
 }
 
 void Renderer::EmptyTextureIndex(unsigned int textureIndex)
 {
-	glActiveTextureARB(GL_TEXTURE0_ARB + textureIndex);
-	glDisable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, textureIndex);
+	SetActiveTextureUnit(textureIndex);
+	DisableTexture();
+	if (m_stateCache.SetTexture(textureIndex))
+	{
+		glBindTexture(GL_TEXTURE_2D, textureIndex);
+	}
 }
 
 void Renderer::DisableTexture()
 {
-	glDisable(GL_TEXTURE_2D);
+	if (m_stateCache.SetTexture2D(false))
+	{
+		glDisable(GL_TEXTURE_2D);
+	}
+}
+
+void Renderer::SetActiveTextureUnit(unsigned int textureIndex)
+{
+	if (m_stateCache.SetActiveTextureUnit(textureIndex))
+	{
+		glActiveTextureARB(GL_TEXTURE0_ARB + textureIndex);
+	}
 }
 
 Texture* Renderer::GetTexture(unsigned int id)
 {
-	return m_textures[id];
+	return m_textures.Get(id);
 }
 
 void Renderer::BindRawTextureId(unsigned int textureId)
 {
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, textureId);
+	if (m_stateCache.SetTexture2D(true))
+	{
+		glEnable(GL_TEXTURE_2D);
+	}
+	if (m_stateCache.SetTexture(textureId))
+	{
+		glBindTexture(GL_TEXTURE_2D, textureId);
+	}
 }
 
 void Renderer::GenerateEmptyTexture(unsigned int *pID)
@@ -1380,21 +1617,261 @@ void Renderer::GenerateEmptyTexture(unsigned int *pID)
 	Texture *pTexture = new Texture();
 	pTexture->GenerateEmptyTexture();
 
-	// Push the vertex array onto the list
-	m_textures.push_back(pTexture);
-
-	// Return the vertex array id
-	*pID = (int)m_textures.size() - 1;
+	// Add the texture to the registry and return its handle
+	*pID = m_textures.Insert(pTexture);
 }
 
 void Renderer::SetTextureData(unsigned int id, int width, int height, unsigned char *texdata)
 {
-	glEnable(GL_TEXTURE_2D);
-	glBindTexture(GL_TEXTURE_2D, m_textures[id]->GetId());
+	Texture *pTexture = m_textures.Get(id);
+	if (pTexture == NULL)
+	{
+		return;
+	}
+
+	BindRawTextureId(pTexture->GetId());
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, texdata);
-	glDisable(GL_TEXTURE_2D);
+	DisableTexture();
+}
+
+// Texture streaming
+bool Renderer::RequestTexture(string fileName, TextureStreamedCallback callback, void *pData, unsigned int *pID)
+{
+	// Already loaded or already streaming, share the existing texture
+	map<string, unsigned int>::iterator textureFile = m_textureFileNames.find(fileName);
+	if (textureFile != m_textureFileNames.end() && m_textures.IsValid(textureFile->second))
+	{
+		*pID = textureFile->second;
+	}
+	else
+	{
+		Texture *pTexture = new Texture();
+		pTexture->SetPlaceholder(fileName, GetPlaceholderTexture());
+
+		*pID = m_textures.Insert(pTexture);
+		if (*pID == ResourceRegistry<Texture>::INVALID_HANDLE)
+		{
+			return false;
+		}
+		m_textureFileNames[fileName] = *pID;
+
+		StartTextureStreaming();
+		m_textureStreamer.QueueRequest(*pID, fileName, Texture::GetImageFlags());
+	}
+
+	// Callbacks are always made from UpdateTextureStreaming(), even for textures that are already loaded
+	if (callback != NULL)
+	{
+		TextureStreamCallback streamCallback;
+		streamCallback.m_textureId = *pID;
+		streamCallback.m_callback = callback;
+		streamCallback.m_pData = pData;
+		m_vTextureStreamCallbacks.push_back(streamCallback);
+	}
+
+	return true;
+}
+
+void Renderer::CancelTextureCallbacks(void *pData)
+{
+	for (unsigned int i = 0; i < m_vTextureStreamCallbacks.size();)
+	{
+		if (m_vTextureStreamCallbacks[i].m_pData == pData)
+		{
+			m_vTextureStreamCallbacks.erase(m_vTextureStreamCallbacks.begin() + i);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+bool Renderer::IsTextureStreaming(unsigned int id)
+{
+	Texture *pTexture = m_textures.Get(id);
+	if (pTexture == NULL)
+	{
+		return false;
+	}
+
+	return pTexture->IsStreaming();
+}
+
+int Renderer::GetNumStreamingTextures()
+{
+	return m_textureStreamer.GetNumOutstanding();
+}
+
+void Renderer::SetTextureStreamingBudget(int bytesPerFrame)
+{
+	m_textureStreamingBudget = bytesPerFrame;
+}
+
+int Renderer::GetTextureStreamingBudget()
+{
+	return m_textureStreamingBudget;
+}
+
+void Renderer::UpdateTextureStreaming()
+{
+	// Upload decoded textures until the budget is used up, at least one per frame so a large texture can't stall the queue
+	int bytesUploaded = 0;
+	TextureStreamRequest request;
+	while (bytesUploaded < m_textureStreamingBudget && m_textureStreamer.PopCompleted(&request))
+	{
+		Texture *pTexture = m_textures.Get(request.m_textureId);
+		if (pTexture != NULL && request.m_atlasFrame != -1)
+		{
+			// A frame of an atlas, the atlas is uploaded once all of its frames are in
+			map<unsigned int, TextureAtlas*>::iterator atlas = m_textureAtlases.find(request.m_textureId);
+			if (atlas != m_textureAtlases.end())
+			{
+				if (request.m_loaded)
+				{
+					atlas->second->SetFrameTexels(request.m_atlasFrame, *request.m_pImage);
+				}
+				else
+				{
+					cout << "Failed to stream atlas frame: " << request.m_fileName << endl;
+					atlas->second->FailFrame(request.m_atlasFrame);
+				}
+
+				if (atlas->second->IsComplete() && pTexture->IsStreaming())
+				{
+					const TextureImage& atlasImage = atlas->second->GetImage();
+					pTexture->Upload(atlasImage, true);
+					m_stateCache.InvalidateTextures();
+					bytesUploaded += atlasImage.m_width * atlasImage.m_height * 4;
+
+					// Only the rects are needed from here on
+					atlas->second->ReleaseTexels();
+				}
+			}
+		}
+		else if (pTexture != NULL)
+		{
+			if (request.m_loaded)
+			{
+				pTexture->Upload(*request.m_pImage, true);
+				m_stateCache.InvalidateTextures();
+
+				for (int i = 0; i < request.m_pImage->GetNumMipLevels(); i++)
+				{
+					const TextureMipLevel& level = request.m_pImage->GetMipLevel(i);
+					bytesUploaded += level.m_width * level.m_height * 4;
+				}
+			}
+			else
+			{
+				// Failed to load, the placeholder stays bound
+				cout << "Failed to stream texture: " << request.m_fileName << endl;
+				pTexture->SetStreaming(false);
+			}
+		}
+
+		delete request.m_pImage;
+	}
+
+	// Let everyone waiting on a texture that has finished know about it
+	for (unsigned int i = 0; i < m_vTextureStreamCallbacks.size();)
+	{
+		TextureStreamCallback streamCallback = m_vTextureStreamCallbacks[i];
+		if (IsTextureStreaming(streamCallback.m_textureId) == false)
+		{
+			// Removed before the call, since a callback may well request more textures
+			m_vTextureStreamCallbacks.erase(m_vTextureStreamCallbacks.begin() + i);
+			streamCallback.m_callback(streamCallback.m_textureId, streamCallback.m_pData);
+		}
+		else
+		{
+			i++;
+		}
+	}
+}
+
+void Renderer::StartTextureStreaming()
+{
+	// Nothing may ever stream, so the workers are only started once there is something for them to do
+	if (m_textureStreamer.IsStarted() == false)
+	{
+		m_textureStreamer.Start(2, GetTextureCacheDirectory());
+	}
+}
+
+GLuint Renderer::GetPlaceholderTexture()
+{
+#ifndef VOGUE_HEADLESS
+	if (m_placeholderTexture == 0)
+	{
+		// A single transparent texel, so a streaming texture simply doesn't show until it has loaded
+		unsigned char placeholderTexel[4] = { 0, 0, 0, 0 };
+		glGenTextures(1, &m_placeholderTexture);
+		glBindTexture(GL_TEXTURE_2D, m_placeholderTexture);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholderTexel);
+		m_stateCache.InvalidateTextures();
+	}
+#endif //VOGUE_HEADLESS
+
+	return m_placeholderTexture;
+}
+
+// Texture atlases
+bool Renderer::LoadTextureAtlas(string name, const vector<string>& fileNames, unsigned int *pID)
+{
+	// Atlases are shared by name, so everything loading the same set of images binds the same texture
+	map<string, unsigned int>::iterator textureFile = m_textureFileNames.find(name);
+	if (textureFile != m_textureFileNames.end() && m_textureAtlases.find(textureFile->second) != m_textureAtlases.end())
+	{
+		*pID = textureFile->second;
+
+		return true;
+	}
+
+	// The rects come from the image headers, so they are ready straight away
+	TextureAtlas *pAtlas = new TextureAtlas();
+	if (pAtlas->Layout(fileNames) == false)
+	{
+		delete pAtlas;
+
+		return false;
+	}
+
+	// The placeholder is bound until every frame has been decoded on the streaming workers and packed
+	Texture *pTexture = new Texture();
+	pTexture->SetPlaceholder(name, GetPlaceholderTexture());
+
+	*pID = m_textures.Insert(pTexture);
+	if (*pID == ResourceRegistry<Texture>::INVALID_HANDLE)
+	{
+		delete pAtlas;
+		return false;
+	}
+	m_textureFileNames[name] = *pID;
+	m_textureAtlases[*pID] = pAtlas;
+
+	StartTextureStreaming();
+	for (int i = 0; i < pAtlas->GetNumFrames(); i++)
+	{
+		m_textureStreamer.QueueRequest(*pID, pAtlas->GetFrameFileName(i), TextureImageFlags_FlipVertical, i);
+	}
+
+	return true;
+}
+
+bool Renderer::GetTextureAtlasRect(unsigned int id, string fileName, TextureAtlasRect *pRect)
+{
+	map<unsigned int, TextureAtlas*>::iterator atlas = m_textureAtlases.find(id);
+	if (atlas == m_textureAtlases.end())
+	{
+		return false;
+	}
+
+	return atlas->second->GetRect(fileName, pRect);
 }
 
 // Cube textures
@@ -1449,7 +1926,7 @@ void Renderer::BindCubeTexture(unsigned int id)
 
 void Renderer::EmptyCubeTextureIndex(unsigned int textureIndex)
 {
-	glActiveTextureARB(GL_TEXTURE0_ARB + textureIndex);
+	SetActiveTextureUnit(textureIndex);
 	glBindTexture(GL_TEXTURE_CUBE_MAP, textureIndex);
 	glDisable(GL_TEXTURE_CUBE_MAP);
 }
@@ -1462,91 +1939,46 @@ void Renderer::DisableCubeTexture()
 // Vertex buffers
 bool Renderer::CreateStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices, unsigned int *pID)
 {
-	VertexArray *pVertexArray = new VertexArray();
+	VertexArray *pVertexArray = BuildVertexArray(type, materialID, textureID, nVerts, nTextureCoordinates, nIndices, pVerts, pTextureCoordinates, pIndices);
 
-	pVertexArray->nIndices = nIndices;
-	pVertexArray->nVerts = nVerts;
-	pVertexArray->nTextureCoordinates = nTextureCoordinates;
-	pVertexArray->materialID = materialID;
-	pVertexArray->textureID = textureID;
-	pVertexArray->type = type;
+	// Add the vertex array to the registry and return its handle
+	*pID = m_vertexArrays.Insert(pVertexArray);
 
-	// Get the correct vertex size and construct the vertex array to hold the vertices
-	if (nVerts)
-	{
-		switch (type)
-		{
-		case VT_POSITION:
-			pVertexArray->vertexSize = sizeof(OGLPositionVertex);
-			pVertexArray->pVA = new float[nVerts * 3];
-			break;
-		case VT_POSITION_DIFFUSE:
-			pVertexArray->vertexSize = sizeof(OGLPositionDiffuseVertex);
-			pVertexArray->pVA = new float[nVerts * 6];
-			break;
-		case VT_POSITION_DIFFUSE_ALPHA:
-			pVertexArray->vertexSize = sizeof(OGLPositionDiffuseAlphaVertex);
-			pVertexArray->pVA = new float[nVerts * 7];
-			break;
-		case VT_POSITION_NORMAL:
-			pVertexArray->vertexSize = sizeof(OGLPositionNormalVertex);
-			pVertexArray->pVA = new float[nVerts * 6];
-			break;
-		case VT_POSITION_NORMAL_COLOUR:
-			pVertexArray->vertexSize = sizeof(OGLPositionNormalColourVertex);
-			pVertexArray->pVA = new float[nVerts * 10];
-			break;
-		case VT_POSITION_NORMAL_UV:
-			pVertexArray->vertexSize = sizeof(OGLPositionNormalVertex);
-			pVertexArray->pVA = new float[nVerts * 6];
-			pVertexArray->textureCoordinateSize = sizeof(OGLUVCoordinate);
-			pVertexArray->pTextureCoordinates = new float[nTextureCoordinates * 2];
-			break;
-		case VT_POSITION_NORMAL_UV_COLOUR:
-			pVertexArray->vertexSize = sizeof(OGLPositionNormalColourVertex);
-			pVertexArray->pVA = new float[nVerts * 10];
-			pVertexArray->textureCoordinateSize = sizeof(OGLUVCoordinate);
-			pVertexArray->pTextureCoordinates = new float[nTextureCoordinates * 2];
-			break;
-		}
-	}
-
-
-	// If we have indices, create the indices array to hold the information
-	if (nIndices)
-	{
-		pVertexArray->pIndices = new unsigned int[nIndices];
-	}
+	return *pID != ResourceRegistry<VertexArray>::INVALID_HANDLE;
+}
 
-	// Copy the vertices into the vertex array
-	memcpy(pVertexArray->pVA, pVerts, pVertexArray->vertexSize*nVerts);
+bool Renderer::QueueStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices, unsigned int *pID)
+{
+	// For loader threads, the handle is valid straight away but the buffer only renders once published by UpdateResourceRegistries()
+	VertexArray *pVertexArray = BuildVertexArray(type, materialID, textureID, nVerts, nTextureCoordinates, nIndices, pVerts, pTextureCoordinates, pIndices);
 
-	// Copt the texture coordinates into the texture array
-	memcpy(pVertexArray->pTextureCoordinates, pTextureCoordinates, pVertexArray->textureCoordinateSize*nTextureCoordinates);
+	*pID = m_vertexArrays.QueueInsert(pVertexArray);
 
-	// Copy the indices into the vertex array
-	memcpy(pVertexArray->pIndices, pIndices, sizeof(unsigned int)*nIndices);
+	return *pID != ResourceRegistry<VertexArray>::INVALID_HANDLE;
+}
 
-	// Push the vertex array onto the list
-	m_vertexArraysMutex.lock();
-	m_vertexArrays.push_back(pVertexArray);
+bool Renderer::RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices)
+{
+	VertexArray *pVertexArray = BuildVertexArray(type, materialID, textureID, nVerts, nTextureCoordinates, nIndices, pVerts, pTextureCoordinates, pIndices);
 
-	// Return the vertex array id
-	*pID = (int)m_vertexArrays.size() - 1;
-	m_vertexArraysMutex.unlock();
+	// Swap in the new vertex array, the old one is retired until the next frame
+	if (m_vertexArrays.Replace(ID, pVertexArray) == false)
+	{
+		delete pVertexArray;
+		return false;
+	}
 
 	return true;
 }
 
-bool Renderer::RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices)
+void Renderer::DeleteStaticBuffer(unsigned int id)
 {
-	m_vertexArraysMutex.lock();
-
-	// Create a new vertex array
-	m_vertexArrays[ID] = new VertexArray();
+	m_vertexArrays.Remove(id);
+}
 
-	// Get this already existing array pointer from the list
-	VertexArray *pVertexArray = m_vertexArrays[ID];
+VertexArray* Renderer::BuildVertexArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices)
+{
+	VertexArray *pVertexArray = new VertexArray();
 
 	pVertexArray->nIndices = nIndices;
 	pVertexArray->nVerts = nVerts;
@@ -1595,6 +2027,7 @@ bool Renderer::RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned i
 		}
 	}
 
+
 	// If we have indices, create the indices array to hold the information
 	if (nIndices)
 	{
@@ -1604,44 +2037,42 @@ bool Renderer::RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned i
 	// Copy the vertices into the vertex array
 	memcpy(pVertexArray->pVA, pVerts, pVertexArray->vertexSize*nVerts);
 
+	// Pull the positions out into their own stream, depth only rendering then doesn't have to read past the rest of each vertex
+	if (nVerts)
+	{
+		int vertexFloats = pVertexArray->vertexSize / sizeof(float);
+		pVertexArray->pPositions = new float[nVerts * 3];
+		for (int i = 0; i < nVerts; i++)
+		{
+			pVertexArray->pPositions[i * 3 + 0] = pVertexArray->pVA[i * vertexFloats + 0];
+			pVertexArray->pPositions[i * 3 + 1] = pVertexArray->pVA[i * vertexFloats + 1];
+			pVertexArray->pPositions[i * 3 + 2] = pVertexArray->pVA[i * vertexFloats + 2];
+		}
+	}
+
 	// Copt the texture coordinates into the texture array
 	memcpy(pVertexArray->pTextureCoordinates, pTextureCoordinates, pVertexArray->textureCoordinateSize*nTextureCoordinates);
 
 	// Copy the indices into the vertex array
 	memcpy(pVertexArray->pIndices, pIndices, sizeof(unsigned int)*nIndices);
-	
-	m_vertexArraysMutex.unlock();
-
-	return true;
-}
 
-void Renderer::DeleteStaticBuffer(unsigned int id)
-{
-	m_vertexArraysMutex.lock();
-	if (m_vertexArrays[id])
-	{
-		delete m_vertexArrays[id];
-		m_vertexArrays[id] = 0;
-	}
-	m_vertexArraysMutex.unlock();
+	return pVertexArray;
 }
 
 bool Renderer::RenderStaticBuffer(unsigned int id)
 {
-	m_vertexArraysMutex.lock();
-
-	if (id >= m_vertexArrays.size())
+	if (m_depthOnlyRender)
 	{
-		m_vertexArraysMutex.unlock();
-		return false;  // We have supplied an invalid id		
+		return RenderStaticBuffer_DepthOnly(id);
 	}
 
-	// Find the vertex array from the list
-	VertexArray *pVertexArray = m_vertexArrays[id];
+	// Find the vertex array from the registry, NULL if we have supplied an invalid or stale id
+	VertexArray *pVertexArray = m_vertexArrays.Get(id);
 
 	bool rendered = false;
 	if (pVertexArray != NULL)
 	{
+		m_numDrawCalls++;
 		m_numRenderedVertices += pVertexArray->nVerts;
 		switch (m_primativeMode)
 		{
@@ -1667,7 +2098,7 @@ bool Renderer::RenderStaticBuffer(unsigned int id)
 		{
 			if (pVertexArray->materialID != -1)
 			{
-				m_materials[pVertexArray->materialID]->Apply();
+				EnableMaterial(pVertexArray->materialID);
 			}
 		}
 
@@ -1732,27 +2163,23 @@ bool Renderer::RenderStaticBuffer(unsigned int id)
 		rendered =  true;
 	}
 
-	m_vertexArraysMutex.unlock();
-
 	return rendered;
 }
 
 bool Renderer::RenderStaticBuffer_NoColour(unsigned int id)
 {
-	m_vertexArraysMutex.lock();
-
-	if (id >= m_vertexArrays.size())
+	if (m_depthOnlyRender)
 	{
-		m_vertexArraysMutex.unlock();
-		return false;  // We have supplied an invalid id		
+		return RenderStaticBuffer_DepthOnly(id);
 	}
 
-	// Find the vertex array from the list
-	VertexArray *pVertexArray = m_vertexArrays[id];
+	// Find the vertex array from the registry, NULL if we have supplied an invalid or stale id
+	VertexArray *pVertexArray = m_vertexArrays.Get(id);
 
 	bool rendered = false;
 	if (pVertexArray != NULL)
 	{
+		m_numDrawCalls++;
 		m_numRenderedVertices += pVertexArray->nVerts;
 		switch (m_primativeMode)
 		{
@@ -1778,7 +2205,7 @@ bool Renderer::RenderStaticBuffer_NoColour(unsigned int id)
 		{
 			if (pVertexArray->materialID != -1)
 			{
-				m_materials[pVertexArray->materialID]->Apply();
+				EnableMaterial(pVertexArray->materialID);
 			}
 		}
 
@@ -1843,18 +2270,59 @@ bool Renderer::RenderStaticBuffer_NoColour(unsigned int id)
 		rendered = true;
 	}
 
-	m_vertexArraysMutex.unlock();
-
 	return rendered;
 }
 
+bool Renderer::RenderStaticBuffer_DepthOnly(unsigned int id)
+{
+	// Find the vertex array from the registry, NULL if we have supplied an invalid or stale id
+	VertexArray *pVertexArray = m_vertexArrays.Get(id);
+	if (pVertexArray == NULL || pVertexArray->nVerts == 0)
+	{
+		return false;
+	}
+
+	m_numDrawCalls++;
+	m_numRenderedVertices += pVertexArray->nVerts;
+	switch (m_primativeMode)
+	{
+	case GL_TRIANGLES:
+		m_numRenderedFaces += (pVertexArray->nIndices / 3);
+		break;
+	case GL_TRIANGLE_STRIP:
+	case GL_TRIANGLE_FAN:
+		m_numRenderedFaces += (pVertexArray->nIndices - 2);
+		break;
+	case GL_QUADS:
+		m_numRenderedFaces += (pVertexArray->nIndices / 4);
+		break;
+	}
+
+	// Positions only, nothing else is needed to fill the depth buffer
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glVertexPointer(3, GL_FLOAT, 0, pVertexArray->pPositions);
+
+	if (pVertexArray->nIndices != 0)
+	{
+		glDrawElements(m_primativeMode, pVertexArray->nIndices, GL_UNSIGNED_INT, pVertexArray->pIndices);
+	}
+	else
+	{
+		glDrawArrays(m_primativeMode, 0, pVertexArray->nVerts);
+	}
+
+	glDisableClientState(GL_VERTEX_ARRAY);
+
+	return true;
+}
+
 bool Renderer::RenderFromArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices)
 {
 	if ((type != VT_POSITION_DIFFUSE_ALPHA) && (type != VT_POSITION_DIFFUSE))
 	{
 		if (materialID != -1)
 		{
-			m_materials[materialID]->Apply();
+			EnableMaterial(materialID);
 		}
 	}
 
@@ -1866,6 +2334,7 @@ bool Renderer::RenderFromArray(VertexType type, unsigned int materialID, unsigne
 		}
 	}
 
+	m_numDrawCalls++;
 	m_numRenderedVertices += nVerts;
 	switch (m_primativeMode)
 	{
@@ -1963,6 +2432,69 @@ unsigned int Renderer::GetStride(VertexType type)
 	return totalStride;
 }
 
+// Streamed vertex buffers
+bool Renderer::CreateStreamBuffer(unsigned int *pID)
+{
+	GLuint buffer = 0;
+#ifndef VOGUE_HEADLESS
+	glGenBuffers(1, &buffer);
+#endif //VOGUE_HEADLESS
+
+	m_vStreamBuffers.push_back(buffer);
+	*pID = (unsigned int)m_vStreamBuffers.size() - 1;
+
+	return true;
+}
+
+bool Renderer::RenderStreamBuffer(unsigned int id, unsigned int textureID, int nVerts, const float *pVerts)
+{
+	if (nVerts == 0)
+	{
+		return false;
+	}
+
+#ifdef VOGUE_HEADLESS
+	return false;
+#else
+	GLsizei stride = sizeof(float) * 9;
+	GLsizeiptr size = stride * nVerts;
+
+	// Orphan the storage from the last draw so the driver doesn't have to wait for it before the upload
+	glBindBuffer(GL_ARRAY_BUFFER, m_vStreamBuffers[id]);
+	glBufferData(GL_ARRAY_BUFFER, size, NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_ARRAY_BUFFER, 0, size, pVerts);
+
+	if (textureID != -1)
+	{
+		BindTexture(textureID);
+	}
+	else
+	{
+		DisableTexture();
+	}
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_COLOR_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(3, GL_FLOAT, stride, 0);
+	glColorPointer(4, GL_FLOAT, stride, reinterpret_cast<void *>(sizeof(float) * 3));
+	glTexCoordPointer(2, GL_FLOAT, stride, reinterpret_cast<void *>(sizeof(float) * 7));
+
+	glDrawArrays(GL_QUADS, 0, nVerts);
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_COLOR_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_numDrawCalls++;
+	m_numRenderedVertices += nVerts;
+	m_numRenderedFaces += nVerts / 4;
+
+	return true;
+#endif //VOGUE_HEADLESS
+}
+
 // Mesh
 OpenGLTriangleMesh* Renderer::CreateMesh(OGLMeshType meshType)
 {
@@ -2089,8 +2621,11 @@ unsigned int Renderer::AddTriangleToMesh(unsigned int vertexId1, unsigned int ve
 
 void Renderer::ModifyMeshAlpha(float alpha, OpenGLTriangleMesh* pMesh)
 {
-	m_vertexArraysMutex.lock();
-	VertexArray* pArray = m_vertexArrays[pMesh->m_staticMeshId];
+	VertexArray* pArray = m_vertexArrays.Get(pMesh->m_staticMeshId);
+	if (pArray == NULL)
+	{
+		return;
+	}
 
 	GLsizei totalStride = GetStride(pArray->type) / 4;
 	int alphaIndex = totalStride - 1;
@@ -2101,13 +2636,15 @@ void Renderer::ModifyMeshAlpha(float alpha, OpenGLTriangleMesh* pMesh)
 
 		alphaIndex += totalStride;
 	}
-	m_vertexArraysMutex.unlock();
 }
 
 void Renderer::ModifyMeshColour(float r, float g, float b, OpenGLTriangleMesh* pMesh)
 {
-	m_vertexArraysMutex.lock();
-	VertexArray* pArray = m_vertexArrays[pMesh->m_staticMeshId];
+	VertexArray* pArray = m_vertexArrays.Get(pMesh->m_staticMeshId);
+	if (pArray == NULL)
+	{
+		return;
+	}
 
 	GLsizei totalStride = GetStride(pArray->type) / 4;
 	int rIndex = totalStride - 4;
@@ -2124,13 +2661,15 @@ void Renderer::ModifyMeshColour(float r, float g, float b, OpenGLTriangleMesh* p
 		gIndex += totalStride;
 		bIndex += totalStride;
 	}
-	m_vertexArraysMutex.unlock();
 }
 
 void Renderer::ConvertMeshColour(float r, float g, float b, float matchR, float matchG, float matchB, OpenGLTriangleMesh* pMesh)
 {
-	m_vertexArraysMutex.lock();
-	VertexArray* pArray = m_vertexArrays[pMesh->m_staticMeshId];
+	VertexArray* pArray = m_vertexArrays.Get(pMesh->m_staticMeshId);
+	if (pArray == NULL)
+	{
+		return;
+	}
 
 	GLsizei totalStride = GetStride(pArray->type) / 4;
 	int rIndex = totalStride - 4;
@@ -2153,7 +2692,6 @@ void Renderer::ConvertMeshColour(float r, float g, float b, float matchR, float
 		gIndex += totalStride;
 		bIndex += totalStride;
 	}
-	m_vertexArraysMutex.unlock();
 }
 
 void Renderer::FinishMesh(unsigned int textureID, unsigned int materialID, OpenGLTriangleMesh* pMesh)
@@ -2286,9 +2824,170 @@ bool Renderer::MeshStaticBufferRender(OpenGLTriangleMesh* pMesh)
 {
 	SetPrimativeMode(PM_TRIANGLES);
 
+	if (m_recordingDrawList)
+	{
+		return RecordMeshDraw(pMesh);
+	}
+
 	return RenderStaticBuffer(pMesh->m_staticMeshId);
 }
 
+// Depth only rendering
+void Renderer::StartDepthOnlyRender()
+{
+	m_depthOnlyRender = true;
+
+	// Colour writes are off, so only the depth test and write remain
+	SetColourMask(false, false, false, false);
+	DisableTexture();
+}
+
+void Renderer::EndDepthOnlyRender()
+{
+	m_depthOnlyRender = false;
+
+	SetColourMask(true, true, true, true);
+}
+
+bool Renderer::IsDepthOnlyRender()
+{
+	return m_depthOnlyRender;
+}
+
+// Draw list
+void Renderer::BeginDrawList()
+{
+	m_drawList.Clear();
+	m_recordingDrawList = true;
+}
+
+void Renderer::EndDrawList()
+{
+	m_recordingDrawList = false;
+
+	SubmitDrawList();
+	m_drawList.Clear();
+}
+
+bool Renderer::IsRecordingDrawList()
+{
+	return m_recordingDrawList;
+}
+
+bool Renderer::RecordMeshDraw(OpenGLTriangleMesh* pMesh)
+{
+	VertexArray *pVertexArray = m_vertexArrays.Get(pMesh->m_staticMeshId);
+	if (pVertexArray == NULL)
+	{
+		return false;
+	}
+
+	DrawCommand command;
+	command.m_staticBufferId = pMesh->m_staticMeshId;
+	command.m_shaderId = m_activeShader;
+	command.m_textureId = pVertexArray->textureID;
+	command.m_materialId = m_stateCache.GetMaterial();
+	command.m_cullMode = m_cullMode;
+	command.m_pass = m_stateCache.IsBlendEnabled() ? DrawPass_Transparent : DrawPass_Opaque;
+
+	// The matrices are taken as they are now, the texture matrix is the shadow one on unit 7
+	glGetFloatv(GL_MODELVIEW_MATRIX, command.m_modelViewMatrix);
+	glGetFloatv(GL_TEXTURE_MATRIX, command.m_textureMatrix);
+
+	// Eye space depth of the mesh origin
+	float depth = -command.m_modelViewMatrix[14] / m_clipFar;
+	command.m_sortKey = DrawList::CreateSortKey(command.m_pass, command.m_shaderId, command.m_textureId, command.m_materialId, depth);
+
+	m_drawList.AddCommand(command);
+
+	return true;
+}
+
+void Renderer::SubmitDrawList()
+{
+	int numCommands = m_drawList.GetNumCommands();
+	if (numCommands == 0)
+	{
+		return;
+	}
+
+	m_drawList.Sort();
+
+	CullMode cullMode = m_cullMode;
+	int shader = m_activeShader;
+	bool blend = m_stateCache.IsBlendEnabled();
+
+	glMatrixMode(GL_TEXTURE);
+	SetActiveTextureUnit(7);
+	glPushMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPushMatrix();
+
+	StartMeshRender();
+	for (int i = 0; i < numCommands; i++)
+	{
+		const DrawCommand& command = m_drawList.GetSortedCommand(i);
+
+		if ((int)command.m_shaderId != m_activeShader)
+		{
+			if (m_activeShader != -1)
+			{
+				EndGLSLShader(m_activeShader);
+			}
+			if ((int)command.m_shaderId != -1)
+			{
+				BeginGLSLShader(command.m_shaderId);
+			}
+		}
+
+		SetCullMode((CullMode)command.m_cullMode);
+		if (command.m_pass == DrawPass_Transparent)
+		{
+			EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+		}
+		else
+		{
+			DisableTransparency();
+		}
+		if (command.m_materialId != (unsigned int)RENDER_STATE_UNKNOWN)
+		{
+			EnableMaterial(command.m_materialId);
+		}
+
+		glMatrixMode(GL_TEXTURE);
+		glLoadMatrixf(command.m_textureMatrix);
+		glMatrixMode(GL_MODELVIEW);
+		glLoadMatrixf(command.m_modelViewMatrix);
+
+		RenderStaticBuffer(command.m_staticBufferId);
+	}
+	EndMeshRender();
+
+	glMatrixMode(GL_TEXTURE);
+	SetActiveTextureUnit(7);
+	glPopMatrix();
+	glMatrixMode(GL_MODELVIEW);
+	glPopMatrix();
+
+	// Put back the state the draws were recorded from
+	if (shader != m_activeShader)
+	{
+		if (m_activeShader != -1)
+		{
+			EndGLSLShader(m_activeShader);
+		}
+		if (shader != -1)
+		{
+			BeginGLSLShader(shader);
+		}
+	}
+	SetCullMode(cullMode);
+	if (blend == false)
+	{
+		DisableTransparency();
+	}
+}
+
 // Name rendering and name picking
 void Renderer::InitNameStack()
 {
@@ -2389,6 +3088,33 @@ int Renderer::CubeInFrustum(unsigned int frustumid, const vec3 &center, float x,
 	return pFrustum->CubeInFrustum(center, x, y, z);
 }
 
+float Renderer::GetProjectedSize(const vec3 &position, float size)
+{
+	// Only the perspective projection shrinks things with distance, anything else counts as full size
+	if (m_activeViewport >= m_viewports.size() || m_projection != &(m_viewports[m_activeViewport]->Perspective))
+	{
+		return (float)m_windowHeight;
+	}
+
+	Viewport* pViewport = m_viewports[m_activeViewport];
+	Frustum* pFrustum = m_frustums[m_activeViewport];
+
+	return GetProjectedSize(size, length(position - pFrustum->cameraPosition), pViewport->Fov, pViewport->Height);
+}
+
+float Renderer::GetProjectedSize(float size, float distance, float fov, int viewportHeight)
+{
+	// Closer than its own size it fills the view
+	if (distance <= size)
+	{
+		return (float)viewportHeight;
+	}
+
+	float tanHalfFov = (float)tan(DegToRad(fov) * 0.5f);
+
+	return (size / (distance * tanHalfFov)) * viewportHeight * 0.5f;
+}
+
 // Frame buffers
 bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, bool normal, bool depth, int width, int height, float viewportScale, string name, unsigned int *pId)
 {
@@ -2396,6 +3122,7 @@ bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, b
 	if (idToResetup == -1)
 	{
 		pNewFrameBuffer = new FrameBuffer();
+		pNewFrameBuffer->m_pooled = false;
 	}
 	else
 	{
@@ -2425,7 +3152,7 @@ bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, b
 	if (diffuse)
 	{
 		glGenTextures(1, &pNewFrameBuffer->m_diffuseTexture);
-		glBindTexture(GL_TEXTURE_2D, pNewFrameBuffer->m_diffuseTexture);
+		BindRawTextureId(pNewFrameBuffer->m_diffuseTexture);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -2437,7 +3164,7 @@ bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, b
 	if (position)
 	{
 		glGenTextures(1, &pNewFrameBuffer->m_positionTexture);
-		glBindTexture(GL_TEXTURE_2D, pNewFrameBuffer->m_positionTexture);
+		BindRawTextureId(pNewFrameBuffer->m_positionTexture);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -2449,7 +3176,7 @@ bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, b
 	if (normal)
 	{
 		glGenTextures(1, &pNewFrameBuffer->m_normalTexture);
-		glBindTexture(GL_TEXTURE_2D, pNewFrameBuffer->m_normalTexture);
+		BindRawTextureId(pNewFrameBuffer->m_normalTexture);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
@@ -2461,7 +3188,7 @@ bool Renderer::CreateFrameBuffer(int idToResetup, bool diffuse, bool position, b
 	if (depth)
 	{
 		glGenTextures(1, &pNewFrameBuffer->m_depthTexture);
-		glBindTexture(GL_TEXTURE_2D, pNewFrameBuffer->m_depthTexture);
+		BindRawTextureId(pNewFrameBuffer->m_depthTexture);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP);
 		glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
@@ -2561,12 +3288,30 @@ void Renderer::StartRenderingToFrameBuffer(unsigned int frameBufferId)
 		clear |= GL_DEPTH_BUFFER_BIT;
 	glClear(clear);
 
-	glActiveTextureARB(GL_TEXTURE0_ARB);
-	glEnable(GL_TEXTURE_2D);
+	SetActiveTextureUnit(0);
+	if (m_stateCache.SetTexture2D(true))
+	{
+		glEnable(GL_TEXTURE_2D);
+	}
+
+	// Specify what to render an start acquiring, only the colour attachments this frame buffer actually has
+	GLenum buffers[3];
+	int numBuffers = 0;
+	if (m_vFrameBuffers[frameBufferId]->m_diffuseTexture != -1)
+		buffers[numBuffers++] = GL_COLOR_ATTACHMENT0_EXT;
+	if (m_vFrameBuffers[frameBufferId]->m_positionTexture != -1)
+		buffers[numBuffers++] = GL_COLOR_ATTACHMENT1_EXT;
+	if (m_vFrameBuffers[frameBufferId]->m_normalTexture != -1)
+		buffers[numBuffers++] = GL_COLOR_ATTACHMENT2_EXT;
 
-	// Specify what to render an start acquiring
-	GLenum buffers[] = { GL_COLOR_ATTACHMENT0_EXT, GL_COLOR_ATTACHMENT1_EXT, GL_COLOR_ATTACHMENT2_EXT };
-	glDrawBuffers(3, buffers);
+	if (numBuffers > 0)
+	{
+		glDrawBuffers(numBuffers, buffers);
+	}
+	else
+	{
+		glDrawBuffer(GL_NONE);
+	}
 }
 
 void Renderer::StopRenderingToFrameBuffer(unsigned int frameBufferId)
@@ -2575,6 +3320,24 @@ void Renderer::StopRenderingToFrameBuffer(unsigned int frameBufferId)
 	glPopAttrib();
 }
 
+void Renderer::CopyFrameBufferDepth(unsigned int sourceFrameBufferId, unsigned int destinationFrameBufferId)
+{
+	FrameBuffer* pSource = m_vFrameBuffers[sourceFrameBufferId];
+	FrameBuffer* pDestination = m_vFrameBuffers[destinationFrameBufferId];
+
+	int sourceWidth = (int)(pSource->m_width*pSource->m_viewportScale);
+	int sourceHeight = (int)(pSource->m_height*pSource->m_viewportScale);
+	int destinationWidth = (int)(pDestination->m_width*pDestination->m_viewportScale);
+	int destinationHeight = (int)(pDestination->m_height*pDestination->m_viewportScale);
+
+	glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, pSource->m_fbo);
+	glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, pDestination->m_fbo);
+	glBlitFramebufferEXT(0, 0, sourceWidth, sourceHeight, 0, 0, destinationWidth, destinationHeight, GL_DEPTH_BUFFER_BIT, GL_NEAREST);
+
+	// Leave the destination bound, this is called part way through rendering to it
+	glBindFramebufferEXT(GL_FRAMEBUFFER_EXT, pDestination->m_fbo);
+}
+
 unsigned int Renderer::GetDiffuseTextureFromFrameBuffer(unsigned int frameBufferId)
 {
 	return m_vFrameBuffers[frameBufferId]->m_diffuseTexture;
@@ -2595,11 +3358,276 @@ unsigned int Renderer::GetDepthTextureFromFrameBuffer(unsigned int frameBufferId
 	return m_vFrameBuffers[frameBufferId]->m_depthTexture;
 }
 
+// Full screen passes
+void Renderer::RenderFullScreenTriangle()
+{
+	if (m_fullScreenTriangleBuffer == 0)
+	{
+		// Clip space position and texture coordinate, the parts of the triangle outside the screen are clipped away
+		float vertices[] =
+		{
+			-1.0f, -1.0f, 0.0f, 0.0f,
+			 3.0f, -1.0f, 2.0f, 0.0f,
+			-1.0f,  3.0f, 0.0f, 2.0f,
+		};
+
+		glGenBuffers(1, &m_fullScreenTriangleBuffer);
+		glBindBuffer(GL_ARRAY_BUFFER, m_fullScreenTriangleBuffer);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+	}
+	else
+	{
+		glBindBuffer(GL_ARRAY_BUFFER, m_fullScreenTriangleBuffer);
+	}
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+	glVertexPointer(2, GL_FLOAT, sizeof(float) * 4, 0);
+	glTexCoordPointer(2, GL_FLOAT, sizeof(float) * 4, reinterpret_cast<void *>(sizeof(float) * 2));
+
+	glDrawArrays(GL_TRIANGLES, 0, 3);
+
+	glDisableClientState(GL_TEXTURE_COORD_ARRAY);
+	glDisableClientState(GL_VERTEX_ARRAY);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+	m_numDrawCalls++;
+	m_numRenderedVertices += 3;
+	m_numRenderedFaces += 1;
+}
+
+// Render target pool
+bool Renderer::CreateRenderTarget(const RenderTargetDesc& desc, int firstPass, int lastPass, string name, unsigned int *pId)
+{
+	RenderTargetLifetime lifetime;
+	lifetime.m_firstPass = firstPass;
+	lifetime.m_lastPass = lastPass;
+
+	// Share a frame buffer with the same description if none of its users are live in the same passes
+	for (unsigned int i = 0; i < m_vFrameBuffers.size(); i++)
+	{
+		FrameBuffer* pFrameBuffer = m_vFrameBuffers[i];
+		if (pFrameBuffer->m_pooled == false || pFrameBuffer->m_desc.Matches(desc) == false)
+		{
+			continue;
+		}
+
+		bool overlaps = false;
+		for (unsigned int j = 0; j < pFrameBuffer->m_vLifetimes.size(); j++)
+		{
+			if (pFrameBuffer->m_vLifetimes[j].m_firstPass <= lastPass && firstPass <= pFrameBuffer->m_vLifetimes[j].m_lastPass)
+			{
+				overlaps = true;
+				break;
+			}
+		}
+
+		if (overlaps == false)
+		{
+			pFrameBuffer->m_vLifetimes.push_back(lifetime);
+			pFrameBuffer->m_name += " / " + name;
+			*pId = i;
+
+			return true;
+		}
+	}
+
+	// Nothing to alias with, create a new frame buffer for it
+	int width = desc.m_width;
+	int height = desc.m_height;
+	float viewportScale = 1.0f;
+	if (desc.m_sizeClass == RenderTargetSizeClass_Screen)
+	{
+		width = m_windowWidth;
+		height = m_windowHeight;
+		viewportScale = desc.m_viewportScale;
+	}
+
+	if (CreateFrameBuffer(-1, desc.m_diffuse, desc.m_position, desc.m_normal, desc.m_depth, width, height, viewportScale, name, pId) == false)
+	{
+		return false;
+	}
+
+	FrameBuffer* pFrameBuffer = m_vFrameBuffers[*pId];
+	pFrameBuffer->m_pooled = true;
+	pFrameBuffer->m_desc = desc;
+	pFrameBuffer->m_vLifetimes.push_back(lifetime);
+
+	return true;
+}
+
+void Renderer::ResizeRenderTargets(int width, int height)
+{
+	// Only the screen sized targets follow the window, fixed size targets like the shadow map are left alone
+	for (unsigned int i = 0; i < m_vFrameBuffers.size(); i++)
+	{
+		FrameBuffer* pFrameBuffer = m_vFrameBuffers[i];
+		if (pFrameBuffer->m_pooled == false || pFrameBuffer->m_desc.m_sizeClass != RenderTargetSizeClass_Screen)
+		{
+			continue;
+		}
+
+		if (pFrameBuffer->m_width == width && pFrameBuffer->m_height == height)
+		{
+			continue;
+		}
+
+		const RenderTargetDesc& desc = pFrameBuffer->m_desc;
+		unsigned int id;
+		CreateFrameBuffer(i, desc.m_diffuse, desc.m_position, desc.m_normal, desc.m_depth, width, height, desc.m_viewportScale, pFrameBuffer->m_name, &id);
+	}
+}
+
+// GPU timers
+bool Renderer::CreateGPUTimer(string name, unsigned int *pId)
+{
+	GPUTimer* pGPUTimer = new GPUTimer();
+	pGPUTimer->m_name = name;
+	pGPUTimer->m_queries[0] = 0;
+	pGPUTimer->m_queries[1] = 0;
+	pGPUTimer->m_queryIssued[0] = false;
+	pGPUTimer->m_queryIssued[1] = false;
+	pGPUTimer->m_currentQuery = 0;
+	pGPUTimer->m_milliseconds = 0.0f;
+
+	m_vpGPUTimers.push_back(pGPUTimer);
+	*pId = (int)m_vpGPUTimers.size() - 1;
+
+	// Without timer queries the timer is kept, but never measures anything
+	if (GLEW_ARB_timer_query == false)
+	{
+		return false;
+	}
+
+	glGenQueries(2, pGPUTimer->m_queries);
+
+	return true;
+}
+
+void Renderer::BeginGPUTimer(unsigned int timerId)
+{
+	GPUTimer* pGPUTimer = m_vpGPUTimers[timerId];
+	if (pGPUTimer->m_queries[0] == 0)
+	{
+		return;
+	}
+
+	// Pick up the result of the last time this query was used before it is reused
+	int query = pGPUTimer->m_currentQuery;
+	if (pGPUTimer->m_queryIssued[query])
+	{
+		GLint available = 0;
+		glGetQueryObjectiv(pGPUTimer->m_queries[query], GL_QUERY_RESULT_AVAILABLE, &available);
+		if (available)
+		{
+			GLuint64 elapsed = 0;
+			glGetQueryObjectui64v(pGPUTimer->m_queries[query], GL_QUERY_RESULT, &elapsed);
+			pGPUTimer->m_milliseconds = (float)(elapsed / 1000000.0);
+		}
+	}
+
+	glBeginQuery(GL_TIME_ELAPSED, pGPUTimer->m_queries[query]);
+}
+
+void Renderer::EndGPUTimer(unsigned int timerId)
+{
+	GPUTimer* pGPUTimer = m_vpGPUTimers[timerId];
+	if (pGPUTimer->m_queries[0] == 0)
+	{
+		return;
+	}
+
+	glEndQuery(GL_TIME_ELAPSED);
+
+	pGPUTimer->m_queryIssued[pGPUTimer->m_currentQuery] = true;
+	pGPUTimer->m_currentQuery = 1 - pGPUTimer->m_currentQuery;
+}
+
+float Renderer::GetGPUTimerMilliseconds(unsigned int timerId)
+{
+	return m_vpGPUTimers[timerId]->m_milliseconds;
+}
+
+// Texture buffers
+bool Renderer::CreateTextureBuffer(bool vec4, unsigned int *pId)
+{
+	TextureBuffer* pTextureBuffer = new TextureBuffer();
+	pTextureBuffer->m_buffer = 0;
+	pTextureBuffer->m_texture = 0;
+	pTextureBuffer->m_format = vec4 ? GL_RGBA32F : GL_R32F;
+	pTextureBuffer->m_numFloats = 0;
+
+	m_vpTextureBuffers.push_back(pTextureBuffer);
+	*pId = (int)m_vpTextureBuffers.size() - 1;
+
+	// Without buffer textures the buffer is kept, but never holds anything
+	if (GLEW_ARB_texture_buffer_object == false)
+	{
+		return false;
+	}
+
+	glGenBuffers(1, &pTextureBuffer->m_buffer);
+	glGenTextures(1, &pTextureBuffer->m_texture);
+
+	// Never leave the texture without any storage behind it
+	float empty[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	glBindBuffer(GL_TEXTURE_BUFFER, pTextureBuffer->m_buffer);
+	glBufferData(GL_TEXTURE_BUFFER, sizeof(empty), empty, GL_STREAM_DRAW);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+
+	glBindTexture(GL_TEXTURE_BUFFER, pTextureBuffer->m_texture);
+	glTexBuffer(GL_TEXTURE_BUFFER, pTextureBuffer->m_format, pTextureBuffer->m_buffer);
+	glBindTexture(GL_TEXTURE_BUFFER, 0);
+
+	return true;
+}
+
+void Renderer::UpdateTextureBuffer(unsigned int id, const float *pData, int numFloats)
+{
+	TextureBuffer* pTextureBuffer = m_vpTextureBuffers[id];
+	if (pTextureBuffer->m_buffer == 0 || numFloats == 0)
+	{
+		return;
+	}
+
+	// Orphan the old storage so the upload doesn't wait on draws still reading it, kept at the largest size seen
+	glBindBuffer(GL_TEXTURE_BUFFER, pTextureBuffer->m_buffer);
+	if (numFloats > pTextureBuffer->m_numFloats)
+	{
+		pTextureBuffer->m_numFloats = numFloats;
+	}
+	glBufferData(GL_TEXTURE_BUFFER, pTextureBuffer->m_numFloats * sizeof(float), NULL, GL_STREAM_DRAW);
+	glBufferSubData(GL_TEXTURE_BUFFER, 0, numFloats * sizeof(float), pData);
+	glBindBuffer(GL_TEXTURE_BUFFER, 0);
+}
+
+void Renderer::BindTextureBuffer(unsigned int id)
+{
+	glBindTexture(GL_TEXTURE_BUFFER, m_vpTextureBuffers[id]->m_texture);
+}
+
+// Resources
+void Renderer::UpdateResourceRegistries()
+{
+	UpdateTextureStreaming();
+
+	m_vertexArrays.PublishQueued();
+	m_textures.PublishQueued();
+	m_materials.PublishQueued();
+
+	m_vertexArrays.CollectGarbage();
+	m_textures.CollectGarbage();
+	m_materials.CollectGarbage();
+}
+
 // Rendered information
 void Renderer::ResetRenderedStats()
 {
 	m_numRenderedVertices = 0;
 	m_numRenderedFaces = 0;
+	m_numDrawCalls = 0;
+
+	m_stateCache.ResetCounters();
 }
 
 int Renderer::GetNumRenderedVertices()
@@ -2612,9 +3640,34 @@ int Renderer::GetNumRenderedFaces()
 	return m_numRenderedFaces;
 }
 
+int Renderer::GetNumDrawCalls()
+{
+	return m_numDrawCalls;
+}
+
+int Renderer::GetNumStateChanges()
+{
+	return m_stateCache.GetNumStateChanges();
+}
+
+int Renderer::GetNumRedundantStateChanges()
+{
+	return m_stateCache.GetNumRedundantStateChanges();
+}
+
+void Renderer::InvalidateStateCache()
+{
+	m_stateCache.Invalidate();
+}
+
 // Shaders
 bool Renderer::LoadGLSLShader(const char* vertexFile, const char* fragmentFile, unsigned int *pID)
 {
+#ifdef VOGUE_HEADLESS
+	// No GL context to compile shaders against
+	return false;
+#endif //VOGUE_HEADLESS
+
 	glShader* lpShader = NULL;
 
 	// Load the shader
@@ -2638,12 +3691,22 @@ bool Renderer::LoadGLSLShader(const char* vertexFile, const char* fragmentFile,
 
 void Renderer::BeginGLSLShader(unsigned int shaderID)
 {
-	m_shaders[shaderID]->begin();
+	m_activeShader = shaderID;
+
+	if (m_stateCache.SetShaderProgram(m_shaders[shaderID]->GetProgramObject()))
+	{
+		m_shaders[shaderID]->begin();
+	}
 }
 
 void Renderer::EndGLSLShader(unsigned int shaderID)
 {
-	m_shaders[shaderID]->end();
+	m_activeShader = -1;
+
+	if (m_stateCache.SetShaderProgram(0))
+	{
+		m_shaders[shaderID]->end();
+	}
 }
 
 glShader* Renderer::GetShader(unsigned int shaderID)
@@ -46,7 +46,28 @@ using namespace tthread;
 #include "material.h"
 #include "light.h"
 #include "framebuffer.h"
+#include "gputimer.h"
+#include "texturebuffer.h"
+#include "resourceregistry.h"
+#include "texturestreamer.h"
+#include "textureatlas.h"
+#include "renderstatecache.h"
+#include "drawlist.h"
 
+#include <map>
+#include <string>
+
+
+// Called on the main thread once a streamed texture has been uploaded, or has failed to load
+typedef void(*TextureStreamedCallback)(unsigned int textureId, void *pData);
+
+class TextureStreamCallback
+{
+public:
+	unsigned int m_textureId;
+	TextureStreamedCallback m_callback;
+	void *m_pData;
+};
 
 enum ProjectionMode
 {
@@ -173,6 +194,9 @@ public:
 	bool CreateViewport(int bottom, int left, int width, int height, float fov, unsigned int *pID);
 	bool ResizeViewport(unsigned int viewportid, int bottom, int left, int width, int height, float fov);
 	int GetActiveViewPort();
+	float GetViewportFov(unsigned int viewportid);
+	float GetClipNear();
+	float GetClipFar();
 
 	// Render modes
 	void SetRenderMode(RenderMode mode);
@@ -218,6 +242,12 @@ public:
 	void PushTextureMatrix();
 	void PopTextureMatrix();
 
+	// Cached transforms, draws placed from world matrices that are already composed instead of built up on the matrix stack.
+	// The world matrices replace the model matrix that was current when the cached transforms began
+	void BeginCachedTransforms();
+	void LoadCachedTransform(const Matrix4x4 &worldMatrix);
+	void EndCachedTransforms();
+
 	// Scissor testing
 	void EnableScissorTest(int x, int y, int width, int height);
 	void DisableScissorTest();
@@ -313,11 +343,25 @@ public:
 	void PrepareShaderTexture(unsigned int textureIndex, unsigned int textureId);
 	void EmptyTextureIndex(unsigned int textureIndex);
 	void DisableTexture();
+	void SetActiveTextureUnit(unsigned int textureIndex);
 	Texture* GetTexture(unsigned int id);
 	void BindRawTextureId(unsigned int textureId);
 	void GenerateEmptyTexture(unsigned int *pID);
 	void SetTextureData(unsigned int id, int width, int height, unsigned char *texdata);
 
+	// Texture streaming
+	bool RequestTexture(string filename, TextureStreamedCallback callback, void *pData, unsigned int *pID);
+	void CancelTextureCallbacks(void *pData);
+	bool IsTextureStreaming(unsigned int id);
+	int GetNumStreamingTextures();
+	void SetTextureStreamingBudget(int bytesPerFrame);
+	int GetTextureStreamingBudget();
+	void UpdateTextureStreaming();
+
+	// Texture atlases, the rects can be used straight away while the frames stream in behind the placeholder
+	bool LoadTextureAtlas(string name, const vector<string>& fileNames, unsigned int *pID);
+	bool GetTextureAtlasRect(unsigned int id, string fileName, TextureAtlasRect *pRect);
+
 	// Cube textures
 	bool LoadCubeTexture(int *width, int *height, string front, string back, string top, string bottom, string left, string right, unsigned int *pID);
 	void BindCubeTexture(unsigned int id);
@@ -326,13 +370,19 @@ public:
 
 	// Vertex buffers
 	bool CreateStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices, unsigned int *pID);
+	bool QueueStaticBuffer(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices, unsigned int *pID);
 	bool RecreateStaticBuffer(unsigned int ID, VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices);
 	void DeleteStaticBuffer(unsigned int id);
 	bool RenderStaticBuffer(unsigned int id);
 	bool RenderStaticBuffer_NoColour(unsigned int id);
+	bool RenderStaticBuffer_DepthOnly(unsigned int id);
 	bool RenderFromArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices);
 	unsigned int GetStride(VertexType type);
 
+	// Streamed vertex buffers, refilled every time they are drawn. Each vertex is position, colour and texture coordinate, drawn as quads
+	bool CreateStreamBuffer(unsigned int *pID);
+	bool RenderStreamBuffer(unsigned int id, unsigned int textureID, int nVerts, const float *pVerts);
+
 	// Mesh
 	OpenGLTriangleMesh* CreateMesh(OGLMeshType meshType);
 	void ClearMesh(OpenGLTriangleMesh* pMesh);
@@ -350,6 +400,16 @@ public:
 	void EndMeshRender();
 	bool MeshStaticBufferRender(OpenGLTriangleMesh* pMesh);
 
+	// Depth only rendering, static buffers are drawn from their position stream without colours, normals, materials or textures
+	void StartDepthOnlyRender();
+	void EndDepthOnlyRender();
+	bool IsDepthOnlyRender();
+
+	// Draw list, while recording the mesh renders are kept back and submitted sorted by state
+	void BeginDrawList();
+	void EndDrawList();
+	bool IsRecordingDrawList();
+
 	// Name rendering and name picking
 	void InitNameStack();
 	void LoadNameOntoStack(int lName);
@@ -362,6 +422,8 @@ public:
 	int PointInFrustum(unsigned int frustumid, const vec3 &point);
 	int SphereInFrustum(unsigned int frustumid, const vec3 &point, float radius);
 	int CubeInFrustum(unsigned int frustumid, const vec3 &center, float x, float y, float z);
+	float GetProjectedSize(const vec3 &position, float size);
+	static float GetProjectedSize(float size, float distance, float fov, int viewportHeight);
 
 	// Frame buffers
 	bool CreateFrameBuffer(int idToResetup, bool diffuse, bool position, bool normal, bool depth, int width, int height, float viewportScale, string name, unsigned int *pId);
@@ -371,15 +433,41 @@ public:
 	int GetFrameBufferIndex(string name);
 	void StartRenderingToFrameBuffer(unsigned int frameBufferId);
 	void StopRenderingToFrameBuffer(unsigned int frameBufferId);
+	void CopyFrameBufferDepth(unsigned int sourceFrameBufferId, unsigned int destinationFrameBufferId);
 	unsigned int GetDiffuseTextureFromFrameBuffer(unsigned int frameBufferId);
 	unsigned int GetPositionTextureFromFrameBuffer(unsigned int frameBufferId);
 	unsigned int GetNormalTextureFromFrameBuffer(unsigned int frameBufferId);
 	unsigned int GetDepthTextureFromFrameBuffer(unsigned int frameBufferId);
 
+	// Full screen passes, drawn as one cached triangle that covers the whole of clip space
+	void RenderFullScreenTriangle();
+
+	// Render target pool
+	bool CreateRenderTarget(const RenderTargetDesc& desc, int firstPass, int lastPass, string name, unsigned int *pId);
+	void ResizeRenderTargets(int width, int height);
+
+	// GPU timers
+	bool CreateGPUTimer(string name, unsigned int *pId);
+	void BeginGPUTimer(unsigned int timerId);
+	void EndGPUTimer(unsigned int timerId);
+	float GetGPUTimerMilliseconds(unsigned int timerId);
+
+	// Texture buffers, arrays of floats the shaders read by index. One float a texel, or four when vec4 is set
+	bool CreateTextureBuffer(bool vec4, unsigned int *pId);
+	void UpdateTextureBuffer(unsigned int id, const float *pData, int numFloats);
+	void BindTextureBuffer(unsigned int id);
+
+	// Resources
+	void UpdateResourceRegistries();
+
 	// Rendered information
 	void ResetRenderedStats();
 	int GetNumRenderedVertices();
 	int GetNumRenderedFaces();
+	int GetNumDrawCalls();
+	int GetNumStateChanges();
+	int GetNumRedundantStateChanges();
+	void InvalidateStateCache();
 
 	// Shaders
 	bool LoadGLSLShader(const char* vertexFile, const char* fragmentFile, unsigned int *pID);
@@ -392,6 +480,11 @@ protected:
 
 private:
 	/* Private methods */
+	bool RecordMeshDraw(OpenGLTriangleMesh* pMesh);
+	void SubmitDrawList();
+	VertexArray* BuildVertexArray(VertexType type, unsigned int materialID, unsigned int textureID, int nVerts, int nTextureCoordinates, int nIndices, const void *pVerts, const void *pTextureCoordinates, const unsigned int *pIndices);
+	void StartTextureStreaming();
+	GLuint GetPlaceholderTexture();
 
 public:
 	/* Public members */
@@ -431,31 +524,66 @@ private:
 	// frustum are closely linked (See viewport functions)
 	
 	// Materials
-	vector<Material *> m_materials;
+	ResourceRegistry<Material> m_materials;
 
-	// Textures
-	vector<Texture *> m_textures;
+	// Textures, with the handles of loaded files so each file is only loaded once
+	ResourceRegistry<Texture> m_textures;
+	map<string, unsigned int> m_textureFileNames;
+
+	// Texture streaming, decoded on worker threads and uploaded within a per frame budget. The workers are started by the first request.
+	TextureStreamer m_textureStreamer;
+	vector<TextureStreamCallback> m_vTextureStreamCallbacks;
+	int m_textureStreamingBudget;
+	GLuint m_placeholderTexture;
+
+	// Texture atlases, by the handle of their texture. The name they were loaded with is in m_textureFileNames.
+	map<unsigned int, TextureAtlas*> m_textureAtlases;
 
 	// Lights
 	vector<Light *> m_lights;
 
 	// Fonts
 	vector<FreeTypeFont *> m_freetypeFonts;
+#ifdef VOGUE_HEADLESS
+	// No GL context to build glyph textures with, so only keep the font sizes for approximate text metrics
+	vector<int> m_vHeadlessFontSizes;
+#endif //VOGUE_HEADLESS
 
 	// Vertex arrays, for storing static vertex data
-	vector<VertexArray *> m_vertexArrays;
-	mutex m_vertexArraysMutex;
+	ResourceRegistry<VertexArray> m_vertexArrays;
 
 	// Frame buffers
 	vector<FrameBuffer*> m_vFrameBuffers;
+	GLuint m_fullScreenTriangleBuffer;
+
+	// Streamed vertex buffers
+	vector<GLuint> m_vStreamBuffers;
+
+	// GPU timers
+	vector<GPUTimer*> m_vpGPUTimers;
+
+	// Texture buffers
+	vector<TextureBuffer*> m_vpTextureBuffers;
 
 	// Rendered information
 	int m_numRenderedVertices;
 	int m_numRenderedFaces;
+	int m_numDrawCalls;
+
+	// The GL state last sent, so unchanged state isn't sent again
+	RenderStateCache m_stateCache;
+
+	// Mesh draws recorded between BeginDrawList() and EndDrawList()
+	DrawList m_drawList;
+	bool m_recordingDrawList;
+
+	// Depth only rendering
+	bool m_depthOnlyRender;
 
 	// Shaders
 	glShaderManager ShaderManager;
 	vector<glShader *> m_shaders;
+	int m_activeShader;
 
 	// Matrices
 	Matrix4x4 *m_projection;
@@ -465,6 +593,10 @@ private:
 	// Model stack
 	vector<Matrix4x4> m_modelStack;
 
+	// The view and shadow texture matrices the cached world matrices are loaded onto
+	float m_cachedTransformView[16];
+	float m_cachedTransformTexture[16];
+
 	// Name picking
 	static const int NAME_PICKING_BUFFER = 64;
 	unsigned int m_SelectBuffer[NAME_PICKING_BUFFER];
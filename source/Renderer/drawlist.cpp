@@ -0,0 +1,97 @@
+// ******************************************************************************
+// Filename:  DrawList.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "drawlist.h"
+
+#include <algorithm>
+
+
+bool draw_list_entry_sort(const DrawListEntry& lhs, const DrawListEntry& rhs)
+{
+	if (lhs.m_sortKey != rhs.m_sortKey)
+	{
+		return lhs.m_sortKey < rhs.m_sortKey;
+	}
+
+	return lhs.m_commandIndex < rhs.m_commandIndex;
+}
+
+DrawList::DrawList()
+{
+}
+
+DrawList::~DrawList()
+{
+}
+
+// Sort keys
+unsigned long long DrawList::CreateSortKey(DrawPass pass, unsigned int shaderId, unsigned int textureId, unsigned int materialId, float depth)
+{
+	depth = depth < 0.0f ? 0.0f : (depth > 1.0f ? 1.0f : depth);
+
+	unsigned long long passBits = (unsigned long long)pass & ((1ULL << SORT_KEY_PASS_BITS) - 1);
+	unsigned long long shaderBits = (unsigned long long)shaderId & ((1ULL << SORT_KEY_SHADER_BITS) - 1);
+	unsigned long long textureBits = (unsigned long long)textureId & ((1ULL << SORT_KEY_TEXTURE_BITS) - 1);
+	unsigned long long materialBits = (unsigned long long)materialId & ((1ULL << SORT_KEY_MATERIAL_BITS) - 1);
+	unsigned long long depthBits = (unsigned long long)(depth * (float)((1ULL << SORT_KEY_DEPTH_BITS) - 1));
+
+	const int stateBits = SORT_KEY_SHADER_BITS + SORT_KEY_TEXTURE_BITS + SORT_KEY_MATERIAL_BITS;
+	unsigned long long stateKey = (shaderBits << (SORT_KEY_TEXTURE_BITS + SORT_KEY_MATERIAL_BITS)) | (textureBits << SORT_KEY_MATERIAL_BITS) | materialBits;
+
+	unsigned long long key = passBits << (stateBits + SORT_KEY_DEPTH_BITS);
+	if (pass == DrawPass_Transparent)
+	{
+		// Blending needs the furthest drawn first, the state only breaks ties
+		depthBits = ((1ULL << SORT_KEY_DEPTH_BITS) - 1) - depthBits;
+		key |= (depthBits << stateBits) | stateKey;
+	}
+	else
+	{
+		key |= (stateKey << SORT_KEY_DEPTH_BITS) | depthBits;
+	}
+
+	return key;
+}
+
+// Recording
+void DrawList::Clear()
+{
+	m_vCommands.clear();
+	m_vSortedEntries.clear();
+}
+
+void DrawList::AddCommand(const DrawCommand& command)
+{
+	m_vCommands.push_back(command);
+}
+
+int DrawList::GetNumCommands()
+{
+	return (int)m_vCommands.size();
+}
+
+// Submission order
+void DrawList::Sort()
+{
+	m_vSortedEntries.resize(m_vCommands.size());
+	for (unsigned int i = 0; i < m_vCommands.size(); i++)
+	{
+		m_vSortedEntries[i].m_sortKey = m_vCommands[i].m_sortKey;
+		m_vSortedEntries[i].m_commandIndex = i;
+	}
+
+	sort(m_vSortedEntries.begin(), m_vSortedEntries.end(), draw_list_entry_sort);
+}
+
+const DrawCommand& DrawList::GetSortedCommand(int index)
+{
+	return m_vCommands[m_vSortedEntries[index].m_commandIndex];
+}
@@ -0,0 +1,99 @@
+// ******************************************************************************
+// Filename:  DrawList.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   A list of mesh draws that are recorded during the scene walk and sorted
+//   before they are submitted. Every draw has a 64 bit sort key built from its
+//   pass, shader, texture, material and depth, so draws that share state end
+//   up next to each other. Opaque draws are ordered front to back within the
+//   same state, transparent draws back to front regardless of state.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+enum DrawPass
+{
+	DrawPass_Opaque = 0,
+	DrawPass_Transparent,
+
+	DrawPass_NUM,
+};
+
+// A recorded mesh draw, with the state and matrices it was recorded with
+class DrawCommand
+{
+public:
+	unsigned long long m_sortKey;
+
+	unsigned int m_staticBufferId;
+	unsigned int m_shaderId;
+	unsigned int m_textureId;
+	unsigned int m_materialId;
+	int m_cullMode;
+	DrawPass m_pass;
+
+	float m_modelViewMatrix[16];
+	float m_textureMatrix[16];
+};
+
+class DrawListEntry
+{
+public:
+	unsigned long long m_sortKey;
+	int m_commandIndex;
+};
+
+class DrawList
+{
+public:
+	/* Public methods */
+	DrawList();
+	~DrawList();
+
+	// Sort keys, depth is from 0 at the camera to 1 at the far clip plane
+	static unsigned long long CreateSortKey(DrawPass pass, unsigned int shaderId, unsigned int textureId, unsigned int materialId, float depth);
+
+	// Recording
+	void Clear();
+	void AddCommand(const DrawCommand& command);
+	int GetNumCommands();
+
+	// Submission order
+	void Sort();
+	const DrawCommand& GetSortedCommand(int index);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+	// Bits of the key given to each field, ids are masked down to fit so two ids can share a value
+	static const int SORT_KEY_PASS_BITS = 4;
+	static const int SORT_KEY_SHADER_BITS = 10;
+	static const int SORT_KEY_TEXTURE_BITS = 16;
+	static const int SORT_KEY_MATERIAL_BITS = 12;
+	static const int SORT_KEY_DEPTH_BITS = 22;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<DrawCommand> m_vCommands;
+
+	// Sorted by key, the command index keeps the recorded order for equal keys
+	vector<DrawListEntry> m_vSortedEntries;
+};
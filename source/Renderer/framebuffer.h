@@ -7,6 +7,11 @@
 //   A frame buffer object, used to store the different g-buffer states of a
 //   viewport.
 //
+//   Frame buffers created through the render target pool also keep the
+//   description they were created from, and the range of render passes each
+//   of their users needs them for. Users with the same description whose
+//   pass ranges don't overlap share one frame buffer.
+//
 // Revision History:
 //   Initial Revision - 16/10/15
 //
@@ -15,6 +20,69 @@
 
 #pragma once
 
+enum RenderTargetSizeClass
+{
+	RenderTargetSizeClass_Screen = 0,	// Scaled from the window size, recreated when the window resizes
+	RenderTargetSizeClass_Fixed,		// A fixed size, independent of the window
+};
+
+// What a pooled render target needs, targets with matching descriptions can share a frame buffer
+class RenderTargetDesc
+{
+public:
+	RenderTargetDesc()
+	{
+		m_diffuse = true;
+		m_position = false;
+		m_normal = false;
+		m_depth = false;
+		m_sizeClass = RenderTargetSizeClass_Screen;
+		m_viewportScale = 1.0f;
+		m_width = 0;
+		m_height = 0;
+	}
+
+	bool Matches(const RenderTargetDesc& other) const
+	{
+		if (m_diffuse != other.m_diffuse || m_position != other.m_position || m_normal != other.m_normal || m_depth != other.m_depth)
+		{
+			return false;
+		}
+
+		if (m_sizeClass != other.m_sizeClass)
+		{
+			return false;
+		}
+
+		if (m_sizeClass == RenderTargetSizeClass_Screen)
+		{
+			return m_viewportScale == other.m_viewportScale;
+		}
+
+		return m_width == other.m_width && m_height == other.m_height;
+	}
+
+	// Attachments
+	bool m_diffuse;
+	bool m_position;
+	bool m_normal;
+	bool m_depth;
+
+	// Size
+	RenderTargetSizeClass m_sizeClass;
+	float m_viewportScale;	// Screen sized targets
+	int m_width;			// Fixed size targets
+	int m_height;
+};
+
+// The render passes a render target is written and read in, inclusive
+class RenderTargetLifetime
+{
+public:
+	int m_firstPass;
+	int m_lastPass;
+};
+
 class FrameBuffer
 {
 public:
@@ -27,4 +95,9 @@ public:
 	int m_height;
 	float m_viewportScale;
 	GLuint m_fbo;
+
+	// Render target pool
+	bool m_pooled;
+	RenderTargetDesc m_desc;
+	vector<RenderTargetLifetime> m_vLifetimes;
 };
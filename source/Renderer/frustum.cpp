@@ -17,7 +17,7 @@
 
 Frustum::Frustum()
 {
-	/* Nothing */
+	cameraPosition = vec3(0.0f, 0.0f, 0.0f);
 }
 
 Frustum::~Frustum()
@@ -43,6 +43,8 @@ void Frustum::SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up)
 {
 	vec3 dir, nc, fc, X, Y, Z;
 
+	cameraPosition = pos;
+
 	Z = pos - target;
 	Z = normalize(Z);
 
@@ -72,6 +74,47 @@ void Frustum::SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up)
 	planes[FRUSTUM_FAR] = Plane3D(farTopRight, farTopLeft, farBottomLeft);
 }
 
+// A box shaped frustum, for an orthographic projection such as the shadow map's light view
+void Frustum::SetOrthographicCamera(const vec3 &pos, const vec3 &target, const vec3 &up, float halfWidth, float halfHeight, float nearD, float farD)
+{
+	vec3 X, Y, Z;
+
+	cameraPosition = pos;
+	nearDistance = nearD;
+	farDistance = farD;
+	nearWidth = farWidth = halfWidth;
+	nearHeight = farHeight = halfHeight;
+
+	Z = pos - target;
+	Z = normalize(Z);
+
+	X = cross(up, Z);
+	X = normalize(X);
+
+	Y = cross(Z, X);
+
+	vec3 nc = pos - Z * nearDistance;
+	vec3 fc = pos - Z * farDistance;
+
+	nearTopLeft = nc + Y * halfHeight - X * halfWidth;
+	nearTopRight = nc + Y * halfHeight + X * halfWidth;
+	nearBottomLeft = nc - Y * halfHeight - X * halfWidth;
+	nearBottomRight = nc - Y * halfHeight + X * halfWidth;
+
+	farTopLeft = fc + Y * halfHeight - X * halfWidth;
+	farTopRight = fc + Y * halfHeight + X * halfWidth;
+	farBottomLeft = fc - Y * halfHeight - X * halfWidth;
+	farBottomRight = fc - Y * halfHeight + X * halfWidth;
+
+	// The plane normals point inwards
+	planes[FRUSTUM_TOP] = Plane3D(-Y, nc + Y * halfHeight);
+	planes[FRUSTUM_BOTTOM] = Plane3D(Y, nc - Y * halfHeight);
+	planes[FRUSTUM_LEFT] = Plane3D(X, nc - X * halfWidth);
+	planes[FRUSTUM_RIGHT] = Plane3D(-X, nc + X * halfWidth);
+	planes[FRUSTUM_NEAR] = Plane3D(-Z, nc);
+	planes[FRUSTUM_FAR] = Plane3D(Z, fc);
+}
+
 int Frustum::PointInFrustum(const vec3 &point)
 {
 	int result = FRUSTUM_INSIDE;
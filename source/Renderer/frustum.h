@@ -27,6 +27,7 @@ public:
 
 	void SetFrustum(float angle, float ratio, float nearD, float farD);
 	void SetCamera(const vec3 &pos, const vec3 &target, const vec3 &up);
+	void SetOrthographicCamera(const vec3 &pos, const vec3 &target, const vec3 &up, float halfWidth, float halfHeight, float nearD, float farD);
 
 	int PointInFrustum(const vec3 &point);
 	int SphereInFrustum(const vec3 &point, float radius);
@@ -57,4 +58,6 @@ public:
 	float nearWidth, nearHeight;
 	float farWidth, farHeight;
 	float ratio, angle, tang;
+
+	vec3 cameraPosition;
 };
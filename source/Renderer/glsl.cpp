@@ -107,6 +107,11 @@ const char* aGLSLStrings[] = {
 //----------------------------------------------------------------------------- 
    bool InitOpenGLExtensions(void)
    {
+#ifdef VOGUE_HEADLESS
+      // No GL context to load the extensions from when running headless
+      return false;
+#endif //VOGUE_HEADLESS
+
       if (extensions_init) return true;
       extensions_init = true;
 
@@ -0,0 +1,28 @@
+// ******************************************************************************
+// Filename:  gputimer.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   A GPU timer, measures how long the GPU spends on the commands between
+//   its begin and end with timer queries. Each timer alternates between two
+//   queries, so the result that is read back is from an earlier frame and
+//   reading it never stalls waiting for the GPU to catch up.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+class GPUTimer
+{
+public:
+	string m_name;
+	GLuint m_queries[2];
+	bool m_queryIssued[2];
+	int m_currentQuery;
+	float m_milliseconds;
+};
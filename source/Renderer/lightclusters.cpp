@@ -0,0 +1,307 @@
+// ******************************************************************************
+// Filename:  LightClusters.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "lightclusters.h"
+
+#include <math.h>
+
+
+LightClusters::LightClusters()
+{
+	m_numLights = 0;
+	m_numDroppedLights = 0;
+	m_maxClusterLights = 0;
+
+	m_vLightData.resize(LIGHT_CLUSTERS_MAX_LIGHTS * LIGHT_CLUSTERS_LIGHT_FLOATS, 0.0f);
+	m_vClusterData.resize(LIGHT_CLUSTERS_NUM * 2, 0.0f);
+	m_vClusterCounts.resize(LIGHT_CLUSTERS_NUM, 0);
+
+	SetProjection(60.0f, 4.0f / 3.0f, 0.1f, 100.0f);
+}
+
+LightClusters::~LightClusters()
+{
+}
+
+// Setup
+void LightClusters::SetProjection(float fov, float aspect, float nearZ, float farZ)
+{
+	m_nearZ = nearZ;
+	m_farZ = farZ;
+
+	float depthRatio = log(m_farZ / m_nearZ);
+	m_sliceScale = LIGHT_CLUSTERS_Z / depthRatio;
+	m_sliceBias = -LIGHT_CLUSTERS_Z * log(m_nearZ) / depthRatio;
+
+	float tanY = tan(DegToRad(fov * 0.5f));
+	float tanX = tanY * aspect;
+
+	for (int z = 0; z < LIGHT_CLUSTERS_Z; z++)
+	{
+		float sliceNear = m_nearZ * pow(m_farZ / m_nearZ, (float)z / LIGHT_CLUSTERS_Z);
+		float sliceFar = m_nearZ * pow(m_farZ / m_nearZ, (float)(z + 1) / LIGHT_CLUSTERS_Z);
+
+		for (int y = 0; y < LIGHT_CLUSTERS_Y; y++)
+		{
+			float bottom = (-1.0f + (2.0f * y) / LIGHT_CLUSTERS_Y) * tanY;
+			float top = (-1.0f + (2.0f * (y + 1)) / LIGHT_CLUSTERS_Y) * tanY;
+
+			for (int x = 0; x < LIGHT_CLUSTERS_X; x++)
+			{
+				float left = (-1.0f + (2.0f * x) / LIGHT_CLUSTERS_X) * tanX;
+				float right = (-1.0f + (2.0f * (x + 1)) / LIGHT_CLUSTERS_X) * tanX;
+
+				// The widest point of a side is at the near or the far end of the slice, depending which side of the centre it is
+				int index = GetClusterIndex(x, y, z);
+				m_clusterMin[index] = vec3(left < 0.0f ? left * sliceFar : left * sliceNear, bottom < 0.0f ? bottom * sliceFar : bottom * sliceNear, -sliceFar);
+				m_clusterMax[index] = vec3(right > 0.0f ? right * sliceFar : right * sliceNear, top > 0.0f ? top * sliceFar : top * sliceNear, -sliceNear);
+			}
+		}
+	}
+}
+
+void LightClusters::SetView(const Matrix4x4& viewMatrix)
+{
+	m_viewMatrix = viewMatrix;
+}
+
+// Lights
+void LightClusters::ClearLights()
+{
+	m_numLights = 0;
+	m_numDroppedLights = 0;
+}
+
+bool LightClusters::AddLight(vec3 position, float radius, Colour colour, float intensity)
+{
+	if (m_numLights >= LIGHT_CLUSTERS_MAX_LIGHTS)
+	{
+		m_numDroppedLights++;
+		return false;
+	}
+
+	vec3 viewPosition = m_viewMatrix * position;
+
+	float* pLight = &m_vLightData[m_numLights * LIGHT_CLUSTERS_LIGHT_FLOATS];
+	pLight[0] = viewPosition.x;
+	pLight[1] = viewPosition.y;
+	pLight[2] = viewPosition.z;
+	pLight[3] = radius;
+	pLight[4] = colour.GetRed();
+	pLight[5] = colour.GetGreen();
+	pLight[6] = colour.GetBlue();
+	pLight[7] = intensity;
+
+	m_numLights++;
+
+	return true;
+}
+
+// Binning
+void LightClusters::Build()
+{
+	m_vClusterLightPairs.clear();
+	for (int i = 0; i < LIGHT_CLUSTERS_NUM; i++)
+	{
+		m_vClusterCounts[i] = 0;
+	}
+
+	for (int i = 0; i < m_numLights; i++)
+	{
+		vec3 centre = GetLightViewPosition(i);
+		float radius = GetLightRadius(i);
+
+		// Only the slices the light reaches
+		float depth = -centre.z;
+		if (depth + radius < m_nearZ || depth - radius > m_farZ)
+		{
+			continue;
+		}
+		// One slice either side, so rounding at a slice boundary is left to the exact test
+		int sliceStart = GetSlice(depth - radius > m_nearZ ? depth - radius : m_nearZ) - 1;
+		int sliceEnd = GetSlice(depth + radius < m_farZ ? depth + radius : m_farZ) + 1;
+		sliceStart = sliceStart > 0 ? sliceStart : 0;
+		sliceEnd = sliceEnd < LIGHT_CLUSTERS_Z - 1 ? sliceEnd : LIGHT_CLUSTERS_Z - 1;
+
+		for (int z = sliceStart; z <= sliceEnd; z++)
+		{
+			// Narrow down to the columns and rows whose bounds overlap the light's, then test the clusters properly
+			int xStart = 0;
+			while (xStart < LIGHT_CLUSTERS_X && m_clusterMax[GetClusterIndex(xStart, 0, z)].x < centre.x - radius)
+			{
+				xStart++;
+			}
+			int xEnd = LIGHT_CLUSTERS_X - 1;
+			while (xEnd >= xStart && m_clusterMin[GetClusterIndex(xEnd, 0, z)].x > centre.x + radius)
+			{
+				xEnd--;
+			}
+			int yStart = 0;
+			while (yStart < LIGHT_CLUSTERS_Y && m_clusterMax[GetClusterIndex(0, yStart, z)].y < centre.y - radius)
+			{
+				yStart++;
+			}
+			int yEnd = LIGHT_CLUSTERS_Y - 1;
+			while (yEnd >= yStart && m_clusterMin[GetClusterIndex(0, yEnd, z)].y > centre.y + radius)
+			{
+				yEnd--;
+			}
+
+			for (int y = yStart; y <= yEnd; y++)
+			{
+				for (int x = xStart; x <= xEnd; x++)
+				{
+					int clusterIndex = GetClusterIndex(x, y, z);
+					if (LightIntersectsCluster(i, clusterIndex))
+					{
+						m_vClusterLightPairs.push_back(clusterIndex);
+						m_vClusterLightPairs.push_back(i);
+						m_vClusterCounts[clusterIndex]++;
+					}
+				}
+			}
+		}
+	}
+
+	// Each cluster's lights are stored together, in the order the lights were added
+	int offset = 0;
+	m_maxClusterLights = 0;
+	for (int i = 0; i < LIGHT_CLUSTERS_NUM; i++)
+	{
+		m_vClusterData[i * 2] = (float)offset;
+		m_vClusterData[i * 2 + 1] = 0.0f;
+		offset += m_vClusterCounts[i];
+
+		m_maxClusterLights = m_vClusterCounts[i] > m_maxClusterLights ? m_vClusterCounts[i] : m_maxClusterLights;
+	}
+
+	m_vLightIndices.resize(offset);
+	for (unsigned int i = 0; i < m_vClusterLightPairs.size(); i += 2)
+	{
+		int clusterIndex = m_vClusterLightPairs[i];
+		int index = (int)m_vClusterData[clusterIndex * 2] + (int)m_vClusterData[clusterIndex * 2 + 1];
+		m_vLightIndices[index] = (float)m_vClusterLightPairs[i + 1];
+		m_vClusterData[clusterIndex * 2 + 1] += 1.0f;
+	}
+}
+
+// Accessors
+int LightClusters::GetNumLights()
+{
+	return m_numLights;
+}
+
+int LightClusters::GetNumDroppedLights()
+{
+	return m_numDroppedLights;
+}
+
+int LightClusters::GetNumLightIndices()
+{
+	return (int)m_vLightIndices.size();
+}
+
+int LightClusters::GetMaxClusterLights()
+{
+	return m_maxClusterLights;
+}
+
+int LightClusters::GetClusterIndex(int x, int y, int z)
+{
+	return x + (y * LIGHT_CLUSTERS_X) + (z * LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y);
+}
+
+int LightClusters::GetClusterNumLights(int clusterIndex)
+{
+	return (int)m_vClusterData[clusterIndex * 2 + 1];
+}
+
+int LightClusters::GetClusterLight(int clusterIndex, int index)
+{
+	return (int)m_vLightIndices[(int)m_vClusterData[clusterIndex * 2] + index];
+}
+
+void LightClusters::GetClusterBounds(int clusterIndex, vec3* pMin, vec3* pMax)
+{
+	*pMin = m_clusterMin[clusterIndex];
+	*pMax = m_clusterMax[clusterIndex];
+}
+
+vec3 LightClusters::GetLightViewPosition(int lightIndex)
+{
+	const float* pLight = &m_vLightData[lightIndex * LIGHT_CLUSTERS_LIGHT_FLOATS];
+	return vec3(pLight[0], pLight[1], pLight[2]);
+}
+
+float LightClusters::GetLightRadius(int lightIndex)
+{
+	return m_vLightData[lightIndex * LIGHT_CLUSTERS_LIGHT_FLOATS + 3];
+}
+
+// Sphere against the cluster's box, from the closest point of the box to the light
+bool LightClusters::LightIntersectsCluster(int lightIndex, int clusterIndex)
+{
+	vec3 centre = GetLightViewPosition(lightIndex);
+	float radius = GetLightRadius(lightIndex);
+	const vec3& boxMin = m_clusterMin[clusterIndex];
+	const vec3& boxMax = m_clusterMax[clusterIndex];
+
+	float distanceSquared = 0.0f;
+	for (int axis = 0; axis < 3; axis++)
+	{
+		if (centre[axis] < boxMin[axis])
+		{
+			distanceSquared += (boxMin[axis] - centre[axis]) * (boxMin[axis] - centre[axis]);
+		}
+		else if (centre[axis] > boxMax[axis])
+		{
+			distanceSquared += (centre[axis] - boxMax[axis]) * (centre[axis] - boxMax[axis]);
+		}
+	}
+
+	return distanceSquared <= radius * radius;
+}
+
+// Shader values
+float LightClusters::GetSliceScale()
+{
+	return m_sliceScale;
+}
+
+float LightClusters::GetSliceBias()
+{
+	return m_sliceBias;
+}
+
+// The arrays for the texture buffers
+const float* LightClusters::GetLightData()
+{
+	return &m_vLightData[0];
+}
+
+const float* LightClusters::GetClusterData()
+{
+	return &m_vClusterData[0];
+}
+
+const float* LightClusters::GetLightIndices()
+{
+	return m_vLightIndices.empty() ? NULL : &m_vLightIndices[0];
+}
+
+int LightClusters::GetSlice(float depth)
+{
+	int slice = (int)floor(log(depth) * m_sliceScale + m_sliceBias);
+	slice = slice > 0 ? slice : 0;
+	slice = slice < LIGHT_CLUSTERS_Z - 1 ? slice : LIGHT_CLUSTERS_Z - 1;
+
+	return slice;
+}
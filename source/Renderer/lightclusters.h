@@ -0,0 +1,120 @@
+// ******************************************************************************
+// Filename:  LightClusters.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   Bins the dynamic point lights into clusters of the view frustum, a grid
+//   of screen tiles split into slices along the view depth. The slices get
+//   deeper exponentially, so the clusters close to the camera stay small.
+//   The lit shader works out which cluster a fragment is in and only loops
+//   over the lights in that cluster, so the number of lights isn't limited
+//   by the fixed function light slots. Everything here is done on the CPU,
+//   the renderer just uploads the finished arrays as texture buffers.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Maths/3dmaths.h"
+#include "colour.h"
+
+#include <vector>
+using namespace std;
+
+// The cluster grid, screen tiles across and up, and depth slices
+const int LIGHT_CLUSTERS_X = 16;
+const int LIGHT_CLUSTERS_Y = 9;
+const int LIGHT_CLUSTERS_Z = 24;
+const int LIGHT_CLUSTERS_NUM = LIGHT_CLUSTERS_X * LIGHT_CLUSTERS_Y * LIGHT_CLUSTERS_Z;
+
+// The most lights that can be binned in a frame, any more are dropped
+const int LIGHT_CLUSTERS_MAX_LIGHTS = 1024;
+
+// View position and radius, then colour and intensity
+const int LIGHT_CLUSTERS_LIGHT_FLOATS = 8;
+
+class LightClusters
+{
+public:
+	/* Public methods */
+	LightClusters();
+	~LightClusters();
+
+	// Setup, the bounds of every cluster only change with the projection
+	void SetProjection(float fov, float aspect, float nearZ, float farZ);
+	void SetView(const Matrix4x4& viewMatrix);
+
+	// Lights, in world space
+	void ClearLights();
+	bool AddLight(vec3 position, float radius, Colour colour, float intensity);
+
+	// Binning
+	void Build();
+
+	// Accessors
+	int GetNumLights();
+	int GetNumDroppedLights();
+	int GetNumLightIndices();
+	int GetMaxClusterLights();
+	int GetClusterIndex(int x, int y, int z);
+	int GetClusterNumLights(int clusterIndex);
+	int GetClusterLight(int clusterIndex, int index);
+	void GetClusterBounds(int clusterIndex, vec3* pMin, vec3* pMax);
+	vec3 GetLightViewPosition(int lightIndex);
+	float GetLightRadius(int lightIndex);
+	bool LightIntersectsCluster(int lightIndex, int clusterIndex);
+
+	// Shader values, slice = floor(log(depth) * scale + bias)
+	float GetSliceScale();
+	float GetSliceBias();
+
+	// The arrays for the texture buffers
+	const float* GetLightData();
+	const float* GetClusterData();		// Offset into the indices and number of lights, for each cluster
+	const float* GetLightIndices();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	LightClusters(const LightClusters&);
+	LightClusters &operator=(const LightClusters&);
+
+	int GetSlice(float depth);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	float m_nearZ;
+	float m_farZ;
+	float m_sliceScale;
+	float m_sliceBias;
+
+	// Each slice is the same tiles at a different depth, the tile bounds only grow with the index so they can be walked in order
+	vec3 m_clusterMin[LIGHT_CLUSTERS_NUM];
+	vec3 m_clusterMax[LIGHT_CLUSTERS_NUM];
+
+	Matrix4x4 m_viewMatrix;
+
+	int m_numLights;
+	int m_numDroppedLights;
+	vector<float> m_vLightData;
+
+	// Built each frame
+	vector<float> m_vClusterData;
+	vector<float> m_vLightIndices;
+	vector<int> m_vClusterCounts;
+	vector<int> m_vClusterLightPairs;
+	int m_maxClusterLights;
+};
@@ -0,0 +1,144 @@
+// ******************************************************************************
+// Filename:  PostProcessChain.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "postprocesschain.h"
+
+
+PostProcessChain::PostProcessChain()
+{
+}
+
+PostProcessChain::~PostProcessChain()
+{
+}
+
+// Passes
+unsigned int PostProcessChain::AddPass(string name, PostProcessPassType type, float scale)
+{
+	PostProcessPass pass;
+	pass.m_name = name;
+	pass.m_type = type;
+	pass.m_scale = scale;
+	pass.m_enabled = true;
+	pass.m_run = true;
+	pass.m_fusedInto = -1;
+
+	m_vPasses.push_back(pass);
+
+	return (int)m_vPasses.size() - 1;
+}
+
+void PostProcessChain::SetPassEnabled(unsigned int passId, bool enabled)
+{
+	m_vPasses[passId].m_enabled = enabled;
+}
+
+void PostProcessChain::Build()
+{
+	for (unsigned int i = 0; i < m_vPasses.size(); i++)
+	{
+		m_vPasses[i].m_run = m_vPasses[i].m_enabled;
+		m_vPasses[i].m_fusedInto = -1;
+	}
+
+	for (unsigned int i = 0; i < m_vPasses.size(); i++)
+	{
+		if (m_vPasses[i].m_run == false || m_vPasses[i].m_type != PostProcessPassType_Antialiasing)
+		{
+			continue;
+		}
+
+		// Find the previous pass that runs, if it is the composite then this pass is run as part of it
+		for (int j = (int)i - 1; j >= 0; j--)
+		{
+			if (m_vPasses[j].m_run == false)
+			{
+				continue;
+			}
+
+			if (m_vPasses[j].m_type == PostProcessPassType_Composite && m_vPasses[j].m_scale == m_vPasses[i].m_scale)
+			{
+				m_vPasses[i].m_run = false;
+				m_vPasses[i].m_fusedInto = j;
+			}
+
+			break;
+		}
+	}
+}
+
+int PostProcessChain::GetNumPasses()
+{
+	return (int)m_vPasses.size();
+}
+
+string PostProcessChain::GetPassName(unsigned int passId)
+{
+	return m_vPasses[passId].m_name;
+}
+
+bool PostProcessChain::IsPassEnabled(unsigned int passId)
+{
+	return m_vPasses[passId].m_enabled;
+}
+
+bool PostProcessChain::IsPassRun(unsigned int passId)
+{
+	return m_vPasses[passId].m_run;
+}
+
+int PostProcessChain::GetFusedInto(unsigned int passId)
+{
+	return m_vPasses[passId].m_fusedInto;
+}
+
+int PostProcessChain::GetNumRunPasses()
+{
+	int numRunPasses = 0;
+	for (unsigned int i = 0; i < m_vPasses.size(); i++)
+	{
+		if (m_vPasses[i].m_run)
+		{
+			numRunPasses++;
+		}
+	}
+
+	return numRunPasses;
+}
+
+// Screen sized writes
+float PostProcessChain::GetScreenWrites()
+{
+	float screenWrites = 0.0f;
+	for (unsigned int i = 0; i < m_vPasses.size(); i++)
+	{
+		if (m_vPasses[i].m_run)
+		{
+			screenWrites += m_vPasses[i].m_scale * m_vPasses[i].m_scale;
+		}
+	}
+
+	return screenWrites;
+}
+
+float PostProcessChain::GetUnfusedScreenWrites()
+{
+	float screenWrites = 0.0f;
+	for (unsigned int i = 0; i < m_vPasses.size(); i++)
+	{
+		if (m_vPasses[i].m_enabled)
+		{
+			screenWrites += m_vPasses[i].m_scale * m_vPasses[i].m_scale;
+		}
+	}
+
+	return screenWrites;
+}
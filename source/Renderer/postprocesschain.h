@@ -0,0 +1,88 @@
+// ******************************************************************************
+// Filename:  PostProcessChain.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   The full screen post processing passes of a frame, in the order they
+//   run, and which of them actually need to run. An antialiasing pass that
+//   directly follows the composite is folded into it, the composite shader
+//   runs the antialiasing filter on its own output so the composited image
+//   is never written out and read back. Passes can run at a fraction of the
+//   screen resolution, and the chain keeps count of how much of the screen
+//   is written each frame.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+#include <string>
+using namespace std;
+
+enum PostProcessPassType
+{
+	PostProcessPassType_Default = 0,
+	PostProcessPassType_Composite,
+	PostProcessPassType_Antialiasing,
+	PostProcessPassType_Blur,
+};
+
+class PostProcessPass
+{
+public:
+	string m_name;
+	PostProcessPassType m_type;
+	float m_scale;		// Resolution, relative to the screen
+	bool m_enabled;
+
+	// Worked out by Build()
+	bool m_run;
+	int m_fusedInto;	// The pass this one is run as part of, -1 when it isn't fused
+};
+
+class PostProcessChain
+{
+public:
+	/* Public methods */
+	PostProcessChain();
+	~PostProcessChain();
+
+	// Passes, added in the order they run
+	unsigned int AddPass(string name, PostProcessPassType type, float scale);
+	void SetPassEnabled(unsigned int passId, bool enabled);
+
+	// Works out which of the enabled passes run
+	void Build();
+
+	int GetNumPasses();
+	string GetPassName(unsigned int passId);
+	bool IsPassEnabled(unsigned int passId);
+	bool IsPassRun(unsigned int passId);
+	int GetFusedInto(unsigned int passId);
+	int GetNumRunPasses();
+
+	// Screen sized writes per frame, a half resolution pass writes a quarter of a screen
+	float GetScreenWrites();
+	float GetUnfusedScreenWrites();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<PostProcessPass> m_vPasses;
+};
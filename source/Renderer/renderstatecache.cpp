@@ -0,0 +1,190 @@
+// ******************************************************************************
+// Filename:  RenderStateCache.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "renderstatecache.h"
+
+
+RenderStateCache::RenderStateCache()
+{
+	Invalidate();
+	ResetCounters();
+}
+
+RenderStateCache::~RenderStateCache()
+{
+}
+
+// Invalidation
+void RenderStateCache::Invalidate()
+{
+	m_cullMode = RENDER_STATE_UNKNOWN;
+
+	m_blend = RENDER_STATE_UNKNOWN;
+	m_blendSource = RENDER_STATE_UNKNOWN;
+	m_blendDestination = RENDER_STATE_UNKNOWN;
+
+	m_depthTest = RENDER_STATE_UNKNOWN;
+	m_depthFunction = RENDER_STATE_UNKNOWN;
+	m_depthWrite = RENDER_STATE_UNKNOWN;
+
+	m_shaderProgram = RENDER_STATE_UNKNOWN;
+
+	InvalidateMaterial();
+	InvalidateTextures();
+}
+
+void RenderStateCache::InvalidateTextures()
+{
+	m_activeTextureUnit = RENDER_STATE_UNKNOWN;
+
+	for (int i = 0; i < RENDER_STATE_TEXTURE_UNITS; i++)
+	{
+		m_texture2D[i] = RENDER_STATE_UNKNOWN;
+		m_texture[i] = RENDER_STATE_UNKNOWN;
+	}
+}
+
+void RenderStateCache::InvalidateMaterial()
+{
+	m_material = RENDER_STATE_UNKNOWN;
+}
+
+// Rasterizer
+bool RenderStateCache::SetCullMode(int cullMode)
+{
+	return Change(&m_cullMode, cullMode);
+}
+
+// Blending
+bool RenderStateCache::SetBlend(bool enabled)
+{
+	return Change(&m_blend, enabled ? 1 : 0);
+}
+
+bool RenderStateCache::SetBlendFunction(int source, int destination)
+{
+	if (m_blendSource == source && m_blendDestination == destination && source != RENDER_STATE_UNKNOWN)
+	{
+		m_numRedundantStateChanges++;
+		return false;
+	}
+
+	m_blendSource = source;
+	m_blendDestination = destination;
+	m_numStateChanges++;
+
+	return true;
+}
+
+bool RenderStateCache::IsBlendEnabled()
+{
+	return m_blend == 1;
+}
+
+// Depth
+bool RenderStateCache::SetDepthTest(bool enabled)
+{
+	return Change(&m_depthTest, enabled ? 1 : 0);
+}
+
+bool RenderStateCache::SetDepthFunction(int function)
+{
+	return Change(&m_depthFunction, function);
+}
+
+bool RenderStateCache::SetDepthWrite(bool enabled)
+{
+	return Change(&m_depthWrite, enabled ? 1 : 0);
+}
+
+// Material and shader
+bool RenderStateCache::SetMaterial(unsigned int materialId)
+{
+	return Change(&m_material, (int)materialId);
+}
+
+bool RenderStateCache::SetShaderProgram(unsigned int program)
+{
+	return Change(&m_shaderProgram, (int)program);
+}
+
+unsigned int RenderStateCache::GetMaterial()
+{
+	return (unsigned int)m_material;
+}
+
+// Textures
+bool RenderStateCache::SetActiveTextureUnit(int unit)
+{
+	if (unit < 0 || unit >= RENDER_STATE_TEXTURE_UNITS)
+	{
+		// Not shadowed, and the bindings can't be trusted until a shadowed unit is made active again
+		m_activeTextureUnit = RENDER_STATE_UNKNOWN;
+		m_numStateChanges++;
+
+		return true;
+	}
+
+	return Change(&m_activeTextureUnit, unit);
+}
+
+bool RenderStateCache::SetTexture2D(bool enabled)
+{
+	if (m_activeTextureUnit == RENDER_STATE_UNKNOWN)
+	{
+		m_numStateChanges++;
+		return true;
+	}
+
+	return Change(&m_texture2D[m_activeTextureUnit], enabled ? 1 : 0);
+}
+
+bool RenderStateCache::SetTexture(unsigned int textureId)
+{
+	if (m_activeTextureUnit == RENDER_STATE_UNKNOWN)
+	{
+		m_numStateChanges++;
+		return true;
+	}
+
+	return Change(&m_texture[m_activeTextureUnit], (int)textureId);
+}
+
+// Counters
+void RenderStateCache::ResetCounters()
+{
+	m_numStateChanges = 0;
+	m_numRedundantStateChanges = 0;
+}
+
+int RenderStateCache::GetNumStateChanges()
+{
+	return m_numStateChanges;
+}
+
+int RenderStateCache::GetNumRedundantStateChanges()
+{
+	return m_numRedundantStateChanges;
+}
+
+bool RenderStateCache::Change(int* pCurrent, int value)
+{
+	if (*pCurrent == value && value != RENDER_STATE_UNKNOWN)
+	{
+		m_numRedundantStateChanges++;
+		return false;
+	}
+
+	*pCurrent = value;
+	m_numStateChanges++;
+
+	return true;
+}
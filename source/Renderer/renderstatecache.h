@@ -0,0 +1,102 @@
+// ******************************************************************************
+// Filename:  RenderStateCache.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   A shadow copy of the GL state that the renderer changes the most. Each
+//   Set function compares against the last value that was sent and returns
+//   true only when it is different, so the renderer can drop the redundant
+//   GL calls. Anything that drives GL directly has to invalidate the cache,
+//   after which the next change of each state is always sent.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+// Texture units that have their bindings shadowed
+const int RENDER_STATE_TEXTURE_UNITS = 8;
+
+// Value of a state that isn't known, the next change to it is always sent
+const int RENDER_STATE_UNKNOWN = -1;
+
+class RenderStateCache
+{
+public:
+	/* Public methods */
+	RenderStateCache();
+	~RenderStateCache();
+
+	// Invalidation
+	void Invalidate();
+	void InvalidateTextures();
+	void InvalidateMaterial();
+
+	// Rasterizer
+	bool SetCullMode(int cullMode);
+
+	// Blending
+	bool SetBlend(bool enabled);
+	bool SetBlendFunction(int source, int destination);
+	bool IsBlendEnabled();
+
+	// Depth
+	bool SetDepthTest(bool enabled);
+	bool SetDepthFunction(int function);
+	bool SetDepthWrite(bool enabled);
+
+	// Material and shader
+	bool SetMaterial(unsigned int materialId);
+	bool SetShaderProgram(unsigned int program);
+	unsigned int GetMaterial();
+
+	// Textures, the enable and binding are for the active unit
+	bool SetActiveTextureUnit(int unit);
+	bool SetTexture2D(bool enabled);
+	bool SetTexture(unsigned int textureId);
+
+	// Counters
+	void ResetCounters();
+	int GetNumStateChanges();
+	int GetNumRedundantStateChanges();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	bool Change(int* pCurrent, int value);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	int m_cullMode;
+
+	int m_blend;
+	int m_blendSource;
+	int m_blendDestination;
+
+	int m_depthTest;
+	int m_depthFunction;
+	int m_depthWrite;
+
+	int m_material;
+	int m_shaderProgram;
+
+	int m_activeTextureUnit;
+	int m_texture2D[RENDER_STATE_TEXTURE_UNITS];
+	int m_texture[RENDER_STATE_TEXTURE_UNITS];
+
+	// Since the last reset, the changes that were sent and the ones that were dropped
+	int m_numStateChanges;
+	int m_numRedundantStateChanges;
+};
@@ -0,0 +1,349 @@
+// ******************************************************************************
+// Filename:  ResourceRegistry.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   A generational slot map for render resources (vertex arrays, textures,
+//   materials). Resources are referred to by a handle that packs the slot
+//   index with the slot's generation, so a stale handle to a deleted or
+//   replaced resource is detected instead of indexing a reused slot.
+//
+//   Slots live in fixed size pages that are never moved, so looking up a
+//   handle is lock-free and safe while another thread is inserting. Inserts
+//   and removals are serialized with a writer mutex that readers never take.
+//   Removed resources are retired and only deleted in CollectGarbage(), which
+//   the render thread calls once per frame, so a reader that looked a
+//   resource up this frame never sees it freed underneath it.
+//
+//   Loader threads can also queue new resources with QueueInsert(), the
+//   handle is returned straight away but the resource is only published to
+//   readers when the render thread calls PublishQueued().
+//
+//   When every slot is in use the inserts return INVALID_HANDLE and retire
+//   the resource, so it is freed in the next CollectGarbage().
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+using namespace tthread;
+
+
+template <class T>
+class ResourceRegistry
+{
+public:
+	// Handle layout, the low bits are the slot index and the high bits the generation
+	static const unsigned int INDEX_BITS = 20;
+	static const unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static const unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	// Slot paging, the last page is left unused so a valid handle can never be -1
+	static const unsigned int PAGE_SIZE = 1024;
+	static const unsigned int MAX_PAGES = ((INDEX_MASK + 1) / PAGE_SIZE) - 1;
+
+	// Never handed out, the index is past the last usable page so lookups always fail
+	static const unsigned int INVALID_HANDLE = 0xFFFFFFFF;
+
+	ResourceRegistry()
+	{
+		for (unsigned int i = 0; i < MAX_PAGES; i++)
+		{
+			m_pages[i].store(NULL, memory_order_relaxed);
+		}
+		m_numSlots.store(0, memory_order_relaxed);
+		m_numResources = 0;
+	}
+
+	~ResourceRegistry()
+	{
+		Clear();
+
+		for (unsigned int i = 0; i < MAX_PAGES; i++)
+		{
+			delete[] m_pages[i].load(memory_order_relaxed);
+			m_pages[i].store(NULL, memory_order_relaxed);
+		}
+	}
+
+	// Inserts a resource and publishes it to readers straight away
+	unsigned int Insert(T* pResource)
+	{
+		m_writeMutex.lock();
+		unsigned int handle = AllocateSlot();
+		if (handle == INVALID_HANDLE)
+		{
+			m_vpRetired.push_back(pResource);
+		}
+		else
+		{
+			GetSlot(handle & INDEX_MASK)->m_pResource.store(pResource, memory_order_release);
+			m_numResources++;
+		}
+		m_writeMutex.unlock();
+
+		return handle;
+	}
+
+	// Reserves a handle for a resource created off the render thread, it becomes visible after PublishQueued()
+	unsigned int QueueInsert(T* pResource)
+	{
+		m_writeMutex.lock();
+		unsigned int handle = AllocateSlot();
+		if (handle == INVALID_HANDLE)
+		{
+			m_vpRetired.push_back(pResource);
+		}
+		else
+		{
+			m_vQueued.push_back(QueuedResource(handle, pResource));
+		}
+		m_writeMutex.unlock();
+
+		return handle;
+	}
+
+	// Makes any queued resources visible to readers, returns how many were published
+	int PublishQueued()
+	{
+		m_writeMutex.lock();
+		int numPublished = (int)m_vQueued.size();
+		for (unsigned int i = 0; i < m_vQueued.size(); i++)
+		{
+			Slot* pSlot = GetSlot(m_vQueued[i].m_handle & INDEX_MASK);
+
+			// The handle may have been removed again before it was ever published
+			if (pSlot->m_generation.load(memory_order_relaxed) == (m_vQueued[i].m_handle >> INDEX_BITS))
+			{
+				pSlot->m_pResource.store(m_vQueued[i].m_pResource, memory_order_release);
+				m_numResources++;
+			}
+			else
+			{
+				m_vpRetired.push_back(m_vQueued[i].m_pResource);
+			}
+		}
+		m_vQueued.clear();
+		m_writeMutex.unlock();
+
+		return numPublished;
+	}
+
+	// Swaps the resource a handle refers to, keeping the handle valid. The old resource is retired.
+	bool Replace(unsigned int handle, T* pResource)
+	{
+		m_writeMutex.lock();
+		Slot* pSlot = FindSlot(handle);
+		if (pSlot == NULL)
+		{
+			m_writeMutex.unlock();
+			return false;
+		}
+
+		T* pOldResource = pSlot->m_pResource.exchange(pResource, memory_order_acq_rel);
+		if (pOldResource != NULL)
+		{
+			m_vpRetired.push_back(pOldResource);
+		}
+		else
+		{
+			m_numResources++;
+		}
+		m_writeMutex.unlock();
+
+		return true;
+	}
+
+	// Invalidates the handle and retires its resource
+	void Remove(unsigned int handle)
+	{
+		m_writeMutex.lock();
+		Slot* pSlot = FindSlot(handle);
+		if (pSlot == NULL)
+		{
+			m_writeMutex.unlock();
+			return;
+		}
+
+		// Bump the generation first so new lookups fail before the resource goes away
+		pSlot->m_generation.store((pSlot->m_generation.load(memory_order_relaxed) + 1) & GENERATION_MASK, memory_order_release);
+
+		T* pOldResource = pSlot->m_pResource.exchange(NULL, memory_order_acq_rel);
+		if (pOldResource != NULL)
+		{
+			m_vpRetired.push_back(pOldResource);
+			m_numResources--;
+		}
+
+		m_vFreeSlots.push_back(handle & INDEX_MASK);
+		m_writeMutex.unlock();
+	}
+
+	// Lock-free lookup, returns NULL for stale, removed or not yet published handles
+	T* Get(unsigned int handle) const
+	{
+		const Slot* pSlot = FindSlot(handle);
+		if (pSlot == NULL)
+		{
+			return NULL;
+		}
+
+		return pSlot->m_pResource.load(memory_order_acquire);
+	}
+
+	bool IsValid(unsigned int handle) const
+	{
+		return Get(handle) != NULL;
+	}
+
+	int GetNumResources() const
+	{
+		return m_numResources;
+	}
+
+	// Deletes the retired resources, called from the render thread between frames
+	void CollectGarbage()
+	{
+		m_writeMutex.lock();
+		for (unsigned int i = 0; i < m_vpRetired.size(); i++)
+		{
+			delete m_vpRetired[i];
+		}
+		m_vpRetired.clear();
+		m_writeMutex.unlock();
+	}
+
+	// Deletes every resource, all handles become invalid
+	void Clear()
+	{
+		m_writeMutex.lock();
+		unsigned int numSlots = m_numSlots.load(memory_order_relaxed);
+		for (unsigned int i = 0; i < numSlots; i++)
+		{
+			Slot* pSlot = GetSlot(i);
+			T* pResource = pSlot->m_pResource.exchange(NULL, memory_order_acq_rel);
+			if (pResource != NULL)
+			{
+				m_vpRetired.push_back(pResource);
+				pSlot->m_generation.store((pSlot->m_generation.load(memory_order_relaxed) + 1) & GENERATION_MASK, memory_order_release);
+				m_vFreeSlots.push_back(i);
+			}
+		}
+
+		// Queued slots were never published, so the loop above did not free them
+		for (unsigned int i = 0; i < m_vQueued.size(); i++)
+		{
+			unsigned int index = m_vQueued[i].m_handle & INDEX_MASK;
+			Slot* pSlot = GetSlot(index);
+			if (pSlot->m_generation.load(memory_order_relaxed) == (m_vQueued[i].m_handle >> INDEX_BITS))
+			{
+				pSlot->m_generation.store((pSlot->m_generation.load(memory_order_relaxed) + 1) & GENERATION_MASK, memory_order_release);
+				m_vFreeSlots.push_back(index);
+			}
+
+			m_vpRetired.push_back(m_vQueued[i].m_pResource);
+		}
+		m_vQueued.clear();
+
+		m_numResources = 0;
+		m_writeMutex.unlock();
+
+		CollectGarbage();
+	}
+
+private:
+	class Slot
+	{
+	public:
+		Slot()
+		{
+			m_pResource.store(NULL, memory_order_relaxed);
+			m_generation.store(0, memory_order_relaxed);
+		}
+
+		atomic<T*> m_pResource;
+		atomic<unsigned int> m_generation;
+	};
+
+	class QueuedResource
+	{
+	public:
+		QueuedResource(unsigned int handle, T* pResource) : m_handle(handle), m_pResource(pResource) {}
+
+		unsigned int m_handle;
+		T* m_pResource;
+	};
+
+	ResourceRegistry(const ResourceRegistry&);
+	ResourceRegistry &operator=(const ResourceRegistry&);
+
+	Slot* GetSlot(unsigned int index) const
+	{
+		return &m_pages[index / PAGE_SIZE].load(memory_order_acquire)[index % PAGE_SIZE];
+	}
+
+	Slot* FindSlot(unsigned int handle) const
+	{
+		unsigned int index = handle & INDEX_MASK;
+		if (index >= m_numSlots.load(memory_order_acquire))
+		{
+			return NULL;
+		}
+
+		Slot* pSlot = GetSlot(index);
+		if (pSlot->m_generation.load(memory_order_acquire) != (handle >> INDEX_BITS))
+		{
+			return NULL;
+		}
+
+		return pSlot;
+	}
+
+	// Called with the write mutex held, returns INVALID_HANDLE when every page is full
+	unsigned int AllocateSlot()
+	{
+		unsigned int index;
+		if (m_vFreeSlots.empty() == false)
+		{
+			index = m_vFreeSlots.back();
+			m_vFreeSlots.pop_back();
+		}
+		else
+		{
+			index = m_numSlots.load(memory_order_relaxed);
+			if (index >= MAX_PAGES * PAGE_SIZE)
+			{
+				return INVALID_HANDLE;
+			}
+
+			if (index % PAGE_SIZE == 0)
+			{
+				// The page pointer is published before the slot count, so readers never see a slot without its page
+				m_pages[index / PAGE_SIZE].store(new Slot[PAGE_SIZE], memory_order_release);
+			}
+			m_numSlots.store(index + 1, memory_order_release);
+		}
+
+		return (GetSlot(index)->m_generation.load(memory_order_relaxed) << INDEX_BITS) | index;
+	}
+
+	atomic<Slot*> m_pages[MAX_PAGES];
+	atomic<unsigned int> m_numSlots;
+	int m_numResources;
+
+	// Only touched with the write mutex held
+	mutex m_writeMutex;
+	vector<unsigned int> m_vFreeSlots;
+	vector<QueuedResource> m_vQueued;
+	vector<T*> m_vpRetired;
+};
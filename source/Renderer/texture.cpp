@@ -11,23 +11,17 @@
 
 #include "texture.h"
 #include "tga.h"
+#include "texturecache.h"
 #include <string.h>
 
 #ifndef GL_CLAMP_TO_EDGE
 #define GL_CLAMP_TO_EDGE 0x812F
 #endif //GL_CLAMP_TO_EDGE
 
-inline int next_p2(int a)
-{
-	int rval = 2;
-
-	while(rval < a)
-		rval <<= 1;
-
-	return rval;
-}
-
 Texture::Texture() {
+	m_id = 0;
+	m_streaming = false;
+	m_placeholder = false;
 }
 
 Texture::~Texture() {
@@ -63,15 +57,28 @@ TextureFileType Texture::GetFileType() const
 	return m_filetype;
 }
 
+// How images are prepared for upload, shared with streamed loads so both hit the same cache files
+unsigned int Texture::GetImageFlags()
+{
+	bool lbNeedScaling = false;  // Was initially true but not really sure if this is needed or not...
+
+	unsigned int flags = TextureImageFlags_FlipVertical | TextureImageFlags_MipMaps;
+	if(lbNeedScaling)
+	{
+		flags |= TextureImageFlags_PadPowerOf2;
+	}
+
+	return flags;
+}
+
 bool Texture::Load(string fileName, int *width, int *height, int *width_power2, int *height_power2, bool refresh)
 {
 	m_fileName = fileName;
 
-	bool lbNeedScaling = false;
-	int lNumchannels = 0;
-	unsigned char *texdata = 0;
-	unsigned char *texdata_power2 = 0;
+	// Decoded, padded and mipped on the CPU, or straight out of the texture cache if we have seen this file before
+	unsigned int flags = GetImageFlags();
 
+	TextureImage image;
 	bool loaded = false;
 
 	if(strstr(fileName.c_str(), ".jpg"))
@@ -79,28 +86,20 @@ bool Texture::Load(string fileName, int *width, int *height, int *width_power2,
 		// TODO : Add back in JPG support
 
 		// JPG
-		//loaded = LoadFileJPG(fileName.c_str(), &texdata, width, height) == 1;
 		//m_filetype = TextureFileType_JPG;
-		//lbNeedScaling = false;
-		//lNumchannels = 3;
 	}
 	else if(strstr(fileName.c_str(), ".tga"))
 	{
 		// TGA
-		loaded = LoadFileTGA(fileName.c_str(), &texdata, width, height, true) == 1;
+		loaded = LoadTextureImage(fileName, flags, GetTextureCacheDirectory(), &image);
 		m_filetype = TextureFileType_TGA;
-		lbNeedScaling = false;  // Was initially true but not really sure if this is needed or not...
-		lNumchannels = 4;
 	}
 	else if(strstr(fileName.c_str(), ".bmp"))
 	{
 		// TODO : Add back in BMP support
 
 		// BMP
-		//loaded = LoadFileBMP(fileName.c_str(), &texdata, width, height) == 1;
 		//m_filetype = TextureFileType_BMP;
-		//lbNeedScaling = false;
-		//lNumchannels = 3;
 	}
 
 	if(loaded == false)
@@ -108,115 +107,91 @@ bool Texture::Load(string fileName, int *width, int *height, int *width_power2,
 		return false;
 	}
 
-	// Store the real width and height of this texture
-	m_width = (*width);
-	m_height = (*height);
-
-	if(lbNeedScaling)
+	if(Upload(image, refresh) == false)
 	{
-		// Now get the next power of 2 for width and height, since we want our final texture to be a power of 2
-		m_width_power2 = next_p2(m_width);
-		m_height_power2 = next_p2(m_height);
-
-		(*width_power2) = m_width_power2;
-		(*height_power2) = m_height_power2;
-
-		// Create space for the new power of 2 data
-		texdata_power2	= new unsigned char[ m_width_power2 * m_height_power2 * 4 ];
-
-		// Pointer to the original data
-		unsigned char	*ptr= (&texdata)[0];
-
-		// Pointer into the new power of 2 data
-		unsigned char	*ptr_power2= (&texdata_power2)[0];
-
-		// Go through the old data and insert it into the new expanded structure, or add padding if we need to...
-		for(int y = 0; y < m_height_power2; y++)
-		{
-			for(int x = 0; x < m_width_power2; x++)
-			{
-				if(y < m_height && x < m_width)
-				{
-					// We dont need padding
-					ptr_power2[0] = ptr[0];
-					ptr_power2[1] = ptr[1];
-					ptr_power2[2] = ptr[2];
-					ptr_power2[3] = ptr[3];
-
-					ptr += 4;
-				}
-				else
-				{
-					// We need padding 
-					ptr_power2[0] = 0;
-					ptr_power2[1] = 0;
-					ptr_power2[2] = 0;
-					ptr_power2[3] = 0;
-				}
-
-				ptr_power2 += 4;
-			}
-		}
-	}
-	else
-	{
-		m_width_power2 = m_width;
-		m_height_power2 = m_height;
-		(*width_power2) = m_width_power2;
-		(*height_power2) = m_height_power2;
+		return false;
 	}
 
-    if(refresh == false)
-    {
-        // Create a new texture id, since we are loading a fully new texture
-	    glGenTextures(1, &m_id);
-    }
+	(*width) = m_width;
+	(*height) = m_height;
+	(*width_power2) = m_width_power2;
+	(*height_power2) = m_height_power2;
 
-	glBindTexture(GL_TEXTURE_2D, m_id);
-
-	// TODO : Are these good parameters for MAG and MIN filters??
+	return true;
+}
 
-	//if(mbMipMap)
-	//{
-	//	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);  // GL_CLAMP
-	//	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);  // GL_CLAMP
-	//	gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, (*width), (*height), GL_RGBA, GL_UNSIGNED_BYTE, texdata);
-	//}
-	//else
+bool Texture::Upload(const TextureImage& image, bool refresh)
+{
+	// Store the real width and height of this texture, and the size it is stored at
+	m_width = image.m_width;
+	m_height = image.m_height;
+	m_width_power2 = image.m_widthPower2;
+	m_height_power2 = image.m_heightPower2;
+
+#ifdef VOGUE_HEADLESS
+	// No GL context to upload into, the decoded image is all we keep track of
+	m_id = 0;
+#else
+	// The placeholder id is shared, so a streamed texture always gets its own id on its first upload
+	if(refresh == false || m_placeholder)
 	{
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);  // GL_LINEAR
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);  // GL_LINEAR
-
-		int textureType = GL_RGB;
-
-		if(lNumchannels == 4)
-			textureType = GL_RGBA;
-
-		if(lbNeedScaling)
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width_power2, m_height_power2, 0, textureType, GL_UNSIGNED_BYTE, texdata_power2);
-		}
-		else
-		{
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, textureType, GL_UNSIGNED_BYTE, texdata);
-		}
+		// Create a new texture id, since we are loading a fully new texture
+		glGenTextures(1, &m_id);
 	}
 
+	glBindTexture(GL_TEXTURE_2D, m_id);
 
+	// Keep the crisp nearest filtering up close, but pick from the mip chain when the texture is minified
+	if(image.GetNumMipLevels() > 1)
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST_MIPMAP_NEAREST);
+	}
+	else
+	{
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+	}
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
 
-	if(lbNeedScaling)
+	for(int i = 0; i < image.GetNumMipLevels(); i++)
 	{
-		// Delete the data now
-		if(texdata_power2)
-			delete[] texdata_power2;
+		const TextureMipLevel& level = image.GetMipLevel(i);
+		glTexImage2D(GL_TEXTURE_2D, i, GL_RGBA, level.m_width, level.m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, level.m_pTexels);
 	}
+#endif //VOGUE_HEADLESS
 
-	if(texdata)
-		delete[] texdata;
+	m_placeholder = false;
+	m_streaming = false;
 
 	return true;
 }
 
+// Streaming
+void Texture::SetPlaceholder(string fileName, GLuint placeholderId)
+{
+	m_fileName = fileName;
+	m_filetype = TextureFileType_TGA;
+
+	m_width = 1;
+	m_height = 1;
+	m_width_power2 = 1;
+	m_height_power2 = 1;
+
+	m_id = placeholderId;
+
+	m_placeholder = true;
+	m_streaming = true;
+}
+
+bool Texture::IsStreaming() const
+{
+	return m_streaming;
+}
+
+void Texture::SetStreaming(bool streaming)
+{
+	m_streaming = streaming;
+}
+
 void Texture::GenerateEmptyTexture()
 {
 	// Create a new texture id, since we are loading a fully new texture
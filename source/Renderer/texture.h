@@ -30,6 +30,8 @@ int LoadFileTGA(const char *filename, unsigned char **pixels, int *width, int *h
 int LoadFileBMP(const char *filename, unsigned char **pixels, int *width, int *height);
 //int LoadFileJPG(const char *filename, unsigned char **pixels, int *width, int *height);
 
+class TextureImage;
+
 enum TextureFileType
 {
 	TextureFileType_BMP = 0,
@@ -55,7 +57,15 @@ public:
 
 	TextureFileType GetFileType() const;
 
+	static unsigned int GetImageFlags();
+
 	bool Load(string fileName, int *width, int *height, int *width_power2, int *height_power2, bool refresh);
+	bool Upload(const TextureImage& image, bool refresh);
+
+	// Streaming, the texture shows a shared placeholder until its image has been uploaded
+	void SetPlaceholder(string fileName, GLuint placeholderId);
+	bool IsStreaming() const;
+	void SetStreaming(bool streaming);
 
 	void GenerateEmptyTexture();
 
@@ -73,4 +83,7 @@ private:
 	GLuint m_id;
 
 	TextureFileType m_filetype;
+
+	bool m_streaming;
+	bool m_placeholder;
 };
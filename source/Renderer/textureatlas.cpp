@@ -0,0 +1,267 @@
+// ******************************************************************************
+// Filename:  TextureAtlas.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "textureatlas.h"
+#include "tga.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <math.h>
+#include <algorithm>
+
+
+static int NextPowerOf2(int value)
+{
+	int power2 = 1;
+	while (power2 < value)
+	{
+		power2 <<= 1;
+	}
+
+	return power2;
+}
+
+// Just the size of an image, read from its header without decoding it
+static bool ReadImageSize(const string& fileName, int* pWidth, int* pHeight)
+{
+	FILE* pFile = fopen(fileName.c_str(), "rb");
+	if (pFile == NULL)
+	{
+		return false;
+	}
+
+	unsigned char header[sizeof(TGAHEADER)];
+	bool read = fread(header, 1, sizeof(TGAHEADER), pFile) == sizeof(TGAHEADER);
+	fclose(pFile);
+
+	// With no pixels to decode into the decoder stops once it has the size
+	if (read == false || DecodeTGA(header, sizeof(TGAHEADER), NULL, pWidth, pHeight, false) != -1)
+	{
+		return false;
+	}
+
+	return *pWidth > 0 && *pHeight > 0;
+}
+
+// Packing order, tallest first so each shelf wastes as little height as possible
+class AtlasPackEntry
+{
+public:
+	int m_frameIndex;
+	int m_height;
+	const string* m_pFileName;
+};
+
+static bool SortAtlasPackEntries(const AtlasPackEntry& lhs, const AtlasPackEntry& rhs)
+{
+	if (lhs.m_height != rhs.m_height)
+	{
+		return lhs.m_height > rhs.m_height;
+	}
+
+	return *lhs.m_pFileName < *rhs.m_pFileName;
+}
+
+
+TextureAtlas::TextureAtlas()
+{
+	m_numFramesDone = 0;
+}
+
+TextureAtlas::~TextureAtlas()
+{
+	ReleaseTexels();
+}
+
+bool TextureAtlas::Layout(const vector<string>& fileNames)
+{
+	ReleaseTexels();
+	m_rects.clear();
+	m_vFrames.clear();
+	m_numFramesDone = 0;
+
+	int totalArea = 0;
+	int maxWidth = 0;
+	for (unsigned int i = 0; i < fileNames.size(); i++)
+	{
+		AtlasFrame frame;
+		frame.m_fileName = fileNames[i];
+		frame.m_x = 0;
+		frame.m_y = 0;
+		frame.m_done = false;
+
+		if (ReadImageSize(fileNames[i], &frame.m_width, &frame.m_height) == false)
+		{
+			continue;
+		}
+
+		int paddedWidth = frame.m_width + GUTTER * 2;
+		int paddedHeight = frame.m_height + GUTTER * 2;
+		totalArea += paddedWidth * paddedHeight;
+		maxWidth = paddedWidth > maxWidth ? paddedWidth : maxWidth;
+
+		m_vFrames.push_back(frame);
+	}
+
+	if (m_vFrames.empty())
+	{
+		return false;
+	}
+
+	vector<AtlasPackEntry> vPackOrder(m_vFrames.size());
+	for (unsigned int i = 0; i < m_vFrames.size(); i++)
+	{
+		vPackOrder[i].m_frameIndex = i;
+		vPackOrder[i].m_height = m_vFrames[i].m_height;
+		vPackOrder[i].m_pFileName = &m_vFrames[i].m_fileName;
+	}
+	sort(vPackOrder.begin(), vPackOrder.end(), SortAtlasPackEntries);
+
+	// Shelf packing into a roughly square power of two width
+	int atlasWidth = NextPowerOf2((int)ceil(sqrt((double)totalArea)));
+	atlasWidth = atlasWidth < NextPowerOf2(maxWidth) ? NextPowerOf2(maxWidth) : atlasWidth;
+
+	int shelfX = 0;
+	int shelfY = 0;
+	int shelfHeight = 0;
+	for (unsigned int i = 0; i < vPackOrder.size(); i++)
+	{
+		AtlasFrame* pFrame = &m_vFrames[vPackOrder[i].m_frameIndex];
+		int paddedWidth = pFrame->m_width + GUTTER * 2;
+		int paddedHeight = pFrame->m_height + GUTTER * 2;
+
+		if (shelfX + paddedWidth > atlasWidth)
+		{
+			shelfX = 0;
+			shelfY += shelfHeight;
+			shelfHeight = 0;
+		}
+
+		pFrame->m_x = shelfX + GUTTER;
+		pFrame->m_y = shelfY + GUTTER;
+
+		shelfX += paddedWidth;
+		shelfHeight = paddedHeight > shelfHeight ? paddedHeight : shelfHeight;
+	}
+
+	int atlasHeight = NextPowerOf2(shelfY + shelfHeight);
+
+	// Cleared to transparent, the frames are copied in as they are decoded
+	m_image.m_width = atlasWidth;
+	m_image.m_height = atlasHeight;
+	m_image.m_widthPower2 = atlasWidth;
+	m_image.m_heightPower2 = atlasHeight;
+	m_image.m_flags = TextureImageFlags_FlipVertical;
+	m_image.m_pOwnedTexels = new unsigned char[atlasWidth * atlasHeight * 4];
+	memset(m_image.m_pOwnedTexels, 0, atlasWidth * atlasHeight * 4);
+
+	TextureMipLevel level;
+	level.m_width = atlasWidth;
+	level.m_height = atlasHeight;
+	level.m_pTexels = m_image.m_pOwnedTexels;
+	m_image.m_vMipLevels.push_back(level);
+
+	for (unsigned int i = 0; i < m_vFrames.size(); i++)
+	{
+		TextureAtlasRect rect;
+		rect.m_u0 = (float)m_vFrames[i].m_x / atlasWidth;
+		rect.m_v0 = (float)m_vFrames[i].m_y / atlasHeight;
+		rect.m_u1 = (float)(m_vFrames[i].m_x + m_vFrames[i].m_width) / atlasWidth;
+		rect.m_v1 = (float)(m_vFrames[i].m_y + m_vFrames[i].m_height) / atlasHeight;
+		m_rects[m_vFrames[i].m_fileName] = rect;
+	}
+
+	return true;
+}
+
+bool TextureAtlas::GetRect(const string& fileName, TextureAtlasRect* pRect) const
+{
+	map<string, TextureAtlasRect>::const_iterator rect = m_rects.find(fileName);
+	if (rect == m_rects.end())
+	{
+		return false;
+	}
+
+	*pRect = rect->second;
+
+	return true;
+}
+
+int TextureAtlas::GetNumFrames() const
+{
+	return (int)m_vFrames.size();
+}
+
+const string& TextureAtlas::GetFrameFileName(int frameIndex) const
+{
+	return m_vFrames[frameIndex].m_fileName;
+}
+
+// Copies a decoded frame into its rect, clamping the source coordinates to fill the gutter with edge texels
+void TextureAtlas::SetFrameTexels(int frameIndex, const TextureImage& image)
+{
+	AtlasFrame* pFrame = &m_vFrames[frameIndex];
+	if (pFrame->m_done)
+	{
+		return;
+	}
+
+	int width = pFrame->m_width;
+	int height = pFrame->m_height;
+
+	// The file changed size since it was laid out, leave it clear rather than overrun the neighbours
+	if (image.GetNumMipLevels() > 0 && image.m_width == width && image.m_height == height && m_image.m_pOwnedTexels != NULL)
+	{
+		const TextureMipLevel& source = image.GetMipLevel(0);
+		int atlasWidth = m_image.m_width;
+		for (int y = -GUTTER; y < height + GUTTER; y++)
+		{
+			int sourceY = y < 0 ? 0 : (y >= height ? height - 1 : y);
+			const unsigned char* pSourceRow = source.m_pTexels + (size_t)sourceY * source.m_width * 4;
+			unsigned char* pDestRow = m_image.m_pOwnedTexels + ((size_t)(pFrame->m_y + y) * atlasWidth + pFrame->m_x) * 4;
+
+			memcpy(pDestRow, pSourceRow, width * 4);
+			for (int g = 1; g <= GUTTER; g++)
+			{
+				memcpy(pDestRow - g * 4, pSourceRow, 4);
+				memcpy(pDestRow + (width - 1 + g) * 4, pSourceRow + (width - 1) * 4, 4);
+			}
+		}
+	}
+
+	pFrame->m_done = true;
+	m_numFramesDone++;
+}
+
+void TextureAtlas::FailFrame(int frameIndex)
+{
+	if (m_vFrames[frameIndex].m_done == false)
+	{
+		m_vFrames[frameIndex].m_done = true;
+		m_numFramesDone++;
+	}
+}
+
+bool TextureAtlas::IsComplete() const
+{
+	return m_numFramesDone == (int)m_vFrames.size();
+}
+
+// The packed texels, can be released once they have been uploaded
+const TextureImage& TextureAtlas::GetImage() const
+{
+	return m_image;
+}
+
+void TextureAtlas::ReleaseTexels()
+{
+	m_image.Release();
+}
@@ -0,0 +1,98 @@
+// ******************************************************************************
+// Filename:  TextureAtlas.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   Packs a set of small images into a single texture. Each image keeps a UV
+//   rect into the atlas, so switching between them is a texture coordinate
+//   change rather than a texture bind. Every frame is surrounded by a one
+//   texel gutter of its own edge texels, so nearest sampling right on a rect
+//   edge never picks up a neighbouring frame.
+//
+//   The layout only needs the size of each image, which is read from its
+//   header, so the rects are known straight away. The frames are decoded
+//   elsewhere (by the texture streamer) and copied in as they arrive; the
+//   atlas is complete once every frame has either arrived or failed.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <map>
+using namespace std;
+
+#include "texturecache.h"
+
+class TextureAtlasRect
+{
+public:
+	float m_u0;
+	float m_v0;
+	float m_u1;
+	float m_v1;
+};
+
+class TextureAtlas
+{
+public:
+	/* Public methods */
+	TextureAtlas();
+	~TextureAtlas();
+
+	// Lays the images out from their headers, the ones that can't be read are left out
+	bool Layout(const vector<string>& fileNames);
+
+	bool GetRect(const string& fileName, TextureAtlasRect* pRect) const;
+	int GetNumFrames() const;
+	const string& GetFrameFileName(int frameIndex) const;
+
+	// Filling in the frames, a failed frame stays clear
+	void SetFrameTexels(int frameIndex, const TextureImage& image);
+	void FailFrame(int frameIndex);
+	bool IsComplete() const;
+
+	// The packed texels, can be released once they have been uploaded
+	const TextureImage& GetImage() const;
+	void ReleaseTexels();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	TextureAtlas(const TextureAtlas&);
+	TextureAtlas &operator=(const TextureAtlas&);
+
+public:
+	/* Public members */
+	static const int GUTTER = 1;
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	map<string, TextureAtlasRect> m_rects;
+
+	class AtlasFrame
+	{
+	public:
+		string m_fileName;
+		int m_width;
+		int m_height;
+		int m_x;
+		int m_y;
+		bool m_done;
+	};
+	vector<AtlasFrame> m_vFrames;
+	int m_numFramesDone;
+
+	TextureImage m_image;
+};
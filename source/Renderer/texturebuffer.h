@@ -0,0 +1,26 @@
+// ******************************************************************************
+// Filename:  texturebuffer.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   A texture buffer, a buffer of floats that the shaders read by index
+//   through a buffer texture. Used for arrays too big to pass as uniforms,
+//   like the clustered light lists.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+class TextureBuffer
+{
+public:
+	GLuint m_buffer;
+	GLuint m_texture;
+	GLenum m_format;
+	int m_numFloats;
+};
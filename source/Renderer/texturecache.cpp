@@ -0,0 +1,515 @@
+// ******************************************************************************
+// Filename:  TextureCache.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "texturecache.h"
+#include "tga.h"
+#include "../utils/FileUtils.h"
+#include "../utils/CacheFile.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif //_WIN32
+
+// 'VTEX'
+const unsigned int TEXTURE_CACHE_MAGIC = 0x58455456;
+
+class TextureCacheHeader
+{
+public:
+	unsigned int m_magic;
+	unsigned int m_version;
+	unsigned long long m_pathHash;
+	unsigned long long m_sourceSize;
+	unsigned long long m_sourceModifiedTime;
+	// Hash of the source contents when the cache file was written, not checked on load
+	unsigned long long m_sourceHash;
+	unsigned int m_flags;
+	int m_width;
+	int m_height;
+	int m_widthPower2;
+	int m_heightPower2;
+	int m_numMipLevels;
+};
+
+static int NextPowerOf2(int a)
+{
+	int rval = 2;
+
+	while (rval < a)
+		rval <<= 1;
+
+	return rval;
+}
+
+// Works out the size of each mip level and the total number of bytes needed to store the chain
+static size_t CalculateMipLevels(int width, int height, bool mipMaps, vector<TextureMipLevel>* pLevels)
+{
+	size_t totalSize = 0;
+
+	pLevels->clear();
+	while (true)
+	{
+		TextureMipLevel level;
+		level.m_width = width;
+		level.m_height = height;
+		level.m_pTexels = NULL;
+		pLevels->push_back(level);
+
+		totalSize += (size_t)width * height * 4;
+
+		if (mipMaps == false || (width == 1 && height == 1))
+		{
+			break;
+		}
+
+		width = width > 1 ? width / 2 : 1;
+		height = height > 1 ? height / 2 : 1;
+	}
+
+	return totalSize;
+}
+
+
+// MappedFile
+MappedFile::MappedFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+
+#ifdef _WIN32
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#endif //_WIN32
+}
+
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+bool MappedFile::Open(const char* fileName)
+{
+	Close();
+
+#ifdef _WIN32
+	m_fileHandle = CreateFileA(fileName, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (m_fileHandle == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(m_fileHandle, &fileSize) == FALSE || fileSize.QuadPart == 0)
+	{
+		Close();
+		return false;
+	}
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (m_mappingHandle == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	m_pData = (const unsigned char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	if (m_pData == NULL)
+	{
+		Close();
+		return false;
+	}
+
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	int fileDescriptor = open(fileName, O_RDONLY);
+	if (fileDescriptor == -1)
+	{
+		return false;
+	}
+
+	struct stat fileStat;
+	if (fstat(fileDescriptor, &fileStat) != 0 || fileStat.st_size == 0)
+	{
+		close(fileDescriptor);
+		return false;
+	}
+
+	void* pData = mmap(NULL, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, fileDescriptor, 0);
+
+	// The mapping stays valid after the descriptor is closed
+	close(fileDescriptor);
+
+	if (pData == MAP_FAILED)
+	{
+		return false;
+	}
+
+	m_pData = (const unsigned char*)pData;
+	m_size = (size_t)fileStat.st_size;
+#endif //_WIN32
+
+	return true;
+}
+
+void MappedFile::Close()
+{
+#ifdef _WIN32
+	if (m_pData != NULL)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (m_mappingHandle != NULL)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = NULL;
+	}
+	if (m_fileHandle != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (m_pData != NULL)
+	{
+		munmap((void*)m_pData, m_size);
+	}
+#endif //_WIN32
+
+	m_pData = NULL;
+	m_size = 0;
+}
+
+
+// TextureImage
+TextureImage::TextureImage()
+{
+	m_width = 0;
+	m_height = 0;
+	m_widthPower2 = 0;
+	m_heightPower2 = 0;
+	m_flags = 0;
+	m_fromCache = false;
+	m_pOwnedTexels = NULL;
+}
+
+TextureImage::~TextureImage()
+{
+	Release();
+}
+
+void TextureImage::Release()
+{
+	delete[] m_pOwnedTexels;
+	m_pOwnedTexels = NULL;
+
+	m_mappedFile.Close();
+	m_vMipLevels.clear();
+	m_fromCache = false;
+}
+
+
+// Loading
+bool LoadTextureImage(const string& fileName, unsigned int flags, const char* cacheDirectory, TextureImage* pImage)
+{
+	pImage->Release();
+
+	// Only TGA is supported for now
+	if (strstr(fileName.c_str(), ".tga") == NULL)
+	{
+		return false;
+	}
+
+	TextureSourceStamp stamp;
+	if (GetTextureSourceStamp(fileName, &stamp) == false)
+	{
+		return false;
+	}
+
+	// A hit only needs the stamp, the source is never opened
+	string cacheFileName;
+	if (cacheDirectory != NULL)
+	{
+		char cacheName[64];
+		sprintf(cacheName, "/%016llx_%x.vtex", stamp.m_pathHash, flags);
+		cacheFileName = string(cacheDirectory) + cacheName;
+
+		if (LoadTextureCache(cacheFileName, stamp, flags, pImage))
+		{
+			return true;
+		}
+	}
+
+	// Cache miss, read the whole source file to decode it
+	FILE* pFile = fopen(fileName.c_str(), "rb");
+	if (pFile == NULL)
+	{
+		return false;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	if (fileSize <= 0)
+	{
+		fclose(pFile);
+		return false;
+	}
+
+	unsigned char* pSourceData = new unsigned char[fileSize];
+	size_t numRead = fread(pSourceData, 1, fileSize, pFile);
+	fclose(pFile);
+
+	if (numRead != (size_t)fileSize)
+	{
+		delete[] pSourceData;
+		return false;
+	}
+
+	unsigned long long sourceHash = HashCacheData(pSourceData, fileSize);
+
+	// Decode the source image
+	unsigned char* pDecoded = NULL;
+	int width = 0;
+	int height = 0;
+	bool decoded = DecodeTGA(pSourceData, fileSize, &pDecoded, &width, &height, (flags & TextureImageFlags_FlipVertical) != 0) == 1;
+	delete[] pSourceData;
+
+	if (decoded == false)
+	{
+		return false;
+	}
+
+	pImage->m_width = width;
+	pImage->m_height = height;
+	pImage->m_flags = flags;
+
+	if (flags & TextureImageFlags_PadPowerOf2)
+	{
+		pImage->m_widthPower2 = NextPowerOf2(width);
+		pImage->m_heightPower2 = NextPowerOf2(height);
+	}
+	else
+	{
+		pImage->m_widthPower2 = width;
+		pImage->m_heightPower2 = height;
+	}
+
+	// All the mip levels are stored back to back in one allocation, in the same layout as the cache file
+	size_t totalSize = CalculateMipLevels(pImage->m_widthPower2, pImage->m_heightPower2, (flags & TextureImageFlags_MipMaps) != 0, &pImage->m_vMipLevels);
+	pImage->m_pOwnedTexels = new unsigned char[totalSize];
+
+	if (flags & TextureImageFlags_PadPowerOf2)
+	{
+		PadTexelsToPowerOf2(pDecoded, width, height, pImage->m_pOwnedTexels, pImage->m_widthPower2, pImage->m_heightPower2);
+	}
+	else
+	{
+		memcpy(pImage->m_pOwnedTexels, pDecoded, (size_t)width * height * 4);
+	}
+	delete[] pDecoded;
+
+	unsigned char* pLevelTexels = pImage->m_pOwnedTexels;
+	for (unsigned int i = 0; i < pImage->m_vMipLevels.size(); i++)
+	{
+		TextureMipLevel* pLevel = &pImage->m_vMipLevels[i];
+		pLevel->m_pTexels = pLevelTexels;
+
+		if (i > 0)
+		{
+			const TextureMipLevel* pPrevious = &pImage->m_vMipLevels[i - 1];
+			DownsampleMipLevel(pPrevious->m_pTexels, pPrevious->m_width, pPrevious->m_height, pLevelTexels, pLevel->m_width, pLevel->m_height);
+		}
+
+		pLevelTexels += (size_t)pLevel->m_width * pLevel->m_height * 4;
+	}
+
+	if (cacheDirectory != NULL && createDirectory(cacheDirectory))
+	{
+		SaveTextureCache(cacheFileName, stamp, sourceHash, *pImage);
+	}
+
+	return true;
+}
+
+// Copies the image into the top left of a larger power of 2 image, whole rows at a time, and clears the padding
+void PadTexelsToPowerOf2(const unsigned char* pSource, int width, int height, unsigned char* pDest, int widthPower2, int heightPower2)
+{
+	size_t sourceRowSize = (size_t)width * 4;
+	size_t destRowSize = (size_t)widthPower2 * 4;
+
+	for (int y = 0; y < height; y++)
+	{
+		memcpy(pDest + y * destRowSize, pSource + y * sourceRowSize, sourceRowSize);
+		memset(pDest + y * destRowSize + sourceRowSize, 0, destRowSize - sourceRowSize);
+	}
+
+	memset(pDest + height * destRowSize, 0, (heightPower2 - height) * destRowSize);
+}
+
+// 2x2 box filter, weighting the colour by alpha so transparent texels don't bleed their colour into the edges
+void DownsampleMipLevel(const unsigned char* pSource, int width, int height, unsigned char* pDest, int destWidth, int destHeight)
+{
+	for (int y = 0; y < destHeight; y++)
+	{
+		int y0 = y * 2 < height ? y * 2 : height - 1;
+		int y1 = y0 + 1 < height ? y0 + 1 : y0;
+
+		for (int x = 0; x < destWidth; x++)
+		{
+			int x0 = x * 2 < width ? x * 2 : width - 1;
+			int x1 = x0 + 1 < width ? x0 + 1 : x0;
+
+			const unsigned char* pTexels[4] =
+			{
+				&pSource[(y0 * width + x0) * 4],
+				&pSource[(y0 * width + x1) * 4],
+				&pSource[(y1 * width + x0) * 4],
+				&pSource[(y1 * width + x1) * 4],
+			};
+
+			unsigned int r = 0;
+			unsigned int g = 0;
+			unsigned int b = 0;
+			unsigned int a = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				unsigned int alpha = pTexels[i][3];
+				r += pTexels[i][0] * alpha;
+				g += pTexels[i][1] * alpha;
+				b += pTexels[i][2] * alpha;
+				a += alpha;
+			}
+
+			unsigned char* pOut = &pDest[(y * destWidth + x) * 4];
+			if (a > 0)
+			{
+				pOut[0] = (unsigned char)((r + a / 2) / a);
+				pOut[1] = (unsigned char)((g + a / 2) / a);
+				pOut[2] = (unsigned char)((b + a / 2) / a);
+			}
+			else
+			{
+				pOut[0] = (unsigned char)((pTexels[0][0] + pTexels[1][0] + pTexels[2][0] + pTexels[3][0] + 2) / 4);
+				pOut[1] = (unsigned char)((pTexels[0][1] + pTexels[1][1] + pTexels[2][1] + pTexels[3][1] + 2) / 4);
+				pOut[2] = (unsigned char)((pTexels[0][2] + pTexels[1][2] + pTexels[2][2] + pTexels[3][2] + 2) / 4);
+			}
+			pOut[3] = (unsigned char)((a + 2) / 4);
+		}
+	}
+}
+
+// Cache files
+bool GetTextureSourceStamp(const string& fileName, TextureSourceStamp* pStamp)
+{
+	if (getFileStamp(fileName, &pStamp->m_size, &pStamp->m_modifiedTime) == false || pStamp->m_size == 0)
+	{
+		return false;
+	}
+
+	pStamp->m_pathHash = HashCacheData(fileName.c_str(), fileName.length());
+
+	return true;
+}
+
+bool LoadTextureCache(const string& cacheFileName, const TextureSourceStamp& stamp, unsigned int flags, TextureImage* pImage)
+{
+	if (pImage->m_mappedFile.Open(cacheFileName.c_str()) == false)
+	{
+		return false;
+	}
+
+	const unsigned char* pData = pImage->m_mappedFile.GetData();
+	size_t size = pImage->m_mappedFile.GetSize();
+
+	TextureCacheHeader header;
+	if (size < sizeof(TextureCacheHeader))
+	{
+		pImage->Release();
+		return false;
+	}
+	memcpy(&header, pData, sizeof(TextureCacheHeader));
+
+	if (header.m_magic != TEXTURE_CACHE_MAGIC || header.m_version != TEXTURE_CACHE_VERSION || header.m_flags != flags ||
+		header.m_pathHash != stamp.m_pathHash || header.m_sourceSize != stamp.m_size || header.m_sourceModifiedTime != stamp.m_modifiedTime ||
+		header.m_widthPower2 <= 0 || header.m_heightPower2 <= 0)
+	{
+		pImage->Release();
+		return false;
+	}
+
+	size_t totalSize = CalculateMipLevels(header.m_widthPower2, header.m_heightPower2, (flags & TextureImageFlags_MipMaps) != 0, &pImage->m_vMipLevels);
+	if ((int)pImage->m_vMipLevels.size() != header.m_numMipLevels || size < sizeof(TextureCacheHeader) + totalSize)
+	{
+		pImage->Release();
+		return false;
+	}
+
+	// Point the mip levels straight at the mapped texels
+	const unsigned char* pLevelTexels = pData + sizeof(TextureCacheHeader);
+	for (unsigned int i = 0; i < pImage->m_vMipLevels.size(); i++)
+	{
+		pImage->m_vMipLevels[i].m_pTexels = pLevelTexels;
+		pLevelTexels += (size_t)pImage->m_vMipLevels[i].m_width * pImage->m_vMipLevels[i].m_height * 4;
+	}
+
+	pImage->m_width = header.m_width;
+	pImage->m_height = header.m_height;
+	pImage->m_widthPower2 = header.m_widthPower2;
+	pImage->m_heightPower2 = header.m_heightPower2;
+	pImage->m_flags = flags;
+	pImage->m_fromCache = true;
+
+	return true;
+}
+
+bool SaveTextureCache(const string& cacheFileName, const TextureSourceStamp& stamp, unsigned long long sourceHash, const TextureImage& image)
+{
+	TextureCacheHeader header;
+	memset(&header, 0, sizeof(TextureCacheHeader));
+	header.m_magic = TEXTURE_CACHE_MAGIC;
+	header.m_version = TEXTURE_CACHE_VERSION;
+	header.m_pathHash = stamp.m_pathHash;
+	header.m_sourceSize = stamp.m_size;
+	header.m_sourceModifiedTime = stamp.m_modifiedTime;
+	header.m_sourceHash = sourceHash;
+	header.m_flags = image.m_flags;
+	header.m_width = image.m_width;
+	header.m_height = image.m_height;
+	header.m_widthPower2 = image.m_widthPower2;
+	header.m_heightPower2 = image.m_heightPower2;
+	header.m_numMipLevels = image.GetNumMipLevels();
+
+	vector<CacheFileBlock> vBlocks;
+	CacheFileBlock headerBlock = { &header, sizeof(TextureCacheHeader) };
+	vBlocks.push_back(headerBlock);
+	for (int i = 0; i < image.GetNumMipLevels(); i++)
+	{
+		const TextureMipLevel& level = image.GetMipLevel(i);
+		CacheFileBlock levelBlock = { level.m_pTexels, (size_t)level.m_width * level.m_height * 4 };
+		vBlocks.push_back(levelBlock);
+	}
+
+	return WriteCacheFile(cacheFileName, &vBlocks[0], (int)vBlocks.size());
+}
+
+const char* GetTextureCacheDirectory()
+{
+	return "cache/textures";
+}
@@ -0,0 +1,118 @@
+// ******************************************************************************
+// Filename:  TextureCache.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   The CPU side of texture loading. Decodes a source image to RGBA8, pads it
+//   to a power of two if needed and builds its mip chain. The result is
+//   written to a versioned cache file keyed by the source path and checked
+//   against the source's size and modification time, so loading the same
+//   image again is a stat and a single memory map of texel data that is
+//   ready to hand straight to glTexImage2D. The source is only read on a miss.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Bump when the cache file layout or the decode output changes, old cache files are then ignored
+const unsigned int TEXTURE_CACHE_VERSION = 2;
+
+enum TextureImageFlags
+{
+	TextureImageFlags_FlipVertical = 1,
+	TextureImageFlags_PadPowerOf2 = 2,
+	TextureImageFlags_MipMaps = 4,
+};
+
+// A read-only memory mapped file
+class MappedFile
+{
+public:
+	MappedFile();
+	~MappedFile();
+
+	bool Open(const char* fileName);
+	void Close();
+
+	const unsigned char* GetData() const { return m_pData; }
+	size_t GetSize() const { return m_size; }
+
+private:
+	MappedFile(const MappedFile&);
+	MappedFile &operator=(const MappedFile&);
+
+	const unsigned char* m_pData;
+	size_t m_size;
+
+#ifdef _WIN32
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#endif //_WIN32
+};
+
+// Identifies a source image without reading it
+class TextureSourceStamp
+{
+public:
+	unsigned long long m_pathHash;
+	unsigned long long m_size;
+	unsigned long long m_modifiedTime;
+};
+
+class TextureMipLevel
+{
+public:
+	int m_width;
+	int m_height;
+	const unsigned char* m_pTexels;
+};
+
+// A decoded RGBA8 image and its mip chain. The texels are either owned, or point into a mapped cache file.
+class TextureImage
+{
+public:
+	TextureImage();
+	~TextureImage();
+
+	void Release();
+
+	int GetNumMipLevels() const { return (int)m_vMipLevels.size(); }
+	const TextureMipLevel& GetMipLevel(int level) const { return m_vMipLevels[level]; }
+
+public:
+	// The size of the source image, and the size it is stored at
+	int m_width;
+	int m_height;
+	int m_widthPower2;
+	int m_heightPower2;
+
+	unsigned int m_flags;
+	bool m_fromCache;
+
+	vector<TextureMipLevel> m_vMipLevels;
+
+	unsigned char* m_pOwnedTexels;
+	MappedFile m_mappedFile;
+};
+
+// Loads an image through the cache, decoding it and writing a new cache file on a miss. The cache is skipped when cacheDirectory is NULL.
+bool LoadTextureImage(const string& fileName, unsigned int flags, const char* cacheDirectory, TextureImage* pImage);
+
+// The individual steps, exposed for the texture benchmark
+void PadTexelsToPowerOf2(const unsigned char* pSource, int width, int height, unsigned char* pDest, int widthPower2, int heightPower2);
+void DownsampleMipLevel(const unsigned char* pSource, int width, int height, unsigned char* pDest, int destWidth, int destHeight);
+bool GetTextureSourceStamp(const string& fileName, TextureSourceStamp* pStamp);
+bool LoadTextureCache(const string& cacheFileName, const TextureSourceStamp& stamp, unsigned int flags, TextureImage* pImage);
+bool SaveTextureCache(const string& cacheFileName, const TextureSourceStamp& stamp, unsigned long long sourceHash, const TextureImage& image);
+
+// The default location for cache files
+const char* GetTextureCacheDirectory();
@@ -0,0 +1,152 @@
+// ******************************************************************************
+// Filename:  TextureStreamer.cpp
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "texturestreamer.h"
+
+
+TextureStreamer::TextureStreamer()
+{
+	m_numDecoding = 0;
+	m_stopping = false;
+}
+
+TextureStreamer::~TextureStreamer()
+{
+	Stop();
+}
+
+// Worker threads
+void TextureStreamer::Start(int numThreads, const char* cacheDirectory)
+{
+	if (m_vpWorkerThreads.empty() == false)
+	{
+		return;
+	}
+
+	m_cacheDirectory = cacheDirectory != NULL ? cacheDirectory : "";
+	m_stopping = false;
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		m_vpWorkerThreads.push_back(new thread(_WorkerThread, this));
+	}
+}
+
+void TextureStreamer::Stop()
+{
+	m_requestsMutex.lock();
+	m_stopping = true;
+	m_requestsCondition.notify_all();
+	m_requestsMutex.unlock();
+
+	for (unsigned int i = 0; i < m_vpWorkerThreads.size(); i++)
+	{
+		m_vpWorkerThreads[i]->join();
+		delete m_vpWorkerThreads[i];
+		m_vpWorkerThreads[i] = 0;
+	}
+	m_vpWorkerThreads.clear();
+
+	// Anything still waiting is dropped
+	m_pendingRequests.clear();
+	for (unsigned int i = 0; i < m_completedRequests.size(); i++)
+	{
+		delete m_completedRequests[i].m_pImage;
+	}
+	m_completedRequests.clear();
+}
+
+bool TextureStreamer::IsStarted()
+{
+	return m_vpWorkerThreads.empty() == false;
+}
+
+// Requests
+void TextureStreamer::QueueRequest(unsigned int textureId, const string& fileName, unsigned int flags, int atlasFrame)
+{
+	TextureStreamRequest request;
+	request.m_textureId = textureId;
+	request.m_fileName = fileName;
+	request.m_flags = flags;
+	request.m_atlasFrame = atlasFrame;
+	request.m_pImage = NULL;
+	request.m_loaded = false;
+
+	m_requestsMutex.lock();
+	m_pendingRequests.push_back(request);
+	m_requestsCondition.notify_one();
+	m_requestsMutex.unlock();
+}
+
+bool TextureStreamer::PopCompleted(TextureStreamRequest* pRequest)
+{
+	bool popped = false;
+
+	m_requestsMutex.lock();
+	if (m_completedRequests.empty() == false)
+	{
+		*pRequest = m_completedRequests.front();
+		m_completedRequests.pop_front();
+		popped = true;
+	}
+	m_requestsMutex.unlock();
+
+	return popped;
+}
+
+int TextureStreamer::GetNumOutstanding()
+{
+	m_requestsMutex.lock();
+	int numOutstanding = (int)(m_pendingRequests.size() + m_completedRequests.size()) + m_numDecoding;
+	m_requestsMutex.unlock();
+
+	return numOutstanding;
+}
+
+void TextureStreamer::_WorkerThread(void* pData)
+{
+	TextureStreamer* pTextureStreamer = (TextureStreamer*)pData;
+	pTextureStreamer->WorkerThread();
+}
+
+void TextureStreamer::WorkerThread()
+{
+	const char* cacheDirectory = m_cacheDirectory.empty() ? NULL : m_cacheDirectory.c_str();
+
+	while (true)
+	{
+		m_requestsMutex.lock();
+		while (m_pendingRequests.empty() && m_stopping == false)
+		{
+			m_requestsCondition.wait(m_requestsMutex);
+		}
+
+		if (m_stopping)
+		{
+			m_requestsMutex.unlock();
+			return;
+		}
+
+		TextureStreamRequest request = m_pendingRequests.front();
+		m_pendingRequests.pop_front();
+		m_numDecoding++;
+		m_requestsMutex.unlock();
+
+		// The slow part, done without holding the lock
+		request.m_pImage = new TextureImage();
+		request.m_loaded = LoadTextureImage(request.m_fileName, request.m_flags, cacheDirectory, request.m_pImage);
+
+		m_requestsMutex.lock();
+		m_completedRequests.push_back(request);
+		m_numDecoding--;
+		m_requestsMutex.unlock();
+	}
+}
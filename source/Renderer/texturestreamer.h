@@ -0,0 +1,91 @@
+// ******************************************************************************
+// Filename:  TextureStreamer.h
+// Project:   Vogue
+// Author:    Steven Ball
+//
+// Purpose:
+//   Background decoding for streamed textures. Requests are queued from the
+//   main thread and picked up by a small pool of worker threads, which run the
+//   CPU side of the texture pipeline (decode, mip chain, texture cache). The
+//   decoded images are handed back to the main thread, which owns the GL
+//   context and does the uploads.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <deque>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+using namespace tthread;
+
+#include "texturecache.h"
+
+// A texture waiting to be decoded, or decoded and waiting to be uploaded
+class TextureStreamRequest
+{
+public:
+	unsigned int m_textureId;
+	string m_fileName;
+	unsigned int m_flags;
+
+	// The frame of the atlas texture this is decoded into, or -1 for a texture of its own
+	int m_atlasFrame;
+
+	TextureImage* m_pImage;
+	bool m_loaded;
+};
+
+class TextureStreamer
+{
+public:
+	/* Public methods */
+	TextureStreamer();
+	~TextureStreamer();
+
+	// Worker threads
+	void Start(int numThreads, const char* cacheDirectory);
+	void Stop();
+	bool IsStarted();
+
+	// Requests
+	void QueueRequest(unsigned int textureId, const string& fileName, unsigned int flags, int atlasFrame = -1);
+	bool PopCompleted(TextureStreamRequest* pRequest);
+	int GetNumOutstanding();
+
+protected:
+	/* Protected methods */
+	static void _WorkerThread(void* pData);
+	void WorkerThread();
+
+private:
+	/* Private methods */
+	TextureStreamer(const TextureStreamer&);
+	TextureStreamer &operator=(const TextureStreamer&);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<thread*> m_vpWorkerThreads;
+	string m_cacheDirectory;
+
+	// Guards both queues and the stop flag
+	mutex m_requestsMutex;
+	condition_variable m_requestsCondition;
+	deque<TextureStreamRequest> m_pendingRequests;
+	deque<TextureStreamRequest> m_completedRequests;
+	int m_numDecoding;
+	bool m_stopping;
+};
@@ -5,11 +5,104 @@
 //
 
 
-#include	<fstream>
+#include	<stdio.h>
+#include	<string.h>
 #include	"tga.h"
 
 
 
+// --------------------------------------------------
+// Pixel conversion helpers. Each one converts a whole
+// run of pixels of a single format, so the format
+// switch is made once per row or packet rather than
+// once per pixel.
+// --------------------------------------------------
+
+static inline unsigned int PackRGBA( unsigned char r, unsigned char g, unsigned char b, unsigned char a )
+{
+	return (unsigned int)r | ((unsigned int)g << 8) | ((unsigned int)b << 16) | ((unsigned int)a << 24);
+}
+
+// read a single pixel of the given depth into a packed rgba value
+static unsigned int ReadPixelTGA( const unsigned char *src, int depth, const RGBTRIPLE *palette, bool greyscale )
+{
+	switch( depth )
+	{
+		case 8:
+		{
+			if( greyscale || palette == NULL )
+				return PackRGBA( src[0], src[0], src[0], 255 );
+
+			return PackRGBA( palette[ src[0] ].rgbtRed, palette[ src[0] ].rgbtGreen, palette[ src[0] ].rgbtBlue, 255 );
+		}
+
+		case 16:
+		{
+			unsigned short color = (unsigned short)(src[0] | (src[1] << 8));
+			return PackRGBA( ((color & 0x7C00) >> 10) << 3, ((color & 0x03E0) >> 5) << 3, (color & 0x001F) << 3, 255 );
+		}
+
+		case 24:
+			return PackRGBA( src[2], src[1], src[0], 255 );
+
+		case 32:
+			return PackRGBA( src[2], src[1], src[0], src[3] );
+	}
+
+	return 0;
+}
+
+// convert count raw pixels of the given depth into rgba
+static void ConvertPixelsTGA( const unsigned char *src, int count, int depth, const RGBTRIPLE *palette, bool greyscale, unsigned char *dst )
+{
+	unsigned int *out = (unsigned int *)dst;
+	int i;
+
+	switch( depth )
+	{
+		case 24:
+		{
+			for( i = 0; i < count; i++, src += 3 )
+				out[i] = 0xFF000000 | ((unsigned int)src[0] << 16) | ((unsigned int)src[1] << 8) | (unsigned int)src[2];
+
+			break;
+		}
+
+		case 32:
+		{
+			// bgra -> rgba is a swap of the red and blue bytes, done on whole words
+			unsigned int pixel;
+			for( i = 0; i < count; i++, src += 4 )
+			{
+				memcpy( &pixel, src, 4 );
+				out[i] = (pixel & 0xFF00FF00) | ((pixel >> 16) & 0xFF) | ((pixel & 0xFF) << 16);
+			}
+
+			break;
+		}
+
+		default:
+		{
+			int bytesPerPixel = depth >> 3;
+			for( i = 0; i < count; i++, src += bytesPerPixel )
+				out[i] = ReadPixelTGA( src, depth, palette, greyscale );
+
+			break;
+		}
+	}
+}
+
+// fill count pixels with a single rgba value
+static void FillPixelsTGA( unsigned int rgba, int count, unsigned char *dst )
+{
+	unsigned int *out = (unsigned int *)dst;
+
+	for( int i = 0; i < count; i++ )
+		out[i] = rgba;
+}
+
+
+
 // --------------------------------------------------
 // LoadFileTGA() - load a TrueVision TARGA image [.tga].
 //
@@ -33,369 +126,196 @@
 
 int LoadFileTGA( const char *filename, unsigned char **pixels, int *width, int *height, bool flipvert )
 {
-	std::ifstream	file;				// file stream
-	TGAHEADER		*tgah;				// targa header
-	RGBTRIPLE		*palette = NULL;	// pointer on the color palette
-	char			*buffer;			// buffer storing the entire file
-	unsigned char	*ptr;				// pointer to pixels data
-	int				row, col, i;		// temporary variables
-
+	/////////////////////////////////////////////////////
+	// read the entire file in one go
 
+	FILE *file = fopen( filename, "rb" );
 
-	/////////////////////////////////////////////////////
-	// read the entire file in the buffer
+	if( file == NULL )
+		return 0;
 
-	file.open( filename, std::ios::in | std::ios::binary );
+	fseek( file, 0, SEEK_END );
+	long flen = ftell( file );
+	fseek( file, 0, SEEK_SET );
 
-	if( file.fail() )
+	if( flen <= 0 )
+	{
+		fclose( file );
 		return 0;
+	}
 
-	file.seekg( 0, std::ios::end );
-	long flen = (long)file.tellg();
-	file.seekg( 0, std::ios::beg );
+	unsigned char *buffer = new unsigned char[ flen ];
+	size_t numRead = fread( buffer, 1, flen, file );
 
-	buffer = new char[ flen + 1 ];
-	file.read( buffer, flen );
-	char *pBuff = buffer;
+	fclose( file );
 
-	file.close();
+	int result = 0;
+	if( numRead == (size_t)flen )
+		result = DecodeTGA( buffer, flen, pixels, width, height, flipvert );
 
-	/////////////////////////////////////////////////////
+	delete [] buffer;
+
+	return result;
+}
+
+
+
+// --------------------------------------------------
+// DecodeTGA() - decode a TARGA image that is already
+// in memory. Same parameters and return values as
+// LoadFileTGA().
+// --------------------------------------------------
 
+int DecodeTGA( const unsigned char *data, long size, unsigned char **pixels, int *width, int *height, bool flipvert )
+{
+	if( size < (long)sizeof( TGAHEADER ) )
+		return 0;
+
+	const unsigned char	*pEnd = data + size;
 
 	// read the header
-	tgah = (TGAHEADER *)pBuff;
-	pBuff += sizeof( TGAHEADER );
+	TGAHEADER tgah;
+	memcpy( &tgah, data, sizeof( TGAHEADER ) );
 
+	const unsigned char *pBuff = data + sizeof( TGAHEADER ) + tgah.id_lenght;
+
+	int imageWidth = tgah.is_width;
+	int imageHeight = tgah.is_height;
 
 	if( width )
-		*width = tgah->is_width;
+		*width = imageWidth;
 
 	if( height )
-		*height = tgah->is_height;
+		*height = imageHeight;
 
 	if( !pixels )
-	{
-		delete [] buffer;
 		return (-1);
-	}
-
-
-	// allocate memory to store pixel data
-	(*pixels) = new unsigned char[ tgah->is_width * tgah->is_height * 4 ];
-	ptr = &(*pixels)[0];
-
 
-	// move the pixel data pointer to the begening of bitmap data
-	if( tgah->id_lenght )
-		pBuff = buffer + (tgah->id_lenght * sizeof( unsigned char ));
+	if( imageWidth <= 0 || imageHeight <= 0 )
+		return 0;
 
 
 	/////////////////////////////////////////////////////
 	// read the palette
 
-	if( tgah->color_map_type )
+	const RGBTRIPLE *palette = NULL;
+
+	if( tgah.color_map_type )
 	{
 		// 24 and 32 bits images are not paletted
+		palette = (const RGBTRIPLE *)pBuff;
 
-		// ajust the palette pointer to the memory in the buffer
-		palette = (RGBTRIPLE *)pBuff;
-
-		pBuff += tgah->cm_length * (tgah->cm_size >> 3) * sizeof( unsigned char );
+		pBuff += tgah.cm_length * (tgah.cm_size >> 3);
 	}
 
-	/////////////////////////////////////////////////////
+	int depth = tgah.is_pixel_depth;
+	int bytesPerPixel = depth >> 3;
+	bool greyscale = (tgah.image_type == 3 || tgah.image_type == 11);
+
+	if( depth != 8 && depth != 16 && depth != 24 && depth != 32 )
+		return 0;
+
+	int rowSize = imageWidth * 4;
 
 
 	/////////////////////////////////////////////////////
 	// read pixel data following the image compression
-	// type and the number of bits per pixels
+	// type, a row (or packet) at a time
 	/////////////////////////////////////////////////////
 
-	switch( tgah->image_type )
+	switch( tgah.image_type )
 	{
 		case 0:
-			// pas de donnes image
-			break;
+			// no image data
+			return (-1);
 
 		case 1:
-// COLOR-MAPPED BGR 8 BITS GREYSCALE
-
+		case 2:
 		case 3:
 		{
-// COLOR-MAPPED BGR 8 BITS
-			for( row = tgah->is_height - 1; row >= 0; row-- )
-			{
-				if( flipvert )
-					ptr = &(*pixels)[ row * tgah->is_width * 4 ];
+			// uncompressed, colour-mapped, true-colour or greyscale
+			if( pBuff + (long)imageWidth * imageHeight * bytesPerPixel > pEnd )
+				return 0;
 
-				for( col = 0; col < tgah->is_width; col++, ptr += 4 )
-				{
-					// read the current pixel
-					unsigned char color = *((unsigned char *)(pBuff++));
-
-					// convert indexed pixel (8 bits) into rgba (32 bits) pixel
-					ptr[0] = palette[ color ].rgbtRed;		// b->r
-					ptr[1] = palette[ color ].rgbtGreen;	// g->g
-					ptr[2] = palette[ color ].rgbtBlue;		// r->b
-					ptr[3] = 255;							// alpha
-				}
-			}
+			(*pixels) = new unsigned char[ rowSize * imageHeight ];
 
-			break;
-		}
-
-		case 2:
-		{
-			for( row = tgah->is_height - 1; row >= 0; row-- )
+			for( int fileRow = 0; fileRow < imageHeight; fileRow++ )
 			{
-				if( flipvert )
-					ptr = &(*pixels)[ row * tgah->is_width * 4 ];
-
-				for( col = 0; col < tgah->is_width; col++, ptr += 4 )
-				{
-					switch( tgah->is_pixel_depth )
-					{
-						case 16:
-						{
-// TRUE-COLOR BGR 16 BITS
-							// read the current pixel
-							unsigned short color = *((unsigned short *)pBuff);
-							pBuff += sizeof( short );
-
-							// convert bgr (16 bits) pixel into rgba (32 bits) pixel
-							ptr[0] = ((color & 0x7C00) >> 10) << 3;	// b->r
-							ptr[1] = ((color & 0x03E0) >>  5) << 3;	// g->g
-							ptr[2] = ((color & 0x001F) >>  0) << 3;	// r->b
-							ptr[3] = 255;							// alpha
-
-							break;
-						}
-
-						case 24:
-						{
-// TRUE-COLOR BGR 24 BITS
-							// convert bgr (24 bits) pixel into rgba (32 bits) pixel
-							RGBTRIPLE *pix = (RGBTRIPLE *)pBuff;
-							pBuff += sizeof( RGBTRIPLE );
-
-							ptr[0] = pix->rgbtRed;
-							ptr[1] = pix->rgbtGreen;
-							ptr[2] = pix->rgbtBlue;
-							ptr[3] = 255;
+				int row = flipvert ? (imageHeight - 1 - fileRow) : fileRow;
 
-							break;
-						}
-
-						case 32:
-						{
-// TRUE-COLOR BGR 32 BITS
-							// convert bgr (32 bits) pixel into rgba (32 bits) pixel
-							BGRAQUAD *pix = (BGRAQUAD *)pBuff;
-							pBuff += sizeof( BGRAQUAD );
-
-							ptr[0] = pix->bgraRed;
-							ptr[1] = pix->bgraGreen;
-							ptr[2] = pix->bgraBlue;
-							ptr[3] = pix->bgraAlpha;
-
-							break;
-						}
-					}
-				}
+				ConvertPixelsTGA( pBuff, imageWidth, depth, palette, greyscale, &(*pixels)[ row * rowSize ] );
+				pBuff += imageWidth * bytesPerPixel;
 			}
 
 			break;
 		}
 
 		case 9:
-// RLE COLOR-MAPPED BGR 8 BITS
-
+		case 10:
 		case 11:
 		{
-// RLE COLOR-MAPPED BGR 8 BITS GREYSCALE
-
-			unsigned char	packetHeader, packetSize, i;
+			// run-length encoded, packets may cross scanlines so track the row and column as we go
+			(*pixels) = new unsigned char[ rowSize * imageHeight ];
 
+			int fileRow = 0;
+			int col = 0;
+			unsigned char *ptr = &(*pixels)[ (flipvert ? (imageHeight - 1) : 0) * rowSize ];
 
-			for( row = tgah->is_height - 1; row >= 0; row-- )
+			while( fileRow < imageHeight )
 			{
-				if( flipvert )
-					ptr = &(*pixels)[ row * tgah->is_width * 4 ];
-
-				for( col = 0; col < tgah->is_width; /* rien */ )
+				if( pBuff >= pEnd )
 				{
-					packetHeader	= *((unsigned char *)(pBuff++));
-					packetSize		= 1 + (packetHeader & 0x7f);
-
-					if( packetHeader & 0x80 )
-					{
-						// run-length packet
-
-						// read the current pixel
-						unsigned char color = *((unsigned char *)(pBuff++));
-
-						// convert indexed pixel (8 bits) pixel into rgba (32 bits) pixel
-						for( i = 0; i < packetSize; i++, ptr += 4, col++ )
-						{
-							ptr[0] = palette[ color ].rgbtRed;		// b->r
-							ptr[1] = palette[ color ].rgbtGreen;	// g->g
-							ptr[2] = palette[ color ].rgbtBlue;		// r->b
-							ptr[3] = 255;							// alpha
-						}
-					}
-					else
-					{
-						// non run-length packet
-
-						for( i = 0; i < packetSize; i++, ptr += 4, col++ )
-						{
-							// read the current pixel
-							unsigned char color = *((unsigned char *)(pBuff++));
-
-							// convert indexed pixel (8 bits) pixel into rgba (32 bits) pixel
-							ptr[0] = palette[ color ].rgbtRed;		// b->r
-							ptr[1] = palette[ color ].rgbtGreen;	// g->g
-							ptr[2] = palette[ color ].rgbtBlue;		// r->b
-							ptr[3] = 255;							// alpha
-						}
-					}
+					delete [] (*pixels);
+					(*pixels) = NULL;
+					return 0;
 				}
-			}
-
-			break;
-		}
 
-		case 10:
-		{
-			unsigned char	packetHeader, packetSize;
+				unsigned char packetHeader = *(pBuff++);
+				int packetSize = 1 + (packetHeader & 0x7f);
+				bool runLength = (packetHeader & 0x80) != 0;
 
+				if( pBuff + (runLength ? bytesPerPixel : packetSize * bytesPerPixel) > pEnd )
+				{
+					delete [] (*pixels);
+					(*pixels) = NULL;
+					return 0;
+				}
 
-			for( row = tgah->is_height - 1; row >= 0; row-- )
-			{
-				if( flipvert )
-					ptr = &(*pixels)[ row * tgah->is_width * 4 ];
+				unsigned int runColour = 0;
+				if( runLength )
+				{
+					runColour = ReadPixelTGA( pBuff, depth, palette, greyscale );
+					pBuff += bytesPerPixel;
+				}
 
-				for( col = 0; col < tgah->is_width; /* rien */ )
+				while( packetSize > 0 && fileRow < imageHeight )
 				{
-					packetHeader	= *((unsigned char *)(pBuff++));
-					packetSize		= 1 + (packetHeader & 0x7f);
+					int count = imageWidth - col;
+					if( count > packetSize )
+						count = packetSize;
 
-					if( packetHeader & 0x80 )
+					if( runLength )
 					{
-						// run-length packet
-						switch( tgah->is_pixel_depth )
-						{
-							case 16:
-							{
-// RLE TRUE-COLOR BGR 16 BITS
-								// read the current pixel
-								unsigned short color = *((unsigned short *)pBuff);
-								pBuff += sizeof( short );
-
-								// convert bgr (16 bits) pixel into rgba (32 bits) pixel
-								for( i = 0; i < packetSize; i++, ptr += 4, col++ )
-								{
-									ptr[0] = ((color & 0x7C00) >> 10) << 3;	// b->r
-									ptr[1] = ((color & 0x03E0) >>  5) << 3;	// g->g
-									ptr[2] = ((color & 0x001F) >>  0) << 3;	// r->b
-									ptr[3] = 255;
-								}
-
-								break;
-							}
-
-							case 24:
-							{
-// RLE TRUE-COLOR BGR 24 BITS
-								// convert bgr (24 bits) pixel into rgba (32 bits) pixel
-								RGBTRIPLE *pix = (RGBTRIPLE *)pBuff;
-								pBuff += sizeof( RGBTRIPLE );
-
-								for( i = 0; i < packetSize; i++, ptr += 4, col++ )
-								{
-									ptr[0] = pix->rgbtRed;
-									ptr[1] = pix->rgbtGreen;
-									ptr[2] = pix->rgbtBlue;
-									ptr[3] = 255;
-								}
-
-								break;
-							}
-
-							case 32:
-							{
-// RLE TRUE-COLOR BGR 32 BITS
-								// convert bgr (32 bits) pixel into rgba (32 bits) pixel
-								BGRAQUAD *pix = (BGRAQUAD *)pBuff;
-								pBuff += sizeof( BGRAQUAD );
-
-								for( i = 0; i < packetSize; i++, ptr += 4, col++ )
-								{
-									ptr[0] = pix->bgraRed;
-									ptr[1] = pix->bgraGreen;
-									ptr[2] = pix->bgraBlue;
-									ptr[3] = pix->bgraAlpha;
-								}
-
-								break;
-							}
-						}
+						FillPixelsTGA( runColour, count, ptr + col * 4 );
 					}
 					else
 					{
-						// non run-length packet
+						ConvertPixelsTGA( pBuff, count, depth, palette, greyscale, ptr + col * 4 );
+						pBuff += count * bytesPerPixel;
+					}
 
-						for( i = 0; i < packetSize; i++, ptr += 4, col++ )
+					packetSize -= count;
+					col += count;
+
+					if( col == imageWidth )
+					{
+						col = 0;
+						fileRow++;
+
+						if( fileRow < imageHeight )
 						{
-							switch( tgah->is_pixel_depth )
-							{
-								case 16:
-								{
-// RLE TRUE-COLOR BGR 16 BITS
-									// read the current pixel
-									unsigned short color = *((unsigned short *)pBuff);
-									pBuff += sizeof( short );
-
-									// convert bgr (16 bits) pixel into rgba (32 bits) pixel
-									ptr[0] = ((color & 0x7C00) >> 10) << 3;	// b->r
-									ptr[1] = ((color & 0x03E0) >>  5) << 3;	// g->g
-									ptr[2] = ((color & 0x001F) >>  0) << 3;	// r->b
-									ptr[3] = 255;							// alpha
-
-									break;
-								}
-
-								case 24:
-								{
-// RLE TRUE-COLOR BGR 24 BITS
-									// convert bgr (24 bits) pixel into rgba (32 bits) pixel
-									RGBTRIPLE *pix = (RGBTRIPLE *)pBuff;
-									pBuff += sizeof( RGBTRIPLE );
-
-									ptr[0] = pix->rgbtRed;
-									ptr[1] = pix->rgbtGreen;
-									ptr[2] = pix->rgbtBlue;
-									ptr[3] = 255;
-
-									break;
-								}
-
-								case 32:
-								{
-// RLE TRUE-COLOR BGR 32 BITS
-									// convert bgr (32 bits) pixel into rgba (32 bits) pixel
-									BGRAQUAD *pix = (BGRAQUAD *)pBuff;
-									pBuff += sizeof( BGRAQUAD );
-
-									ptr[0] = pix->bgraRed;
-									ptr[1] = pix->bgraGreen;
-									ptr[2] = pix->bgraBlue;
-									ptr[3] = pix->bgraAlpha;
-
-									break;
-								}
-							}
+							int row = flipvert ? (imageHeight - 1 - fileRow) : fileRow;
+							ptr = &(*pixels)[ row * rowSize ];
 						}
 					}
 				}
@@ -407,16 +327,10 @@ int LoadFileTGA( const char *filename, unsigned char **pixels, int *width, int *
 		default:
 		{
 			// unknown format
-			delete [] pixels;
-			delete [] buffer;
 			return 0;
 		}
 	}
 
-
-	// free buffer memory
-	delete [] buffer;
-
 	// return success
 	return 1;
 }
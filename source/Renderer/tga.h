@@ -79,4 +79,13 @@ typedef struct tagBGRAQUAD			// rgbt
 } BGRAQUAD, *PBGRAQUAD;
 
 
+// --------------------------------------------
+// Loading and decoding.
+// --------------------------------------------
+
+int LoadFileTGA( const char *filename, unsigned char **pixels, int *width, int *height, bool flipvert );
+int DecodeTGA( const unsigned char *data, long size, unsigned char **pixels, int *width, int *height, bool flipvert );
+
+
+
 #endif	// __TARGA_H_
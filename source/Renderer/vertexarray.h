@@ -38,6 +38,9 @@ public:
 		if(nTextureCoordinates)
 			delete pTextureCoordinates;
 
+		if(nVerts)
+			delete [] pPositions;
+
 		nVerts = 0;
 		nIndices = 0;
 		nTextureCoordinates = 0;
@@ -50,6 +53,7 @@ public:
 	int nTextureCoordinates;
 	int nIndices;
 	float *pVA;
+	float *pPositions;	// Just the positions, packed, for depth only rendering
 	float *pTextureCoordinates;
 	unsigned int *pIndices;
 	int vertexSize;
@@ -0,0 +1,504 @@
+// ******************************************************************************
+// Filename:    ScriptManager.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "ScriptManager.h"
+#include "../utils/FileUtils.h"
+#include "../utils/CacheFile.h"
+#include "../utils/Random.h"
+#include "../utils/Profiler.h"
+
+#include "selene.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <iostream>
+
+
+// The cache file header, the compiled chunk follows it
+const unsigned int SCRIPT_CACHE_MAGIC = 0x41554C56; // 'VLUA'
+
+class ScriptCacheHeader
+{
+public:
+	unsigned int m_magic;
+	unsigned int m_version;
+	unsigned int m_luaVersion;
+	unsigned int m_bytecodeSize;
+	unsigned long long m_sourceHash;
+};
+
+// lua_dump writer, appends the chunk to a string
+static int _WriteBytecode(lua_State* pState, const void* pData, size_t size, void* pUserData)
+{
+	string* pBytecode = (string*)pUserData;
+	pBytecode->append((const char*)pData, size);
+
+	return 0;
+}
+
+
+// ScriptBatch
+ScriptBatch::ScriptBatch(int numFields)
+{
+	m_numFields = numFields;
+
+	m_idsTable = LUA_NOREF;
+	m_fieldsTable = LUA_NOREF;
+	m_tableCapacity = 0;
+}
+
+ScriptBatch::~ScriptBatch()
+{
+	ScriptManager::ReleaseBatchTables(this);
+}
+
+void ScriptBatch::Clear()
+{
+	m_vIds.clear();
+	m_vFields.clear();
+}
+
+float* ScriptBatch::AddEntry(int id)
+{
+	m_vIds.push_back(id);
+	m_vFields.resize(m_vFields.size() + m_numFields, 0.0f);
+
+	return &m_vFields[m_vFields.size() - m_numFields];
+}
+
+
+// Initialize the singleton instance
+ScriptManager *ScriptManager::c_instance = 0;
+
+ScriptManager* ScriptManager::GetInstance()
+{
+	if(c_instance == 0)
+		c_instance = new ScriptManager;
+
+	return c_instance;
+}
+
+void ScriptManager::Destroy()
+{
+	if(c_instance)
+	{
+		delete m_pSeleneState;
+		lua_close(m_pState);
+
+		delete c_instance;
+		c_instance = 0;
+	}
+}
+
+ScriptManager::ScriptManager()
+{
+	m_pState = luaL_newstate();
+	luaL_openlibs(m_pState);
+
+	// Selene only wraps the state for registering C++ functions, the state itself is owned here
+	m_pSeleneState = new sel::State(m_pState);
+
+	m_numCachedLoads = 0;
+	m_numCompiledLoads = 0;
+
+	m_frameNumCalls = 0;
+	m_frameTime = 0.0;
+	m_lastFrameNumCalls = 0;
+	m_lastFrameTime = 0.0;
+	m_totalNumCalls = 0;
+	m_totalTime = 0.0;
+
+	RegisterFunctions();
+}
+
+// Loading
+bool ScriptManager::LoadScript(const char* fileName)
+{
+	FILE* pFile = fopen(fileName, "rb");
+	if (pFile == NULL)
+	{
+		cout << "Script error: Could not open " << fileName << endl;
+		return false;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	string source;
+	source.resize(fileSize > 0 ? fileSize : 0);
+	size_t numRead = fileSize > 0 ? fread(&source[0], 1, fileSize, pFile) : 0;
+	fclose(pFile);
+
+	if (numRead != source.size())
+	{
+		cout << "Script error: Could not read " << fileName << endl;
+		return false;
+	}
+
+	// The chunk name is kept in the bytecode, so errors still point at the source file
+	string chunkName = string("@") + fileName;
+	unsigned long long sourceHash = HashCacheData(source.c_str(), source.size());
+
+	char hashName[64];
+	sprintf(hashName, "/%016llx.vlua", sourceHash);
+	string cacheFileName = string(GetScriptCacheDirectory()) + hashName;
+
+	// Try the cached bytecode first
+	bool loaded = false;
+	pFile = fopen(cacheFileName.c_str(), "rb");
+	if (pFile != NULL)
+	{
+		ScriptCacheHeader header;
+		if (fread(&header, sizeof(ScriptCacheHeader), 1, pFile) == 1 &&
+			header.m_magic == SCRIPT_CACHE_MAGIC && header.m_version == SCRIPT_CACHE_VERSION &&
+			header.m_luaVersion == (unsigned int)LUA_VERSION_NUM && header.m_sourceHash == sourceHash)
+		{
+			string bytecode;
+			bytecode.resize(header.m_bytecodeSize);
+			if (header.m_bytecodeSize > 0 && fread(&bytecode[0], 1, header.m_bytecodeSize, pFile) == header.m_bytecodeSize)
+			{
+				if (luaL_loadbufferx(m_pState, bytecode.c_str(), bytecode.size(), chunkName.c_str(), "b") == LUA_OK)
+				{
+					loaded = true;
+					m_numCachedLoads++;
+				}
+				else
+				{
+					lua_pop(m_pState, 1);
+				}
+			}
+		}
+		fclose(pFile);
+	}
+
+	// Cache miss, compile the source and write out the bytecode
+	if (loaded == false)
+	{
+		if (luaL_loadbufferx(m_pState, source.c_str(), source.size(), chunkName.c_str(), "t") != LUA_OK)
+		{
+			cout << "Script error: " << lua_tostring(m_pState, -1) << endl;
+			lua_pop(m_pState, 1);
+			return false;
+		}
+
+		m_numCompiledLoads++;
+
+		string bytecode;
+		if (lua_dump(m_pState, _WriteBytecode, &bytecode, 0) == 0 && createDirectory(GetScriptCacheDirectory()))
+		{
+			ScriptCacheHeader header;
+			memset(&header, 0, sizeof(ScriptCacheHeader));
+			header.m_magic = SCRIPT_CACHE_MAGIC;
+			header.m_version = SCRIPT_CACHE_VERSION;
+			header.m_luaVersion = LUA_VERSION_NUM;
+			header.m_bytecodeSize = (unsigned int)bytecode.size();
+			header.m_sourceHash = sourceHash;
+
+			CacheFileBlock blocks[2] = { { &header, sizeof(ScriptCacheHeader) }, { bytecode.c_str(), bytecode.size() } };
+			WriteCacheFile(cacheFileName, blocks, 2);
+		}
+	}
+
+	// Run the chunk, this defines the script's tables and functions
+	return CallProtected(0, 0);
+}
+
+int ScriptManager::GetNumCachedLoads() const
+{
+	return m_numCachedLoads;
+}
+
+int ScriptManager::GetNumCompiledLoads() const
+{
+	return m_numCompiledLoads;
+}
+
+// Data tables
+float ScriptManager::GetNumber(const char* table, const char* key, float defaultValue)
+{
+	float value = defaultValue;
+	if (PushTableField(table, key))
+	{
+		if (lua_type(m_pState, -1) == LUA_TNUMBER)
+		{
+			value = (float)lua_tonumber(m_pState, -1);
+		}
+		lua_pop(m_pState, 1);
+	}
+
+	return value;
+}
+
+int ScriptManager::GetInt(const char* table, const char* key, int defaultValue)
+{
+	int value = defaultValue;
+	if (PushTableField(table, key))
+	{
+		if (lua_type(m_pState, -1) == LUA_TNUMBER)
+		{
+			value = (int)lua_tointeger(m_pState, -1);
+		}
+		lua_pop(m_pState, 1);
+	}
+
+	return value;
+}
+
+bool ScriptManager::GetBool(const char* table, const char* key, bool defaultValue)
+{
+	bool value = defaultValue;
+	if (PushTableField(table, key))
+	{
+		if (lua_type(m_pState, -1) == LUA_TBOOLEAN)
+		{
+			value = lua_toboolean(m_pState, -1) != 0;
+		}
+		lua_pop(m_pState, 1);
+	}
+
+	return value;
+}
+
+string ScriptManager::GetString(const char* table, const char* key, const string& defaultValue)
+{
+	string value = defaultValue;
+	if (PushTableField(table, key))
+	{
+		if (lua_type(m_pState, -1) == LUA_TSTRING)
+		{
+			value = lua_tostring(m_pState, -1);
+		}
+		lua_pop(m_pState, 1);
+	}
+
+	return value;
+}
+
+int ScriptManager::GetArrayLength(const char* table)
+{
+	int length = 0;
+	if (lua_getglobal(m_pState, table) == LUA_TTABLE)
+	{
+		length = (int)lua_rawlen(m_pState, -1);
+	}
+	lua_pop(m_pState, 1);
+
+	return length;
+}
+
+string ScriptManager::GetArrayString(const char* table, int index, const string& defaultValue)
+{
+	string value = defaultValue;
+	if (lua_getglobal(m_pState, table) == LUA_TTABLE)
+	{
+		// Lua arrays start at 1
+		if (lua_rawgeti(m_pState, -1, index + 1) == LUA_TSTRING)
+		{
+			value = lua_tostring(m_pState, -1);
+		}
+		lua_pop(m_pState, 1);
+	}
+	lua_pop(m_pState, 1);
+
+	return value;
+}
+
+// Functions
+ScriptFunction ScriptManager::BindFunction(const char* name)
+{
+	if (lua_getglobal(m_pState, name) != LUA_TFUNCTION)
+	{
+		lua_pop(m_pState, 1);
+		return INVALID_SCRIPT_FUNCTION;
+	}
+
+	return luaL_ref(m_pState, LUA_REGISTRYINDEX);
+}
+
+void ScriptManager::UnbindFunction(ScriptFunction function)
+{
+	if (IsFunctionBound(function))
+	{
+		luaL_unref(m_pState, LUA_REGISTRYINDEX, function);
+	}
+}
+
+bool ScriptManager::IsFunctionBound(ScriptFunction function) const
+{
+	return function != INVALID_SCRIPT_FUNCTION && function != LUA_REFNIL;
+}
+
+bool ScriptManager::CallBatch(ScriptFunction function, float dt, ScriptBatch* pBatch)
+{
+	if (IsFunctionBound(function) == false || pBatch->GetNumEntries() == 0)
+	{
+		return true;
+	}
+
+	PROFILE_ZONE("Scripts");
+
+	double start = GetElapsedTime();
+
+	int numEntries = pBatch->GetNumEntries();
+	int numFields = pBatch->GetNumFields();
+	int numValues = numEntries * numFields;
+
+	// Grow the batch tables when needed, they are reused from frame to frame otherwise
+	if (numValues > pBatch->m_tableCapacity || numEntries > pBatch->m_tableCapacity || pBatch->m_idsTable == LUA_NOREF)
+	{
+		ReleaseBatchTables(pBatch);
+
+		pBatch->m_tableCapacity = numValues > numEntries ? numValues : numEntries;
+		lua_createtable(m_pState, pBatch->m_tableCapacity, 0);
+		pBatch->m_idsTable = luaL_ref(m_pState, LUA_REGISTRYINDEX);
+		lua_createtable(m_pState, pBatch->m_tableCapacity, 0);
+		pBatch->m_fieldsTable = luaL_ref(m_pState, LUA_REGISTRYINDEX);
+	}
+
+	lua_rawgeti(m_pState, LUA_REGISTRYINDEX, function);
+	lua_pushnumber(m_pState, dt);
+	lua_pushinteger(m_pState, numEntries);
+
+	lua_rawgeti(m_pState, LUA_REGISTRYINDEX, pBatch->m_idsTable);
+	for (int i = 0; i < numEntries; i++)
+	{
+		lua_pushinteger(m_pState, pBatch->m_vIds[i]);
+		lua_rawseti(m_pState, -2, i + 1);
+	}
+
+	lua_rawgeti(m_pState, LUA_REGISTRYINDEX, pBatch->m_fieldsTable);
+	for (int i = 0; i < numValues; i++)
+	{
+		lua_pushnumber(m_pState, pBatch->m_vFields[i]);
+		lua_rawseti(m_pState, -2, i + 1);
+	}
+
+	// fn(dt, count, ids, fields), aborted if it runs past the instruction budget
+	lua_sethook(m_pState, _InstructionBudgetHook, LUA_MASKCOUNT, SCRIPT_INSTRUCTION_BUDGET);
+	bool success = CallProtected(4, 0);
+	lua_sethook(m_pState, NULL, 0, 0);
+
+	// Copy back whatever the script changed
+	if (success)
+	{
+		lua_rawgeti(m_pState, LUA_REGISTRYINDEX, pBatch->m_fieldsTable);
+		for (int i = 0; i < numValues; i++)
+		{
+			lua_rawgeti(m_pState, -1, i + 1);
+			pBatch->m_vFields[i] = (float)lua_tonumber(m_pState, -1);
+			lua_pop(m_pState, 1);
+		}
+		lua_pop(m_pState, 1);
+	}
+
+	double elapsed = GetElapsedTime() - start;
+	m_frameNumCalls++;
+	m_frameTime += elapsed;
+	m_totalNumCalls++;
+	m_totalTime += elapsed;
+
+	return success;
+}
+
+void ScriptManager::ReleaseBatchTables(ScriptBatch* pBatch)
+{
+	if (c_instance != 0 && pBatch->m_idsTable != LUA_NOREF)
+	{
+		luaL_unref(c_instance->m_pState, LUA_REGISTRYINDEX, pBatch->m_idsTable);
+		luaL_unref(c_instance->m_pState, LUA_REGISTRYINDEX, pBatch->m_fieldsTable);
+	}
+
+	pBatch->m_idsTable = LUA_NOREF;
+	pBatch->m_fieldsTable = LUA_NOREF;
+	pBatch->m_tableCapacity = 0;
+}
+
+// Frame statistics
+void ScriptManager::NewFrame()
+{
+	m_lastFrameNumCalls = m_frameNumCalls;
+	m_lastFrameTime = m_frameTime;
+
+	m_frameNumCalls = 0;
+	m_frameTime = 0.0;
+}
+
+int ScriptManager::GetLastFrameNumCalls() const
+{
+	return m_lastFrameNumCalls;
+}
+
+double ScriptManager::GetLastFrameTime() const
+{
+	return m_lastFrameTime;
+}
+
+int ScriptManager::GetTotalNumCalls() const
+{
+	return m_totalNumCalls;
+}
+
+double ScriptManager::GetTotalTime() const
+{
+	return m_totalTime;
+}
+
+void ScriptManager::RegisterFunctions()
+{
+	sel::State& state = *m_pSeleneState;
+
+	state["GetRandomNumber"] = [](int lower, int higher) -> int { return GetRandomNumber(lower, higher); };
+	state["Log"] = [](std::string message) { cout << message << endl; };
+}
+
+bool ScriptManager::PushTableField(const char* table, const char* key)
+{
+	if (lua_getglobal(m_pState, table) != LUA_TTABLE)
+	{
+		lua_pop(m_pState, 1);
+		return false;
+	}
+
+	lua_getfield(m_pState, -1, key);
+	lua_remove(m_pState, -2);
+
+	return true;
+}
+
+bool ScriptManager::CallProtected(int numArgs, int numResults)
+{
+	if (lua_pcall(m_pState, numArgs, numResults, 0) != LUA_OK)
+	{
+		const char* message = lua_tostring(m_pState, -1);
+		cout << "Script error: " << (message != NULL ? message : "unknown error") << endl;
+		lua_pop(m_pState, 1);
+		return false;
+	}
+
+	return true;
+}
+
+void ScriptManager::_InstructionBudgetHook(lua_State* pState, lua_Debug* pDebug)
+{
+	luaL_error(pState, "instruction budget of %d exceeded", SCRIPT_INSTRUCTION_BUDGET);
+}
+
+double ScriptManager::GetElapsedTime()
+{
+	return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+const char* GetScriptCacheDirectory()
+{
+	return "cache/scripts";
+}
@@ -0,0 +1,157 @@
+// ******************************************************************************
+// Filename:    ScriptManager.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   The embedded Lua scripting layer. Owns the Lua state, loads scripts and
+//   reads data tables out of them, and exposes the C++ entry points scripts
+//   can call.
+//
+//   Scripts are compiled once and their bytecode is written to a cache file
+//   keyed by a hash of the source, so later loads skip the Lua compiler.
+//   Script functions the game calls are bound once to a registry reference
+//   rather than looked up by name on every call. Per frame callbacks are
+//   batched, a system fills in a ScriptBatch with one entry per object and
+//   makes a single call for all of them. Every per frame call runs under an
+//   instruction budget, and the time and number of calls are counted so the
+//   cost of scripts each frame can be read back.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+using namespace std;
+
+#include "lua.hpp"
+
+namespace sel
+{
+	class State;
+}
+
+// Bump when the cache file layout changes, old cache files are then ignored
+const unsigned int SCRIPT_CACHE_VERSION = 1;
+
+// A Lua function bound once to a registry reference
+typedef int ScriptFunction;
+const ScriptFunction INVALID_SCRIPT_FUNCTION = LUA_NOREF;
+
+// The maximum number of Lua instructions a single per frame call may run before it is aborted
+const int SCRIPT_INSTRUCTION_BUDGET = 200000;
+
+// The per object data handed to a batched callback. Each entry has an id and a fixed number of fields,
+// scripts read and write them through a flat table and any changes are copied back after the call.
+class ScriptBatch
+{
+public:
+	ScriptBatch(int numFields);
+	~ScriptBatch();
+
+	void Clear();
+	float* AddEntry(int id);
+
+	int GetNumFields() const { return m_numFields; }
+	int GetNumEntries() const { return (int)m_vIds.size(); }
+	int GetId(int entry) const { return m_vIds[entry]; }
+	float* GetFields(int entry) { return &m_vFields[entry * m_numFields]; }
+
+private:
+	friend class ScriptManager;
+
+	int m_numFields;
+	vector<int> m_vIds;
+	vector<float> m_vFields;
+
+	// The Lua tables are kept between frames so dispatching doesn't create garbage
+	int m_idsTable;
+	int m_fieldsTable;
+	int m_tableCapacity;
+};
+
+class ScriptManager
+{
+public:
+	/* Public methods */
+	static ScriptManager* GetInstance();
+	void Destroy();
+
+	// Loading
+	bool LoadScript(const char* fileName);
+	int GetNumCachedLoads() const;
+	int GetNumCompiledLoads() const;
+
+	// Data tables, read at load time. The default is returned if the table or key is missing.
+	float GetNumber(const char* table, const char* key, float defaultValue);
+	int GetInt(const char* table, const char* key, int defaultValue);
+	bool GetBool(const char* table, const char* key, bool defaultValue);
+	string GetString(const char* table, const char* key, const string& defaultValue);
+	int GetArrayLength(const char* table);
+	string GetArrayString(const char* table, int index, const string& defaultValue);
+
+	// Functions
+	ScriptFunction BindFunction(const char* name);
+	void UnbindFunction(ScriptFunction function);
+	bool IsFunctionBound(ScriptFunction function) const;
+	bool CallBatch(ScriptFunction function, float dt, ScriptBatch* pBatch);
+	static void ReleaseBatchTables(ScriptBatch* pBatch);
+
+	// Frame statistics
+	void NewFrame();
+	int GetLastFrameNumCalls() const;
+	double GetLastFrameTime() const;
+	int GetTotalNumCalls() const;
+	double GetTotalTime() const;
+
+protected:
+	/* Protected methods */
+	ScriptManager();
+	ScriptManager(const ScriptManager&);
+	ScriptManager &operator=(const ScriptManager&);
+
+private:
+	/* Private methods */
+	void RegisterFunctions();
+
+	bool PushTableField(const char* table, const char* key);
+	bool CallProtected(int numArgs, int numResults);
+
+	static void _InstructionBudgetHook(lua_State* pState, lua_Debug* pDebug);
+
+	double GetElapsedTime();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	lua_State* m_pState;
+	sel::State* m_pSeleneState;
+
+	// Cache statistics
+	int m_numCachedLoads;
+	int m_numCompiledLoads;
+
+	// Per frame cost, times in milliseconds
+	int m_frameNumCalls;
+	double m_frameTime;
+	int m_lastFrameNumCalls;
+	double m_lastFrameTime;
+	int m_totalNumCalls;
+	double m_totalTime;
+
+	// Singleton instance
+	static ScriptManager *c_instance;
+};
+
+// The default location for cache files
+const char* GetScriptCacheDirectory();
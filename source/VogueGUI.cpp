@@ -18,6 +18,11 @@
 #include <algorithm>
 using namespace std;
 
+// Stress test layout
+const int NUM_STRESS_TEST_BUTTONS = 5000;
+const int STRESS_TEST_BUTTONS_PER_ROW = 100;
+const int STRESS_TEST_BUTTON_SIZE = 8;
+
 
 VogueGUI::VogueGUI(Renderer* pRenderer, OpenGLGUI* pGUI, int width, int height)
 {
@@ -68,6 +73,10 @@ void VogueGUI::CreateGUI()
 	m_pInstanceRenderCheckBox->SetDimensions(10, 136, 14, 14);
 	m_pDebugRenderCheckBox = new CheckBox(m_pRenderer, m_defaultGUIFont, "DebugRender");
 	m_pDebugRenderCheckBox->SetDimensions(10, 154, 14, 14);
+	m_pGUIStressCheckBox = new CheckBox(m_pRenderer, m_defaultGUIFont, "GUIStress");
+	m_pGUIStressCheckBox->SetDimensions(120, 10, 14, 14);
+	m_pProfilerCheckBox = new CheckBox(m_pRenderer, m_defaultGUIFont, "Profiler");
+	m_pProfilerCheckBox->SetDimensions(120, 28, 14, 14);
 
 	// Params
 	m_pGenderMaleOptionBox = new OptionBox(m_pRenderer, m_defaultGUIFont, "Male");
@@ -110,11 +119,16 @@ void VogueGUI::CreateGUI()
 	m_pSkinWindow->SetRenderWindowBackground(true);
 	m_pSkinWindow->SetOutlineRender(true);
 	m_pSkinWindow->SetDimensions(350, 35, 320, 180);
+
+	// Stress test
+	m_pStressTestWindow = NULL;
 }
 
 // Destruction
 void VogueGUI::DestroyGUI()
 {
+	DestroyStressTestGUI();
+
 	delete m_pMainWindow;
 	delete m_pShadowsCheckBox;
 	delete m_pSSAOCheckBox;
@@ -125,6 +139,8 @@ void VogueGUI::DestroyGUI()
 	delete m_pDeferredCheckBox;
 	delete m_pDebugRenderCheckBox;
 	delete m_pInstanceRenderCheckBox;
+	delete m_pGUIStressCheckBox;
+	delete m_pProfilerCheckBox;
 
 	delete m_pGenderOptionController;
 	delete m_pGenderMaleOptionBox;
@@ -149,6 +165,8 @@ void VogueGUI::SetupGUI()
 	m_pMainWindow->AddComponent(m_pDeferredCheckBox);
 	m_pMainWindow->AddComponent(m_pDebugRenderCheckBox);
 	m_pMainWindow->AddComponent(m_pInstanceRenderCheckBox);
+	m_pMainWindow->AddComponent(m_pGUIStressCheckBox);
+	m_pMainWindow->AddComponent(m_pProfilerCheckBox);
 
 	m_pDeferredCheckBox->SetToggled(true);
 	m_pDynamicLightingCheckBox->SetToggled(true);
@@ -175,6 +193,11 @@ void VogueGUI::SignalResize(int width, int height)
 
 	m_pMainWindow->SetApplicationDimensions(m_windowWidth, m_windowHeight);
 	m_pSkinWindow->SetApplicationDimensions(m_windowWidth, m_windowHeight);
+
+	if (m_pStressTestWindow != NULL)
+	{
+		m_pStressTestWindow->SetApplicationDimensions(m_windowWidth, m_windowHeight);
+	}
 }
 
 // Skinning
@@ -211,6 +234,74 @@ void VogueGUI::UpdateGUI(float dt)
 	{
 		m_pGenerateFromSeedButton->SetDisabled(false);
 	}
+
+	// Stress test
+	if (m_pGUIStressCheckBox->GetToggled())
+	{
+		if (m_pStressTestWindow == NULL)
+		{
+			CreateStressTestGUI();
+		}
+	}
+	else
+	{
+		if (m_pStressTestWindow != NULL)
+		{
+			DestroyStressTestGUI();
+		}
+	}
+}
+
+// Stress test
+void VogueGUI::CreateStressTestGUI()
+{
+	int numRows = NUM_STRESS_TEST_BUTTONS / STRESS_TEST_BUTTONS_PER_ROW;
+
+	m_pStressTestWindow = new GUIWindow(m_pRenderer, m_defaultGUIFont, "GUI Stress");
+	m_pStressTestWindow->AllowMoving(true);
+	m_pStressTestWindow->AllowClosing(false);
+	m_pStressTestWindow->AllowMinimizing(true);
+	m_pStressTestWindow->AllowScrolling(false);
+	m_pStressTestWindow->SetRenderTitleBar(true);
+	m_pStressTestWindow->SetRenderWindowBackground(true);
+	m_pStressTestWindow->SetOutlineRender(true);
+	m_pStressTestWindow->SetDimensions(15, 240, STRESS_TEST_BUTTONS_PER_ROW * STRESS_TEST_BUTTON_SIZE, numRows * STRESS_TEST_BUTTON_SIZE);
+
+	for (int i = 0; i < NUM_STRESS_TEST_BUTTONS; i++)
+	{
+		int x = (i % STRESS_TEST_BUTTONS_PER_ROW) * STRESS_TEST_BUTTON_SIZE;
+		int y = (i / STRESS_TEST_BUTTONS_PER_ROW) * STRESS_TEST_BUTTON_SIZE;
+
+		Button* pButton = new Button(m_pRenderer, m_defaultGUIFont, "");
+		pButton->SetDimensions(x, y, STRESS_TEST_BUTTON_SIZE - 1, STRESS_TEST_BUTTON_SIZE - 1);
+		m_pStressTestWindow->AddComponent(pButton);
+
+		m_vpStressTestButtons.push_back(pButton);
+	}
+
+	m_pStressTestWindow->SetApplicationDimensions(m_windowWidth, m_windowHeight);
+
+	m_pGUI->AddWindow(m_pStressTestWindow);
+}
+
+void VogueGUI::DestroyStressTestGUI()
+{
+	if (m_pStressTestWindow == NULL)
+	{
+		return;
+	}
+
+	m_pGUI->RemoveWindow(m_pStressTestWindow);
+
+	for (unsigned int i = 0; i < m_vpStressTestButtons.size(); i++)
+	{
+		m_pStressTestWindow->RemoveComponent(m_vpStressTestButtons[i]);
+		delete m_vpStressTestButtons[i];
+	}
+	m_vpStressTestButtons.clear();
+
+	delete m_pStressTestWindow;
+	m_pStressTestWindow = NULL;
 }
 
 // Game functionality
@@ -44,6 +44,10 @@ public:
 	// Update
 	void UpdateGUI(float dt);
 
+	// Stress test
+	void CreateStressTestGUI();
+	void DestroyStressTestGUI();
+
 	// Game functionality
 	ePlayerSex GetPlayerSex();
 
@@ -88,6 +92,8 @@ private:
 	CheckBox* m_pBlurCheckBox;
 	CheckBox* m_pDebugRenderCheckBox;
 	CheckBox* m_pInstanceRenderCheckBox;
+	CheckBox* m_pGUIStressCheckBox;
+	CheckBox* m_pProfilerCheckBox;
 
 	// Params
 	OptionController* m_pGenderOptionController;
@@ -101,6 +107,10 @@ private:
 	// SKin
 	GUIWindow* m_pSkinWindow;
 
+	// Stress test
+	GUIWindow* m_pStressTestWindow;
+	vector<Button*> m_vpStressTestButtons;
+
 	// Friend class
 	friend class VogueGame;
 };
\ No newline at end of file
@@ -14,10 +14,12 @@
 #include "VogueGame.h"
 #include "utils/Interpolator.h"
 #include "utils/Random.h"
+#include "Scripting/ScriptManager.h"
+#include "models/AnimatedSectionBatch.h"
 #include <glm/detail/func_geometric.hpp>
 
 #ifdef __linux__
-#include <sys/time.h>
+#include <time.h>
 #endif //__linux__
 
 
@@ -37,12 +39,17 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 {
 	m_pRenderer = NULL;
 	m_pGameCamera = NULL;
+	m_pLightClusters = NULL;
 	m_pVogueGUI = NULL;
 
 	m_pPlayer = NULL;
+	m_pSceneTransforms = NULL;
 	m_pTileManager = NULL;
 	m_pRoomManager = NULL;
 	m_pInstanceManager = NULL;
+	m_pParticleManager = NULL;
+	m_pImpostorCache = NULL;
+	m_pFaceQuadBatch = NULL;
 	m_pQubicleBinaryManager = NULL;
 
 	m_GUICreated = false;
@@ -59,14 +66,23 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	QueryPerformanceCounter(&m_fpsCurrentTicks);
 	QueryPerformanceFrequency(&m_fpsTicksPerSecond);
 #else
-	struct timeval tm;
-	gettimeofday(&tm, NULL);
-	m_fpsCurrentTicks = (double)tm.tv_sec + (double)tm.tv_usec / 1000000.0;
-	m_fpsPreviousTicks = (double)tm.tv_sec + (double)tm.tv_usec / 1000000.0;
+	struct timespec tm;
+	clock_gettime(CLOCK_MONOTONIC, &tm);
+	m_fpsCurrentTicks = (double)tm.tv_sec + (double)tm.tv_nsec / 1000000000.0;
+	m_fpsPreviousTicks = (double)tm.tv_sec + (double)tm.tv_nsec / 1000000000.0;
 #endif //_WIN32
 	m_deltaTime = 0.0f;
 	m_fps = 0.0f;
 
+	/* Setup the fixed timestep simulation */
+	int tickRate = m_pVogueSettings->m_simulationTickRate > 0 ? m_pVogueSettings->m_simulationTickRate : 60;
+	m_fixedTimeStep = 1.0f / (float)tickRate;
+	m_simulationAccumulator = 0.0f;
+	m_interpolationAlpha = 1.0f;
+	m_maxSimulationTicksPerFrame = m_pVogueSettings->m_maxSimulationTicksPerFrame > 0 ? m_pVogueSettings->m_maxSimulationTicksPerFrame : 1;
+	m_numSimulationTicks = 0;
+	m_GUIUpdateTime = 0.0f;
+
 	/* Mouse name picking */
 	m_pickedObject = -1;
 	m_bNamePickingSelected = false;
@@ -117,26 +133,62 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	m_pRenderer->CreateLight(Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(0.0f, 0.0f, 0.0f, 1.0f),
 							 m_defaultLightPosition, lightDirection, 0.0f, 0.0f, 1.0f, 0.5f, 0.0025f, true, false, &m_defaultLight);
 
+	/* Create the light clusters, covering the same frustum as the default viewport */
+	m_pLightClusters = new LightClusters();
+	m_pLightClusters->SetProjection(m_pRenderer->GetViewportFov(m_defaultViewport), (float)m_windowWidth / (float)m_windowHeight, m_pRenderer->GetClipNear(), m_pRenderer->GetClipFar());
+	m_clusteredLighting = m_pRenderer->CreateTextureBuffer(true, &m_clusterLightBuffer);
+	m_pRenderer->CreateTextureBuffer(false, &m_clusterGridBuffer);
+	m_pRenderer->CreateTextureBuffer(false, &m_clusterIndexBuffer);
+
 	/* Create materials */
 	m_pRenderer->CreateMaterial(Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(1.0f, 1.0f, 1.0f, 1.0f), Colour(0.0f, 0.0f, 0.0f, 1.0f), 64, &m_defaultMaterial);
 
 	/* Create the frame buffers */
+	// Pooled render targets, targets that are never live in the same pass share a frame buffer
 	bool frameBufferCreated = false;
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "SSAO", &m_SSAOFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 5.0f, "Shadow", &m_shadowFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Deferred Lighting", &m_lightingFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Transparency", &m_transparencyFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Water Reflection", &m_waterReflectionFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FXAA", &m_FXAAFrameBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 1st Pass", &m_firstPassFullscreenBuffer);
-	frameBufferCreated = m_pRenderer->CreateFrameBuffer(-1, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 2nd Pass", &m_secondPassFullscreenBuffer);
+	RenderTargetDesc gBufferDesc;
+	gBufferDesc.m_position = true;
+	gBufferDesc.m_normal = true;
+	gBufferDesc.m_depth = true;
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(gBufferDesc, RenderPass_Scene, RenderPass_SSAO, "SSAO", &m_SSAOFrameBuffer);
+
+	RenderTargetDesc occlusionDesc;
+	occlusionDesc.m_viewportScale = SSAO_RESOLUTION_SCALE;
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(occlusionDesc, RenderPass_Occlusion, RenderPass_SSAO, "Occlusion", &m_occlusionFrameBuffer);
+
+	// The shadow maps are depth only and a fixed power of two size, whatever the window size
+	RenderTargetDesc shadowDesc;
+	shadowDesc.m_diffuse = false;
+	shadowDesc.m_depth = true;
+	shadowDesc.m_sizeClass = RenderTargetSizeClass_Fixed;
+	shadowDesc.m_width = m_pVogueSettings->m_shadowMapSize;
+	shadowDesc.m_height = m_pVogueSettings->m_shadowMapSize;
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(shadowDesc, RenderPass_Shadow, RenderPass_Scene, "Shadow", &m_shadowFrameBuffer);
+	// The static casters are kept from one frame to the next, so this target is live for the whole frame
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(shadowDesc, RenderPass_Shadow, RenderPass_BlurVertical, "Static Shadow", &m_staticShadowFrameBuffer);
+
+	// Nothing renders into the lighting buffer yet, so it is kept for the whole frame rather than letting another pass overwrite it
+	RenderTargetDesc colourDesc;
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(colourDesc, RenderPass_Shadow, RenderPass_BlurVertical, "Deferred Lighting", &m_lightingFrameBuffer);
+
+	RenderTargetDesc colourDepthDesc;
+	colourDepthDesc.m_depth = true;
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(colourDepthDesc, RenderPass_Transparency, RenderPass_SSAO, "Transparency", &m_transparencyFrameBuffer);
+
+	// Post processing ping-pong, the 1st pass buffer can be written by the SSAO pass when FXAA is off
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(colourDesc, RenderPass_SSAO, RenderPass_FXAA, "FXAA", &m_FXAAFrameBuffer);
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(colourDesc, RenderPass_SSAO, RenderPass_BlurHorizontal, "FullScreen 1st Pass", &m_firstPassFullscreenBuffer);
+	frameBufferCreated = m_pRenderer->CreateRenderTarget(colourDesc, RenderPass_BlurHorizontal, RenderPass_BlurVertical, "FullScreen 2nd Pass", &m_secondPassFullscreenBuffer);
 
 	/* Create the shaders */
 	bool shaderLoaded = false;
 	m_defaultShader = -1;
 	m_phongShader = -1;
 	m_SSAOShader = -1;
+	m_compositeShader = -1;
+	m_compositeFXAAShader = -1;
 	m_shadowShader = -1;
+	m_shadowDepthShader = -1;
 	m_waterShader = -1;
 	m_lightingShader = -1;
 	m_cubeMapShader = -1;
@@ -147,15 +199,31 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/default.vertex", "media/shaders/default.pixel", &m_defaultShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/phong.vertex", "media/shaders/phong.pixel", &m_phongShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/shadow.vertex", "media/shaders/shadow.pixel", &m_shadowShader);
+	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/shadow_depth.vertex", "media/shaders/shadow_depth.pixel", &m_shadowDepthShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/water_still.vertex", "media/shaders/water_still.pixel", &m_waterShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/texture.vertex", "media/shaders/texture.pixel", &m_textureShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/SSAO.vertex", "media/shaders/fullscreen/SSAO.pixel", &m_SSAOShader);
+	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/composite.vertex", "media/shaders/fullscreen/composite.pixel", &m_compositeShader);
+	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/composite.vertex", "media/shaders/fullscreen/composite_fxaa.pixel", &m_compositeFXAAShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/fxaa.vertex", "media/shaders/fullscreen/fxaa.pixel", &m_fxaaShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/lighting.vertex", "media/shaders/fullscreen/lighting.pixel", &m_lightingShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/cube_map.vertex", "media/shaders/cube_map.pixel", &m_cubeMapShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/blur_vertical.vertex", "media/shaders/fullscreen/blur_vertical.pixel", &m_blurVerticalShader);
 	shaderLoaded = m_pRenderer->LoadGLSLShader("media/shaders/fullscreen/blur_horizontal.vertex", "media/shaders/fullscreen/blur_horizontal.pixel", &m_blurHorizontalShader);
 
+	/* Create the post processing chain */
+	m_SSAOPass = m_postProcessChain.AddPass("SSAO", PostProcessPassType_Default, SSAO_RESOLUTION_SCALE);
+	m_compositePass = m_postProcessChain.AddPass("Composite", PostProcessPassType_Composite, 1.0f);
+	m_FXAAPass = m_postProcessChain.AddPass("FXAA", PostProcessPassType_Antialiasing, 1.0f);
+	m_blurHorizontalPass = m_postProcessChain.AddPass("Blur H", PostProcessPassType_Blur, 1.0f);
+	m_blurVerticalPass = m_postProcessChain.AddPass("Blur V", PostProcessPassType_Blur, 1.0f);
+	for (int i = 0; i < m_postProcessChain.GetNumPasses(); i++)
+	{
+		unsigned int timerId;
+		m_pRenderer->CreateGPUTimer(m_postProcessChain.GetPassName(i), &timerId);
+		m_vPostProcessTimers.push_back(timerId);
+	}
+
 	/* Create the GUI */
 	m_pVogueGUI = new VogueGUI(m_pRenderer, m_pGUI, m_windowWidth, m_windowHeight);
 
@@ -165,14 +233,26 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	/* Create the instance manager */
 	m_pInstanceManager = new InstanceManager(m_pRenderer);
 
+	/* Create the particle manager */
+	m_pParticleManager = new ParticleManager(m_pRenderer);
+
+	/* Create the character impostor cache */
+	m_pImpostorCache = new CharacterImpostorCache(m_pRenderer, RenderPass_Shadow, RenderPass_BlurVertical);
+
+	/* Create the face quad batch */
+	m_pFaceQuadBatch = new FaceQuadBatch(m_pRenderer);
+
+	/* Create the scene transforms */
+	m_pSceneTransforms = new TransformHierarchy();
+
 	/* Create the tile manager */
-	m_pTileManager = new TileManager(m_pRenderer, m_pQubicleBinaryManager);
+	m_pTileManager = new TileManager(m_pRenderer, m_pQubicleBinaryManager, m_pSceneTransforms);
 
 	/* Create the room manager */
 	m_pRoomManager = new RoomManager(m_pRenderer, m_pTileManager, m_pInstanceManager);
 	
 	/* Create the player */
-	m_pPlayer = new Player(m_pRenderer, m_pQubicleBinaryManager);
+	m_pPlayer = new Player(m_pRenderer, m_pQubicleBinaryManager, m_pSceneTransforms);
 
 	// Keyboard movement
 	m_bKeyboardForward = false;
@@ -211,6 +291,14 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	// Water
 	m_elapsedWaterTime = 0.0f;
 
+	// Static shadow cache
+	m_staticShadowsValid = false;
+	m_staticShadowNumTiles = 0;
+	m_staticShadowNumDecoratedRooms = 0;
+	m_staticShadowNumInstances = 0;
+	m_staticShadowInstanceRender = false;
+	m_numStaticShadowRebuilds = 0;
+
 	// Toggle flags
 	m_deferredRendering = true;
 	m_multiSampling = true;
@@ -222,6 +310,7 @@ void VogueGame::Create(VogueSettings* pVogueSettings)
 	m_debugRender = false;
 	m_wireframeRender = false;
 	m_instanceRender = false;
+	m_profilerRender = false;
 
 	// Camera mode
 	m_cameraMode = CameraMode_Debug;
@@ -257,10 +346,18 @@ void VogueGame::Destroy()
 		delete m_pRoomManager;
 		delete m_pTileManager;
 		delete m_pPlayer;
+		delete m_pSceneTransforms;
 
+		delete m_pFaceQuadBatch;
+		delete m_pImpostorCache;
+		delete m_pParticleManager;
 		delete m_pInstanceManager;
 		delete m_pQubicleBinaryManager;
 
+		ScriptManager::GetInstance()->Destroy();
+		AnimatedSectionBatch::GetInstance()->Destroy();
+
+		delete m_pLightClusters;
 		delete m_pGameCamera;
 		delete m_pVogueGUI;  // Destroy the GUI components before we delete the opengl GUI manager object.
 		delete m_pGUI;
@@ -347,17 +444,13 @@ void VogueGame::ResizeWindow(int width, int height)
 
 		// Resize the main viewport
 		m_pRenderer->ResizeViewport(m_defaultViewport, 0, 0, m_windowWidth, m_windowHeight, 60.0f);
+		if (m_pLightClusters != NULL)
+		{
+			m_pLightClusters->SetProjection(m_pRenderer->GetViewportFov(m_defaultViewport), (float)m_windowWidth / (float)m_windowHeight, m_pRenderer->GetClipNear(), m_pRenderer->GetClipFar());
+		}
 
-		// Resize the frame buffers
-		bool frameBufferResize = false;
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_SSAOFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "SSAO", &m_SSAOFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_shadowFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 5.0f, "Shadow", &m_shadowFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_lightingFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Deferred Lighting", &m_lightingFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_transparencyFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Transparency", &m_transparencyFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_waterReflectionFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "Water Reflection", &m_waterReflectionFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_FXAAFrameBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FXAA", &m_FXAAFrameBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_firstPassFullscreenBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 1st Pass", &m_firstPassFullscreenBuffer);
-		frameBufferResize = m_pRenderer->CreateFrameBuffer(m_secondPassFullscreenBuffer, true, true, true, true, m_windowWidth, m_windowHeight, 1.0f, "FullScreen 2nd Pass", &m_secondPassFullscreenBuffer);
+		// Resize the frame buffers, only the screen sized ones are recreated
+		m_pRenderer->ResizeRenderTargets(m_windowWidth, m_windowHeight);
 	}
 
 	if (m_pVogueGUI)
@@ -19,8 +19,10 @@
 #pragma once
 
 #include "Renderer/Renderer.h"
+#include "Renderer/postprocesschain.h"
 #include "gui/openglgui.h"
 #include "Renderer/camera.h"
+#include "Renderer/lightclusters.h"
 #include "VogueWindow.h"
 #include "VogueSettings.h"
 #include "VogueGUI.h"
@@ -29,6 +31,9 @@
 #include "room/TileManager.h"
 #include "Player/Player.h"
 #include "Instance/InstanceManager.h"
+#include "Particles/ParticleManager.h"
+#include "models/CharacterImpostorCache.h"
+#include "models/FaceQuadBatch.h"
 
 #ifdef __linux__
 typedef struct POINT {
@@ -54,6 +59,27 @@ enum CameraMode
 	CameraMode_MouseRotate,
 };
 
+// Render passes, in the order they run each frame. Render targets are pooled by which of these they are live for.
+enum RenderPass
+{
+	RenderPass_Shadow = 0,
+	RenderPass_Scene,
+	RenderPass_Transparency,
+	RenderPass_Occlusion,
+	RenderPass_SSAO,
+	RenderPass_FXAA,
+	RenderPass_BlurHorizontal,
+	RenderPass_BlurVertical,
+};
+
+// The occlusion is worked out at this fraction of the screen resolution, then upsampled when it is composited
+const float SSAO_RESOLUTION_SCALE = 0.5f;
+
+// The shadow map covers this radius around the player, the light view is snapped to a grid of the snap distance in light space.
+// The map is grown by half the snap distance so the player's surroundings are always covered, wherever they are within a grid cell.
+const float SHADOW_RADIUS = 5.0f;
+const float SHADOW_SNAP_DISTANCE = 2.0f;
+
 class VogueGame
 {
 public:
@@ -130,6 +156,7 @@ public:
 
 	// Updating
 	void Update();
+	void UpdateSimulation(float dt);
 	void UpdateNamePicking();
 	void UpdateLights(float dt);
 	void UpdateGameGUI(float dt);
@@ -140,13 +167,16 @@ public:
 	void EndShaderRender();
 	void Render();
 	void RenderShadows();
+	void UpdateLightClusters();
 	void RenderTransparency();
 	void RenderSSAOTexture();
+	void RenderCompositeTexture();
 	void RenderFXAATexture();
 	void RenderFirstPassFullScreen();
 	void RenderSecondPassFullScreen();
 	void RenderGUI();
 	void RenderDebugInformation();
+	void RenderProfiler();
 
 	// Accessors
 	unsigned int GetDefaultViewport();
@@ -223,10 +253,11 @@ private:
 
 	// Frame buffers
 	unsigned int m_SSAOFrameBuffer;
+	unsigned int m_occlusionFrameBuffer;
 	unsigned int m_shadowFrameBuffer;
+	unsigned int m_staticShadowFrameBuffer;
 	unsigned int m_lightingFrameBuffer;
 	unsigned int m_transparencyFrameBuffer;
-	unsigned int m_waterReflectionFrameBuffer;
 	unsigned int m_FXAAFrameBuffer;
 	unsigned int m_firstPassFullscreenBuffer;
 	unsigned int m_secondPassFullscreenBuffer;
@@ -235,7 +266,10 @@ private:
 	unsigned int m_defaultShader;
 	unsigned int m_phongShader;
 	unsigned int m_SSAOShader;
+	unsigned int m_compositeShader;
+	unsigned int m_compositeFXAAShader;
 	unsigned int m_shadowShader;
+	unsigned int m_shadowDepthShader;
 	unsigned int m_waterShader;
 	unsigned int m_lightingShader;
 	unsigned int m_cubeMapShader;
@@ -244,6 +278,34 @@ private:
 	unsigned int m_blurVerticalShader;
 	unsigned int m_blurHorizontalShader;
 
+	// Static shadow cache, only re-rendered when the light view or the static casters change
+	bool m_staticShadowsValid;
+	vec3 m_staticShadowLightTarget;
+	int m_staticShadowNumTiles;
+	int m_staticShadowNumDecoratedRooms;
+	int m_staticShadowNumInstances;
+	bool m_staticShadowInstanceRender;
+	int m_numStaticShadowRebuilds;
+
+	// The light's orthographic view, for culling the shadow casters
+	Frustum m_shadowFrustum;
+
+	// Clustered dynamic lights, binned every frame and read by the lit shader from texture buffers
+	LightClusters* m_pLightClusters;
+	unsigned int m_clusterLightBuffer;
+	unsigned int m_clusterGridBuffer;
+	unsigned int m_clusterIndexBuffer;
+	bool m_clusteredLighting;
+
+	// Post processing, the passes that run are worked out each frame and each one is timed on the GPU
+	PostProcessChain m_postProcessChain;
+	unsigned int m_SSAOPass;
+	unsigned int m_compositePass;
+	unsigned int m_FXAAPass;
+	unsigned int m_blurHorizontalPass;
+	unsigned int m_blurVerticalPass;
+	vector<unsigned int> m_vPostProcessTimers;
+
 	// Custom cursor textures
 	unsigned int m_customCursorNormalBuffer;
 	unsigned int m_customCursorClickedBuffer;
@@ -262,6 +324,16 @@ private:
 	float m_deltaTime;
 	float m_fps;
 
+	// Fixed timestep simulation
+	float m_fixedTimeStep;
+	float m_simulationAccumulator;
+	float m_interpolationAlpha;
+	int m_maxSimulationTicksPerFrame;
+	int m_numSimulationTicks;
+
+	// GUI update timing, in milliseconds
+	float m_GUIUpdateTime;
+
 	// Initial starting wait timer
 	float m_initialWaitTimer;
 	float m_initialWaitTime;
@@ -318,6 +390,7 @@ private:
 	bool m_debugRender;
 	bool m_wireframeRender;
 	bool m_instanceRender;
+	bool m_profilerRender;
 
 	// Game objects
 	// Qubicle binary manager
@@ -326,9 +399,21 @@ private:
 	// Instance manager
 	InstanceManager* m_pInstanceManager;
 
+	// Particle manager
+	ParticleManager* m_pParticleManager;
+
+	// Character impostor cache, for portraits and paperdolls in the GUI
+	CharacterImpostorCache* m_pImpostorCache;
+
+	// Face quad batch, the eyes and mouths of every character drawn together
+	FaceQuadBatch* m_pFaceQuadBatch;
+
 	// Room manager
 	RoomManager *m_pRoomManager;
 
+	// Scene transforms, world matrices cached for the tiles and the player
+	TransformHierarchy* m_pSceneTransforms;
+
 	// Tile manager
 	TileManager *m_pTileManager;
 
@@ -15,6 +15,7 @@
 using namespace std;
 
 #include "utils/Random.h"
+#include "utils/Profiler.h"
 #include "VogueGame.h"
 
 
@@ -262,6 +263,14 @@ void VogueGame::KeyReleased(int key, int scancode, int mods)
 			m_pPlayer->SetColourModifiers();
 			break;
 		}
+		case GLFW_KEY_P:
+		{
+			if (Profiler::GetInstance()->ExportChromeTrace("profile.json"))
+			{
+				cout << "Profiler: exported chrome trace to profile.json\n";
+			}
+			break;
+		}
 	}
 }
 
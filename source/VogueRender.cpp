@@ -10,6 +10,10 @@
 // ******************************************************************************
 
 #include "VogueGame.h"
+#include "gui/selectionmanager.h"
+#include "utils/Profiler.h"
+#include "Scripting/ScriptManager.h"
+#include "models/AnimatedSectionBatch.h"
 
 #include <glm/detail/func_geometric.hpp>
 
@@ -17,8 +21,13 @@
 // Rendering
 void VogueGame::PreRender()
 {
-	// Update matrices for game objects
-	m_pPlayer->CalculateWorldTransformMatrix();
+	// Update matrices for game objects, interpolated between the last two simulation ticks
+	m_pPlayer->CalculateWorldTransformMatrix(m_interpolationAlpha);
+	m_pPlayer->InterpolatePose(m_interpolationAlpha);
+	AnimatedSectionBatch::GetInstance()->SetInterpolationAlpha(m_interpolationAlpha);
+
+	// Compose the world matrices of anything that moved, a static scene does no work here
+	m_pSceneTransforms->Update();
 }
 
 void VogueGame::BeginShaderRender()
@@ -30,6 +39,25 @@ void VogueGame::BeginShaderRender()
 		m_pRenderer->BeginGLSLShader(m_shadowShader);
 
 		pShader = m_pRenderer->GetShader(m_shadowShader);
+
+		// Clustered dynamic lights, bound before the shadow map so the shadow map unit stays the active one
+		bool clusteredLighting = m_clusteredLighting && m_dynamicLighting && m_pLightClusters->GetNumLights() > 0;
+		glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "clusteredLighting"), clusteredLighting);
+		if (clusteredLighting)
+		{
+			m_pRenderer->PrepareShaderTexture(4, glGetUniformLocationARB(pShader->GetProgramObject(), "clusterLights"));
+			m_pRenderer->BindTextureBuffer(m_clusterLightBuffer);
+			m_pRenderer->PrepareShaderTexture(5, glGetUniformLocationARB(pShader->GetProgramObject(), "clusterGrid"));
+			m_pRenderer->BindTextureBuffer(m_clusterGridBuffer);
+			m_pRenderer->PrepareShaderTexture(6, glGetUniformLocationARB(pShader->GetProgramObject(), "clusterIndices"));
+			m_pRenderer->BindTextureBuffer(m_clusterIndexBuffer);
+
+			pShader->setUniform3f("clusterDimensions", (float)LIGHT_CLUSTERS_X, (float)LIGHT_CLUSTERS_Y, (float)LIGHT_CLUSTERS_Z);
+			pShader->setUniform2f("clusterScreenSize", (float)m_windowWidth, (float)m_windowHeight);
+			pShader->setUniform1f("clusterSliceScale", m_pLightClusters->GetSliceScale());
+			pShader->setUniform1f("clusterSliceBias", m_pLightClusters->GetSliceBias());
+		}
+
 		GLuint shadowMapUniform = glGetUniformLocationARB(pShader->GetProgramObject(), "ShadowMap");
 		m_pRenderer->PrepareShaderTexture(7, shadowMapUniform);
 		m_pRenderer->BindRawTextureId(m_pRenderer->GetDepthTextureFromFrameBuffer(m_shadowFrameBuffer));
@@ -58,6 +86,8 @@ void VogueGame::EndShaderRender()
 
 void VogueGame::Render()
 {
+	PROFILE_ZONE("VogueGame::Render");
+
 	if (m_pVogueWindow->GetMinimized())
 	{
 		// Don't call any render functions if minimized
@@ -67,6 +97,9 @@ void VogueGame::Render()
 	// Begin rendering
 	m_pRenderer->BeginScene(true, true, true);
 
+		// Portraits and paperdolls whose characters have changed since they were last cached
+		m_pImpostorCache->RenderImpostors();
+
 		// Shadow rendering to the shadow frame buffer
 		if (m_shadows)
 		{
@@ -95,6 +128,15 @@ void VogueGame::Render()
 			// Set the lookat camera
 			m_pGameCamera->Look();
 
+			// Only the rooms that can be seen from the camera are submitted
+			m_pRoomManager->UpdateVisibility(m_pRenderer->GetFrustum(m_defaultViewport));
+
+			// Bin the dynamic lights for this view
+			if (m_dynamicLighting)
+			{
+				UpdateLightClusters();
+			}
+
 			// Enable the lights
 			if (m_dynamicLighting)
 			{
@@ -134,16 +176,20 @@ void VogueGame::Render()
 
 			BeginShaderRender();
 			{
+				PROFILE_ZONE("Render Scene");
+
 				// Rooms
 				//m_pRoomManager->Render();
 
-				// Tile
+				// Tile, recorded and drawn sorted by state. Rooms don't create tiles yet, so only the headless report fills this list.
+				m_pRenderer->BeginDrawList();
 				m_pTileManager->Render();
+				m_pRenderer->EndDrawList();
 
-				// Instanced objects
+				// Instanced objects, already one instanced draw per parent mesh
 				m_pInstanceManager->Render();
 
-				// Player
+				// Player, drawn immediately since the outline and face passes rely on draw order
 				m_pPlayer->Render();
 			}
 			EndShaderRender();
@@ -163,14 +209,27 @@ void VogueGame::Render()
 		// Render our deferred textures from the frame buffers
 		if (m_deferredRendering)
 		{
-			RenderSSAOTexture();
+			PROFILE_ZONE("Post Processing");
+
+			m_postProcessChain.SetPassEnabled(m_SSAOPass, m_ssao);
+			m_postProcessChain.SetPassEnabled(m_FXAAPass, m_multiSampling && m_fxaaShader != -1 && m_compositeFXAAShader != -1);
+			m_postProcessChain.SetPassEnabled(m_blurHorizontalPass, m_blur);
+			m_postProcessChain.SetPassEnabled(m_blurVerticalPass, m_blur);
+			m_postProcessChain.Build();
+
+			if (m_postProcessChain.IsPassRun(m_SSAOPass))
+			{
+				RenderSSAOTexture();
+			}
 
-			if (m_multiSampling && m_fxaaShader != -1)
+			RenderCompositeTexture();
+
+			if (m_postProcessChain.IsPassRun(m_FXAAPass))
 			{
 				RenderFXAATexture();
 			}
 			
-			if (m_blur)
+			if (m_postProcessChain.IsPassRun(m_blurHorizontalPass))
 			{
 				RenderFirstPassFullScreen();
 				RenderSecondPassFullScreen();
@@ -201,38 +260,123 @@ void VogueGame::Render()
 
 void VogueGame::RenderShadows()
 {
+	PROFILE_ZONE("RenderShadows");
+
+	// The light looks along a fixed direction, work out its axes
+	vec3 lightZ = normalize(m_defaultLightPosition);
+	vec3 lightX = normalize(cross(vec3(0.0f, 1.0f, 0.0f), lightZ));
+	vec3 lightY = cross(lightZ, lightX);
+
+	// Snap the light's target to a grid in light space, in whole shadow map texels, so the cached static depth stays valid while
+	// the player moves within a grid cell and the shadow edges don't crawl when it is rebuilt
+	float shadowRadius = SHADOW_RADIUS + (SHADOW_SNAP_DISTANCE * 0.5f);
+	float texelSize = (shadowRadius * 2.0f) / m_pVogueSettings->m_shadowMapSize;
+	float snapDistance = floorf(SHADOW_SNAP_DISTANCE / texelSize) * texelSize;
+
+	vec3 playerPosition = m_pPlayer->GetPosition();
+	float snappedX = floorf((dot(playerPosition, lightX) / snapDistance) + 0.5f) * snapDistance;
+	float snappedY = floorf((dot(playerPosition, lightY) / snapDistance) + 0.5f) * snapDistance;
+	float snappedZ = floorf((dot(playerPosition, lightZ) / snapDistance) + 0.5f) * snapDistance;
+	vec3 lightTarget = (lightX * snappedX) + (lightY * snappedY) + (lightZ * snappedZ);
+	vec3 lightPos = m_defaultLightPosition + lightTarget; // Make sure our light is always offset from the player
+
+	m_shadowFrustum.SetOrthographicCamera(lightPos, lightTarget, vec3(0.0f, 1.0f, 0.0f), shadowRadius, shadowRadius, 0.01f, 1000.0f);
+
+	// The static casters only need rendering again when the light has moved to another grid cell or the world has changed
+	int numTiles = m_pTileManager->GetNumTiles();
+	int numDecoratedRooms = m_pRoomManager->GetNumDecoratedRooms();
+	int numInstances = m_pInstanceManager->GetTotalNumInstanceObjects();
+	if(m_staticShadowsValid == false || lightTarget != m_staticShadowLightTarget ||
+		numTiles != m_staticShadowNumTiles || numDecoratedRooms != m_staticShadowNumDecoratedRooms || numInstances != m_staticShadowNumInstances ||
+		m_instanceRender != m_staticShadowInstanceRender)
+	{
+		m_pRenderer->PushMatrix();
+			m_pRenderer->StartRenderingToFrameBuffer(m_staticShadowFrameBuffer);
+
+			m_pRenderer->SetupOrthographicProjection(-shadowRadius, shadowRadius, -shadowRadius, shadowRadius, 0.01f, 1000.0f);
+			m_pRenderer->SetLookAtCamera(vec3(lightPos.x, lightPos.y, lightPos.z), lightTarget, vec3(0.0f, 1.0f, 0.0f));
+
+			m_pRenderer->PushMatrix();
+				m_pRenderer->SetCullMode(CM_FRONT);
+
+				// Render the tiles
+				m_pRenderer->BeginGLSLShader(m_shadowDepthShader);
+				m_pTileManager->RenderDepthOnly(&m_shadowFrustum);
+				m_pRenderer->EndGLSLShader(m_shadowDepthShader);
+
+				// Render the instanced objects
+				if(m_instanceRender)
+				{
+					m_pInstanceManager->RenderDepthOnly(&m_shadowFrustum);
+				}
+
+				m_pRenderer->SetCullMode(CM_BACK);
+			m_pRenderer->PopMatrix();
+
+			m_pRenderer->StopRenderingToFrameBuffer(m_staticShadowFrameBuffer);
+		m_pRenderer->PopMatrix();
+
+		m_staticShadowsValid = true;
+		m_staticShadowLightTarget = lightTarget;
+		m_staticShadowNumTiles = numTiles;
+		m_staticShadowNumDecoratedRooms = numDecoratedRooms;
+		m_staticShadowNumInstances = numInstances;
+		m_staticShadowInstanceRender = m_instanceRender;
+		m_numStaticShadowRebuilds++;
+	}
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->StartRenderingToFrameBuffer(m_shadowFrameBuffer);
-		m_pRenderer->SetColourMask(false, false, false, false);
 
-		float shadowRadius = 5.0f;
+		// Start from the cached static depth, then add the dynamic casters on top
+		m_pRenderer->CopyFrameBufferDepth(m_staticShadowFrameBuffer, m_shadowFrameBuffer);
+
 		m_pRenderer->SetupOrthographicProjection(-shadowRadius, shadowRadius, -shadowRadius, shadowRadius, 0.01f, 1000.0f);
-		vec3 lightPos = m_defaultLightPosition + m_pPlayer->GetPosition(); // Make sure our light is always offset from the player
-		m_pRenderer->SetLookAtCamera(vec3(lightPos.x, lightPos.y, lightPos.z), m_pPlayer->GetPosition(), vec3(0.0f, 1.0f, 0.0f));
+		m_pRenderer->SetLookAtCamera(vec3(lightPos.x, lightPos.y, lightPos.z), lightTarget, vec3(0.0f, 1.0f, 0.0f));
 
 		m_pRenderer->PushMatrix();
 			m_pRenderer->SetCullMode(CM_FRONT);
 
 			// Render the player
+			m_pRenderer->BeginGLSLShader(m_shadowDepthShader);
+			m_pRenderer->StartDepthOnlyRender();
 			m_pPlayer->Render();
-
-			// Render the instanced objects
-			if(m_instanceRender)
-			{
-				m_pInstanceManager->Render();
-			}
+			m_pRenderer->EndDepthOnlyRender();
+			m_pRenderer->EndGLSLShader(m_shadowDepthShader);
 
 			m_pRenderer->SetTextureMatrix();
 			m_pRenderer->SetCullMode(CM_BACK);
 		m_pRenderer->PopMatrix();
 
-		m_pRenderer->SetColourMask(true, true, true, true);
 		m_pRenderer->StopRenderingToFrameBuffer(m_shadowFrameBuffer);
 	m_pRenderer->PopMatrix();
 }
 
+void VogueGame::UpdateLightClusters()
+{
+	PROFILE_ZONE("UpdateLightClusters");
+
+	// The camera has just been set, so the modelview is the view matrix
+	Matrix4x4 viewMatrix;
+	m_pRenderer->GetModelViewMatrix(&viewMatrix);
+
+	m_pLightClusters->ClearLights();
+	m_pLightClusters->SetView(viewMatrix);
+	m_pPlayer->AddWeaponLights(m_pLightClusters);
+	m_pLightClusters->Build();
+
+	if (m_clusteredLighting)
+	{
+		m_pRenderer->UpdateTextureBuffer(m_clusterLightBuffer, m_pLightClusters->GetLightData(), m_pLightClusters->GetNumLights() * LIGHT_CLUSTERS_LIGHT_FLOATS);
+		m_pRenderer->UpdateTextureBuffer(m_clusterGridBuffer, m_pLightClusters->GetClusterData(), LIGHT_CLUSTERS_NUM * 2);
+		m_pRenderer->UpdateTextureBuffer(m_clusterIndexBuffer, m_pLightClusters->GetLightIndices(), m_pLightClusters->GetNumLightIndices());
+	}
+}
+
 void VogueGame::RenderTransparency()
 {
+	PROFILE_ZONE("RenderTransparency");
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_PERSPECTIVE, m_defaultViewport);
 		m_pRenderer->SetCullMode(CM_BACK);
@@ -245,7 +389,13 @@ void VogueGame::RenderTransparency()
 			m_pRenderer->StartRenderingToFrameBuffer(m_transparencyFrameBuffer);
 		}
 
-		m_pPlayer->RenderFace();
+		// Every face collected into world space quads, then one streamed draw per face atlas
+		m_pPlayer->RenderFace(m_pFaceQuadBatch);
+		m_pFaceQuadBatch->Render();
+
+		// One streamed draw per particle texture
+		m_pParticleManager->BuildVertices(m_pGameCamera->GetRight(), m_pGameCamera->GetUp());
+		m_pParticleManager->Render();
 
 		if (m_deferredRendering)
 		{
@@ -256,22 +406,69 @@ void VogueGame::RenderTransparency()
 
 void VogueGame::RenderSSAOTexture()
 {
+	m_pRenderer->BeginGPUTimer(m_vPostProcessTimers[m_SSAOPass]);
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
-		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
 
-		if (m_multiSampling)
+		// Reduced resolution, the composite pass upsamples it
+		m_pRenderer->StartRenderingToFrameBuffer(m_occlusionFrameBuffer);
+
+		// SSAO shader
+		m_pRenderer->BeginGLSLShader(m_SSAOShader);
+		glShader* pShader = m_pRenderer->GetShader(m_SSAOShader);
+
+		unsigned int textureId0 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_DepthTexture");
+		m_pRenderer->PrepareShaderTexture(0, textureId0);
+		m_pRenderer->BindRawTextureId(m_pRenderer->GetDepthTextureFromFrameBuffer(m_SSAOFrameBuffer));
+
+		pShader->setUniform1i("screenWidth", m_windowWidth);
+		pShader->setUniform1i("screenHeight", m_windowHeight);
+		pShader->setUniform1f("nearZ", 0.01f);
+		pShader->setUniform1f("farZ", 1000.0f);
+
+		pShader->setUniform1f("samplingMultiplier", 1.5f);
+
+		m_pRenderer->SetRenderMode(RM_TEXTURED);
+		m_pRenderer->RenderFullScreenTriangle();
+
+		m_pRenderer->EmptyTextureIndex(0);
+
+		m_pRenderer->EndGLSLShader(m_SSAOShader);
+
+		m_pRenderer->StopRenderingToFrameBuffer(m_occlusionFrameBuffer);
+	m_pRenderer->PopMatrix();
+
+	m_pRenderer->EndGPUTimer(m_vPostProcessTimers[m_SSAOPass]);
+}
+
+void VogueGame::RenderCompositeTexture()
+{
+	m_pRenderer->BeginGPUTimer(m_vPostProcessTimers[m_compositePass]);
+
+	// The antialiasing is either run as part of this pass, or reads what this pass writes
+	bool antialias = (m_postProcessChain.GetFusedInto(m_FXAAPass) == (int)m_compositePass);
+	unsigned int compositeShader = antialias ? m_compositeFXAAShader : m_compositeShader;
+
+	// Written to the input of whichever pass runs next
+	bool renderToFXAA = m_postProcessChain.IsPassRun(m_FXAAPass);
+	bool renderToBlur = (renderToFXAA == false && m_postProcessChain.IsPassRun(m_blurHorizontalPass));
+
+	m_pRenderer->PushMatrix();
+		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
+
+		if (renderToFXAA)
 		{
 			m_pRenderer->StartRenderingToFrameBuffer(m_FXAAFrameBuffer);
 		}
-		else if (m_blur)
+		else if (renderToBlur)
 		{
 			m_pRenderer->StartRenderingToFrameBuffer(m_firstPassFullscreenBuffer);
 		}
 
-		// SSAO shader
-		m_pRenderer->BeginGLSLShader(m_SSAOShader);
-		glShader* pShader = m_pRenderer->GetShader(m_SSAOShader);
+		// Composite shader, occlusion, lighting and transparency in one pass
+		m_pRenderer->BeginGLSLShader(compositeShader);
+		glShader* pShader = m_pRenderer->GetShader(compositeShader);
 
 		unsigned int textureId0 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_DepthTexture");
 		m_pRenderer->PrepareShaderTexture(0, textureId0);
@@ -293,54 +490,56 @@ void VogueGame::RenderSSAOTexture()
 		m_pRenderer->PrepareShaderTexture(4, textureId4);
 		m_pRenderer->BindRawTextureId(m_pRenderer->GetDepthTextureFromFrameBuffer(m_transparencyFrameBuffer));
 
-		pShader->setUniform1i("screenWidth", m_windowWidth);
-		pShader->setUniform1i("screenHeight", m_windowHeight);
+		unsigned int textureId5 = glGetUniformLocationARB(pShader->GetProgramObject(), "bgl_OcclusionTexture");
+		m_pRenderer->PrepareShaderTexture(5, textureId5);
+		m_pRenderer->BindRawTextureId(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_occlusionFrameBuffer));
+
+		if (antialias)
+		{
+			pShader->setUniform1i("screenWidth", m_windowWidth);
+			pShader->setUniform1i("screenHeight", m_windowHeight);
+		}
+		pShader->setUniform1i("occlusionWidth", (int)(m_windowWidth*SSAO_RESOLUTION_SCALE));
+		pShader->setUniform1i("occlusionHeight", (int)(m_windowHeight*SSAO_RESOLUTION_SCALE));
 		pShader->setUniform1f("nearZ", 0.01f);
 		pShader->setUniform1f("farZ", 1000.0f);
 
-		pShader->setUniform1f("samplingMultiplier", 1.5f);
-
 		pShader->setUniform1i("lighting_enabled", m_dynamicLighting);
-		pShader->setUniform1i("ssao_enabled", m_ssao);
+		pShader->setUniform1i("ssao_enabled", m_postProcessChain.IsPassRun(m_SSAOPass));
 
 		m_pRenderer->SetRenderMode(RM_TEXTURED);
-		m_pRenderer->EnableImmediateMode(IM_QUADS);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
-			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, (float)m_windowHeight, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
-			m_pRenderer->ImmediateVertex(0.0f, (float)m_windowHeight, 1.0f);
-		m_pRenderer->DisableImmediateMode();
+		m_pRenderer->RenderFullScreenTriangle();
 
+		m_pRenderer->EmptyTextureIndex(5);
 		m_pRenderer->EmptyTextureIndex(4);
 		m_pRenderer->EmptyTextureIndex(3);
 		m_pRenderer->EmptyTextureIndex(2);
 		m_pRenderer->EmptyTextureIndex(1);
 		m_pRenderer->EmptyTextureIndex(0);
 
-		m_pRenderer->EndGLSLShader(m_SSAOShader);
+		m_pRenderer->EndGLSLShader(compositeShader);
 
-		if (m_multiSampling)
+		if (renderToFXAA)
 		{
 			m_pRenderer->StopRenderingToFrameBuffer(m_FXAAFrameBuffer);
 		}
-		else if (m_blur)
+		else if (renderToBlur)
 		{
 			m_pRenderer->StopRenderingToFrameBuffer(m_firstPassFullscreenBuffer);
 		}
 	m_pRenderer->PopMatrix();
+
+	m_pRenderer->EndGPUTimer(m_vPostProcessTimers[m_compositePass]);
 }
 
 void VogueGame::RenderFXAATexture()
 {
+	m_pRenderer->BeginGPUTimer(m_vPostProcessTimers[m_FXAAPass]);
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
-		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
 
-		if (m_blur)
+		if (m_postProcessChain.IsPassRun(m_blurHorizontalPass))
 		{
 			m_pRenderer->StartRenderingToFrameBuffer(m_firstPassFullscreenBuffer);
 		}
@@ -356,33 +555,27 @@ void VogueGame::RenderFXAATexture()
 		m_pRenderer->BindRawTextureId(m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_FXAAFrameBuffer));
 
 		m_pRenderer->SetRenderMode(RM_TEXTURED);
-		m_pRenderer->EnableImmediateMode(IM_QUADS);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
-			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, (float)m_windowHeight, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
-			m_pRenderer->ImmediateVertex(0.0f, (float)m_windowHeight, 1.0f);
-		m_pRenderer->DisableImmediateMode();
+		m_pRenderer->RenderFullScreenTriangle();
 
 		m_pRenderer->EmptyTextureIndex(0);
 
 		m_pRenderer->EndGLSLShader(m_fxaaShader);
 
-		if (m_blur)
+		if (m_postProcessChain.IsPassRun(m_blurHorizontalPass))
 		{
 			m_pRenderer->StopRenderingToFrameBuffer(m_firstPassFullscreenBuffer);
 		}
 	m_pRenderer->PopMatrix();
+
+	m_pRenderer->EndGPUTimer(m_vPostProcessTimers[m_FXAAPass]);
 }
 
 void VogueGame::RenderFirstPassFullScreen()
 {
+	m_pRenderer->BeginGPUTimer(m_vPostProcessTimers[m_blurHorizontalPass]);
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
-		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
 
 		// Blur first pass (Horizontal)
 		m_pRenderer->StartRenderingToFrameBuffer(m_secondPassFullscreenBuffer);
@@ -404,29 +597,23 @@ void VogueGame::RenderFirstPassFullScreen()
 		pShader->setUniform1f("blurSize", blurSize);
 
 		m_pRenderer->SetRenderMode(RM_TEXTURED);
-		m_pRenderer->EnableImmediateMode(IM_QUADS);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
-			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, (float)m_windowHeight, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
-			m_pRenderer->ImmediateVertex(0.0f, (float)m_windowHeight, 1.0f);
-		m_pRenderer->DisableImmediateMode();
+		m_pRenderer->RenderFullScreenTriangle();
 
 		m_pRenderer->EmptyTextureIndex(0);
 
 		m_pRenderer->EndGLSLShader(m_blurHorizontalShader);
 		m_pRenderer->StopRenderingToFrameBuffer(m_secondPassFullscreenBuffer);
 	m_pRenderer->PopMatrix();
+
+	m_pRenderer->EndGPUTimer(m_vPostProcessTimers[m_blurHorizontalPass]);
 }
 
 void VogueGame::RenderSecondPassFullScreen()
 {
+	m_pRenderer->BeginGPUTimer(m_vPostProcessTimers[m_blurVerticalPass]);
+
 	m_pRenderer->PushMatrix();
 		m_pRenderer->SetProjectionMode(PM_2D, m_defaultViewport);
-		m_pRenderer->SetLookAtCamera(vec3(0.0f, 0.0f, 250.0f), vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 1.0f, 0.0f));
 
 		// Blur second pass (Vertical)
 		m_pRenderer->BeginGLSLShader(m_blurVerticalShader);
@@ -450,25 +637,20 @@ void VogueGame::RenderSecondPassFullScreen()
 		glUniform1iARB(glGetUniformLocationARB(pShader->GetProgramObject(), "applyBlueTint"), applyBlueTint);
 
 		m_pRenderer->SetRenderMode(RM_TEXTURED);
-		m_pRenderer->EnableImmediateMode(IM_QUADS);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
-			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
-			m_pRenderer->ImmediateVertex((float)m_windowWidth, (float)m_windowHeight, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
-			m_pRenderer->ImmediateVertex(0.0f, (float)m_windowHeight, 1.0f);
-		m_pRenderer->DisableImmediateMode();
+		m_pRenderer->RenderFullScreenTriangle();
 
 		m_pRenderer->EmptyTextureIndex(0);
 
 		m_pRenderer->EndGLSLShader(m_blurVerticalShader);
 	m_pRenderer->PopMatrix();
+
+	m_pRenderer->EndGPUTimer(m_vPostProcessTimers[m_blurVerticalPass]);
 }
 
 void VogueGame::RenderGUI()
 {
+	PROFILE_ZONE("RenderGUI");
+
 	m_pRenderer->EmptyTextureIndex(0);
 
 	// Render the GUI
@@ -494,21 +676,45 @@ void VogueGame::RenderDebugInformation()
 		m_pGameCamera->GetZoomAmount());
 
 	char lDrawingBuff[256];
-	sprintf(lDrawingBuff, "Vertices: %i, Faces: %i", m_pRenderer->GetNumRenderedVertices(), m_pRenderer->GetNumRenderedFaces());
+	sprintf(lDrawingBuff, "Vertices: %i, Faces: %i, Draws: %i, State changes: %i (%i redundant), Shadow cache rebuilds: %i, Face quads: %i in %i draws, Transforms: %i/%i", m_pRenderer->GetNumRenderedVertices(), m_pRenderer->GetNumRenderedFaces(),
+		m_pRenderer->GetNumDrawCalls(), m_pRenderer->GetNumStateChanges(), m_pRenderer->GetNumRedundantStateChanges(), m_numStaticShadowRebuilds, m_pFaceQuadBatch->GetNumQuads(), m_pFaceQuadBatch->GetNumDrawCalls(),
+		m_pSceneTransforms->GetNumUpdated(), m_pSceneTransforms->GetNumNodes());
 
 	char lRoomsBuff[256];
 	sprintf(lRoomsBuff, "Rooms: %i, ConnectionList: %i, Item: %i (%i), Boss: %i (%i)", m_pRoomManager->GetNumRooms(), m_pRoomManager->GetNumConnectionRoomsPossible(),
 		m_pRoomManager->GetNumItemRooms(), m_pRoomManager->GetNumItemRoomsPossible(), m_pRoomManager->GetNumBossRooms(), m_pRoomManager->GetNumBossRoomsPossible());
 	
 	char lInstancesBuff[256];
-	sprintf(lInstancesBuff, "Instance Parents: %i, Instance Objects: %i, Instance Render: %i", m_pInstanceManager->GetNumInstanceParents(), m_pInstanceManager->GetTotalNumInstanceObjects(), m_pInstanceManager->GetTotalNumInstanceRenderObjects());
+	sprintf(lInstancesBuff, "Instance Parents: %i, Instance Objects: %i, Instance Render: %i, Particles: %i (%i dropped) in %i pools", m_pInstanceManager->GetNumInstanceParents(), m_pInstanceManager->GetTotalNumInstanceObjects(), m_pInstanceManager->GetTotalNumInstanceRenderObjects(),
+		m_pParticleManager->GetNumParticles(), m_pParticleManager->GetNumDroppedParticles(), m_pParticleManager->GetNumPools());
+
+	char lLightsBuff[256];
+	sprintf(lLightsBuff, "Dynamic Lights: %i (%i dropped), Cluster entries: %i, Most in a cluster: %i", m_pLightClusters->GetNumLights(), m_pLightClusters->GetNumDroppedLights(),
+		m_pLightClusters->GetNumLightIndices(), m_pLightClusters->GetMaxClusterLights());
+
+	char lGUIBuff[256];
+	sprintf(lGUIBuff, "GUI Selectable: %i, GUI Update: %.3fms, Impostors: %i (%i rendered, %i cached)", SelectionManager::GetInstance()->GetNumComponents(), m_GUIUpdateTime,
+		m_pImpostorCache->GetNumImpostors(), m_pImpostorCache->GetNumRendered(), m_pImpostorCache->GetNumCached());
+
+	char lScriptsBuff[256];
+	sprintf(lScriptsBuff, "Script Calls: %i, Script Time: %.3fms", ScriptManager::GetInstance()->GetLastFrameNumCalls(), ScriptManager::GetInstance()->GetLastFrameTime());
+
+	char lPostProcessBuff[512];
+	int postProcessLength = sprintf(lPostProcessBuff, "Post: %i passes, %.2f screens written (%.2f unfused)", m_postProcessChain.GetNumRunPasses(), m_postProcessChain.GetScreenWrites(), m_postProcessChain.GetUnfusedScreenWrites());
+	for (int i = 0; i < m_postProcessChain.GetNumPasses(); i++)
+	{
+		if (m_postProcessChain.IsPassRun(i))
+		{
+			postProcessLength += sprintf(&lPostProcessBuff[postProcessLength], ", %s: %.3fms", m_postProcessChain.GetPassName(i).c_str(), m_pRenderer->GetGPUTimerMilliseconds(m_vPostProcessTimers[i]));
+		}
+	}
 
 	char lFPSBuff[128];
 	float fpsWidthOffset = 65.0f;
 	if (m_debugRender)
 	{
-		sprintf(lFPSBuff, "Delta: %.4f  FPS: %.0f", m_deltaTime, m_fps);
-		fpsWidthOffset = 135.0f;
+		sprintf(lFPSBuff, "Ticks: %i  Delta: %.4f  FPS: %.0f", m_numSimulationTicks, m_deltaTime, m_fps);
+		fpsWidthOffset = 190.0f;
 	}
 	else
 	{
@@ -536,10 +742,87 @@ void VogueGame::RenderDebugInformation()
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 2) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lDrawingBuff);
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 3) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lRoomsBuff);
 			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 4) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lInstancesBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 5) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lGUIBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 6) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lScriptsBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 7) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lPostProcessBuff);
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, m_windowHeight - (l_nTextHeight * 8) - 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lLightsBuff);
 		}
 
 		m_pRenderer->RenderFreeTypeText(m_defaultFont, m_windowWidth-fpsWidthOffset, 10.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lFPSBuff);
 		m_pRenderer->RenderFreeTypeText(m_defaultFont, 10.0f, 10.0f, 1.0f, Colour(0.75f, 0.75f, 0.75f), 1.0f, lBuildInfo);
 
+		if (m_profilerRender)
+		{
+			RenderProfiler();
+		}
 	m_pRenderer->PopMatrix();
+}
+
+void VogueGame::RenderProfiler()
+{
+	// Flame style breakdown of the last frame, each nesting depth is a row and each zone is scaled to its share of the frame
+	static vector<ProfileZoneRecord> zones;
+	Profiler::GetInstance()->GetLastFrameZones(zones);
+
+	double frameStart = Profiler::GetInstance()->GetLastFrameStartTime();
+	double frameTime = Profiler::GetInstance()->GetLastFrameTime() * 1000.0;
+	if (frameTime <= 0.0)
+	{
+		return;
+	}
+
+	float graphLeft = 10.0f;
+	float graphWidth = (float)m_windowWidth - 20.0f;
+	float graphBottom = 30.0f;
+	float rowHeight = 16.0f;
+	int l_nTextHeight = m_pRenderer->GetFreeTypeTextHeight(m_defaultFont, "a");
+
+	int maxDepth = 0;
+	m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+	m_pRenderer->EnableImmediateMode(IM_QUADS);
+	for (unsigned int i = 0; i < zones.size(); i++)
+	{
+		float x1 = graphLeft + (float)((zones[i].m_startTime - frameStart) / frameTime) * graphWidth;
+		float x2 = graphLeft + (float)((zones[i].m_endTime - frameStart) / frameTime) * graphWidth;
+		float y1 = graphBottom + zones[i].m_depth * rowHeight;
+		float y2 = y1 + rowHeight - 1.0f;
+
+		if (zones[i].m_depth > maxDepth)
+		{
+			maxDepth = zones[i].m_depth;
+		}
+
+		// Colour by zone name, so the same zone keeps the same colour each frame
+		unsigned int hash = (unsigned int)((size_t)zones[i].m_name >> 3) * 2654435761u;
+		float r = 0.4f + 0.6f * ((hash >> 8) & 255) / 255.0f;
+		float g = 0.3f + 0.5f * ((hash >> 16) & 255) / 255.0f;
+		float b = 0.2f + 0.3f * ((hash >> 24) & 255) / 255.0f;
+
+		m_pRenderer->ImmediateColourAlpha(r, g, b, 0.85f);
+		m_pRenderer->ImmediateVertex(x1, y1, 1.0f);
+		m_pRenderer->ImmediateVertex(x2, y1, 1.0f);
+		m_pRenderer->ImmediateVertex(x2, y2, 1.0f);
+		m_pRenderer->ImmediateVertex(x1, y2, 1.0f);
+	}
+	m_pRenderer->DisableImmediateMode();
+	m_pRenderer->DisableTransparency();
+
+	// Only label the zones that are wide enough to fit their name
+	char lZoneBuff[128];
+	for (unsigned int i = 0; i < zones.size(); i++)
+	{
+		float x1 = graphLeft + (float)((zones[i].m_startTime - frameStart) / frameTime) * graphWidth;
+		float x2 = graphLeft + (float)((zones[i].m_endTime - frameStart) / frameTime) * graphWidth;
+		float y1 = graphBottom + zones[i].m_depth * rowHeight;
+
+		sprintf(lZoneBuff, "%s %.2fms", zones[i].m_name, (zones[i].m_endTime - zones[i].m_startTime) / 1000.0);
+		if (m_pRenderer->GetFreeTypeTextWidth(m_defaultFont, "%s", lZoneBuff) + 4.0f < x2 - x1)
+		{
+			m_pRenderer->RenderFreeTypeText(m_defaultFont, x1 + 2.0f, y1 + (rowHeight - l_nTextHeight) * 0.5f, 1.0f, Colour(0.0f, 0.0f, 0.0f), 1.0f, lZoneBuff);
+		}
+	}
+
+	char lFrameBuff[128];
+	sprintf(lFrameBuff, "Profiler Frame: %.3fms, Zones: %i", frameTime / 1000.0, (int)zones.size());
+	m_pRenderer->RenderFreeTypeText(m_defaultFont, graphLeft, graphBottom + (maxDepth + 1) * rowHeight + 4.0f, 1.0f, Colour(1.0f, 1.0f, 1.0f), 1.0f, lFrameBuff);
 }
\ No newline at end of file
@@ -23,6 +23,11 @@ using namespace std;
 
 VogueSettings::VogueSettings()
 {
+	// Defaults in case the settings file can't be loaded
+	m_shadowMapSize = 2048;
+
+	m_simulationTickRate = 60;
+	m_maxSimulationTicksPerFrame = 5;
 }
 
 VogueSettings::~VogueSettings()
@@ -47,6 +52,18 @@ void VogueSettings::LoadSettings()
 	m_vsync = reader.GetBoolean("Graphics", "VSync", false);
 	m_fullscreen = reader.GetBoolean("Graphics", "FullScreen", false);
 
+	// Rounded up to a power of two
+	int shadowMapSize = reader.GetInteger("Graphics", "ShadowMapSize", 2048);
+	m_shadowMapSize = 256;
+	while (m_shadowMapSize < shadowMapSize && m_shadowMapSize < 8192)
+	{
+		m_shadowMapSize <<= 1;
+	}
+
+	// Simulation
+	m_simulationTickRate = reader.GetInteger("Simulation", "TickRate", 60);
+	m_maxSimulationTicksPerFrame = reader.GetInteger("Simulation", "MaxTicksPerFrame", 5);
+
 	// Debug
 	m_debugRendering = reader.GetBoolean("Debug", "DebugRendering", false);
 	m_gameMode = reader.Get("Debug", "GameMode", "Debug");
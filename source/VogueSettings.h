@@ -57,6 +57,11 @@ public:
 	int m_windowHeight;
 	bool m_vsync;
 	bool m_fullscreen;
+	int m_shadowMapSize;
+
+	// Simulation
+	int m_simulationTickRate;
+	int m_maxSimulationTicksPerFrame;
 
 	// Debug
 	bool m_debugRendering;
@@ -13,24 +13,31 @@
 
 #include "utils/Interpolator.h"
 #include "utils/TimeManager.h"
+#include "utils/Profiler.h"
+#include "Scripting/ScriptManager.h"
+#include "models/AnimatedSectionBatch.h"
+
+#include <chrono>
 
 #ifdef __linux__
-#include <sys/time.h>
+#include <time.h>
 #endif //__linux__
 
 
 // Updating
 void VogueGame::Update()
 {
+	PROFILE_ZONE("VogueGame::Update");
+
 	// FPS
 #ifdef _WIN32
 	QueryPerformanceCounter(&m_fpsCurrentTicks);
 	m_deltaTime = ((float)(m_fpsCurrentTicks.QuadPart - m_fpsPreviousTicks.QuadPart) / (float)m_fpsTicksPerSecond.QuadPart);
 #else
-	struct timeval tm;
-	gettimeofday(&tm, NULL);
-	m_fpsCurrentTicks = (double)tm.tv_sec + (double)tm.tv_usec / 1000000.0;
-	m_deltaTime = (m_fpsCurrentTicks - m_fpsPreviousTicks);
+	struct timespec tm;
+	clock_gettime(CLOCK_MONOTONIC, &tm);
+	m_fpsCurrentTicks = (double)tm.tv_sec + (double)tm.tv_nsec / 1000000000.0;
+	m_deltaTime = (float)(m_fpsCurrentTicks - m_fpsPreviousTicks);
 #endif //_WIN32
 	m_fps = 1.0f / m_deltaTime;
 	m_fpsPreviousTicks = m_fpsCurrentTicks;
@@ -42,14 +49,79 @@ void VogueGame::Update()
 		m_deltaTime = maxDeltaTime;
 	}
 
+	// Run the simulation in fixed size ticks, consuming the frame time that has built up
+	m_simulationAccumulator += m_deltaTime;
+	m_numSimulationTicks = 0;
+	while (m_simulationAccumulator >= m_fixedTimeStep && m_numSimulationTicks < m_maxSimulationTicksPerFrame)
+	{
+		PROFILE_ZONE("SimulationTick");
+
+		UpdateSimulation(m_fixedTimeStep);
+
+		m_simulationAccumulator -= m_fixedTimeStep;
+		m_numSimulationTicks++;
+	}
+
+	if (m_simulationAccumulator >= m_fixedTimeStep)
+	{
+		// We can't keep up, drop the time we couldn't simulate rather than spiralling further behind each frame
+		m_simulationAccumulator = fmod(m_simulationAccumulator, m_fixedTimeStep);
+	}
+
+	// How far we are between the previous and current simulation states, used to interpolate rendering
+	m_interpolationAlpha = m_simulationAccumulator / m_fixedTimeStep;
+
+	// Update the GUI
+	{
+		PROFILE_ZONE("GUI Update");
+
+		std::chrono::steady_clock::time_point GUIUpdateStart = std::chrono::steady_clock::now();
+		int x = m_pVogueWindow->GetCursorX();
+		int y = m_pVogueWindow->GetCursorY();
+		m_pGUI->Update(m_deltaTime);
+		if (IsCursorOn())
+		{
+			m_pGUI->ImportMouseMotion(x, m_windowHeight - y);
+		}
+		UpdateGameGUI(m_deltaTime);
+		m_GUIUpdateTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - GUIUpdateStart).count();
+	}
+
+	// Update controls
+	UpdateControls(m_deltaTime);
+
+	// Update the dynamic camera zoom
+	UpdateCameraZoom(m_deltaTime);
+	
+	// Update the camera
+	UpdateCamera(m_deltaTime);
+
+	// Update the application and window
+	m_pVogueWindow->Update(m_deltaTime);
+}
+
+void VogueGame::UpdateSimulation(float dt)
+{
+	// Start counting the script cost for this tick
+	ScriptManager::GetInstance()->NewFrame();
+
+	// Keep the animated section values this tick starts from, rendering blends from them
+	AnimatedSectionBatch::GetInstance()->BeginTick();
+
 	// Update interpolator singleton
-	Interpolator::GetInstance()->Update(m_deltaTime);
+	{
+		PROFILE_ZONE("Interpolator");
+		Interpolator::GetInstance()->Update(dt);
+	}
 
 	// Pause the interpolator we are are paused.
 	Interpolator::GetInstance()->SetPaused(m_bPaused);
 
 	// Update the time manager (countdowntimers);
-	TimeManager::GetInstance()->Update(m_deltaTime);
+	{
+		PROFILE_ZONE("TimeManager");
+		TimeManager::GetInstance()->Update(dt);
+	}
 
 	// Update the initial wait timer and variables, so we dont do gameplay updates straight away
 	if (m_initialStartWait == true)
@@ -60,43 +132,47 @@ void VogueGame::Update()
 		}
 		else
 		{
-			m_initialWaitTimer += m_deltaTime;
+			m_initialWaitTimer += dt;
 			m_initialStartWait = true;
 		}
 	}
 
-	// Update the GUI
-	int x = m_pVogueWindow->GetCursorX();
-	int y = m_pVogueWindow->GetCursorY();
-	m_pGUI->Update(m_deltaTime);
-	if (IsCursorOn())
-	{
-		m_pGUI->ImportMouseMotion(x, m_windowHeight - y);
-	}
-	UpdateGameGUI(m_deltaTime);
-
 	// Main components update
 	if (m_bPaused == false && m_initialStartWait == false)
 	{
-		m_pInstanceManager->Update(m_deltaTime);
+		{
+			PROFILE_ZONE("InstanceManager::Update");
+			m_pInstanceManager->Update(dt);
+		}
 
-		m_pRoomManager->Update(m_deltaTime);
-		m_pTileManager->Update(m_deltaTime);
+		{
+			PROFILE_ZONE("Rooms and Tiles");
+			m_pRoomManager->Update(dt);
+			m_pTileManager->Update(dt);
+		}
 
-		m_pPlayer->Update(m_deltaTime);
-	}
+		{
+			PROFILE_ZONE("Player::Update");
+			m_pPlayer->Update(dt);
+		}
 
-	// Update controls
-	UpdateControls(m_deltaTime);
+		{
+			// Step the animated sections of every weapon queued above in one pass
+			PROFILE_ZONE("AnimatedSectionBatch::Update");
+			AnimatedSectionBatch::GetInstance()->Update();
+		}
 
-	// Update the dynamic camera zoom
-	UpdateCameraZoom(m_deltaTime);
-	
-	// Update the camera
-	UpdateCamera(m_deltaTime);
+		{
+			PROFILE_ZONE("ParticleManager::Update");
+			m_pPlayer->UpdateWeaponParticleEffects(m_pParticleManager);
+			m_pParticleManager->Update(dt);
+		}
 
-	// Update the application and window
-	m_pVogueWindow->Update(m_deltaTime);
+		{
+			PROFILE_ZONE("CharacterImpostorCache::Update");
+			m_pImpostorCache->Update(dt);
+		}
+	}
 }
 
 void VogueGame::UpdateNamePicking()
@@ -129,6 +205,7 @@ void VogueGame::UpdateNamePicking()
 	// Pop attribs
 	glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);   // Enable rendering
 	glPopAttrib();
+	m_pRenderer->InvalidateStateCache();
 
 	if (m_pickedObject != -1)
 	{
@@ -158,6 +235,7 @@ void VogueGame::UpdateGameGUI(float dt)
 	m_debugRender = m_pVogueGUI->m_pDebugRenderCheckBox->GetToggled();
 	m_wireframeRender = m_pVogueGUI->m_pWireframeCheckBox->GetToggled();
 	m_instanceRender = m_pVogueGUI->m_pInstanceRenderCheckBox->GetToggled();
+	m_profilerRender = m_pVogueGUI->m_pProfilerCheckBox->GetToggled();
 
 	m_pPlayer->SetWireFrameRender(m_wireframeRender);
 	m_pInstanceManager->SetWireFrameRender(m_wireframeRender);
@@ -18,6 +18,8 @@
 #include "selectionmanager.h"
 #include "../utils/TimeManager.h"
 
+// Initialize the depth change counter
+unsigned int Component::c_depthChangeCount = 0;
 
 Component::Component(Renderer* pRenderer)
   : m_pRenderer(pRenderer)
@@ -39,6 +41,8 @@ Component::Component(Renderer* pRenderer)
 
 	m_dimensions = Dimensions(0, 0, 0, 0);
 
+	m_bScreenLocationDirty = true;
+
 	m_bMouseListenerRemoved = false;
 	m_bKeyListenerRemoved = false;
 	m_bFocusListenerRemoved = false;
@@ -101,6 +105,11 @@ float Component::GetTransparency() const
 
 void Component::SetDepth(float depth)
 {
+	if(m_depth != depth)
+	{
+		c_depthChangeCount++;
+	}
+
 	m_depth = depth;
 }
 
@@ -116,9 +125,16 @@ float Component::GetDepth() const
 	return depth;
 }
 
+unsigned int Component::GetDepthChangeCount()
+{
+	return c_depthChangeCount;
+}
+
 void Component::SetParent(Component *pParent)
 {
 	m_pParent = pParent;
+
+	SetScreenLocationDirty();
 }
 
 Component* Component::GetParent() const
@@ -135,22 +151,30 @@ void Component::SetLocation(int x, int y)
 {
 	m_dimensions.m_x = x;
 	m_dimensions.m_y = y;
+
+	SetScreenLocationDirty();
 }
 
 void Component::SetLocation(const Point& p)
 {
 	m_dimensions.m_x = p.m_x;
 	m_dimensions.m_y = p.m_y;
+
+	SetScreenLocationDirty();
 }
 
 void Component::SetX(int x)
 {
 	m_dimensions.m_x = x;
+
+	SetScreenLocationDirty();
 }
 
 void Component::SetY(int y)
 {
 	m_dimensions.m_y = y;
+
+	SetScreenLocationDirty();
 }
 
 void Component::GetLocation(int& x, int& y) const
@@ -168,6 +192,8 @@ void Component::SetSize(int width, int height)
 {
 	m_dimensions.m_width = width;
 	m_dimensions.m_height = height;
+
+	SelectionManager::GetInstance()->SetLayoutDirty();
 }
 
 void Component::GetSize(int& width, int& height)
@@ -188,20 +214,31 @@ bool Component::IsDebugRender()
 
 Point Component::GetLocationOnScreen() const
 {
-	// Start with this component's location, and add all parents locations
-	Point location = GetLocation();
-
-	for(Component* parent = GetParent(); parent != 0;)
+	if(m_bScreenLocationDirty)
 	{
-		Point parentLocation = parent->GetLocation();
+		// Start with this component's location, and add our parent's (cached) screen location
+		m_screenLocation = GetLocation();
+
+		if(m_pParent != NULL)
+		{
+			Point parentLocation = m_pParent->GetLocationOnScreen();
 
-		location.m_x += parentLocation.m_x;
-		location.m_y += parentLocation.m_y;
+			m_screenLocation.m_x += parentLocation.m_x;
+			m_screenLocation.m_y += parentLocation.m_y;
+		}
 
-		parent = parent->GetParent();
+		m_bScreenLocationDirty = false;
 	}
 
-	return location;
+	return m_screenLocation;
+}
+
+void Component::SetScreenLocationDirty()
+{
+	// The selection manager hit test rectangles are built from screen locations
+	SelectionManager::GetInstance()->SetLayoutDirty();
+
+	m_bScreenLocationDirty = true;
 }
 
 void Component::SetDimensions(int x, int y, int width, int height)
@@ -210,6 +247,8 @@ void Component::SetDimensions(int x, int y, int width, int height)
 	m_dimensions.m_y = y;
 	m_dimensions.m_width = width;
 	m_dimensions.m_height = height;
+
+	SetScreenLocationDirty();
 }
 
 void Component::SetDimensions(const Dimensions& r)
@@ -220,11 +259,15 @@ void Component::SetDimensions(const Dimensions& r)
 void Component::SetWidth(int width)
 {
 	m_dimensions.m_width = width;
+
+	SelectionManager::GetInstance()->SetLayoutDirty();
 }
 
 void Component::SetHeight(int height)
 {
 	m_dimensions.m_height = height;
+
+	SelectionManager::GetInstance()->SetLayoutDirty();
 }
 
 Dimensions Component::GetDimensions() const
@@ -103,6 +103,7 @@ public:
 
 	void SetDepth(float depth);
 	float GetDepth() const;
+	static unsigned int GetDepthChangeCount();
 		
 	void SetParent(Component *pParent);
 	Component* GetParent() const;
@@ -116,6 +117,7 @@ public:
 	void GetLocation(int& x, int& y) const;
 	Point GetLocation() const;
 	Point GetLocationOnScreen() const;
+	virtual void SetScreenLocationDirty();
 
 	void SetSize(int width, int height);
 	void GetSize(int& width, int& height);
@@ -210,4 +212,11 @@ private:
 	bool m_bFocusListenerRemoved;
 
 	Component* m_pParent;
+
+	// Cached absolute location, invalidated when we or any of our parents move
+	mutable Point m_screenLocation;
+	mutable bool m_bScreenLocationDirty;
+
+	// Incremented whenever any component changes depth, so depth sorting can be skipped when nothing has changed
+	static unsigned int c_depthChangeCount;
 };
\ No newline at end of file
@@ -21,7 +21,7 @@
 Container::Container(Renderer* pRenderer)
   : Component(pRenderer)
 {
-	/* Nothing */
+	m_sortedDepthChangeCount = Component::GetDepthChangeCount();
 }
 
 Container::~Container()
@@ -94,11 +94,19 @@ void Container::Add(Component* component)
 	// Make sure it appears on top of the container
 	//component->SetDepth(m_depth + 1.0f);
 
-	// Add the Component to the vector
-	m_vpComponentList.push_back(component);
+	if(m_sortedDepthChangeCount != Component::GetDepthChangeCount())
+	{
+		// Depths have changed since we last sorted, so do a full sort of the component vector list
+		m_vpComponentList.push_back(component);
 
-	// Sort the component vector list, by depth
-	DepthSortComponentChildren();
+		DepthSortComponentChildren();
+	}
+	else
+	{
+		// Our list is still in depth order, just insert the new component in the correct place
+		ComponentList::iterator iter = std::upper_bound(m_vpComponentList.begin(), m_vpComponentList.end(), component, Component::DepthLessThan);
+		m_vpComponentList.insert(iter, component);
+	}
 }
 
 void Container::Remove(Component* component)
@@ -141,6 +149,20 @@ int Container::GetNumberOfChildren() const
 void Container::DepthSortComponentChildren()
 {
 	sort(m_vpComponentList.begin(), m_vpComponentList.end(), Component::DepthLessThan);
+
+	m_sortedDepthChangeCount = Component::GetDepthChangeCount();
+}
+
+void Container::SetScreenLocationDirty()
+{
+	Component::SetScreenLocationDirty();
+
+	// All our children are positioned relative to us
+	ComponentList::const_iterator iterator;
+	for(iterator = m_vpComponentList.begin(); iterator != m_vpComponentList.end(); ++iterator)
+	{
+		(*iterator)->SetScreenLocationDirty();
+	}
 }
 
 Component* Container::GetChild(int n) const
@@ -53,6 +53,8 @@ public:
 
 	void DepthSortComponentChildren();
 
+	virtual void SetScreenLocationDirty();
+
 	EComponentType GetComponentType() const;
 
     virtual void SetAudio(bool set);
@@ -77,4 +79,5 @@ protected:
 
 private:
 	/* Private members */
+	unsigned int m_sortedDepthChangeCount;
 };
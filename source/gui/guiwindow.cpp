@@ -308,6 +308,8 @@ void GUIWindow::SetLocation(int x, int y)
 
     m_dimensions.m_x = x;
     m_dimensions.m_y = y;
+
+	SetScreenLocationDirty();
 }
 
 void GUIWindow::SetLocation(const Point& p)
@@ -318,6 +320,18 @@ void GUIWindow::SetLocation(const Point& p)
 	SetLocation(x, y);
 }
 
+void GUIWindow::SetScreenLocationDirty()
+{
+	Container::SetScreenLocationDirty();
+
+	// Child windows are not in our component list, but are still positioned relative to us
+	GUIWindowList::const_iterator iter;
+	for(iter = m_vpGUIWindowList.begin(); iter != m_vpGUIWindowList.end(); ++iter)
+	{
+		(*iter)->SetScreenLocationDirty();
+	}
+}
+
 void GUIWindow::SetTitle(const std::string &title)
 {
 	m_titleBar->SetTitle(title);
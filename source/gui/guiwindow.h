@@ -65,6 +65,8 @@ public:
     void SetLocation(int x, int y);
     void SetLocation(const Point& p);
 
+	void SetScreenLocationDirty();
+
 	void SetTitle(const std::string &title);
 	const std::string GetTitle() const;
 
@@ -21,6 +21,7 @@
 #include "focusmanager.h"
 
 #include "../Renderer/Renderer.h"
+#include "../utils/Profiler.h"
 
 
 OpenGLGUI::OpenGLGUI(Renderer* pRenderer)
@@ -31,6 +32,8 @@ OpenGLGUI::OpenGLGUI(Renderer* pRenderer)
 
 	m_currentWindowDepth = 1.0f;
 
+	m_sortedDepthChangeCount = Component::GetDepthChangeCount();
+
 	m_bDegubRender = false;
 
 	m_pFocusedWindow = NULL;
@@ -231,11 +234,18 @@ bool OpenGLGUI::IsDebugRender()
 
 void OpenGLGUI::Render()
 {
-	// Sort the GUI window vector list, by depth
-	DepthSortGUIWindowChildren();
+	PROFILE_ZONE("OpenGLGUI::Render");
 
-	// Sort the component vector list, by depth
-	DepthSortComponentChildren();
+	if(m_sortedDepthChangeCount != Component::GetDepthChangeCount())
+	{
+		// Sort the GUI window vector list, by depth
+		DepthSortGUIWindowChildren();
+
+		// Sort the component vector list, by depth
+		DepthSortComponentChildren();
+
+		m_sortedDepthChangeCount = Component::GetDepthChangeCount();
+	}
 
 	// Draw all the standalone components we contain
 	ComponentList::const_iterator iter_component;
@@ -268,6 +278,8 @@ void OpenGLGUI::ResetSelectionManager()
 
 void OpenGLGUI::Update(float deltaTime)
 {
+	PROFILE_ZONE("OpenGLGUI::Update");
+
 	// Update the selection manager
 	SelectionManager::GetInstance()->Update(m_mouseX, m_mouseY);
 
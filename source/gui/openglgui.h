@@ -128,6 +128,9 @@ private:
 
 	float m_currentWindowDepth;
 
+	// Depth change count when we last sorted, so we only re-sort when depths have changed
+	unsigned int m_sortedDepthChangeCount;
+
 	bool m_audio;
 	float m_audioVolume;
 
@@ -194,7 +194,7 @@ ScrollBar::ScrollBar(Renderer* pRenderer, const std::string &leftDefaultTexture,
 
 ScrollBar::~ScrollBar()
 {
-	TimeManager::GetInstance()->RemoveCountdownTimer(m_pArrowButtonUpdate);
+	delete m_pArrowButtonUpdate;
 
 	delete m_pLeftArrowDefault;
 	delete m_pLeftArrowHover;
@@ -921,6 +921,18 @@ void ScrollBar::SetDimensions(const Dimensions& r)
 	SetDimensions(r.m_x, r.m_y, r.m_width, r.m_height);
 }
 
+void ScrollBar::SetScreenLocationDirty()
+{
+	Container::SetScreenLocationDirty();
+
+	// Scroll area items are not in our component list, but are still positioned relative to us
+	ComponentList::const_iterator iterator;
+	for(iterator = m_vpScrollAreaComponentList.begin(); iterator != m_vpScrollAreaComponentList.end(); ++iterator)
+	{
+		(*iterator)->SetScreenLocationDirty();
+	}
+}
+
 void ScrollBar::AddScrollAreaItem(Component* component)
 {
 	component->SetParent(this);
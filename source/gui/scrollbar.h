@@ -68,6 +68,8 @@ public:
 	void SetDimensions(int x, int y, int width, int height);
 	void SetDimensions(const Dimensions& r);
 
+	void SetScreenLocationDirty();
+
 	void SetArrowDimensions(int width, int height);
 
 	void AddScrollAreaItem(Component* component);
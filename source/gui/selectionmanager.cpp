@@ -6,7 +6,9 @@
 //
 // Purpose:
 //   Handles the picking of components, events are sent to the currently
-//   selected component. This is worked out using component bounding boxes.
+//   selected component. This is worked out using component bounding boxes,
+//   which are bucketed into a uniform grid so that picking only needs to
+//   test the components that overlap the cell under the mouse.
 //
 // Note:
 //   The actual algorithm for working out what component is currently
@@ -28,6 +30,10 @@
 // Initialize the singleton instance
 SelectionManager *SelectionManager::c_instance = 0;
 
+// Spatial grid sizing
+const int MIN_GRID_CELL_SIZE = 32;
+const int MAX_GRID_CELLS_PER_AXIS = 128;
+
 SelectionManager* SelectionManager::GetInstance()
 {
 	if(c_instance == 0)
@@ -41,6 +47,7 @@ void SelectionManager::Destroy()
 	if(c_instance)
 	{
 		delete c_instance;
+		c_instance = 0;
 	}
 }
 
@@ -61,11 +68,20 @@ SelectionManager::SelectionManager()
 {
 	m_lastX = 0;
 	m_lastY = 0;
+
+	m_bLayoutDirty = true;
+	m_gridOriginX = 0;
+	m_gridOriginY = 0;
+	m_gridCellSize = MIN_GRID_CELL_SIZE;
+	m_gridWidth = 0;
+	m_gridHeight = 0;
 }
 
 void SelectionManager::AddComponent(Component* component)
 {
 	m_vpComponentList.push_back(component);
+
+	m_bLayoutDirty = true;
 }
 
 void SelectionManager::RemoveComponent(Component* component)
@@ -88,6 +104,106 @@ void SelectionManager::RemoveComponent(Component* component)
 	{
 		// Erase the component
 		m_vpComponentList.erase(iter);
+
+		m_bLayoutDirty = true;
+	}
+}
+
+int SelectionManager::GetNumComponents() const
+{
+	return (int)m_vpComponentList.size();
+}
+
+void SelectionManager::SetLayoutDirty()
+{
+	m_bLayoutDirty = true;
+}
+
+void SelectionManager::RebuildSpatialGrid()
+{
+	m_vGridCells.clear();
+	m_gridWidth = 0;
+	m_gridHeight = 0;
+
+	m_bLayoutDirty = false;
+
+	// Work out the bounds of all the component rectangles
+	bool lFoundRect = false;
+	int lMinX = 0;
+	int lMinY = 0;
+	int lMaxX = 0;
+	int lMaxY = 0;
+	ComponentList::const_iterator iterator;
+	for(iterator = m_vpComponentList.begin(); iterator != m_vpComponentList.end(); ++iterator)
+	{
+		Point l_location = (*iterator)->GetLocationOnScreen();
+		Dimensions l_dimensions = (*iterator)->GetDimensions();
+
+		if(l_dimensions.m_width <= 0 || l_dimensions.m_height <= 0)
+		{
+			continue;
+		}
+
+		if(lFoundRect == false)
+		{
+			lMinX = l_location.m_x;
+			lMinY = l_location.m_y;
+			lMaxX = l_location.m_x + l_dimensions.m_width;
+			lMaxY = l_location.m_y + l_dimensions.m_height;
+			lFoundRect = true;
+		}
+		else
+		{
+			lMinX = std::min(lMinX, l_location.m_x);
+			lMinY = std::min(lMinY, l_location.m_y);
+			lMaxX = std::max(lMaxX, l_location.m_x + l_dimensions.m_width);
+			lMaxY = std::max(lMaxY, l_location.m_y + l_dimensions.m_height);
+		}
+	}
+
+	if(lFoundRect == false)
+	{
+		return;
+	}
+
+	// Grow the cell size for very large layouts, so the grid stays a sensible size
+	int lExtent = std::max(lMaxX - lMinX, lMaxY - lMinY) + 1;
+	m_gridCellSize = MIN_GRID_CELL_SIZE;
+	while(lExtent / m_gridCellSize >= MAX_GRID_CELLS_PER_AXIS)
+	{
+		m_gridCellSize *= 2;
+	}
+
+	m_gridOriginX = lMinX;
+	m_gridOriginY = lMinY;
+	m_gridWidth = ((lMaxX - lMinX) / m_gridCellSize) + 1;
+	m_gridHeight = ((lMaxY - lMinY) / m_gridCellSize) + 1;
+	m_vGridCells.resize(m_gridWidth * m_gridHeight);
+
+	// Add each component index to every cell it overlaps, in list order, so that picking gives the same result as a linear scan
+	int lIndex = 0;
+	for(iterator = m_vpComponentList.begin(); iterator != m_vpComponentList.end(); ++iterator, ++lIndex)
+	{
+		Point l_location = (*iterator)->GetLocationOnScreen();
+		Dimensions l_dimensions = (*iterator)->GetDimensions();
+
+		if(l_dimensions.m_width <= 0 || l_dimensions.m_height <= 0)
+		{
+			continue;
+		}
+
+		int lStartX = (l_location.m_x - m_gridOriginX) / m_gridCellSize;
+		int lEndX = (l_location.m_x + l_dimensions.m_width - m_gridOriginX) / m_gridCellSize;
+		int lStartY = (l_location.m_y - m_gridOriginY) / m_gridCellSize;
+		int lEndY = (l_location.m_y + l_dimensions.m_height - m_gridOriginY) / m_gridCellSize;
+
+		for(int cellY = lStartY; cellY <= lEndY; cellY++)
+		{
+			for(int cellX = lStartX; cellX <= lEndX; cellX++)
+			{
+				m_vGridCells[cellX + cellY * m_gridWidth].push_back(lIndex);
+			}
+		}
 	}
 }
 
@@ -108,13 +224,34 @@ Component* SelectionManager::GetComponentAt(int x, int y)
 	// * Focus ordering
 	// ----------------------
 
-	ComponentList::const_iterator iterator;
+	if(m_bLayoutDirty)
+	{
+		RebuildSpatialGrid();
+	}
 
 	Component* lpWindowComponent = 0;
 	float lCurrentDepth = 0;
 
-	for(iterator = m_vpComponentList.begin(); iterator != m_vpComponentList.end(); ++iterator)
+	// Find the grid cell that we are in, only the components overlapping this cell can be selected
+	if(x < m_gridOriginX || y < m_gridOriginY)
+	{
+		return lpWindowComponent;
+	}
+
+	int lCellX = (x - m_gridOriginX) / m_gridCellSize;
+	int lCellY = (y - m_gridOriginY) / m_gridCellSize;
+	if(lCellX >= m_gridWidth || lCellY >= m_gridHeight)
 	{
+		return lpWindowComponent;
+	}
+
+	const std::vector<int>& lCell = m_vGridCells[lCellX + lCellY * m_gridWidth];
+
+	std::vector<int>::const_iterator cell_iterator;
+	for(cell_iterator = lCell.begin(); cell_iterator != lCell.end(); ++cell_iterator)
+	{
+		ComponentList::const_iterator iterator = m_vpComponentList.begin() + (*cell_iterator);
+
 		// We have only found a selection if the component is enabled
 		if((*iterator)->IsEnabled() && (*iterator)->IsVisible() && (*iterator)->IsParentEnabled() && (*iterator)->IsParentVisible())
 		{
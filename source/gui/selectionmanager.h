@@ -6,7 +6,9 @@
 //
 // Purpose:
 //   Handles the picking of components, events are sent to the currently
-//   selected component. This is worked out using component bounding boxes.
+//   selected component. This is worked out using component bounding boxes,
+//   which are bucketed into a uniform grid so that picking only needs to
+//   test the components that overlap the cell under the mouse.
 //
 // Note:
 //   The actual algorithm for working out what component is currently
@@ -37,6 +39,9 @@ public:
 
 	void AddComponent(Component* component);
 	void RemoveComponent(Component* component);
+	int GetNumComponents() const;
+
+	void SetLayoutDirty();
 
 	void Update(int x, int y);
 	Component* GetComponentAt(int x, int y);
@@ -56,6 +61,8 @@ private:
 	SelectionManager(const SelectionManager&);
 	SelectionManager& operator=(const SelectionManager&);
 
+	void RebuildSpatialGrid();
+
 public:
 	/* Public members */
 
@@ -66,6 +73,15 @@ private:
 	/* Private members */
 	ComponentList m_vpComponentList;
 
+	// Spatial grid of component screen rectangles, each cell stores indices into m_vpComponentList
+	bool m_bLayoutDirty;
+	int m_gridOriginX;
+	int m_gridOriginY;
+	int m_gridCellSize;
+	int m_gridWidth;
+	int m_gridHeight;
+	std::vector< std::vector<int> > m_vGridCells;
+
 	Component* m_foundComponent;
 	Component* m_hoverOverComponent;
 	Component* m_firstClickedComponent;
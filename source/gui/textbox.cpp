@@ -81,7 +81,7 @@ TextBox::TextBox(Renderer* pRenderer, unsigned int GUIFont, const std::string &d
 
 TextBox::~TextBox()
 {
-	TimeManager::GetInstance()->RemoveCountdownTimer(m_pPipeDisplayCountDown);
+	delete m_pPipeDisplayCountDown;
 
 	delete m_pBackgroundIcon;
 }
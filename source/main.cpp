@@ -15,6 +15,7 @@
 // ******************************************************************************
 
 #include "VogueGame.h"
+#include "utils/Profiler.h"
 
 int main(void)
 {
@@ -30,6 +31,9 @@ int main(void)
 	/* Loop until the user closes the window or application */
 	while (!pVogueGame->ShouldClose())
 	{
+		/* Profiler frame marker */
+		PROFILE_FRAME();
+
 		/* Poll input events*/
 		pVogueGame->PollEvents();
 
@@ -0,0 +1,368 @@
+// ******************************************************************************
+// Filename:    AnimatedSectionBatch.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "AnimatedSectionBatch.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define ANIMATED_SECTION_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+
+// Initialize the singleton instance
+AnimatedSectionBatch *AnimatedSectionBatch::c_instance = 0;
+
+AnimatedSectionBatch* AnimatedSectionBatch::GetInstance()
+{
+	if (c_instance == 0)
+		c_instance = new AnimatedSectionBatch;
+
+	return c_instance;
+}
+
+void AnimatedSectionBatch::Destroy()
+{
+	if (c_instance)
+	{
+		delete c_instance;
+		c_instance = 0;
+	}
+}
+
+AnimatedSectionBatch::AnimatedSectionBatch()
+{
+	m_interpolationAlpha = 1.0f;
+}
+
+// Sections
+int AnimatedSectionBatch::AddSection(bool playing, bool looping)
+{
+	int sectionId;
+	if (m_vFreeSections.empty() == false)
+	{
+		sectionId = m_vFreeSections.back();
+		m_vFreeSections.pop_back();
+	}
+	else
+	{
+		sectionId = (int)m_vUsed.size();
+
+		m_vUsed.push_back(0);
+		m_vPlaying.push_back(0);
+		m_vLooping.push_back(0);
+		m_vQueued.push_back(0);
+		m_vStopping.push_back(0);
+
+		// Keep the tracks padded so the pass can always work on whole groups of four
+		int numTracks = (((int)m_vUsed.size() * AnimatedSectionTrack_NUM) + 3) & ~3;
+		m_vValue.resize(numTracks, 0.0f);
+		m_vPreviousValue.resize(numTracks, 0.0f);
+		m_vSpeed.resize(numTracks, 0.0f);
+		m_vMaxSpeed.resize(numTracks, 0.0f);
+		m_vTurnSpeed.resize(numTracks, 0.0f);
+		m_vRangeMin.resize(numTracks, 0.0f);
+		m_vRangeMax.resize(numTracks, 0.0f);
+		m_vDirection.resize(numTracks, 1.0f);
+		m_vStep.resize(numTracks, 0.0f);
+		m_vActive.resize(numTracks, 0);
+		m_vTurned.resize(numTracks, 0);
+	}
+
+	m_vUsed[sectionId] = 1;
+	m_vPlaying[sectionId] = playing ? 1 : 0;
+	m_vLooping[sectionId] = looping ? 1 : 0;
+	m_vQueued[sectionId] = 0;
+	m_vStopping[sectionId] = 0;
+
+	for (int i = 0; i < AnimatedSectionTrack_NUM; i++)
+	{
+		SetTrack(sectionId, (AnimatedSectionTrack)i, 0.0f, 0.0f, 0.0f, 0.0f);
+	}
+
+	return sectionId;
+}
+
+void AnimatedSectionBatch::RemoveSection(int sectionId)
+{
+	if (m_vQueued[sectionId])
+	{
+		// Let the queued step happen so the other sections in the pass are not held up
+		Update();
+	}
+
+	m_vUsed[sectionId] = 0;
+	m_vPlaying[sectionId] = 0;
+	m_vFreeSections.push_back(sectionId);
+}
+
+int AnimatedSectionBatch::GetNumSections()
+{
+	return (int)(m_vUsed.size() - m_vFreeSections.size());
+}
+
+// Tracks
+void AnimatedSectionBatch::SetTrack(int sectionId, AnimatedSectionTrack track, float speed, float rangeMin, float rangeMax, float turnSpeed)
+{
+	int index = sectionId * AnimatedSectionTrack_NUM + track;
+
+	m_vValue[index] = 0.0f;
+	m_vPreviousValue[index] = 0.0f;
+	m_vSpeed[index] = speed;
+	m_vMaxSpeed[index] = speed;
+	m_vTurnSpeed[index] = turnSpeed;
+	m_vRangeMin[index] = rangeMin;
+	m_vRangeMax[index] = rangeMax;
+	m_vDirection[index] = 1.0f;
+}
+
+float AnimatedSectionBatch::GetValue(int sectionId, AnimatedSectionTrack track)
+{
+	return m_vValue[sectionId * AnimatedSectionTrack_NUM + track];
+}
+
+float AnimatedSectionBatch::GetSpeed(int sectionId, AnimatedSectionTrack track)
+{
+	return m_vSpeed[sectionId * AnimatedSectionTrack_NUM + track];
+}
+
+float AnimatedSectionBatch::GetRangeMin(int sectionId, AnimatedSectionTrack track)
+{
+	return m_vRangeMin[sectionId * AnimatedSectionTrack_NUM + track];
+}
+
+float AnimatedSectionBatch::GetRangeMax(int sectionId, AnimatedSectionTrack track)
+{
+	return m_vRangeMax[sectionId * AnimatedSectionTrack_NUM + track];
+}
+
+float AnimatedSectionBatch::GetTurnSpeed(int sectionId, AnimatedSectionTrack track)
+{
+	return m_vTurnSpeed[sectionId * AnimatedSectionTrack_NUM + track];
+}
+
+// Playing
+void AnimatedSectionBatch::SetPlaying(int sectionId, bool playing)
+{
+	m_vPlaying[sectionId] = playing ? 1 : 0;
+}
+
+bool AnimatedSectionBatch::IsPlaying(int sectionId)
+{
+	return m_vPlaying[sectionId] == 1;
+}
+
+// Updating
+void AnimatedSectionBatch::QueueUpdate(int sectionId, float dt)
+{
+	if (m_vQueued[sectionId])
+	{
+		return;
+	}
+
+	m_vQueued[sectionId] = 1;
+	m_vQueuedSections.push_back(sectionId);
+
+	int firstTrack = sectionId * AnimatedSectionTrack_NUM;
+	for (int i = 0; i < AnimatedSectionTrack_NUM; i++)
+	{
+		m_vStep[firstTrack + i] = dt;
+	}
+}
+
+bool AnimatedSectionBatch::IsQueued(int sectionId)
+{
+	return m_vQueued[sectionId] == 1;
+}
+
+void AnimatedSectionBatch::Update()
+{
+	if (m_vQueuedSections.empty())
+	{
+		return;
+	}
+
+	// Mark the tracks of the queued sections that are playing, everything else in the pass is left alone
+	int lowestSection = (int)m_vUsed.size();
+	int highestSection = -1;
+	for (unsigned int i = 0; i < m_vQueuedSections.size(); i++)
+	{
+		int sectionId = m_vQueuedSections[i];
+		m_vQueued[sectionId] = 0;
+
+		if (m_vPlaying[sectionId] == 0)
+		{
+			continue;
+		}
+
+		int firstTrack = sectionId * AnimatedSectionTrack_NUM;
+		bool stopping = true;
+		for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+		{
+			m_vActive[firstTrack + track] = 0xFFFFFFFF;
+			stopping = stopping && (m_vSpeed[firstTrack + track] == 0.0f);
+		}
+		m_vStopping[sectionId] = stopping ? 1 : 0;
+
+		lowestSection = sectionId < lowestSection ? sectionId : lowestSection;
+		highestSection = sectionId > highestSection ? sectionId : highestSection;
+	}
+
+	if (highestSection != -1)
+	{
+		int firstTrack = (lowestSection * AnimatedSectionTrack_NUM) & ~3;
+		int endTrack = (((highestSection + 1) * AnimatedSectionTrack_NUM) + 3) & ~3;
+		UpdateTracks(firstTrack, endTrack - firstTrack);
+
+		// A track leaving its range ends a one shot animation, as does having nothing to animate
+		for (unsigned int i = 0; i < m_vQueuedSections.size(); i++)
+		{
+			int sectionId = m_vQueuedSections[i];
+			int sectionTrack = sectionId * AnimatedSectionTrack_NUM;
+			if (m_vActive[sectionTrack] == 0)
+			{
+				continue;
+			}
+
+			unsigned int turned = 0;
+			for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+			{
+				turned |= m_vTurned[sectionTrack + track];
+				m_vActive[sectionTrack + track] = 0;
+			}
+
+			if ((turned != 0 && m_vLooping[sectionId] == 0) || m_vStopping[sectionId] == 1)
+			{
+				m_vPlaying[sectionId] = 0;
+			}
+		}
+	}
+
+	m_vQueuedSections.clear();
+}
+
+void AnimatedSectionBatch::BeginTick()
+{
+	// Tracks that are not stepped this tick then render exactly where they are
+	m_vPreviousValue = m_vValue;
+}
+
+void AnimatedSectionBatch::SetInterpolationAlpha(float alpha)
+{
+	m_interpolationAlpha = alpha;
+}
+
+float AnimatedSectionBatch::GetInterpolatedValue(int sectionId, AnimatedSectionTrack track)
+{
+	int index = sectionId * AnimatedSectionTrack_NUM + track;
+
+	return m_vPreviousValue[index] + (m_vValue[index] - m_vPreviousValue[index]) * m_interpolationAlpha;
+}
+
+void AnimatedSectionBatch::UpdateTracks(int firstTrack, int numTracks)
+{
+	float* pValue = &m_vValue[firstTrack];
+	float* pPreviousValue = &m_vPreviousValue[firstTrack];
+	float* pSpeed = &m_vSpeed[firstTrack];
+	float* pDirection = &m_vDirection[firstTrack];
+	const float* pMaxSpeed = &m_vMaxSpeed[firstTrack];
+	const float* pTurnSpeed = &m_vTurnSpeed[firstTrack];
+	const float* pRangeMin = &m_vRangeMin[firstTrack];
+	const float* pRangeMax = &m_vRangeMax[firstTrack];
+	const float* pStep = &m_vStep[firstTrack];
+	const unsigned int* pActive = &m_vActive[firstTrack];
+	unsigned int* pTurned = &m_vTurned[firstTrack];
+
+#ifdef ANIMATED_SECTION_BATCH_SSE2
+	const __m128 zero = _mm_setzero_ps();
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 minusOne = _mm_set1_ps(-1.0f);
+	const __m128 signBit = _mm_set1_ps(-0.0f);
+
+	for (int i = 0; i < numTracks; i += 4)
+	{
+		__m128 value = _mm_loadu_ps(pValue + i);
+		__m128 speed = _mm_loadu_ps(pSpeed + i);
+		__m128 direction = _mm_loadu_ps(pDirection + i);
+		__m128 maxSpeed = _mm_loadu_ps(pMaxSpeed + i);
+		__m128 turnSpeed = _mm_loadu_ps(pTurnSpeed + i);
+		__m128 rangeMin = _mm_loadu_ps(pRangeMin + i);
+		__m128 rangeMax = _mm_loadu_ps(pRangeMax + i);
+		__m128 dt = _mm_loadu_ps(pStep + i);
+		__m128 active = _mm_castsi128_ps(_mm_loadu_si128((const __m128i*)(pActive + i)));
+
+		// Speed up towards the max speed in the direction of travel, or snap back to the start of the range
+		__m128 accelerating = _mm_cmplt_ps(_mm_mul_ps(direction, speed), maxSpeed);
+		__m128 turning = _mm_cmpneq_ps(turnSpeed, minusOne);
+		__m128 ramp = _mm_and_ps(accelerating, turning);
+		__m128 snap = _mm_andnot_ps(turning, accelerating);
+
+		__m128 rampSpeed = _mm_add_ps(speed, _mm_mul_ps(direction, _mm_mul_ps(turnSpeed, dt)));
+		__m128 snapSpeed = _mm_xor_ps(speed, signBit);
+		__m128 heldSpeed = _mm_or_ps(_mm_and_ps(snap, snapSpeed), _mm_andnot_ps(snap, speed));
+		__m128 newSpeed = _mm_or_ps(_mm_and_ps(ramp, rampSpeed), _mm_andnot_ps(ramp, heldSpeed));
+
+		__m128 headingUp = _mm_cmpgt_ps(direction, zero);
+		__m128 snapValue = _mm_or_ps(_mm_and_ps(headingUp, rangeMin), _mm_andnot_ps(headingUp, rangeMax));
+		__m128 newValue = _mm_or_ps(_mm_and_ps(snap, snapValue), _mm_andnot_ps(snap, value));
+
+		// Turn around once outside the range
+		__m128 above = _mm_cmpgt_ps(newValue, rangeMax);
+		__m128 below = _mm_andnot_ps(above, _mm_cmplt_ps(newValue, rangeMin));
+		__m128 newDirection = _mm_or_ps(_mm_and_ps(above, minusOne), _mm_andnot_ps(above, direction));
+		newDirection = _mm_or_ps(_mm_and_ps(below, one), _mm_andnot_ps(below, newDirection));
+
+		// A snapped track blends from the start of its range, not back across it
+		__m128 snapped = _mm_and_ps(active, snap);
+		__m128 previousValue = _mm_loadu_ps(pPreviousValue + i);
+		_mm_storeu_ps(pPreviousValue + i, _mm_or_ps(_mm_and_ps(snapped, newValue), _mm_andnot_ps(snapped, previousValue)));
+
+		newValue = _mm_add_ps(newValue, _mm_mul_ps(newSpeed, dt));
+
+		_mm_storeu_ps(pValue + i, _mm_or_ps(_mm_and_ps(active, newValue), _mm_andnot_ps(active, value)));
+		_mm_storeu_ps(pSpeed + i, _mm_or_ps(_mm_and_ps(active, newSpeed), _mm_andnot_ps(active, speed)));
+		_mm_storeu_ps(pDirection + i, _mm_or_ps(_mm_and_ps(active, newDirection), _mm_andnot_ps(active, direction)));
+		_mm_storeu_si128((__m128i*)(pTurned + i), _mm_castps_si128(_mm_and_ps(active, _mm_or_ps(above, below))));
+	}
+#else
+	for (int i = 0; i < numTracks; i++)
+	{
+		bool active = pActive[i] != 0;
+		float value = pValue[i];
+		float speed = pSpeed[i];
+		float direction = pDirection[i];
+
+		bool accelerating = direction * speed < pMaxSpeed[i];
+		bool turning = pTurnSpeed[i] != -1.0f;
+		bool ramp = accelerating && turning;
+		bool snap = accelerating && !turning;
+
+		float newSpeed = ramp ? speed + direction * (pTurnSpeed[i] * pStep[i]) : (snap ? -speed : speed);
+		float newValue = snap ? (direction > 0.0f ? pRangeMin[i] : pRangeMax[i]) : value;
+
+		bool above = newValue > pRangeMax[i];
+		bool below = !above && newValue < pRangeMin[i];
+		float newDirection = above ? -1.0f : (below ? 1.0f : direction);
+
+		// A snapped track blends from the start of its range, not back across it
+		if (active && snap)
+		{
+			pPreviousValue[i] = newValue;
+		}
+
+		newValue += newSpeed * pStep[i];
+
+		pValue[i] = active ? newValue : value;
+		pSpeed[i] = active ? newSpeed : speed;
+		pDirection[i] = active ? newDirection : direction;
+		pTurned[i] = (active && (above || below)) ? 0xFFFFFFFF : 0;
+	}
+#endif
+}
@@ -0,0 +1,118 @@
+// ******************************************************************************
+// Filename:    AnimatedSectionBatch.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   The translate and rotate oscillators for the animated sections of every
+//   loaded weapon, stored as a structure of arrays with one track per
+//   section and axis. Weapons queue their sections when they update and
+//   the queued tracks are then accelerated, turned around at the ends of
+//   their range and integrated together in a single pass, four tracks at a
+//   time with SSE2 where it is available. Each track steps exactly the way
+//   the old per section update did. The values from the previous simulation
+//   tick are kept so rendering can blend between the last two ticks.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+using namespace std;
+
+enum AnimatedSectionTrack
+{
+	AnimatedSectionTrack_TranslateX = 0,
+	AnimatedSectionTrack_TranslateY,
+	AnimatedSectionTrack_TranslateZ,
+	AnimatedSectionTrack_RotationX,
+	AnimatedSectionTrack_RotationY,
+	AnimatedSectionTrack_RotationZ,
+
+	AnimatedSectionTrack_NUM,
+};
+
+class AnimatedSectionBatch
+{
+public:
+	/* Public methods */
+	static AnimatedSectionBatch* GetInstance();
+	void Destroy();
+
+	// Sections
+	int AddSection(bool playing, bool looping);
+	void RemoveSection(int sectionId);
+	int GetNumSections();
+
+	// Tracks, a turn speed of -1 snaps back to the start of the range instead of turning around
+	void SetTrack(int sectionId, AnimatedSectionTrack track, float speed, float rangeMin, float rangeMax, float turnSpeed);
+	float GetValue(int sectionId, AnimatedSectionTrack track);
+	float GetSpeed(int sectionId, AnimatedSectionTrack track);
+	float GetRangeMin(int sectionId, AnimatedSectionTrack track);
+	float GetRangeMax(int sectionId, AnimatedSectionTrack track);
+	float GetTurnSpeed(int sectionId, AnimatedSectionTrack track);
+
+	// Playing
+	void SetPlaying(int sectionId, bool playing);
+	bool IsPlaying(int sectionId);
+
+	// Updating, queued sections are stepped together the next time Update() is called
+	void QueueUpdate(int sectionId, float dt);
+	bool IsQueued(int sectionId);
+	void Update();
+
+	// Fixed timestep interpolation, BeginTick() keeps the values the last tick ended on and rendering blends from them by the alpha
+	void BeginTick();
+	void SetInterpolationAlpha(float alpha);
+	float GetInterpolatedValue(int sectionId, AnimatedSectionTrack track);
+
+protected:
+	/* Protected methods */
+	AnimatedSectionBatch();
+	AnimatedSectionBatch(const AnimatedSectionBatch&);
+	AnimatedSectionBatch &operator=(const AnimatedSectionBatch&);
+
+private:
+	/* Private methods */
+	void UpdateTracks(int firstTrack, int numTracks);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+
+	// Per track, AnimatedSectionTrack_NUM tracks for each section, padded to a multiple of 4
+	vector<float> m_vValue;
+	vector<float> m_vPreviousValue;		// Value at the end of the previous tick, or where a snapped track restarted from
+	vector<float> m_vSpeed;
+	vector<float> m_vMaxSpeed;
+	vector<float> m_vTurnSpeed;
+	vector<float> m_vRangeMin;
+	vector<float> m_vRangeMax;
+	vector<float> m_vDirection;			// 1 while heading up the range, -1 while heading down
+	vector<float> m_vStep;				// Delta time of the queued update
+	vector<unsigned int> m_vActive;		// All bits set for the tracks stepped in this pass
+	vector<unsigned int> m_vTurned;		// All bits set for the tracks that left their range in this pass
+
+	// Per section
+	vector<unsigned char> m_vUsed;
+	vector<unsigned char> m_vPlaying;
+	vector<unsigned char> m_vLooping;
+	vector<unsigned char> m_vQueued;
+	vector<unsigned char> m_vStopping;	// Had no speed on any track when it was queued
+	vector<int> m_vFreeSections;
+	vector<int> m_vQueuedSections;
+
+	float m_interpolationAlpha;
+
+	// Singleton instance
+	static AnimatedSectionBatch *c_instance;
+};
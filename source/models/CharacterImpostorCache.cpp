@@ -0,0 +1,347 @@
+// ******************************************************************************
+// Filename:    CharacterImpostorCache.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "CharacterImpostorCache.h"
+
+// Paperdoll animations don't need to be smooth in a small GUI window, step them at this rate
+const float IMPOSTOR_DEFAULT_ANIMATION_RATE = 10.0f;
+
+
+CharacterImpostorCache::CharacterImpostorCache(Renderer* pRenderer, int firstPass, int lastPass)
+{
+	m_pRenderer = pRenderer;
+
+	m_firstPass = firstPass;
+	m_lastPass = lastPass;
+
+	m_numFrameBuffersCreated = 0;
+
+	m_numRendered = 0;
+	m_numCached = 0;
+}
+
+CharacterImpostorCache::~CharacterImpostorCache()
+{
+	ClearImpostors();
+}
+
+void CharacterImpostorCache::ClearImpostors()
+{
+	for (unsigned int i = 0; i < m_vImpostors.size(); i++)
+	{
+		if (m_vImpostors[i].m_used)
+		{
+			DestroyImpostor(i);
+		}
+	}
+}
+
+// Impostors
+unsigned int CharacterImpostorCache::CreateImpostor(VoxelCharacter* pVoxelCharacter, ImpostorType type, int width, int height)
+{
+	unsigned int impostorId;
+	if (m_vFreeImpostors.size() > 0)
+	{
+		impostorId = m_vFreeImpostors.back();
+		m_vFreeImpostors.pop_back();
+	}
+	else
+	{
+		impostorId = (unsigned int)m_vImpostors.size();
+		m_vImpostors.push_back(CharacterImpostor());
+	}
+
+	CharacterImpostor* pImpostor = &m_vImpostors[impostorId];
+	pImpostor->m_used = true;
+	pImpostor->m_enabled = true;
+	pImpostor->m_pVoxelCharacter = pVoxelCharacter;
+	pImpostor->m_type = type;
+	pImpostor->m_width = width;
+	pImpostor->m_height = height;
+	pImpostor->m_frameBufferId = GetFrameBuffer(width, height);
+	pImpostor->m_animationRate = IMPOSTOR_DEFAULT_ANIMATION_RATE;
+	pImpostor->m_animationTimer = 0.0f;
+	pImpostor->m_renderedVersion = 0;
+	pImpostor->m_dirty = true;
+
+	// Head and shoulders for portraits, the whole body for paperdolls
+	if (type == ImpostorType_Portrait)
+	{
+		pImpostor->m_framingCentre = vec3(0.0f, 1.5f, 0.0f);
+		pImpostor->m_framingHalfHeight = 0.5f;
+	}
+	else
+	{
+		pImpostor->m_framingCentre = vec3(0.0f, 0.9f, 0.0f);
+		pImpostor->m_framingHalfHeight = 1.2f;
+	}
+
+	// Showing a paperdoll is what keeps its animators running, but only at the impostor's rate
+	pVoxelCharacter->SetPaperdollAnimationEnabled(false);
+
+	return impostorId;
+}
+
+void CharacterImpostorCache::DestroyImpostor(unsigned int impostorId)
+{
+	if (impostorId >= m_vImpostors.size() || m_vImpostors[impostorId].m_used == false)
+	{
+		return;
+	}
+
+	CharacterImpostor* pImpostor = &m_vImpostors[impostorId];
+
+	ImpostorFrameBuffer frameBuffer;
+	frameBuffer.m_width = pImpostor->m_width;
+	frameBuffer.m_height = pImpostor->m_height;
+	frameBuffer.m_frameBufferId = pImpostor->m_frameBufferId;
+	m_vFreeFrameBuffers.push_back(frameBuffer);
+
+	pImpostor->m_used = false;
+	pImpostor->m_pVoxelCharacter = NULL;
+	m_vFreeImpostors.push_back(impostorId);
+}
+
+void CharacterImpostorCache::DestroyImpostors(VoxelCharacter* pVoxelCharacter)
+{
+	for (unsigned int i = 0; i < m_vImpostors.size(); i++)
+	{
+		if (m_vImpostors[i].m_used && m_vImpostors[i].m_pVoxelCharacter == pVoxelCharacter)
+		{
+			DestroyImpostor(i);
+		}
+	}
+}
+
+void CharacterImpostorCache::SetImpostorFraming(unsigned int impostorId, vec3 centre, float halfHeight)
+{
+	if (impostorId >= m_vImpostors.size())
+	{
+		return;
+	}
+
+	m_vImpostors[impostorId].m_framingCentre = centre;
+	m_vImpostors[impostorId].m_framingHalfHeight = halfHeight;
+	m_vImpostors[impostorId].m_dirty = true;
+}
+
+void CharacterImpostorCache::SetImpostorAnimationRate(unsigned int impostorId, float rate)
+{
+	if (impostorId >= m_vImpostors.size())
+	{
+		return;
+	}
+
+	m_vImpostors[impostorId].m_animationRate = rate;
+}
+
+void CharacterImpostorCache::SetImpostorEnabled(unsigned int impostorId, bool enabled)
+{
+	if (impostorId >= m_vImpostors.size())
+	{
+		return;
+	}
+
+	m_vImpostors[impostorId].m_enabled = enabled;
+}
+
+void CharacterImpostorCache::Invalidate(unsigned int impostorId)
+{
+	if (impostorId >= m_vImpostors.size())
+	{
+		return;
+	}
+
+	m_vImpostors[impostorId].m_dirty = true;
+}
+
+void CharacterImpostorCache::InvalidateAll()
+{
+	for (unsigned int i = 0; i < m_vImpostors.size(); i++)
+	{
+		m_vImpostors[i].m_dirty = true;
+	}
+}
+
+int CharacterImpostorCache::GetNumImpostors()
+{
+	return (int)(m_vImpostors.size() - m_vFreeImpostors.size());
+}
+
+// Accessors
+unsigned int CharacterImpostorCache::GetTexture(unsigned int impostorId)
+{
+	return m_pRenderer->GetDiffuseTextureFromFrameBuffer(m_vImpostors[impostorId].m_frameBufferId);
+}
+
+int CharacterImpostorCache::GetNumRendered()
+{
+	return m_numRendered;
+}
+
+int CharacterImpostorCache::GetNumCached()
+{
+	return m_numCached;
+}
+
+// Update
+void CharacterImpostorCache::Update(float dt)
+{
+	for (unsigned int i = 0; i < m_vImpostors.size(); i++)
+	{
+		CharacterImpostor* pImpostor = &m_vImpostors[i];
+		if (pImpostor->m_used == false || pImpostor->m_enabled == false)
+		{
+			continue;
+		}
+
+		VoxelCharacter* pVoxelCharacter = pImpostor->m_pVoxelCharacter;
+		if (pVoxelCharacter->IsPaperdollAnimating() == false)
+		{
+			pImpostor->m_animationTimer = 0.0f;
+			continue;
+		}
+
+		// Step the paperdoll in whole animation frames, which bumps the appearance version and re-renders the impostor
+		pImpostor->m_animationTimer += dt;
+		float animationStep = 1.0f / pImpostor->m_animationRate;
+		if (pImpostor->m_animationTimer >= animationStep)
+		{
+			pVoxelCharacter->UpdatePaperdoll(pImpostor->m_animationTimer);
+			pImpostor->m_animationTimer = 0.0f;
+		}
+	}
+}
+
+// Rendering
+void CharacterImpostorCache::RenderImpostors()
+{
+	m_numRendered = 0;
+	m_numCached = 0;
+
+	for (unsigned int i = 0; i < m_vImpostors.size(); i++)
+	{
+		CharacterImpostor* pImpostor = &m_vImpostors[i];
+		if (pImpostor->m_used == false || pImpostor->m_enabled == false)
+		{
+			continue;
+		}
+
+		unsigned int version = pImpostor->m_pVoxelCharacter->GetAppearanceVersion();
+		if (pImpostor->m_dirty == false && pImpostor->m_renderedVersion == version)
+		{
+			m_numCached++;
+			continue;
+		}
+
+		RenderCharacter(pImpostor);
+
+		pImpostor->m_renderedVersion = version;
+		pImpostor->m_dirty = false;
+		m_numRendered++;
+	}
+}
+
+void CharacterImpostorCache::RenderImpostor(unsigned int impostorId, float x, float y, float width, float height)
+{
+	if (impostorId >= m_vImpostors.size() || m_vImpostors[impostorId].m_used == false)
+	{
+		return;
+	}
+
+	m_pRenderer->PushMatrix();
+		m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+		m_pRenderer->SetRenderMode(RM_TEXTURED);
+		m_pRenderer->BindRawTextureId(GetTexture(impostorId));
+
+		m_pRenderer->EnableImmediateMode(IM_QUADS);
+			m_pRenderer->ImmediateColourAlpha(1.0f, 1.0f, 1.0f, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
+			m_pRenderer->ImmediateVertex(x, y, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(1.0f, 0.0f);
+			m_pRenderer->ImmediateVertex(x + width, y, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(1.0f, 1.0f);
+			m_pRenderer->ImmediateVertex(x + width, y + height, 1.0f);
+			m_pRenderer->ImmediateTextureCoordinate(0.0f, 1.0f);
+			m_pRenderer->ImmediateVertex(x, y + height, 1.0f);
+		m_pRenderer->DisableImmediateMode();
+
+		m_pRenderer->DisableTexture();
+		m_pRenderer->DisableTransparency();
+	m_pRenderer->PopMatrix();
+}
+
+// Private methods
+unsigned int CharacterImpostorCache::GetFrameBuffer(int width, int height)
+{
+	for (unsigned int i = 0; i < m_vFreeFrameBuffers.size(); i++)
+	{
+		if (m_vFreeFrameBuffers[i].m_width == width && m_vFreeFrameBuffers[i].m_height == height)
+		{
+			unsigned int frameBufferId = m_vFreeFrameBuffers[i].m_frameBufferId;
+			m_vFreeFrameBuffers.erase(m_vFreeFrameBuffers.begin() + i);
+
+			return frameBufferId;
+		}
+	}
+
+	// Impostors are live for the whole frame, so the pool gives every one its own frame buffer
+	RenderTargetDesc impostorDesc;
+	impostorDesc.m_depth = true;
+	impostorDesc.m_sizeClass = RenderTargetSizeClass_Fixed;
+	impostorDesc.m_width = width;
+	impostorDesc.m_height = height;
+
+	char name[64];
+	sprintf(name, "Impostor %i", m_numFrameBuffersCreated);
+	m_numFrameBuffersCreated++;
+
+	unsigned int frameBufferId;
+	m_pRenderer->CreateRenderTarget(impostorDesc, m_firstPass, m_lastPass, name, &frameBufferId);
+
+	return frameBufferId;
+}
+
+void CharacterImpostorCache::RenderCharacter(CharacterImpostor* pImpostor)
+{
+	VoxelCharacter* pVoxelCharacter = pImpostor->m_pVoxelCharacter;
+	float halfHeight = pImpostor->m_framingHalfHeight;
+	float halfWidth = halfHeight * ((float)pImpostor->m_width / (float)pImpostor->m_height);
+	vec3 centre = pImpostor->m_framingCentre;
+
+	m_pRenderer->PushMatrix();
+		m_pRenderer->StartRenderingToFrameBuffer(pImpostor->m_frameBufferId);
+
+		m_pRenderer->SetupOrthographicProjection(-halfWidth, halfWidth, -halfHeight, halfHeight, 0.01f, 100.0f);
+		m_pRenderer->SetLookAtCamera(centre + vec3(0.0f, 0.0f, 10.0f), centre, vec3(0.0f, 1.0f, 0.0f));
+
+		m_pRenderer->PushMatrix();
+			m_pRenderer->EnableDepthTest(DT_LESS);
+			m_pRenderer->SetCullMode(CM_BACK);
+
+			if (pImpostor->m_type == ImpostorType_Portrait)
+			{
+				pVoxelCharacter->RenderPortrait();
+				pVoxelCharacter->RenderFacePortrait();
+			}
+			else
+			{
+				pVoxelCharacter->RenderPaperdoll();
+				pVoxelCharacter->RenderFacePaperdoll();
+				pVoxelCharacter->RenderWeaponsPaperdoll();
+			}
+
+			m_pRenderer->DisableDepthTest();
+		m_pRenderer->PopMatrix();
+
+		m_pRenderer->StopRenderingToFrameBuffer(pImpostor->m_frameBufferId);
+	m_pRenderer->PopMatrix();
+}
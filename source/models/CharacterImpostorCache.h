@@ -0,0 +1,134 @@
+// ******************************************************************************
+// Filename:    CharacterImpostorCache.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Cached portraits and paperdolls for the GUI. Each impostor renders its
+//   character into a pooled frame buffer, and only renders it again when the
+//   character's appearance version has moved on, from an equipment swap, a
+//   colour change, a new expression, or when its paperdoll animation is
+//   stepped at the impostor's reduced rate. Character sheets and inventory
+//   screens then draw a single textured quad for each one.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "VoxelCharacter.h"
+
+#include <vector>
+using namespace std;
+
+enum ImpostorType
+{
+	ImpostorType_Portrait = 0,
+	ImpostorType_Paperdoll,
+};
+
+class ImpostorFrameBuffer
+{
+public:
+	int m_width;
+	int m_height;
+	unsigned int m_frameBufferId;
+};
+
+class CharacterImpostor
+{
+public:
+	bool m_used;
+	bool m_enabled;
+	VoxelCharacter* m_pVoxelCharacter;
+	ImpostorType m_type;
+
+	// Pooled frame buffer the character is rendered into
+	int m_width;
+	int m_height;
+	unsigned int m_frameBufferId;
+
+	// What the orthographic camera looks at, in the character's paperdoll space
+	vec3 m_framingCentre;
+	float m_framingHalfHeight;
+
+	// The paperdoll animation is stepped at this rate while it is playing, rather than every frame
+	float m_animationRate;
+	float m_animationTimer;
+
+	// The appearance version the frame buffer was last rendered with
+	unsigned int m_renderedVersion;
+	bool m_dirty;
+};
+
+class CharacterImpostorCache
+{
+public:
+	/* Public methods */
+	CharacterImpostorCache(Renderer* pRenderer, int firstPass, int lastPass);
+	~CharacterImpostorCache();
+
+	void ClearImpostors();
+
+	// Impostors
+	unsigned int CreateImpostor(VoxelCharacter* pVoxelCharacter, ImpostorType type, int width, int height);
+	void DestroyImpostor(unsigned int impostorId);
+	void DestroyImpostors(VoxelCharacter* pVoxelCharacter);
+	void SetImpostorFraming(unsigned int impostorId, vec3 centre, float halfHeight);
+	void SetImpostorAnimationRate(unsigned int impostorId, float rate);
+	void SetImpostorEnabled(unsigned int impostorId, bool enabled);
+	void Invalidate(unsigned int impostorId);
+	void InvalidateAll();
+	int GetNumImpostors();
+
+	// Accessors
+	unsigned int GetTexture(unsigned int impostorId);
+	int GetNumRendered();
+	int GetNumCached();
+
+	// Update
+	void Update(float dt);
+
+	// Rendering
+	void RenderImpostors();
+	void RenderImpostor(unsigned int impostorId, float x, float y, float width, float height);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	CharacterImpostorCache(const CharacterImpostorCache&);
+	CharacterImpostorCache &operator=(const CharacterImpostorCache&);
+
+	unsigned int GetFrameBuffer(int width, int height);
+	void RenderCharacter(CharacterImpostor* pImpostor);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	Renderer* m_pRenderer;
+
+	// The render passes the frame buffers are live for
+	int m_firstPass;
+	int m_lastPass;
+
+	vector<CharacterImpostor> m_vImpostors;
+	vector<unsigned int> m_vFreeImpostors;
+
+	// Frame buffers handed back by destroyed impostors, reused by the next impostor of the same size
+	vector<ImpostorFrameBuffer> m_vFreeFrameBuffers;
+	int m_numFrameBuffersCreated;
+
+	// Counts from the last RenderImpostors()
+	int m_numRendered;
+	int m_numCached;
+};
@@ -0,0 +1,147 @@
+// ******************************************************************************
+// Filename:    FaceQuadBatch.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "FaceQuadBatch.h"
+
+#include "../Renderer/Renderer.h"
+#include "../utils/Profiler.h"
+
+
+FaceQuadBatch::FaceQuadBatch(Renderer* pRenderer)
+{
+	m_pRenderer = pRenderer;
+
+	m_numQuads = 0;
+	m_numDrawCalls = 0;
+}
+
+FaceQuadBatch::~FaceQuadBatch()
+{
+	for (unsigned int i = 0; i < m_vpBatches.size(); i++)
+	{
+		delete m_vpBatches[i];
+		m_vpBatches[i] = 0;
+	}
+	m_vpBatches.clear();
+}
+
+void FaceQuadBatch::ClearQuads()
+{
+	for (unsigned int i = 0; i < m_vpBatches.size(); i++)
+	{
+		m_vpBatches[i]->m_numVertices = 0;
+	}
+}
+
+// Quads
+void FaceQuadBatch::AddQuad(unsigned int textureId, Matrix4x4 worldMatrix, float width, float height, const TextureAtlasRect& rect, float alpha)
+{
+	FaceQuadAtlasBatch* pBatch = m_vpBatches[GetBatch(textureId)];
+
+	// Same corners and winding as the immediate mode face quad, with the atlas flipped vertically
+	AddVertex(pBatch, worldMatrix * vec3(0.0f, 0.0f, 0.0f), alpha, rect.m_u0, rect.m_v1);
+	AddVertex(pBatch, worldMatrix * vec3(width, 0.0f, 0.0f), alpha, rect.m_u1, rect.m_v1);
+	AddVertex(pBatch, worldMatrix * vec3(width, height, 0.0f), alpha, rect.m_u1, rect.m_v0);
+	AddVertex(pBatch, worldMatrix * vec3(0.0f, height, 0.0f), alpha, rect.m_u0, rect.m_v0);
+}
+
+// Accessors
+int FaceQuadBatch::GetNumQuads()
+{
+	return m_numQuads;
+}
+
+int FaceQuadBatch::GetNumBatches()
+{
+	return (int)m_vpBatches.size();
+}
+
+int FaceQuadBatch::GetNumDrawCalls()
+{
+	return m_numDrawCalls;
+}
+
+// Rendering
+void FaceQuadBatch::Render()
+{
+	PROFILE_ZONE("FaceQuadBatch::Render");
+
+	m_numQuads = 0;
+	m_numDrawCalls = 0;
+
+	// The quads are already in world space, and the faces were only ever lit by their vertex colour
+	m_pRenderer->SetActiveTextureUnit(0);
+	m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+	m_pRenderer->SetRenderMode(RM_TEXTURED);
+
+	for (unsigned int i = 0; i < m_vpBatches.size(); i++)
+	{
+		FaceQuadAtlasBatch* pBatch = m_vpBatches[i];
+		if (pBatch->m_numVertices == 0)
+		{
+			continue;
+		}
+
+		m_pRenderer->RenderStreamBuffer(pBatch->m_streamBufferId, pBatch->m_textureId, pBatch->m_numVertices, &pBatch->m_vVertices[0]);
+
+		m_numQuads += pBatch->m_numVertices / 4;
+		m_numDrawCalls++;
+	}
+
+	m_pRenderer->DisableTexture();
+	m_pRenderer->DisableTransparency();
+
+	ClearQuads();
+}
+
+// Private methods
+int FaceQuadBatch::GetBatch(unsigned int textureId)
+{
+	for (unsigned int i = 0; i < m_vpBatches.size(); i++)
+	{
+		if (m_vpBatches[i]->m_textureId == textureId)
+		{
+			return i;
+		}
+	}
+
+	FaceQuadAtlasBatch* pBatch = new FaceQuadAtlasBatch();
+	pBatch->m_textureId = textureId;
+	pBatch->m_numVertices = 0;
+	m_pRenderer->CreateStreamBuffer(&pBatch->m_streamBufferId);
+
+	m_vpBatches.push_back(pBatch);
+
+	return (int)m_vpBatches.size() - 1;
+}
+
+void FaceQuadBatch::AddVertex(FaceQuadAtlasBatch* pBatch, vec3 position, float alpha, float u, float v)
+{
+	// The vertex storage only ever grows, so a steady number of faces stops allocating after the first frame
+	int offset = pBatch->m_numVertices * FACE_QUAD_VERTEX_FLOATS;
+	if ((int)pBatch->m_vVertices.size() < offset + FACE_QUAD_VERTEX_FLOATS)
+	{
+		pBatch->m_vVertices.resize(offset + FACE_QUAD_VERTEX_FLOATS);
+	}
+
+	float* pVertex = &pBatch->m_vVertices[offset];
+	pVertex[0] = position.x;
+	pVertex[1] = position.y;
+	pVertex[2] = position.z;
+	pVertex[3] = 1.0f;
+	pVertex[4] = 1.0f;
+	pVertex[5] = 1.0f;
+	pVertex[6] = alpha;
+	pVertex[7] = u;
+	pVertex[8] = v;
+
+	pBatch->m_numVertices++;
+}
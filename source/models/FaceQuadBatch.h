@@ -0,0 +1,89 @@
+// ******************************************************************************
+// Filename:    FaceQuadBatch.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Collects the eyes and mouth quads of every character rendering its face
+//   this pass. Each quad is transformed into world space on the CPU from
+//   its head bone, and the quads are written into one streamed vertex
+//   buffer per face atlas, so all the faces of a character type are drawn
+//   with a single call instead of two immediate mode quads per character.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Maths/3dmaths.h"
+#include "../Renderer/textureatlas.h"
+
+#include <vector>
+using namespace std;
+
+class Renderer;
+
+// Position, colour and texture coordinate for each corner of a face quad
+const int FACE_QUAD_VERTEX_FLOATS = 9;
+
+// All the face quads sharing an atlas
+class FaceQuadAtlasBatch
+{
+public:
+	unsigned int m_textureId;
+	unsigned int m_streamBufferId;
+
+	vector<float> m_vVertices;
+	int m_numVertices;
+};
+
+class FaceQuadBatch
+{
+public:
+	/* Public methods */
+	FaceQuadBatch(Renderer* pRenderer);
+	~FaceQuadBatch();
+
+	void ClearQuads();
+
+	// Quads, the world matrix places the bottom left corner and the quad extends along its x and y axes
+	void AddQuad(unsigned int textureId, Matrix4x4 worldMatrix, float width, float height, const TextureAtlasRect& rect, float alpha);
+
+	// Accessors
+	int GetNumQuads();
+	int GetNumBatches();
+	int GetNumDrawCalls();
+
+	// Rendering, draws everything added since the last render and then empties the batch
+	void Render();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	FaceQuadBatch(const FaceQuadBatch&);
+	FaceQuadBatch &operator=(const FaceQuadBatch&);
+
+	int GetBatch(unsigned int textureId);
+	void AddVertex(FaceQuadAtlasBatch* pBatch, vec3 position, float alpha, float u, float v);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	Renderer* m_pRenderer;
+
+	vector<FaceQuadAtlasBatch*> m_vpBatches;
+
+	// Counts from the last render
+	int m_numQuads;
+	int m_numDrawCalls;
+};
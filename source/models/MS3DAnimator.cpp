@@ -1,6 +1,8 @@
 #include "MS3DAnimator.h"
+#include "../utils/Profiler.h"
 
 #include <assert.h>
+#include <math.h>
 
 #include <glm/glm.hpp>
 #include <glm/gtc/quaternion.hpp>
@@ -27,6 +29,7 @@ MS3DAnimator::MS3DAnimator(Renderer *lpRenderer, MS3DModel* pModel)
 
 	// Calculate the initial bounding box
 	CalculateBoundingBox();
+	m_boundingBoxDirty = false;
 
 	mCurrentAnimationIndex = 0;
 	mCurrentAnimationStartTime = 0.0;
@@ -83,6 +86,10 @@ void MS3DAnimator::CreateJointAnimations()
 		pJointAnimations[i].currentRotationKeyframe = 0;
 
 		pJointAnimations[i].final = mpModel->pJoints[i].absolute;
+		pJointAnimations[i].interpolateFrom = pJointAnimations[i].final;
+		pJointAnimations[i].interpolateTo = pJointAnimations[i].final;
+		pJointAnimations[i].interpolateFromRot = quat_cast(make_mat4(pJointAnimations[i].final.m));
+		pJointAnimations[i].interpolateToRot = pJointAnimations[i].interpolateFromRot;
 	}
 }
 
@@ -218,6 +225,12 @@ void MS3DAnimator::CalculateBoundingBox()
 
 BoundingBox* MS3DAnimator::GetBoundingBox()
 {
+	if(m_boundingBoxDirty)
+	{
+		CalculateBoundingBox();
+		m_boundingBoxDirty = false;
+	}
+
 	return &m_BoundingBox;
 }
 
@@ -625,6 +638,8 @@ Matrix4x4 MS3DAnimator::GetBoneMatrix(int index)
 // Update
 void MS3DAnimator::Update(float dt)
 {
+	PROFILE_ZONE("MS3DAnimator::Update");
+
 	if(m_bBlending)
 	{
 		UpdateBlending(dt);
@@ -640,8 +655,15 @@ void MS3DAnimator::Update(float dt)
 	{
 		if ( mblooping )
 		{
+			// Carry the time past the end into the next loop, so updates of any length stay on the same phase
+			double overshoot = m_timer - mCurrentAnimationEndTime;
+			double loopLength = mCurrentAnimationEndTime - mCurrentAnimationStartTime;
+			if ( loopLength > 0.0 && overshoot >= loopLength )
+			{
+				overshoot = fmod( overshoot, loopLength );
+			}
 			Restart();
-			m_timer = mCurrentAnimationStartTime;
+			m_timer = mCurrentAnimationStartTime + overshoot;
 
 			m_bLooped = true;
 		}
@@ -786,8 +808,9 @@ void MS3DAnimator::Update(float dt)
 		pJointAnimation->currentBlendRot[2] = rotVec[2];
 	}
 
-	// Also re-calculate the bounding box, since vertices *might* now have new positions, given that we have updated all the bones!
-	CalculateBoundingBox();
+	// The bounding box needs re-calculating, since vertices *might* now have new positions, given that we have updated all the bones!
+	// Left until it is asked for, walking every vertex each update is most of the cost for a crowd of characters.
+	m_boundingBoxDirty = true;
 }
 
 void MS3DAnimator::UpdateBlending(float dt)
@@ -856,6 +879,72 @@ void MS3DAnimator::UpdateBlending(float dt)
 	}
 }
 
+void MS3DAnimator::UpdateInterpolated(float dt)
+{
+	for (int i = 0; i < numJointAnimations; i++)
+	{
+		pJointAnimations[i].interpolateFrom = pJointAnimations[i].final;
+	}
+
+	Update(dt);
+
+	for (int i = 0; i < numJointAnimations; i++)
+	{
+		pJointAnimations[i].interpolateTo = pJointAnimations[i].final;
+		pJointAnimations[i].final = pJointAnimations[i].interpolateFrom;
+
+		// Rigid bones, so the rotation is the upper 3x3 of the matrix
+		pJointAnimations[i].interpolateFromRot = quat_cast(make_mat4(pJointAnimations[i].interpolateFrom.m));
+		pJointAnimations[i].interpolateToRot = quat_cast(make_mat4(pJointAnimations[i].interpolateTo.m));
+	}
+}
+
+void MS3DAnimator::UpdateTick(float dt)
+{
+	for (int i = 0; i < numJointAnimations; i++)
+	{
+		pJointAnimations[i].interpolateFrom = pJointAnimations[i].interpolateTo;
+		pJointAnimations[i].interpolateFromRot = pJointAnimations[i].interpolateToRot;
+	}
+
+	Update(dt);
+
+	// The final matrices are left on this tick's pose, until the renderer asks for a blend
+	for (int i = 0; i < numJointAnimations; i++)
+	{
+		pJointAnimations[i].interpolateTo = pJointAnimations[i].final;
+		pJointAnimations[i].interpolateToRot = quat_cast(make_mat4(pJointAnimations[i].final.m));
+	}
+}
+
+void MS3DAnimator::InterpolatePose(float ratio)
+{
+	// Split each bone into its rotation and translation so the blended bone stays rigid, slerp the rotation and lerp the translation
+	for (int i = 0; i < numJointAnimations; i++)
+	{
+		JointAnimation *pJointAnimation = &(pJointAnimations[i]);
+
+		quat q1 = pJointAnimation->interpolateFromRot;
+		quat q2 = pJointAnimation->interpolateToRot;
+		float cosTheta = dot(q1, q2);
+		if (cosTheta < 0.0f)
+		{
+			q2 = -q2;
+			cosTheta = -cosTheta;
+		}
+
+		// The poses are only a few frames apart, so a normalized lerp is as good as a slerp and skips the trig
+		quat q3 = (cosTheta > 0.9995f) ? normalize(q1 * (1.0f - ratio) + q2 * ratio) : slerp(q1, q2, ratio);
+
+		vec3 transVec = mix(pJointAnimation->interpolateFrom.GetTranslationVector(), pJointAnimation->interpolateTo.GetTranslationVector(), ratio);
+
+		mat4 trans = mat4_cast(q3);
+		float *pM = value_ptr(trans);
+		pJointAnimation->final.SetValues(pM);
+		pJointAnimation->final.SetTranslation(transVec);
+	}
+}
+
 // Rendering
 void MS3DAnimator::Render(bool lMesh, bool lNormals, bool lBones, bool lBoundingBox)
 {
@@ -1044,6 +1133,8 @@ void MS3DAnimator::RenderBones()
 
 void MS3DAnimator::RenderBoundingBox()
 {
+	GetBoundingBox();
+
 	mpRenderer->PushMatrix();
 		mpRenderer->ImmediateColourAlpha(1.0f, 1.0f, 0.0f, 1.0f);
 
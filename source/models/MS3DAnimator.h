@@ -3,6 +3,8 @@
 #include "../Renderer/Renderer.h"
 #include "MS3DModel.h"
 
+#include <glm/gtc/quaternion.hpp>
+
 // Joint animation structure
 typedef struct JointAnimation
 {
@@ -18,6 +20,12 @@ typedef struct JointAnimation
 
 	Matrix4x4 final;
 
+	// The last two evaluated poses, when the animator is only updated every few frames
+	Matrix4x4 interpolateFrom;
+	Matrix4x4 interpolateTo;
+	quat interpolateFromRot;
+	quat interpolateToRot;
+
 } JointAnimation;
 
 // Animation structure
@@ -97,6 +105,13 @@ public:
 	void Update(float dt);
 	void UpdateBlending(float dt);
 
+	// Pose interpolation, evaluates a new target pose and then eases the bones from the pose they are showing towards it
+	void UpdateInterpolated(float dt);
+	void InterpolatePose(float ratio);
+
+	// Fixed timestep interpolation, evaluates the pose for this tick and keeps the previous tick's pose to blend from
+	void UpdateTick(float dt);
+
 	// Rendering
 	void Render(bool lMesh, bool lNormals, bool lBones, bool lBoundingBox);
 	void RenderMesh();
@@ -147,4 +162,5 @@ private:
 
 	// Bounding box
 	BoundingBox m_BoundingBox;
+	bool m_boundingBoxDirty;
 };
@@ -13,7 +13,9 @@
 
 #include "QubicleBinary.h"
 #include "VoxelCharacter.h"
+#include "FaceQuadBatch.h"
 #include "../utils/FileUtils.h"
+#include "../utils/Profiler.h"
 
 #include <vector>
 #include <algorithm>
@@ -42,6 +44,8 @@ QubicleBinary::QubicleBinary(Renderer* pRenderer)
 	m_meshSingleColourG = 1.0f;
 	m_meshSingleColourB = 1.0f;
 	m_singleMeshColour = false;
+
+	m_pLODSelection = NULL;
 }
 
 QubicleBinary::~QubicleBinary()
@@ -106,6 +110,8 @@ void QubicleBinary::ClearMatrices()
 		m_pRenderer->ClearMesh(m_vpMatrices[i]->m_pMesh);
 		m_vpMatrices[i]->m_pMesh = NULL;
 
+		ClearLODMeshes(m_vpMatrices[i]);
+
 		delete [] m_vpMatrices[i]->m_pColour;
 
 		delete m_vpMatrices[i];
@@ -215,6 +221,10 @@ bool QubicleBinary::Import(const char* fileName, bool faceMerging)
 
 			pNewMatrix->m_boneIndex = -1;
 			pNewMatrix->m_pMesh = NULL;
+			for(int lod = 0; lod < QUBICLE_NUM_LODS - 1; lod++)
+			{
+				pNewMatrix->m_pLODMeshes[lod] = NULL;
+			}
 
 			pNewMatrix->m_scale = 1.0f;
 			pNewMatrix->m_offsetX = 0.0f;
@@ -438,6 +448,21 @@ void QubicleBinary::GetColour(int matrixIndex, int x, int y, int z, float* r, fl
 	}	
 }
 
+void QubicleBinary::GetColour(QubicleMatrix* pMatrix, int x, int y, int z, float* r, float* g, float* b, float* a)
+{
+	if(m_singleMeshColour)
+	{
+		*r = m_meshSingleColourR;
+		*g = m_meshSingleColourG;
+		*b = m_meshSingleColourB;
+		*a = 1.0f;
+	}
+	else
+	{
+		pMatrix->GetColour(x, y, z, r, g, b, a);
+	}
+}
+
 unsigned int QubicleBinary::GetColourCompact(int matrixIndex, int x, int y, int z)
 {
 	QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
@@ -469,6 +494,14 @@ void QubicleBinary::SetMeshAlpha(float alpha)
 	for(unsigned int i = 0; i < m_vpMatrices.size(); i++)
 	{
 		m_pRenderer->ModifyMeshAlpha(alpha, m_vpMatrices[i]->m_pMesh);
+
+		for(int lod = 0; lod < QUBICLE_NUM_LODS - 1; lod++)
+		{
+			if(m_vpMatrices[i]->m_pLODMeshes[lod] != NULL)
+			{
+				m_pRenderer->ModifyMeshAlpha(alpha, m_vpMatrices[i]->m_pLODMeshes[lod]);
+			}
+		}
 	}
 }
 
@@ -482,6 +515,14 @@ void QubicleBinary::SetMeshSingleColour(float r, float g, float b)
 	for(unsigned int i = 0; i < m_vpMatrices.size(); i++)
 	{
 		m_pRenderer->ModifyMeshColour(r, g, b, m_vpMatrices[i]->m_pMesh);
+
+		for(int lod = 0; lod < QUBICLE_NUM_LODS - 1; lod++)
+		{
+			if(m_vpMatrices[i]->m_pLODMeshes[lod] != NULL)
+			{
+				m_pRenderer->ModifyMeshColour(r, g, b, m_vpMatrices[i]->m_pLODMeshes[lod]);
+			}
+		}
 	}
 }
 
@@ -490,6 +531,14 @@ void QubicleBinary::ConvertMeshColour(float r, float g, float b, float matchR, f
 	for (unsigned int i = 0; i < m_vpMatrices.size(); i++)
 	{
 		m_pRenderer->ConvertMeshColour(r, g, b, matchR, matchG, matchB, m_vpMatrices[i]->m_pMesh);
+
+		for(int lod = 0; lod < QUBICLE_NUM_LODS - 1; lod++)
+		{
+			if(m_vpMatrices[i]->m_pLODMeshes[lod] != NULL)
+			{
+				m_pRenderer->ConvertMeshColour(r, g, b, matchR, matchG, matchB, m_vpMatrices[i]->m_pLODMeshes[lod]);
+			}
+		}
 	}
 }
 
@@ -502,268 +551,377 @@ bool IsMergedZPositive(int *merged, int x, int y, int z, int width, int height)
 
 void QubicleBinary::CreateMesh(bool lDoFaceMerging)
 {
+	PROFILE_ZONE("QubicleBinary::CreateMesh");
+
 	for(unsigned int matrixIndex = 0; matrixIndex < m_vpMatrices.size(); matrixIndex++)
 	{
 		QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
 
-		int *l_merged;
-
-		l_merged = new int[pMatrix->m_matrixSizeX*pMatrix->m_matrixSizeY*pMatrix->m_matrixSizeZ];
-
-		for(unsigned int i = 0; i < pMatrix->m_matrixSizeX*pMatrix->m_matrixSizeY*pMatrix->m_matrixSizeZ; i++)
-		{
-			l_merged[i] = MergedSide_None;
-		}
-
 		if(pMatrix->m_pMesh == NULL)
 		{
 			pMatrix->m_pMesh = m_pRenderer->CreateMesh(OGLMeshType_Textured);
 		}
 
-		float r = 1.0f;
-		float g = 1.0f;
-		float b = 1.0f;
-		float a = 1.0f;	
+		CreateMatrixMesh(pMatrix, pMatrix->m_pMesh, lDoFaceMerging, vec3(1.0f, 1.0f, 1.0f));
+
+		CreateLODMeshes(pMatrix, lDoFaceMerging);
+	}
+}
+
+void QubicleBinary::CreateMatrixMesh(QubicleMatrix* pMatrix, OpenGLTriangleMesh* pMesh, bool lDoFaceMerging, vec3 blockSize)
+{
+	int *l_merged;
+
+	l_merged = new int[pMatrix->m_matrixSizeX*pMatrix->m_matrixSizeY*pMatrix->m_matrixSizeZ];
 
-		for(unsigned int x = 0; x < pMatrix->m_matrixSizeX; x++)
+	for(unsigned int i = 0; i < pMatrix->m_matrixSizeX*pMatrix->m_matrixSizeY*pMatrix->m_matrixSizeZ; i++)
+	{
+		l_merged[i] = MergedSide_None;
+	}
+
+	float r = 1.0f;
+	float g = 1.0f;
+	float b = 1.0f;
+	float a = 1.0f;	
+
+	for(unsigned int x = 0; x < pMatrix->m_matrixSizeX; x++)
+	{
+		for(unsigned int y = 0; y < pMatrix->m_matrixSizeY; y++)
 		{
-			for(unsigned int y = 0; y < pMatrix->m_matrixSizeY; y++)
+			for(unsigned int z = 0; z < pMatrix->m_matrixSizeZ; z++)
 			{
-				for(unsigned int z = 0; z < pMatrix->m_matrixSizeZ; z++)
+				if(pMatrix->GetActive(x, y, z) == false)
 				{
-					if(GetActive(matrixIndex, x, y, z) == false)
+					continue;
+				}
+				else
+				{
+					GetColour(pMatrix, x, y, z, &r, &g, &b, &a);
+
+					a = 1.0f;
+
+					// Block corners, a block spans blockSize voxels of the full resolution matrix
+					float x1 = x*blockSize.x - BLOCK_RENDER_SIZE;
+					float y1 = y*blockSize.y - BLOCK_RENDER_SIZE;
+					float z1 = z*blockSize.z - BLOCK_RENDER_SIZE;
+					float x2 = x1 + blockSize.x*BLOCK_RENDER_SIZE*2.0f;
+					float y2 = y1 + blockSize.y*BLOCK_RENDER_SIZE*2.0f;
+					float z2 = z1 + blockSize.z*BLOCK_RENDER_SIZE*2.0f;
+
+					vec3 p1(x1, y1, z2);
+					vec3 p2(x2, y1, z2);
+					vec3 p3(x2, y2, z2);
+					vec3 p4(x1, y2, z2);
+					vec3 p5(x2, y1, z1);
+					vec3 p6(x1, y1, z1);
+					vec3 p7(x1, y2, z1);
+					vec3 p8(x2, y2, z1);
+
+					vec3 n1;
+					unsigned int v1, v2, v3, v4;
+					unsigned int t1, t2, t3, t4;
+
+					bool doXPositive = (IsMergedXPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					bool doXNegative = (IsMergedXNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					bool doYPositive = (IsMergedYPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					bool doYNegative = (IsMergedYNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					bool doZPositive = (IsMergedZPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					bool doZNegative = (IsMergedZNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+
+					// Front
+					if(doZPositive && ((z == pMatrix->m_matrixSizeZ-1) || z < pMatrix->m_matrixSizeZ-1 && pMatrix->GetActive(x, y, z+1) == false))
 					{
-						continue;
+						int endX = pMatrix->m_matrixSizeX;
+						int endY = pMatrix->m_matrixSizeY;
+						
+						if (lDoFaceMerging)
+						{
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p1, &p2, &p3, &p4, x, y, endX, endY, true, true, false, false, blockSize);
+						}
+
+						n1 = vec3(0.0f, 0.0f, 1.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
 					}
-					else
-					{
-						GetColour(matrixIndex, x, y, z, &r, &g, &b, &a);
 
-						a = 1.0f;
+					p1 = vec3(x1, y1, z2);
+					p2 = vec3(x2, y1, z2);
+					p3 = vec3(x2, y2, z2);
+					p4 = vec3(x1, y2, z2);
+					p5 = vec3(x2, y1, z1);
+					p6 = vec3(x1, y1, z1);
+					p7 = vec3(x1, y2, z1);
+					p8 = vec3(x2, y2, z1);
+
+					// Back
+					if(doZNegative && ((z == 0) || (z > 0 && pMatrix->GetActive(x, y, z-1) == false)))
+					{
+						int endX = pMatrix->m_matrixSizeX;
+						int endY = pMatrix->m_matrixSizeY;
 
-						vec3 p1(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						vec3 p2(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						vec3 p3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						vec3 p4(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						vec3 p5(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						vec3 p6(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						vec3 p7(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						vec3 p8(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
+						if (lDoFaceMerging)
+						{
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p5, &p8, &p7, x, y, endX, endY, false, true, false, false, blockSize);
+						}
 
-						vec3 n1;
-						unsigned int v1, v2, v3, v4;
-						unsigned int t1, t2, t3, t4;
+						n1 = vec3(0.0f, 0.0f, -1.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+					}
 
-						bool doXPositive = (IsMergedXPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
-						bool doXNegative = (IsMergedXNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
-						bool doYPositive = (IsMergedYPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
-						bool doYNegative = (IsMergedYNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
-						bool doZPositive = (IsMergedZPositive(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
-						bool doZNegative = (IsMergedZNegative(l_merged, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY) == false);
+					p1 = vec3(x1, y1, z2);
+					p2 = vec3(x2, y1, z2);
+					p3 = vec3(x2, y2, z2);
+					p4 = vec3(x1, y2, z2);
+					p5 = vec3(x2, y1, z1);
+					p6 = vec3(x1, y1, z1);
+					p7 = vec3(x1, y2, z1);
+					p8 = vec3(x2, y2, z1);
+
+					// Right
+					if(doXPositive && ((x == pMatrix->m_matrixSizeX-1) || (x < pMatrix->m_matrixSizeX-1 && pMatrix->GetActive(x+1, y, z) == false)))
+					{
+						int endX = pMatrix->m_matrixSizeZ;
+						int endY = pMatrix->m_matrixSizeY;
 
-						// Front
-						if(doZPositive && ((z == pMatrix->m_matrixSizeZ-1) || z < pMatrix->m_matrixSizeZ-1 && GetActive(matrixIndex, x, y, z+1) == false))
+						if (lDoFaceMerging)
 						{
-							int endX = pMatrix->m_matrixSizeX;
-							int endY = pMatrix->m_matrixSizeY;
-							
-							if (lDoFaceMerging)
-							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p1, &p2, &p3, &p4, x, y, endX, endY, true, true, false, false);
-							}
-
-							n1 = vec3(0.0f, 0.0f, 1.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p5, &p2, &p3, &p8, z, y, endX, endY, true, false, true, false, blockSize);
 						}
 
-						p1 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p2 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p3 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p4 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p5 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p6 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p7 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p8 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-
-						// Back
-						if(doZNegative && ((z == 0) || (z > 0 && GetActive(matrixIndex, x, y, z-1) == false)))
-						{
-							int endX = pMatrix->m_matrixSizeX;
-							int endY = pMatrix->m_matrixSizeY;
+						n1 = vec3(1.0f, 0.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+					}
 
-							if (lDoFaceMerging)
-							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p5, &p8, &p7, x, y, endX, endY, false, true, false, false);
-							}
+					p1 = vec3(x1, y1, z2);
+					p2 = vec3(x2, y1, z2);
+					p3 = vec3(x2, y2, z2);
+					p4 = vec3(x1, y2, z2);
+					p5 = vec3(x2, y1, z1);
+					p6 = vec3(x1, y1, z1);
+					p7 = vec3(x1, y2, z1);
+					p8 = vec3(x2, y2, z1);
+
+					// Left
+					if(doXNegative && ((x == 0) || (x > 0 && pMatrix->GetActive(x-1, y, z) == false)))
+					{
+						int endX = pMatrix->m_matrixSizeZ;
+						int endY = pMatrix->m_matrixSizeY;
 
-							n1 = vec3(0.0f, 0.0f, -1.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
+						if (lDoFaceMerging)
+						{
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p1, &p4, &p7, z, y, endX, endY, false, false, true, false, blockSize);
 						}
 
-						p1 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p2 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p3 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p4 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p5 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p6 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p7 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p8 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-
-						// Right
-						if(doXPositive && ((x == pMatrix->m_matrixSizeX-1) || (x < pMatrix->m_matrixSizeX-1 && GetActive(matrixIndex, x+1, y, z) == false)))
-						{
-							int endX = pMatrix->m_matrixSizeZ;
-							int endY = pMatrix->m_matrixSizeY;
+						n1 = vec3(-1.0f, 0.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+					}
 
-							if (lDoFaceMerging)
-							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p5, &p2, &p3, &p8, z, y, endX, endY, true, false, true, false);
-							}
+					p1 = vec3(x1, y1, z2);
+					p2 = vec3(x2, y1, z2);
+					p3 = vec3(x2, y2, z2);
+					p4 = vec3(x1, y2, z2);
+					p5 = vec3(x2, y1, z1);
+					p6 = vec3(x1, y1, z1);
+					p7 = vec3(x1, y2, z1);
+					p8 = vec3(x2, y2, z1);
+
+					// Top
+					if(doYPositive && ((y == pMatrix->m_matrixSizeY-1) || (y < pMatrix->m_matrixSizeY-1 && pMatrix->GetActive(x, y+1, z) == false)))
+					{
+						int endX = pMatrix->m_matrixSizeX;
+						int endY = pMatrix->m_matrixSizeZ;
 
-							n1 = vec3(1.0f, 0.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
+						if (lDoFaceMerging)
+						{
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p7, &p8, &p3, &p4, x, z, endX, endY, true, false, false, true, blockSize);
 						}
 
-						p1 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p2 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p3 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p4 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p5 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p6 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p7 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p8 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-
-						// Left
-						if(doXNegative && ((x == 0) || (x > 0 && GetActive(matrixIndex, x-1, y, z) == false)))
-						{
-							int endX = pMatrix->m_matrixSizeZ;
-							int endY = pMatrix->m_matrixSizeY;
+						n1 = vec3(0.0f, 1.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+					}
 
-							if (lDoFaceMerging)
-							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p1, &p4, &p7, z, y, endX, endY, false, false, true, false);
-							}
+					p1 = vec3(x1, y1, z2);
+					p2 = vec3(x2, y1, z2);
+					p3 = vec3(x2, y2, z2);
+					p4 = vec3(x1, y2, z2);
+					p5 = vec3(x2, y1, z1);
+					p6 = vec3(x1, y1, z1);
+					p7 = vec3(x1, y2, z1);
+					p8 = vec3(x2, y2, z1);
+
+					// Bottom
+					if(doYNegative && ((y == 0) || (y > 0 && pMatrix->GetActive(x, y-1, z) == false)))
+					{
+						int endX = pMatrix->m_matrixSizeX;
+						int endY = pMatrix->m_matrixSizeZ;
 
-							n1 = vec3(-1.0f, 0.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
+						if (lDoFaceMerging)
+						{
+							UpdateMergedSide(l_merged, pMatrix, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p5, &p2, &p1, x, z, endX, endY, false, false, false, true, blockSize);
 						}
 
-						p1 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p2 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p3 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p4 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p5 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p6 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p7 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p8 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-
-						// Top
-						if(doYPositive && ((y == pMatrix->m_matrixSizeY-1) || (y < pMatrix->m_matrixSizeY-1 && GetActive(matrixIndex, x, y+1, z) == false)))
-						{
-							int endX = pMatrix->m_matrixSizeX;
-							int endY = pMatrix->m_matrixSizeZ;
+						n1 = vec3(0.0f, -1.0f, 0.0f);
+						v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMesh);
+						t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMesh);
+						v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMesh);
+						t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMesh);
+						v3 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMesh);
+						t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMesh);
+						v4 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMesh);
+						t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMesh);
+
+						m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMesh);
+						m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMesh);
+					}
+				}
+			}
+		}
+	}
 
-							if (lDoFaceMerging)
-							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p7, &p8, &p3, &p4, x, z, endX, endY, true, false, false, true);
-							}
+	m_pRenderer->FinishMesh(-1, m_materialID, pMesh);
 
-							n1 = vec3(0.0f, 1.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p4, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p3, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p8, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p7, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
-						}
+	// Delete the merged array
+	delete [] l_merged;
+}
 
-						p1 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p2 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p3 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p4 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z+BLOCK_RENDER_SIZE);
-						p5 = vec3(x+BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p6 = vec3(x-BLOCK_RENDER_SIZE, y-BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p7 = vec3(x-BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-						p8 = vec3(x+BLOCK_RENDER_SIZE, y+BLOCK_RENDER_SIZE, z-BLOCK_RENDER_SIZE);
-
-						// Bottom
-						if(doYNegative && ((y == 0) || (y > 0 && GetActive(matrixIndex, x, y-1, z) == false)))
-						{
-							int endX = pMatrix->m_matrixSizeX;
-							int endY = pMatrix->m_matrixSizeZ;
+void QubicleBinary::CreateLODMeshes(QubicleMatrix* pMatrix, bool lDoFaceMerging)
+{
+	ClearLODMeshes(pMatrix);
+
+	unsigned int largestSize = pMatrix->m_matrixSizeX;
+	largestSize = (pMatrix->m_matrixSizeY > largestSize) ? pMatrix->m_matrixSizeY : largestSize;
+	largestSize = (pMatrix->m_matrixSizeZ > largestSize) ? pMatrix->m_matrixSizeZ : largestSize;
+
+	for(int lod = 1; lod < QUBICLE_NUM_LODS; lod++)
+	{
+		unsigned int merge = 1 << lod;
 
-							if (lDoFaceMerging)
+		// Nothing left to merge, the coarser levels fall back to the last one built
+		if(largestSize < merge)
+		{
+			break;
+		}
+
+		// Each LOD voxel covers a merge*merge*merge block, the last block on an axis may be partial
+		QubicleMatrix lodMatrix;
+		lodMatrix.m_matrixSizeX = (pMatrix->m_matrixSizeX + merge - 1) / merge;
+		lodMatrix.m_matrixSizeY = (pMatrix->m_matrixSizeY + merge - 1) / merge;
+		lodMatrix.m_matrixSizeZ = (pMatrix->m_matrixSizeZ + merge - 1) / merge;
+		lodMatrix.m_pColour = new unsigned int[lodMatrix.m_matrixSizeX*lodMatrix.m_matrixSizeY*lodMatrix.m_matrixSizeZ];
+
+		for(unsigned int x = 0; x < lodMatrix.m_matrixSizeX; x++)
+		{
+			for(unsigned int y = 0; y < lodMatrix.m_matrixSizeY; y++)
+			{
+				for(unsigned int z = 0; z < lodMatrix.m_matrixSizeZ; z++)
+				{
+					// Active if any of the voxels it covers are, so thin parts don't disappear, coloured by their average
+					unsigned int red = 0;
+					unsigned int green = 0;
+					unsigned int blue = 0;
+					unsigned int alpha = 0;
+					unsigned int numActive = 0;
+
+					for(unsigned int sx = x*merge; sx < (x+1)*merge && sx < pMatrix->m_matrixSizeX; sx++)
+					{
+						for(unsigned int sy = y*merge; sy < (y+1)*merge && sy < pMatrix->m_matrixSizeY; sy++)
+						{
+							for(unsigned int sz = z*merge; sz < (z+1)*merge && sz < pMatrix->m_matrixSizeZ; sz++)
 							{
-								UpdateMergedSide(l_merged, matrixIndex, x, y, z, pMatrix->m_matrixSizeX, pMatrix->m_matrixSizeY, &p6, &p5, &p2, &p1, x, z, endX, endY, false, false, false, true);
-							}
+								if(pMatrix->GetActive(sx, sy, sz) == false)
+								{
+									continue;
+								}
 
-							n1 = vec3(0.0f, -1.0f, 0.0f);
-							v1 = m_pRenderer->AddVertexToMesh(p6, n1, r, g, b, a, pMatrix->m_pMesh);
-							t1 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 0.0f, pMatrix->m_pMesh);
-							v2 = m_pRenderer->AddVertexToMesh(p5, n1, r, g, b, a, pMatrix->m_pMesh);
-							t2 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 0.0f, pMatrix->m_pMesh);
-							v3 = m_pRenderer->AddVertexToMesh(p2, n1, r, g, b, a, pMatrix->m_pMesh);
-							t3 = m_pRenderer->AddTextureCoordinatesToMesh(1.0f, 1.0f, pMatrix->m_pMesh);
-							v4 = m_pRenderer->AddVertexToMesh(p1, n1, r, g, b, a, pMatrix->m_pMesh);
-							t4 = m_pRenderer->AddTextureCoordinatesToMesh(0.0f, 1.0f, pMatrix->m_pMesh);
-
-							m_pRenderer->AddTriangleToMesh(v1, v2, v3, pMatrix->m_pMesh);
-							m_pRenderer->AddTriangleToMesh(v1, v3, v4, pMatrix->m_pMesh);
+								unsigned int colour = pMatrix->GetColourCompact(sx, sy, sz);
+								red += (colour & 0x000000FF);
+								green += (colour & 0x0000FF00) >> 8;
+								blue += (colour & 0x00FF0000) >> 16;
+								alpha += (colour & 0xFF000000) >> 24;
+								numActive++;
+							}
 						}
 					}
+
+					unsigned int colour = 0;
+					if(numActive > 0)
+					{
+						colour = (red / numActive) | ((green / numActive) << 8) | ((blue / numActive) << 16) | ((alpha / numActive) << 24);
+					}
+
+					lodMatrix.m_pColour[x + lodMatrix.m_matrixSizeX * (y + lodMatrix.m_matrixSizeY * z)] = colour;
 				}
 			}
 		}
 
-		m_pRenderer->FinishMesh(-1, m_materialID, pMatrix->m_pMesh);
+		// Stretch the blocks so the LOD keeps the same bounds as the full resolution matrix
+		vec3 blockSize((float)pMatrix->m_matrixSizeX / lodMatrix.m_matrixSizeX, (float)pMatrix->m_matrixSizeY / lodMatrix.m_matrixSizeY, (float)pMatrix->m_matrixSizeZ / lodMatrix.m_matrixSizeZ);
+
+		pMatrix->m_pLODMeshes[lod - 1] = m_pRenderer->CreateMesh(OGLMeshType_Textured);
+		CreateMatrixMesh(&lodMatrix, pMatrix->m_pLODMeshes[lod - 1], lDoFaceMerging, blockSize);
 
-		// Delete the merged array
-		delete [] l_merged;
+		delete [] lodMatrix.m_pColour;
+	}
+}
+
+void QubicleBinary::ClearLODMeshes(QubicleMatrix* pMatrix)
+{
+	for(int lod = 0; lod < QUBICLE_NUM_LODS - 1; lod++)
+	{
+		if(pMatrix->m_pLODMeshes[lod] != NULL)
+		{
+			m_pRenderer->ClearMesh(pMatrix->m_pLODMeshes[lod]);
+			pMatrix->m_pLODMeshes[lod] = NULL;
+		}
 	}
 }
 
@@ -778,10 +936,8 @@ void QubicleBinary::RebuildMesh(bool lDoFaceMerging)
 	CreateMesh(lDoFaceMerging);
 }
 
-void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, int blocky, int blockz, int width, int height, vec3 *p1, vec3 *p2, vec3 *p3, vec3 *p4, int startX, int startY, int maxX, int maxY, bool positive, bool zFace, bool xFace, bool yFace)
+void QubicleBinary::UpdateMergedSide(int *merged, QubicleMatrix* pMatrix, int blockx, int blocky, int blockz, int width, int height, vec3 *p1, vec3 *p2, vec3 *p3, vec3 *p4, int startX, int startY, int maxX, int maxY, bool positive, bool zFace, bool xFace, bool yFace, vec3 blockSize)
 {
-	QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
-
 	bool doMore = true;
 	unsigned int incrementX = 0;
 	unsigned int incrementZ = 0;
@@ -816,8 +972,8 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 		{
 			bool doPhase1Merge = true;
 			float r1, r2, g1, g2, b1, b2, a1, a2;
-			GetColour(matrixIndex, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
-			GetColour(matrixIndex, blockx + incrementX, blocky, blockz + incrementZ, &r2, &g2, &b2, &a2);
+			GetColour(pMatrix, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
+			GetColour(pMatrix, blockx + incrementX, blocky, blockz + incrementZ, &r2, &g2, &b2, &a2);
 			//if(m_pBlocks[blockx][blocky][blockz].GetBlockType() != m_pBlocks[blockx + incrementX][blocky][blockz + incrementZ].GetBlockType())
 			//{
 				// Don't do any phase 1 merging if we don't have the same block type.
@@ -843,37 +999,37 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 					doMore = false;
 				}
 				// Don't do any phase 1 merging if we find an inactive block or already merged block in our path
-				else if(xFace && positive && (blockx + incrementX+1) < pMatrix->m_matrixSizeX && GetActive(matrixIndex, blockx + incrementX+1, blocky, blockz + incrementZ) == true)
+				else if(xFace && positive && (blockx + incrementX+1) < pMatrix->m_matrixSizeX && pMatrix->GetActive(blockx + incrementX+1, blocky, blockz + incrementZ) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(xFace && !positive && (blockx + incrementX) > 0 && GetActive(matrixIndex, blockx + incrementX-1, blocky, blockz + incrementZ) == true)
+				else if(xFace && !positive && (blockx + incrementX) > 0 && pMatrix->GetActive(blockx + incrementX-1, blocky, blockz + incrementZ) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(yFace && positive && (blocky+1) < (int)pMatrix->m_matrixSizeY && GetActive(matrixIndex, blockx + incrementX, blocky+1, blockz + incrementZ) == true)
+				else if(yFace && positive && (blocky+1) < (int)pMatrix->m_matrixSizeY && pMatrix->GetActive(blockx + incrementX, blocky+1, blockz + incrementZ) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(yFace && !positive && blocky > 0 && GetActive(matrixIndex, blockx + incrementX, blocky-1, blockz + incrementZ) == true)
+				else if(yFace && !positive && blocky > 0 && pMatrix->GetActive(blockx + incrementX, blocky-1, blockz + incrementZ) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(zFace && positive && (blockz + incrementZ+1) < pMatrix->m_matrixSizeZ && GetActive(matrixIndex, blockx + incrementX, blocky, blockz + incrementZ+1) == true)
+				else if(zFace && positive && (blockz + incrementZ+1) < pMatrix->m_matrixSizeZ && pMatrix->GetActive(blockx + incrementX, blocky, blockz + incrementZ+1) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(zFace && !positive && (blockz + incrementZ) > 0 && GetActive(matrixIndex, blockx + incrementX, blocky, blockz + incrementZ-1) == true)
+				else if(zFace && !positive && (blockz + incrementZ) > 0 && pMatrix->GetActive(blockx + incrementX, blocky, blockz + incrementZ-1) == true)
 				{
 					doPhase1Merge = false;
 					doMore = false;
 				}
-				else if(GetActive(matrixIndex, blockx + incrementX, blocky, blockz + incrementZ) == false)
+				else if(pMatrix->GetActive(blockx + incrementX, blocky, blockz + incrementZ) == false)
 				{
 					doPhase1Merge = false;
 					doMore = false;
@@ -898,13 +1054,13 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 				{
 					if(zFace || yFace)
 					{
-						(*p2).x += change * (BLOCK_RENDER_SIZE * 2.0f);
-						(*p3).x += change * (BLOCK_RENDER_SIZE * 2.0f);
+						(*p2).x += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.x);
+						(*p3).x += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.x);
 					}
 					if(xFace)
 					{
-						(*p2).z += change * (BLOCK_RENDER_SIZE * 2.0f);
-						(*p3).z += change * (BLOCK_RENDER_SIZE * 2.0f);
+						(*p2).z += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.z);
+						(*p3).z += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.z);
 					}
 
 					if(positive)
@@ -978,18 +1134,18 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 				if(zFace)
 				{
 					float r1, r2, g1, g2, b1, b2, a1, a2;
-					GetColour(matrixIndex, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
-					GetColour(matrixIndex, blockx + i, blocky + incrementY, blockz, &r2, &g2, &b2, &a2);
+					GetColour(pMatrix, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
+					GetColour(pMatrix, blockx + i, blocky + incrementY, blockz, &r2, &g2, &b2, &a2);
 
-					if(positive && (blockz+1) < (int)pMatrix->m_matrixSizeZ && GetActive(matrixIndex, blockx + i, blocky + incrementY, blockz+1) == true)
+					if(positive && (blockz+1) < (int)pMatrix->m_matrixSizeZ && pMatrix->GetActive(blockx + i, blocky + incrementY, blockz+1) == true)
 					{
 						doMore = false;
 					}
-					else if(!positive && blockz > 0 && GetActive(matrixIndex, blockx + i, blocky + incrementY, blockz-1) == true)
+					else if(!positive && blockz > 0 && pMatrix->GetActive(blockx + i, blocky + incrementY, blockz-1) == true)
 					{
 						doMore = false;
 					}
-					else if(GetActive(matrixIndex, blockx + i, blocky + incrementY, blockz) == false || (positive ? (IsMergedZPositive(merged, blockx + i, blocky + incrementY, blockz, width, height) == true) : (IsMergedZNegative(merged, blockx + i, blocky + incrementY, blockz, width, height) == true)))
+					else if(pMatrix->GetActive(blockx + i, blocky + incrementY, blockz) == false || (positive ? (IsMergedZPositive(merged, blockx + i, blocky + incrementY, blockz, width, height) == true) : (IsMergedZNegative(merged, blockx + i, blocky + incrementY, blockz, width, height) == true)))
 					{
 						// Failed active or already merged check
 						doMore = false;
@@ -1009,18 +1165,18 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 				if(xFace)
 				{
 					float r1, r2, g1, g2, b1, b2, a1, a2;
-					GetColour(matrixIndex, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
-					GetColour(matrixIndex, blockx, blocky + incrementY, blockz + i, &r2, &g2, &b2, &a2);
+					GetColour(pMatrix, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
+					GetColour(pMatrix, blockx, blocky + incrementY, blockz + i, &r2, &g2, &b2, &a2);
 
-					if(positive && (blockx+1) < (int)pMatrix->m_matrixSizeX && GetActive(matrixIndex, blockx+1, blocky + incrementY, blockz + i) == true)
+					if(positive && (blockx+1) < (int)pMatrix->m_matrixSizeX && pMatrix->GetActive(blockx+1, blocky + incrementY, blockz + i) == true)
 					{
 						doMore = false;
 					}
-					else if(!positive && (blockx) > 0 && GetActive(matrixIndex, blockx-1, blocky + incrementY, blockz + i) == true)
+					else if(!positive && (blockx) > 0 && pMatrix->GetActive(blockx-1, blocky + incrementY, blockz + i) == true)
 					{
 						doMore = false;
 					}
-					else if(GetActive(matrixIndex, blockx, blocky + incrementY, blockz + i) == false || (positive ? (IsMergedXPositive(merged, blockx, blocky + incrementY, blockz + i, width, height) == true) : (IsMergedXNegative(merged, blockx, blocky + incrementY, blockz + i, width, height) == true)))
+					else if(pMatrix->GetActive(blockx, blocky + incrementY, blockz + i) == false || (positive ? (IsMergedXPositive(merged, blockx, blocky + incrementY, blockz + i, width, height) == true) : (IsMergedXNegative(merged, blockx, blocky + incrementY, blockz + i, width, height) == true)))
 					{
 						// Failed active or already merged check
 						doMore = false;
@@ -1040,18 +1196,18 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 				if(yFace)
 				{
 					float r1, r2, g1, g2, b1, b2, a1, a2;
-					GetColour(matrixIndex, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
-					GetColour(matrixIndex, blockx + i, blocky, blockz + incrementY, &r2, &g2, &b2, &a2);
+					GetColour(pMatrix, blockx, blocky, blockz, &r1, &g1, &b1, &a1);
+					GetColour(pMatrix, blockx + i, blocky, blockz + incrementY, &r2, &g2, &b2, &a2);
 
-					if(positive && (blocky+1) < (int)pMatrix->m_matrixSizeY && GetActive(matrixIndex, blockx + i, blocky+1, blockz + incrementY) == true)
+					if(positive && (blocky+1) < (int)pMatrix->m_matrixSizeY && pMatrix->GetActive(blockx + i, blocky+1, blockz + incrementY) == true)
 					{
 						doMore = false;
 					}
-					else if(!positive && blocky > 0 && GetActive(matrixIndex, blockx + i, blocky-1, blockz + incrementY) == true)
+					else if(!positive && blocky > 0 && pMatrix->GetActive(blockx + i, blocky-1, blockz + incrementY) == true)
 					{
 						doMore = false;
 					}
-					else if(GetActive(matrixIndex, blockx + i, blocky, blockz + incrementY) == false || (positive ? (IsMergedYPositive(merged, blockx + i, blocky, blockz + incrementY, width, height) == true) : (IsMergedYNegative(merged, blockx + i, blocky, blockz + incrementY, width, height) == true)))
+					else if(pMatrix->GetActive(blockx + i, blocky, blockz + incrementY) == false || (positive ? (IsMergedYPositive(merged, blockx + i, blocky, blockz + incrementY, width, height) == true) : (IsMergedYNegative(merged, blockx + i, blocky, blockz + incrementY, width, height) == true)))
 					{
 						// Failed active or already merged check
 						doMore = false;
@@ -1074,13 +1230,13 @@ void QubicleBinary::UpdateMergedSide(int *merged, int matrixIndex, int blockx, i
 			{
 				if(zFace || xFace)
 				{
-					(*p3).y += change * (BLOCK_RENDER_SIZE * 2.0f);
-					(*p4).y += change * (BLOCK_RENDER_SIZE * 2.0f);
+					(*p3).y += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.y);
+					(*p4).y += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.y);
 				}
 				if(yFace)
 				{
-					(*p3).z += change * (BLOCK_RENDER_SIZE * 2.0f);
-					(*p4).z += change * (BLOCK_RENDER_SIZE * 2.0f);
+					(*p3).z += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.z);
+					(*p4).z += change * (BLOCK_RENDER_SIZE * 2.0f * blockSize.z);
 				}
 
 				for(int i = 0; i < loop-1; i++)
@@ -1162,6 +1318,42 @@ vec3 QubicleBinary::GetMatrixOffset(int index)
 	return vec3(m_vpMatrices[index]->m_offsetX, m_vpMatrices[index]->m_offsetY, m_vpMatrices[index]->m_offsetZ);
 }
 
+// The scale and centring that Render() applies to a matrix on the stack, as a single matrix
+Matrix4x4 QubicleBinary::GetMatrixLocalTransform(int index)
+{
+	QubicleMatrix* pMatrix = m_vpMatrices[index];
+
+	Matrix4x4 scale;
+	scale.SetScale(vec3(pMatrix->m_scale, pMatrix->m_scale, pMatrix->m_scale));
+
+	Matrix4x4 translate;
+	translate.SetTranslation(vec3(0.5f - (float)pMatrix->m_matrixSizeX*0.5f + pMatrix->m_offsetX, 0.5f - (float)pMatrix->m_matrixSizeY*0.5f + pMatrix->m_offsetY, 0.5f - (float)pMatrix->m_matrixSizeZ*0.5f + pMatrix->m_offsetZ));
+
+	return translate * scale;
+}
+
+// The radius of a sphere around the model origin that holds every matrix once placed by GetMatrixLocalTransform()
+float QubicleBinary::GetBoundingRadius()
+{
+	float radius = 0.0f;
+	for(unsigned int i = 0; i < m_numMatrices; i++)
+	{
+		QubicleMatrix* pMatrix = m_vpMatrices[i];
+		if(pMatrix->m_removed == true)
+		{
+			continue;
+		}
+
+		vec3 halfSize = vec3((float)pMatrix->m_matrixSizeX, (float)pMatrix->m_matrixSizeY, (float)pMatrix->m_matrixSizeZ) * 0.5f;
+		vec3 offset = vec3(pMatrix->m_offsetX, pMatrix->m_offsetY, pMatrix->m_offsetZ);
+		float matrixRadius = (length(halfSize) + length(offset)) * pMatrix->m_scale;
+
+		radius = matrixRadius > radius ? matrixRadius : radius;
+	}
+
+	return radius;
+}
+
 void QubicleBinary::SetupMatrixBones(MS3DAnimator* pSkeleton)
 {
 	for(unsigned int i = 0; i < m_numMatrices; i++)
@@ -1281,6 +1473,190 @@ void QubicleBinary::SetQubicleMatrixRender(const char* matrixName, bool render)
 	}
 }
 
+// LOD
+void QubicleBinary::SetLODSelection(QubicleLODSelection* pLODSelection)
+{
+	m_pLODSelection = pLODSelection;
+}
+
+int QubicleBinary::GetNumTriangles(int lod)
+{
+	int numTriangles = 0;
+
+	for(unsigned int i = 0; i < m_numMatrices; i++)
+	{
+		if(m_vpMatrices[i]->m_removed == true)
+		{
+			continue;
+		}
+
+		OpenGLTriangleMesh* pMesh = m_vpMatrices[i]->GetLODMesh(lod);
+		if(pMesh != NULL)
+		{
+			int numVerts;
+			int numTris;
+			m_pRenderer->GetMeshInformation(&numVerts, &numTris, pMesh);
+
+			numTriangles += numTris;
+		}
+	}
+
+	return numTriangles;
+}
+
+int QubicleBinary::SelectLOD(int currentLOD, float voxelScreenSize)
+{
+	// LOD n merges 2^n voxels, go coarser once a merged voxel is clearly below the pixel limit
+	// and only come back once it is clearly above it
+	int lod = currentLOD;
+	while(lod < QUBICLE_NUM_LODS - 1 && voxelScreenSize * (1 << (lod + 1)) < QUBICLE_LOD_VOXEL_PIXELS * (1.0f - QUBICLE_LOD_HYSTERESIS))
+	{
+		lod++;
+	}
+	while(lod > 0 && voxelScreenSize * (1 << lod) > QUBICLE_LOD_VOXEL_PIXELS * (1.0f + QUBICLE_LOD_HYSTERESIS))
+	{
+		lod--;
+	}
+
+	return lod;
+}
+
+OpenGLTriangleMesh* QubicleBinary::GetMatrixRenderMesh(int matrixIndex)
+{
+	QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
+
+	QubicleLODSelection* pLODSelection = (m_pLODSelection != NULL) ? m_pLODSelection : &m_defaultLODSelection;
+	if(pLODSelection->m_vMatrixLODs.size() < m_numMatrices)
+	{
+		pLODSelection->m_vMatrixLODs.resize(m_numMatrices, 0);
+	}
+
+	// Size on screen of a single voxel at the middle of the matrix, the current world matrix is in voxel units
+	Matrix4x4 worldMatrix;
+	m_pRenderer->GetModelMatrix(&worldMatrix);
+	vec3 centre = worldMatrix * vec3((pMatrix->m_matrixSizeX - 1) * 0.5f, (pMatrix->m_matrixSizeY - 1) * 0.5f, (pMatrix->m_matrixSizeZ - 1) * 0.5f);
+	float voxelSize = length(worldMatrix.GetRightVector());
+	float voxelScreenSize = m_pRenderer->GetProjectedSize(centre, voxelSize);
+
+	int lod = SelectLOD(pLODSelection->m_vMatrixLODs[matrixIndex], voxelScreenSize);
+	pLODSelection->m_vMatrixLODs[matrixIndex] = lod;
+
+	return pMatrix->GetLODMesh(lod);
+}
+
+// Face placement, built on the CPU in the same order the renderer would apply each step to its world matrix
+static void TranslateFaceMatrix(Matrix4x4* pMatrix, float x, float y, float z)
+{
+	Matrix4x4 translate;
+	translate.SetTranslation(vec3(x, y, z));
+	*pMatrix = translate * (*pMatrix);
+}
+
+static void RotateFaceMatrix(Matrix4x4* pMatrix, float x, float y, float z)
+{
+	Matrix4x4 rotX;
+	Matrix4x4 rotY;
+	Matrix4x4 rotZ;
+	rotX.SetXRotation(DegToRad(x));
+	rotY.SetYRotation(DegToRad(y));
+	rotZ.SetZRotation(DegToRad(z));
+	*pMatrix = rotZ * rotY * rotX * (*pMatrix);
+}
+
+static void ScaleFaceMatrix(Matrix4x4* pMatrix, float x, float y, float z)
+{
+	Matrix4x4 scale;
+	scale.SetScale(vec3(x, y, z));
+	*pMatrix = scale * (*pMatrix);
+}
+
+Matrix4x4 QubicleBinary::GetFaceMatrix(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, int boneIndex, int matrixIndex, vec3 offset, bool useScale, bool useTranslate)
+{
+	Matrix4x4 faceMatrix;
+
+	if(useScale)
+	{
+		TranslateFaceMatrix(&faceMatrix, 0.0f, 0.0f, -pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
+		RotateFaceMatrix(&faceMatrix, pVoxelCharacter->GetHeadAndUpperBodyLookRotation()*0.65f, 0.0f, 0.0f);
+		TranslateFaceMatrix(&faceMatrix, 0.0f, 0.0f, pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
+
+		// Breathing animation
+		if(pVoxelCharacter->IsBreathingAnimationStarted())
+		{
+			float offsetAmount = 0.0f;
+			if(boneIndex != -1)
+			{
+				offsetAmount = pVoxelCharacter->GetBreathingAnimationOffsetForBone(boneIndex);
+			}
+
+			TranslateFaceMatrix(&faceMatrix, 0.0f, offsetAmount, 0.0f);
+		}
+	}
+
+	// Translate by attached bone matrix
+	Matrix4x4 boneMatrix = pSkeleton->GetBoneMatrix(boneIndex);
+	vec3 boneScale = pVoxelCharacter->GetBoneScale();
+	ScaleFaceMatrix(&faceMatrix, boneScale.x, boneScale.y, boneScale.z);
+	faceMatrix = boneMatrix * faceMatrix;
+	ScaleFaceMatrix(&faceMatrix, 1.0f/boneScale.x, 1.0f/boneScale.y, 1.0f/boneScale.z);
+
+	// Rotation due to 3dsmax export affecting the bone rotations
+	RotateFaceMatrix(&faceMatrix, 0.0f, 0.0f, -90.0f);
+
+	// Face looking direction
+	vec3 lForward = normalize(pVoxelCharacter->GetFaceLookingDirection());
+	vec3 lUp = vec3(0.0f, 1.0f, 0.0f);
+	vec3 lRight = normalize(cross(lUp, lForward));
+	lUp = normalize(cross(lForward, lRight));
+
+	float lMatrix[16] =
+	{
+		lRight.x, lRight.y, lRight.z, 0.0f,
+		lUp.x, lUp.y, lUp.z, 0.0f,
+		lForward.x, lForward.y, lForward.z, 0.0f,
+		0.0f, 0.0f, 0.0f, 1.0f
+	};
+	Matrix4x4 lookingMat;
+	lookingMat.SetValues(lMatrix);
+	faceMatrix = lookingMat * faceMatrix;
+
+	if(useScale)
+	{
+		// Scale for external matrix scale value
+		ScaleFaceMatrix(&faceMatrix, m_vpMatrices[matrixIndex]->m_scale, m_vpMatrices[matrixIndex]->m_scale, m_vpMatrices[matrixIndex]->m_scale);
+	}
+	if(useTranslate)
+	{
+		// Translate for external matrix offset value
+		TranslateFaceMatrix(&faceMatrix, m_vpMatrices[matrixIndex]->m_offsetX, m_vpMatrices[matrixIndex]->m_offsetY, m_vpMatrices[matrixIndex]->m_offsetZ);
+	}
+
+	TranslateFaceMatrix(&faceMatrix, offset.x, offset.y, offset.z);
+
+	return faceMatrix;
+}
+
+void QubicleBinary::RenderFaceQuad(VoxelCharacter* pVoxelCharacter, bool eyes, Matrix4x4 faceMatrix, bool transparency, FaceQuadBatch* pFaceQuadBatch)
+{
+	// Batched faces are placed in world space now and drawn together with every other face later, wireframe still draws them one by one
+	if(pFaceQuadBatch != NULL && m_renderWireFrame == false)
+	{
+		Matrix4x4 worldMatrix;
+		m_pRenderer->GetModelMatrix(&worldMatrix);
+
+		pVoxelCharacter->AddFaceQuad(pFaceQuadBatch, eyes, faceMatrix * worldMatrix, transparency);
+
+		return;
+	}
+
+	m_pRenderer->PushMatrix();
+		m_pRenderer->EnableMaterial(m_materialID);
+		m_pRenderer->MultiplyWorldMatrix(faceMatrix);
+
+		pVoxelCharacter->RenderFaceTextures(eyes, m_renderWireFrame, transparency);
+	m_pRenderer->PopMatrix();
+}
+
 // Sub selection
 string QubicleBinary::GetSubSelectionName(int pickingId)
 {
@@ -1365,6 +1741,9 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 					m_pRenderer->GetModelMatrix(&m_vpMatrices[i]->m_modelMatrix);
 				}
 
+				// Pick the LOD from how big the matrix is on screen
+				OpenGLTriangleMesh* pRenderMesh = GetMatrixRenderMesh(i);
+
 				m_pRenderer->PushMatrix();
 					m_pRenderer->StartMeshRender();
 
@@ -1386,11 +1765,11 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 					if(renderOutline || silhouette)
 					{
 						m_pRenderer->EndMeshRender();
-						m_pRenderer->RenderMesh_NoColour(m_vpMatrices[i]->m_pMesh);
+						m_pRenderer->RenderMesh_NoColour(pRenderMesh);
 					}
 					else
 					{
-						m_pRenderer->MeshStaticBufferRender(m_vpMatrices[i]->m_pMesh);
+						m_pRenderer->MeshStaticBufferRender(pRenderMesh);
 					}
 
 					if (m_meshAlpha < 1.0f)
@@ -1417,6 +1796,57 @@ void QubicleBinary::Render(bool renderOutline, bool reflection, bool silhouette,
 	m_pRenderer->PopMatrix();
 }
 
+// Renders a single matrix from a world matrix already composed with GetMatrixLocalTransform(), between the renderer's BeginCachedTransforms() and EndCachedTransforms()
+void QubicleBinary::RenderCached(int matrixIndex, const Matrix4x4& worldMatrix)
+{
+	QubicleMatrix* pMatrix = m_vpMatrices[matrixIndex];
+	if(pMatrix->m_removed == true)
+	{
+		return;
+	}
+
+	CullMode cullMode = m_pRenderer->GetCullMode();
+
+	if(m_renderWireFrame)
+	{
+		m_pRenderer->SetLineWidth(1.0f);
+		m_pRenderer->SetRenderMode(RM_WIREFRAME);
+		m_pRenderer->SetCullMode(CM_NOCULL);
+	}
+	else
+	{
+		m_pRenderer->SetRenderMode(RM_SHADED);
+	}
+
+	// Store the model matrix
+	pMatrix->m_modelMatrix = worldMatrix;
+
+	m_pRenderer->LoadCachedTransform(worldMatrix);
+
+	// Pick the LOD from how big the matrix is on screen
+	OpenGLTriangleMesh* pRenderMesh = GetMatrixRenderMesh(matrixIndex);
+
+	m_pRenderer->StartMeshRender();
+
+	if(m_meshAlpha < 1.0f)
+	{
+		m_pRenderer->EnableTransparency(BF_SRC_ALPHA, BF_ONE_MINUS_SRC_ALPHA);
+	}
+	m_pRenderer->EnableMaterial(m_materialID);
+
+	m_pRenderer->MeshStaticBufferRender(pRenderMesh);
+
+	if(m_meshAlpha < 1.0f)
+	{
+		m_pRenderer->DisableTransparency();
+	}
+
+	m_pRenderer->EndMeshRender();
+
+	// Restore cull mode
+	m_pRenderer->SetCullMode(cullMode);
+}
+
 void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking)
 {
 	if(pVoxelCharacter == NULL)
@@ -1607,6 +2037,9 @@ void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter*
 						m_pRenderer->GetModelMatrix(&m_vpMatrices[i]->m_modelMatrix);
 					}
 
+					// Pick the LOD from how big the matrix is on screen
+					OpenGLTriangleMesh* pRenderMesh = GetMatrixRenderMesh(i);
+
 					// Texture manipulation (for shadow rendering)
 					{
 						Matrix4x4 worldMatrix;
@@ -1625,11 +2058,11 @@ void QubicleBinary::RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter*
 					if(renderOutline || silhouette)
 					{
 						m_pRenderer->EndMeshRender();
-						m_pRenderer->RenderMesh_NoColour(m_vpMatrices[i]->m_pMesh);
+						m_pRenderer->RenderMesh_NoColour(pRenderMesh);
 					}
 					else
 					{
-						m_pRenderer->MeshStaticBufferRender(m_vpMatrices[i]->m_pMesh);
+						m_pRenderer->MeshStaticBufferRender(pRenderMesh);
 					}
 
 					if (m_meshAlpha < 1.0f)
@@ -1886,7 +2319,7 @@ void QubicleBinary::RenderSingleMatrix(MS3DAnimator** pSkeleton, VoxelCharacter*
 	m_pRenderer->PopMatrix();
 }
 
-void QubicleBinary::RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale, bool useTranslate)
+void QubicleBinary::RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale, bool useTranslate, FaceQuadBatch* pFaceQuadBatch)
 {
 	if(pVoxelCharacter == NULL)
 	{
@@ -1896,77 +2329,11 @@ void QubicleBinary::RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCh
 	// Render eyes
 	{
 		int eyesBoneIndex = pVoxelCharacter->GetEyesBone();
-		vec3 eyeOffset = pVoxelCharacter->GetEyesOffset();
 
 		if(eyesBoneIndex != -1)
 		{
-			m_pRenderer->PushMatrix();
-				m_pRenderer->EnableMaterial(m_materialID);
-
-				if(useScale)
-				{
-					m_pRenderer->TranslateWorldMatrix(0.0f, 0.0f, -pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
-					m_pRenderer->RotateWorldMatrix(pVoxelCharacter->GetHeadAndUpperBodyLookRotation()*0.65f, 0.0f, 0.0f);
-					m_pRenderer->TranslateWorldMatrix(0.0f, 0.0f, pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
-
-					// Breathing animation
-					if(pVoxelCharacter->IsBreathingAnimationStarted())
-					{
-						float offsetAmount = 0.0f;
-						if(eyesBoneIndex != -1)
-						{
-							offsetAmount = pVoxelCharacter->GetBreathingAnimationOffsetForBone(eyesBoneIndex);
-						}
-
-						m_pRenderer->TranslateWorldMatrix(0.0f, offsetAmount, 0.0f);
-					}
-				}
-
-				// Translate by attached bone matrix
-				Matrix4x4 boneMatrix = pSkeleton->GetBoneMatrix(eyesBoneIndex);
-				vec3 boneScale = pVoxelCharacter->GetBoneScale();
-				m_pRenderer->ScaleWorldMatrix(boneScale.x, boneScale.y, boneScale.z);
-				m_pRenderer->MultiplyWorldMatrix(boneMatrix);
-				m_pRenderer->ScaleWorldMatrix(1.0f/boneScale.x, 1.0f/boneScale.y, 1.0f/boneScale.z);
-
-				// Rotation due to 3dsmax export affecting the bone rotations
-				m_pRenderer->RotateWorldMatrix(0.0f, 0.0f, -90.0f);
-
-				// Face looking direction
-				vec3 lForward = normalize(pVoxelCharacter->GetFaceLookingDirection());
-				vec3 lUp = vec3(0.0f, 1.0f, 0.0f);
-				vec3 lRight = normalize(cross(lUp, lForward));
-				lUp = normalize(cross(lForward, lRight));
-
-				float lMatrix[16] =
-				{
-					lRight.x, lRight.y, lRight.z, 0.0f,
-					lUp.x, lUp.y, lUp.z, 0.0f,
-					lForward.x, lForward.y, lForward.z, 0.0f,
-					0.0f, 0.0f, 0.0f, 1.0f
-				};
-				Matrix4x4 lookingMat;
-				lookingMat.SetValues(lMatrix);
-				m_pRenderer->MultiplyWorldMatrix(lookingMat);
-
-				int eyesMatrixIndex = pVoxelCharacter->GetEyesMatrixIndex();
-
-				m_pRenderer->SetRenderMode(RM_SOLID);
-
-				if(useScale)
-				{
-					// Scale for external matrix scale value
-					m_pRenderer->ScaleWorldMatrix(m_vpMatrices[eyesMatrixIndex]->m_scale, m_vpMatrices[eyesMatrixIndex]->m_scale, m_vpMatrices[eyesMatrixIndex]->m_scale);
-				}
-				if(useTranslate)
-				{
-					// Translate for external matrix offset value
-					m_pRenderer->TranslateWorldMatrix(m_vpMatrices[eyesMatrixIndex]->m_offsetX, m_vpMatrices[eyesMatrixIndex]->m_offsetY, m_vpMatrices[eyesMatrixIndex]->m_offsetZ);
-				}
-
-				m_pRenderer->TranslateWorldMatrix(eyeOffset.x, eyeOffset.y, eyeOffset.z);
-				pVoxelCharacter->RenderFaceTextures(true, m_renderWireFrame, transparency);
-			m_pRenderer->PopMatrix();
+			Matrix4x4 eyesMatrix = GetFaceMatrix(pSkeleton, pVoxelCharacter, eyesBoneIndex, pVoxelCharacter->GetEyesMatrixIndex(), pVoxelCharacter->GetEyesOffset(), useScale, useTranslate);
+			RenderFaceQuad(pVoxelCharacter, true, eyesMatrix, transparency, pFaceQuadBatch);
 		}
 	}
 
@@ -1974,73 +2341,9 @@ void QubicleBinary::RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCh
 	// Render mouth
 	{
 		int mouthBoneIndex = pVoxelCharacter->GetMouthBone();
-		vec3 mouthOffset = pVoxelCharacter->GetMouthOffset();
-
-		m_pRenderer->PushMatrix();
-			m_pRenderer->EnableMaterial(m_materialID);
-
-			if(useScale)
-			{
-				m_pRenderer->TranslateWorldMatrix(0.0f, 0.0f, -pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
-				m_pRenderer->RotateWorldMatrix(pVoxelCharacter->GetHeadAndUpperBodyLookRotation()*0.65f, 0.0f, 0.0f);
-				m_pRenderer->TranslateWorldMatrix(0.0f, 0.0f, pVoxelCharacter->GetHeadAndUpperBodyLookzTranslate());
-
-				// Breathing animation
-				if(pVoxelCharacter->IsBreathingAnimationStarted())
-				{
-					float offsetAmount = 0.0f;
-					if(mouthBoneIndex != -1)
-					{
-						offsetAmount = pVoxelCharacter->GetBreathingAnimationOffsetForBone(mouthBoneIndex);
-					}
-
-					m_pRenderer->TranslateWorldMatrix(0.0f, offsetAmount, 0.0f);
-				}
-			}
-
-			// Translate by attached bone matrix
-			Matrix4x4 boneMatrix = pSkeleton->GetBoneMatrix(mouthBoneIndex);
-			vec3 boneScale = pVoxelCharacter->GetBoneScale();
-			m_pRenderer->ScaleWorldMatrix(boneScale.x, boneScale.y, boneScale.z);
-			m_pRenderer->MultiplyWorldMatrix(boneMatrix);
-			m_pRenderer->ScaleWorldMatrix(1.0f/boneScale.x, 1.0f/boneScale.y, 1.0f/boneScale.z);
-
-			// Rotation due to 3dsmax export affecting the bone rotations
-			m_pRenderer->RotateWorldMatrix(0.0f, 0.0f, -90.0f);
-
-			// Face looking direction
-			vec3 lForward = normalize(pVoxelCharacter->GetFaceLookingDirection());
-			vec3 lUp = vec3(0.0f, 1.0f, 0.0f);
-			vec3 lRight = normalize(cross(lUp, lForward));
-			lUp = normalize(cross(lForward, lRight));
-
-			float lMatrix[16] =
-			{
-				lRight.x, lRight.y, lRight.z, 0.0f,
-				lUp.x, lUp.y, lUp.z, 0.0f,
-				lForward.x, lForward.y, lForward.z, 0.0f,
-				0.0f, 0.0f, 0.0f, 1.0f
-			};
-			Matrix4x4 lookingMat;
-			lookingMat.SetValues(lMatrix);
-			m_pRenderer->MultiplyWorldMatrix(lookingMat);
-
-			int mouthMatrixIndex = pVoxelCharacter->GetMouthMatrixIndex();
-
-			if(useScale)
-			{
-				// Scale for external matrix scale value
-				m_pRenderer->ScaleWorldMatrix(m_vpMatrices[mouthMatrixIndex]->m_scale, m_vpMatrices[mouthMatrixIndex]->m_scale, m_vpMatrices[mouthMatrixIndex]->m_scale);
-			}
-			if(useTranslate)
-			{
-				// Translate for external matrix offset value
-				m_pRenderer->TranslateWorldMatrix(m_vpMatrices[mouthMatrixIndex]->m_offsetX, m_vpMatrices[mouthMatrixIndex]->m_offsetY, m_vpMatrices[mouthMatrixIndex]->m_offsetZ);
-			}
 
-			m_pRenderer->TranslateWorldMatrix(mouthOffset.x, mouthOffset.y, mouthOffset.z);
-			pVoxelCharacter->RenderFaceTextures(false, m_renderWireFrame, transparency);
-		m_pRenderer->PopMatrix();
+		Matrix4x4 mouthMatrix = GetFaceMatrix(pSkeleton, pVoxelCharacter, mouthBoneIndex, pVoxelCharacter->GetMouthMatrixIndex(), pVoxelCharacter->GetMouthOffset(), useScale, useTranslate);
+		RenderFaceQuad(pVoxelCharacter, false, mouthMatrix, transparency, pFaceQuadBatch);
 	}
 }
 
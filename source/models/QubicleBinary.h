@@ -17,6 +17,7 @@
 #include "MS3DAnimator.h"
 
 class VoxelCharacter;
+class FaceQuadBatch;
 
 enum MergedSide
 {
@@ -37,6 +38,15 @@ bool IsMergedYPositive(int *merged, int x, int y, int z, int width, int height);
 bool IsMergedZNegative(int *merged, int x, int y, int z, int width, int height);
 bool IsMergedZPositive(int *merged, int x, int y, int z, int width, int height);
 
+// Number of meshes in each matrix LOD chain, full resolution followed by the 2x, 4x and 8x voxel merges
+const int QUBICLE_NUM_LODS = 4;
+
+// A LOD is picked once a merged voxel covers no more than this many pixels on screen
+const float QUBICLE_LOD_VOXEL_PIXELS = 3.0f;
+
+// How far past a switch size the screen size has to move before the LOD changes, stops popping at the boundary
+const float QUBICLE_LOD_HYSTERESIS = 0.2f;
+
 class QubicleMatrix
 {
 public:
@@ -66,6 +76,20 @@ public:
 
 	OpenGLTriangleMesh* m_pMesh;
 
+	// Downsampled meshes for LOD 1 upwards, NULL where the matrix is too small to merge any further
+	OpenGLTriangleMesh* m_pLODMeshes[QUBICLE_NUM_LODS - 1];
+
+	OpenGLTriangleMesh* GetLODMesh(int lod)
+	{
+		// Fall back to the finest mesh that was built
+		while(lod > 0 && m_pLODMeshes[lod - 1] == NULL)
+		{
+			lod--;
+		}
+
+		return (lod == 0) ? m_pMesh : m_pLODMeshes[lod - 1];
+	}
+
 	void GetColour(int x, int y, int z, float* r, float* g, float* b, float* a)
 	{
 		unsigned colour = m_pColour[x + m_matrixSizeX * (y + m_matrixSizeY * z)];
@@ -105,6 +129,14 @@ public:
 
 typedef vector<QubicleMatrix*> QubicleMatrixList;
 
+// The LOD each matrix was last drawn at. Binaries are shared between lots of objects
+// (every tile uses the same file), so objects keep their own and hand it over before rendering.
+class QubicleLODSelection
+{
+public:
+	vector<int> m_vMatrixLODs;
+};
+
 
 class QubicleBinary
 {
@@ -143,7 +175,12 @@ public:
 
 	void CreateMesh(bool lDoFaceMerging);
 	void RebuildMesh(bool lDoFaceMerging);
-	void UpdateMergedSide(int *merged, int matrixIndex, int blockx, int blocky, int blockz, int width, int height, vec3 *p1, vec3 *p2, vec3 *p3, vec3 *p4, int startX, int startY, int maxX, int maxY, bool positive, bool zFace, bool xFace, bool yFace);
+	void UpdateMergedSide(int *merged, QubicleMatrix* pMatrix, int blockx, int blocky, int blockz, int width, int height, vec3 *p1, vec3 *p2, vec3 *p3, vec3 *p4, int startX, int startY, int maxX, int maxY, bool positive, bool zFace, bool xFace, bool yFace, vec3 blockSize);
+
+	// LOD
+	void SetLODSelection(QubicleLODSelection* pLODSelection);
+	int GetNumTriangles(int lod);
+	static int SelectLOD(int currentLOD, float voxelScreenSize);
 
 	int GetNumMatrices();
 	QubicleMatrix* GetQubicleMatrix(int index);
@@ -151,6 +188,8 @@ public:
 	const char* GetMatrixName(int index);
 	float GetMatrixScale(int index);
 	vec3 GetMatrixOffset(int index);
+	Matrix4x4 GetMatrixLocalTransform(int index);
+	float GetBoundingRadius();
 
 	void SetupMatrixBones(MS3DAnimator* pSkeleton);
 	
@@ -174,9 +213,10 @@ public:
 
 	// Rendering
 	void Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour);
+	void RenderCached(int matrixIndex, const Matrix4x4& worldMatrix);
 	void RenderWithAnimator(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking);
 	void RenderSingleMatrix(MS3DAnimator** pSkeleton, VoxelCharacter* pVoxelCharacter, string matrixName, bool renderOutline, bool silhouette, Colour OutlineColour);
-	void RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale = true, bool useTranslate = true);
+	void RenderFace(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, bool transparency, bool useScale = true, bool useTranslate = true, FaceQuadBatch* pFaceQuadBatch = NULL);
 	void RenderPaperdoll(MS3DAnimator* pSkeleton_Left, MS3DAnimator* pSkeleton_Right, VoxelCharacter* pVoxelCharacter);
 	void RenderPortrait(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, string matrixName);
 
@@ -185,6 +225,13 @@ protected:
 
 private:
 	/* Private methods */
+	void GetColour(QubicleMatrix* pMatrix, int x, int y, int z, float* r, float* g, float* b, float* a);
+	void CreateMatrixMesh(QubicleMatrix* pMatrix, OpenGLTriangleMesh* pMesh, bool lDoFaceMerging, vec3 blockSize);
+	void CreateLODMeshes(QubicleMatrix* pMatrix, bool lDoFaceMerging);
+	void ClearLODMeshes(QubicleMatrix* pMatrix);
+	OpenGLTriangleMesh* GetMatrixRenderMesh(int matrixIndex);
+	Matrix4x4 GetFaceMatrix(MS3DAnimator* pSkeleton, VoxelCharacter* pVoxelCharacter, int boneIndex, int matrixIndex, vec3 offset, bool useScale, bool useTranslate);
+	void RenderFaceQuad(VoxelCharacter* pVoxelCharacter, bool eyes, Matrix4x4 faceMatrix, bool transparency, FaceQuadBatch* pFaceQuadBatch);
 
 public:
 	/* Public members */
@@ -229,4 +276,8 @@ private:
 
 	// Material
 	unsigned int m_materialID;
+
+	// LOD selection used when rendering, the binary's own unless an object has handed over theirs
+	QubicleLODSelection* m_pLODSelection;
+	QubicleLODSelection m_defaultLODSelection;
 };
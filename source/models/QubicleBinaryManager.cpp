@@ -12,20 +12,28 @@
 // ******************************************************************************
 
 #include "QubicleBinaryManager.h"
+#include "WeaponDefinition.h"
 
 
 QubicleBinaryManager::QubicleBinaryManager(Renderer* pRenderer)
 {
 	m_pRenderer = pRenderer;
+
+	m_pWeaponDefinitionRegistry = new WeaponDefinitionRegistry(m_pRenderer, this);
 }
 
 QubicleBinaryManager::~QubicleBinaryManager()
 {
 	ClearQubicleBinaryList();
+
+	delete m_pWeaponDefinitionRegistry;
 }
 
 void QubicleBinaryManager::ClearQubicleBinaryList()
 {
+	// The weapon definitions hold section models that point at these binaries
+	m_pWeaponDefinitionRegistry->ClearDefinitions();
+
 	for(unsigned int i = 0; i < m_vpQubicleBinaryList.size(); i++)
 	{
 		delete m_vpQubicleBinaryList[i];
@@ -61,4 +69,9 @@ QubicleBinary* QubicleBinaryManager::AddQubicleBinaryFile(const char* fileName)
 	m_vpQubicleBinaryList.push_back(pNewQubicleBinary);
 
 	return pNewQubicleBinary;
+}
+
+WeaponDefinitionRegistry* QubicleBinaryManager::GetWeaponDefinitionRegistry()
+{
+	return m_pWeaponDefinitionRegistry;
 }
\ No newline at end of file
@@ -16,6 +16,8 @@
 
 #include "QubicleBinary.h"
 
+class WeaponDefinitionRegistry;
+
 typedef vector<QubicleBinary*> QubicleBinaryList;
 
 
@@ -31,6 +33,9 @@ public:
 	QubicleBinary* GetQubicleBinaryFile(const char* fileName, bool refreshModel);
 	QubicleBinary* AddQubicleBinaryFile(const char* fileName);
 
+	// Shared weapon definitions, their section models use the qubicle binaries held here
+	WeaponDefinitionRegistry* GetWeaponDefinitionRegistry();
+
 protected:
 	/* Protected methods */
 
@@ -48,4 +53,6 @@ private:
 	Renderer* m_pRenderer;
 
 	QubicleBinaryList m_vpQubicleBinaryList;
+
+	WeaponDefinitionRegistry* m_pWeaponDefinitionRegistry;
 };
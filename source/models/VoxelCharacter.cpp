@@ -12,9 +12,11 @@
 // ******************************************************************************
 
 #include "VoxelCharacter.h"
+#include "FaceQuadBatch.h"
 
 #include "../utils/Interpolator.h"
 #include "../utils/Random.h"
+#include "../utils/FileUtils.h"
 
 #include <glm/detail/func_geometric.hpp>
 
@@ -47,6 +49,18 @@ void VoxelCharacter::Reset()
 
 	m_updateAnimator = true;
 
+	m_animationUpdateInterval = 1;
+	m_animationUpdateCounter = 0;
+	m_animationUpdateTime = 0.0f;
+	m_poseInterpolationStarted = false;
+	m_animationEvaluated = false;
+	m_tickInterpolationEnabled = false;
+	m_faceVisible = true;
+	m_culled = false;
+	m_paperdollAnimationEnabled = false;
+
+	m_appearanceVersion = 0;
+
 	m_renderRightWeapon = false;
 	m_renderLeftWeapon = false;
 
@@ -83,8 +97,7 @@ void VoxelCharacter::Reset()
 	// Facial expressions
 	m_numFacialExpressions = 0;
 	m_pFacialExpressions = NULL;
-	m_faceEyesTexture = -1;
-	m_faceMouthTexture = -1;	
+	m_faceAtlasTexture = -1;
 	m_eyesOffset = vec3(0.0f, 0.0f, 0.0f);
 	m_mouthOffset = vec3(0.0f, 0.0f, 0.0f);
 	m_currentFacialExpression = 0;
@@ -118,7 +131,6 @@ void VoxelCharacter::Reset()
 
 	// Wink animation
 	m_bWinkAnimationEnabled = false;
-	m_faceEyesWinkTexture = -1;
 	m_wink = false;
 	m_winkWaitTimer = 4.0f + GetRandomNumber(-2, 2, 2);
 	m_winkStayTime = 0.15f;
@@ -248,6 +260,8 @@ void VoxelCharacter::UnloadCharacter()
 // Rebuild
 void VoxelCharacter::RebuildVoxelModel(bool faceMerge)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->RebuildMesh(faceMerge);
 
 	if (m_pRightWeapon != NULL)
@@ -270,8 +284,6 @@ bool VoxelCharacter::LoadFaces(const char* characterType, const char *facesFileN
 	if(file.is_open())
 	{
 		string tempString;
-		int lTextureWidth, lTextureHeight, lTextureWidth2, lTextureHeight2;
-
 		float offsetX;
 		float offsetY;
 		float offsetZ;
@@ -287,9 +299,19 @@ bool VoxelCharacter::LoadFaces(const char* characterType, const char *facesFileN
 
 		file >> tempString >> m_winkTextureFilename;
 
+		// Every face frame for this character type, all eye colours included, is packed into one atlas that all characters of the type share.
+		// The frames are decoded on the streaming workers, the faces just don't show until the atlas is uploaded.
+		char facesFolder[128];
+		sprintf(facesFolder, "%s/%s/faces", charactersBaseFolder, characterType);
+		vector<string> faceFileNames = listFilesInDirectoryRecursive(facesFolder, ".tga");
+		if(m_pRenderer->LoadTextureAtlas(facesFolder, faceFileNames, &m_faceAtlasTexture) == false)
+		{
+			cout << "Failed to load face atlas: " << facesFolder << endl;
+		}
+
 		char winkFilename[128];
 		sprintf(winkFilename, "%s/%s/%s", charactersBaseFolder, characterType, m_winkTextureFilename.c_str());
-		m_pRenderer->LoadTexture(winkFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_faceEyesWinkTexture);
+		GetFaceAtlasRect(winkFilename, &m_faceEyesWinkRect);
 
 		file >> tempString >> m_eyesBoneName;
 		file >> tempString >> m_mouthBoneName;
@@ -306,16 +328,16 @@ bool VoxelCharacter::LoadFaces(const char* characterType, const char *facesFileN
 			file >> m_pFacialExpressions[i].m_facialExpressionName >> m_pFacialExpressions[i].m_eyesTextureFile >> m_pFacialExpressions[i].m_mouthTextureFile;
 
 			sprintf(eyesFilename, "%s/%s/%s", charactersBaseFolder, characterType, m_pFacialExpressions[i].m_eyesTextureFile.c_str());
-			m_pRenderer->LoadTexture(eyesFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_pFacialExpressions[i].m_eyeTexture);
+			GetFaceAtlasRect(eyesFilename, &m_pFacialExpressions[i].m_eyeRect);
 
 			sprintf(mouthFilename, "%s/%s/%s", charactersBaseFolder, characterType, m_pFacialExpressions[i].m_mouthTextureFile.c_str());
-			m_pRenderer->LoadTexture(mouthFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_pFacialExpressions[i].m_mouthTexture);
+			GetFaceAtlasRect(mouthFilename, &m_pFacialExpressions[i].m_mouthRect);
 		}
 
 		if(m_numFacialExpressions > 0)
 		{
-			m_faceEyesTexture = m_pFacialExpressions[0].m_eyeTexture;
-			m_faceMouthTexture = m_pFacialExpressions[0].m_mouthTexture;
+			m_faceEyesRect = m_pFacialExpressions[0].m_eyeRect;
+			m_faceMouthRect = m_pFacialExpressions[0].m_mouthRect;
 		}
 
 		file >> tempString >> m_numTalkingMouths;
@@ -327,7 +349,7 @@ bool VoxelCharacter::LoadFaces(const char* characterType, const char *facesFileN
 			file >> m_pTalkingAnimations[i].m_talkingAnimationTextureFile;
 
 			sprintf(talkingMouthFilename, "%s/%s/%s", charactersBaseFolder, characterType, m_pTalkingAnimations[i].m_talkingAnimationTextureFile.c_str());
-			m_pRenderer->LoadTexture(talkingMouthFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_pTalkingAnimations[i].m_talkingAnimationTexture);
+			GetFaceAtlasRect(talkingMouthFilename, &m_pTalkingAnimations[i].m_talkingAnimationRect);
 		}
 
 		file.close();
@@ -404,8 +426,9 @@ void VoxelCharacter::SetupFacesBones()
 
 void VoxelCharacter::ModifyEyesTextures(const char *charactersBaseFolder, const char* characterType, const char* eyeTextureFolder)
 {
-	int lTextureWidth, lTextureHeight, lTextureWidth2, lTextureHeight2;
+	m_appearanceVersion++;
 
+	// The eye colours all live in the face atlas, so this only changes which rects we use
 	char winkFilename[128];
 
 	// For saving to the faces file we need a stripped down version of the full path
@@ -414,7 +437,7 @@ void VoxelCharacter::ModifyEyesTextures(const char *charactersBaseFolder, const
 
 	// Generate full path for texture loading
 	sprintf(winkFilename, "%s/%s/faces/%s/face_eyes_wink.tga", charactersBaseFolder, characterType, eyeTextureFolder);
-	m_pRenderer->LoadTexture(winkFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_faceEyesWinkTexture);
+	GetFaceAtlasRect(winkFilename, &m_faceEyesWinkRect);
 
 	for(int i = 0; i < m_numFacialExpressions; i++)
 	{
@@ -430,11 +453,28 @@ void VoxelCharacter::ModifyEyesTextures(const char *charactersBaseFolder, const
 
 		// Generate full path for texture loading
 		sprintf(eyesFilename, "%s/%s/faces/%s/%s", charactersBaseFolder, characterType, eyeTextureFolder, fileWithoutExtension.c_str());
-		m_pRenderer->LoadTexture(eyesFilename, &lTextureWidth, &lTextureHeight, &lTextureWidth2, &lTextureHeight2, &m_pFacialExpressions[i].m_eyeTexture);
+		GetFaceAtlasRect(eyesFilename, &m_pFacialExpressions[i].m_eyeRect);
+	}
+
+	m_faceEyesRect = m_wink ? m_faceEyesWinkRect : m_pFacialExpressions[m_currentFacialExpression].m_eyeRect;
+}
+
+bool VoxelCharacter::GetFaceAtlasRect(const char* faceFilename, TextureAtlasRect* pRect)
+{
+	if(m_pRenderer->GetTextureAtlasRect(m_faceAtlasTexture, faceFilename, pRect) == false)
+	{
+		// Not in the atlas, fall back to the whole of it rather than leaving the rect undefined
+		cout << "Face texture missing from atlas: " << faceFilename << endl;
+
+		pRect->m_u0 = 0.0f;
+		pRect->m_v0 = 0.0f;
+		pRect->m_u1 = 1.0f;
+		pRect->m_v1 = 1.0f;
+
+		return false;
 	}
 
-	m_faceEyesTexture = m_pFacialExpressions[m_currentFacialExpression].m_eyeTexture;
-	m_faceMouthTexture = m_pFacialExpressions[m_currentFacialExpression].m_mouthTexture;
+	return true;
 }
 
 // Character file
@@ -576,6 +616,8 @@ float VoxelCharacter::GetHeadAndUpperBodyLookzTranslate()
 
 void VoxelCharacter::SetCharacterMatrixRenderParams(const char* matrixName, float scale, float xOffset, float yOffset, float zOffset)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->SetScaleAndOffsetForMatrix(matrixName, scale, xOffset, yOffset, zOffset);
 }
 
@@ -591,6 +633,8 @@ vec3 VoxelCharacter::GetBoneMatrixRenderOffset(const char* matrixName)
 
 void VoxelCharacter::LoadRightWeapon(const char *weaponFilename)
 {
+	m_appearanceVersion++;
+
 	if(m_loaded)
 	{
 		m_pRightWeapon->SetVoxelCharacterParent(this);
@@ -604,6 +648,8 @@ void VoxelCharacter::LoadRightWeapon(const char *weaponFilename)
 
 void VoxelCharacter::LoadLeftWeapon(const char *weaponFilename)
 {
+	m_appearanceVersion++;
+
 	if(m_loaded)
 	{
 		m_pLeftWeapon->SetVoxelCharacterParent(this);
@@ -627,11 +673,15 @@ VoxelWeapon* VoxelCharacter::GetLeftWeapon()
 
 void VoxelCharacter::UnloadRightWeapon()
 {
+	m_appearanceVersion++;
+
 	m_rightWeaponLoaded = false;
 }
 
 void VoxelCharacter::UnloadLeftWeapon()
 {
+	m_appearanceVersion++;
+
 	m_leftWeaponLoaded = false;
 }
 
@@ -742,6 +792,8 @@ void VoxelCharacter::SetBoneScale(float scale)
 // Rendering modes
 void VoxelCharacter::SetWireFrameRender(bool wireframe)
 {
+	m_appearanceVersion++;
+
 	if(m_pVoxelModel != NULL)
 	{
 		m_pVoxelModel->SetWireFrameRender(wireframe);
@@ -766,11 +818,15 @@ void VoxelCharacter::SetWireFrameRender(bool wireframe)
 
 void VoxelCharacter::SetRenderRightWeapon(bool render)
 {
+	m_appearanceVersion++;
+
 	m_renderRightWeapon = render;
 }
 
 void VoxelCharacter::SetRenderLeftWeapon(bool render)
 {
+	m_appearanceVersion++;
+
 	m_renderLeftWeapon = render;
 }
 
@@ -783,6 +839,7 @@ void VoxelCharacter::SetMeshAlpha(float alpha, bool force)
 	}
 
 	m_characterAlpha = alpha;
+	m_appearanceVersion++;
 
 	if(m_pVoxelModel)
 	{
@@ -808,6 +865,8 @@ void VoxelCharacter::SetMeshAlpha(float alpha, bool force)
 
 void VoxelCharacter::SetMeshSingleColour(float r, float g, float b)
 {
+	m_appearanceVersion++;
+
 	if(m_pVoxelModel)
 	{
 		m_pVoxelModel->SetMeshSingleColour(r, g, b);
@@ -832,6 +891,8 @@ void VoxelCharacter::SetMeshSingleColour(float r, float g, float b)
 
 void VoxelCharacter::ConvertMeshColour(float r, float g, float b, float matchR, float matchG, float matchB)
 {
+	m_appearanceVersion++;
+
 	if (m_pVoxelModel)
 	{
 		m_pVoxelModel->ConvertMeshColour(r, g, b, matchR, matchG, matchB);
@@ -857,18 +918,18 @@ void VoxelCharacter::StartBreathAnimation()
 {
 	m_bBreathingAnimationStarted = true;
 
-	FloatInterpolation* lBodyYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.35f, 1.5f, 100.0f);
-	FloatInterpolation* lBodyYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.35f, 0.175f, 0.0f);
-	FloatInterpolation* lBodyYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.0f, 1.5f, -100.0f);
-	FloatInterpolation* lBodyYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.0f, 0.05f, 0.0f, NULL, _BreathAnimationFinished, this);
+	InterpolationHandle lBodyYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.35f, 1.5f, 100.0f);
+	InterpolationHandle lBodyYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.35f, 0.175f, 0.0f);
+	InterpolationHandle lBodyYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.35f, 0.0f, 1.5f, -100.0f);
+	InterpolationHandle lBodyYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingBodyYOffset, 0.0f, 0.0f, 0.05f, 0.0f, INVALID_INTERPOLATION, _BreathAnimationFinished, this);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lBodyYInterpolation1, lBodyYInterpolation2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lBodyYInterpolation2, lBodyYInterpolation3);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lBodyYInterpolation3, lBodyYInterpolation4);
 
-	FloatInterpolation* lHandsYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.0f, 0.5f, 0.0f);
-	FloatInterpolation* lHandsYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.75f, 1.25f, 100.0f);
-	FloatInterpolation* lHandsYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.75f, 0.125f, 0.0f);
-	FloatInterpolation* lHandsYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.0f, 1.5f, -100.0f);
+	InterpolationHandle lHandsYInterpolation1 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.0f, 0.5f, 0.0f);
+	InterpolationHandle lHandsYInterpolation2 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.0f, 0.75f, 1.25f, 100.0f);
+	InterpolationHandle lHandsYInterpolation3 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.75f, 0.125f, 0.0f);
+	InterpolationHandle lHandsYInterpolation4 = Interpolator::GetInstance()->CreateFloatInterpolation(&m_breathingHandsYOffset, 0.75f, 0.0f, 1.5f, -100.0f);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lHandsYInterpolation1, lHandsYInterpolation2);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lHandsYInterpolation2, lHandsYInterpolation3);
 	Interpolator::GetInstance()->LinkFloatInterpolation(lHandsYInterpolation3, lHandsYInterpolation4);
@@ -933,11 +994,15 @@ vec3 VoxelCharacter::GetMouthOffset()
 
 void VoxelCharacter::SetEyesOffset(vec3 offset)
 {
+	m_appearanceVersion++;
+
 	m_eyesOffset = offset;
 }
 
 void VoxelCharacter::SetMouthOffset(vec3 offset)
 {
+	m_appearanceVersion++;
+
 	m_mouthOffset = offset;
 }
 
@@ -959,14 +1024,16 @@ void VoxelCharacter::UpdateWinkAnimation(float dt)
 	{
 		m_winkWaitTimer = 4.0f + GetRandomNumber(-2, 2, 2);
 		m_wink = false;
+		m_appearanceVersion++;
 
 		// Return eyes back to whatever they were before the wink
-		m_faceEyesTexture = m_pFacialExpressions[m_currentFacialExpression].m_eyeTexture;
+		m_faceEyesRect = m_pFacialExpressions[m_currentFacialExpression].m_eyeRect;
 	}
-	else if(m_winkWaitTimer <= m_winkStayTime)
+	else if(m_winkWaitTimer <= m_winkStayTime && m_wink == false)
 	{
 		m_wink = true;
-		m_faceEyesTexture = m_faceEyesWinkTexture;
+		m_faceEyesRect = m_faceEyesWinkRect;
+		m_appearanceVersion++;
 	}
 }
 
@@ -979,7 +1046,8 @@ void VoxelCharacter::SetTalkingAnimationEnabled(bool enable)
 	{
 		if(m_bTalkingAnimationEnabled == false)
 		{
-			m_faceMouthTexture = m_pFacialExpressions[m_currentFacialExpression].m_mouthTexture;
+			m_faceMouthRect = m_pFacialExpressions[m_currentFacialExpression].m_mouthRect;
+			m_appearanceVersion++;
 		}
 	}
 }
@@ -1036,7 +1104,8 @@ void VoxelCharacter::UpdateTalkingAnimation(float dt)
 			if(GetRandomNumber(0, 100, 1) > 50)
 			{
 				// Revert back to the face pose mouth
-				m_faceMouthTexture = m_pFacialExpressions[m_currentFacialExpression].m_mouthTexture;
+				m_faceMouthRect = m_pFacialExpressions[m_currentFacialExpression].m_mouthRect;
+				m_appearanceVersion++;
 			}
 			else
 			{
@@ -1045,7 +1114,8 @@ void VoxelCharacter::UpdateTalkingAnimation(float dt)
 		}
 		else
 		{
-			m_faceMouthTexture = m_pTalkingAnimations[m_currentTalkingTexture].m_talkingAnimationTexture;
+			m_faceMouthRect = m_pTalkingAnimations[m_currentTalkingTexture].m_talkingAnimationRect;
+			m_appearanceVersion++;
 
 			float randomTimeAddtion = GetRandomNumber(-10, 50, 2) * 0.00225f;
 			m_talkingWaitTimer = m_talkingWaitTime + randomTimeAddtion;
@@ -1087,8 +1157,9 @@ void VoxelCharacter::PlayFacialExpression(int facialAnimationIndex)
 		{
 			m_currentFacialExpression = facialAnimationIndex;
 
-			m_faceEyesTexture = m_pFacialExpressions[m_currentFacialExpression].m_eyeTexture;
-			m_faceMouthTexture = m_pFacialExpressions[m_currentFacialExpression].m_mouthTexture;
+			m_faceEyesRect = m_pFacialExpressions[m_currentFacialExpression].m_eyeRect;
+			m_faceMouthRect = m_pFacialExpressions[m_currentFacialExpression].m_mouthRect;
+			m_appearanceVersion++;
 		}
 	}
 }
@@ -1541,6 +1612,8 @@ Joint* VoxelCharacter::GetJoint(const char* jointName)
 
 void VoxelCharacter::PlayAnimationOnPaperDoll(const char *lAnimationName, bool left)
 {
+	m_appearanceVersion++;
+
 	if (left)
 	{
 		m_pCharacterAnimatorPaperdoll_Left->PlayAnimation(lAnimationName);
@@ -1565,21 +1638,29 @@ const char* VoxelCharacter::GetModelMatrixName(int index)
 // Swapping and adding new matrices
 void VoxelCharacter::SwapBodyPart(const char* bodyPartName, QubicleMatrix* pMatrix, bool copyMatrixParams)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->SwapMatrix(bodyPartName, pMatrix, copyMatrixParams);
 }
 
 void VoxelCharacter::AddQubicleMatrix(QubicleMatrix* pNewMatrix, bool copyMatrixParams)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->AddQubicleMatrix(pNewMatrix, copyMatrixParams);
 }
 
 void VoxelCharacter::RemoveQubicleMatrix(const char* matrixName)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->RemoveQubicleMatrix(matrixName);
 }
 
 void VoxelCharacter::SetQubicleMatrixRender(const char* matrixName, bool render)
 {
+	m_appearanceVersion++;
+
 	m_pVoxelModel->SetQubicleMatrixRender(matrixName, render);
 }
 
@@ -1589,6 +1670,106 @@ string VoxelCharacter::GetSubSelectionName(int pickingId)
 }
 
 // Update
+// Crowd update level of detail
+void VoxelCharacter::SetAnimationUpdateInterval(int interval, int phase)
+{
+	if(interval < 1)
+	{
+		interval = 1;
+	}
+
+	if(interval != m_animationUpdateInterval)
+	{
+		if(interval < m_animationUpdateInterval || m_animationEvaluated == false)
+		{
+			// Becoming more important, or never animated yet, so catch up on the next update
+			m_animationUpdateCounter = interval - 1;
+		}
+		else
+		{
+			// Stagger the characters sharing an interval, so they don't all evaluate on the same frame
+			m_animationUpdateCounter = phase % interval;
+		}
+
+		m_animationUpdateInterval = interval;
+		m_poseInterpolationStarted = false;
+	}
+}
+
+int VoxelCharacter::GetAnimationUpdateInterval()
+{
+	return m_animationUpdateInterval;
+}
+
+void VoxelCharacter::SetFaceVisible(bool visible)
+{
+	m_faceVisible = visible;
+}
+
+bool VoxelCharacter::IsFaceVisible()
+{
+	return m_faceVisible;
+}
+
+void VoxelCharacter::SetCulled(bool culled)
+{
+	m_culled = culled;
+}
+
+bool VoxelCharacter::IsCulled()
+{
+	return m_culled;
+}
+
+void VoxelCharacter::SetPaperdollAnimationEnabled(bool enable)
+{
+	m_paperdollAnimationEnabled = enable;
+}
+
+bool VoxelCharacter::IsPaperdollAnimationEnabled()
+{
+	return m_paperdollAnimationEnabled;
+}
+
+// Fixed timestep interpolation
+void VoxelCharacter::SetTickInterpolationEnabled(bool enable)
+{
+	m_tickInterpolationEnabled = enable;
+}
+
+bool VoxelCharacter::IsTickInterpolationEnabled()
+{
+	return m_tickInterpolationEnabled;
+}
+
+void VoxelCharacter::InterpolateTickPose(float alpha)
+{
+	// Characters on a crowd update interval already ease between their own poses
+	if(m_loaded == false || m_tickInterpolationEnabled == false || m_updateAnimator == false || m_animationUpdateInterval > 1)
+	{
+		return;
+	}
+
+	for(int i = 0; i < AnimationSections_NUMSECTIONS; i++)
+	{
+		if(m_pCharacterAnimator[i] != NULL)
+		{
+			m_pCharacterAnimator[i]->InterpolatePose(alpha);
+		}
+	}
+}
+
+// Appearance
+unsigned int VoxelCharacter::GetAppearanceVersion()
+{
+	return m_appearanceVersion;
+}
+
+void VoxelCharacter::InvalidateAppearance()
+{
+	m_appearanceVersion++;
+}
+
 void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS])
 {
 	if(m_loaded == false)
@@ -1596,6 +1777,20 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 		return;
 	}
 
+	// Time is gathered up between animation updates, so a character on a longer interval never loses any
+	m_animationUpdateTime += dt;
+	m_animationUpdateCounter++;
+
+	bool evaluateAnimation = (m_animationUpdateCounter >= m_animationUpdateInterval);
+	bool interpolatePose = (m_animationUpdateInterval > 1 && m_animationEvaluated);
+	float animationDt = m_animationUpdateTime;
+	if(evaluateAnimation)
+	{
+		m_animationUpdateCounter = 0;
+		m_animationUpdateTime = 0.0f;
+		m_animationEvaluated = true;
+	}
+
 	// Update skeleton animation
 	for(int i = 0; i < AnimationSections_NUMSECTIONS; i++)
 	{
@@ -1603,26 +1798,50 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 		{
 			if(m_updateAnimator)
 			{
-				m_pCharacterAnimator[i]->Update(dt * animationSpeed[i]);
+				if(interpolatePose == false)
+				{
+					if(evaluateAnimation)
+					{
+						if(m_tickInterpolationEnabled)
+						{
+							m_pCharacterAnimator[i]->UpdateTick(animationDt * animationSpeed[i]);
+						}
+						else
+						{
+							m_pCharacterAnimator[i]->Update(animationDt * animationSpeed[i]);
+						}
+					}
+				}
+				else
+				{
+					// Evaluate a new pose every interval and ease towards it on the frames in between
+					if(evaluateAnimation)
+					{
+						m_pCharacterAnimator[i]->UpdateInterpolated(animationDt * animationSpeed[i]);
+					}
+
+					if(evaluateAnimation || m_poseInterpolationStarted)
+					{
+						m_pCharacterAnimator[i]->InterpolatePose((float)(m_animationUpdateCounter + 1) / (float)m_animationUpdateInterval);
+					}
+				}
 			}
 		}
 	}
 
+	if(evaluateAnimation && interpolatePose)
+	{
+		m_poseInterpolationStarted = true;
+	}
+
 	// Update paperdoll animator
-	if(m_updateAnimator)
+	if(m_updateAnimator && m_paperdollAnimationEnabled)
 	{
-		if (m_pCharacterAnimatorPaperdoll_Left != NULL)
-		{
-			m_pCharacterAnimatorPaperdoll_Left->Update(dt);
-		}
-		if (m_pCharacterAnimatorPaperdoll_Right != NULL)
-		{
-			m_pCharacterAnimatorPaperdoll_Right->Update(dt);
-		}
+		UpdatePaperdoll(dt);
 	}
 
 	// Breathing animations
-	if(m_bBreathingAnimationEnabled && m_bBreathingAnimationStarted == false)
+	if(evaluateAnimation && m_bBreathingAnimationEnabled && m_bBreathingAnimationStarted == false)
 	{
 		if(m_breathingAnimationInitialWaitTime <= 0.0f) // So we have an initial delay, do all characters are not in sync
 		{
@@ -1630,12 +1849,12 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 		}
 		else
 		{
-			m_breathingAnimationInitialWaitTime -= dt;
+			m_breathingAnimationInitialWaitTime -= animationDt;
 		}
 	}
 
-	// Facial animation
-	if(m_loadedFaces)
+	// Facial animation, suspended while nobody can see the face
+	if(m_loadedFaces && m_faceVisible)
 	{
 		if(m_bWinkAnimationEnabled || m_wink == true)
 		{
@@ -1649,19 +1868,22 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 	}
 
 	// Face looking
-	if(glm::distance(m_faceLookingDirection, m_faceTargetDirection) <= 0.01f)
+	if(evaluateAnimation)
 	{
-		if(m_bRandomLookDirectionEnabled)
+		if(glm::distance(m_faceLookingDirection, m_faceTargetDirection) <= 0.01f)
 		{
-			m_faceTargetDirection = vec3(GetRandomNumber(-1, 1, 2)*0.65f, GetRandomNumber(-1, 1, 2)*0.175f, GetRandomNumber(0, 3, 2)+0.35f);
-			m_faceTargetDirection = normalize(m_faceTargetDirection);
+			if(m_bRandomLookDirectionEnabled)
+			{
+				m_faceTargetDirection = vec3(GetRandomNumber(-1, 1, 2)*0.65f, GetRandomNumber(-1, 1, 2)*0.175f, GetRandomNumber(0, 3, 2)+0.35f);
+				m_faceTargetDirection = normalize(m_faceTargetDirection);
+			}
+		}
+		else
+		{
+			vec3 toTarget = m_faceTargetDirection - m_faceLookingDirection;
+			m_faceLookingDirection += (toTarget * animationDt) * m_faceLookToTargetSpeedMultiplier;
+			m_faceLookingDirection = normalize(m_faceLookingDirection);
 		}
-	}
-	else
-	{
-		vec3 toTarget = m_faceTargetDirection - m_faceLookingDirection;
-		m_faceLookingDirection += (toTarget * dt) * m_faceLookToTargetSpeedMultiplier;
-		m_faceLookingDirection = normalize(m_faceLookingDirection);
 	}
 
 	// Animated weapons
@@ -1681,6 +1903,21 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 		}
 	}
 
+	// Weapon trails are only seen on screen, a culled character drops them and starts fresh when it comes back into view
+	if (m_culled)
+	{
+		if (m_pLeftWeapon != NULL && m_pLeftWeapon->IsWeaponTrailsActive())
+		{
+			m_pLeftWeapon->StopWeaponTrails();
+		}
+		if (m_pRightWeapon != NULL && m_pRightWeapon->IsWeaponTrailsActive())
+		{
+			m_pRightWeapon->StopWeaponTrails();
+		}
+
+		return;
+	}
+
 	if (m_pLeftWeapon != NULL)
 	{
 		m_pLeftWeapon->CreateWeaponTrailPoint();
@@ -1717,6 +1954,28 @@ void VoxelCharacter::Update(float dt, float animationSpeed[AnimationSections_NUM
 	}
 }
 
+void VoxelCharacter::UpdatePaperdoll(float dt)
+{
+	if (m_pCharacterAnimatorPaperdoll_Left != NULL)
+	{
+		m_pCharacterAnimatorPaperdoll_Left->Update(dt);
+	}
+	if (m_pCharacterAnimatorPaperdoll_Right != NULL)
+	{
+		m_pCharacterAnimatorPaperdoll_Right->Update(dt);
+	}
+
+	m_appearanceVersion++;
+}
+
+bool VoxelCharacter::IsPaperdollAnimating()
+{
+	bool leftAnimating = (m_pCharacterAnimatorPaperdoll_Left != NULL && m_pCharacterAnimatorPaperdoll_Left->HasAnimationFinished() == false);
+	bool rightAnimating = (m_pCharacterAnimatorPaperdoll_Right != NULL && m_pCharacterAnimatorPaperdoll_Right->HasAnimationFinished() == false);
+
+	return leftAnimating || rightAnimating;
+}
+
 void VoxelCharacter::SetWeaponTrailsOriginMatrix(float dt, Matrix4x4 originMatrix)
 {
 	if(m_pLeftWeapon != NULL)
@@ -1774,7 +2033,7 @@ void VoxelCharacter::RenderBones()
 	}
 }
 
-void VoxelCharacter::RenderFace()
+void VoxelCharacter::RenderFace(FaceQuadBatch* pFaceQuadBatch)
 {
 	if(m_loadedFaces == false)
 	{
@@ -1785,7 +2044,7 @@ void VoxelCharacter::RenderFace()
 	{
 		m_pRenderer->PushMatrix();
 			m_pRenderer->ScaleWorldMatrix(m_characterScale, m_characterScale, m_characterScale);
-			m_pVoxelModel->RenderFace(m_pCharacterAnimator[AnimationSections_Head_Body], this, true);			
+			m_pVoxelModel->RenderFace(m_pCharacterAnimator[AnimationSections_Head_Body], this, true, true, true, pFaceQuadBatch);
 		m_pRenderer->PopMatrix();
 	}
 }
@@ -1830,13 +2089,13 @@ void VoxelCharacter::RenderFaceTextures(bool eyesTexture, bool wireframe, bool t
 		return;
 	}
 
-	if(m_faceEyesTexture == -1 || m_faceMouthTexture == -1)
+	if(m_loadedFaces == false || m_faceAtlasTexture == -1)
 	{
 		return;
 	}
 
-	float texture_w = 1.0f;
-	float texture_h = 1.0f;
+	// Every face frame is a rect in the same atlas, so this texture stays bound across expressions and characters of the same type
+	TextureAtlasRect rect = eyesTexture ? m_faceEyesRect : m_faceMouthRect;
 
 	float width = 1.0f;
 	float height = 1.0f;
@@ -1854,9 +2113,8 @@ void VoxelCharacter::RenderFaceTextures(bool eyesTexture, bool wireframe, bool t
 
 	m_pRenderer->PushMatrix();
 		
-		glActiveTextureARB(GL_TEXTURE0_ARB);
-		glDisable(GL_TEXTURE_2D);
-		glBindTexture(GL_TEXTURE_2D, 0);
+		m_pRenderer->SetActiveTextureUnit(0);
+		m_pRenderer->DisableTexture();
 
 		if(transparency)
 		{
@@ -1877,14 +2135,7 @@ void VoxelCharacter::RenderFaceTextures(bool eyesTexture, bool wireframe, bool t
 			m_pRenderer->SetRenderMode(RM_TEXTURED);
 		}
 		
-		if(eyesTexture)
-		{
-			m_pRenderer->BindTexture(m_faceEyesTexture);
-		}
-		else
-		{
-			m_pRenderer->BindTexture(m_faceMouthTexture);
-		}
+		m_pRenderer->BindTexture(m_faceAtlasTexture);
 
 		if(transparency)
 		{
@@ -1899,16 +2150,16 @@ void VoxelCharacter::RenderFaceTextures(bool eyesTexture, bool wireframe, bool t
 
 		m_pRenderer->EnableImmediateMode(IM_QUADS);
 			//m_pRenderer->ImmediateNormal(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, texture_h);
+			m_pRenderer->ImmediateTextureCoordinate(rect.m_u0, rect.m_v1);
 			m_pRenderer->ImmediateVertex(0.0f, 0.0f, 0.0f);
 			//m_pRenderer->ImmediateNormal(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(texture_w, texture_h);
+			m_pRenderer->ImmediateTextureCoordinate(rect.m_u1, rect.m_v1);
 			m_pRenderer->ImmediateVertex(width, 0.0f, 0.0f);
 			//m_pRenderer->ImmediateNormal(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(texture_w, 0.0f);
+			m_pRenderer->ImmediateTextureCoordinate(rect.m_u1, rect.m_v0);
 			m_pRenderer->ImmediateVertex(width, height, 0.0f);
 			//m_pRenderer->ImmediateNormal(0.0f, 0.0f, 1.0f);
-			m_pRenderer->ImmediateTextureCoordinate(0.0f, 0.0f);
+			m_pRenderer->ImmediateTextureCoordinate(rect.m_u0, rect.m_v0);
 			m_pRenderer->ImmediateVertex(0.0f, height, 0.0f);
 		m_pRenderer->DisableImmediateMode();
 		m_pRenderer->DisableTexture();
@@ -1923,6 +2174,28 @@ void VoxelCharacter::RenderFaceTextures(bool eyesTexture, bool wireframe, bool t
 	m_pRenderer->PopMatrix();
 }
 
+void VoxelCharacter::AddFaceQuad(FaceQuadBatch* pFaceQuadBatch, bool eyesTexture, Matrix4x4 worldMatrix, bool transparency)
+{
+	if(m_pCharacterModel == NULL || m_pCharacterAnimator == NULL)
+	{
+		return;
+	}
+
+	if(m_loadedFaces == false || m_faceAtlasTexture == -1)
+	{
+		return;
+	}
+
+	if(eyesTexture)
+	{
+		pFaceQuadBatch->AddQuad(m_faceAtlasTexture, worldMatrix, m_eyesTextureWidth, m_eyesTextureHeight, m_faceEyesRect, transparency ? m_characterAlpha : 1.0f);
+	}
+	else
+	{
+		pFaceQuadBatch->AddQuad(m_faceAtlasTexture, worldMatrix, m_mouthTextureWidth, m_mouthTextureHeight, m_faceMouthRect, transparency ? m_characterAlpha : 1.0f);
+	}
+}
+
 void VoxelCharacter::RenderWeapons(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour)
 {
 	if(m_pLeftWeapon != NULL)
@@ -23,18 +23,19 @@ typedef struct FacialExpression
 	string m_facialExpressionName;
 	string m_eyesTextureFile;
 	string m_mouthTextureFile;
-	unsigned int m_eyeTexture;
-	unsigned int m_mouthTexture;
+	TextureAtlasRect m_eyeRect;
+	TextureAtlasRect m_mouthRect;
 } FacialExpression;
 
 // Talking animation
 typedef struct TalkingAnimation
 {
 	string m_talkingAnimationTextureFile;
-	unsigned int m_talkingAnimationTexture;
+	TextureAtlasRect m_talkingAnimationRect;
 } TalkingAnimation;
 
 class VoxelWeapon;
+class FaceQuadBatch;
 
 enum AnimationSections
 {
@@ -67,6 +68,7 @@ public:
 	bool SaveFaces(const char *facesFileName);
 	void SetupFacesBones();
 	void ModifyEyesTextures(const char *charactersBaseFolder, const char* characterType, const char* eyeTextureFolder);
+	bool GetFaceAtlasRect(const char* faceFilename, TextureAtlasRect* pRect);
 
 	// Character file
 	void LoadCharacterFile(const char* characterFilename);
@@ -214,17 +216,39 @@ public:
 	// Sub selection of individual body parts
 	string GetSubSelectionName(int pickingId);
 
+	// Crowd update level of detail
+	void SetAnimationUpdateInterval(int interval, int phase);
+	int GetAnimationUpdateInterval();
+	void SetFaceVisible(bool visible);
+	bool IsFaceVisible();
+	void SetCulled(bool culled);
+	bool IsCulled();
+	void SetPaperdollAnimationEnabled(bool enable);
+	bool IsPaperdollAnimationEnabled();
+
+	// Fixed timestep interpolation, the skeleton is rendered between the poses of the last two updates
+	void SetTickInterpolationEnabled(bool enable);
+	bool IsTickInterpolationEnabled();
+	void InterpolateTickPose(float alpha);
+
+	// Appearance, changes whenever anything a portrait or paperdoll shows has changed
+	unsigned int GetAppearanceVersion();
+	void InvalidateAppearance();
+
 	// Update
 	void Update(float dt, float animationSpeed[AnimationSections_NUMSECTIONS]);
+	void UpdatePaperdoll(float dt);
+	bool IsPaperdollAnimating();
 	void SetWeaponTrailsOriginMatrix(float dt, Matrix4x4 originMatrix);
 
 	// Rendering
 	void Render(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour, bool subSelectionNamePicking);
 	void RenderSubSelection(string subSelection, bool renderOutline, bool silhouette, Colour OutlineColour);
 	void RenderBones();
-	void RenderFace();
+	void RenderFace(FaceQuadBatch* pFaceQuadBatch);
 	void RenderFacingDebug();
 	void RenderFaceTextures(bool eyesTexture, bool wireframe, bool transparency);
+	void AddFaceQuad(FaceQuadBatch* pFaceQuadBatch, bool eyesTexture, Matrix4x4 worldMatrix, bool transparency);
 	void RenderWeapons(bool renderOutline, bool reflection, bool silhouette, Colour OutlineColour);
 	void RenderWeaponTrails();
 	void RenderPaperdoll();
@@ -259,6 +283,24 @@ private:
 	// FLag for updating the animator
 	bool m_updateAnimator;
 
+	// Crowd update level of detail, distant characters only evaluate their animation every few frames
+	int m_animationUpdateInterval;
+	int m_animationUpdateCounter;
+	float m_animationUpdateTime;
+	bool m_poseInterpolationStarted;
+	bool m_animationEvaluated;
+	bool m_faceVisible;
+	bool m_culled;
+
+	// Fixed timestep interpolation
+	bool m_tickInterpolationEnabled;
+
+	// The paperdoll animators are only updated while a paperdoll view is showing them
+	bool m_paperdollAnimationEnabled;
+
+	// Bumped by equipment, colour, expression and paperdoll animation changes, so cached portraits know to re-render
+	unsigned int m_appearanceVersion;
+
 	// Flags to control weapon rendering
 	bool m_renderRightWeapon;
 	bool m_renderLeftWeapon;
@@ -288,8 +330,9 @@ private:
 	// Facial expression	
 	int m_numFacialExpressions;
 	FacialExpression *m_pFacialExpressions;
-	unsigned int m_faceEyesTexture;
-	unsigned int m_faceMouthTexture;
+	unsigned int m_faceAtlasTexture;
+	TextureAtlasRect m_faceEyesRect;
+	TextureAtlasRect m_faceMouthRect;
 	vec3 m_eyesOffset;
 	vec3 m_mouthOffset;
 	int m_currentFacialExpression;
@@ -320,7 +363,7 @@ private:
 	// Wink animation
 	bool m_bWinkAnimationEnabled;
 	string m_winkTextureFilename;
-	unsigned int m_faceEyesWinkTexture;
+	TextureAtlasRect m_faceEyesWinkRect;
 	bool m_wink;
 	float m_winkWaitTimer;
 	float m_winkStayTime;
@@ -0,0 +1,299 @@
+// ******************************************************************************
+// Filename:    VoxelCharacterCrowd.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "VoxelCharacterCrowd.h"
+
+#include <algorithm>
+
+
+VoxelCharacterCrowd::VoxelCharacterCrowd()
+{
+	SetProjection(60.0f, 1.0f, 0.1f, 100.0f, 768);
+	SetCamera(vec3(0.0f, 0.0f, 0.0f), vec3(0.0f, 0.0f, 1.0f), vec3(0.0f, 1.0f, 0.0f));
+
+	// Big on screen every frame, then every 2nd, 4th and 8th frame as they get smaller and go out of view
+	m_lodScreenSize[CrowdAnimationLOD_Full] = 128.0f;
+	m_lodScreenSize[CrowdAnimationLOD_Near] = 80.0f;
+	m_lodScreenSize[CrowdAnimationLOD_Far] = 0.0f;
+	m_lodScreenSize[CrowdAnimationLOD_Culled] = 0.0f;
+	m_lodUpdateInterval[CrowdAnimationLOD_Full] = 1;
+	m_lodUpdateInterval[CrowdAnimationLOD_Near] = 2;
+	m_lodUpdateInterval[CrowdAnimationLOD_Far] = 4;
+	m_lodUpdateInterval[CrowdAnimationLOD_Culled] = 8;
+
+	m_fullRateBudget = 16;
+	m_faceScreenSize = 64.0f;
+
+	for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+	{
+		m_numAtLOD[i] = 0;
+	}
+	m_numVisibleFaces = 0;
+}
+
+VoxelCharacterCrowd::~VoxelCharacterCrowd()
+{
+	ClearCharacters();
+}
+
+void VoxelCharacterCrowd::ClearCharacters()
+{
+	m_vCharacters.clear();
+	m_vFreeCharacters.clear();
+	m_vpRanking.clear();
+}
+
+// Characters
+int VoxelCharacterCrowd::AddCharacter(VoxelCharacter* pVoxelCharacter, float radius)
+{
+	int characterId;
+	if (m_vFreeCharacters.size() > 0)
+	{
+		characterId = m_vFreeCharacters.back();
+		m_vFreeCharacters.pop_back();
+	}
+	else
+	{
+		characterId = (int)m_vCharacters.size();
+		m_vCharacters.push_back(CrowdCharacter());
+	}
+
+	CrowdCharacter* pCharacter = &m_vCharacters[characterId];
+	pCharacter->m_pVoxelCharacter = pVoxelCharacter;
+	pCharacter->m_used = true;
+	pCharacter->m_position = vec3(0.0f, 0.0f, 0.0f);
+	pCharacter->m_forward = vec3(0.0f, 0.0f, 1.0f);
+	pCharacter->m_radius = radius;
+	for (int i = 0; i < AnimationSections_NUMSECTIONS; i++)
+	{
+		pCharacter->m_animationSpeed[i] = 1.0f;
+	}
+	pCharacter->m_alwaysFullRate = false;
+	pCharacter->m_visible = true;
+	pCharacter->m_screenSize = 0.0f;
+	pCharacter->m_lod = CrowdAnimationLOD_Full;
+
+	return characterId;
+}
+
+void VoxelCharacterCrowd::RemoveCharacter(int characterId)
+{
+	if (characterId < 0 || characterId >= (int)m_vCharacters.size() || m_vCharacters[characterId].m_used == false)
+	{
+		return;
+	}
+
+	// Hand the character back animating every frame, the way it was before it joined the crowd
+	VoxelCharacter* pVoxelCharacter = m_vCharacters[characterId].m_pVoxelCharacter;
+	pVoxelCharacter->SetAnimationUpdateInterval(1, 0);
+	pVoxelCharacter->SetFaceVisible(true);
+	pVoxelCharacter->SetCulled(false);
+
+	m_vCharacters[characterId].m_used = false;
+	m_vCharacters[characterId].m_pVoxelCharacter = NULL;
+	m_vFreeCharacters.push_back(characterId);
+}
+
+void VoxelCharacterCrowd::SetCharacterTransform(int characterId, vec3 position, vec3 forward)
+{
+	if (characterId < 0 || characterId >= (int)m_vCharacters.size())
+	{
+		return;
+	}
+
+	m_vCharacters[characterId].m_position = position;
+	m_vCharacters[characterId].m_forward = forward;
+}
+
+void VoxelCharacterCrowd::SetCharacterAnimationSpeed(int characterId, AnimationSections section, float speed)
+{
+	if (characterId < 0 || characterId >= (int)m_vCharacters.size())
+	{
+		return;
+	}
+
+	m_vCharacters[characterId].m_animationSpeed[section] = speed;
+}
+
+void VoxelCharacterCrowd::SetCharacterAlwaysFullRate(int characterId, bool alwaysFullRate)
+{
+	if (characterId < 0 || characterId >= (int)m_vCharacters.size())
+	{
+		return;
+	}
+
+	m_vCharacters[characterId].m_alwaysFullRate = alwaysFullRate;
+}
+
+int VoxelCharacterCrowd::GetNumCharacters()
+{
+	return (int)(m_vCharacters.size() - m_vFreeCharacters.size());
+}
+
+// Camera
+void VoxelCharacterCrowd::SetProjection(float fov, float aspectRatio, float nearClip, float farClip, int viewportHeight)
+{
+	m_fov = fov;
+	m_viewportHeight = viewportHeight;
+
+	m_frustum.SetFrustum(fov, aspectRatio, nearClip, farClip);
+}
+
+void VoxelCharacterCrowd::SetCamera(vec3 position, vec3 target, vec3 up)
+{
+	m_frustum.SetCamera(position, target, up);
+}
+
+// Level of detail settings
+void VoxelCharacterCrowd::SetLODScreenSize(CrowdAnimationLOD lod, float screenSize)
+{
+	m_lodScreenSize[lod] = screenSize;
+}
+
+void VoxelCharacterCrowd::SetLODUpdateInterval(CrowdAnimationLOD lod, int interval)
+{
+	m_lodUpdateInterval[lod] = interval > 0 ? interval : 1;
+}
+
+void VoxelCharacterCrowd::SetFullRateBudget(int numCharacters)
+{
+	m_fullRateBudget = numCharacters;
+}
+
+void VoxelCharacterCrowd::SetFaceScreenSize(float screenSize)
+{
+	m_faceScreenSize = screenSize;
+}
+
+// Accessors
+CrowdAnimationLOD VoxelCharacterCrowd::GetCharacterLOD(int characterId)
+{
+	return m_vCharacters[characterId].m_lod;
+}
+
+float VoxelCharacterCrowd::GetCharacterScreenSize(int characterId)
+{
+	return m_vCharacters[characterId].m_screenSize;
+}
+
+int VoxelCharacterCrowd::GetNumCharactersAtLOD(CrowdAnimationLOD lod)
+{
+	return m_numAtLOD[lod];
+}
+
+int VoxelCharacterCrowd::GetNumVisibleFaces()
+{
+	return m_numVisibleFaces;
+}
+
+// Update
+void VoxelCharacterCrowd::Update(float dt)
+{
+	RankCharacters();
+
+	for (int i = 0; i < (int)m_vCharacters.size(); i++)
+	{
+		CrowdCharacter* pCharacter = &m_vCharacters[i];
+		if (pCharacter->m_used == false)
+		{
+			continue;
+		}
+
+		pCharacter->m_pVoxelCharacter->Update(dt, pCharacter->m_animationSpeed);
+	}
+}
+
+void VoxelCharacterCrowd::RankCharacters()
+{
+	for (int i = 0; i < CrowdAnimationLOD_NUM; i++)
+	{
+		m_numAtLOD[i] = 0;
+	}
+	m_numVisibleFaces = 0;
+
+	// Visibility and size on screen
+	m_vpRanking.clear();
+	for (int i = 0; i < (int)m_vCharacters.size(); i++)
+	{
+		CrowdCharacter* pCharacter = &m_vCharacters[i];
+		if (pCharacter->m_used == false)
+		{
+			continue;
+		}
+
+		float distance = length(pCharacter->m_position - m_frustum.cameraPosition);
+		pCharacter->m_visible = m_frustum.SphereInFrustum(pCharacter->m_position, pCharacter->m_radius) != Frustum::FRUSTUM_OUTSIDE;
+		pCharacter->m_screenSize = pCharacter->m_visible ? Renderer::GetProjectedSize(pCharacter->m_radius * 2.0f, distance, m_fov, m_viewportHeight) : 0.0f;
+
+		if (pCharacter->m_alwaysFullRate)
+		{
+			pCharacter->m_lod = CrowdAnimationLOD_Full;
+		}
+		else if (pCharacter->m_visible == false)
+		{
+			pCharacter->m_lod = CrowdAnimationLOD_Culled;
+		}
+		else
+		{
+			m_vpRanking.push_back(pCharacter);
+		}
+	}
+
+	// The biggest on screen get the full rate budget, the rest fall back to a band by their size
+	sort(m_vpRanking.begin(), m_vpRanking.end(), SortByScreenSize);
+
+	for (int i = 0; i < (int)m_vpRanking.size(); i++)
+	{
+		CrowdCharacter* pCharacter = m_vpRanking[i];
+
+		if (i < m_fullRateBudget && pCharacter->m_screenSize >= m_lodScreenSize[CrowdAnimationLOD_Full])
+		{
+			pCharacter->m_lod = CrowdAnimationLOD_Full;
+		}
+		else if (pCharacter->m_screenSize >= m_lodScreenSize[CrowdAnimationLOD_Near])
+		{
+			pCharacter->m_lod = CrowdAnimationLOD_Near;
+		}
+		else
+		{
+			pCharacter->m_lod = CrowdAnimationLOD_Far;
+		}
+	}
+
+	// Hand the results to the characters
+	for (int i = 0; i < (int)m_vCharacters.size(); i++)
+	{
+		CrowdCharacter* pCharacter = &m_vCharacters[i];
+		if (pCharacter->m_used == false)
+		{
+			continue;
+		}
+
+		// Faces only animate while they are big enough to see and turned towards the camera
+		vec3 toCamera = m_frustum.cameraPosition - pCharacter->m_position;
+		bool faceVisible = pCharacter->m_alwaysFullRate || (pCharacter->m_visible && pCharacter->m_screenSize >= m_faceScreenSize && dot(pCharacter->m_forward, toCamera) > 0.0f);
+
+		pCharacter->m_pVoxelCharacter->SetAnimationUpdateInterval(m_lodUpdateInterval[pCharacter->m_lod], i);
+		pCharacter->m_pVoxelCharacter->SetFaceVisible(faceVisible);
+		pCharacter->m_pVoxelCharacter->SetCulled(pCharacter->m_lod == CrowdAnimationLOD_Culled);
+
+		m_numAtLOD[pCharacter->m_lod]++;
+		if (faceVisible)
+		{
+			m_numVisibleFaces++;
+		}
+	}
+}
+
+bool VoxelCharacterCrowd::SortByScreenSize(const CrowdCharacter* pLeft, const CrowdCharacter* pRight)
+{
+	return pLeft->m_screenSize > pRight->m_screenSize;
+}
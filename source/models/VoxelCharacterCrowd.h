@@ -0,0 +1,133 @@
+// ******************************************************************************
+// Filename:    VoxelCharacterCrowd.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Updates a crowd of voxel characters with an animation level of detail.
+//   Every frame the characters are tested against the view frustum and
+//   ranked by how large they are on screen, the biggest few are animated
+//   every frame and the rest are evaluated every few frames with their
+//   poses interpolated in between. Faces are only animated while they are
+//   big enough and turned towards the camera, and culled characters drop
+//   their weapon trails.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "VoxelCharacter.h"
+#include "../Renderer/frustum.h"
+
+#include <vector>
+using namespace std;
+
+enum CrowdAnimationLOD
+{
+	CrowdAnimationLOD_Full = 0,
+	CrowdAnimationLOD_Near,
+	CrowdAnimationLOD_Far,
+	CrowdAnimationLOD_Culled,
+
+	CrowdAnimationLOD_NUM,
+};
+
+class CrowdCharacter
+{
+public:
+	VoxelCharacter* m_pVoxelCharacter;
+	bool m_used;
+
+	vec3 m_position;
+	vec3 m_forward;
+	float m_radius;
+	float m_animationSpeed[AnimationSections_NUMSECTIONS];
+
+	// Always animated every frame, for the player and anything else the camera is following
+	bool m_alwaysFullRate;
+
+	// Ranking results
+	bool m_visible;
+	float m_screenSize;
+	CrowdAnimationLOD m_lod;
+};
+
+class VoxelCharacterCrowd
+{
+public:
+	/* Public methods */
+	VoxelCharacterCrowd();
+	~VoxelCharacterCrowd();
+
+	void ClearCharacters();
+
+	// Characters
+	int AddCharacter(VoxelCharacter* pVoxelCharacter, float radius);
+	void RemoveCharacter(int characterId);
+	void SetCharacterTransform(int characterId, vec3 position, vec3 forward);
+	void SetCharacterAnimationSpeed(int characterId, AnimationSections section, float speed);
+	void SetCharacterAlwaysFullRate(int characterId, bool alwaysFullRate);
+	int GetNumCharacters();
+
+	// Camera
+	void SetProjection(float fov, float aspectRatio, float nearClip, float farClip, int viewportHeight);
+	void SetCamera(vec3 position, vec3 target, vec3 up);
+
+	// Level of detail settings
+	void SetLODScreenSize(CrowdAnimationLOD lod, float screenSize);
+	void SetLODUpdateInterval(CrowdAnimationLOD lod, int interval);
+	void SetFullRateBudget(int numCharacters);
+	void SetFaceScreenSize(float screenSize);
+
+	// Accessors
+	CrowdAnimationLOD GetCharacterLOD(int characterId);
+	float GetCharacterScreenSize(int characterId);
+	int GetNumCharactersAtLOD(CrowdAnimationLOD lod);
+	int GetNumVisibleFaces();
+
+	// Update
+	void Update(float dt);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	VoxelCharacterCrowd(const VoxelCharacterCrowd&);
+	VoxelCharacterCrowd &operator=(const VoxelCharacterCrowd&);
+
+	void RankCharacters();
+
+	static bool SortByScreenSize(const CrowdCharacter* pLeft, const CrowdCharacter* pRight);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<CrowdCharacter> m_vCharacters;
+	vector<int> m_vFreeCharacters;
+	vector<CrowdCharacter*> m_vpRanking;
+
+	// Camera
+	Frustum m_frustum;
+	float m_fov;
+	int m_viewportHeight;
+
+	// Level of detail settings
+	float m_lodScreenSize[CrowdAnimationLOD_NUM];
+	int m_lodUpdateInterval[CrowdAnimationLOD_NUM];
+	int m_fullRateBudget;
+	float m_faceScreenSize;
+
+	// Counts from the last update
+	int m_numAtLOD[CrowdAnimationLOD_NUM];
+	int m_numVisibleFaces;
+};
@@ -12,6 +12,8 @@
 // ******************************************************************************
 
 #include "VoxelWeapon.h"
+#include "WeaponDefinition.h"
+#include "../Particles/ParticleManager.h"
 
 #include <fstream>
 #include <ostream>
@@ -70,6 +72,9 @@ void VoxelWeapon::Reset()
 
 	m_cameraYRotation = 0.0f;
 
+	m_pDefinition = NULL;
+	m_ownsSectionObjects = false;
+
 	m_loaded = false;
 }
 
@@ -89,208 +94,120 @@ void VoxelWeapon::RebuildVoxelModel(bool faceMerge)
 
 void VoxelWeapon::LoadWeapon(const char *weaponFilename, bool useManager)
 {
-	ifstream file;
-
-	// Open the file
-	file.open(weaponFilename, ios::in);
-	if(file.is_open())
+	const WeaponDefinition* pDefinition = m_pQubicleBinaryManager->GetWeaponDefinitionRegistry()->GetDefinition(weaponFilename);
+	if(pDefinition == NULL)
 	{
-		string tempString;
+		return;
+	}
 
-		file >> tempString >> m_renderOffset.x >> m_renderOffset.y >> m_renderOffset.z;
+	m_pDefinition = pDefinition;
+	const WeaponDefinitionHeader* pHeader = pDefinition->GetHeader();
 
-		file >> tempString >> m_renderScale;
+	m_renderOffset = vec3(pHeader->m_renderOffset[0], pHeader->m_renderOffset[1], pHeader->m_renderOffset[2]);
+	m_renderScale = pHeader->m_renderScale;
 
-		// Animated sections
-		m_numAnimatedSections = 0;
-		file >> tempString >> m_numAnimatedSections;
-		if(m_numAnimatedSections > 0)
-		{
-			m_pAnimatedSections = new AnimatedSection[m_numAnimatedSections];
-		}
-		for(int i = 0; i < m_numAnimatedSections; i++)
+	// Animated sections
+	m_ownsSectionObjects = (useManager == false);
+	m_numAnimatedSections = pHeader->m_numSections;
+	if(m_numAnimatedSections > 0)
+	{
+		m_pAnimatedSections = new AnimatedSection[m_numAnimatedSections];
+	}
+	for(int i = 0; i < m_numAnimatedSections; i++)
+	{
+		const WeaponSectionDefinition* pSection = pDefinition->GetSection(i);
+
+		if(m_ownsSectionObjects)
 		{
 			m_pAnimatedSections[i].m_pVoxelObject = new VoxelObject();
 			m_pAnimatedSections[i].m_pVoxelObject->SetRenderer(m_pRenderer);
 			m_pAnimatedSections[i].m_pVoxelObject->SetQubicleBinaryManager(m_pQubicleBinaryManager);
-
-			file >> tempString >> m_pAnimatedSections[i].m_fileName;
-			m_pAnimatedSections[i].m_pVoxelObject->LoadObject(m_pAnimatedSections[i].m_fileName.c_str(), useManager);
-
-			file >> tempString >> m_pAnimatedSections[i].m_renderScale;
-
-			float offsetX = 0.0f;
-			float offsetY = 0.0f;
-			float offsetZ = 0.0f;
-			file >> tempString >> offsetX >> offsetY >> offsetZ;
-			m_pAnimatedSections[i].m_renderOffset = vec3(offsetX, offsetY, offsetZ);
-
-			file >> tempString >> m_pAnimatedSections[i].m_autoStart;
-			file >> tempString >> m_pAnimatedSections[i].m_loopingAnimation;
-			m_pAnimatedSections[i].m_playingAnimation = m_pAnimatedSections[i].m_autoStart;
-
-			// Translation
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedX;
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedY;
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedZ;
-
-			file >> tempString >> m_pAnimatedSections[i].m_translateRangeXMin >> m_pAnimatedSections[i].m_translateRangeXMax;
-			file >> tempString >> m_pAnimatedSections[i].m_translateRangeYMin >> m_pAnimatedSections[i].m_translateRangeYMax;
-			file >> tempString >> m_pAnimatedSections[i].m_translateRangeZMin >> m_pAnimatedSections[i].m_translateRangeZMax;
-
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedTurnSpeedX;
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedTurnSpeedY;
-			file >> tempString >> m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ;
-
-			m_pAnimatedSections[i].m_translateX = 0.0f;
-			m_pAnimatedSections[i].m_translateY = 0.0f;
-			m_pAnimatedSections[i].m_translateZ = 0.0f;
-
-			m_pAnimatedSections[i].m_translateMaxSpeedX = m_pAnimatedSections[i].m_translateSpeedX;
-			m_pAnimatedSections[i].m_translateMaxSpeedY = m_pAnimatedSections[i].m_translateSpeedY;
-			m_pAnimatedSections[i].m_translateMaxSpeedZ = m_pAnimatedSections[i].m_translateSpeedZ;
-			m_pAnimatedSections[i].m_translateXUp = true;
-			m_pAnimatedSections[i].m_translateXDown = false;
-			m_pAnimatedSections[i].m_translateYUp = true;
-			m_pAnimatedSections[i].m_translateYDown = false;
-			m_pAnimatedSections[i].m_translateZUp = true;
-			m_pAnimatedSections[i].m_translateZDown = false;
-
-			// Rotation
-			float rotationPointX = 0.0f;
-			float rotationPointY = 0.0f;
-			float rotationPointZ = 0.0f;
-			file >> tempString >> rotationPointX >> rotationPointY >> rotationPointZ;
-			m_pAnimatedSections[i].m_rotationPoint = vec3(rotationPointX, rotationPointY, rotationPointZ);
-
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedX;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedY;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedZ;
-
-			file >> tempString >> m_pAnimatedSections[i].m_rotationRangeXMin >> m_pAnimatedSections[i].m_rotationRangeXMax;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationRangeYMin >> m_pAnimatedSections[i].m_rotationRangeYMax;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationRangeZMin >> m_pAnimatedSections[i].m_rotationRangeZMax;
-
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY;
-			file >> tempString >> m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ;
-
-			m_pAnimatedSections[i].m_rotationX = 0.0f;
-			m_pAnimatedSections[i].m_rotationY = 0.0f;
-			m_pAnimatedSections[i].m_rotationZ = 0.0f;
-
-			m_pAnimatedSections[i].m_rotationMaxSpeedX = m_pAnimatedSections[i].m_rotationSpeedX;
-			m_pAnimatedSections[i].m_rotationMaxSpeedY = m_pAnimatedSections[i].m_rotationSpeedY;
-			m_pAnimatedSections[i].m_rotationMaxSpeedZ = m_pAnimatedSections[i].m_rotationSpeedZ;
-			m_pAnimatedSections[i].m_rotationXUp = true;
-			m_pAnimatedSections[i].m_rotationXDown = false;
-			m_pAnimatedSections[i].m_rotationYUp = true;
-			m_pAnimatedSections[i].m_rotationYDown = false;
-			m_pAnimatedSections[i].m_rotationZUp = true;
-			m_pAnimatedSections[i].m_rotationZDown = false;
+			m_pAnimatedSections[i].m_pVoxelObject->LoadObject(pSection->m_fileName, false);
 		}
-
-		// Dynamic lights
-		m_numLights = 0;
-		file >> tempString >> m_numLights;
-		if(m_numLights > 0)
+		else
 		{
-			m_pLights = new VoxelWeaponLight[m_numLights];
+			m_pAnimatedSections[i].m_pVoxelObject = pDefinition->GetSectionObject(i);
 		}
-		for(int i = 0; i < m_numLights; i++)
-		{
-			m_pLights[i].m_lightId = -1;
-
-			float offsetX = 0.0f;
-			float offsetY = 0.0f;
-			float offsetZ = 0.0f;
-			file >> tempString >> offsetX >> offsetY >> offsetZ;
-			m_pLights[i].m_lightOffset = vec3(offsetX, offsetY, offsetZ);
 
-			file >> tempString >> m_pLights[i].m_lightRadius;
+		m_pAnimatedSections[i].m_renderScale = pSection->m_renderScale;
+		m_pAnimatedSections[i].m_renderOffset = vec3(pSection->m_renderOffset[0], pSection->m_renderOffset[1], pSection->m_renderOffset[2]);
+		m_pAnimatedSections[i].m_autoStart = (pSection->m_autoStart != 0);
+		m_pAnimatedSections[i].m_loopingAnimation = (pSection->m_loopingAnimation != 0);
+		m_pAnimatedSections[i].m_rotationPoint = vec3(pSection->m_rotationPoint[0], pSection->m_rotationPoint[1], pSection->m_rotationPoint[2]);
 
-			file >> tempString >> m_pLights[i].m_lightDiffuseMultiplier;
+		m_pAnimatedSections[i].m_localMatrixValid = false;
 
-			float r = 1.0f;
-			float g = 1.0f;
-			float b = 1.0f;
-			float a = 1.0f;
-			file >> tempString >> r >> g >> b >> a;
-			m_pLights[i].m_lightColour = Colour(r, g, b, a);
-
-			file >> tempString >> m_pLights[i].m_connectedToSectionIndex;
-		}
-
-		// Particle effects
-		m_numParticleEffects = 0;
-		file >> tempString >> m_numParticleEffects;
-		if(m_numParticleEffects > 0)
+		m_pAnimatedSections[i].m_batchSectionId = AnimatedSectionBatch::GetInstance()->AddSection(m_pAnimatedSections[i].m_autoStart, m_pAnimatedSections[i].m_loopingAnimation);
+		for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
 		{
-			m_pParticleEffects = new ParticleEffect[m_numParticleEffects];
+			AnimatedSectionBatch::GetInstance()->SetTrack(m_pAnimatedSections[i].m_batchSectionId, (AnimatedSectionTrack)track, pSection->m_trackSpeed[track], pSection->m_trackRangeMin[track], pSection->m_trackRangeMax[track], pSection->m_trackTurnSpeed[track]);
 		}
-		for(int i = 0; i < m_numParticleEffects; i++)
-		{
-			m_pParticleEffects[i].m_particleEffectId = -1;
+	}
 
-			file >> tempString >> m_pParticleEffects[i].m_fileName;
-			float offsetX = 0.0f;
-			float offsetY = 0.0f;
-			float offsetZ = 0.0f;
-			file >> tempString >> offsetX >> offsetY >> offsetZ;
-			m_pParticleEffects[i].m_positionOffset = vec3(offsetX, offsetY, offsetZ);
+	// Dynamic lights
+	m_numLights = pHeader->m_numLights;
+	if(m_numLights > 0)
+	{
+		m_pLights = new VoxelWeaponLight[m_numLights];
+	}
+	for(int i = 0; i < m_numLights; i++)
+	{
+		const WeaponLightDefinition* pLight = pDefinition->GetLight(i);
+
+		m_pLights[i].m_lightId = -1;
+		m_pLights[i].m_lightOffset = vec3(pLight->m_offset[0], pLight->m_offset[1], pLight->m_offset[2]);
+		m_pLights[i].m_lightRadius = pLight->m_radius;
+		m_pLights[i].m_lightDiffuseMultiplier = pLight->m_diffuseMultiplier;
+		m_pLights[i].m_lightColour = Colour(pLight->m_colour[0], pLight->m_colour[1], pLight->m_colour[2], pLight->m_colour[3]);
+		m_pLights[i].m_connectedToSectionIndex = pLight->m_connectedToSectionIndex;
+	}
 
-			file >> tempString >> m_pParticleEffects[i].m_connectedToSectionIndex;
-		}
+	// Particle effects
+	m_numParticleEffects = pHeader->m_numParticleEffects;
+	if(m_numParticleEffects > 0)
+	{
+		m_pParticleEffects = new ParticleEffect[m_numParticleEffects];
+	}
+	for(int i = 0; i < m_numParticleEffects; i++)
+	{
+		const WeaponParticleEffectDefinition* pParticleEffect = pDefinition->GetParticleEffect(i);
 
-		// Weapon trails
-		m_numWeaponTrails = 0;
-		file >> tempString >> m_numWeaponTrails;
-		if(m_numWeaponTrails > 0)
-		{
-			m_pWeaponTrails = new WeaponTrail[m_numWeaponTrails];
-		}
-		for(int i = 0; i < m_numWeaponTrails; i++)
+		m_pParticleEffects[i].m_particleEffectId = ParticleManager::INVALID_EMITTER;
+		m_pParticleEffects[i].m_positionOffset = vec3(pParticleEffect->m_positionOffset[0], pParticleEffect->m_positionOffset[1], pParticleEffect->m_positionOffset[2]);
+		m_pParticleEffects[i].m_connectedToSectionIndex = pParticleEffect->m_connectedToSectionIndex;
+	}
+
+	// Weapon trails
+	m_numWeaponTrails = pHeader->m_numTrails;
+	if(m_numWeaponTrails > 0)
+	{
+		m_pWeaponTrails = new WeaponTrail[m_numWeaponTrails];
+	}
+	for(int i = 0; i < m_numWeaponTrails; i++)
+	{
+		const WeaponTrailDefinition* pTrail = pDefinition->GetTrail(i);
+
+		m_pWeaponTrails[i].m_trailTime = pTrail->m_trailTime;
+		m_pWeaponTrails[i].m_startOffsetPoint = vec3(pTrail->m_startOffset[0], pTrail->m_startOffset[1], pTrail->m_startOffset[2]);
+		m_pWeaponTrails[i].m_endOffsetPoint = vec3(pTrail->m_endOffset[0], pTrail->m_endOffset[1], pTrail->m_endOffset[2]);
+		m_pWeaponTrails[i].m_trailColour = Colour(pTrail->m_colour[0], pTrail->m_colour[1], pTrail->m_colour[2]);
+		m_pWeaponTrails[i].m_followOrigin = (pTrail->m_followOrigin != 0);
+
+		m_pWeaponTrails[i].m_parentScale = 1.0f;
+		m_pWeaponTrails[i].m_numTrailPoints = 50;
+		m_pWeaponTrails[i].m_pTrailPoints = new WeaponTrailPoint[m_pWeaponTrails[i].m_numTrailPoints];
+		m_pWeaponTrails[i].m_trailNextAddIndex = 0;
+		for(int point = 0; point < m_pWeaponTrails[i].m_numTrailPoints; point++)
 		{
-			file >> tempString >> m_pWeaponTrails[i].m_trailTime;
-
-			float startOffsetX = 0.0f;
-			float startOffsetY = 0.0f;
-			float startOffsetZ = 0.0f;
-			file >> tempString >> startOffsetX >> startOffsetY >> startOffsetZ;
-			m_pWeaponTrails[i].m_startOffsetPoint = vec3(startOffsetX, startOffsetY, startOffsetZ);
-
-			float endOffsetX = 0.0f;
-			float endOffsetY = 0.0f;
-			float endOffsetZ = 0.0f;
-			file >> tempString >> endOffsetX >> endOffsetY >> endOffsetZ;
-			m_pWeaponTrails[i].m_endOffsetPoint = vec3(endOffsetX, endOffsetY, endOffsetZ);
-
-			float r = 1.0f;
-			float g = 1.0f;
-			float b = 1.0f;
-			file >> tempString >> r >> g >> b;
-			m_pWeaponTrails[i].m_trailColour = Colour(r, g, b);
-
-			file >> tempString >> m_pWeaponTrails[i].m_followOrigin;
-
-			m_pWeaponTrails[i].m_parentScale = 1.0f;
-			m_pWeaponTrails[i].m_numTrailPoints = 50;
-			m_pWeaponTrails[i].m_pTrailPoints = new WeaponTrailPoint[m_pWeaponTrails[i].m_numTrailPoints];
-			m_pWeaponTrails[i].m_trailNextAddIndex = 0;
-			for(int point = 0; point < m_pWeaponTrails[i].m_numTrailPoints; point++)
-			{
-				m_pWeaponTrails[i].m_pTrailPoints[point].m_pointActive = false;
-				m_pWeaponTrails[i].m_pTrailPoints[point].m_animaionTime = 0.0f;
-			}
+			m_pWeaponTrails[i].m_pTrailPoints[point].m_pointActive = false;
+			m_pWeaponTrails[i].m_pTrailPoints[point].m_animaionTime = 0.0f;
 		}
+	}
 
-		// Gameplay
-		file >> tempString >> m_weaponRadius;
-
-		m_loaded = true;
+	// Gameplay
+	m_weaponRadius = pHeader->m_weaponRadius;
 
-		file.close();
-	}
+	m_loaded = true;
 }
 
 void VoxelWeapon::SaveWeapon(const char *weaponFilename)
@@ -306,33 +223,37 @@ void VoxelWeapon::SaveWeapon(const char *weaponFilename)
 		file << "scale: " << m_renderScale << "\n\n";
 
 		// Animated sections
+		AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+		pBatch->Update();
+
 		file << "numAnimatedSections: " << m_numAnimatedSections << "\n";
 		for (int i = 0; i < m_numAnimatedSections; i++)
 		{
-			file << "qubicleFile: " << m_pAnimatedSections[i].m_fileName << "\n";
+			file << "qubicleFile: " << m_pDefinition->GetSection(i)->m_fileName << "\n";
 			file << "renderScale: " << m_pAnimatedSections[i].m_renderScale << "\n";
 			file << "renderOffset: " << m_pAnimatedSections[i].m_renderOffset.x << " " << m_pAnimatedSections[i].m_renderOffset.y << " " << m_pAnimatedSections[i].m_renderOffset.z << " " << "\n";
 			file << "autoStartAnimation: " << m_pAnimatedSections[i].m_autoStart << "\n";
 			file << "loopingAnimation: " << m_pAnimatedSections[i].m_loopingAnimation << "\n";
-			file << "translateXSpeed: " << m_pAnimatedSections[i].m_translateSpeedX << "\n";
-			file << "translateYSpeed: " << m_pAnimatedSections[i].m_translateSpeedY << "\n";
-			file << "translateZSpeed: " << m_pAnimatedSections[i].m_translateSpeedZ << "\n";
-			file << "translateXRange: " << m_pAnimatedSections[i].m_translateRangeXMin << " " << m_pAnimatedSections[i].m_translateRangeXMax << "\n";
-			file << "translateYRange: " << m_pAnimatedSections[i].m_translateRangeYMin << " " << m_pAnimatedSections[i].m_translateRangeYMax << "\n";
-			file << "translateZRange: " << m_pAnimatedSections[i].m_translateRangeZMin << " " << m_pAnimatedSections[i].m_translateRangeZMax << "\n";
-			file << "translateXTurnSpeed: " << m_pAnimatedSections[i].m_translateSpeedTurnSpeedX << "\n";
-			file << "translateYTurnSpeed: " << m_pAnimatedSections[i].m_translateSpeedTurnSpeedY << "\n";
-			file << "translateZTurnSpeed: " << m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ << "\n";
+			int sectionId = m_pAnimatedSections[i].m_batchSectionId;
+			file << "translateXSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_TranslateX) << "\n";
+			file << "translateYSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_TranslateY) << "\n";
+			file << "translateZSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_TranslateZ) << "\n";
+			file << "translateXRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_TranslateX) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_TranslateX) << "\n";
+			file << "translateYRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_TranslateY) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_TranslateY) << "\n";
+			file << "translateZRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_TranslateZ) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_TranslateZ) << "\n";
+			file << "translateXTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_TranslateX) << "\n";
+			file << "translateYTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_TranslateY) << "\n";
+			file << "translateZTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_TranslateZ) << "\n";
 			file << "rotationPoint: " << m_pAnimatedSections[i].m_rotationPoint.x << " " << m_pAnimatedSections[i].m_rotationPoint.y << " " << m_pAnimatedSections[i].m_rotationPoint.z << "\n";
-			file << "rotationXSpeed: " << m_pAnimatedSections[i].m_rotationSpeedX << "\n";
-			file << "rotationYSpeed: " << m_pAnimatedSections[i].m_rotationSpeedY << "\n";
-			file << "rotationZSpeed: " << m_pAnimatedSections[i].m_rotationSpeedZ << "\n";
-			file << "rotationXRange: " << m_pAnimatedSections[i].m_rotationRangeXMin << " " << m_pAnimatedSections[i].m_rotationRangeXMax << "\n";
-			file << "rotationYRange: " << m_pAnimatedSections[i].m_rotationRangeYMin << " " << m_pAnimatedSections[i].m_rotationRangeYMax << "\n";
-			file << "rotationZRange: " << m_pAnimatedSections[i].m_rotationRangeZMin << " " << m_pAnimatedSections[i].m_rotationRangeZMax << "\n";
-			file << "rotationXTurnSpeed: " << m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX << "\n";
-			file << "rotationYTurnSpeed: " << m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY << "\n";
-			file << "rotationZTurnSpeed: " << m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ << "\n";
+			file << "rotationXSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_RotationX) << "\n";
+			file << "rotationYSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_RotationY) << "\n";
+			file << "rotationZSpeed: " << pBatch->GetSpeed(sectionId, AnimatedSectionTrack_RotationZ) << "\n";
+			file << "rotationXRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_RotationX) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_RotationX) << "\n";
+			file << "rotationYRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_RotationY) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_RotationY) << "\n";
+			file << "rotationZRange: " << pBatch->GetRangeMin(sectionId, AnimatedSectionTrack_RotationZ) << " " << pBatch->GetRangeMax(sectionId, AnimatedSectionTrack_RotationZ) << "\n";
+			file << "rotationXTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_RotationX) << "\n";
+			file << "rotationYTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_RotationY) << "\n";
+			file << "rotationZTurnSpeed: " << pBatch->GetTurnSpeed(sectionId, AnimatedSectionTrack_RotationZ) << "\n";
 		}
 		file << "\n";
 
@@ -352,7 +273,7 @@ void VoxelWeapon::SaveWeapon(const char *weaponFilename)
 		file << "numParticleEffects: " << m_numParticleEffects << "\n";
 		for (int i = 0; i < m_numParticleEffects; i++)
 		{
-			file << "particleEffect: " << m_pParticleEffects[i].m_fileName << "\n";
+			file << "particleEffect: " << m_pDefinition->GetParticleEffect(i)->m_fileName << "\n";
 			file << "position: " << m_pParticleEffects[i].m_positionOffset.x << " " << m_pParticleEffects[i].m_positionOffset.y << " " << m_pParticleEffects[i].m_positionOffset.z << "\n";
 			file << "connectedToSection: " << m_pParticleEffects[i].m_connectedToSectionIndex << "\n";
 		}
@@ -388,6 +309,18 @@ void VoxelWeapon::UnloadWeapon()
 
 	if(m_numAnimatedSections > 0)
 	{
+		for(int i = 0; i < m_numAnimatedSections; i++)
+		{
+			AnimatedSectionBatch::GetInstance()->RemoveSection(m_pAnimatedSections[i].m_batchSectionId);
+
+			// Shared section models belong to the definition
+			if(m_ownsSectionObjects)
+			{
+				delete m_pAnimatedSections[i].m_pVoxelObject;
+			}
+			m_pAnimatedSections[i].m_pVoxelObject = NULL;
+		}
+
 		delete[] m_pAnimatedSections;
 		m_pAnimatedSections = NULL;
 		m_numAnimatedSections = 0;
@@ -470,23 +403,29 @@ vec3 VoxelWeapon::GetCenter()
 // Subsection animations
 void VoxelWeapon::StartSubSectionAnimation()
 {
+	AnimatedSectionBatch::GetInstance()->Update();
+
 	for(int i = 0; i < m_numAnimatedSections; i++)
 	{
-		m_pAnimatedSections[i].m_playingAnimation = true;
+		AnimatedSectionBatch::GetInstance()->SetPlaying(m_pAnimatedSections[i].m_batchSectionId, true);
 	}
 }
 
 void VoxelWeapon::StopSubSectionAnimation()
 {
+	AnimatedSectionBatch::GetInstance()->Update();
+
 	for(int i = 0; i < m_numAnimatedSections; i++)
 	{
-		m_pAnimatedSections[i].m_playingAnimation = false;
+		AnimatedSectionBatch::GetInstance()->SetPlaying(m_pAnimatedSections[i].m_batchSectionId, false);
 	}
 }
 
 bool VoxelWeapon::HasSubSectionAnimationFinished(int index)
 {
-	return m_pAnimatedSections[index].m_playingAnimation == false;
+	AnimatedSectionBatch::GetInstance()->Update();
+
+	return AnimatedSectionBatch::GetInstance()->IsPlaying(m_pAnimatedSections[index].m_batchSectionId) == false;
 }
 
 // Weapon trails
@@ -558,7 +497,7 @@ void VoxelWeapon::GetParticleEffectParams(int particleEffectIndex, unsigned int
 {
 	*particleEffectId = m_pParticleEffects[particleEffectIndex].m_particleEffectId;
 	*position = m_pParticleEffects[particleEffectIndex].m_particleEffectPosition;
-	*name = m_pParticleEffects[particleEffectIndex].m_fileName;
+	*name = m_pDefinition->GetParticleEffect(particleEffectIndex)->m_fileName;
 	*connectedToSegment = m_pParticleEffects[particleEffectIndex].m_connectedToSectionIndex != -1;
 
 	if(m_pParticleEffects[particleEffectIndex].m_connectedToSectionIndex == -1)
@@ -802,297 +741,16 @@ void VoxelWeapon::Update(float dt)
 		return;
 	}
 
-	// Update animated sections
+	// Update animated sections, queued here and stepped together with every other weapon's sections
+	AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+	if(m_numAnimatedSections > 0 && pBatch->IsQueued(m_pAnimatedSections[0].m_batchSectionId))
+	{
+		// Still waiting on the last update, step that first so no time is lost
+		pBatch->Update();
+	}
 	for(int i = 0; i < m_numAnimatedSections; i++)
 	{
-		if(m_pAnimatedSections[i].m_playingAnimation)
-		{
-			bool noChangeInAnimation = (m_pAnimatedSections[i].m_translateSpeedX == 0.0f && m_pAnimatedSections[i].m_translateSpeedY == 0.0f && m_pAnimatedSections[i].m_translateSpeedZ == 0.0f &&
-										m_pAnimatedSections[i].m_rotationSpeedX == 0.0f && m_pAnimatedSections[i].m_rotationSpeedY == 0.0f && m_pAnimatedSections[i].m_rotationSpeedZ == 0.0f);
-
-			// Translation
-			if(m_pAnimatedSections[i].m_translateXUp == true && m_pAnimatedSections[i].m_translateSpeedX < m_pAnimatedSections[i].m_translateMaxSpeedX)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedX != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedX += m_pAnimatedSections[i].m_translateSpeedTurnSpeedX * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateX = m_pAnimatedSections[i].m_translateRangeXMin;
-					m_pAnimatedSections[i].m_translateSpeedX = -m_pAnimatedSections[i].m_translateSpeedX;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateXDown == true && m_pAnimatedSections[i].m_translateSpeedX > -m_pAnimatedSections[i].m_translateMaxSpeedX)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedX != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedX -= m_pAnimatedSections[i].m_translateSpeedTurnSpeedX * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateX = m_pAnimatedSections[i].m_translateRangeXMax;
-					m_pAnimatedSections[i].m_translateSpeedX = -m_pAnimatedSections[i].m_translateSpeedX;
-				}
-			}
-			if(m_pAnimatedSections[i].m_translateYUp == true && m_pAnimatedSections[i].m_translateSpeedY < m_pAnimatedSections[i].m_translateMaxSpeedY)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedY != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedY += m_pAnimatedSections[i].m_translateSpeedTurnSpeedY * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateY = m_pAnimatedSections[i].m_translateRangeYMin;
-					m_pAnimatedSections[i].m_translateSpeedY = -m_pAnimatedSections[i].m_translateSpeedY;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateYDown == true && m_pAnimatedSections[i].m_translateSpeedY > -m_pAnimatedSections[i].m_translateMaxSpeedY)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedY != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedY -= m_pAnimatedSections[i].m_translateSpeedTurnSpeedY * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateY = m_pAnimatedSections[i].m_translateRangeYMax;
-					m_pAnimatedSections[i].m_translateSpeedY = -m_pAnimatedSections[i].m_translateSpeedY;
-				}
-			}
-			if(m_pAnimatedSections[i].m_translateZUp == true && m_pAnimatedSections[i].m_translateSpeedZ < m_pAnimatedSections[i].m_translateMaxSpeedZ)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedZ += m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateZ = m_pAnimatedSections[i].m_translateRangeZMin;
-					m_pAnimatedSections[i].m_translateSpeedZ = -m_pAnimatedSections[i].m_translateSpeedZ;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateZDown == true && m_pAnimatedSections[i].m_translateSpeedZ > -m_pAnimatedSections[i].m_translateMaxSpeedZ)
-			{
-				if(m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ != -1)
-				{
-					m_pAnimatedSections[i].m_translateSpeedZ -= m_pAnimatedSections[i].m_translateSpeedTurnSpeedZ * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_translateZ = m_pAnimatedSections[i].m_translateRangeZMax;
-					m_pAnimatedSections[i].m_translateSpeedZ = -m_pAnimatedSections[i].m_translateSpeedZ;
-				}
-			}
-
-			if(m_pAnimatedSections[i].m_translateX > m_pAnimatedSections[i].m_translateRangeXMax)
-			{
-				m_pAnimatedSections[i].m_translateXUp = false;
-				m_pAnimatedSections[i].m_translateXDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateX < m_pAnimatedSections[i].m_translateRangeXMin)
-			{
-				m_pAnimatedSections[i].m_translateXUp = true;
-				m_pAnimatedSections[i].m_translateXDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			if(m_pAnimatedSections[i].m_translateY > m_pAnimatedSections[i].m_translateRangeYMax)
-			{
-				m_pAnimatedSections[i].m_translateYUp = false;
-				m_pAnimatedSections[i].m_translateYDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateY < m_pAnimatedSections[i].m_translateRangeYMin)
-			{
-				m_pAnimatedSections[i].m_translateYUp = true;
-				m_pAnimatedSections[i].m_translateYDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			if(m_pAnimatedSections[i].m_translateZ > m_pAnimatedSections[i].m_translateRangeZMax)
-			{
-				m_pAnimatedSections[i].m_translateZUp = false;
-				m_pAnimatedSections[i].m_translateZDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_translateZ < m_pAnimatedSections[i].m_translateRangeZMin)
-			{
-				m_pAnimatedSections[i].m_translateZUp = true;
-				m_pAnimatedSections[i].m_translateZDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-
-			m_pAnimatedSections[i].m_translateX += m_pAnimatedSections[i].m_translateSpeedX * dt;
-			m_pAnimatedSections[i].m_translateY += m_pAnimatedSections[i].m_translateSpeedY * dt;
-			m_pAnimatedSections[i].m_translateZ += m_pAnimatedSections[i].m_translateSpeedZ * dt;
-
-			// Rotation
-			if(m_pAnimatedSections[i].m_rotationXUp == true && m_pAnimatedSections[i].m_rotationSpeedX < m_pAnimatedSections[i].m_rotationMaxSpeedX)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedX += m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationX = m_pAnimatedSections[i].m_rotationRangeXMin;
-					m_pAnimatedSections[i].m_rotationSpeedX = -m_pAnimatedSections[i].m_rotationSpeedX;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationXDown == true && m_pAnimatedSections[i].m_rotationSpeedX > -m_pAnimatedSections[i].m_rotationMaxSpeedX)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedX -= m_pAnimatedSections[i].m_rotationSpeedTurnSpeedX * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationX = m_pAnimatedSections[i].m_rotationRangeXMax;
-					m_pAnimatedSections[i].m_rotationSpeedX = -m_pAnimatedSections[i].m_rotationSpeedX;
-				}
-			}
-			if(m_pAnimatedSections[i].m_rotationYUp == true && m_pAnimatedSections[i].m_rotationSpeedY < m_pAnimatedSections[i].m_rotationMaxSpeedY)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedY += m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationY = m_pAnimatedSections[i].m_rotationRangeYMin;
-					m_pAnimatedSections[i].m_rotationSpeedY = -m_pAnimatedSections[i].m_rotationSpeedY;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationYDown == true && m_pAnimatedSections[i].m_rotationSpeedY > -m_pAnimatedSections[i].m_rotationMaxSpeedY)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedY -= m_pAnimatedSections[i].m_rotationSpeedTurnSpeedY * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationY = m_pAnimatedSections[i].m_rotationRangeYMax;
-					m_pAnimatedSections[i].m_rotationSpeedY = -m_pAnimatedSections[i].m_rotationSpeedY;
-				}
-			}
-			if(m_pAnimatedSections[i].m_rotationZUp == true && m_pAnimatedSections[i].m_rotationSpeedZ < m_pAnimatedSections[i].m_rotationMaxSpeedZ)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedZ += m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationZ = m_pAnimatedSections[i].m_rotationRangeZMin;
-					m_pAnimatedSections[i].m_rotationSpeedZ = -m_pAnimatedSections[i].m_rotationSpeedZ;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationZDown == true && m_pAnimatedSections[i].m_rotationSpeedZ > -m_pAnimatedSections[i].m_rotationMaxSpeedZ)
-			{
-				if(m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ != -1)
-				{
-					m_pAnimatedSections[i].m_rotationSpeedZ -= m_pAnimatedSections[i].m_rotationSpeedTurnSpeedZ * dt;
-				}
-				else
-				{
-					m_pAnimatedSections[i].m_rotationZ = m_pAnimatedSections[i].m_rotationRangeZMax;
-					m_pAnimatedSections[i].m_rotationSpeedZ = -m_pAnimatedSections[i].m_rotationSpeedZ;
-				}
-			}
-
-			if(m_pAnimatedSections[i].m_rotationX > m_pAnimatedSections[i].m_rotationRangeXMax)
-			{
-				m_pAnimatedSections[i].m_rotationXUp = false;
-				m_pAnimatedSections[i].m_rotationXDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationX < m_pAnimatedSections[i].m_rotationRangeXMin)
-			{
-				m_pAnimatedSections[i].m_rotationXUp = true;
-				m_pAnimatedSections[i].m_rotationXDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			if(m_pAnimatedSections[i].m_rotationY > m_pAnimatedSections[i].m_rotationRangeYMax)
-			{
-				m_pAnimatedSections[i].m_rotationYUp = false;
-				m_pAnimatedSections[i].m_rotationYDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationY < m_pAnimatedSections[i].m_rotationRangeYMin)
-			{
-				m_pAnimatedSections[i].m_rotationYUp = true;
-				m_pAnimatedSections[i].m_rotationYDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			if(m_pAnimatedSections[i].m_rotationZ > m_pAnimatedSections[i].m_rotationRangeZMax)
-			{
-				m_pAnimatedSections[i].m_rotationZUp = false;
-				m_pAnimatedSections[i].m_rotationZDown = true;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-			else if(m_pAnimatedSections[i].m_rotationZ < m_pAnimatedSections[i].m_rotationRangeZMin)
-			{
-				m_pAnimatedSections[i].m_rotationZUp = true;
-				m_pAnimatedSections[i].m_rotationZDown = false;
-
-				if(m_pAnimatedSections[i].m_loopingAnimation == false)
-				{
-					m_pAnimatedSections[i].m_playingAnimation = false;
-				}
-			}
-
-			m_pAnimatedSections[i].m_rotationX += m_pAnimatedSections[i].m_rotationSpeedX * dt;
-			m_pAnimatedSections[i].m_rotationY += m_pAnimatedSections[i].m_rotationSpeedY * dt;
-			m_pAnimatedSections[i].m_rotationZ += m_pAnimatedSections[i].m_rotationSpeedZ * dt;
-
-			if (noChangeInAnimation)
-			{
-				m_pAnimatedSections[i].m_playingAnimation = false;
-			}
-		}
+		pBatch->QueueUpdate(m_pAnimatedSections[i].m_batchSectionId, dt);
 	}
 
 	// Update dynamic lights
@@ -1476,23 +1134,13 @@ void VoxelWeapon::Render(bool renderOutline, bool reflection, bool silhouette, C
 		m_pRenderer->TranslateWorldMatrix(m_renderOffset.x, m_renderOffset.y, m_renderOffset.z);
 
 		// Render all animated sections
+		AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+		pBatch->Update();
 		for(int i = 0; i < m_numAnimatedSections; i++)
 		{
 			m_pRenderer->PushMatrix();
-				// Scale to render size
-				m_pRenderer->ScaleWorldMatrix(m_pAnimatedSections[i].m_renderScale, m_pAnimatedSections[i].m_renderScale, m_pAnimatedSections[i].m_renderScale);
-
-				// Translate for initial block offset
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_renderOffset.x, m_pAnimatedSections[i].m_renderOffset.y, m_pAnimatedSections[i].m_renderOffset.z);
-
-				// Animated sections
-				m_pRenderer->TranslateWorldMatrix(-m_pAnimatedSections[i].m_rotationPoint.x, -m_pAnimatedSections[i].m_rotationPoint.y, -m_pAnimatedSections[i].m_rotationPoint.z);
-				m_pRenderer->RotateWorldMatrix(m_pAnimatedSections[i].m_rotationX, m_pAnimatedSections[i].m_rotationY, m_pAnimatedSections[i].m_rotationZ);
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_rotationPoint.x, m_pAnimatedSections[i].m_rotationPoint.y, m_pAnimatedSections[i].m_rotationPoint.z);
-					
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_translateX, m_pAnimatedSections[i].m_translateY, m_pAnimatedSections[i].m_translateZ);
-
-				//m_pRenderer->ScaleWorldMatrix(1.0f, 1.0f, 1.0f);
+				// Scale, offset and animated rotation and translation, composed once for the section
+				m_pRenderer->MultiplyWorldMatrix(GetAnimatedSectionMatrix(i));
 
 				m_pAnimatedSections[i].m_pVoxelObject->Render(renderOutline, reflection, silhouette, OutlineColour);
 
@@ -1507,6 +1155,54 @@ void VoxelWeapon::Render(bool renderOutline, bool reflection, bool silhouette, C
 	m_pRenderer->PopMatrix();
 }
 
+// Private methods
+const Matrix4x4& VoxelWeapon::GetAnimatedSectionMatrix(int index)
+{
+	AnimatedSection* pSection = &m_pAnimatedSections[index];
+	AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+
+	float tracks[AnimatedSectionTrack_NUM];
+	bool changed = (pSection->m_localMatrixValid == false);
+	for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+	{
+		tracks[track] = pBatch->GetInterpolatedValue(pSection->m_batchSectionId, (AnimatedSectionTrack)track);
+		if (tracks[track] != pSection->m_localMatrixTracks[track])
+		{
+			changed = true;
+		}
+	}
+
+	// A section that isn't animating keeps the matrix it already has
+	if (changed == false)
+	{
+		return pSection->m_localMatrix;
+	}
+
+	// Same order as the scale, offset, rotate about the rotation point and translate on the matrix stack
+	Matrix4x4 scale;
+	scale.SetScale(vec3(pSection->m_renderScale, pSection->m_renderScale, pSection->m_renderScale));
+	Matrix4x4 offset;
+	offset.SetTranslation(pSection->m_renderOffset - pSection->m_rotationPoint);
+	Matrix4x4 rotX;
+	Matrix4x4 rotY;
+	Matrix4x4 rotZ;
+	rotX.SetXRotation(DegToRad(tracks[AnimatedSectionTrack_RotationX]));
+	rotY.SetYRotation(DegToRad(tracks[AnimatedSectionTrack_RotationY]));
+	rotZ.SetZRotation(DegToRad(tracks[AnimatedSectionTrack_RotationZ]));
+	Matrix4x4 translate;
+	translate.SetTranslation(pSection->m_rotationPoint + vec3(tracks[AnimatedSectionTrack_TranslateX], tracks[AnimatedSectionTrack_TranslateY], tracks[AnimatedSectionTrack_TranslateZ]));
+
+	pSection->m_localMatrix = translate * rotX * rotY * rotZ * offset * scale;
+
+	for (int track = 0; track < AnimatedSectionTrack_NUM; track++)
+	{
+		pSection->m_localMatrixTracks[track] = tracks[track];
+	}
+	pSection->m_localMatrixValid = true;
+
+	return pSection->m_localMatrix;
+}
+
 void VoxelWeapon::RenderPaperdoll()
 {
 	m_pRenderer->PushMatrix();
@@ -1573,23 +1269,13 @@ void VoxelWeapon::RenderPaperdoll()
 		m_pRenderer->TranslateWorldMatrix(m_renderOffset.x, m_renderOffset.y, m_renderOffset.z);
 
 		// Render all animated sections
+		AnimatedSectionBatch* pBatch = AnimatedSectionBatch::GetInstance();
+		pBatch->Update();
 		for(int i = 0; i < m_numAnimatedSections; i++)
 		{
 			m_pRenderer->PushMatrix();
-				// Scale to render size
-				m_pRenderer->ScaleWorldMatrix(m_pAnimatedSections[i].m_renderScale, m_pAnimatedSections[i].m_renderScale, m_pAnimatedSections[i].m_renderScale);
-
-				// Translate for initial block offset
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_renderOffset.x, m_pAnimatedSections[i].m_renderOffset.y, m_pAnimatedSections[i].m_renderOffset.z);
-
-				// Animated sections
-				m_pRenderer->TranslateWorldMatrix(-m_pAnimatedSections[i].m_rotationPoint.x, -m_pAnimatedSections[i].m_rotationPoint.y, -m_pAnimatedSections[i].m_rotationPoint.z);
-				m_pRenderer->RotateWorldMatrix(m_pAnimatedSections[i].m_rotationX, m_pAnimatedSections[i].m_rotationY, m_pAnimatedSections[i].m_rotationZ);
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_rotationPoint.x, m_pAnimatedSections[i].m_rotationPoint.y, m_pAnimatedSections[i].m_rotationPoint.z);
-
-				m_pRenderer->TranslateWorldMatrix(m_pAnimatedSections[i].m_translateX, m_pAnimatedSections[i].m_translateY, m_pAnimatedSections[i].m_translateZ);
-
-				//m_pRenderer->ScaleWorldMatrix(1.0f, 1.0f, 1.0f);
+				// Scale, offset and animated rotation and translation, composed once for the section
+				m_pRenderer->MultiplyWorldMatrix(GetAnimatedSectionMatrix(i));
 
 				Colour OutlineColour(1.0f, 1.0f, 0.0f, 1.0f);
 				m_pAnimatedSections[i].m_pVoxelObject->Render(false, false, false, OutlineColour);
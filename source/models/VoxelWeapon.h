@@ -16,8 +16,10 @@
 
 #include "modelloader.h"
 #include "QubicleBinaryManager.h"
+#include "AnimatedSectionBatch.h"
 
 class VoxelObject;
+class WeaponDefinition;
 
 
 class VoxelWeaponLight
@@ -36,77 +38,30 @@ public:
 class AnimatedSection
 {
 public:
-	string m_fileName;
 	VoxelObject* m_pVoxelObject;
 	float m_renderScale;
 	vec3 m_renderOffset;
 
 	bool m_autoStart;
-	bool m_playingAnimation;
 	bool m_loopingAnimation;
 
-	// Animated parts
-	float m_translateSpeedX;
-	float m_translateSpeedY;
-	float m_translateSpeedZ;
-	float m_translateRangeXMin;
-	float m_translateRangeXMax;
-	float m_translateRangeYMin;
-	float m_translateRangeYMax;
-	float m_translateRangeZMin;
-	float m_translateRangeZMax;
-	float m_translateSpeedTurnSpeedX;
-	float m_translateSpeedTurnSpeedY;
-	float m_translateSpeedTurnSpeedZ;
+	// Animated parts, the translate and rotate tracks live in the AnimatedSectionBatch
+	int m_batchSectionId;
 
 	vec3 m_rotationPoint;
-	float m_rotationSpeedX;
-	float m_rotationSpeedY;
-	float m_rotationSpeedZ;
-	float m_rotationRangeXMin;
-	float m_rotationRangeXMax;
-	float m_rotationRangeYMin;
-	float m_rotationRangeYMax;
-	float m_rotationRangeZMin;
-	float m_rotationRangeZMax;
-	float m_rotationSpeedTurnSpeedX;
-	float m_rotationSpeedTurnSpeedY;
-	float m_rotationSpeedTurnSpeedZ;
 
 	vec3 m_animatedSectionPosition;
 
-	float m_translateX;
-	float m_translateY;
-	float m_translateZ;
-	float m_translateMaxSpeedX;
-	float m_translateMaxSpeedY;
-	float m_translateMaxSpeedZ;
-	bool m_translateXUp;
-	bool m_translateXDown;
-	bool m_translateYUp;
-	bool m_translateYDown;
-	bool m_translateZUp;
-	bool m_translateZDown;
-
-	float m_rotationX;
-	float m_rotationY;
-	float m_rotationZ;
-	float m_rotationMaxSpeedX;
-	float m_rotationMaxSpeedY;
-	float m_rotationMaxSpeedZ;
-	bool m_rotationXUp;
-	bool m_rotationXDown;
-	bool m_rotationYUp;
-	bool m_rotationYDown;
-	bool m_rotationZUp;
-	bool m_rotationZDown;
+	// Local matrix for the section, only composed again when the track values it was built from change
+	Matrix4x4 m_localMatrix;
+	bool m_localMatrixValid;
+	float m_localMatrixTracks[AnimatedSectionTrack_NUM];
 };
 
 class ParticleEffect
 {
 public:
 	unsigned int m_particleEffectId;
-	string m_fileName;
 	vec3 m_positionOffset;
 	int m_connectedToSectionIndex;
 
@@ -219,6 +174,7 @@ protected:
 
 private:
 	/* Private methods */
+	const Matrix4x4& GetAnimatedSectionMatrix(int index);
 
 public:
 	/* Public members */
@@ -234,6 +190,12 @@ private:
 	// Loaded flag
 	bool m_loaded;
 
+	// Shared definition from the registry, everything held per weapon below is a copy or animation state
+	const WeaponDefinition* m_pDefinition;
+
+	// Section models are only per weapon when not loaded through the manager
+	bool m_ownsSectionObjects;
+
 	// Parent character we are connected to
 	VoxelCharacter* m_pParentCharacter;
 
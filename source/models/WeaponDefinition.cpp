@@ -0,0 +1,468 @@
+// ******************************************************************************
+// Filename:    WeaponDefinition.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "WeaponDefinition.h"
+#include "VoxelObject.h"
+#include "../utils/FileUtils.h"
+#include "../utils/CacheFile.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sstream>
+
+
+const unsigned int WEAPON_DEFINITION_MAGIC = 0x4E505756; // 'VWPN'
+
+static void CopyWeaponFileName(char* pDest, const string& source)
+{
+	strncpy(pDest, source.c_str(), WEAPON_DEFINITION_MAX_FILENAME - 1);
+	pDest[WEAPON_DEFINITION_MAX_FILENAME - 1] = 0;
+}
+
+// The size of a packed definition with the given record counts
+static size_t GetPackedSize(int numSections, int numLights, int numParticleEffects, int numTrails)
+{
+	return sizeof(WeaponDefinitionHeader) +
+		sizeof(WeaponSectionDefinition) * numSections +
+		sizeof(WeaponLightDefinition) * numLights +
+		sizeof(WeaponParticleEffectDefinition) * numParticleEffects +
+		sizeof(WeaponTrailDefinition) * numTrails;
+}
+
+
+WeaponDefinition::WeaponDefinition()
+{
+	m_pHeader = NULL;
+	m_pSections = NULL;
+	m_pLights = NULL;
+	m_pParticleEffects = NULL;
+	m_pTrails = NULL;
+}
+
+WeaponDefinition::~WeaponDefinition()
+{
+	for (unsigned int i = 0; i < m_vpSectionObjects.size(); i++)
+	{
+		delete m_vpSectionObjects[i];
+		m_vpSectionObjects[i] = 0;
+	}
+	m_vpSectionObjects.clear();
+}
+
+// Loading
+bool WeaponDefinition::LoadPacked(const string& fileName, unsigned long long sourceHash)
+{
+	FILE* pFile = fopen(fileName.c_str(), "rb");
+	if (pFile == NULL)
+	{
+		return false;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	if (fileSize < (long)sizeof(WeaponDefinitionHeader))
+	{
+		fclose(pFile);
+		return false;
+	}
+
+	// The whole definition in one read, the records are then used where they are
+	m_vData.resize(fileSize);
+	size_t numRead = fread(&m_vData[0], 1, fileSize, pFile);
+	fclose(pFile);
+
+	if (numRead != (size_t)fileSize || MapRecords() == false || m_pHeader->m_sourceHash != sourceHash)
+	{
+		m_vData.clear();
+		m_pHeader = NULL;
+		return false;
+	}
+
+	return true;
+}
+
+bool WeaponDefinition::Compile(const string& source, unsigned long long sourceHash)
+{
+	istringstream file(source);
+	string tempString;
+
+	WeaponDefinitionHeader header;
+	memset(&header, 0, sizeof(WeaponDefinitionHeader));
+	header.m_magic = WEAPON_DEFINITION_MAGIC;
+	header.m_version = WEAPON_DEFINITION_VERSION;
+	header.m_sourceHash = sourceHash;
+	header.m_weaponRadius = 1.0f;
+
+	file >> tempString >> header.m_renderOffset[0] >> header.m_renderOffset[1] >> header.m_renderOffset[2];
+
+	file >> tempString >> header.m_renderScale;
+
+	// Animated sections
+	file >> tempString >> header.m_numSections;
+	vector<WeaponSectionDefinition> vSections(header.m_numSections > 0 ? header.m_numSections : 0);
+	for (unsigned int i = 0; i < vSections.size(); i++)
+	{
+		WeaponSectionDefinition* pSection = &vSections[i];
+		memset(pSection, 0, sizeof(WeaponSectionDefinition));
+
+		string qubicleFile;
+		file >> tempString >> qubicleFile;
+		CopyWeaponFileName(pSection->m_fileName, qubicleFile);
+
+		file >> tempString >> pSection->m_renderScale;
+		file >> tempString >> pSection->m_renderOffset[0] >> pSection->m_renderOffset[1] >> pSection->m_renderOffset[2];
+
+		file >> tempString >> pSection->m_autoStart;
+		file >> tempString >> pSection->m_loopingAnimation;
+
+		// Translation
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackSpeed[AnimatedSectionTrack_TranslateX + axis];
+		}
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackRangeMin[AnimatedSectionTrack_TranslateX + axis] >> pSection->m_trackRangeMax[AnimatedSectionTrack_TranslateX + axis];
+		}
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackTurnSpeed[AnimatedSectionTrack_TranslateX + axis];
+		}
+
+		// Rotation
+		file >> tempString >> pSection->m_rotationPoint[0] >> pSection->m_rotationPoint[1] >> pSection->m_rotationPoint[2];
+
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackSpeed[AnimatedSectionTrack_RotationX + axis];
+		}
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackRangeMin[AnimatedSectionTrack_RotationX + axis] >> pSection->m_trackRangeMax[AnimatedSectionTrack_RotationX + axis];
+		}
+		for (int axis = 0; axis < 3; axis++)
+		{
+			file >> tempString >> pSection->m_trackTurnSpeed[AnimatedSectionTrack_RotationX + axis];
+		}
+	}
+
+	// Dynamic lights
+	file >> tempString >> header.m_numLights;
+	vector<WeaponLightDefinition> vLights(header.m_numLights > 0 ? header.m_numLights : 0);
+	for (unsigned int i = 0; i < vLights.size(); i++)
+	{
+		WeaponLightDefinition* pLight = &vLights[i];
+		memset(pLight, 0, sizeof(WeaponLightDefinition));
+
+		file >> tempString >> pLight->m_offset[0] >> pLight->m_offset[1] >> pLight->m_offset[2];
+		file >> tempString >> pLight->m_radius;
+		file >> tempString >> pLight->m_diffuseMultiplier;
+		file >> tempString >> pLight->m_colour[0] >> pLight->m_colour[1] >> pLight->m_colour[2] >> pLight->m_colour[3];
+		file >> tempString >> pLight->m_connectedToSectionIndex;
+	}
+
+	// Particle effects
+	file >> tempString >> header.m_numParticleEffects;
+	vector<WeaponParticleEffectDefinition> vParticleEffects(header.m_numParticleEffects > 0 ? header.m_numParticleEffects : 0);
+	for (unsigned int i = 0; i < vParticleEffects.size(); i++)
+	{
+		WeaponParticleEffectDefinition* pParticleEffect = &vParticleEffects[i];
+		memset(pParticleEffect, 0, sizeof(WeaponParticleEffectDefinition));
+
+		string effectFile;
+		file >> tempString >> effectFile;
+		CopyWeaponFileName(pParticleEffect->m_fileName, effectFile);
+
+		file >> tempString >> pParticleEffect->m_positionOffset[0] >> pParticleEffect->m_positionOffset[1] >> pParticleEffect->m_positionOffset[2];
+		file >> tempString >> pParticleEffect->m_connectedToSectionIndex;
+	}
+
+	// Weapon trails
+	file >> tempString >> header.m_numTrails;
+	vector<WeaponTrailDefinition> vTrails(header.m_numTrails > 0 ? header.m_numTrails : 0);
+	for (unsigned int i = 0; i < vTrails.size(); i++)
+	{
+		WeaponTrailDefinition* pTrail = &vTrails[i];
+		memset(pTrail, 0, sizeof(WeaponTrailDefinition));
+
+		file >> tempString >> pTrail->m_trailTime;
+		file >> tempString >> pTrail->m_startOffset[0] >> pTrail->m_startOffset[1] >> pTrail->m_startOffset[2];
+		file >> tempString >> pTrail->m_endOffset[0] >> pTrail->m_endOffset[1] >> pTrail->m_endOffset[2];
+		file >> tempString >> pTrail->m_colour[0] >> pTrail->m_colour[1] >> pTrail->m_colour[2];
+		file >> tempString >> pTrail->m_followOrigin;
+	}
+
+	// Gameplay
+	file >> tempString >> header.m_weaponRadius;
+
+	header.m_numSections = (int)vSections.size();
+	header.m_numLights = (int)vLights.size();
+	header.m_numParticleEffects = (int)vParticleEffects.size();
+	header.m_numTrails = (int)vTrails.size();
+
+	// Pack everything into one buffer, laid out exactly as it is written to the cache
+	m_vData.resize(GetPackedSize(header.m_numSections, header.m_numLights, header.m_numParticleEffects, header.m_numTrails));
+	unsigned char* pData = &m_vData[0];
+	memcpy(pData, &header, sizeof(WeaponDefinitionHeader));
+	pData += sizeof(WeaponDefinitionHeader);
+	if (vSections.size() > 0)
+	{
+		memcpy(pData, &vSections[0], sizeof(WeaponSectionDefinition) * vSections.size());
+		pData += sizeof(WeaponSectionDefinition) * vSections.size();
+	}
+	if (vLights.size() > 0)
+	{
+		memcpy(pData, &vLights[0], sizeof(WeaponLightDefinition) * vLights.size());
+		pData += sizeof(WeaponLightDefinition) * vLights.size();
+	}
+	if (vParticleEffects.size() > 0)
+	{
+		memcpy(pData, &vParticleEffects[0], sizeof(WeaponParticleEffectDefinition) * vParticleEffects.size());
+		pData += sizeof(WeaponParticleEffectDefinition) * vParticleEffects.size();
+	}
+	if (vTrails.size() > 0)
+	{
+		memcpy(pData, &vTrails[0], sizeof(WeaponTrailDefinition) * vTrails.size());
+	}
+
+	return MapRecords();
+}
+
+bool WeaponDefinition::SavePacked(const string& fileName)
+{
+	if (m_pHeader == NULL)
+	{
+		return false;
+	}
+
+	CacheFileBlock block = { &m_vData[0], m_vData.size() };
+	return WriteCacheFile(fileName, &block, 1);
+}
+
+// Accessors
+const string& WeaponDefinition::GetFileName() const
+{
+	return m_fileName;
+}
+
+const WeaponDefinitionHeader* WeaponDefinition::GetHeader() const
+{
+	return m_pHeader;
+}
+
+const WeaponSectionDefinition* WeaponDefinition::GetSection(int index) const
+{
+	return &m_pSections[index];
+}
+
+const WeaponLightDefinition* WeaponDefinition::GetLight(int index) const
+{
+	return &m_pLights[index];
+}
+
+const WeaponParticleEffectDefinition* WeaponDefinition::GetParticleEffect(int index) const
+{
+	return &m_pParticleEffects[index];
+}
+
+const WeaponTrailDefinition* WeaponDefinition::GetTrail(int index) const
+{
+	return &m_pTrails[index];
+}
+
+VoxelObject* WeaponDefinition::GetSectionObject(int index) const
+{
+	return m_vpSectionObjects[index];
+}
+
+int WeaponDefinition::GetDataSize() const
+{
+	return (int)m_vData.size();
+}
+
+bool WeaponDefinition::MapRecords()
+{
+	const WeaponDefinitionHeader* pHeader = (const WeaponDefinitionHeader*)&m_vData[0];
+	if (pHeader->m_magic != WEAPON_DEFINITION_MAGIC || pHeader->m_version != WEAPON_DEFINITION_VERSION ||
+		pHeader->m_numSections < 0 || pHeader->m_numLights < 0 || pHeader->m_numParticleEffects < 0 || pHeader->m_numTrails < 0 ||
+		m_vData.size() != GetPackedSize(pHeader->m_numSections, pHeader->m_numLights, pHeader->m_numParticleEffects, pHeader->m_numTrails))
+	{
+		return false;
+	}
+
+	const unsigned char* pData = &m_vData[0] + sizeof(WeaponDefinitionHeader);
+	m_pSections = (const WeaponSectionDefinition*)pData;
+	pData += sizeof(WeaponSectionDefinition) * pHeader->m_numSections;
+	m_pLights = (const WeaponLightDefinition*)pData;
+	pData += sizeof(WeaponLightDefinition) * pHeader->m_numLights;
+	m_pParticleEffects = (const WeaponParticleEffectDefinition*)pData;
+	pData += sizeof(WeaponParticleEffectDefinition) * pHeader->m_numParticleEffects;
+	m_pTrails = (const WeaponTrailDefinition*)pData;
+
+	m_pHeader = pHeader;
+
+	return true;
+}
+
+
+WeaponDefinitionRegistry::WeaponDefinitionRegistry(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
+{
+	m_pRenderer = pRenderer;
+	m_pQubicleBinaryManager = pQubicleBinaryManager;
+
+	m_numSharedLoads = 0;
+	m_numCachedLoads = 0;
+	m_numCompiledLoads = 0;
+}
+
+WeaponDefinitionRegistry::~WeaponDefinitionRegistry()
+{
+	ClearDefinitions();
+}
+
+void WeaponDefinitionRegistry::ClearDefinitions()
+{
+	for (unsigned int i = 0; i < m_vpDefinitions.size(); i++)
+	{
+		delete m_vpDefinitions[i];
+		m_vpDefinitions[i] = 0;
+	}
+	m_vpDefinitions.clear();
+}
+
+const WeaponDefinition* WeaponDefinitionRegistry::GetDefinition(const char* weaponFilename)
+{
+	for (unsigned int i = 0; i < m_vpDefinitions.size(); i++)
+	{
+		if (strcmp(m_vpDefinitions[i]->GetFileName().c_str(), weaponFilename) == 0)
+		{
+			m_numSharedLoads++;
+
+			return m_vpDefinitions[i];
+		}
+	}
+
+	WeaponDefinition* pDefinition = LoadDefinition(weaponFilename);
+	if (pDefinition == NULL)
+	{
+		return NULL;
+	}
+
+	// The section models are loaded once here, and shared by every weapon using this definition
+	for (int i = 0; i < pDefinition->GetHeader()->m_numSections; i++)
+	{
+		VoxelObject* pVoxelObject = new VoxelObject();
+		pVoxelObject->SetRenderer(m_pRenderer);
+		pVoxelObject->SetQubicleBinaryManager(m_pQubicleBinaryManager);
+		pVoxelObject->LoadObject(pDefinition->GetSection(i)->m_fileName, true);
+
+		pDefinition->m_vpSectionObjects.push_back(pVoxelObject);
+	}
+
+	m_vpDefinitions.push_back(pDefinition);
+
+	return pDefinition;
+}
+
+// Accessors
+int WeaponDefinitionRegistry::GetNumDefinitions()
+{
+	return (int)m_vpDefinitions.size();
+}
+
+int WeaponDefinitionRegistry::GetNumSharedLoads()
+{
+	return m_numSharedLoads;
+}
+
+int WeaponDefinitionRegistry::GetNumCachedLoads()
+{
+	return m_numCachedLoads;
+}
+
+int WeaponDefinitionRegistry::GetNumCompiledLoads()
+{
+	return m_numCompiledLoads;
+}
+
+int WeaponDefinitionRegistry::GetTotalDataSize()
+{
+	int totalSize = 0;
+	for (unsigned int i = 0; i < m_vpDefinitions.size(); i++)
+	{
+		totalSize += m_vpDefinitions[i]->GetDataSize();
+	}
+
+	return totalSize;
+}
+
+WeaponDefinition* WeaponDefinitionRegistry::LoadDefinition(const char* weaponFilename)
+{
+	FILE* pFile = fopen(weaponFilename, "rb");
+	if (pFile == NULL)
+	{
+		return NULL;
+	}
+
+	fseek(pFile, 0, SEEK_END);
+	long fileSize = ftell(pFile);
+	fseek(pFile, 0, SEEK_SET);
+
+	string source;
+	source.resize(fileSize > 0 ? fileSize : 0);
+	size_t numRead = fileSize > 0 ? fread(&source[0], 1, fileSize, pFile) : 0;
+	fclose(pFile);
+
+	if (numRead != source.size())
+	{
+		return NULL;
+	}
+
+	unsigned long long sourceHash = HashCacheData(source.c_str(), source.size());
+
+	char hashName[64];
+	sprintf(hashName, "/%016llx.vwpn", sourceHash);
+	string cacheFileName = string(GetWeaponDefinitionCacheDirectory()) + hashName;
+
+	WeaponDefinition* pDefinition = new WeaponDefinition();
+	pDefinition->m_fileName = weaponFilename;
+
+	// Try the packed definition first
+	if (pDefinition->LoadPacked(cacheFileName, sourceHash))
+	{
+		m_numCachedLoads++;
+
+		return pDefinition;
+	}
+
+	// Cache miss, compile the text definition and write out the packed one
+	if (pDefinition->Compile(source, sourceHash) == false)
+	{
+		delete pDefinition;
+		return NULL;
+	}
+
+	m_numCompiledLoads++;
+
+	if (createDirectory(GetWeaponDefinitionCacheDirectory()))
+	{
+		pDefinition->SavePacked(cacheFileName);
+	}
+
+	return pDefinition;
+}
+
+const char* GetWeaponDefinitionCacheDirectory()
+{
+	return "cache/weapons";
+}
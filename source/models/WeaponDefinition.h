@@ -0,0 +1,206 @@
+// ******************************************************************************
+// Filename:    WeaponDefinition.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Immutable weapon definitions, shared by every weapon carrying the same
+//   .weapon file. A text definition is compiled once into a packed binary
+//   form and written to a cache file keyed by a hash of its source, so
+//   loading it again is a single read with the records used straight from
+//   the buffer. The registry also holds one voxel object per animated
+//   section, so the section models are shared between carriers as well.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "AnimatedSectionBatch.h"
+
+#include <vector>
+#include <string>
+using namespace std;
+
+class Renderer;
+class QubicleBinaryManager;
+class VoxelObject;
+
+// Bump when the packed layout or the text parsing changes, old cache files are then ignored
+const unsigned int WEAPON_DEFINITION_VERSION = 1;
+
+const int WEAPON_DEFINITION_MAX_FILENAME = 128;
+
+// The packed records, plain data only so they can be read and written as they are
+class WeaponDefinitionHeader
+{
+public:
+	unsigned int m_magic;
+	unsigned int m_version;
+	unsigned long long m_sourceHash;
+
+	float m_renderOffset[3];
+	float m_renderScale;
+	float m_weaponRadius;
+
+	int m_numSections;
+	int m_numLights;
+	int m_numParticleEffects;
+	int m_numTrails;
+};
+
+class WeaponSectionDefinition
+{
+public:
+	char m_fileName[WEAPON_DEFINITION_MAX_FILENAME];
+	float m_renderScale;
+	float m_renderOffset[3];
+	int m_autoStart;
+	int m_loopingAnimation;
+	float m_rotationPoint[3];
+
+	// One entry per AnimatedSectionTrack
+	float m_trackSpeed[AnimatedSectionTrack_NUM];
+	float m_trackRangeMin[AnimatedSectionTrack_NUM];
+	float m_trackRangeMax[AnimatedSectionTrack_NUM];
+	float m_trackTurnSpeed[AnimatedSectionTrack_NUM];
+};
+
+class WeaponLightDefinition
+{
+public:
+	float m_offset[3];
+	float m_radius;
+	float m_diffuseMultiplier;
+	float m_colour[4];
+	int m_connectedToSectionIndex;
+};
+
+class WeaponParticleEffectDefinition
+{
+public:
+	char m_fileName[WEAPON_DEFINITION_MAX_FILENAME];
+	float m_positionOffset[3];
+	int m_connectedToSectionIndex;
+};
+
+class WeaponTrailDefinition
+{
+public:
+	float m_trailTime;
+	float m_startOffset[3];
+	float m_endOffset[3];
+	float m_colour[3];
+	int m_followOrigin;
+};
+
+class WeaponDefinition
+{
+public:
+	/* Public methods */
+	WeaponDefinition();
+	~WeaponDefinition();
+
+	// Loading
+	bool LoadPacked(const string& fileName, unsigned long long sourceHash);
+	bool Compile(const string& source, unsigned long long sourceHash);
+	bool SavePacked(const string& fileName);
+
+	// Accessors
+	const string& GetFileName() const;
+	const WeaponDefinitionHeader* GetHeader() const;
+	const WeaponSectionDefinition* GetSection(int index) const;
+	const WeaponLightDefinition* GetLight(int index) const;
+	const WeaponParticleEffectDefinition* GetParticleEffect(int index) const;
+	const WeaponTrailDefinition* GetTrail(int index) const;
+	VoxelObject* GetSectionObject(int index) const;
+	int GetDataSize() const;
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	WeaponDefinition(const WeaponDefinition&);
+	WeaponDefinition &operator=(const WeaponDefinition&);
+
+	bool MapRecords();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	string m_fileName;
+
+	// The packed definition, the header and every record array point into it
+	vector<unsigned char> m_vData;
+
+	const WeaponDefinitionHeader* m_pHeader;
+	const WeaponSectionDefinition* m_pSections;
+	const WeaponLightDefinition* m_pLights;
+	const WeaponParticleEffectDefinition* m_pParticleEffects;
+	const WeaponTrailDefinition* m_pTrails;
+
+	// Shared section models, one per animated section
+	vector<VoxelObject*> m_vpSectionObjects;
+
+	friend class WeaponDefinitionRegistry;
+};
+
+class WeaponDefinitionRegistry
+{
+public:
+	/* Public methods */
+	WeaponDefinitionRegistry(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager);
+	~WeaponDefinitionRegistry();
+
+	void ClearDefinitions();
+
+	// Returns the shared definition, compiling or loading it from the cache the first time it is asked for
+	const WeaponDefinition* GetDefinition(const char* weaponFilename);
+
+	// Accessors
+	int GetNumDefinitions();
+	int GetNumSharedLoads();
+	int GetNumCachedLoads();
+	int GetNumCompiledLoads();
+	int GetTotalDataSize();
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	WeaponDefinitionRegistry(const WeaponDefinitionRegistry&);
+	WeaponDefinitionRegistry &operator=(const WeaponDefinitionRegistry&);
+
+	WeaponDefinition* LoadDefinition(const char* weaponFilename);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	Renderer* m_pRenderer;
+	QubicleBinaryManager* m_pQubicleBinaryManager;
+
+	vector<WeaponDefinition*> m_vpDefinitions;
+
+	// Load statistics
+	int m_numSharedLoads;
+	int m_numCachedLoads;
+	int m_numCompiledLoads;
+};
+
+// The default location for cache files
+const char* GetWeaponDefinitionCacheDirectory();
@@ -11,6 +11,8 @@
 
 #include "Corridor.h"
 
+#include <math.h>
+
 
 Corridor::Corridor(Renderer* pRenderer)
 {
@@ -19,6 +21,10 @@ Corridor::Corridor(Renderer* pRenderer)
 	m_length = 0.5f;
 	m_width = 0.5f;
 	m_height = 0.5f;
+
+	m_direction = eDirection_NONE;
+
+	m_visible = true;
 }
 
 Corridor::~Corridor()
@@ -68,6 +74,25 @@ eDirection Corridor::GetDirection()
 	return m_direction;
 }
 
+// Validation
+bool Corridor::IsPointInsideCorridor(vec3 point)
+{
+	vec3 offset = point - m_position;
+
+	return fabs(offset.x) <= m_length && fabs(offset.y) <= m_height && fabs(offset.z) <= m_width;
+}
+
+// Visibility
+void Corridor::SetVisible(bool visible)
+{
+	m_visible = visible;
+}
+
+bool Corridor::IsVisible()
+{
+	return m_visible;
+}
+
 // Update
 void Corridor::Update(float dt)
 {
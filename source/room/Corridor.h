@@ -39,6 +39,13 @@ public:
 	void SetDirection(eDirection direction);
 	eDirection GetDirection();
 
+	// Validation
+	bool IsPointInsideCorridor(vec3 point);
+
+	// Visibility
+	void SetVisible(bool visible);
+	bool IsVisible();
+
 	// Update
 	void Update(float dt);
 
@@ -71,4 +78,7 @@ private:
 
 	// Corridor position
 	vec3 m_position;
+
+	// Set each frame by the room visibility pass
+	bool m_visible;
 };
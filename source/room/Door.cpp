@@ -19,6 +19,12 @@ Door::Door(Renderer* pRenderer)
 	m_length = 0.5f;
 	m_width = 0.5f;
 	m_height = 0.5f;
+
+	m_direction = eDirection_NONE;
+
+	m_pConnectedRoom = NULL;
+	m_pConnectedDoor = NULL;
+	m_pCorridor = NULL;
 }
 
 Door::~Door()
@@ -68,6 +74,49 @@ eDirection Door::GetDirection()
 	return m_direction;
 }
 
+// Connections
+void Door::SetConnection(Room* pConnectedRoom, Door* pConnectedDoor, Corridor* pCorridor)
+{
+	m_pConnectedRoom = pConnectedRoom;
+	m_pConnectedDoor = pConnectedDoor;
+	m_pCorridor = pCorridor;
+}
+
+Room* Door::GetConnectedRoom()
+{
+	return m_pConnectedRoom;
+}
+
+Door* Door::GetConnectedDoor()
+{
+	return m_pConnectedDoor;
+}
+
+Corridor* Door::GetCorridor()
+{
+	return m_pCorridor;
+}
+
+// Portal
+void Door::GetPortalCorners(vec3* pCorners)
+{
+	// The opening is the face of the door that lies in the room's wall
+	if (m_direction == eDirection_Left || m_direction == eDirection_Right)
+	{
+		pCorners[0] = m_position + vec3(0.0f, -m_height, -m_width);
+		pCorners[1] = m_position + vec3(0.0f, -m_height, m_width);
+		pCorners[2] = m_position + vec3(0.0f, m_height, m_width);
+		pCorners[3] = m_position + vec3(0.0f, m_height, -m_width);
+	}
+	else
+	{
+		pCorners[0] = m_position + vec3(-m_length, -m_height, 0.0f);
+		pCorners[1] = m_position + vec3(m_length, -m_height, 0.0f);
+		pCorners[2] = m_position + vec3(m_length, m_height, 0.0f);
+		pCorners[3] = m_position + vec3(-m_length, m_height, 0.0f);
+	}
+}
+
 // Update
 void Door::Update(float dt)
 {
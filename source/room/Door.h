@@ -30,6 +30,9 @@ enum eDirection
 	eDirection_NONE,
 };
 
+class Room;
+class Corridor;
+
 
 class Door
 {
@@ -48,6 +51,15 @@ public:
 	void SetDirection(eDirection direction);
 	eDirection GetDirection();
 
+	// Connections
+	void SetConnection(Room* pConnectedRoom, Door* pConnectedDoor, Corridor* pCorridor);
+	Room* GetConnectedRoom();
+	Door* GetConnectedDoor();
+	Corridor* GetCorridor();
+
+	// Portal
+	void GetPortalCorners(vec3* pCorners);
+
 	// Update
 	void Update(float dt);
 
@@ -80,4 +92,9 @@ private:
 
 	// Door position
 	vec3 m_position;
+
+	// The room on the other side, the door at the far end of the corridor and the corridor between them
+	Room* m_pConnectedRoom;
+	Door* m_pConnectedDoor;
+	Corridor* m_pCorridor;
 };
@@ -13,6 +13,8 @@
 #include "RoomManager.h"
 #include "../utils/Random.h"
 
+#include <math.h>
+
 
 Room::Room(Renderer* pRenderer, TileManager* pTileManager, InstanceManager* pInstanceManager, RoomManager* pRoomManager)
 {
@@ -32,6 +34,11 @@ Room::Room(Renderer* pRenderer, TileManager* pTileManager, InstanceManager* pIns
 	m_itemRoom = false;
 	m_bossRoom = false;
 
+	m_decorationBakeId = 0;
+	m_decorated = false;
+
+	m_visible = true;
+
 	UpdateRoomPlanes();
 }
 
@@ -221,7 +228,7 @@ void Room::SetRoomAbleToCreateMoreConnections(bool able)
 	m_ableToCreateConnectingRooms = able;
 }
 
-void Room::CreateDoor(eDirection direction, float randomRoomOffset)
+Door* Room::CreateDoor(eDirection direction, float randomRoomOffset)
 {
 	Door* pNewDoor = new Door(m_pRenderer);
 
@@ -260,9 +267,11 @@ void Room::CreateDoor(eDirection direction, float randomRoomOffset)
 	pNewDoor->SetDirection(direction);
 
 	m_vpDoorList.push_back(pNewDoor);
+
+	return pNewDoor;
 }
 
-void Room::CreateCorridor(eDirection direction, float corridorLengthAmount, float randomRoomOffset)
+Corridor* Room::CreateCorridor(eDirection direction, float corridorLengthAmount, float randomRoomOffset)
 {
 	Corridor* pNewCorrider = new Corridor(m_pRenderer);
 	float corridorLength;
@@ -301,31 +310,103 @@ void Room::CreateCorridor(eDirection direction, float corridorLengthAmount, floa
 	pNewCorrider->SetDirection(direction);
 
 	m_vpCorridorList.push_back(pNewCorrider);
+
+	return pNewCorrider;
 }
 
 void Room::CreateTiles()
 {
-	// Create tiles
-	for (int x = 0; x < m_length*2.0f; x++)
+	// The tile choices come from the decoration, which is baked in the background
+	int numTilesX = (int)ceil(m_length*2.0f);
+	int numTilesZ = (int)ceil(m_width*2.0f);
+	vec3 origin = m_position - vec3(m_length, m_height, m_width) + vec3(0.5f, 0.05f, 0.5f);
+
+	m_decorated = false;
+	m_decorationBakeId = m_pRoomManager->QueueDecorationBake(origin.x, origin.z, numTilesX, numTilesZ);
+}
+
+// Connections
+int Room::GetNumDoors()
+{
+	return (int)m_vpDoorList.size();
+}
+
+Door* Room::GetDoor(int index)
+{
+	return m_vpDoorList[index];
+}
+
+int Room::GetNumCorridors()
+{
+	return (int)m_vpCorridorList.size();
+}
+
+Corridor* Room::GetCorridor(int index)
+{
+	return m_vpCorridorList[index];
+}
+
+// Visibility
+void Room::SetVisible(bool visible)
+{
+	m_visible = visible;
+
+	for (unsigned int i = 0; i < m_vpTileList.size(); i++)
 	{
-		for (int z = 0; z < m_width*2.0f; z++)
-		{
-			float scale = 0.0625f;
-			vec3 tilePos = m_position;
-			tilePos -= vec3(m_length, m_height, m_width);
-			tilePos += (vec3(0.5f, 0.05f, 0.5f));
-			tilePos += vec3(x*1.0f, 0.0f, z*1.0f);
-			
-			//m_pTileManager->CreateTile(tilePos);
-
-			int numTiles = 3;
-			char tileFilename[64];
-			sprintf(tileFilename, "media/gamedata/tiles/stone_tile%i.qb", GetRandomNumber(1, numTiles));
-			//m_pInstanceManager->AddInstanceObject(tileFilename, tilePos, vec3(0.0f, 0.0f, 0.0f), scale);
-		}
+		m_vpTileList[i]->SetVisible(visible);
+	}
+
+	for (unsigned int i = 0; i < m_vpInstanceObjectList.size(); i++)
+	{
+		m_vpInstanceObjectList[i]->m_render = visible;
 	}
 }
 
+bool Room::IsVisible()
+{
+	return m_visible;
+}
+
+// Decoration
+unsigned int Room::GetDecorationBakeId()
+{
+	return m_decorationBakeId;
+}
+
+bool Room::IsDecorated()
+{
+	return m_decorated;
+}
+
+void Room::SetDecoration(const RoomDecoration& decoration)
+{
+	m_decoration = decoration;
+	m_decorated = true;
+}
+
+const RoomDecoration& Room::GetDecoration()
+{
+	return m_decoration;
+}
+
+vec3 Room::GetTilePosition(int x, int z)
+{
+	vec3 tilePos = m_position;
+	tilePos -= vec3(m_length, m_height, m_width);
+	tilePos += (vec3(0.5f, 0.05f, 0.5f));
+	tilePos += vec3(x*1.0f, 0.0f, z*1.0f);
+
+	return tilePos;
+}
+
+string Room::GetTileFilename(int x, int z)
+{
+	char tileFilename[64];
+	sprintf(tileFilename, "media/gamedata/tiles/stone_tile%i.qb", m_decoration.m_vTileVariations[z * m_decoration.m_numTilesX + x]);
+
+	return tileFilename;
+}
+
 // Update
 void Room::Update(float dt)
 {
@@ -387,7 +468,7 @@ void Room::Render()
 		{
 			m_pRenderer->ImmediateColourAlpha(1.0f, 0.0f, 0.0f, 1.0f);
 		}
-		else if (m_roomDepth >= RoomManager::MAX_ROOM_DEPTH)
+		else if (m_roomDepth >= m_pRoomManager->GetMaxRoomDepth())
 		{
 			m_pRenderer->ImmediateColourAlpha(1.0f, 1.0f, 0.0f, 1.0f);
 		}
@@ -454,6 +535,11 @@ void Room::Render()
 	{
 		Corridor *pCorridor = m_vpCorridorList[i];
 
+		if (pCorridor->IsVisible() == false)
+		{
+			continue;
+		}
+
 		pCorridor->Render();
 	}
 }
\ No newline at end of file
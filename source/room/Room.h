@@ -19,6 +19,7 @@
 #include "Door.h"
 #include "Corridor.h"
 #include "TileManager.h"
+#include "RoomDecoration.h"
 
 #include <stdio.h>
 #include <vector>
@@ -28,6 +29,9 @@ class RoomManager;
 typedef vector<Door*> DoorList;
 typedef vector<Corridor*> CorridorList;
 
+// Scale the floor tile models are placed at, a tile model is 16 voxels across
+const float ROOM_TILE_SCALE = 0.0625f;
+
 
 class Room
 {
@@ -63,10 +67,28 @@ public:
 	bool IsRoomFullOfDoors();
 	bool IsRoomAbleToCreateMoreConnections();
 	void SetRoomAbleToCreateMoreConnections(bool able);
-	void CreateDoor(eDirection direction, float randomRoomOffset);
-	void CreateCorridor(eDirection direction, float corridorLengthAmount, float randomRoomOffset);
+	Door* CreateDoor(eDirection direction, float randomRoomOffset);
+	Corridor* CreateCorridor(eDirection direction, float corridorLengthAmount, float randomRoomOffset);
 	void CreateTiles();
 
+	// Connections
+	int GetNumDoors();
+	Door* GetDoor(int index);
+	int GetNumCorridors();
+	Corridor* GetCorridor(int index);
+
+	// Visibility
+	void SetVisible(bool visible);
+	bool IsVisible();
+
+	// Decoration
+	unsigned int GetDecorationBakeId();
+	bool IsDecorated();
+	void SetDecoration(const RoomDecoration& decoration);
+	const RoomDecoration& GetDecoration();
+	vec3 GetTilePosition(int x, int z);
+	string GetTileFilename(int x, int z);
+
 	// Update
 	void Update(float dt);
 	void UpdateRoomPlanes();;
@@ -121,4 +143,16 @@ private:
 
 	// List of corridors
 	CorridorList m_vpCorridorList;
+
+	// Floor tiles and instances placed in this room, hidden along with the room
+	TileList m_vpTileList;
+	InstanceObjectList m_vpInstanceObjectList;
+
+	// Set each frame by the room visibility pass
+	bool m_visible;
+
+	// Baked decoration, filled in when the bake requested by CreateTiles() completes
+	unsigned int m_decorationBakeId;
+	bool m_decorated;
+	RoomDecoration m_decoration;
 };
\ No newline at end of file
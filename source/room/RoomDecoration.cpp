@@ -0,0 +1,281 @@
+// ******************************************************************************
+// Filename:    RoomDecoration.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "RoomDecoration.h"
+#include "../simplex/simplexbatch.h"
+#include "../utils/CacheFile.h"
+
+#include <string.h>
+
+
+RoomDecoration::RoomDecoration()
+{
+	m_numTilesX = 0;
+	m_numTilesZ = 0;
+}
+
+RoomDecorationBaker::RoomDecorationBaker()
+{
+	m_numBaking = 0;
+	m_stopping = false;
+
+	m_nextBakeId = 0;
+	m_numCacheHits = 0;
+}
+
+RoomDecorationBaker::~RoomDecorationBaker()
+{
+	Stop();
+}
+
+// Worker threads
+void RoomDecorationBaker::Start(int numThreads)
+{
+	if (m_vpWorkerThreads.empty() == false)
+	{
+		return;
+	}
+
+	m_stopping = false;
+
+	for (int i = 0; i < numThreads; i++)
+	{
+		m_vpWorkerThreads.push_back(new thread(_WorkerThread, this));
+	}
+}
+
+void RoomDecorationBaker::Stop()
+{
+	m_requestsMutex.lock();
+	m_stopping = true;
+	m_requestsCondition.notify_all();
+	m_requestsMutex.unlock();
+
+	for (unsigned int i = 0; i < m_vpWorkerThreads.size(); i++)
+	{
+		m_vpWorkerThreads[i]->join();
+		delete m_vpWorkerThreads[i];
+		m_vpWorkerThreads[i] = 0;
+	}
+	m_vpWorkerThreads.clear();
+
+	// Anything still waiting is dropped
+	m_pendingRequests.clear();
+	m_completedRequests.clear();
+}
+
+// Requests
+unsigned int RoomDecorationBaker::QueueBake(float originX, float originZ, int numTilesX, int numTilesZ)
+{
+	RoomDecorationRequest request;
+	request.m_bakeId = m_nextBakeId++;
+	request.m_originX = originX;
+	request.m_originZ = originZ;
+	request.m_numTilesX = numTilesX;
+	request.m_numTilesZ = numTilesZ;
+
+	// A room with the same placement has been baked before, hand back the cached copy
+	map<unsigned long long, RoomDecoration>::iterator iter = m_decorationCache.find(GetCacheKey(originX, originZ, numTilesX, numTilesZ));
+	if (iter != m_decorationCache.end())
+	{
+		request.m_decoration = iter->second;
+		m_numCacheHits++;
+
+		m_requestsMutex.lock();
+		m_completedRequests.push_back(request);
+		m_requestsMutex.unlock();
+
+		return request.m_bakeId;
+	}
+
+	// Without any workers the bake is done straight away
+	if (m_vpWorkerThreads.empty())
+	{
+		BakeDecoration(originX, originZ, numTilesX, numTilesZ, &request.m_decoration);
+
+		m_requestsMutex.lock();
+		m_completedRequests.push_back(request);
+		m_requestsMutex.unlock();
+
+		return request.m_bakeId;
+	}
+
+	m_requestsMutex.lock();
+	m_pendingRequests.push_back(request);
+	m_requestsCondition.notify_one();
+	m_requestsMutex.unlock();
+
+	return request.m_bakeId;
+}
+
+bool RoomDecorationBaker::PopCompleted(RoomDecorationRequest* pRequest)
+{
+	bool popped = false;
+
+	m_requestsMutex.lock();
+	if (m_completedRequests.empty() == false)
+	{
+		*pRequest = m_completedRequests.front();
+		m_completedRequests.pop_front();
+		popped = true;
+	}
+	m_requestsMutex.unlock();
+
+	if (popped)
+	{
+		if ((int)m_decorationCache.size() >= ROOM_DECORATION_CACHE_SIZE)
+		{
+			m_decorationCache.clear();
+		}
+		m_decorationCache[GetCacheKey(pRequest->m_originX, pRequest->m_originZ, pRequest->m_numTilesX, pRequest->m_numTilesZ)] = pRequest->m_decoration;
+	}
+
+	return popped;
+}
+
+int RoomDecorationBaker::GetNumOutstanding()
+{
+	m_requestsMutex.lock();
+	int numOutstanding = (int)(m_pendingRequests.size() + m_completedRequests.size()) + m_numBaking;
+	m_requestsMutex.unlock();
+
+	return numOutstanding;
+}
+
+int RoomDecorationBaker::GetNumCacheHits()
+{
+	return m_numCacheHits;
+}
+
+// Baking
+void RoomDecorationBaker::BakeDecoration(float originX, float originZ, int numTilesX, int numTilesZ, RoomDecoration* pDecoration)
+{
+	int numTiles = numTilesX * numTilesZ;
+
+	pDecoration->m_numTilesX = numTilesX;
+	pDecoration->m_numTilesZ = numTilesZ;
+	pDecoration->m_vTileVariations.resize(numTiles);
+	pDecoration->m_vColourJitter.resize(numTiles);
+
+	// Floor tile variation, low frequency so the same tile forms patches
+	vector<float> vNoise(numTiles);
+	if (numTiles > 0)
+	{
+		octave_noise_2d_block(3.0f, 0.5f, 0.15f, originX, originZ, 1.0f, 1.0f, numTilesX, numTilesZ, &vNoise[0]);
+	}
+	for (int i = 0; i < numTiles; i++)
+	{
+		int variation = (int)((vNoise[i] * 0.5f + 0.5f) * ROOM_DECORATION_NUM_TILES);
+		variation = variation < 0 ? 0 : (variation >= ROOM_DECORATION_NUM_TILES ? ROOM_DECORATION_NUM_TILES - 1 : variation);
+		pDecoration->m_vTileVariations[i] = (unsigned char)(variation + 1);
+	}
+
+	// Colour jitter, higher frequency and offset so it doesn't line up with the variation
+	if (numTiles > 0)
+	{
+		scaled_octave_noise_2d_block(2.0f, 0.5f, 0.35f, -0.05f, 0.05f, originX + 1000.0f, originZ + 1000.0f, 1.0f, 1.0f, numTilesX, numTilesZ, &pDecoration->m_vColourJitter[0]);
+	}
+
+	// Wall weathering, sampled along the perimeter at wall height
+	int numWallSegments = (numTilesX + numTilesZ) * 2;
+	pDecoration->m_vWallWeathering.resize(numWallSegments);
+
+	vector<float> vX(numWallSegments);
+	vector<float> vY(numWallSegments, 0.5f);
+	vector<float> vZ(numWallSegments);
+	int segment = 0;
+	for (int x = 0; x < numTilesX; x++, segment++)
+	{
+		vX[segment] = originX + x;
+		vZ[segment] = originZ - 1.0f;
+	}
+	for (int z = 0; z < numTilesZ; z++, segment++)
+	{
+		vX[segment] = originX + numTilesX;
+		vZ[segment] = originZ + z;
+	}
+	for (int x = numTilesX - 1; x >= 0; x--, segment++)
+	{
+		vX[segment] = originX + x;
+		vZ[segment] = originZ + numTilesZ;
+	}
+	for (int z = numTilesZ - 1; z >= 0; z--, segment++)
+	{
+		vX[segment] = originX - 1.0f;
+		vZ[segment] = originZ + z;
+	}
+
+	const float weatheringScale = 0.2f;
+	for (int i = 0; i < numWallSegments; i++)
+	{
+		vX[i] *= weatheringScale;
+		vY[i] *= weatheringScale;
+		vZ[i] *= weatheringScale;
+	}
+
+	if (numWallSegments > 0)
+	{
+		raw_noise_3d_batch(&vX[0], &vY[0], &vZ[0], numWallSegments, &pDecoration->m_vWallWeathering[0]);
+	}
+	for (int i = 0; i < numWallSegments; i++)
+	{
+		pDecoration->m_vWallWeathering[i] = pDecoration->m_vWallWeathering[i] * 0.5f + 0.5f;
+	}
+}
+
+void RoomDecorationBaker::_WorkerThread(void* pData)
+{
+	RoomDecorationBaker* pBaker = (RoomDecorationBaker*)pData;
+	pBaker->WorkerThread();
+}
+
+void RoomDecorationBaker::WorkerThread()
+{
+	while (true)
+	{
+		m_requestsMutex.lock();
+		while (m_pendingRequests.empty() && m_stopping == false)
+		{
+			m_requestsCondition.wait(m_requestsMutex);
+		}
+
+		if (m_stopping)
+		{
+			m_requestsMutex.unlock();
+			return;
+		}
+
+		RoomDecorationRequest request = m_pendingRequests.front();
+		m_pendingRequests.pop_front();
+		m_numBaking++;
+		m_requestsMutex.unlock();
+
+		// The slow part, done without holding the lock
+		BakeDecoration(request.m_originX, request.m_originZ, request.m_numTilesX, request.m_numTilesZ, &request.m_decoration);
+
+		m_requestsMutex.lock();
+		m_completedRequests.push_back(request);
+		m_numBaking--;
+		m_requestsMutex.unlock();
+	}
+}
+
+unsigned long long RoomDecorationBaker::GetCacheKey(float originX, float originZ, int numTilesX, int numTilesZ)
+{
+	unsigned int originXBits;
+	unsigned int originZBits;
+	memcpy(&originXBits, &originX, sizeof(unsigned int));
+	memcpy(&originZBits, &originZ, sizeof(unsigned int));
+
+	unsigned int values[4] = { originXBits, originZBits, (unsigned int)numTilesX, (unsigned int)numTilesZ };
+
+	return HashCacheData(values, sizeof(values));
+}
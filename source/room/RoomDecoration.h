@@ -0,0 +1,124 @@
+// ******************************************************************************
+// Filename:    RoomDecoration.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Procedural decoration data for rooms, floor tile variation, colour
+//   jitter and wall weathering, all taken from coherent noise in world
+//   space so neighbouring rooms blend together. The noise is evaluated a
+//   block at a time with the batched simplex functions, on worker threads,
+//   and finished decorations are handed back to the main thread. Results
+//   are cached by the room's placement, so regenerating the same layout
+//   doesn't bake them again. Rooms are only drawn as debug boxes for now and
+//   no floor tiles are created, so the headless report is the only reader.
+//   The game bakes the decoration but doesn't show it yet.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+#include <deque>
+#include <map>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+using namespace tthread;
+
+// The number of floor tile models a variation can pick from
+const int ROOM_DECORATION_NUM_TILES = 3;
+
+// Completed decorations kept for reuse, the cache is emptied when it grows past this
+const int ROOM_DECORATION_CACHE_SIZE = 256;
+
+// The baked decoration for one room
+class RoomDecoration
+{
+public:
+	RoomDecoration();
+
+	int m_numTilesX;
+	int m_numTilesZ;
+
+	// Per floor tile, stored row by row along x
+	vector<unsigned char> m_vTileVariations;	// 1 to ROOM_DECORATION_NUM_TILES
+	vector<float> m_vColourJitter;				// Brightness offset
+
+	// Per wall segment, clockwise around the room starting from the minimum corner, 0 to 1
+	vector<float> m_vWallWeathering;
+};
+
+// A decoration waiting to be baked, or baked and waiting to be picked up
+class RoomDecorationRequest
+{
+public:
+	unsigned int m_bakeId;
+	float m_originX;
+	float m_originZ;
+	int m_numTilesX;
+	int m_numTilesZ;
+
+	RoomDecoration m_decoration;
+};
+
+class RoomDecorationBaker
+{
+public:
+	/* Public methods */
+	RoomDecorationBaker();
+	~RoomDecorationBaker();
+
+	// Worker threads
+	void Start(int numThreads);
+	void Stop();
+
+	// Requests
+	unsigned int QueueBake(float originX, float originZ, int numTilesX, int numTilesZ);
+	bool PopCompleted(RoomDecorationRequest* pRequest);
+	int GetNumOutstanding();
+	int GetNumCacheHits();
+
+	// Baking, can also be called directly to bake on the calling thread
+	static void BakeDecoration(float originX, float originZ, int numTilesX, int numTilesZ, RoomDecoration* pDecoration);
+
+protected:
+	/* Protected methods */
+	static void _WorkerThread(void* pData);
+	void WorkerThread();
+
+private:
+	/* Private methods */
+	RoomDecorationBaker(const RoomDecorationBaker&);
+	RoomDecorationBaker &operator=(const RoomDecorationBaker&);
+
+	static unsigned long long GetCacheKey(float originX, float originZ, int numTilesX, int numTilesZ);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vector<thread*> m_vpWorkerThreads;
+
+	// Guards both queues and the stop flag
+	mutex m_requestsMutex;
+	condition_variable m_requestsCondition;
+	deque<RoomDecorationRequest> m_pendingRequests;
+	deque<RoomDecorationRequest> m_completedRequests;
+	int m_numBaking;
+	bool m_stopping;
+
+	unsigned int m_nextBakeId;
+
+	// Only touched from the main thread
+	map<unsigned long long, RoomDecoration> m_decorationCache;
+	int m_numCacheHits;
+};
@@ -16,19 +16,50 @@
 #include <algorithm>
 using namespace std;
 
-const int RoomManager::MAX_ROOM_DEPTH = 3;
-
-
 RoomManager::RoomManager(Renderer* pRenderer, TileManager* pTileManager, InstanceManager* pInstanceManager)
+	: m_roomScriptBatch(ROOM_SCRIPT_FIELDS)
 {
 	m_pRenderer = pRenderer;
 	m_pTileManager = pTileManager;
 	m_pInstanceManager = pInstanceManager;
+
+	m_numItemRooms = 0;
+	m_numBossRooms = 0;
+
+	LoadGenerationRules();
+
+	m_decorationBaker.Start(DECORATION_BAKE_THREADS);
 }
 
 RoomManager::~RoomManager()
 {
+	m_decorationBaker.Stop();
+
 	ClearRooms();
+
+	ScriptManager::GetInstance()->UnbindFunction(m_updateRoomsFunction);
+}
+
+// Generation rules
+void RoomManager::LoadGenerationRules()
+{
+	// The defaults are used for anything the script doesn't define
+	ScriptManager* pScriptManager = ScriptManager::GetInstance();
+	pScriptManager->LoadScript("media/scripts/rooms.lua");
+
+	m_minRoomSize = pScriptManager->GetNumber("RoomGeneration", "minRoomSize", 5.0f);
+	m_maxRoomSize = pScriptManager->GetNumber("RoomGeneration", "maxRoomSize", 14.0f);
+	m_minCorridorLength = pScriptManager->GetNumber("RoomGeneration", "minCorridorLength", 2.0f);
+	m_maxCorridorLength = pScriptManager->GetNumber("RoomGeneration", "maxCorridorLength", 8.0f);
+	m_maxRoomDepth = pScriptManager->GetInt("RoomGeneration", "maxRoomDepth", 3);
+	m_numDirectionTries = pScriptManager->GetInt("RoomGeneration", "numDirectionTries", 10);
+
+	m_updateRoomsFunction = pScriptManager->BindFunction("UpdateRooms");
+}
+
+int RoomManager::GetMaxRoomDepth()
+{
+	return m_maxRoomDepth;
 }
 
 // Clearing
@@ -55,6 +86,11 @@ int RoomManager::GetNumRooms()
 	return (int)m_vpRoomList.size();
 }
 
+Room* RoomManager::GetRoom(int index)
+{
+	return m_vpRoomList[index];
+}
+
 int RoomManager::GetNumConnectionRoomsPossible()
 {
 	return (int)m_vpConnectionRoomList.size();
@@ -256,8 +292,8 @@ Room* RoomManager::CreateRandomRoom(Room* pRoomConnection, eDirection connectedD
 	int numRoomTries = 0;
 	while(overlapsExistingRoom == true && numRoomTries < 1)
 	{
-		roomLength = (float)(int)(GetRandomNumber(50, 140, 2) * 0.1f);
-		roomWidth = (float)(int)(GetRandomNumber(50, 140, 2) * 0.1f);
+		roomLength = (float)(int)(GetRandomNumber((int)(m_minRoomSize * 10.0f), (int)(m_maxRoomSize * 10.0f), 2) * 0.1f);
+		roomWidth = (float)(int)(GetRandomNumber((int)(m_minRoomSize * 10.0f), (int)(m_maxRoomSize * 10.0f), 2) * 0.1f);
 		roomHeight = 1.0f;
 
 		*randomLengthOffset = GetRandomNumber(-100, 100, 2) * 0.01f;
@@ -315,7 +351,7 @@ Room* RoomManager::CreateRandomRoom(Room* pRoomConnection, eDirection connectedD
 		{
 			m_vpCanBeItemRoomList.push_back(pNewRoom);
 		}
-		if (roomDepth < MAX_ROOM_DEPTH)
+		if (roomDepth < m_maxRoomDepth)
 		{
 			m_vpConnectionRoomList.push_back(pNewRoom);
 		}
@@ -346,17 +382,17 @@ void RoomManager::CreateConnectedRoom()
 			pRoom = m_vpConnectionRoomList[randomRoomIndex];
 		}
 
-		if (pRoom != NULL && pRoom->IsRoomFullOfDoors() == false && pRoom->IsRoomAbleToCreateMoreConnections() == true && pRoom->GetRoomDepth() < MAX_ROOM_DEPTH)
+		if (pRoom != NULL && pRoom->IsRoomFullOfDoors() == false && pRoom->IsRoomAbleToCreateMoreConnections() == true && pRoom->GetRoomDepth() < m_maxRoomDepth)
 		{
 			bool canCreateRoomFromDirection = false;
 			int numDirctionTries = 0;
-			while (canCreateRoomFromDirection == false && numDirctionTries < 10)
+			while (canCreateRoomFromDirection == false && numDirctionTries < m_numDirectionTries)
 			{
 				eDirection direction = (eDirection)GetRandomNumber(0, 3);
 
 				if (pRoom->CanCreateConnection(direction))
 				{
-					float randomCorridorAmount = GetRandomNumber(10, 40, 2) * 0.2f;
+					float randomCorridorAmount = GetRandomNumber((int)(m_minCorridorLength * 5.0f), (int)(m_maxCorridorLength * 5.0f), 2) * 0.2f;
 					
 					// Create a new room, that connects to this one
 					float randomRoomOffset;
@@ -377,10 +413,15 @@ void RoomManager::CreateConnectedRoom()
 						{
 							randomLengthOffset = randomRoomOffset * (pRoom->GetWidth() - 0.5f);
 						}
-						pRoom->CreateDoor(direction, randomLengthOffset);
+						Door* pDoor = pRoom->CreateDoor(direction, randomLengthOffset);
 
 						// Create the corridor object
-						pRoom->CreateCorridor(direction, randomCorridorAmount, randomLengthOffset);
+						Corridor* pCorridor = pRoom->CreateCorridor(direction, randomCorridorAmount, randomLengthOffset);
+
+						// Link the doors at both ends of the corridor, the new room's only door is the one back to us
+						Door* pConnectedDoor = pCreatedRoom->GetDoor(0);
+						pDoor->SetConnection(pCreatedRoom, pConnectedDoor, pCorridor);
+						pConnectedDoor->SetConnection(pRoom, pDoor, pCorridor);
 
 						// Remove this room from the connection list if we become full of doors
 						if (pRoom->IsRoomFullOfDoors())
@@ -392,7 +433,7 @@ void RoomManager::CreateConnectedRoom()
 
 				numDirctionTries++;
 
-				if (numDirctionTries == 10 && canCreateRoomFromDirection == false)
+				if (numDirctionTries == m_numDirectionTries && canCreateRoomFromDirection == false)
 				{
 					// Set room unable to create more connections and remove from connection list
 					pRoom->SetRoomAbleToCreateMoreConnections(false);
@@ -486,9 +527,84 @@ void RoomManager::CreateItemRoom()
 	}
 }
 
+// Decoration
+unsigned int RoomManager::QueueDecorationBake(float originX, float originZ, int numTilesX, int numTilesZ)
+{
+	return m_decorationBaker.QueueBake(originX, originZ, numTilesX, numTilesZ);
+}
+
+void RoomManager::UpdateDecorations()
+{
+	// Completed bakes for rooms that have since been cleared are just dropped
+	RoomDecorationRequest request;
+	while (m_decorationBaker.PopCompleted(&request))
+	{
+		for (unsigned int i = 0; i < m_vpRoomList.size(); i++)
+		{
+			Room *pRoom = m_vpRoomList[i];
+
+			if (pRoom->IsDecorated() == false && pRoom->GetDecorationBakeId() == request.m_bakeId)
+			{
+				pRoom->SetDecoration(request.m_decoration);
+				break;
+			}
+		}
+	}
+}
+
+int RoomManager::GetNumDecoratedRooms()
+{
+	int numDecoratedRooms = 0;
+	for (unsigned int i = 0; i < m_vpRoomList.size(); i++)
+	{
+		if (m_vpRoomList[i]->IsDecorated())
+		{
+			numDecoratedRooms++;
+		}
+	}
+
+	return numDecoratedRooms;
+}
+
+// Visibility
+void RoomManager::UpdateVisibility(Frustum* pFrustum)
+{
+	m_roomVisibility.FindVisibleRooms(m_vpRoomList, pFrustum);
+
+	for (unsigned int i = 0; i < m_vpRoomList.size(); i++)
+	{
+		Room* pRoom = m_vpRoomList[i];
+
+		pRoom->SetVisible(false);
+		for (int j = 0; j < pRoom->GetNumCorridors(); j++)
+		{
+			pRoom->GetCorridor(j)->SetVisible(false);
+		}
+	}
+
+	const RoomList& vpVisibleRooms = m_roomVisibility.GetVisibleRooms();
+	for (unsigned int i = 0; i < vpVisibleRooms.size(); i++)
+	{
+		vpVisibleRooms[i]->SetVisible(true);
+	}
+
+	const CorridorList& vpVisibleCorridors = m_roomVisibility.GetVisibleCorridors();
+	for (unsigned int i = 0; i < vpVisibleCorridors.size(); i++)
+	{
+		vpVisibleCorridors[i]->SetVisible(true);
+	}
+}
+
+int RoomManager::GetNumVisibleRooms()
+{
+	return (int)m_roomVisibility.GetVisibleRooms().size();
+}
+
 // Update
 void RoomManager::Update(float dt)
 {
+	UpdateDecorations();
+
 	m_numItemRooms = 0;
 	m_numBossRooms = 0;
 	for (unsigned int i = 0; i < m_vpRoomList.size(); i++)
@@ -506,6 +622,23 @@ void RoomManager::Update(float dt)
 			m_numBossRooms++;
 		}
 	}
+
+	// Hand all the rooms to the script in a single call
+	if (ScriptManager::GetInstance()->IsFunctionBound(m_updateRoomsFunction))
+	{
+		m_roomScriptBatch.Clear();
+		for (unsigned int i = 0; i < m_vpRoomList.size(); i++)
+		{
+			Room *pRoom = m_vpRoomList[i];
+
+			float* pFields = m_roomScriptBatch.AddEntry(i);
+			pFields[0] = (float)pRoom->GetRoomDepth();
+			pFields[1] = pRoom->IsItemRoom() ? 1.0f : 0.0f;
+			pFields[2] = pRoom->IsBossRoom() ? 1.0f : 0.0f;
+		}
+
+		ScriptManager::GetInstance()->CallBatch(m_updateRoomsFunction, dt, &m_roomScriptBatch);
+	}
 }
 
 // Render
@@ -516,6 +649,11 @@ void RoomManager::Render()
 		{
 			Room *pRoom = m_vpRoomList[i];
 
+			if (pRoom->IsVisible() == false)
+			{
+				continue;
+			}
+
 			pRoom->Render();
 		}
 	m_pRenderer->PopMatrix();
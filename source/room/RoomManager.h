@@ -16,8 +16,11 @@
 #include "Room.h"
 #include "Corridor.h"
 #include "TileManager.h"
+#include "RoomDecoration.h"
+#include "RoomVisibility.h"
 #include "../Maths/3dmaths.h"
 #include "../Renderer/Renderer.h"
+#include "../Scripting/ScriptManager.h"
 
 #include <stdio.h>
 #include <vector>
@@ -37,8 +40,13 @@ public:
 	// Clearing
 	void ClearRooms();
 
+	// Generation rules
+	void LoadGenerationRules();
+	int GetMaxRoomDepth();
+
 	// Accessors
 	int GetNumRooms();
+	Room* GetRoom(int index);
 	int GetNumConnectionRoomsPossible();
 	int GetNumItemRooms();
 	int GetNumItemRoomsPossible();
@@ -59,6 +67,15 @@ public:
 	void CreateBossRoom();
 	void CreateItemRoom();
 
+	// Decoration
+	unsigned int QueueDecorationBake(float originX, float originZ, int numTilesX, int numTilesZ);
+	void UpdateDecorations();
+	int GetNumDecoratedRooms();
+
+	// Visibility
+	void UpdateVisibility(Frustum* pFrustum);
+	int GetNumVisibleRooms();
+
 	// Update
 	void Update(float dt);
 
@@ -73,7 +90,11 @@ private:
 
 public:
 	/* Public members */
-	static const int MAX_ROOM_DEPTH;
+	// Worker threads used to bake room decorations
+	static const int DECORATION_BAKE_THREADS = 1;
+
+	// The number of fields each room has in the per frame script batch
+	static const int ROOM_SCRIPT_FIELDS = 3;
 
 protected:
 	/* Protected members */
@@ -99,4 +120,22 @@ private:
 	// Counters for the type of rooms
 	int m_numItemRooms;
 	int m_numBossRooms;
+
+	// Generation rules, loaded from the rooms script
+	float m_minRoomSize;
+	float m_maxRoomSize;
+	float m_minCorridorLength;
+	float m_maxCorridorLength;
+	int m_maxRoomDepth;
+	int m_numDirectionTries;
+
+	// Background decoration baking
+	RoomDecorationBaker m_decorationBaker;
+
+	// Portal visibility, which rooms the camera can see this frame
+	RoomVisibility m_roomVisibility;
+
+	// Per frame script callback, called once for all the rooms
+	ScriptFunction m_updateRoomsFunction;
+	ScriptBatch m_roomScriptBatch;
 };
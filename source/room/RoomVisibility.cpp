@@ -0,0 +1,357 @@
+// ******************************************************************************
+// Filename:    RoomVisibility.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "RoomVisibility.h"
+
+#include <math.h>
+#include <algorithm>
+
+// Closer than this to a door's opening and the camera is stood in the doorway
+const float ROOM_VISIBILITY_DOORWAY_DISTANCE = 0.05f;
+
+
+RoomVisibility::RoomVisibility()
+{
+	m_usedPortals = false;
+	m_numPortalsTested = 0;
+}
+
+RoomVisibility::~RoomVisibility()
+{
+}
+
+// Visibility
+void RoomVisibility::FindVisibleRooms(const RoomList& vpRoomList, Frustum* pFrustum)
+{
+	m_vpVisibleRooms.clear();
+	m_vpVisibleCorridors.clear();
+	m_usedPortals = false;
+	m_numPortalsTested = 0;
+
+	m_cameraPosition = pFrustum->cameraPosition;
+
+	VisibilityVolume volume;
+	CreateFrustumVolume(pFrustum, &volume);
+
+	// Start from the room the camera is in
+	for (unsigned int i = 0; i < vpRoomList.size(); i++)
+	{
+		if (vpRoomList[i]->IsPointInsideRoom(m_cameraPosition))
+		{
+			m_usedPortals = true;
+			VisitRoom(vpRoomList[i], NULL, volume, 0);
+
+			return;
+		}
+	}
+
+	// Or from the corridor, looking out through the doors at both ends of it
+	for (unsigned int i = 0; i < vpRoomList.size(); i++)
+	{
+		Room* pRoom = vpRoomList[i];
+
+		for (int j = 0; j < pRoom->GetNumDoors(); j++)
+		{
+			Door* pDoor = pRoom->GetDoor(j);
+			if (pDoor->GetCorridor() == NULL || pDoor->GetCorridor()->IsPointInsideCorridor(m_cameraPosition) == false)
+			{
+				continue;
+			}
+
+			m_usedPortals = true;
+			AddVisibleCorridor(pDoor->GetCorridor());
+
+			Door* pEndDoors[2] = { pDoor, pDoor->GetConnectedDoor() };
+			Room* pEndRooms[2] = { pRoom, pDoor->GetConnectedRoom() };
+			for (int k = 0; k < 2; k++)
+			{
+				VisibilityVolume roomVolume;
+				if (NarrowThroughDoor(pEndDoors[k], volume, &roomVolume))
+				{
+					VisitRoom(pEndRooms[k], pEndDoors[k], roomVolume, 1);
+				}
+			}
+
+			return;
+		}
+	}
+
+	// Outside of the dungeon, nothing to look through
+	FindRoomsInFrustum(vpRoomList, pFrustum);
+}
+
+void RoomVisibility::FindRoomsInFrustum(const RoomList& vpRoomList, Frustum* pFrustum)
+{
+	m_vpVisibleRooms.clear();
+	m_vpVisibleCorridors.clear();
+	m_usedPortals = false;
+	m_numPortalsTested = 0;
+
+	m_cameraPosition = pFrustum->cameraPosition;
+
+	VisibilityVolume volume;
+	CreateFrustumVolume(pFrustum, &volume);
+
+	for (unsigned int i = 0; i < vpRoomList.size(); i++)
+	{
+		Room* pRoom = vpRoomList[i];
+
+		if (IsBoxInsideVolume(volume, pRoom->GetPosition(), vec3(pRoom->GetLength(), pRoom->GetHeight(), pRoom->GetWidth())))
+		{
+			AddVisibleRoom(pRoom);
+		}
+
+		for (int j = 0; j < pRoom->GetNumCorridors(); j++)
+		{
+			Corridor* pCorridor = pRoom->GetCorridor(j);
+
+			if (IsBoxInsideVolume(volume, pCorridor->GetPosition(), vec3(pCorridor->GetLength(), pCorridor->GetHeight(), pCorridor->GetWidth())))
+			{
+				AddVisibleCorridor(pCorridor);
+			}
+		}
+	}
+}
+
+// Results
+const RoomList& RoomVisibility::GetVisibleRooms()
+{
+	return m_vpVisibleRooms;
+}
+
+const CorridorList& RoomVisibility::GetVisibleCorridors()
+{
+	return m_vpVisibleCorridors;
+}
+
+bool RoomVisibility::UsedPortals()
+{
+	return m_usedPortals;
+}
+
+int RoomVisibility::GetNumPortalsTested()
+{
+	return m_numPortalsTested;
+}
+
+// Geometry
+bool RoomVisibility::IsBoxInsideVolume(const VisibilityVolume& volume, vec3 center, vec3 halfExtents)
+{
+	for (unsigned int i = 0; i < volume.m_vPlanes.size(); i++)
+	{
+		Plane3D plane = volume.m_vPlanes[i];
+
+		// Outside as soon as every corner is behind one of the planes
+		bool anyInside = false;
+		for (int corner = 0; corner < 8 && anyInside == false; corner++)
+		{
+			vec3 offset = vec3((corner & 1) ? halfExtents.x : -halfExtents.x, (corner & 2) ? halfExtents.y : -halfExtents.y, (corner & 4) ? halfExtents.z : -halfExtents.z);
+			if (plane.GetPointDistance(center + offset) >= 0.0f)
+			{
+				anyInside = true;
+			}
+		}
+
+		if (anyInside == false)
+		{
+			return false;
+		}
+	}
+
+	return true;
+}
+
+int RoomVisibility::ClipPolygon(const VisibilityVolume& volume, const vec3* pCorners, int numCorners, vec3* pClippedCorners)
+{
+	vec3 buffers[2][ROOM_VISIBILITY_MAX_CORNERS];
+	int numInput = numCorners;
+	for (int i = 0; i < numCorners; i++)
+	{
+		buffers[0][i] = pCorners[i];
+	}
+
+	int input = 0;
+	for (unsigned int i = 0; i < volume.m_vPlanes.size() && numInput > 0; i++)
+	{
+		Plane3D plane = volume.m_vPlanes[i];
+		vec3* pInput = buffers[input];
+		vec3* pOutput = buffers[1 - input];
+
+		// Keep the part of the polygon in front of the plane
+		int numOutput = 0;
+		bool overflow = false;
+		for (int j = 0; j < numInput; j++)
+		{
+			vec3 start = pInput[j];
+			vec3 end = pInput[(j + 1) % numInput];
+			float startDistance = plane.GetPointDistance(start);
+			float endDistance = plane.GetPointDistance(end);
+
+			if (numOutput + 2 > ROOM_VISIBILITY_MAX_CORNERS)
+			{
+				overflow = true;
+				break;
+			}
+
+			if (startDistance >= 0.0f)
+			{
+				pOutput[numOutput++] = start;
+			}
+			if ((startDistance >= 0.0f) != (endDistance >= 0.0f))
+			{
+				float t = startDistance / (startDistance - endDistance);
+				pOutput[numOutput++] = start + (end - start) * t;
+			}
+		}
+
+		// Too many corners to clip any further, the polygon so far is still a safe over estimate
+		if (overflow)
+		{
+			break;
+		}
+
+		numInput = numOutput;
+		input = 1 - input;
+	}
+
+	for (int i = 0; i < numInput; i++)
+	{
+		pClippedCorners[i] = buffers[input][i];
+	}
+
+	return numInput;
+}
+
+// Volumes
+void RoomVisibility::CreateFrustumVolume(Frustum* pFrustum, VisibilityVolume* pVolume)
+{
+	pVolume->m_vPlanes.clear();
+	for (int i = 0; i < 6; i++)
+	{
+		pVolume->m_vPlanes.push_back(pFrustum->planes[i]);
+	}
+
+	m_nearPlane = pFrustum->planes[Frustum::FRUSTUM_NEAR];
+	m_farPlane = pFrustum->planes[Frustum::FRUSTUM_FAR];
+}
+
+bool RoomVisibility::NarrowThroughDoor(Door* pDoor, const VisibilityVolume& volume, VisibilityVolume* pNarrowedVolume)
+{
+	m_numPortalsTested++;
+
+	vec3 corners[4];
+	pDoor->GetPortalCorners(corners);
+
+	vec3 center = (corners[0] + corners[2]) * 0.5f;
+	vec3 portalNormal = (pDoor->GetDirection() == eDirection_Left || pDoor->GetDirection() == eDirection_Right) ? vec3(1.0f, 0.0f, 0.0f) : vec3(0.0f, 0.0f, 1.0f);
+	float cameraDistance = dot(portalNormal, m_cameraPosition - center);
+
+	// Stood in the doorway, the opening doesn't narrow anything
+	if (fabs(cameraDistance) < ROOM_VISIBILITY_DOORWAY_DISTANCE)
+	{
+		*pNarrowedVolume = volume;
+		return true;
+	}
+
+	vec3 clippedCorners[ROOM_VISIBILITY_MAX_CORNERS];
+	int numClippedCorners = ClipPolygon(volume, corners, 4, clippedCorners);
+	if (numClippedCorners < 3)
+	{
+		return false;
+	}
+
+	vec3 clippedCenter(0.0f, 0.0f, 0.0f);
+	for (int i = 0; i < numClippedCorners; i++)
+	{
+		clippedCenter += clippedCorners[i];
+	}
+	clippedCenter /= (float)numClippedCorners;
+
+	pNarrowedVolume->m_vPlanes.clear();
+
+	// Only what is beyond the door
+	pNarrowedVolume->m_vPlanes.push_back(Plane3D(cameraDistance > 0.0f ? -portalNormal : portalNormal, center));
+
+	// A plane from the camera through each edge of the visible part of the opening
+	for (int i = 0; i < numClippedCorners; i++)
+	{
+		vec3 edgeNormal = cross(clippedCorners[i] - m_cameraPosition, clippedCorners[(i + 1) % numClippedCorners] - m_cameraPosition);
+		if (length(edgeNormal) < 0.000001f)
+		{
+			continue;
+		}
+
+		Plane3D edgePlane(edgeNormal, m_cameraPosition);
+		if (edgePlane.GetPointDistance(clippedCenter) < 0.0f)
+		{
+			edgePlane.mNormal = -edgePlane.mNormal;
+			edgePlane.d = -edgePlane.d;
+		}
+		pNarrowedVolume->m_vPlanes.push_back(edgePlane);
+	}
+
+	pNarrowedVolume->m_vPlanes.push_back(m_nearPlane);
+	pNarrowedVolume->m_vPlanes.push_back(m_farPlane);
+
+	return true;
+}
+
+// Traversal
+void RoomVisibility::VisitRoom(Room* pRoom, Door* pEntryDoor, const VisibilityVolume& volume, int depth)
+{
+	AddVisibleRoom(pRoom);
+
+	if (depth >= ROOM_VISIBILITY_MAX_DEPTH)
+	{
+		return;
+	}
+
+	for (int i = 0; i < pRoom->GetNumDoors(); i++)
+	{
+		Door* pDoor = pRoom->GetDoor(i);
+		if (pDoor == pEntryDoor || pDoor->GetCorridor() == NULL)
+		{
+			continue;
+		}
+
+		// Through this room's door into the corridor
+		VisibilityVolume corridorVolume;
+		if (NarrowThroughDoor(pDoor, volume, &corridorVolume) == false)
+		{
+			continue;
+		}
+		AddVisibleCorridor(pDoor->GetCorridor());
+
+		// And through the door at the far end into the next room
+		VisibilityVolume roomVolume;
+		if (NarrowThroughDoor(pDoor->GetConnectedDoor(), corridorVolume, &roomVolume) == false)
+		{
+			continue;
+		}
+		VisitRoom(pDoor->GetConnectedRoom(), pDoor->GetConnectedDoor(), roomVolume, depth + 1);
+	}
+}
+
+void RoomVisibility::AddVisibleRoom(Room* pRoom)
+{
+	if (find(m_vpVisibleRooms.begin(), m_vpVisibleRooms.end(), pRoom) == m_vpVisibleRooms.end())
+	{
+		m_vpVisibleRooms.push_back(pRoom);
+	}
+}
+
+void RoomVisibility::AddVisibleCorridor(Corridor* pCorridor)
+{
+	if (find(m_vpVisibleCorridors.begin(), m_vpVisibleCorridors.end(), pCorridor) == m_vpVisibleCorridors.end())
+	{
+		m_vpVisibleCorridors.push_back(pCorridor);
+	}
+}
@@ -0,0 +1,98 @@
+// ******************************************************************************
+// Filename:    RoomVisibility.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Portal visibility between rooms. Doors are the portals, starting from the
+//   room (or corridor) the camera is in the pass walks through every door
+//   that is inside the view, clipping the door opening against the view and
+//   narrowing the view down to what can be seen through it, then carries on
+//   into the corridor and the room on the other side. When the camera isn't
+//   inside any room or corridor, such as the overhead game camera, the rooms
+//   are just tested against the view frustum. Everything here is CPU only so
+//   it can be run against generated layouts without a GL context.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include "../Maths/3dmaths.h"
+#include "../Renderer/frustum.h"
+#include "Room.h"
+
+#include <vector>
+using namespace std;
+
+typedef vector<Room*> RoomList;
+
+// Deepest chain of doors that is followed from the camera
+const int ROOM_VISIBILITY_MAX_DEPTH = 32;
+
+// The most corners a door opening can have once it has been clipped to the view
+const int ROOM_VISIBILITY_MAX_CORNERS = 32;
+
+// A convex volume made of planes that all face inwards
+class VisibilityVolume
+{
+public:
+	vector<Plane3D> m_vPlanes;
+};
+
+
+class RoomVisibility
+{
+public:
+	/* Public methods */
+	RoomVisibility();
+	~RoomVisibility();
+
+	// Visibility
+	void FindVisibleRooms(const RoomList& vpRoomList, Frustum* pFrustum);
+	void FindRoomsInFrustum(const RoomList& vpRoomList, Frustum* pFrustum);
+
+	// Results
+	const RoomList& GetVisibleRooms();
+	const CorridorList& GetVisibleCorridors();
+	bool UsedPortals();
+	int GetNumPortalsTested();
+
+	// Geometry
+	static bool IsBoxInsideVolume(const VisibilityVolume& volume, vec3 center, vec3 halfExtents);
+	static int ClipPolygon(const VisibilityVolume& volume, const vec3* pCorners, int numCorners, vec3* pClippedCorners);
+
+protected:
+	/* Protected methods */
+
+private:
+	/* Private methods */
+	void CreateFrustumVolume(Frustum* pFrustum, VisibilityVolume* pVolume);
+	bool NarrowThroughDoor(Door* pDoor, const VisibilityVolume& volume, VisibilityVolume* pNarrowedVolume);
+	void VisitRoom(Room* pRoom, Door* pEntryDoor, const VisibilityVolume& volume, int depth);
+	void AddVisibleRoom(Room* pRoom);
+	void AddVisibleCorridor(Corridor* pCorridor);
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	vec3 m_cameraPosition;
+
+	// The near and far planes of the view, kept on every narrowed volume
+	Plane3D m_nearPlane;
+	Plane3D m_farPlane;
+
+	// Results of the last pass
+	RoomList m_vpVisibleRooms;
+	CorridorList m_vpVisibleCorridors;
+	bool m_usedPortals;
+	int m_numPortalsTested;
+};
@@ -17,22 +17,46 @@
 using namespace std;
 
 
-Tile::Tile(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
+Tile::Tile(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms)
 {
 	m_pRenderer = pRenderer;
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
+	m_pTransforms = pTransforms;
+
+	m_visible = true;
 
 	m_pTileFile = m_pQubicleBinaryManager->GetQubicleBinaryFile("media/gamedata/tiles/wood_tile.qb", false);
+	m_radius = m_pTileFile->GetBoundingRadius() * TILE_SCALE;
+
+	// The matrices never move within the tile, so their world matrices only change when the tile does
+	m_transformId = m_pTransforms->CreateNode();
+	for (int i = 0; i < m_pTileFile->GetNumMatrices(); i++)
+	{
+		int matrixTransformId = m_pTransforms->CreateNode(m_transformId);
+		m_pTransforms->SetLocalMatrix(matrixTransformId, m_pTileFile->GetMatrixLocalTransform(i));
+
+		m_vMatrixTransformIds.push_back(matrixTransformId);
+	}
+
+	SetPosition(vec3(0.0f, 0.0f, 0.0f));
 }
 
 Tile::~Tile()
 {
+	m_pTransforms->DestroyNode(m_transformId);
 }
 
 // Accessors
 void Tile::SetPosition(vec3 pos)
 {
 	m_position = pos;
+
+	// Translated into place and scaled down
+	Matrix4x4 translate;
+	translate.SetTranslation(m_position);
+	Matrix4x4 scale;
+	scale.SetScale(vec3(TILE_SCALE, TILE_SCALE, TILE_SCALE));
+	m_pTransforms->SetLocalMatrix(m_transformId, scale * translate);
 }
 
 vec3 Tile::GetPosition()
@@ -40,6 +64,22 @@ vec3 Tile::GetPosition()
 	return m_position;
 }
 
+// Visibility
+void Tile::SetVisible(bool visible)
+{
+	m_visible = visible;
+}
+
+bool Tile::IsVisible()
+{
+	return m_visible;
+}
+
+float Tile::GetRadius()
+{
+	return m_radius;
+}
+
 // Update
 void Tile::Update(float dt)
 {
@@ -48,15 +88,12 @@ void Tile::Update(float dt)
 // Render
 void Tile::Render()
 {
-	m_pRenderer->PushMatrix();
-		m_pRenderer->TranslateWorldMatrix(m_position.x, m_position.y, m_position.z);
-
-		// Scale down
-		m_pRenderer->ScaleWorldMatrix(0.03125f, 0.03125f, 0.03125f);
-
-		Colour OulineColour(1.0f, 1.0f, 0.0f, 1.0f);
-		m_pTileFile->Render(false, false, false, OulineColour);
-	m_pRenderer->PopMatrix();
+	m_pTileFile->SetLODSelection(&m_lodSelection);
+	for (unsigned int i = 0; i < m_vMatrixTransformIds.size(); i++)
+	{
+		m_pTileFile->RenderCached(i, m_pTransforms->GetWorldMatrix(m_vMatrixTransformIds[i]));
+	}
+	m_pTileFile->SetLODSelection(NULL);
 
 	//RenderDebug();
 }
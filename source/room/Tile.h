@@ -16,23 +16,32 @@
 #include "../Maths/3dmaths.h"
 #include "../Renderer/Renderer.h"
 #include "../models/modelloader.h"
+#include "../Maths/TransformHierarchy.h"
+
+// The tile model is authored at one voxel per unit and scaled down into the world
+const float TILE_SCALE = 0.03125f;
 
 
 class Tile
 {
 public:
 	/* Public methods */
-	Tile(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager);
+	Tile(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms);
 	~Tile();
 
 	// Accessors
 	void SetPosition(vec3 pos);
 	vec3 GetPosition();
 
+	// Visibility
+	void SetVisible(bool visible);
+	bool IsVisible();
+	float GetRadius();
+
 	// Update
 	void Update(float dt);
 
-	// Render
+	// Render, between the renderer's BeginCachedTransforms() and EndCachedTransforms()
     void Render();
 	void RenderDebug();
 
@@ -52,10 +61,22 @@ private:
 	/* Private members */
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
+	TransformHierarchy* m_pTransforms;
 
-	// Tile position
+	// Tile position, and the radius of a sphere around it that holds the tile
 	vec3 m_position;
+	float m_radius;
+
+	// Hidden when the room it belongs to can't be seen
+	bool m_visible;
 
 	// Qubicle binary file
 	QubicleBinary* m_pTileFile;
+
+	// LOD picked for this tile, the tile file is shared with every other tile
+	QubicleLODSelection m_lodSelection;
+
+	// Transform nodes, one for the tile and a child for each matrix in the tile file
+	int m_transformId;
+	vector<int> m_vMatrixTransformIds;
 };
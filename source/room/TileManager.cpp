@@ -17,10 +17,11 @@
 using namespace std;
 
 
-TileManager::TileManager(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager)
+TileManager::TileManager(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms)
 {
 	m_pRenderer = pRenderer;
 	m_pQubicleBinaryManager = pQubicleBinaryManager;
+	m_pTransforms = pTransforms;
 }
 
 TileManager::~TileManager()
@@ -42,7 +43,7 @@ void TileManager::ClearTiles()
 // Creation
 Tile* TileManager::CreateTile(vec3 position)
 {
-	Tile* pNewTile = new Tile(m_pRenderer, m_pQubicleBinaryManager);
+	Tile* pNewTile = new Tile(m_pRenderer, m_pQubicleBinaryManager, m_pTransforms);
 	pNewTile->SetPosition(position);
 
 	m_vpTileList.push_back(pNewTile);
@@ -50,6 +51,11 @@ Tile* TileManager::CreateTile(vec3 position)
 	return pNewTile;
 }
 
+int TileManager::GetNumTiles()
+{
+	return (int)m_vpTileList.size();
+}
+
 // Update
 void TileManager::Update(float dt)
 {
@@ -64,12 +70,38 @@ void TileManager::Update(float dt)
 // Render
 void TileManager::Render()
 {
-	m_pRenderer->PushMatrix();
+	// The tiles are drawn straight from their cached world matrices
+	m_pRenderer->BeginCachedTransforms();
+		for (unsigned int i = 0; i < m_vpTileList.size(); i++)
+		{
+			Tile *pTile = m_vpTileList[i];
+
+			if (pTile->IsVisible() == false)
+			{
+				continue;
+			}
+
+			pTile->Render();
+		}
+	m_pRenderer->EndCachedTransforms();
+}
+
+void TileManager::RenderDepthOnly(Frustum* pLightFrustum)
+{
+	// Any tile inside the light's view, a tile out of the camera's view can still cast a shadow into it
+	m_pRenderer->StartDepthOnlyRender();
+	m_pRenderer->BeginCachedTransforms();
 		for (unsigned int i = 0; i < m_vpTileList.size(); i++)
 		{
 			Tile *pTile = m_vpTileList[i];
 
+			if (pLightFrustum->SphereInFrustum(pTile->GetPosition(), pTile->GetRadius()) == Frustum::FRUSTUM_OUTSIDE)
+			{
+				continue;
+			}
+
 			pTile->Render();
 		}
-	m_pRenderer->PopMatrix();
+	m_pRenderer->EndCachedTransforms();
+	m_pRenderer->EndDepthOnlyRender();
 }
\ No newline at end of file
@@ -28,7 +28,7 @@ class TileManager
 {
 public:
 	/* Public methods */
-	TileManager(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager);
+	TileManager(Renderer* pRenderer, QubicleBinaryManager* pQubicleBinaryManager, TransformHierarchy* pTransforms);
 	~TileManager();
 
 	// Deletion
@@ -36,12 +36,14 @@ public:
 
 	// Creation
 	Tile* CreateTile(vec3 position);
+	int GetNumTiles();
 
 	// Update
 	void Update(float dt);
 
 	// Render
     void Render();
+	void RenderDepthOnly(Frustum* pLightFrustum);
 
 protected:
 	/* Protected methods */
@@ -59,6 +61,7 @@ private:
 	/* Private members */
 	Renderer* m_pRenderer;
 	QubicleBinaryManager* m_pQubicleBinaryManager;
+	TransformHierarchy* m_pTransforms;
 
 	// List of tiles
 	TileList m_vpTileList;
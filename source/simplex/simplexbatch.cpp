@@ -0,0 +1,303 @@
+// ******************************************************************************
+// Filename:    simplexbatch.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include <math.h>
+
+#include "simplexbatch.h"
+#include "simplexnoise.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SIMPLEX_BATCH_SSE2
+#include <emmintrin.h>
+#endif
+
+
+#ifdef SIMPLEX_BATCH_SSE2
+
+// The same rounding as fastfloor(), x > 0 ? (int)x : (int)x - 1
+static inline __m128i fastfloor4(const __m128 x) {
+    __m128i truncated = _mm_cvttps_epi32(x);
+    __m128i notPositive = _mm_castps_si128(_mm_cmple_ps(x, _mm_setzero_ps()));
+    return _mm_add_epi32(truncated, notPositive);
+}
+
+// Corner contribution, max(0, t)^4 * dot(g, d)
+static inline __m128 corner4(__m128 t, const __m128 dot) {
+    t = _mm_max_ps(t, _mm_setzero_ps());
+    t = _mm_mul_ps(t, t);
+    return _mm_mul_ps(_mm_mul_ps(t, t), dot);
+}
+
+// 2D raw Simplex noise, four samples at once
+static __m128 raw_noise_2d_4(const __m128 x, const __m128 y) {
+    const float F2 = 0.5f * (sqrtf(3.0f) - 1.0f);
+    const float G2 = (3.0f - sqrtf(3.0f)) / 6.0f;
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    // Skew the input space to determine which simplex cell we're in
+    __m128 s = _mm_mul_ps(_mm_add_ps(x, y), _mm_set1_ps(F2));
+    __m128i i = fastfloor4(_mm_add_ps(x, s));
+    __m128i j = fastfloor4(_mm_add_ps(y, s));
+
+    // Unskew the cell origin back to (x,y) space
+    __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(i, j)), _mm_set1_ps(G2));
+    __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+    __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+
+    // Lower or upper triangle
+    __m128 lower = _mm_cmpgt_ps(x0, y0);
+    __m128 i1 = _mm_and_ps(lower, one);
+    __m128 j1 = _mm_andnot_ps(lower, one);
+
+    __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, i1), _mm_set1_ps(G2));
+    __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, j1), _mm_set1_ps(G2));
+    __m128 x2 = _mm_add_ps(x0, _mm_set1_ps(-1.0f + 2.0f * G2));
+    __m128 y2 = _mm_add_ps(y0, _mm_set1_ps(-1.0f + 2.0f * G2));
+
+    // The hashed gradients are looked up a lane at a time
+    int ii[4], jj[4], li[4];
+    _mm_storeu_si128((__m128i*)ii, _mm_and_si128(i, _mm_set1_epi32(255)));
+    _mm_storeu_si128((__m128i*)jj, _mm_and_si128(j, _mm_set1_epi32(255)));
+    _mm_storeu_si128((__m128i*)li, _mm_castps_si128(lower));
+
+    float g0x[4], g0y[4], g1x[4], g1y[4], g2x[4], g2y[4];
+    for( int lane=0; lane < 4; lane++ ) {
+        int ii1 = li[lane] ? 1 : 0;
+        int jj1 = 1 - ii1;
+        const int* g0 = grad3[perm[ii[lane]+perm[jj[lane]]] % 12];
+        const int* g1 = grad3[perm[ii[lane]+ii1+perm[jj[lane]+jj1]] % 12];
+        const int* g2 = grad3[perm[ii[lane]+1+perm[jj[lane]+1]] % 12];
+        g0x[lane] = (float)g0[0]; g0y[lane] = (float)g0[1];
+        g1x[lane] = (float)g1[0]; g1y[lane] = (float)g1[1];
+        g2x[lane] = (float)g2[0]; g2y[lane] = (float)g2[1];
+    }
+
+    // Calculate the contribution from the three corners
+    const __m128 half = _mm_set1_ps(0.5f);
+    __m128 n0 = corner4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x0, x0)), _mm_mul_ps(y0, y0)),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(g0x), x0), _mm_mul_ps(_mm_loadu_ps(g0y), y0)));
+    __m128 n1 = corner4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x1, x1)), _mm_mul_ps(y1, y1)),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(g1x), x1), _mm_mul_ps(_mm_loadu_ps(g1y), y1)));
+    __m128 n2 = corner4(_mm_sub_ps(_mm_sub_ps(half, _mm_mul_ps(x2, x2)), _mm_mul_ps(y2, y2)),
+        _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(g2x), x2), _mm_mul_ps(_mm_loadu_ps(g2y), y2)));
+
+    return _mm_mul_ps(_mm_set1_ps(70.0f), _mm_add_ps(_mm_add_ps(n0, n1), n2));
+}
+
+// 3D raw Simplex noise, four samples at once
+static __m128 raw_noise_3d_4(const __m128 x, const __m128 y, const __m128 z) {
+    const float F3 = 1.0f / 3.0f;
+    const float G3 = 1.0f / 6.0f;
+    const __m128 one = _mm_set1_ps(1.0f);
+
+    // Skew the input space to determine which simplex cell we're in
+    __m128 s = _mm_mul_ps(_mm_add_ps(_mm_add_ps(x, y), z), _mm_set1_ps(F3));
+    __m128i i = fastfloor4(_mm_add_ps(x, s));
+    __m128i j = fastfloor4(_mm_add_ps(y, s));
+    __m128i k = fastfloor4(_mm_add_ps(z, s));
+
+    // Unskew the cell origin back to (x,y,z) space
+    __m128 t = _mm_mul_ps(_mm_cvtepi32_ps(_mm_add_epi32(_mm_add_epi32(i, j), k)), _mm_set1_ps(G3));
+    __m128 x0 = _mm_sub_ps(x, _mm_sub_ps(_mm_cvtepi32_ps(i), t));
+    __m128 y0 = _mm_sub_ps(y, _mm_sub_ps(_mm_cvtepi32_ps(j), t));
+    __m128 z0 = _mm_sub_ps(z, _mm_sub_ps(_mm_cvtepi32_ps(k), t));
+
+    // The six orderings of the scalar version, written as comparisons
+    __m128 xy = _mm_cmpge_ps(x0, y0);
+    __m128 xz = _mm_cmpge_ps(x0, z0);
+    __m128 yz = _mm_cmpge_ps(y0, z0);
+    __m128 mi1 = _mm_and_ps(xy, xz);
+    __m128 mj1 = _mm_andnot_ps(xy, yz);
+    __m128 mk1 = _mm_andnot_ps(xz, _mm_andnot_ps(yz, _mm_castsi128_ps(_mm_set1_epi32(-1))));
+    __m128 mi2 = _mm_or_ps(xy, xz);
+    __m128 mj2 = _mm_or_ps(_mm_andnot_ps(xy, _mm_castsi128_ps(_mm_set1_epi32(-1))), yz);
+    __m128 mk2 = _mm_andnot_ps(_mm_and_ps(xz, yz), _mm_castsi128_ps(_mm_set1_epi32(-1)));
+
+    __m128 x1 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(mi1, one)), _mm_set1_ps(G3));
+    __m128 y1 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(mj1, one)), _mm_set1_ps(G3));
+    __m128 z1 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(mk1, one)), _mm_set1_ps(G3));
+    __m128 x2 = _mm_add_ps(_mm_sub_ps(x0, _mm_and_ps(mi2, one)), _mm_set1_ps(2.0f * G3));
+    __m128 y2 = _mm_add_ps(_mm_sub_ps(y0, _mm_and_ps(mj2, one)), _mm_set1_ps(2.0f * G3));
+    __m128 z2 = _mm_add_ps(_mm_sub_ps(z0, _mm_and_ps(mk2, one)), _mm_set1_ps(2.0f * G3));
+    __m128 x3 = _mm_add_ps(x0, _mm_set1_ps(-1.0f + 3.0f * G3));
+    __m128 y3 = _mm_add_ps(y0, _mm_set1_ps(-1.0f + 3.0f * G3));
+    __m128 z3 = _mm_add_ps(z0, _mm_set1_ps(-1.0f + 3.0f * G3));
+
+    // The hashed gradients are looked up a lane at a time
+    int ii[4], jj[4], kk[4], o1[4], o2[4];
+    _mm_storeu_si128((__m128i*)ii, _mm_and_si128(i, _mm_set1_epi32(255)));
+    _mm_storeu_si128((__m128i*)jj, _mm_and_si128(j, _mm_set1_epi32(255)));
+    _mm_storeu_si128((__m128i*)kk, _mm_and_si128(k, _mm_set1_epi32(255)));
+    _mm_storeu_si128((__m128i*)o1, _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_castps_si128(mi1), _mm_set1_epi32(1)),
+        _mm_and_si128(_mm_castps_si128(mj1), _mm_set1_epi32(2))),
+        _mm_and_si128(_mm_castps_si128(mk1), _mm_set1_epi32(4))));
+    _mm_storeu_si128((__m128i*)o2, _mm_or_si128(_mm_or_si128(
+        _mm_and_si128(_mm_castps_si128(mi2), _mm_set1_epi32(1)),
+        _mm_and_si128(_mm_castps_si128(mj2), _mm_set1_epi32(2))),
+        _mm_and_si128(_mm_castps_si128(mk2), _mm_set1_epi32(4))));
+
+    float g[4][3][4];
+    for( int lane=0; lane < 4; lane++ ) {
+        int i1 = o1[lane] & 1, j1 = (o1[lane] >> 1) & 1, k1 = (o1[lane] >> 2) & 1;
+        int i2 = o2[lane] & 1, j2 = (o2[lane] >> 1) & 1, k2 = (o2[lane] >> 2) & 1;
+        const int* gi[4];
+        gi[0] = grad3[perm[ii[lane]+perm[jj[lane]+perm[kk[lane]]]] % 12];
+        gi[1] = grad3[perm[ii[lane]+i1+perm[jj[lane]+j1+perm[kk[lane]+k1]]] % 12];
+        gi[2] = grad3[perm[ii[lane]+i2+perm[jj[lane]+j2+perm[kk[lane]+k2]]] % 12];
+        gi[3] = grad3[perm[ii[lane]+1+perm[jj[lane]+1+perm[kk[lane]+1]]] % 12];
+        for( int c=0; c < 4; c++ ) {
+            g[c][0][lane] = (float)gi[c][0];
+            g[c][1][lane] = (float)gi[c][1];
+            g[c][2][lane] = (float)gi[c][2];
+        }
+    }
+
+    // Calculate the contribution from the four corners
+    const __m128 limit = _mm_set1_ps(0.6f);
+    const __m128 cx[4] = { x0, x1, x2, x3 };
+    const __m128 cy[4] = { y0, y1, y2, y3 };
+    const __m128 cz[4] = { z0, z1, z2, z3 };
+    __m128 total = _mm_setzero_ps();
+    for( int c=0; c < 4; c++ ) {
+        __m128 tc = _mm_sub_ps(_mm_sub_ps(_mm_sub_ps(limit, _mm_mul_ps(cx[c], cx[c])), _mm_mul_ps(cy[c], cy[c])), _mm_mul_ps(cz[c], cz[c]));
+        __m128 dot = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_loadu_ps(g[c][0]), cx[c]), _mm_mul_ps(_mm_loadu_ps(g[c][1]), cy[c])), _mm_mul_ps(_mm_loadu_ps(g[c][2]), cz[c]));
+        total = _mm_add_ps(total, corner4(tc, dot));
+    }
+
+    return _mm_mul_ps(_mm_set1_ps(32.0f), total);
+}
+
+#endif //SIMPLEX_BATCH_SSE2
+
+
+// 2D raw Simplex noise for a list of samples
+void raw_noise_2d_batch( const float* pX, const float* pY, const int count, float* pOutput ) {
+    int i = 0;
+#ifdef SIMPLEX_BATCH_SSE2
+    for( ; i + 4 <= count; i += 4 ) {
+        _mm_storeu_ps(pOutput + i, raw_noise_2d_4(_mm_loadu_ps(pX + i), _mm_loadu_ps(pY + i)));
+    }
+#endif //SIMPLEX_BATCH_SSE2
+    for( ; i < count; i++ ) {
+        pOutput[i] = raw_noise_2d(pX[i], pY[i]);
+    }
+}
+
+
+// 3D raw Simplex noise for a list of samples
+void raw_noise_3d_batch( const float* pX, const float* pY, const float* pZ, const int count, float* pOutput ) {
+    int i = 0;
+#ifdef SIMPLEX_BATCH_SSE2
+    for( ; i + 4 <= count; i += 4 ) {
+        _mm_storeu_ps(pOutput + i, raw_noise_3d_4(_mm_loadu_ps(pX + i), _mm_loadu_ps(pY + i), _mm_loadu_ps(pZ + i)));
+    }
+#endif //SIMPLEX_BATCH_SSE2
+    for( ; i < count; i++ ) {
+        pOutput[i] = raw_noise_3d(pX[i], pY[i], pZ[i]);
+    }
+}
+
+
+// 2D Multi-octave Simplex noise over a grid.
+//
+// Each group of four samples runs through all the octaves while it is in registers.
+void octave_noise_2d_block( const float octaves, const float persistence, const float scale, const float x, const float y, const float stepX, const float stepY, const int width, const int height, float* pOutput ) {
+    // The same normalisation as octave_noise_2d()
+    float maxAmplitude = 0;
+    float amplitude = 1;
+    for( int o=0; o < octaves; o++ ) {
+        maxAmplitude += amplitude;
+        amplitude *= persistence;
+    }
+
+    for( int row=0; row < height; row++ ) {
+        float sampleY = y + row * stepY;
+        float* pRow = pOutput + row * width;
+
+        int column = 0;
+#ifdef SIMPLEX_BATCH_SSE2
+        const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        for( ; column + 4 <= width; column += 4 ) {
+            __m128 sx = _mm_add_ps(_mm_set1_ps(x), _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)column), offsets), _mm_set1_ps(stepX)));
+            __m128 sy = _mm_set1_ps(sampleY);
+
+            __m128 total = _mm_setzero_ps();
+            float frequency = scale;
+            amplitude = 1;
+            for( int o=0; o < octaves; o++ ) {
+                __m128 f = _mm_set1_ps(frequency);
+                total = _mm_add_ps(total, _mm_mul_ps(raw_noise_2d_4(_mm_mul_ps(sx, f), _mm_mul_ps(sy, f)), _mm_set1_ps(amplitude)));
+                frequency *= 2;
+                amplitude *= persistence;
+            }
+
+            _mm_storeu_ps(pRow + column, _mm_div_ps(total, _mm_set1_ps(maxAmplitude)));
+        }
+#endif //SIMPLEX_BATCH_SSE2
+        for( ; column < width; column++ ) {
+            pRow[column] = octave_noise_2d(octaves, persistence, scale, x + column * stepX, sampleY);
+        }
+    }
+}
+
+
+// 3D Multi-octave Simplex noise over a grid at a fixed z.
+void octave_noise_3d_block( const float octaves, const float persistence, const float scale, const float x, const float y, const float z, const float stepX, const float stepY, const int width, const int height, float* pOutput ) {
+    float maxAmplitude = 0;
+    float amplitude = 1;
+    for( int o=0; o < octaves; o++ ) {
+        maxAmplitude += amplitude;
+        amplitude *= persistence;
+    }
+
+    for( int row=0; row < height; row++ ) {
+        float sampleY = y + row * stepY;
+        float* pRow = pOutput + row * width;
+
+        int column = 0;
+#ifdef SIMPLEX_BATCH_SSE2
+        const __m128 offsets = _mm_set_ps(3.0f, 2.0f, 1.0f, 0.0f);
+        for( ; column + 4 <= width; column += 4 ) {
+            __m128 sx = _mm_add_ps(_mm_set1_ps(x), _mm_mul_ps(_mm_add_ps(_mm_set1_ps((float)column), offsets), _mm_set1_ps(stepX)));
+            __m128 sy = _mm_set1_ps(sampleY);
+            __m128 sz = _mm_set1_ps(z);
+
+            __m128 total = _mm_setzero_ps();
+            float frequency = scale;
+            amplitude = 1;
+            for( int o=0; o < octaves; o++ ) {
+                __m128 f = _mm_set1_ps(frequency);
+                total = _mm_add_ps(total, _mm_mul_ps(raw_noise_3d_4(_mm_mul_ps(sx, f), _mm_mul_ps(sy, f), _mm_mul_ps(sz, f)), _mm_set1_ps(amplitude)));
+                frequency *= 2;
+                amplitude *= persistence;
+            }
+
+            _mm_storeu_ps(pRow + column, _mm_div_ps(total, _mm_set1_ps(maxAmplitude)));
+        }
+#endif //SIMPLEX_BATCH_SSE2
+        for( ; column < width; column++ ) {
+            pRow[column] = octave_noise_3d(octaves, persistence, scale, x + column * stepX, sampleY, z);
+        }
+    }
+}
+
+
+// 2D Scaled Multi-octave Simplex noise over a grid.
+void scaled_octave_noise_2d_block( const float octaves, const float persistence, const float scale, const float loBound, const float hiBound, const float x, const float y, const float stepX, const float stepY, const int width, const int height, float* pOutput ) {
+    octave_noise_2d_block(octaves, persistence, scale, x, y, stepX, stepY, width, height, pOutput);
+
+    float halfRange = (hiBound - loBound) / 2;
+    float centre = (hiBound + loBound) / 2;
+    for( int i=0; i < width * height; i++ ) {
+        pOutput[i] = pOutput[i] * halfRange + centre;
+    }
+}
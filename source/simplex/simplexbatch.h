@@ -0,0 +1,76 @@
+// ******************************************************************************
+// Filename:    simplexbatch.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Batched versions of the simplex noise functions. Each call evaluates a
+//   whole array or block of samples, four at a time with SSE2 where it is
+//   available, instead of one sample per call. The single sample functions in
+//   simplexnoise.h promote part of their arithmetic to double while the
+//   batches stay in float, so the results differ by a few ulps, just over
+//   1e-6 at most for raw 3D noise (1.0133e-06 in -noisebench).
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#ifndef SIMPLEX_BATCH_H_
+#define SIMPLEX_BATCH_H_
+
+
+// Raw Simplex noise for a list of sample positions, pOutput[i] is the noise at (pX[i], pY[i], ...)
+void raw_noise_2d_batch(const float* pX,
+                        const float* pY,
+                        const int count,
+                        float* pOutput);
+void raw_noise_3d_batch(const float* pX,
+                        const float* pY,
+                        const float* pZ,
+                        const int count,
+                        float* pOutput);
+
+
+// Multi-octave Simplex noise over a regular grid of samples, stored row by row.
+// Sample (column, row) is at (x + column*stepX, y + row*stepY), the 3D version keeps z fixed.
+void octave_noise_2d_block(const float octaves,
+                        const float persistence,
+                        const float scale,
+                        const float x,
+                        const float y,
+                        const float stepX,
+                        const float stepY,
+                        const int width,
+                        const int height,
+                        float* pOutput);
+void octave_noise_3d_block(const float octaves,
+                        const float persistence,
+                        const float scale,
+                        const float x,
+                        const float y,
+                        const float z,
+                        const float stepX,
+                        const float stepY,
+                        const int width,
+                        const int height,
+                        float* pOutput);
+
+
+// Scaled Multi-octave Simplex noise over a grid, the results will be between the two bounds passed.
+void scaled_octave_noise_2d_block(const float octaves,
+                        const float persistence,
+                        const float scale,
+                        const float loBound,
+                        const float hiBound,
+                        const float x,
+                        const float y,
+                        const float stepX,
+                        const float stepY,
+                        const int width,
+                        const int height,
+                        float* pOutput);
+
+
+#endif /*SIMPLEX_BATCH_H_*/
@@ -0,0 +1,89 @@
+// ******************************************************************************
+// Filename:    CacheFile.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "CacheFile.h"
+
+#include <stdio.h>
+#include <atomic>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif //_WIN32
+
+
+unsigned long long HashCacheData(const void* pData, size_t size)
+{
+	const unsigned char* pBytes = (const unsigned char*)pData;
+	unsigned long long hash = 14695981039346656037ULL;
+
+	for (size_t i = 0; i < size; i++)
+	{
+		hash ^= pBytes[i];
+		hash *= 1099511628211ULL;
+	}
+
+	return hash;
+}
+
+bool WriteCacheFile(const string& fileName, const CacheFileBlock* pBlocks, int numBlocks)
+{
+	// The process id and a counter make the temporary name unique to this writer
+	static atomic<unsigned int> s_tempFileCounter(0);
+	char tempSuffix[64];
+#ifdef _WIN32
+	sprintf(tempSuffix, ".%lu_%u.tmp", (unsigned long)GetCurrentProcessId(), s_tempFileCounter.fetch_add(1));
+#else
+	sprintf(tempSuffix, ".%lu_%u.tmp", (unsigned long)getpid(), s_tempFileCounter.fetch_add(1));
+#endif //_WIN32
+	string tempFileName = fileName + tempSuffix;
+
+	FILE* pFile = fopen(tempFileName.c_str(), "wb");
+	if (pFile == NULL)
+	{
+		return false;
+	}
+
+	bool written = true;
+	for (int i = 0; i < numBlocks && written; i++)
+	{
+		if (pBlocks[i].m_size > 0)
+		{
+			written = fwrite(pBlocks[i].m_pData, 1, pBlocks[i].m_size, pFile) == pBlocks[i].m_size;
+		}
+	}
+	written = (fclose(pFile) == 0) && written;
+
+	if (written == false)
+	{
+		remove(tempFileName.c_str());
+		return false;
+	}
+
+#ifdef _WIN32
+	// rename() will not replace an existing file on Windows
+	if (MoveFileExA(tempFileName.c_str(), fileName.c_str(), MOVEFILE_REPLACE_EXISTING) == 0)
+	{
+		remove(tempFileName.c_str());
+		return false;
+	}
+	return true;
+#else
+	// rename() atomically replaces any existing file, a reader sees either the old or the new one
+	if (rename(tempFileName.c_str(), fileName.c_str()) != 0)
+	{
+		remove(tempFileName.c_str());
+		return false;
+	}
+	return true;
+#endif //_WIN32
+}
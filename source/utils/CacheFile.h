@@ -0,0 +1,36 @@
+// ******************************************************************************
+// Filename:    CacheFile.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   Helpers shared by the on-disk caches (textures, scripts, weapon
+//   definitions and room decoration). A 64 bit FNV-1a hash for keying and
+//   validating entries, and a writer that never leaves a half written cache
+//   file where a reader can pick it up.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <string>
+using namespace std;
+
+// 64 bit FNV-1a
+unsigned long long HashCacheData(const void* pData, size_t size);
+
+// A block of bytes to write, cache files are usually a header followed by one or more payloads
+class CacheFileBlock
+{
+public:
+	const void* m_pData;
+	size_t m_size;
+};
+
+// Writes the blocks to a temporary file with a name unique to this writer, then renames it over fileName.
+// Several threads or processes can be writing the same cache file at once, the last rename wins.
+bool WriteCacheFile(const string& fileName, const CacheFileBlock* pBlocks, int numBlocks);
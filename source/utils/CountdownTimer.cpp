@@ -10,126 +10,81 @@
 // ******************************************************************************
 
 #include "CountdownTimer.h"
-#include "TimeManager.h"
 
 
 CountdownTimer::CountdownTimer()
 {
-	TimeManager::GetInstance()->AddCountdownTimer(this);
-
-	m_elapsedTime = 0.0f;
-	m_timeOutTime = 0.0f;
+	m_timer = TimeManager::GetInstance()->CreateTimer();
 
 	m_Callback = NULL;
 	m_pCallbackData = NULL;
-
-	m_bStarted = false;
-
-	m_bPaused = true;
-
-	m_bFinished = false;
 }
 
 CountdownTimer::~CountdownTimer()
 {
-	//TimeManager::GetInstance()->RemoveCountdownTimer(this);
+	TimeManager::GetInstance()->RemoveTimer(m_timer);
 }
 
 void CountdownTimer::SetCallBackFunction(FunctionCallback lFunction)
 {
 	m_Callback = lFunction;
+
+	TimeManager::GetInstance()->SetTimerCallback(m_timer, m_Callback, m_pCallbackData);
 }
 
 void CountdownTimer::SetCallBackData(void *lpData)
 {
 	m_pCallbackData = lpData;
+
+	TimeManager::GetInstance()->SetTimerCallback(m_timer, m_Callback, m_pCallbackData);
 }
 
 void CountdownTimer::StartCountdown()
 {
-	m_elapsedTime = 0.0f;
-
-	m_bPaused = false;
-
-	m_bFinished = false;
-
-	m_bStarted = true;
+	TimeManager::GetInstance()->StartTimer(m_timer);
 }
 
 void CountdownTimer::ResetCountdown()
 {
-	m_elapsedTime = 0.0f;
-
-	m_bFinished = false;
+	TimeManager::GetInstance()->ResetTimer(m_timer);
 }
 
 void CountdownTimer::PauseCountdown()
 {
-	m_bPaused = true;
+	TimeManager::GetInstance()->PauseTimer(m_timer);
 }
 
 void CountdownTimer::ResumeCountdown()
 {
-	m_bPaused = false;
+	TimeManager::GetInstance()->ResumeTimer(m_timer);
 }
 
 bool CountdownTimer::IsPaused() const
 {
-	return m_bPaused;
+	return TimeManager::GetInstance()->IsTimerPaused(m_timer);
 }
 
 float CountdownTimer::GetElapsedTime() const
 {
-	return m_elapsedTime;
+	return TimeManager::GetInstance()->GetTimerElapsedTime(m_timer);
 }
 
 float CountdownTimer::GetRemainingTime() const
 {
-	return (m_timeOutTime - m_elapsedTime);
+	return TimeManager::GetInstance()->GetTimerRemainingTime(m_timer);
 }
 
 void CountdownTimer::SetCountdownTime(float lTimeOut)
 {
-	m_timeOutTime = lTimeOut;
+	TimeManager::GetInstance()->SetTimerCountdownTime(m_timer, lTimeOut);
 }
 
 void CountdownTimer::SetLooping(bool lLoop)
 {
-	m_bLooping = lLoop;
+	TimeManager::GetInstance()->SetTimerLooping(m_timer, lLoop);
 }
 
-void CountdownTimer::UpdateCountdown(float dt)
+TimerHandle CountdownTimer::GetTimerHandle() const
 {
-	if(!m_bStarted)
-	{
-		return;
-	}
-
-	if(!m_bPaused)
-	{
-		m_elapsedTime += dt;
-	}
-
-	if(m_elapsedTime >= m_timeOutTime)
-	{
-		if(!m_bFinished)
-		{
-			// We have reached our countdown time, call our function callback
-			if(m_Callback)
-			{
-				m_Callback(m_pCallbackData);
-			}
-
-			if(m_bLooping)
-			{
-				// If we are a looping timer, then just reset the elapsed time
-				m_elapsedTime = 0.0f;
-			}
-			else
-			{
-				// We are not looping, so set our finished flag
-				m_bFinished = true;
-			}
-		}
-	}
+	return m_timer;
 }
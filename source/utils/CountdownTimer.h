@@ -8,6 +8,9 @@
 //	 countdown time specified. Can also be a looping timer so that the callback
 //	 happens every 'n' amount of time.
 //
+//   A thin wrapper around a timer handle, the timer itself lives in the
+//   TimeManager and is released when this object is deleted.
+//
 // Revision History:
 //   Initial Revision - 15/07/08
 //
@@ -16,7 +19,7 @@
 
 #pragma once
 
-typedef void(*FunctionCallback)(void *lpData);
+#include "TimeManager.h"
 
 class CountdownTimer
 {
@@ -43,7 +46,7 @@ public:
 
 	void SetLooping(bool lLoop);
 
-	void UpdateCountdown(float dt);
+	TimerHandle GetTimerHandle() const;
 
 protected:
 	/* Protected methods */
@@ -59,14 +62,7 @@ protected:
 
 private:
 	/* Private members */
-	float m_elapsedTime;
-
-	float m_timeOutTime;
-
-	bool m_bStarted;
-	bool m_bLooping;
-	bool m_bPaused;
-	bool m_bFinished;
+	TimerHandle m_timer;
 
 	FunctionCallback m_Callback;
 	void *m_pCallbackData;
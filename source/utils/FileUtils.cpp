@@ -15,6 +15,7 @@
 #include <windows.h>
 #elif __linux__
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <dirent.h>
 #include <errno.h>
 #include <vector>
@@ -97,3 +98,135 @@ vector<string> listFilesInDirectory(string directoryName)
 	return listFileNames;
 #endif //_WIN32
 }
+
+// Returns the paths of all the files under the directory (and its sub folders) with the given extension, e.g. ".tga"
+vector<string> listFilesInDirectoryRecursive(string directoryName, string extension)
+{
+	vector<string> listFileNames;
+	vector<string> directories;
+	directories.push_back(directoryName);
+
+	while (directories.empty() == false)
+	{
+		string directory = directories.back();
+		directories.pop_back();
+
+#ifdef _WIN32
+		WIN32_FIND_DATAA FindFileData;
+		string searchPath = directory + "\\*";
+		HANDLE hFind = FindFirstFileA(searchPath.c_str(), &FindFileData);
+		if (hFind == INVALID_HANDLE_VALUE)
+		{
+			continue;
+		}
+
+		do
+		{
+			string fileName = FindFileData.cFileName;
+			if (fileName == "." || fileName == "..")
+			{
+				continue;
+			}
+
+			string path = directory + "/" + fileName;
+			if (FindFileData.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY)
+			{
+				directories.push_back(path);
+			}
+			else if (fileName.length() >= extension.length() && fileName.compare(fileName.length() - extension.length(), extension.length(), extension) == 0)
+			{
+				listFileNames.push_back(path);
+			}
+		} while (FindNextFileA(hFind, &FindFileData));
+
+		FindClose(hFind);
+#elif __linux__
+		DIR *dp = opendir(directory.c_str());
+		if (dp == NULL)
+		{
+			continue;
+		}
+
+		struct dirent *dirp;
+		while ((dirp = readdir(dp)) != NULL)
+		{
+			string fileName = dirp->d_name;
+			if (fileName == "." || fileName == "..")
+			{
+				continue;
+			}
+
+			string path = directory + "/" + fileName;
+			struct stat fileStat;
+			if (stat(path.c_str(), &fileStat) != 0)
+			{
+				continue;
+			}
+
+			if (S_ISDIR(fileStat.st_mode))
+			{
+				directories.push_back(path);
+			}
+			else if (fileName.length() >= extension.length() && fileName.compare(fileName.length() - extension.length(), extension.length(), extension) == 0)
+			{
+				listFileNames.push_back(path);
+			}
+		}
+
+		closedir(dp);
+#endif //_WIN32
+	}
+
+	return listFileNames;
+}
+
+// Creates the directory, and any missing parent directories. Returns true if the directory exists afterwards.
+bool createDirectory(string directoryName)
+{
+	for (unsigned int i = 1; i <= directoryName.length(); i++)
+	{
+		if (i == directoryName.length() || directoryName[i] == '/' || directoryName[i] == '\\')
+		{
+			string path = directoryName.substr(0, i);
+#ifdef _WIN32
+			CreateDirectoryA(path.c_str(), NULL);
+#elif __linux__
+			mkdir(path.c_str(), 0755);
+#endif //_WIN32
+		}
+	}
+
+#ifdef _WIN32
+	DWORD attributes = GetFileAttributesA(directoryName.c_str());
+	return (attributes != INVALID_FILE_ATTRIBUTES) && (attributes & FILE_ATTRIBUTE_DIRECTORY);
+#elif __linux__
+	struct stat fileStat;
+	return stat(directoryName.c_str(), &fileStat) == 0 && S_ISDIR(fileStat.st_mode);
+#endif //_WIN32
+}
+
+// The size and last write time of a file, without opening it
+bool getFileStamp(string fileName, unsigned long long *pSize, unsigned long long *pModifiedTime)
+{
+#ifdef _WIN32
+	WIN32_FILE_ATTRIBUTE_DATA attributes;
+	if (GetFileAttributesExA(fileName.c_str(), GetFileExInfoStandard, &attributes) == FALSE)
+	{
+		return false;
+	}
+
+	*pSize = ((unsigned long long)attributes.nFileSizeHigh << 32) | attributes.nFileSizeLow;
+	*pModifiedTime = ((unsigned long long)attributes.ftLastWriteTime.dwHighDateTime << 32) | attributes.ftLastWriteTime.dwLowDateTime;
+#elif __linux__
+	struct stat fileStat;
+	if (stat(fileName.c_str(), &fileStat) != 0)
+	{
+		return false;
+	}
+
+	*pSize = (unsigned long long)fileStat.st_size;
+	*pModifiedTime = ((unsigned long long)fileStat.st_mtim.tv_sec * 1000000000ULL) + (unsigned long long)fileStat.st_mtim.tv_nsec;
+#endif //_WIN32
+
+	return true;
+}
@@ -23,6 +23,7 @@ using namespace std;
 #include <windows.h>
 #elif __linux__
 #include <sys/types.h>
+#include <sys/stat.h>
 #include <dirent.h>
 #include <errno.h>
 #define fopen_s(pFile,filename,mode) ((*(pFile))=fopen((filename),(mode)))==NULL
@@ -31,3 +32,6 @@ using namespace std;
 string wchar_t2string(const wchar_t *wchar);
 wchar_t *string2wchar_t(const string &str);
 vector<string> listFilesInDirectory(string directoryName);
+vector<string> listFilesInDirectoryRecursive(string directoryName, string extension);
+bool createDirectory(string directoryName);
+bool getFileStamp(string fileName, unsigned long long *pSize, unsigned long long *pModifiedTime);
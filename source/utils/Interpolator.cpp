@@ -11,10 +11,7 @@
 
 #include "Interpolator.h"
 
-#include "../Maths/3dGeometry.h"
-
 #include <stdio.h>
-#include <algorithm>
 
 #pragma comment (lib, "Winmm.lib")
 
@@ -37,6 +34,7 @@ void Interpolator::Destroy()
 		ClearInterpolators();
 
 		delete c_instance;
+		c_instance = 0;
 	}
 }
 
@@ -47,521 +45,407 @@ Interpolator::Interpolator()
 
 void Interpolator::ClearInterpolators()
 {
-	// Float
-	for(unsigned int i = 0; i < m_vpFloatInterpolations.size(); i++)
+	// Bump every generation so any handles still held by callers become stale
+	m_vFreeSlots.clear();
+	for(unsigned int i = 0; i < m_vSlots.size(); i++)
 	{
-		FloatInterpolation* lpNext = m_vpFloatInterpolations[i]->m_pNextInterpolation;
-		while(lpNext != NULL)
+		InterpolationSlot* pSlot = &m_vSlots[i];
+		if(pSlot->m_state != InterpolationState_Free)
 		{
-			FloatInterpolation* lpThisOne = lpNext;
-			lpNext = lpNext->m_pNextInterpolation;
-			
-			if(lpThisOne->m_variable != 0)
-			{
-				delete lpThisOne;
-				lpThisOne->m_variable = 0;
-				lpThisOne->m_pNextInterpolation = 0;
-				lpThisOne = 0;
-			}
-		}
-
-		if(m_vpFloatInterpolations[i]->m_variable != 0)
-		{
-			delete m_vpFloatInterpolations[i];
-			m_vpFloatInterpolations[i]->m_variable = 0;
-			m_vpFloatInterpolations[i]->m_pNextInterpolation = 0;
-			m_vpFloatInterpolations[i] = 0;
+			pSlot->m_generation = (pSlot->m_generation + 1) & GENERATION_MASK;
+			pSlot->m_state = InterpolationState_Free;
 		}
+		m_vFreeSlots.push_back(m_vSlots.size() - 1 - i);
 	}
-	m_vpFloatInterpolations.clear();
 
-	for(unsigned int i = 0; i < m_vpCreateFloatInterpolations.size(); i++)
-	{
-		FloatInterpolation* lpNext = m_vpCreateFloatInterpolations[i]->m_pNextInterpolation;
-		while(lpNext != NULL)
-		{
-			FloatInterpolation* lpThisOne = lpNext;
-			lpNext = lpNext->m_pNextInterpolation;
-
-			if(lpThisOne->m_variable != 0)
-			{
-				delete lpThisOne;
-				lpThisOne->m_variable = 0;
-				lpThisOne->m_pNextInterpolation = 0;
-				lpThisOne = 0;
-			}
-		}
+	m_variableSlots.clear();
+	m_vPendingInterpolations.clear();
+	m_floatBatch.Clear();
+	m_intBatch.Clear();
+	m_vFinishedSlots.clear();
+}
 
-		if(m_vpCreateFloatInterpolations[i]->m_variable != 0)
-		{
-			delete m_vpCreateFloatInterpolations[i];
-			m_vpCreateFloatInterpolations[i]->m_variable = 0;
-			m_vpCreateFloatInterpolations[i]->m_pNextInterpolation = 0;
-			m_vpCreateFloatInterpolations[i] = 0;
-		}
-	}
-	m_vpCreateFloatInterpolations.clear();
+InterpolationHandle Interpolator::CreateFloatInterpolation(float *val, float start, float end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData)
+{
+	return CreateInterpolation(InterpolationType_Float, val, start, end, time, easing, aNext, aCallback, aData);
+}
 
-	// Int
-	for(unsigned int i = 0; i < m_vpIntInterpolations.size(); i++)
-	{
-		IntInterpolation* lpNext = m_vpIntInterpolations[i]->m_pNextInterpolation;
-		while(lpNext != NULL)
-		{
-			IntInterpolation* lpThisOne = lpNext;
-			lpNext = lpNext->m_pNextInterpolation;
-
-			if(lpThisOne->m_variable != 0)
-			{
-				delete lpThisOne;
-				lpThisOne->m_variable = 0;
-				lpThisOne->m_pNextInterpolation = 0;
-				lpThisOne = 0;
-			}
-		}
+void Interpolator::LinkFloatInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond)
+{
+	LinkInterpolation(aFirst, aSecond);
+}
 
-		if(m_vpIntInterpolations[i]->m_variable != 0)
-		{
-			delete m_vpIntInterpolations[i];
-			m_vpIntInterpolations[i]->m_variable = 0;
-			m_vpIntInterpolations[i]->m_pNextInterpolation = 0;
-			m_vpIntInterpolations[i] = 0;
-		}
-	}
-	m_vpIntInterpolations.clear();
+void Interpolator::AddFloatInterpolation(InterpolationHandle aInterpolation)
+{
+	AddInterpolation(aInterpolation);
+}
 
-	for(unsigned int i = 0; i < m_vpCreateIntInterpolations.size(); i++)
-	{
-		IntInterpolation* lpNext = m_vpCreateIntInterpolations[i]->m_pNextInterpolation;
-		while(lpNext != NULL)
-		{
-			IntInterpolation* lpThisOne = lpNext;
-			lpNext = lpNext->m_pNextInterpolation;
-
-			if(lpThisOne->m_variable != 0)
-			{
-				delete lpThisOne;
-				lpThisOne->m_variable = 0;
-				lpThisOne->m_pNextInterpolation = 0;
-				lpThisOne = 0;
-			}
-		}
+InterpolationHandle Interpolator::AddFloatInterpolation(float *val, float start, float end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData)
+{
+	InterpolationHandle floatInterp = CreateFloatInterpolation(val, start, end, time, easing, aNext, aCallback, aData);
 
-		if(m_vpCreateIntInterpolations[i]->m_variable != 0)
-		{
-			delete m_vpCreateIntInterpolations[i];
-			m_vpCreateIntInterpolations[i]->m_variable = 0;
-			m_vpCreateIntInterpolations[i]->m_pNextInterpolation = 0;
-			m_vpCreateIntInterpolations[i] = 0;
-		}
-	}
-	m_vpCreateIntInterpolations.clear();
+	AddInterpolation(floatInterp);
+
+	return floatInterp;
 }
 
-FloatInterpolation* Interpolator::CreateFloatInterpolation(float *val, float start, float end, float time, float easing, FloatInterpolation* aNext, FunctionCallback aCallback, void *aData)
+void Interpolator::RemoveFloatInterpolation(InterpolationHandle aInterpolation)
 {
-	FloatInterpolation* floatInterp = new FloatInterpolation();
-	floatInterp->m_variable = val;
-	floatInterp->m_start = start;
-	floatInterp->m_end = end;
-	floatInterp->m_time = time;
+	RemoveInterpolation(aInterpolation);
+}
 
-	floatInterp->m_easing = easing;
+void Interpolator::RemoveFloatInterpolationByVariable(float *val)
+{
+	RemoveInterpolationsByVariable(val);
+}
 
-	floatInterp->m_pNextInterpolation = aNext;
+InterpolationHandle Interpolator::CreateIntInterpolation(int *val, int start, int end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData)
+{
+	return CreateInterpolation(InterpolationType_Int, val, (float)start, (float)end, time, easing, aNext, aCallback, aData);
+}
 
-	floatInterp->m_elapsed = 0.0f;
-	floatInterp->m_erase = false;
+void Interpolator::LinkIntInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond)
+{
+	LinkInterpolation(aFirst, aSecond);
+}
 
-	floatInterp->m_Callback = aCallback;
-	floatInterp->m_pCallbackData = aData;
+void Interpolator::AddIntInterpolation(InterpolationHandle aInterpolation)
+{
+	AddInterpolation(aInterpolation);
+}
 
-	return floatInterp;
+InterpolationHandle Interpolator::AddIntInterpolation(int *val, int start, int end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData)
+{
+	InterpolationHandle intInterp = CreateIntInterpolation(val, start, end, time, easing, aNext, aCallback, aData);
+
+	AddInterpolation(intInterp);
+
+	return intInterp;
 }
 
-void Interpolator::LinkFloatInterpolation(FloatInterpolation* aFirst, FloatInterpolation* aSecond)
+void Interpolator::RemoveIntInterpolation(InterpolationHandle aInterpolation)
 {
-	aFirst->m_pNextInterpolation = aSecond;
+	RemoveInterpolation(aInterpolation);
 }
 
-void Interpolator::AddFloatInterpolation(FloatInterpolation* aInterpolation)
+void Interpolator::RemoveIntInterpolationByVariable(int *val)
 {
-	// Reset the elapsed time
-	aInterpolation->m_elapsed = 0.0f;
+	RemoveInterpolationsByVariable(val);
+}
 
-	// Rest the erase flag
-	aInterpolation->m_erase = false;
+bool Interpolator::IsInterpolating(InterpolationHandle aInterpolation) const
+{
+	const InterpolationSlot* pSlot = FindSlot(aInterpolation);
 
-	m_vpCreateFloatInterpolations.push_back(aInterpolation);
+	return (pSlot != NULL && (pSlot->m_state == InterpolationState_Pending || pSlot->m_state == InterpolationState_Running));
 }
 
-void Interpolator::AddFloatInterpolation(float *val, float start, float end, float time, float easing, FloatInterpolation* aNext, FunctionCallback aCallback, void *aData)
+int Interpolator::GetNumRunningInterpolations() const
 {
-	FloatInterpolation* floatInterp = CreateFloatInterpolation(val, start, end, time, easing, aNext, aCallback, aData);
-
-	AddFloatInterpolation(floatInterp);
+	return m_floatBatch.GetSize() + m_intBatch.GetSize();
 }
 
-void Interpolator::RemoveCreateFloatInterpolation(FloatInterpolation* aInterpolation)
+void Interpolator::SetPaused(bool pause)
 {
-	m_vpCreateFloatInterpolations.erase(std::remove(m_vpCreateFloatInterpolations.begin(), m_vpCreateFloatInterpolations.end(), aInterpolation), m_vpCreateFloatInterpolations.end());
+	m_paused = pause;
 }
 
-void Interpolator::RemoveFloatInterpolation(FloatInterpolation* aInterpolation)
+bool Interpolator::IsPaused()
 {
-	m_vpFloatInterpolations.erase(std::remove(m_vpFloatInterpolations.begin(), m_vpFloatInterpolations.end(), aInterpolation), m_vpFloatInterpolations.end());
+	return m_paused;
 }
 
-void Interpolator::RemoveFloatInterpolationByVariable(float *val)
+void Interpolator::Update(float dt)
 {
-	// Creation list
-	FloatInterpolationList l_vpRemoveCreateFloatInterpolations;
-	for(unsigned int i = 0; i < (int)m_vpCreateFloatInterpolations.size(); i++)
+	// Start any interpolations that were added since the last update
+	for(unsigned int i = 0; i < m_vPendingInterpolations.size(); i++)
 	{
-		FloatInterpolation* pInterpolator = m_vpCreateFloatInterpolations[i];
-		if(pInterpolator->m_variable == val)
+		InterpolationSlot* pSlot = FindSlot(m_vPendingInterpolations[i]);
+		if(pSlot != NULL && pSlot->m_state == InterpolationState_Pending)
 		{
-			l_vpRemoveCreateFloatInterpolations.push_back(pInterpolator);
+			StartInterpolation(m_vPendingInterpolations[i] & INDEX_MASK);
 		}
 	}
-	for(unsigned int i = 0; i < (int)l_vpRemoveCreateFloatInterpolations.size(); i++)
+	m_vPendingInterpolations.clear();
+
+	if(m_paused == true)
 	{
-		RemoveCreateFloatInterpolation(l_vpRemoveCreateFloatInterpolations[i]);
+		return;
 	}
 
+	// Evaluate every running interpolation in one pass per type
+	m_vFinishedSlots.clear();
+	m_floatBatch.Evaluate(dt, m_vFinishedSlots);
+	m_intBatch.Evaluate(dt, m_vFinishedSlots);
 
-	// Normal list
-	FloatInterpolationList l_vpRemoveFloatInterpolations;
-	for(unsigned int i = 0; i < (int)m_vpFloatInterpolations.size(); i++)
-	{
-		FloatInterpolation* pInterpolator = m_vpFloatInterpolations[i];
-		if(pInterpolator->m_variable == val)
-		{
-			l_vpRemoveFloatInterpolations.push_back(pInterpolator);
-		}
-	}
-	for(unsigned int i = 0; i < (int)l_vpRemoveFloatInterpolations.size(); i++)
+	// Only the ones that finished need any more work, callbacks are free to add or remove interpolations
+	for(unsigned int i = 0; i < m_vFinishedSlots.size(); i++)
 	{
-		RemoveFloatInterpolation(l_vpRemoveFloatInterpolations[i]);
+		FinishInterpolation(m_vFinishedSlots[i]);
 	}
 }
 
-IntInterpolation* Interpolator::CreateIntInterpolation(int *val, int start, int end, float time, float easing, IntInterpolation* aNext, FunctionCallback aCallback, void *aData)
+InterpolationHandle Interpolator::CreateInterpolation(InterpolationType type, void *val, float start, float end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData)
 {
-	IntInterpolation* intInterp = new IntInterpolation();
-	intInterp->m_variable = val;
-	intInterp->m_start = start;
-	intInterp->m_end = end;
-	intInterp->m_time = time;
-
-	intInterp->m_easing = easing;
-
-	intInterp->m_pNextInterpolation = aNext;
+	unsigned int index;
+	if(m_vFreeSlots.empty() == false)
+	{
+		index = m_vFreeSlots.back();
+		m_vFreeSlots.pop_back();
+	}
+	else
+	{
+		// The last index is never handed out, so a valid handle can never equal INVALID_INTERPOLATION
+		if(m_vSlots.size() >= INDEX_MASK)
+		{
+			return INVALID_INTERPOLATION;
+		}
 
-	intInterp->m_elapsed = 0.0f;
-	intInterp->m_erase = false;
+		index = (unsigned int)m_vSlots.size();
+		InterpolationSlot newSlot;
+		newSlot.m_generation = 0;
+		newSlot.m_state = InterpolationState_Free;
+		m_vSlots.push_back(newSlot);
+	}
 
-	intInterp->m_Callback = aCallback;
-	intInterp->m_pCallbackData = aData;
+	InterpolationSlot* pSlot = &m_vSlots[index];
+	pSlot->m_state = InterpolationState_Created;
+	pSlot->m_type = type;
+	pSlot->m_batchIndex = -1;
+	pSlot->m_variable = val;
+	pSlot->m_start = start;
+	pSlot->m_end = end;
+	pSlot->m_time = time;
+	pSlot->m_easing = easing;
+	pSlot->m_next = aNext;
+	pSlot->m_Callback = aCallback;
+	pSlot->m_pCallbackData = aData;
+
+	// Push onto the front of this variable's list
+	pSlot->m_prevByVariable = -1;
+	pSlot->m_nextByVariable = -1;
+	unordered_map<void*, int>::iterator variableIterator = m_variableSlots.find(val);
+	if(variableIterator != m_variableSlots.end())
+	{
+		pSlot->m_nextByVariable = variableIterator->second;
+		m_vSlots[variableIterator->second].m_prevByVariable = (int)index;
+		variableIterator->second = (int)index;
+	}
+	else
+	{
+		m_variableSlots[val] = (int)index;
+	}
 
-	return intInterp;
+	return GetHandle(index);
 }
 
-void Interpolator::LinkIntInterpolation(IntInterpolation* aFirst, IntInterpolation* aSecond)
+void Interpolator::LinkInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond)
 {
-	aFirst->m_pNextInterpolation = aSecond;
+	InterpolationSlot* pSlot = FindSlot(aFirst);
+	if(pSlot != NULL)
+	{
+		pSlot->m_next = aSecond;
+	}
 }
 
-void Interpolator::AddIntInterpolation(IntInterpolation* aInterpolation)
+void Interpolator::AddInterpolation(InterpolationHandle aInterpolation)
 {
-	// Reset the elapsed time
-	aInterpolation->m_elapsed = 0.0f;
-
-	// Rest the erase flag
-	aInterpolation->m_erase = false;
+	InterpolationSlot* pSlot = FindSlot(aInterpolation);
+	if(pSlot == NULL || pSlot->m_state != InterpolationState_Created)
+	{
+		return;
+	}
 
-	m_vpCreateIntInterpolations.push_back(aInterpolation);
+	pSlot->m_state = InterpolationState_Pending;
+	m_vPendingInterpolations.push_back(aInterpolation);
 }
 
-void Interpolator::AddIntInterpolation(int *val, int start, int end, float time, float easing, IntInterpolation* aNext, FunctionCallback aCallback, void *aData)
+void Interpolator::RemoveInterpolation(InterpolationHandle aInterpolation)
 {
-	IntInterpolation* intInterp = CreateIntInterpolation(val, start, end, time, easing, aNext, aCallback, aData);
+	InterpolationSlot* pSlot = FindSlot(aInterpolation);
+	if(pSlot == NULL)
+	{
+		return;
+	}
 
-	AddIntInterpolation(intInterp);
-}
+	unsigned int index = aInterpolation & INDEX_MASK;
+	InterpolationHandle next = pSlot->m_next;
 
-void Interpolator::RemoveCreateIntInterpolation(IntInterpolation* aInterpolation)
-{
-	m_vpCreateIntInterpolations.erase(std::remove(m_vpCreateIntInterpolations.begin(), m_vpCreateIntInterpolations.end(), aInterpolation), m_vpCreateIntInterpolations.end());
-}
+	FreeSlot(index);
 
-void Interpolator::RemoveIntInterpolation(IntInterpolation* aInterpolation)
-{
-	m_vpIntInterpolations.erase(std::remove(m_vpIntInterpolations.begin(), m_vpIntInterpolations.end(), aInterpolation), m_vpIntInterpolations.end());
+	// The rest of the chain can never start now, so release any links that are still waiting
+	InterpolationSlot* pNextSlot = FindSlot(next);
+	while(pNextSlot != NULL && pNextSlot->m_state == InterpolationState_Created)
+	{
+		unsigned int nextIndex = next & INDEX_MASK;
+		next = pNextSlot->m_next;
+
+		FreeSlot(nextIndex);
+
+		pNextSlot = FindSlot(next);
+	}
 }
 
-void Interpolator::RemoveIntInterpolationByVariable(int *val)
+void Interpolator::RemoveInterpolationsByVariable(void *val)
 {
-	// Creation list
-	IntInterpolationList l_vpRemoveCreateIntInterpolations;
-	for(unsigned int i = 0; i < (int)m_vpCreateIntInterpolations.size(); i++)
-	{
-		IntInterpolation* pInterpolator = m_vpCreateIntInterpolations[i];
-		if(pInterpolator->m_variable == val)
-		{
-			l_vpRemoveCreateIntInterpolations.push_back(pInterpolator);
-		}
-	}
-	for(unsigned int i = 0; i < (int)l_vpRemoveCreateIntInterpolations.size(); i++)
+	unordered_map<void*, int>::iterator variableIterator = m_variableSlots.find(val);
+	if(variableIterator == m_variableSlots.end())
 	{
-		RemoveCreateIntInterpolation(l_vpRemoveCreateIntInterpolations[i]);
+		return;
 	}
 
-
-	// Normal list
-	IntInterpolationList l_vpRemoveIntInterpolations;
-	for(unsigned int i = 0; i < (int)m_vpIntInterpolations.size(); i++)
+	// Only the pending and running interpolations are removed, created ones still belong to whoever holds their handle
+	int index = variableIterator->second;
+	while(index != -1)
 	{
-		IntInterpolation* pInterpolator = m_vpIntInterpolations[i];
-		if(pInterpolator->m_variable == val)
+		InterpolationSlot* pSlot = &m_vSlots[index];
+		int nextIndex = pSlot->m_nextByVariable;
+
+		if(pSlot->m_state == InterpolationState_Pending || pSlot->m_state == InterpolationState_Running)
 		{
-			l_vpRemoveIntInterpolations.push_back(pInterpolator);
+			// Removing a chain can free later entries in this list, so start again from the front
+			RemoveInterpolation(GetHandle(index));
+
+			variableIterator = m_variableSlots.find(val);
+			nextIndex = (variableIterator != m_variableSlots.end()) ? variableIterator->second : -1;
 		}
-	}
-	for(unsigned int i = 0; i < (int)l_vpRemoveIntInterpolations.size(); i++)
-	{
-		RemoveIntInterpolation(l_vpRemoveIntInterpolations[i]);
+
+		index = nextIndex;
 	}
 }
 
-bool needs_erasing_float(FloatInterpolation* aF)
+InterpolationSlot* Interpolator::FindSlot(InterpolationHandle aInterpolation)
 {
-	bool needsErase = aF->m_erase;
-
-	if(needsErase == true)
+	unsigned int index = aInterpolation & INDEX_MASK;
+	if(aInterpolation == INVALID_INTERPOLATION || index >= m_vSlots.size())
 	{
-		delete aF;
+		return NULL;
 	}
 
-	return needsErase;
-}
-
-bool needs_erasing_int(IntInterpolation* aI)
-{
-	bool needsErase = aI->m_erase;
-
-	if(needsErase == true)
+	InterpolationSlot* pSlot = &m_vSlots[index];
+	if(pSlot->m_state == InterpolationState_Free || pSlot->m_generation != (aInterpolation >> INDEX_BITS))
 	{
-		delete aI;
+		return NULL;
 	}
 
-	return needsErase;
+	return pSlot;
 }
 
-void Interpolator::SetPaused(bool pause)
+const InterpolationSlot* Interpolator::FindSlot(InterpolationHandle aInterpolation) const
 {
-	m_paused = pause;
+	return const_cast<Interpolator*>(this)->FindSlot(aInterpolation);
 }
 
-bool Interpolator::IsPaused()
+InterpolationHandle Interpolator::GetHandle(unsigned int index) const
 {
-	return m_paused;
+	return (m_vSlots[index].m_generation << INDEX_BITS) | index;
 }
 
-void Interpolator::Update(float dt)
+void Interpolator::StartInterpolation(unsigned int index)
 {
-	UpdateFloatInterpolators(dt);
-	UpdateIntInterpolators(dt);
+	InterpolationSlot* pSlot = &m_vSlots[index];
+	pSlot->m_state = InterpolationState_Running;
+
+	if(pSlot->m_type == InterpolationType_Float)
+	{
+		pSlot->m_batchIndex = m_floatBatch.Add(index, (float*)pSlot->m_variable, pSlot->m_start, pSlot->m_end, pSlot->m_time, pSlot->m_easing);
+	}
+	else
+	{
+		pSlot->m_batchIndex = m_intBatch.Add(index, (int*)pSlot->m_variable, pSlot->m_start, pSlot->m_end, pSlot->m_time, pSlot->m_easing);
+	}
 }
 
-void Interpolator::UpdateFloatInterpolators(float delta)
+void Interpolator::FinishInterpolation(unsigned int index)
 {
-	// Add any interpolators in the create list
-	for(unsigned int i = 0; i < (int)m_vpCreateFloatInterpolations.size(); i++)
+	// An earlier callback this update may have removed it
+	InterpolationSlot* pSlot = &m_vSlots[index];
+	if(pSlot->m_state != InterpolationState_Running)
 	{
-		FloatInterpolation* pInterpolator = m_vpCreateFloatInterpolations[i];
-
-		m_vpFloatInterpolations.push_back(pInterpolator);
+		return;
 	}
-	m_vpCreateFloatInterpolations.clear();
-
 
-	// Remove any interpolations that need to be erased
-	m_vpFloatInterpolations.erase( remove_if(m_vpFloatInterpolations.begin(), m_vpFloatInterpolations.end(), needs_erasing_float), m_vpFloatInterpolations.end() );
-
-	if(m_paused == false)
+	// Land exactly on the end value
+	if(pSlot->m_type == InterpolationType_Float)
+	{
+		*(float*)pSlot->m_variable = pSlot->m_end;
+	}
+	else
 	{
-		FloatInterpolationList m_vpNextFloatInterpolationsAddList;
+		*(int*)pSlot->m_variable = (int)pSlot->m_end;
+	}
 
-		// Update the float interpolations
-		for(unsigned int i = 0; i < (int)m_vpFloatInterpolations.size(); i++)
-		{
-			FloatInterpolation* pInterpolator = m_vpFloatInterpolations[i];
-			if(pInterpolator != NULL)
-			{
-				FloatInterpolation* pNextInterpolationToAdd = NULL;
-
-				if(pInterpolator->m_elapsed < pInterpolator->m_time)
-				{
-					float* lVar = pInterpolator->m_variable;
-					if(lVar == NULL)
-					{
-						continue;
-					}
-
-					float lTimeRatio = pInterpolator->m_elapsed / pInterpolator->m_time;
-					float lDiff = (pInterpolator->m_end - pInterpolator->m_start);
-
-					// Create a bezier curve to represent the acceleration/deceleration curve of the animation
-					// NOTE : 0 = linear, 100 = full acceleration, -100 = full deceleration.
-					float lX = (pInterpolator->m_easing * 0.005f) + 0.5f;
-					float lY = 1.0f - lX;
-
-					vec3 lStart = vec3(0.0f, 0.0f, 0.0f);
-					vec3 lEnd = vec3(1.0f, 1.0f, 0.0f);
-					vec3 lControl = vec3(lX, lY, 0.0f);
-
-					Bezier3 lEaseBezier = Bezier3(lStart, lEnd, lControl);
-					vec3 lVectorT = lEaseBezier.GetInterpolatedPoint(lTimeRatio);
-
-					// Get our real T value that we are going to use to interpolate
-					float lRealT = lVectorT.y;
-
-					// Set the variable value
-					(*lVar) = pInterpolator->m_start + (lDiff * lRealT);
-
-					pInterpolator->m_elapsed += delta;
-				}
-				else
-				{
-					float* lVar = pInterpolator->m_variable;
-					if(lVar == NULL)
-					{
-						continue;
-					}
-
-					(*lVar) = pInterpolator->m_end;
-
-					// If we have a callback, do it
-					if(pInterpolator->m_Callback != NULL)
-					{
-						pInterpolator->m_Callback(pInterpolator->m_pCallbackData);
-					}
-
-					// Are we chained to start another float interpolator?
-					if(pInterpolator->m_pNextInterpolation != NULL)
-					{
-						m_vpNextFloatInterpolationsAddList.push_back(pInterpolator->m_pNextInterpolation);
-					}
-
-					// Erase this interpolator since we have finished
-					pInterpolator->m_erase = true;
-				}
-			}
+	InterpolationHandle next = pSlot->m_next;
+	FunctionCallback callback = pSlot->m_Callback;
+	void *pCallbackData = pSlot->m_pCallbackData;
 
-		}
+	// Release the slot before the callback, since the callback may create new interpolations and grow the slot array
+	FreeSlot(index);
 
-		// Add any chained interpolators to the list
-		for(unsigned int j = 0; j < (int)m_vpNextFloatInterpolationsAddList.size(); j++)
-		{
-			FloatInterpolation* pInterpolator = m_vpNextFloatInterpolationsAddList[j];
-			AddFloatInterpolation(pInterpolator);
-		}
+	// If we have a callback, do it
+	if(callback != NULL)
+	{
+		callback(pCallbackData);
 	}
+
+	// Are we chained to start another interpolation?
+	AddInterpolation(next);
 }
 
-void Interpolator::UpdateIntInterpolators(float delta)
+void Interpolator::RemoveFromBatch(unsigned int index)
 {
-	// Add any interpolators in the create list
-	for(unsigned int i = 0; i < (int)m_vpCreateIntInterpolations.size(); i++)
+	InterpolationSlot* pSlot = &m_vSlots[index];
+
+	int movedSlot;
+	if(pSlot->m_type == InterpolationType_Float)
+	{
+		movedSlot = m_floatBatch.RemoveAt(pSlot->m_batchIndex);
+	}
+	else
 	{
-		IntInterpolation* pInterpolator = m_vpCreateIntInterpolations[i];
+		movedSlot = m_intBatch.RemoveAt(pSlot->m_batchIndex);
+	}
 
-		m_vpIntInterpolations.push_back(pInterpolator);
+	if(movedSlot != -1)
+	{
+		m_vSlots[movedSlot].m_batchIndex = pSlot->m_batchIndex;
 	}
-	m_vpCreateIntInterpolations.clear();
 
+	pSlot->m_batchIndex = -1;
+}
 
-	// Remove any interpolations that need to be erased
-	m_vpIntInterpolations.erase( remove_if(m_vpIntInterpolations.begin(), m_vpIntInterpolations.end(), needs_erasing_int), m_vpIntInterpolations.end() );
+void Interpolator::FreeSlot(unsigned int index)
+{
+	InterpolationSlot* pSlot = &m_vSlots[index];
 
-	if(m_paused == false)
+	if(pSlot->m_state == InterpolationState_Running)
 	{
-		IntInterpolationList m_vpNextIntInterpolationsAddList;
-
-		// Update the int interpolations
-		for(unsigned int i = 0; i < (int)m_vpIntInterpolations.size(); i++)
-		{
-			IntInterpolation* pInterpolator = m_vpIntInterpolations[i];
-			if(pInterpolator != NULL)
-			{
-				IntInterpolation* pNextInterpolationToAdd = NULL;
-
-				if(pInterpolator->m_elapsed < pInterpolator->m_time)
-				{
-					int* lVar = pInterpolator->m_variable;
-					if(lVar == NULL)
-					{
-						continue;
-					}
-
-					float lTimeRatio = pInterpolator->m_elapsed / pInterpolator->m_time;
-					float lDiff = (float)(pInterpolator->m_end - pInterpolator->m_start);
-
-					// Create a bezier curve to represent the acceleration/deceleration curve of the animation
-					// NOTE : 0 = linear, 100 = full acceleration, -100 = full deceleration.
-					float lX = (pInterpolator->m_easing * 0.005f) + 0.5f;
-					float lY = 1.0f - lX;
-
-					vec3 lStart = vec3(0.0f, 0.0f, 0.0f);
-					vec3 lEnd = vec3(1.0f, 1.0f, 0.0f);
-					vec3 lControl = vec3(lX, lY, 0.0f);
-
-					Bezier3 lEaseBezier = Bezier3(lStart, lEnd, lControl);
-					vec3 lVectorT = lEaseBezier.GetInterpolatedPoint(lTimeRatio);
-
-					// Get our real T value that we are going to use to interpolate
-					float lRealT = lVectorT.y;
-
-					// Set the variable value
-					(*lVar) = (int)(pInterpolator->m_start + (lDiff * lRealT));
-
-					pInterpolator->m_elapsed += delta;
-				}
-				else
-				{
-					int* lVar = pInterpolator->m_variable;
-					if(lVar == NULL)
-					{
-						continue;
-					}
-
-					(*lVar) = pInterpolator->m_end;
-
-					// If we have a callback, do it
-					if(pInterpolator->m_Callback != NULL)
-					{
-						pInterpolator->m_Callback(pInterpolator->m_pCallbackData);
-					}
-
-					// Are we chained to start another int interpolator?
-					if(pInterpolator->m_pNextInterpolation != NULL)
-					{
-						m_vpNextIntInterpolationsAddList.push_back(pInterpolator->m_pNextInterpolation);
-					}
-
-					// Erase this interpolator since we have finished
-					pInterpolator->m_erase = true;
-				}
-			}
+		RemoveFromBatch(index);
+	}
 
-		}
+	// Unlink from the variable's list
+	if(pSlot->m_prevByVariable != -1)
+	{
+		m_vSlots[pSlot->m_prevByVariable].m_nextByVariable = pSlot->m_nextByVariable;
+	}
+	else if(pSlot->m_nextByVariable != -1)
+	{
+		m_variableSlots[pSlot->m_variable] = pSlot->m_nextByVariable;
+	}
+	else
+	{
+		m_variableSlots.erase(pSlot->m_variable);
+	}
 
-		// Add any chained interpolators to the list
-		for(unsigned int j = 0; j < (int)m_vpNextIntInterpolationsAddList.size(); j++)
-		{
-			IntInterpolation* pInterpolator = m_vpNextIntInterpolationsAddList[j];
-			AddIntInterpolation(pInterpolator);
-		}
+	if(pSlot->m_nextByVariable != -1)
+	{
+		m_vSlots[pSlot->m_nextByVariable].m_prevByVariable = pSlot->m_prevByVariable;
 	}
+
+	// Pending handles are just left in the pending list, the generation bump makes them stale
+	pSlot->m_generation = (pSlot->m_generation + 1) & GENERATION_MASK;
+	pSlot->m_state = InterpolationState_Free;
+	pSlot->m_variable = NULL;
+
+	m_vFreeSlots.push_back(index);
 }
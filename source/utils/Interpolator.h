@@ -7,6 +7,14 @@
 //	 An interpolator helper class that will manage all the interpolations for
 //   your variables.
 //
+//   Interpolations are referred to by a generational handle, a stale handle
+//   to an interpolation that has finished or been removed is ignored. The
+//   running interpolations are packed into structure of arrays batches, one
+//   per variable type, that are evaluated in a single tight loop each frame.
+//   Finishing, chaining and callbacks only touch the interpolations that
+//   actually finished this frame. Removing by handle is O(1), and removing
+//   by variable only visits the interpolations for that variable.
+//
 // Revision History:
 //   Initial Revision - 23/02/12
 //
@@ -16,84 +24,190 @@
 #pragma once
 
 #include <vector>
+#include <unordered_map>
 #include <stddef.h>
-
+using namespace std;
 
 typedef void(*FunctionCallback)(void *lpData);
 
-class FloatInterpolation
+typedef unsigned int InterpolationHandle;
+const InterpolationHandle INVALID_INTERPOLATION = 0xFFFFFFFF;
+
+enum InterpolationType
+{
+	InterpolationType_Float = 0,
+	InterpolationType_Int,
+};
+
+enum InterpolationState
+{
+	InterpolationState_Free = 0,
+	InterpolationState_Created,	// Allocated, waiting to be added or chained to
+	InterpolationState_Pending,	// Added, starts running on the next update
+	InterpolationState_Running,
+};
+
+// The per interpolation data that is only needed when it starts, finishes or is removed
+class InterpolationSlot
 {
 public:
-	float *m_variable;
+	unsigned int m_generation;
+	InterpolationState m_state;
+	InterpolationType m_type;
+
+	// Index into the running batch for this type
+	int m_batchIndex;
 
+	void *m_variable;
 	float m_start;
 	float m_end;
 	float m_time;
-
 	float m_easing;
 
-	float m_elapsed;
-
-	bool m_erase;
-
-	FloatInterpolation* m_pNextInterpolation;
+	InterpolationHandle m_next;
 
 	FunctionCallback m_Callback;
 	void *m_pCallbackData;
+
+	// Intrusive list of every interpolation on the same variable
+	int m_prevByVariable;
+	int m_nextByVariable;
 };
 
-class IntInterpolation
+// The running interpolations for one variable type, stored as parallel arrays
+template <class T>
+class InterpolationBatch
 {
 public:
-	int *m_variable;
-
-	int m_start;
-	int m_end;
-	float m_time;
+	int GetSize() const
+	{
+		return (int)m_vSlots.size();
+	}
+
+	int Add(unsigned int slot, T *variable, float start, float end, float time, float easing)
+	{
+		m_vpVariables.push_back(variable);
+		m_vStart.push_back(start);
+		m_vDelta.push_back(end - start);
+		m_vInvTime.push_back(time > 0.0f ? 1.0f / time : 1.0e30f);
+		m_vElapsed.push_back(0.0f);
+
+		// The easing curve is a quadratic bezier from (0, 0) to (1, 1), only the control point's y is needed
+		// NOTE : 0 = linear, 100 = full acceleration, -100 = full deceleration.
+		m_vControl.push_back(0.5f - (easing * 0.005f));
+
+		m_vSlots.push_back(slot);
+
+		return (int)m_vSlots.size() - 1;
+	}
+
+	// Swap removes an entry, returns the slot of the entry that was moved into its place, or -1
+	int RemoveAt(int index)
+	{
+		int last = (int)m_vSlots.size() - 1;
+		int movedSlot = -1;
+		if (index != last)
+		{
+			m_vpVariables[index] = m_vpVariables[last];
+			m_vStart[index] = m_vStart[last];
+			m_vDelta[index] = m_vDelta[last];
+			m_vInvTime[index] = m_vInvTime[last];
+			m_vElapsed[index] = m_vElapsed[last];
+			m_vControl[index] = m_vControl[last];
+			m_vSlots[index] = m_vSlots[last];
+			movedSlot = (int)m_vSlots[index];
+		}
+
+		m_vpVariables.pop_back();
+		m_vStart.pop_back();
+		m_vDelta.pop_back();
+		m_vInvTime.pop_back();
+		m_vElapsed.pop_back();
+		m_vControl.pop_back();
+		m_vSlots.pop_back();
+
+		return movedSlot;
+	}
+
+	// Advances and writes every running interpolation, the slots that reached their end are appended to finishedSlots
+	void Evaluate(float delta, vector<unsigned int>& finishedSlots)
+	{
+		int size = (int)m_vSlots.size();
+		for (int i = 0; i < size; i++)
+		{
+			float elapsed = m_vElapsed[i] + delta;
+			m_vElapsed[i] = elapsed;
+
+			float t = elapsed * m_vInvTime[i];
+			if (t >= 1.0f)
+			{
+				t = 1.0f;
+				finishedSlots.push_back(m_vSlots[i]);
+			}
+
+			float easedT = t * ((2.0f * m_vControl[i] * (1.0f - t)) + t);
+
+			*m_vpVariables[i] = (T)(m_vStart[i] + (m_vDelta[i] * easedT));
+		}
+	}
+
+	void Clear()
+	{
+		m_vpVariables.clear();
+		m_vStart.clear();
+		m_vDelta.clear();
+		m_vInvTime.clear();
+		m_vElapsed.clear();
+		m_vControl.clear();
+		m_vSlots.clear();
+	}
 
-	float m_easing;
-
-	float m_elapsed;
-
-	bool m_erase;
-
-	IntInterpolation* m_pNextInterpolation;
-
-	FunctionCallback m_Callback;
-	void *m_pCallbackData;
+private:
+	vector<T*> m_vpVariables;
+	vector<float> m_vStart;
+	vector<float> m_vDelta;
+	vector<float> m_vInvTime;
+	vector<float> m_vElapsed;
+	vector<float> m_vControl;
+	vector<unsigned int> m_vSlots;
 };
 
-typedef std::vector<FloatInterpolation*> FloatInterpolationList;
-typedef std::vector<IntInterpolation*> IntInterpolationList;
-
 
 class Interpolator
 {
 public:
+	// Handle layout, the low bits are the slot index and the high bits the generation
+	static const unsigned int INDEX_BITS = 20;
+	static const unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static const unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
 	/* Public methods */
 	static Interpolator* GetInstance();
 	void Destroy();
 
 	void ClearInterpolators();
 
-	FloatInterpolation* CreateFloatInterpolation(float *val, float start, float end, float time, float easing, FloatInterpolation* aNext = NULL, FunctionCallback aCallback = NULL, void *aData = NULL);
-	void LinkFloatInterpolation(FloatInterpolation* aFirst, FloatInterpolation* aSecond);
-	void AddFloatInterpolation(FloatInterpolation* aInterpolation);
-	void AddFloatInterpolation(float *val, float start, float end, float time, float easing, FloatInterpolation* aNext = NULL, FunctionCallback aCallback = NULL, void *aData = NULL);
+	InterpolationHandle CreateFloatInterpolation(float *val, float start, float end, float time, float easing, InterpolationHandle aNext = INVALID_INTERPOLATION, FunctionCallback aCallback = NULL, void *aData = NULL);
+	void LinkFloatInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond);
+	void AddFloatInterpolation(InterpolationHandle aInterpolation);
+	InterpolationHandle AddFloatInterpolation(float *val, float start, float end, float time, float easing, InterpolationHandle aNext = INVALID_INTERPOLATION, FunctionCallback aCallback = NULL, void *aData = NULL);
+	void RemoveFloatInterpolation(InterpolationHandle aInterpolation);
 	void RemoveFloatInterpolationByVariable(float *val);
 
-	IntInterpolation* CreateIntInterpolation(int *val, int start, int end, float time, float easing, IntInterpolation* aNext = NULL, FunctionCallback aCallback = NULL, void *aData = NULL);
-	void LinkIntInterpolation(IntInterpolation* aFirst, IntInterpolation* aSecond);
-	void AddIntInterpolation(IntInterpolation* aInterpolation);
-	void AddIntInterpolation(int *val, int start, int end, float time, float easing, IntInterpolation* aNext = NULL, FunctionCallback aCallback = NULL, void *aData = NULL);
+	InterpolationHandle CreateIntInterpolation(int *val, int start, int end, float time, float easing, InterpolationHandle aNext = INVALID_INTERPOLATION, FunctionCallback aCallback = NULL, void *aData = NULL);
+	void LinkIntInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond);
+	void AddIntInterpolation(InterpolationHandle aInterpolation);
+	InterpolationHandle AddIntInterpolation(int *val, int start, int end, float time, float easing, InterpolationHandle aNext = INVALID_INTERPOLATION, FunctionCallback aCallback = NULL, void *aData = NULL);
+	void RemoveIntInterpolation(InterpolationHandle aInterpolation);
 	void RemoveIntInterpolationByVariable(int *val);
 
+	bool IsInterpolating(InterpolationHandle aInterpolation) const;
+	int GetNumRunningInterpolations() const;
+
 	void SetPaused(bool pause);
 	bool IsPaused();
 
 	void Update(float dt);
-	void UpdateFloatInterpolators(float delta);
-	void UpdateIntInterpolators(float delta);
 
 protected:
 	/* Protected methods */
@@ -103,11 +217,20 @@ protected:
 
 private:
 	/* Private methods */
-	void RemoveCreateFloatInterpolation(FloatInterpolation* aInterpolation);
-	void RemoveFloatInterpolation(FloatInterpolation* aInterpolation);
+	InterpolationHandle CreateInterpolation(InterpolationType type, void *val, float start, float end, float time, float easing, InterpolationHandle aNext, FunctionCallback aCallback, void *aData);
+	void LinkInterpolation(InterpolationHandle aFirst, InterpolationHandle aSecond);
+	void AddInterpolation(InterpolationHandle aInterpolation);
+	void RemoveInterpolation(InterpolationHandle aInterpolation);
+	void RemoveInterpolationsByVariable(void *val);
+
+	InterpolationSlot* FindSlot(InterpolationHandle aInterpolation);
+	const InterpolationSlot* FindSlot(InterpolationHandle aInterpolation) const;
+	InterpolationHandle GetHandle(unsigned int index) const;
 
-	void RemoveCreateIntInterpolation(IntInterpolation* aInterpolation);
-	void RemoveIntInterpolation(IntInterpolation* aInterpolation);
+	void StartInterpolation(unsigned int index);
+	void FinishInterpolation(unsigned int index);
+	void RemoveFromBatch(unsigned int index);
+	void FreeSlot(unsigned int index);
 
 public:
 	/* Public members */
@@ -118,13 +241,22 @@ protected:
 private:
 	/* Private members */
 
-	// A dynamic array of our float interpolation variables
-	FloatInterpolationList m_vpFloatInterpolations;
-	FloatInterpolationList m_vpCreateFloatInterpolations;
+	// Every interpolation, indexed by the handle's slot index
+	vector<InterpolationSlot> m_vSlots;
+	vector<unsigned int> m_vFreeSlots;
+
+	// The first slot for each variable that has interpolations
+	unordered_map<void*, int> m_variableSlots;
+
+	// Handles added since the last update
+	vector<InterpolationHandle> m_vPendingInterpolations;
+
+	// The running interpolations
+	InterpolationBatch<float> m_floatBatch;
+	InterpolationBatch<int> m_intBatch;
 
-	// A dynamic array of our int interpolation variables
-	IntInterpolationList m_vpIntInterpolations;
-	IntInterpolationList m_vpCreateIntInterpolations;
+	// Scratch list of the slots that finished this update
+	vector<unsigned int> m_vFinishedSlots;
 
 	// Singleton instance
 	static Interpolator *c_instance;
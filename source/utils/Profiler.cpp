@@ -0,0 +1,236 @@
+// ******************************************************************************
+// Filename:    Profiler.cpp
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#include "Profiler.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+
+
+// Each thread lazily gets its own buffer the first time it opens a zone
+static thread_local ProfileThreadBuffer* t_pProfileThreadBuffer = NULL;
+
+// Profiler time is measured from when the profiler was first created
+static std::chrono::steady_clock::time_point s_profilerEpoch;
+
+// Initialize the singleton instance
+Profiler *Profiler::c_instance = 0;
+
+Profiler* Profiler::GetInstance()
+{
+	if (c_instance == 0)
+		c_instance = new Profiler;
+
+	return c_instance;
+}
+
+void Profiler::Destroy()
+{
+	if (c_instance)
+	{
+		m_threadBuffersMutex.lock();
+		for (unsigned int i = 0; i < m_vpThreadBuffers.size(); i++)
+		{
+			delete m_vpThreadBuffers[i];
+			m_vpThreadBuffers[i] = 0;
+		}
+		m_vpThreadBuffers.clear();
+		m_threadBuffersMutex.unlock();
+
+		t_pProfileThreadBuffer = NULL;
+
+		delete c_instance;
+		c_instance = 0;
+	}
+}
+
+Profiler::Profiler()
+{
+	s_profilerEpoch = std::chrono::steady_clock::now();
+
+	m_enabled = true;
+
+	m_pMainThreadBuffer = NULL;
+	m_currentFrameStart = 0.0;
+	m_lastFrameStart = 0.0;
+	m_lastFrameEnd = 0.0;
+}
+
+// Enable / disable recording at runtime
+void Profiler::SetEnabled(bool enabled)
+{
+	m_enabled = enabled;
+}
+
+bool Profiler::IsEnabled() const
+{
+	return m_enabled;
+}
+
+// Zones
+void Profiler::BeginZone(const char* name)
+{
+	ProfileThreadBuffer* pBuffer = GetThreadBuffer();
+
+	// Open zones are always tracked, so enabling or disabling mid-zone can't unbalance the stack
+	if (pBuffer->m_depth < ProfileThreadBuffer::MAX_DEPTH)
+	{
+		pBuffer->m_openNames[pBuffer->m_depth] = name;
+		pBuffer->m_openStartTimes[pBuffer->m_depth] = m_enabled ? GetTime() : 0.0;
+	}
+
+	pBuffer->m_depth++;
+}
+
+void Profiler::EndZone()
+{
+	ProfileThreadBuffer* pBuffer = GetThreadBuffer();
+
+	if (pBuffer->m_depth <= 0)
+	{
+		return;
+	}
+
+	pBuffer->m_depth--;
+
+	if (m_enabled == false || pBuffer->m_depth >= ProfileThreadBuffer::MAX_DEPTH)
+	{
+		return;
+	}
+
+	// Only this thread writes to its buffer, readers use the written count to know what is valid
+	unsigned int index = pBuffer->m_numWritten.load(memory_order_relaxed);
+	ProfileZoneRecord* pRecord = &pBuffer->m_records[index % ProfileThreadBuffer::RING_SIZE];
+	pRecord->m_name = pBuffer->m_openNames[pBuffer->m_depth];
+	pRecord->m_startTime = pBuffer->m_openStartTimes[pBuffer->m_depth];
+	pRecord->m_endTime = GetTime();
+	pRecord->m_depth = pBuffer->m_depth;
+	pBuffer->m_numWritten.store(index + 1, memory_order_release);
+}
+
+// Frames, marked from the main thread
+void Profiler::NewFrame()
+{
+	m_pMainThreadBuffer = GetThreadBuffer();
+
+	double now = GetTime();
+	m_lastFrameStart = m_currentFrameStart;
+	m_lastFrameEnd = now;
+	m_currentFrameStart = now;
+}
+
+double Profiler::GetLastFrameStartTime() const
+{
+	return m_lastFrameStart;
+}
+
+double Profiler::GetLastFrameTime() const
+{
+	return (m_lastFrameEnd - m_lastFrameStart) / 1000.0;
+}
+
+void Profiler::GetLastFrameZones(vector<ProfileZoneRecord>& zones) const
+{
+	zones.clear();
+
+	if (m_pMainThreadBuffer == NULL)
+	{
+		return;
+	}
+
+	// Records are written as zones close, so they are ordered by end time. Walk back until we leave the frame.
+	unsigned int numWritten = m_pMainThreadBuffer->m_numWritten.load(memory_order_acquire);
+	unsigned int numAvailable = numWritten < (unsigned int)ProfileThreadBuffer::RING_SIZE ? numWritten : (unsigned int)ProfileThreadBuffer::RING_SIZE;
+	for (unsigned int i = 0; i < numAvailable; i++)
+	{
+		const ProfileZoneRecord& record = m_pMainThreadBuffer->m_records[(numWritten - 1 - i) % ProfileThreadBuffer::RING_SIZE];
+
+		if (record.m_endTime < m_lastFrameStart)
+		{
+			break;
+		}
+
+		if (record.m_startTime >= m_lastFrameStart && record.m_endTime <= m_lastFrameEnd)
+		{
+			zones.push_back(record);
+		}
+	}
+}
+
+// Exporting
+bool Profiler::ExportChromeTrace(const char* fileName)
+{
+	ofstream file(fileName);
+
+	if (file.is_open() == false)
+	{
+		return false;
+	}
+
+	file << fixed << setprecision(3);
+	file << "{\"traceEvents\":[\n";
+
+	bool firstEvent = true;
+
+	m_threadBuffersMutex.lock();
+	for (unsigned int i = 0; i < m_vpThreadBuffers.size(); i++)
+	{
+		ProfileThreadBuffer* pBuffer = m_vpThreadBuffers[i];
+
+		// Other threads may still be recording, only the records written before this point are exported
+		unsigned int numWritten = pBuffer->m_numWritten.load(memory_order_acquire);
+		unsigned int numAvailable = numWritten < (unsigned int)ProfileThreadBuffer::RING_SIZE ? numWritten : (unsigned int)ProfileThreadBuffer::RING_SIZE;
+		for (unsigned int j = numWritten - numAvailable; j < numWritten; j++)
+		{
+			const ProfileZoneRecord& record = pBuffer->m_records[j % ProfileThreadBuffer::RING_SIZE];
+
+			if (firstEvent == false)
+			{
+				file << ",\n";
+			}
+			firstEvent = false;
+
+			file << "{\"name\":\"" << record.m_name << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << pBuffer->m_threadId;
+			file << ",\"ts\":" << record.m_startTime << ",\"dur\":" << (record.m_endTime - record.m_startTime) << "}";
+		}
+	}
+	m_threadBuffersMutex.unlock();
+
+	file << "\n]}\n";
+
+	return true;
+}
+
+// Time since the profiler was created, in microseconds
+double Profiler::GetTime() const
+{
+	return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - s_profilerEpoch).count();
+}
+
+ProfileThreadBuffer* Profiler::GetThreadBuffer()
+{
+	if (t_pProfileThreadBuffer == NULL)
+	{
+		ProfileThreadBuffer* pBuffer = new ProfileThreadBuffer();
+		pBuffer->m_numWritten.store(0);
+		pBuffer->m_depth = 0;
+
+		m_threadBuffersMutex.lock();
+		pBuffer->m_threadId = (int)m_vpThreadBuffers.size();
+		m_vpThreadBuffers.push_back(pBuffer);
+		m_threadBuffersMutex.unlock();
+
+		t_pProfileThreadBuffer = pBuffer;
+	}
+
+	return t_pProfileThreadBuffer;
+}
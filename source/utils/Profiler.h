@@ -0,0 +1,142 @@
+// ******************************************************************************
+// Filename:    Profiler.h
+// Project:     Vogue
+// Author:      Steven Ball
+//
+// Purpose:
+//   A lightweight hierarchical CPU profiler. Code is instrumented with scoped
+//   zones using the PROFILE_ZONE() macro, each thread records its completed
+//   zones into its own ring buffer without taking any locks. The recorded
+//   zones can be queried for the last frame (for the debug overlay) or
+//   exported as Chrome trace-event JSON (chrome://tracing).
+//
+//   The macros compile to nothing unless VOGUE_PROFILER is defined.
+//
+// Revision History:
+//   Initial Revision - 18/10/16
+//
+// Copyright (c) 2005-2016, Steven Ball
+// ******************************************************************************
+
+#pragma once
+
+#include <vector>
+#include <atomic>
+using namespace std;
+
+#include "../tinythread/tinythread.h"
+using namespace tthread;
+
+// A completed zone. The name must be a string literal, or otherwise outlive the profiler.
+class ProfileZoneRecord
+{
+public:
+	const char* m_name;
+	double m_startTime;
+	double m_endTime;
+	int m_depth;
+};
+
+// Per thread storage for the zones, only ever written to by the owning thread
+class ProfileThreadBuffer
+{
+public:
+	static const int RING_SIZE = 16384;
+	static const int MAX_DEPTH = 32;
+
+	ProfileZoneRecord m_records[RING_SIZE];
+	atomic<unsigned int> m_numWritten;
+
+	// Currently open zones
+	const char* m_openNames[MAX_DEPTH];
+	double m_openStartTimes[MAX_DEPTH];
+	int m_depth;
+
+	int m_threadId;
+};
+
+class Profiler
+{
+public:
+	/* Public methods */
+	static Profiler* GetInstance();
+	void Destroy();
+
+	// Enable / disable recording at runtime
+	void SetEnabled(bool enabled);
+	bool IsEnabled() const;
+
+	// Zones
+	void BeginZone(const char* name);
+	void EndZone();
+
+	// Frames, marked from the main thread
+	void NewFrame();
+	double GetLastFrameStartTime() const;
+	double GetLastFrameTime() const;
+	void GetLastFrameZones(vector<ProfileZoneRecord>& zones) const;
+
+	// Exporting
+	bool ExportChromeTrace(const char* fileName);
+
+	// Time since the profiler was created, in microseconds
+	double GetTime() const;
+
+protected:
+	/* Protected methods */
+	Profiler();
+	Profiler(const Profiler&);
+	Profiler &operator=(const Profiler&);
+
+private:
+	/* Private methods */
+	ProfileThreadBuffer* GetThreadBuffer();
+
+public:
+	/* Public members */
+
+protected:
+	/* Protected members */
+
+private:
+	/* Private members */
+	bool m_enabled;
+
+	// All the thread buffers that have been created, only locked when a new thread records its first zone
+	vector<ProfileThreadBuffer*> m_vpThreadBuffers;
+	mutex m_threadBuffersMutex;
+
+	// Frame markers
+	ProfileThreadBuffer* m_pMainThreadBuffer;
+	double m_currentFrameStart;
+	double m_lastFrameStart;
+	double m_lastFrameEnd;
+
+	// Singleton instance
+	static Profiler *c_instance;
+};
+
+// Records a zone for the rest of the enclosing scope
+class ProfileZone
+{
+public:
+	ProfileZone(const char* name)
+	{
+		Profiler::GetInstance()->BeginZone(name);
+	}
+
+	~ProfileZone()
+	{
+		Profiler::GetInstance()->EndZone();
+	}
+};
+
+#ifdef VOGUE_PROFILER
+#define PROFILE_ZONE_CONCAT_INNER(a, b) a##b
+#define PROFILE_ZONE_CONCAT(a, b) PROFILE_ZONE_CONCAT_INNER(a, b)
+#define PROFILE_ZONE(name) ProfileZone PROFILE_ZONE_CONCAT(profileZone, __LINE__)(name)
+#define PROFILE_FRAME() Profiler::GetInstance()->NewFrame()
+#else
+#define PROFILE_ZONE(name)
+#define PROFILE_FRAME()
+#endif //VOGUE_PROFILER
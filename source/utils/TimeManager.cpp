@@ -12,6 +12,7 @@
 #include "TimeManager.h"
 
 #include <stdio.h>
+#include <math.h>
 
 
 // Initialize the singleton instance
@@ -29,48 +30,487 @@ void TimeManager::Destroy()
 {
 	if(c_instance)
 	{
-		for(unsigned int i = 0; i < m_vpCountdownTimers.size(); i++)
-		{
-			delete m_vpCountdownTimers[i];
-			m_vpCountdownTimers[i] = 0;
-		}
-		m_vpCountdownTimers.clear();
+		RemoveTimers();
 
 		delete c_instance;
+		c_instance = 0;
 	}
 }
 
 TimeManager::TimeManager()
 {
+	for(int i = 0; i < WHEEL_NUM_LEVELS * WHEEL_LEVEL_SIZE; i++)
+	{
+		m_wheelHeads[i] = -1;
+	}
+
+	m_currentTick = 0;
+	m_tickAccumulator = 0.0;
+	m_numScheduledTimers = 0;
+	m_numTimers = 0;
+}
+
+// Timers
+TimerHandle TimeManager::CreateTimer(FunctionCallback callback, void *pCallbackData)
+{
+	int index;
+	if(m_vFreeTimers.empty() == false)
+	{
+		index = m_vFreeTimers.back();
+		m_vFreeTimers.pop_back();
+	}
+	else
+	{
+		// The last index is never handed out, so a valid handle can never equal INVALID_TIMER
+		if(m_vTimerGenerations.size() >= INDEX_MASK)
+		{
+			return INVALID_TIMER;
+		}
+
+		index = (int)m_vTimerGenerations.size();
+		m_vTimerGenerations.push_back(0);
+		m_vTimerFlags.push_back(0);
+		m_vTimerCountdownTimes.push_back(0.0f);
+		m_vTimerElapsedTimes.push_back(0.0f);
+		m_vTimerExpiryTicks.push_back(0);
+		m_vTimerCallbacks.push_back(NULL);
+		m_vTimerCallbackData.push_back(NULL);
+		m_vTimerNext.push_back(-1);
+		m_vTimerPrev.push_back(-1);
+		m_vTimerBuckets.push_back(-1);
+	}
+
+	// New timers start off paused and not started, until StartTimer() is called
+	m_vTimerFlags[index] = TimerFlags_Allocated | TimerFlags_Paused;
+	m_vTimerCountdownTimes[index] = 0.0f;
+	m_vTimerElapsedTimes[index] = 0.0f;
+	m_vTimerCallbacks[index] = callback;
+	m_vTimerCallbackData[index] = pCallbackData;
+
+	m_numTimers++;
+
+	return (m_vTimerGenerations[index] << INDEX_BITS) | (unsigned int)index;
+}
+
+TimerHandle TimeManager::AddTimer(float countdownTime, FunctionCallback callback, void *pCallbackData, bool looping)
+{
+	TimerHandle timer = CreateTimer(callback, pCallbackData);
+	SetTimerCountdownTime(timer, countdownTime);
+	SetTimerLooping(timer, looping);
+	StartTimer(timer);
+
+	return timer;
+}
+
+void TimeManager::RemoveTimer(TimerHandle timer)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	UnscheduleTimer(index);
+
+	// Bump the generation so the handle, and any pending expiry for it this update, go stale
+	m_vTimerGenerations[index] = (m_vTimerGenerations[index] + 1) & GENERATION_MASK;
+	m_vTimerFlags[index] = 0;
+	m_vTimerCallbacks[index] = NULL;
+	m_vTimerCallbackData[index] = NULL;
+
+	m_vFreeTimers.push_back(index);
+	m_numTimers--;
 }
 
-bool TimeManager::HasCountdownTimers() const
+void TimeManager::RemoveTimers()
 {
-	return(m_vpCountdownTimers.size() > 0);
+	for(unsigned int i = 0; i < m_vTimerGenerations.size(); i++)
+	{
+		if(m_vTimerFlags[i] & TimerFlags_Allocated)
+		{
+			RemoveTimer((m_vTimerGenerations[i] << INDEX_BITS) | i);
+		}
+	}
+}
+
+bool TimeManager::IsTimerValid(TimerHandle timer) const
+{
+	return FindTimer(timer) != -1;
 }
 
-void TimeManager::AddCountdownTimer(CountdownTimer* countdownTimer)
+int TimeManager::GetNumTimers() const
 {
-	m_vpCountdownTimers.push_back(countdownTimer);
+	return m_numTimers;
 }
 
-void TimeManager::RemoveCountdownTimer(CountdownTimer* countdownTimer)
+int TimeManager::GetNumScheduledTimers() const
 {
-	m_vpCountdownTimers.erase(std::remove(m_vpCountdownTimers.begin(), m_vpCountdownTimers.end(), countdownTimer), m_vpCountdownTimers.end());
+	return m_numScheduledTimers;
 }
 
-void TimeManager::RemoveCountdownTimers()
+void TimeManager::SetTimerCallback(TimerHandle timer, FunctionCallback callback, void *pCallbackData)
 {
-	m_vpCountdownTimers.clear();
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	m_vTimerCallbacks[index] = callback;
+	m_vTimerCallbackData[index] = pCallbackData;
+}
+
+void TimeManager::SetTimerCountdownTime(TimerHandle timer, float countdownTime)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	if(m_vTimerBuckets[index] != -1)
+	{
+		// Keep the time already counted, and move the expiry to match the new countdown
+		float elapsedTime = GetTimerElapsedTime(timer);
+		UnscheduleTimer(index);
+		m_vTimerCountdownTimes[index] = countdownTime;
+		ScheduleTimer(index, countdownTime - elapsedTime);
+	}
+	else
+	{
+		m_vTimerCountdownTimes[index] = countdownTime;
+	}
+}
+
+void TimeManager::SetTimerLooping(TimerHandle timer, bool looping)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	if(looping)
+	{
+		m_vTimerFlags[index] |= TimerFlags_Looping;
+	}
+	else
+	{
+		m_vTimerFlags[index] &= ~TimerFlags_Looping;
+	}
+}
+
+void TimeManager::StartTimer(TimerHandle timer)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	UnscheduleTimer(index);
+
+	m_vTimerElapsedTimes[index] = 0.0f;
+	m_vTimerFlags[index] &= ~(TimerFlags_Paused | TimerFlags_Finished | TimerFlags_Expired);
+	m_vTimerFlags[index] |= TimerFlags_Started;
+
+	ScheduleTimer(index, m_vTimerCountdownTimes[index]);
+}
+
+void TimeManager::ResetTimer(TimerHandle timer)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	UnscheduleTimer(index);
+
+	m_vTimerElapsedTimes[index] = 0.0f;
+	m_vTimerFlags[index] &= ~(TimerFlags_Finished | TimerFlags_Expired);
+
+	if((m_vTimerFlags[index] & TimerFlags_Started) && (m_vTimerFlags[index] & TimerFlags_Paused) == 0)
+	{
+		ScheduleTimer(index, m_vTimerCountdownTimes[index]);
+	}
+}
+
+void TimeManager::PauseTimer(TimerHandle timer)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	if(m_vTimerBuckets[index] != -1)
+	{
+		m_vTimerElapsedTimes[index] = GetTimerElapsedTime(timer);
+		UnscheduleTimer(index);
+	}
+
+	m_vTimerFlags[index] |= TimerFlags_Paused;
+}
+
+void TimeManager::ResumeTimer(TimerHandle timer)
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return;
+	}
+
+	m_vTimerFlags[index] &= ~TimerFlags_Paused;
+
+	if((m_vTimerFlags[index] & TimerFlags_Started) && (m_vTimerFlags[index] & TimerFlags_Finished) == 0 && m_vTimerBuckets[index] == -1)
+	{
+		ScheduleTimer(index, m_vTimerCountdownTimes[index] - m_vTimerElapsedTimes[index]);
+	}
+}
+
+bool TimeManager::IsTimerPaused(TimerHandle timer) const
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return false;
+	}
+
+	return (m_vTimerFlags[index] & TimerFlags_Paused) != 0;
+}
+
+float TimeManager::GetTimerElapsedTime(TimerHandle timer) const
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return 0.0f;
+	}
+
+	if(m_vTimerBuckets[index] == -1)
+	{
+		return m_vTimerElapsedTimes[index];
+	}
+
+	// While scheduled the elapsed time is worked out from how far away the expiry is
+	double remainingTicks = (double)m_vTimerExpiryTicks[index] - ((double)m_currentTick + m_tickAccumulator);
+	float elapsedTime = m_vTimerCountdownTimes[index] - (float)(remainingTicks / TIMER_TICKS_PER_SECOND);
+
+	return elapsedTime > 0.0f ? elapsedTime : 0.0f;
+}
+
+float TimeManager::GetTimerRemainingTime(TimerHandle timer) const
+{
+	int index = FindTimer(timer);
+	if(index == -1)
+	{
+		return 0.0f;
+	}
+
+	return m_vTimerCountdownTimes[index] - GetTimerElapsedTime(timer);
 }
 
 // Update
 void TimeManager::Update(float dt)
 {
-	// Also update all our countdown timers
-	CountdownTimerList::iterator iterator;
-	for(iterator = m_vpCountdownTimers.begin(); iterator != m_vpCountdownTimers.end(); ++iterator)
+	// Work out how many whole ticks have passed, the remainder carries over to the next update
+	m_tickAccumulator += (double)dt * TIMER_TICKS_PER_SECOND;
+	double wholeTicks = floor(m_tickAccumulator);
+	m_tickAccumulator -= wholeTicks;
+
+	m_vExpiredTimers.clear();
+	AdvanceWheel(m_currentTick + (unsigned long long)wholeTicks);
+
+	// Fire the expired timers, callbacks are free to start, reset or remove any timer
+	for(unsigned int i = 0; i < m_vExpiredTimers.size(); i++)
+	{
+		int index = FindTimer(m_vExpiredTimers[i]);
+		if(index == -1 || (m_vTimerFlags[index] & TimerFlags_Expired) == 0)
+		{
+			continue;
+		}
+
+		m_vTimerFlags[index] &= ~TimerFlags_Expired;
+
+		if(m_vTimerFlags[index] & TimerFlags_Looping)
+		{
+			// If we are a looping timer, then just start counting again from now
+			m_vTimerElapsedTimes[index] = 0.0f;
+			ScheduleTimer(index, m_vTimerCountdownTimes[index]);
+		}
+		else
+		{
+			// We are not looping, so set our finished flag
+			m_vTimerElapsedTimes[index] = m_vTimerCountdownTimes[index];
+			m_vTimerFlags[index] |= TimerFlags_Finished;
+		}
+
+		// We have reached our countdown time, call our function callback
+		FunctionCallback callback = m_vTimerCallbacks[index];
+		if(callback)
+		{
+			callback(m_vTimerCallbackData[index]);
+		}
+	}
+}
+
+int TimeManager::FindTimer(TimerHandle timer) const
+{
+	unsigned int index = timer & INDEX_MASK;
+	if(timer == INVALID_TIMER || index >= m_vTimerGenerations.size())
+	{
+		return -1;
+	}
+
+	if((m_vTimerFlags[index] & TimerFlags_Allocated) == 0 || m_vTimerGenerations[index] != (timer >> INDEX_BITS))
+	{
+		return -1;
+	}
+
+	return (int)index;
+}
+
+void TimeManager::ScheduleTimer(int index, float remainingTime)
+{
+	if(remainingTime < 0.0f)
+	{
+		remainingTime = 0.0f;
+	}
+
+	// Round up, so a timer never fires before its time. It always waits at least one tick.
+	double now = (double)m_currentTick + m_tickAccumulator;
+	unsigned long long expiryTick = (unsigned long long)ceil(now + (double)remainingTime * TIMER_TICKS_PER_SECOND);
+	if(expiryTick <= m_currentTick)
+	{
+		expiryTick = m_currentTick + 1;
+	}
+
+	m_vTimerExpiryTicks[index] = expiryTick;
+	InsertIntoWheel(index);
+}
+
+void TimeManager::UnscheduleTimer(int index)
+{
+	int bucket = m_vTimerBuckets[index];
+	if(bucket == -1)
+	{
+		return;
+	}
+
+	int prev = m_vTimerPrev[index];
+	int next = m_vTimerNext[index];
+	if(prev != -1)
+	{
+		m_vTimerNext[prev] = next;
+	}
+	else
+	{
+		m_wheelHeads[bucket] = next;
+	}
+
+	if(next != -1)
+	{
+		m_vTimerPrev[next] = prev;
+	}
+
+	m_vTimerPrev[index] = -1;
+	m_vTimerNext[index] = -1;
+	m_vTimerBuckets[index] = -1;
+	m_numScheduledTimers--;
+}
+
+void TimeManager::InsertIntoWheel(int index)
+{
+	unsigned long long expiryTick = m_vTimerExpiryTicks[index];
+	unsigned long long delta = expiryTick > m_currentTick ? expiryTick - m_currentTick : 0;
+
+	// Pick the lowest level whose range covers the delta, anything past the top level is parked at its far end and cascades down later
+	int level = 0;
+	while(level < WHEEL_NUM_LEVELS - 1 && delta >= (1ull << (WHEEL_LEVEL_BITS * (level + 1))))
+	{
+		level++;
+	}
+
+	unsigned long long maxDelta = (1ull << (WHEEL_LEVEL_BITS * WHEEL_NUM_LEVELS)) - 1;
+	unsigned long long bucketTick = delta > maxDelta ? m_currentTick + maxDelta : expiryTick;
+	int bucket = (level * WHEEL_LEVEL_SIZE) + (int)((bucketTick >> (WHEEL_LEVEL_BITS * level)) & WHEEL_LEVEL_MASK);
+
+	// Push onto the front of the bucket's list
+	int head = m_wheelHeads[bucket];
+	m_vTimerPrev[index] = -1;
+	m_vTimerNext[index] = head;
+	if(head != -1)
 	{
-		(*iterator)->UpdateCountdown(dt);
+		m_vTimerPrev[head] = index;
+	}
+	m_wheelHeads[bucket] = index;
+	m_vTimerBuckets[index] = bucket;
+	m_numScheduledTimers++;
+}
+
+void TimeManager::CascadeBucket(int level, int bucket)
+{
+	int index = m_wheelHeads[(level * WHEEL_LEVEL_SIZE) + bucket];
+	while(index != -1)
+	{
+		int next = m_vTimerNext[index];
+
+		// Re-inserting from the current tick drops each timer into a finer level
+		UnscheduleTimer(index);
+		InsertIntoWheel(index);
+
+		index = next;
+	}
+}
+
+void TimeManager::AdvanceWheel(unsigned long long targetTick)
+{
+	while(m_currentTick < targetTick)
+	{
+		// Nothing scheduled, so there is no need to walk the empty buckets
+		if(m_numScheduledTimers == 0)
+		{
+			m_currentTick = targetTick;
+			break;
+		}
+
+		m_currentTick++;
+
+		// When a level wraps, the next bucket up is cascaded down into the levels below
+		int bucket = (int)(m_currentTick & WHEEL_LEVEL_MASK);
+		if(bucket == 0)
+		{
+			for(int level = 1; level < WHEEL_NUM_LEVELS; level++)
+			{
+				int levelBucket = (int)((m_currentTick >> (WHEEL_LEVEL_BITS * level)) & WHEEL_LEVEL_MASK);
+				CascadeBucket(level, levelBucket);
+
+				if(levelBucket != 0)
+				{
+					break;
+				}
+			}
+		}
+
+		// Everything left in this tick's bucket has expired
+		int index = m_wheelHeads[bucket];
+		while(index != -1)
+		{
+			int next = m_vTimerNext[index];
+
+			UnscheduleTimer(index);
+			if(m_vTimerExpiryTicks[index] > m_currentTick)
+			{
+				InsertIntoWheel(index);
+			}
+			else
+			{
+				m_vTimerFlags[index] |= TimerFlags_Expired;
+				m_vExpiredTimers.push_back((m_vTimerGenerations[index] << INDEX_BITS) | (unsigned int)index);
+			}
+
+			index = next;
+		}
 	}
 }
@@ -8,6 +8,13 @@
 //	 to get elapsed time, current tick count and also for a change in time
 //	 on a frame by frame basis, to allow for time based animations.
 //
+//   Owns the storage for every countdown timer. Timers are referred to by a
+//   generational handle and their data is kept in parallel arrays. Running
+//   timers are scheduled into a hierarchical timer wheel, so an update only
+//   touches the wheel buckets for the ticks that passed and the timers that
+//   actually expire in them, rather than every timer every frame. Starting,
+//   pausing and cancelling a timer are all O(1).
+//
 // Revision History:
 //   Initial Revision - 15/07/08
 //
@@ -16,25 +23,68 @@
 
 #pragma once
 
-#include "CountdownTimer.h"
-
 #include <vector>
-#include <algorithm>
+#include <stddef.h>
+using namespace std;
+
+typedef void(*FunctionCallback)(void *lpData);
 
-typedef std::vector<CountdownTimer*> CountdownTimerList;
+typedef unsigned int TimerHandle;
+const TimerHandle INVALID_TIMER = 0xFFFFFFFF;
+
+// The wheel's resolution, timers are rounded up to the next tick
+const float TIMER_TICKS_PER_SECOND = 1000.0f;
+
+enum TimerFlags
+{
+	TimerFlags_Allocated = 1,
+	TimerFlags_Started = 2,
+	TimerFlags_Paused = 4,
+	TimerFlags_Looping = 8,
+	TimerFlags_Finished = 16,
+	TimerFlags_Expired = 32,	// Expired this update and waiting for its callback
+};
 
 
 class TimeManager
 {
 public:
+	// Handle layout, the low bits are the slot index and the high bits the generation
+	static const unsigned int INDEX_BITS = 20;
+	static const unsigned int INDEX_MASK = (1u << INDEX_BITS) - 1;
+	static const unsigned int GENERATION_MASK = (1u << (32 - INDEX_BITS)) - 1;
+
+	// Wheel layout, each level has 256 buckets and covers 256 times the range of the level below
+	static const int WHEEL_LEVEL_BITS = 8;
+	static const int WHEEL_LEVEL_SIZE = 1 << WHEEL_LEVEL_BITS;
+	static const int WHEEL_LEVEL_MASK = WHEEL_LEVEL_SIZE - 1;
+	static const int WHEEL_NUM_LEVELS = 4;
+
 	/* Public methods */
 	static TimeManager* GetInstance();
 	void Destroy();
 
-	bool HasCountdownTimers() const;
-	void AddCountdownTimer(CountdownTimer* countdownTimer);
-	void RemoveCountdownTimer(CountdownTimer* countdownTimer);
-	void RemoveCountdownTimers();
+	// Timers
+	TimerHandle CreateTimer(FunctionCallback callback = NULL, void *pCallbackData = NULL);
+	TimerHandle AddTimer(float countdownTime, FunctionCallback callback, void *pCallbackData, bool looping);
+	void RemoveTimer(TimerHandle timer);
+	void RemoveTimers();
+	bool IsTimerValid(TimerHandle timer) const;
+	int GetNumTimers() const;
+	int GetNumScheduledTimers() const;
+
+	void SetTimerCallback(TimerHandle timer, FunctionCallback callback, void *pCallbackData);
+	void SetTimerCountdownTime(TimerHandle timer, float countdownTime);
+	void SetTimerLooping(TimerHandle timer, bool looping);
+
+	void StartTimer(TimerHandle timer);
+	void ResetTimer(TimerHandle timer);
+	void PauseTimer(TimerHandle timer);
+	void ResumeTimer(TimerHandle timer);
+	bool IsTimerPaused(TimerHandle timer) const;
+
+	float GetTimerElapsedTime(TimerHandle timer) const;
+	float GetTimerRemainingTime(TimerHandle timer) const;
 
 	// Update
 	void Update(float dt);
@@ -47,6 +97,13 @@ protected:
 
 private:
 	/* Private methods */
+	int FindTimer(TimerHandle timer) const;
+
+	void ScheduleTimer(int index, float remainingTime);
+	void UnscheduleTimer(int index);
+	void InsertIntoWheel(int index);
+	void CascadeBucket(int level, int bucket);
+	void AdvanceWheel(unsigned long long targetTick);
 
 public:
 	/* Public members */
@@ -56,8 +113,31 @@ protected:
 
 private:
 	/* Private members */
-	// A dynamic array of our countdown timers
-	CountdownTimerList m_vpCountdownTimers;
+	// Timer data, indexed by the handle's slot index
+	vector<unsigned int> m_vTimerGenerations;
+	vector<unsigned char> m_vTimerFlags;
+	vector<float> m_vTimerCountdownTimes;
+	vector<float> m_vTimerElapsedTimes;	// Only valid while the timer is not scheduled
+	vector<unsigned long long> m_vTimerExpiryTicks;
+	vector<FunctionCallback> m_vTimerCallbacks;
+	vector<void*> m_vTimerCallbackData;
+
+	// Wheel bucket links, -1 terminated
+	vector<int> m_vTimerNext;
+	vector<int> m_vTimerPrev;
+	vector<int> m_vTimerBuckets;
+
+	vector<int> m_vFreeTimers;
+	int m_numTimers;
+
+	// Wheel state
+	int m_wheelHeads[WHEEL_NUM_LEVELS * WHEEL_LEVEL_SIZE];
+	unsigned long long m_currentTick;
+	double m_tickAccumulator;
+	int m_numScheduledTimers;
+
+	// Scratch list of the timers that expired this update
+	vector<TimerHandle> m_vExpiredTimers;
 
 	// Singleton instance
 	static TimeManager *c_instance;